@@ -67,33 +67,33 @@ void problem(Grid *pGrid, Domain *pDomain)
       for (i=is; i<=ie; i++) {
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-	pGrid->U[k][j][i].d = pow((1.0 + r2),-0.75);
-	pGrid->U[k][j][i].M1 = 0.0;
-        pGrid->U[k][j][i].M2 = 0.0;
-        pGrid->U[k][j][i].M3 = 0.0;
-        pGrid->U[k][j][i].E = pow((1.0 + r2),-0.75)/(Gamma*Gamma_1);
+	UVAR(pGrid,k,j,i,d) = pow((1.0 + r2),-0.75);
+	UVAR(pGrid,k,j,i,M1) = 0.0;
+        UVAR(pGrid,k,j,i,M2) = 0.0;
+        UVAR(pGrid,k,j,i,M3) = 0.0;
+        UVAR(pGrid,k,j,i,E) = pow((1.0 + r2),-0.75)/(Gamma*Gamma_1);
 
         r2 = x1*x1 + (x2-0.25)*(x2-0.25) + x3*x3;
         if (r2 < (rad_bubble*rad_bubble)) {
-	  pGrid->U[k][j][i].d = 0.01;
+	  UVAR(pGrid,k,j,i,d) = 0.01;
 	}
 #ifdef MHD									//choose ifield
 	if (ifield==1){
 	 pGrid->B1i[k][j][i] = b0;
-	 pGrid->U[k][j][i].B1c = b0;
-         pGrid->U[k][j][i].E += 0.5*b0*b0;
+	 UVAR(pGrid,k,j,i,B1c) = b0;
+         UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
 	 pGrid->B1i[k][j][ie+1] = b0;
 	}
 	if (ifield==2){
 	 pGrid->B2i[k][j][i] = b0;
-	 pGrid->U[k][j][i].B2c = b0;
-         pGrid->U[k][j][i].E += 0.5*b0*b0;
+	 UVAR(pGrid,k,j,i,B2c) = b0;
+         UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
 	 pGrid->B2i[k][je+1][i] = b0;
 	}
 	if (ifield==3){
 	 pGrid->B3i[k][j][i] = b0;
-	 pGrid->U[k][j][i].B3c = b0;
-         pGrid->U[k][j][i].E += 0.5*b0*b0;
+	 UVAR(pGrid,k,j,i,B3c) = b0;
+         UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
 	 pGrid->B3i[ke+1][je][i] = b0;
 	}
 #endif
@@ -207,20 +207,20 @@ static void outflow_ix1(Grid *pGrid)
       for (i=1; i<=nghost; i++) {
         cc_pos(pGrid,is,j,k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        d0 = pGrid->U[k][j][is].d/pow((1.0 + r2),-0.75);
+        d0 = UVAR(pGrid,k,j,is,d)/pow((1.0 + r2),-0.75);
 
-        p0 = pGrid->U[k][j][is].E - 0.5*(SQR(pGrid->U[k][j][is].M1)
-          + SQR(pGrid->U[k][j][is].M2) + SQR(pGrid->U[k][j][is].M3))
-             /pGrid->U[k][j][is].d;
+        p0 = UVAR(pGrid,k,j,is,E) - 0.5*(SQR(UVAR(pGrid,k,j,is,M1))
+          + SQR(UVAR(pGrid,k,j,is,M2)) + SQR(UVAR(pGrid,k,j,is,M3)))
+             /UVAR(pGrid,k,j,is,d);
         p0 /= pow((1.0 + r2),-0.75);
 
         cc_pos(pGrid,(is-i),j,k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        pGrid->U[k][j][is-i].d = d0*pow((1.0 + r2),-0.75);
-        pGrid->U[k][j][is-i].M1 = 0.0;
-        pGrid->U[k][j][is-i].M2 = 0.0;
-        pGrid->U[k][j][is-i].M3 = 0.0;
-        pGrid->U[k][j][is-i].E = p0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,k,j,is-i,d) = d0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,k,j,is-i,M1) = 0.0;
+        UVAR(pGrid,k,j,is-i,M2) = 0.0;
+        UVAR(pGrid,k,j,is-i,M3) = 0.0;
+        UVAR(pGrid,k,j,is-i,E) = p0*pow((1.0 + r2),-0.75);
       }
     }
   }
@@ -230,7 +230,7 @@ static void outflow_ix1(Grid *pGrid)
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
         pGrid->B1i[k][j][is-i]   = pGrid->B1i[k][j][is];
-        pGrid->U[k][j][is-i].B1c = pGrid->U[k][j][is].B1c;
+        UVAR(pGrid,k,j,is-i,B1c) = UVAR(pGrid,k,j,is,B1c);
       }
     }
   }
@@ -240,7 +240,7 @@ static void outflow_ix1(Grid *pGrid)
     for (j=js; j<=ju; j++) {
       for (i=1; i<=nghost; i++) {
         pGrid->B2i[k][j][is-i]   = pGrid->B2i[k][j][is];
-        pGrid->U[k][j][is-i].B2c = pGrid->U[k][j][is].B2c;
+        UVAR(pGrid,k,j,is-i,B2c) = UVAR(pGrid,k,j,is,B2c);
       }
     }
   }
@@ -250,7 +250,7 @@ static void outflow_ix1(Grid *pGrid)
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
         pGrid->B3i[k][j][is-i]   = pGrid->B3i[k][j][is];
-        pGrid->U[k][j][is-i].B3c = pGrid->U[k][j][is].B3c;
+        UVAR(pGrid,k,j,is-i,B3c) = UVAR(pGrid,k,j,is,B3c);
       }
     }
   }
@@ -280,20 +280,20 @@ static void outflow_ox1(Grid *pGrid)
       for (i=1; i<=nghost; i++) {
         cc_pos(pGrid,ie,j,k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        d0 = pGrid->U[k][j][ie].d/pow((1.0 + r2),-0.75);
+        d0 = UVAR(pGrid,k,j,ie,d)/pow((1.0 + r2),-0.75);
 
-        p0 = pGrid->U[k][j][ie].E - 0.5*(SQR(pGrid->U[k][j][ie].M1)
-          + SQR(pGrid->U[k][j][ie].M2) + SQR(pGrid->U[k][j][ie].M3))
-             /pGrid->U[k][j][ie].d;
+        p0 = UVAR(pGrid,k,j,ie,E) - 0.5*(SQR(UVAR(pGrid,k,j,ie,M1))
+          + SQR(UVAR(pGrid,k,j,ie,M2)) + SQR(UVAR(pGrid,k,j,ie,M3)))
+             /UVAR(pGrid,k,j,ie,d);
         p0 /= pow((1.0 + r2),-0.75);
 
         cc_pos(pGrid,(ie+i),j,k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        pGrid->U[k][j][ie+i].d = d0*pow((1.0 + r2),-0.75);
-        pGrid->U[k][j][ie+i].M1 = 0.0;
-        pGrid->U[k][j][ie+i].M2 = 0.0;
-        pGrid->U[k][j][ie+i].M3 = 0.0;
-        pGrid->U[k][j][ie+i].E = p0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,k,j,ie+i,d) = d0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,k,j,ie+i,M1) = 0.0;
+        UVAR(pGrid,k,j,ie+i,M2) = 0.0;
+        UVAR(pGrid,k,j,ie+i,M3) = 0.0;
+        UVAR(pGrid,k,j,ie+i,E) = p0*pow((1.0 + r2),-0.75);
       }
     }
   }
@@ -304,7 +304,7 @@ static void outflow_ox1(Grid *pGrid)
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
         if (i>1) pGrid->B1i[k][j][ie+i]   = pGrid->B1i[k][j][ie+1];
-        pGrid->U[k][j][ie+i].B1c = pGrid->U[k][j][ie].B1c;
+        UVAR(pGrid,k,j,ie+i,B1c) = UVAR(pGrid,k,j,ie,B1c);
       }
     }
   }
@@ -314,7 +314,7 @@ static void outflow_ox1(Grid *pGrid)
     for (j=js; j<=ju; j++) {
       for (i=1; i<=nghost; i++) {
         pGrid->B2i[k][j][ie+i]   = pGrid->B2i[k][j][ie];
-        pGrid->U[k][j][ie+i].B2c = pGrid->U[k][j][ie].B2c;
+        UVAR(pGrid,k,j,ie+i,B2c) = UVAR(pGrid,k,j,ie,B2c);
       }
     }
   }
@@ -324,7 +324,7 @@ static void outflow_ox1(Grid *pGrid)
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
         pGrid->B3i[k][j][ie+i]   = pGrid->B3i[k][j][ie];
-        pGrid->U[k][j][ie+i].B3c = pGrid->U[k][j][ie].B3c;
+        UVAR(pGrid,k,j,ie+i,B3c) = UVAR(pGrid,k,j,ie,B3c);
       }
     }
   }
@@ -361,20 +361,20 @@ static void outflow_ox2(Grid *pGrid)
       for (i=il; i<=iu; i++) {
         cc_pos(pGrid,i,je,k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        d0 = pGrid->U[k][je][i].d/pow((1.0 + r2),-0.75);
+        d0 = UVAR(pGrid,k,je,i,d)/pow((1.0 + r2),-0.75);
 
-        p0 = pGrid->U[k][je][i].E - 0.5*(SQR(pGrid->U[k][je][i].M1)
-          + SQR(pGrid->U[k][je][i].M2) + SQR(pGrid->U[k][je][i].M3))
-             /pGrid->U[k][je][i].d;
+        p0 = UVAR(pGrid,k,je,i,E) - 0.5*(SQR(UVAR(pGrid,k,je,i,M1))
+          + SQR(UVAR(pGrid,k,je,i,M2)) + SQR(UVAR(pGrid,k,je,i,M3)))
+             /UVAR(pGrid,k,je,i,d);
         p0 /= pow((1.0 + r2),-0.75);
 
         cc_pos(pGrid,i,(je+j),k,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        pGrid->U[k][je+j][i].d = d0*pow((1.0 + r2),-0.75);
-        pGrid->U[k][je+j][i].M1 = 0.0;
-        pGrid->U[k][je+j][i].M2 = 0.0;
-        pGrid->U[k][je+j][i].M3 = 0.0;
-        pGrid->U[k][je+j][i].E = p0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,k,je+j,i,d) = d0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,k,je+j,i,M1) = 0.0;
+        UVAR(pGrid,k,je+j,i,M2) = 0.0;
+        UVAR(pGrid,k,je+j,i,M3) = 0.0;
+        UVAR(pGrid,k,je+j,i,E) = p0*pow((1.0 + r2),-0.75);
       }
     }
   }
@@ -384,7 +384,7 @@ static void outflow_ox2(Grid *pGrid)
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B1i[k][je+j][i]   = pGrid->B1i[k][je][i];
-        pGrid->U[k][je+j][i].B1c = pGrid->U[k][je][i].B1c;
+        UVAR(pGrid,k,je+j,i,B1c) = UVAR(pGrid,k,je,i,B1c);
       }
     }
   }
@@ -394,7 +394,7 @@ static void outflow_ox2(Grid *pGrid)
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
          if (j>1) pGrid->B2i[k][je+j][i]   = pGrid->B2i[k][je+1][i];
-        pGrid->U[k][je+j][i].B2c = pGrid->U[k][je][i].B2c;
+        UVAR(pGrid,k,je+j,i,B2c) = UVAR(pGrid,k,je,i,B2c);
       }
     }
   }
@@ -404,7 +404,7 @@ static void outflow_ox2(Grid *pGrid)
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B3i[k][je+j][i]   = pGrid->B3i[k][je][i];
-        pGrid->U[k][je+j][i].B3c = pGrid->U[k][je][i].B3c;
+        UVAR(pGrid,k,je+j,i,B3c) = UVAR(pGrid,k,je,i,B3c);
       }
     }
   }
@@ -444,20 +444,20 @@ static void outflow_ix3(Grid *pGrid)
       for (i=il; i<=iu; i++) {
         cc_pos(pGrid,i,j,ks,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        d0 = pGrid->U[ks][j][i].d/pow((1.0 + r2),-0.75);
+        d0 = UVAR(pGrid,ks,j,i,d)/pow((1.0 + r2),-0.75);
 
-        p0 = pGrid->U[ks][j][i].E - 0.5*(SQR(pGrid->U[ks][j][i].M1)
-          + SQR(pGrid->U[ks][j][i].M2) + SQR(pGrid->U[ks][j][i].M3))
-             /pGrid->U[ks][j][i].d;
+        p0 = UVAR(pGrid,ks,j,i,E) - 0.5*(SQR(UVAR(pGrid,ks,j,i,M1))
+          + SQR(UVAR(pGrid,ks,j,i,M2)) + SQR(UVAR(pGrid,ks,j,i,M3)))
+             /UVAR(pGrid,ks,j,i,d);
         p0 /= pow((1.0 + r2),-0.75);
 
         cc_pos(pGrid,i,j,(ks-k),&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        pGrid->U[ks-k][j][i].d = d0*pow((1.0 + r2),-0.75);
-        pGrid->U[ks-k][j][i].M1 = 0.0;
-        pGrid->U[ks-k][j][i].M2 = 0.0;
-        pGrid->U[ks-k][j][i].M3 = 0.0;
-        pGrid->U[ks-k][j][i].E = p0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,ks-k,j,i,d) = d0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,ks-k,j,i,M1) = 0.0;
+        UVAR(pGrid,ks-k,j,i,M2) = 0.0;
+        UVAR(pGrid,ks-k,j,i,M3) = 0.0;
+        UVAR(pGrid,ks-k,j,i,E) = p0*pow((1.0 + r2),-0.75);
       }
     }
   }
@@ -467,7 +467,7 @@ static void outflow_ix3(Grid *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B1i[ks-k][j][i]   = pGrid->B1i[ks][j][i];
-        pGrid->U[ks-k][j][i].B1c = pGrid->U[ks][j][i].B1c;
+        UVAR(pGrid,ks-k,j,i,B1c) = UVAR(pGrid,ks,j,i,B1c);
       }
     }
   }
@@ -476,7 +476,7 @@ static void outflow_ix3(Grid *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B2i[ks-k][j][i]   = pGrid->B2i[ks][j][i];
-        pGrid->U[ks-k][j][i].B2c = pGrid->U[ks][j][i].B2c;
+        UVAR(pGrid,ks-k,j,i,B2c) = UVAR(pGrid,ks,j,i,B2c);
       }
     }
   }
@@ -485,7 +485,7 @@ static void outflow_ix3(Grid *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B3i[ks-k][j][i]   = pGrid->B3i[ks][j][i];
-        pGrid->U[ks-k][j][i].B3c = pGrid->U[ks][j][i].B3c;
+        UVAR(pGrid,ks-k,j,i,B3c) = UVAR(pGrid,ks,j,i,B3c);
       }
     }
   }
@@ -525,20 +525,20 @@ static void outflow_ox3(Grid *pGrid)
       for (i=il; i<=iu; i++) {
         cc_pos(pGrid,i,j,ke,&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        d0 = pGrid->U[ke][j][i].d/pow((1.0 + r2),-0.75);
+        d0 = UVAR(pGrid,ke,j,i,d)/pow((1.0 + r2),-0.75);
 
-        p0 = pGrid->U[ke][j][i].E - 0.5*(SQR(pGrid->U[ke][j][i].M1)
-          + SQR(pGrid->U[ke][j][i].M2) + SQR(pGrid->U[ke][j][i].M3))
-             /pGrid->U[ke][j][i].d;
+        p0 = UVAR(pGrid,ke,j,i,E) - 0.5*(SQR(UVAR(pGrid,ke,j,i,M1))
+          + SQR(UVAR(pGrid,ke,j,i,M2)) + SQR(UVAR(pGrid,ke,j,i,M3)))
+             /UVAR(pGrid,ke,j,i,d);
         p0 /= pow((1.0 + r2),-0.75);
 
         cc_pos(pGrid,i,j,(ke+k),&x1,&x2,&x3);
         r2 = x1*x1 + x2*x2 + x3*x3;
-        pGrid->U[ke+k][j][i].d = d0*pow((1.0 + r2),-0.75);
-        pGrid->U[ke+k][j][i].M1 = 0.0;
-        pGrid->U[ke+k][j][i].M2 = 0.0;
-        pGrid->U[ke+k][j][i].M3 = 0.0;
-        pGrid->U[ke+k][j][i].E = p0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,ke+k,j,i,d) = d0*pow((1.0 + r2),-0.75);
+        UVAR(pGrid,ke+k,j,i,M1) = 0.0;
+        UVAR(pGrid,ke+k,j,i,M2) = 0.0;
+        UVAR(pGrid,ke+k,j,i,M3) = 0.0;
+        UVAR(pGrid,ke+k,j,i,E) = p0*pow((1.0 + r2),-0.75);
       }
     }
   }
@@ -548,7 +548,7 @@ static void outflow_ox3(Grid *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B1i[ke+k][j][i]   = pGrid->B1i[ke][j][i];
-        pGrid->U[ke+k][j][i].B1c = pGrid->U[ke][j][i].B1c;
+        UVAR(pGrid,ke+k,j,i,B1c) = UVAR(pGrid,ke,j,i,B1c);
       }
     }
   }
@@ -558,7 +558,7 @@ static void outflow_ox3(Grid *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pGrid->B2i[ke+k][j][i]   = pGrid->B2i[ke][j][i];
-        pGrid->U[ke+k][j][i].B2c = pGrid->U[ke][j][i].B2c;
+        UVAR(pGrid,ke+k,j,i,B2c) = UVAR(pGrid,ke,j,i,B2c);
       }
     }
   }
@@ -568,7 +568,7 @@ static void outflow_ox3(Grid *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         if (k>1) pGrid->B3i[ke+k][j][i]   = pGrid->B3i[ke+1][j][i];
-        pGrid->U[ke+k][j][i].B3c = pGrid->U[ke][j][i].B3c;
+        UVAR(pGrid,ke+k,j,i,B3c) = UVAR(pGrid,ke,j,i,B3c);
       }
     }
   }
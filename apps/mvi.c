@@ -167,17 +167,17 @@ void problem(DomainS *pDomain)
 /* Initialize d, M, and P.  For 3D shearing box M1=Vx, M2=Vy, M3=Vz
  * With FARGO do not initialize the background shear */ 
 
-      pGrid->U[k][j][i].d  = rd;
-      pGrid->U[k][j][i].M1 = rd*rvx;
-      pGrid->U[k][j][i].M2 = rd*rvy;
+      UVAR(pGrid,k,j,i,d)  = rd;
+      UVAR(pGrid,k,j,i,M1) = rd*rvx;
+      UVAR(pGrid,k,j,i,M2) = rd*rvy;
 #ifndef FARGO
-      pGrid->U[k][j][i].M2 -= rd*(qshear*Omega_0*x1);
+      UVAR(pGrid,k,j,i,M2) -= rd*(qshear*Omega_0*x1);
 #endif
-      pGrid->U[k][j][i].M3 = rd*rvz;
+      UVAR(pGrid,k,j,i,M3) = rd*rvz;
 #ifdef ADIABATIC
-      pGrid->U[k][j][i].E = rp/Gamma_1
-        + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2) 
-             + SQR(pGrid->U[k][j][i].M3))/rd;
+      UVAR(pGrid,k,j,i,E) = rp/Gamma_1
+        + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2)) 
+             + SQR(UVAR(pGrid,k,j,i,M3)))/rd;
 #endif
 
 /* Initialize magnetic field.  For 3D shearing box B1=Bx, B2=By, B3=Bz
@@ -241,12 +241,12 @@ void problem(DomainS *pDomain)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-        pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-        pGrid->U[k][j][i].B3c = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+        UVAR(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+        UVAR(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+        UVAR(pGrid,k,j,i,B3c) = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
 #ifdef ADIABATIC
-      pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-         + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+      UVAR(pGrid,k,j,i,E) += 0.5*(SQR(UVAR(pGrid,k,j,i,B1c))
+         + SQR(UVAR(pGrid,k,j,i,B2c)) + SQR(UVAR(pGrid,k,j,i,B3c)));
 #endif
       }
     }
@@ -476,9 +476,9 @@ static Real expr_dV2(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d));
 #else
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -497,10 +497,10 @@ static Real hst_rho_Vx_dVy(const GridS *pG,const int i,const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return UVAR(pG,k,j,i,M1)*(UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d));
 #else
-  return pG->U[k][j][i].M1*
-    (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return UVAR(pG,k,j,i,M1)*
+    (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -509,11 +509,11 @@ static Real hst_rho_dVy2(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3,dVy;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  dVy = (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d));
 #else
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  dVy = (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
-  return pG->U[k][j][i].d*dVy*dVy;
+  return UVAR(pG,k,j,i,d)*dVy*dVy;
 }
 
 static Real hst_BrBpdOmega(const GridS *pG,const int i,const int j,const int k)
@@ -540,15 +540,15 @@ static Real hst_BBdV(const GridS *pG, const int i, const int j, const int k)
   B02 = Bx*Bx + By*By + Bz*Bz;
   B02 = MAX(B02,TINY_NUMBER); /* limit in case B=0 */
 
-  BBdV  = Bx*Bx*((pG->U[k][j][i+1].M1/pG->U[k][j][i+1].d) -
-                 (pG->U[k][j][i-1].M1/pG->U[k][j][i-1].d))/(2.0*pG->dx1);
-  BBdV += Bx*By*((pG->U[k][j+1][i].M1/pG->U[k][j+1][i].d) -
-                 (pG->U[k][j-1][i].M1/pG->U[k][j-1][i].d))/(2.0*pG->dx2);
-  BBdV += Bx*Bz*((pG->U[k+1][j][i].M1/pG->U[k+1][j][i].d) -
-                 (pG->U[k-1][j][i].M1/pG->U[k-1][j][i].d))/(2.0*pG->dx3);
+  BBdV  = Bx*Bx*((UVAR(pG,k,j,i+1,M1)/UVAR(pG,k,j,i+1,d)) -
+                 (UVAR(pG,k,j,i-1,M1)/UVAR(pG,k,j,i-1,d)))/(2.0*pG->dx1);
+  BBdV += Bx*By*((UVAR(pG,k,j+1,i,M1)/UVAR(pG,k,j+1,i,d)) -
+                 (UVAR(pG,k,j-1,i,M1)/UVAR(pG,k,j-1,i,d)))/(2.0*pG->dx2);
+  BBdV += Bx*Bz*((UVAR(pG,k+1,j,i,M1)/UVAR(pG,k+1,j,i,d)) -
+                 (UVAR(pG,k-1,j,i,M1)/UVAR(pG,k-1,j,i,d)))/(2.0*pG->dx3);
 
-  Vyp = pG->U[k][j][i+1].M2/pG->U[k][j][i+1].d;
-  Vym = pG->U[k][j][i-1].M2/pG->U[k][j][i-1].d;
+  Vyp = UVAR(pG,k,j,i+1,M2)/UVAR(pG,k,j,i+1,d);
+  Vym = UVAR(pG,k,j,i-1,M2)/UVAR(pG,k,j,i-1,d);
 #ifdef FARGO
   cc_pos(pG,(i+1),j,k,&x1,&x2,&x3);
   Vyp -= qshear*Omega_0*x1;
@@ -557,8 +557,8 @@ static Real hst_BBdV(const GridS *pG, const int i, const int j, const int k)
 #endif
   BBdV += By*Bx*(Vyp - Vym)/(2.0*pG->dx1);
 
-  Vyp = pG->U[k][j+1][i].M2/pG->U[k][j+1][i].d;
-  Vym = pG->U[k][j-1][i].M2/pG->U[k][j-1][i].d;
+  Vyp = UVAR(pG,k,j+1,i,M2)/UVAR(pG,k,j+1,i,d);
+  Vym = UVAR(pG,k,j-1,i,M2)/UVAR(pG,k,j-1,i,d);
 #ifdef FARGO
   cc_pos(pG,i,(j+1),k,&x1,&x2,&x3);
   Vyp -= qshear*Omega_0*x1;
@@ -567,8 +567,8 @@ static Real hst_BBdV(const GridS *pG, const int i, const int j, const int k)
 #endif
   BBdV += By*By*(Vyp - Vym)/(2.0*pG->dx2);
 
-  Vyp = pG->U[k+1][j][i].M2/pG->U[k+1][j][i].d;
-  Vym = pG->U[k-1][j][i].M2/pG->U[k-1][j][i].d;
+  Vyp = UVAR(pG,k+1,j,i,M2)/UVAR(pG,k+1,j,i,d);
+  Vym = UVAR(pG,k-1,j,i,M2)/UVAR(pG,k-1,j,i,d);
 #ifdef FARGO
   cc_pos(pG,i,j,(k+1),&x1,&x2,&x3);
   Vyp -= qshear*Omega_0*x1;
@@ -577,12 +577,12 @@ static Real hst_BBdV(const GridS *pG, const int i, const int j, const int k)
 #endif
   BBdV += By*Bz*(Vyp - Vym)/(2.0*pG->dx3);
 
-  BBdV += Bz*Bx*((pG->U[k][j][i+1].M3/pG->U[k][j][i+1].d) -
-                 (pG->U[k][j][i-1].M3/pG->U[k][j][i-1].d))/(2.0*pG->dx1);
-  BBdV += Bz*By*((pG->U[k][j+1][i].M3/pG->U[k][j+1][i].d) -
-                 (pG->U[k][j-1][i].M3/pG->U[k][j-1][i].d))/(2.0*pG->dx2);
-  BBdV += Bz*Bz*((pG->U[k+1][j][i].M3/pG->U[k+1][j][i].d) -
-                 (pG->U[k-1][j][i].M3/pG->U[k-1][j][i].d))/(2.0*pG->dx3);
+  BBdV += Bz*Bx*((UVAR(pG,k,j,i+1,M3)/UVAR(pG,k,j,i+1,d)) -
+                 (UVAR(pG,k,j,i-1,M3)/UVAR(pG,k,j,i-1,d)))/(2.0*pG->dx1);
+  BBdV += Bz*By*((UVAR(pG,k,j+1,i,M3)/UVAR(pG,k,j+1,i,d)) -
+                 (UVAR(pG,k,j-1,i,M3)/UVAR(pG,k,j-1,i,d)))/(2.0*pG->dx2);
+  BBdV += Bz*Bz*((UVAR(pG,k+1,j,i,M3)/UVAR(pG,k+1,j,i,d)) -
+                 (UVAR(pG,k-1,j,i,M3)/UVAR(pG,k-1,j,i,d)))/(2.0*pG->dx3);
 
   BBdV /= B02;
   return BBdV;
@@ -601,7 +601,7 @@ static Real hst_Visc_flx(const GridS *pG, const int i, const int j, const int k)
 
   BBdV = hst_BBdV(pG, i, j, k);
 
-  nud = nu_aniso*pG->U[k][j][i].d;
+  nud = nu_aniso*UVAR(pG,k,j,i,d);
   qa = nud*(BBdV - ONE_3RD*divV);
   return qa*(3.0*By*Bx/B02);
 }
@@ -610,12 +610,12 @@ static Real hst_ThirddivV(const GridS *pG, const int i, const int j, const int k
 {
   Real divV;
 
-  divV  = ((pG->U[k][j][i+1].M1/pG->U[k][j][i+1].d)-
-           (pG->U[k][j][i-1].M1/pG->U[k][j][i-1].d))/(2.0*pG->dx1);
-  divV += ((pG->U[k][j+1][i].M2/pG->U[k][j+1][i].d)-
-           (pG->U[k][j-1][i].M2/pG->U[k][j-1][i].d))/(2.0*pG->dx2);
-  divV += ((pG->U[k+1][j][i].M3/pG->U[k+1][j][i].d)-
-           (pG->U[k-1][j][i].M3/pG->U[k-1][j][i].d))/(2.0*pG->dx3);
+  divV  = ((UVAR(pG,k,j,i+1,M1)/UVAR(pG,k,j,i+1,d))-
+           (UVAR(pG,k,j,i-1,M1)/UVAR(pG,k,j,i-1,d)))/(2.0*pG->dx1);
+  divV += ((UVAR(pG,k,j+1,i,M2)/UVAR(pG,k,j+1,i,d))-
+           (UVAR(pG,k,j-1,i,M2)/UVAR(pG,k,j-1,i,d)))/(2.0*pG->dx2);
+  divV += ((UVAR(pG,k+1,j,i,M3)/UVAR(pG,k+1,j,i,d))-
+           (UVAR(pG,k-1,j,i,M3)/UVAR(pG,k-1,j,i,d)))/(2.0*pG->dx3);
 
   return ONE_3RD*divV;
 }
@@ -628,7 +628,7 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
   phi = UnstratifiedDisk(x1, x2, x3);
 
-  return pG->U[k][j][i].E + pG->U[k][j][i].d*phi;
+  return UVAR(pG,k,j,i,E) + UVAR(pG,k,j,i,d)*phi;
 }
 #endif /* ADIABATIC */
 
@@ -639,20 +639,20 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
 
 static Real hst_Bx(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B1c;
+  return UVAR(pG,k,j,i,B1c);
 }
 
 static Real hst_By(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B2c;
+  return UVAR(pG,k,j,i,B2c);
 }
 
 static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B3c;
+  return UVAR(pG,k,j,i,B3c);
 }
 
 static Real hst_BxBy(const GridS *pG, const int i, const int j, const int k)
 {
-  return -pG->U[k][j][i].B1c*pG->U[k][j][i].B2c;
+  return -UVAR(pG,k,j,i,B1c)*UVAR(pG,k,j,i,B2c);
 }
@@ -82,19 +82,19 @@ void problem(DomainS *pDomain)
 
 /* Initialize d, M, and P.  With FARGO do not initialize the background shear */
 
-      pGrid->U[k][j][i].d  = den;
-      pGrid->U[k][j][i].M1 = 0.0;
-      pGrid->U[k][j][i].M2 = 0.0;
+      UVAR(pGrid,k,j,i,d)  = den;
+      UVAR(pGrid,k,j,i,M1) = 0.0;
+      UVAR(pGrid,k,j,i,M2) = 0.0;
 #ifdef SHEARING_BOX
 #ifndef FARGO
-      pGrid->U[k][j][i].M2 -= den*(qshear*Omega_0*x1);
+      UVAR(pGrid,k,j,i,M2) -= den*(qshear*Omega_0*x1);
 #endif
 #endif
-      pGrid->U[k][j][i].M3 = 0.0;
+      UVAR(pGrid,k,j,i,M3) = 0.0;
 #ifdef ADIABATIC
-      pGrid->U[k][j][i].E = pres/Gamma_1
-        + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2) 
-             + SQR(pGrid->U[k][j][i].M3))/den;
+      UVAR(pGrid,k,j,i,E) = pres/Gamma_1
+        + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2)) 
+             + SQR(UVAR(pGrid,k,j,i,M3)))/den;
 #endif
 
     }
@@ -266,9 +266,9 @@ static Real expr_dV2(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef SHEARING_BOX
 #ifdef FARGO
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d));
 #else
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 #endif
 }
@@ -289,10 +289,10 @@ static Real hst_rho_Vx_dVy(const GridS *pG,const int i,const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef SHEARING_BOX
 #ifdef FARGO
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return UVAR(pG,k,j,i,M1)*(UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d));
 #else
-  return pG->U[k][j][i].M1*
-    (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return UVAR(pG,k,j,i,M1)*
+    (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 #endif
 }
@@ -306,12 +306,12 @@ static Real hst_rho_dVy2(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef SHEARING_BOX
 #ifdef FARGO
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  dVy = (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d));
 #else
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  dVy = (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 #endif
-  return pG->U[k][j][i].d*dVy*dVy;
+  return UVAR(pG,k,j,i,d)*dVy*dVy;
 }
 
 #ifdef ADIABATIC
@@ -324,7 +324,7 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
   phi = UnstratifiedDisk(x1, x2, x3);
 
-  return pG->U[k][j][i].E + pG->U[k][j][i].d*phi;
+  return UVAR(pG,k,j,i,E) + UVAR(pG,k,j,i,d)*phi;
 }
 #endif /* ADIABATIC */
 
@@ -350,19 +350,19 @@ void constant_iib(GridS *pGrid)
 
 /* Initialize d, M, and P.  With FARGO do not initialize the background shear */
 
-      pGrid->U[k][j][is-i].d  = den;
-      pGrid->U[k][j][is-i].M1 = 0.0;
-      pGrid->U[k][j][is-i].M2 = 0.0;
+      UVAR(pGrid,k,j,is-i,d)  = den;
+      UVAR(pGrid,k,j,is-i,M1) = 0.0;
+      UVAR(pGrid,k,j,is-i,M2) = 0.0;
 #ifdef SHEARING_BOX
 #ifndef FARGO
-      pGrid->U[k][j][is-i].M2 -= den*(qshear*Omega_0*x1);
+      UVAR(pGrid,k,j,is-i,M2) -= den*(qshear*Omega_0*x1);
 #endif
 #endif
-      pGrid->U[k][j][is-i].M3 = 0.0;
+      UVAR(pGrid,k,j,is-i,M3) = 0.0;
 #ifdef ADIABATIC
-      pGrid->U[k][j][is-i].E = pres/Gamma_1
-        + 0.5*(SQR(pGrid->U[k][j][is-i].M1) + SQR(pGrid->U[k][j][is-i].M2)
-             + SQR(pGrid->U[k][j][is-i].M3))/den;
+      UVAR(pGrid,k,j,is-i,E) = pres/Gamma_1
+        + 0.5*(SQR(UVAR(pGrid,k,j,is-i,M1)) + SQR(UVAR(pGrid,k,j,is-i,M2))
+             + SQR(UVAR(pGrid,k,j,is-i,M3)))/den;
 #endif
       }
     }
@@ -391,19 +391,19 @@ void constant_oib(GridS *pGrid)
 
 /* Initialize d, M, and P.  With FARGO do not initialize the background shear */
 
-      pGrid->U[k][j][ie+i].d  = den;
-      pGrid->U[k][j][ie+i].M1 = 0.0;
-      pGrid->U[k][j][ie+i].M2 = 0.0;
+      UVAR(pGrid,k,j,ie+i,d)  = den;
+      UVAR(pGrid,k,j,ie+i,M1) = 0.0;
+      UVAR(pGrid,k,j,ie+i,M2) = 0.0;
 #ifdef SHEARING_BOX
 #ifndef FARGO
-      pGrid->U[k][j][ie+i].M2 -= den*(qshear*Omega_0*x1);
+      UVAR(pGrid,k,j,ie+i,M2) -= den*(qshear*Omega_0*x1);
 #endif
 #endif
-      pGrid->U[k][j][ie+i].M3 = 0.0;
+      UVAR(pGrid,k,j,ie+i,M3) = 0.0;
 #ifdef ADIABATIC
-      pGrid->U[k][j][ie+i].E = pres/Gamma_1
-        + 0.5*(SQR(pGrid->U[k][j][ie+i].M1) + SQR(pGrid->U[k][j][ie+i].M2)
-             + SQR(pGrid->U[k][j][ie+i].M3))/den;
+      UVAR(pGrid,k,j,ie+i,E) = pres/Gamma_1
+        + 0.5*(SQR(UVAR(pGrid,k,j,ie+i,M1)) + SQR(UVAR(pGrid,k,j,ie+i,M2))
+             + SQR(UVAR(pGrid,k,j,ie+i,M3)))/den;
 #endif
       }
     }
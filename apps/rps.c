@@ -166,12 +166,12 @@ void problem(DomainS *pDomain)
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
-	pGrid->U[k][j][i].d = densicm;
-	pGrid->U[k][j][i].E = kboltz * ticm/TemperatureUnits/((Gamma-1.0)*mh*mu) * densicm*DensityUnits;
-	//printf("E ICM: %g\n",pGrid->U[k][j][i].E);
-	pGrid->U[k][j][i].M1 = 0.0;
-	pGrid->U[k][j][i].M2 = 0.0;
-	pGrid->U[k][j][i].M3 = 0.0;
+	UVAR(pGrid,k,j,i,d) = densicm;
+	UVAR(pGrid,k,j,i,E) = kboltz * ticm/TemperatureUnits/((Gamma-1.0)*mh*mu) * densicm*DensityUnits;
+	//printf("E ICM: %g\n",UVAR(pGrid,k,j,i,E));
+	UVAR(pGrid,k,j,i,M1) = 0.0;
+	UVAR(pGrid,k,j,i,M2) = 0.0;
+	UVAR(pGrid,k,j,i,M3) = 0.0;
 	
 		  /*If we are in the galaxy*/
 	if (sqrt(pow((x1-DiskPositionx),2.0) + pow((x2-DiskPositiony),2.0) + pow((x3-DiskPositionz),2.0)) < DiskRadius) {
@@ -224,30 +224,30 @@ void problem(DomainS *pDomain)
 				  /*this is where I would insert the "color" parameter if I was doing so*/
 			  }
 			//  printf("dens1 %g density %g vrot %g\n",dens1,density, DiskVelocityMag);
-				pGrid->U[k][j][i].d = density; //dens1; /*pretty sure that this is in code units*/
+				UVAR(pGrid,k,j,i,d) = density; //dens1; /*pretty sure that this is in code units*/
 		  /* Compute velocity magnitude (divided by drad). 
 		   This assumes PointSourceGravityPosition and Disk center are the same. */
 		  
 		  /* Compute velocty: L x r_perp. */  /*to get to Momentum units I will have to multiply by U[k][j][i].d*/
 		  
-		  pGrid->U[k][j][i].M1 = DiskVelocityMag*(AngularMomentumy*zpos1 -AngularMomentumz*ypos1);
+		  UVAR(pGrid,k,j,i,M1) = DiskVelocityMag*(AngularMomentumy*zpos1 -AngularMomentumz*ypos1);
 		  
-		  pGrid->U[k][j][i].M2 = DiskVelocityMag*(AngularMomentumz*xpos1 -   AngularMomentumx*zpos1);
+		  UVAR(pGrid,k,j,i,M2) = DiskVelocityMag*(AngularMomentumz*xpos1 -   AngularMomentumx*zpos1);
 		  
-		  pGrid->U[k][j][i].M3 = DiskVelocityMag*(AngularMomentumx*ypos1 -  AngularMomentumy*xpos1);
+		  UVAR(pGrid,k,j,i,M3) = DiskVelocityMag*(AngularMomentumx*ypos1 -  AngularMomentumy*xpos1);
 
-		  pGrid->U[k][j][i].M1 *= density;
-		  pGrid->U[k][j][i].M2 *= density;
-		  pGrid->U[k][j][i].M3 *= density;
+		  UVAR(pGrid,k,j,i,M1) *= density;
+		  UVAR(pGrid,k,j,i,M2) *= density;
+		  UVAR(pGrid,k,j,i,M3) *= density;
 		
 			
 	
-		pGrid->U[k][j][i].E = kboltz * temperature0/TemperatureUnits/((Gamma-1.0)*mh*mu) * pGrid->U[k][j][i].d*DensityUnits;
+		UVAR(pGrid,k,j,i,E) = kboltz * temperature0/TemperatureUnits/((Gamma-1.0)*mh*mu) * UVAR(pGrid,k,j,i,d)*DensityUnits;
 	
 		  
-		  pGrid->U[k][j][i].E += 0.5*(pow(pGrid->U[k][j][i].M3,2)+pow(pGrid->U[k][j][i].M2,2)+pow(pGrid->U[k][j][i].M1,2))/pGrid->U[k][j][i].d;
-		  if (pGrid->U[k][j][i].E < kboltz * ticm/TemperatureUnits/((Gamma-1.0)*mh*mu) * densicm*DensityUnits) {
-		    pGrid->U[k][j][i].E = kboltz * ticm/TemperatureUnits/((Gamma-1.0)*mh*mu) * densicm*DensityUnits;
+		  UVAR(pGrid,k,j,i,E) += 0.5*(pow(UVAR(pGrid,k,j,i,M3),2)+pow(UVAR(pGrid,k,j,i,M2),2)+pow(UVAR(pGrid,k,j,i,M1),2))/UVAR(pGrid,k,j,i,d);
+		  if (UVAR(pGrid,k,j,i,E) < kboltz * ticm/TemperatureUnits/((Gamma-1.0)*mh*mu) * densicm*DensityUnits) {
+		    UVAR(pGrid,k,j,i,E) = kboltz * ticm/TemperatureUnits/((Gamma-1.0)*mh*mu) * densicm*DensityUnits;
 		    printf("had a low energy!");
 		  }
 
@@ -260,41 +260,41 @@ void problem(DomainS *pDomain)
           if (x3 <= 0.0) {
             pGrid->B1i[k][j][i] = b0;
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-            pGrid->U[k][j][i].B1c = b0;
+            UVAR(pGrid,k,j,i,B1c) = b0;
           }
           break;
         case 4: /* discontinuous rotation of B by angle at interface */
           if (x3 <= 0.0) {
             pGrid->B1i[k][j][i] = b0;
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-            pGrid->U[k][j][i].B1c = b0;
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            UVAR(pGrid,k,j,i,B1c) = b0;
+            UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           else {
             pGrid->B1i[k][j][i] = b0*cos(angle);
             pGrid->B2i[k][j][i] = b0*sin(angle);
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0*cos(angle);
             if (j == je) pGrid->B2i[k][je+1][i] = b0*sin(angle);
-            pGrid->U[k][j][i].B1c = b0*cos(angle);
-            pGrid->U[k][j][i].B2c = b0*sin(angle);
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            UVAR(pGrid,k,j,i,B1c) = b0*cos(angle);
+            UVAR(pGrid,k,j,i,B2c) = b0*sin(angle);
+            UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           break;
         case 5: /* rotation of B by angle over distance L_rot at interface */
           if (x3 <= (-L_rot/2.0)) {
             pGrid->B1i[k][j][i] = b0;
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-            pGrid->U[k][j][i].B1c = b0;
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            UVAR(pGrid,k,j,i,B1c) = b0;
+            UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           else if (x3 >= (L_rot/2.0)) {
             pGrid->B1i[k][j][i] = b0*cos(angle);
             pGrid->B2i[k][j][i] = b0*sin(angle);
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0*cos(angle);
             if (j == je) pGrid->B2i[k][je+1][i] = b0*sin(angle);
-            pGrid->U[k][j][i].B1c = b0*cos(angle);
-            pGrid->U[k][j][i].B2c = b0*sin(angle);
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            UVAR(pGrid,k,j,i,B1c) = b0*cos(angle);
+            UVAR(pGrid,k,j,i,B2c) = b0*sin(angle);
+            UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           else {
             fact = ((L_rot/2.0)+x3)/L_rot;
@@ -302,17 +302,17 @@ void problem(DomainS *pDomain)
             pGrid->B2i[k][j][i] = b0*sin(fact*angle);
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0*cos(fact*angle);
             if (j == je) pGrid->B2i[k][je+1][i] = b0*sin(fact*angle);
-            pGrid->U[k][j][i].B1c = b0*cos(fact*angle);
-            pGrid->U[k][j][i].B2c = b0*sin(fact*angle);
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            UVAR(pGrid,k,j,i,B1c) = b0*cos(fact*angle);
+            UVAR(pGrid,k,j,i,B2c) = b0*sin(fact*angle);
+            UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
 
           break;
         default:
           pGrid->B1i[k][j][i] = b0;
           if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-          pGrid->U[k][j][i].B1c = b0;
-          pGrid->U[k][j][i].E += 0.5*b0*b0;
+          UVAR(pGrid,k,j,i,B1c) = b0;
+          UVAR(pGrid,k,j,i,E) += 0.5*b0*b0;
         }
 #endif
       }
@@ -422,11 +422,11 @@ static void rps_ikb(GridS *pGrid)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         //dmr.c calls cc_pos(pGrid,i,j,ks,&x1,&x2,&x3);  I don't think I need it!
-	pGrid->U[ks-k][j][i].d  = d0;
-	pGrid->U[ks-k][j][i].M1 = d0*u0;
-        pGrid->U[ks-k][j][i].M2 = d0*v0;
-        pGrid->U[ks-k][j][i].M3 = d0*w0;
-        pGrid->U[ks-k][j][i].E  = e0 + 0.5*d0*(u0*u0 + v0*v0 + w0*w0);
+	UVAR(pGrid,ks-k,j,i,d)  = d0;
+	UVAR(pGrid,ks-k,j,i,M1) = d0*u0;
+        UVAR(pGrid,ks-k,j,i,M2) = d0*v0;
+        UVAR(pGrid,ks-k,j,i,M3) = d0*w0;
+        UVAR(pGrid,ks-k,j,i,E)  = e0 + 0.5*d0*(u0*u0 + v0*v0 + w0*w0);
       }
     }
   }
@@ -454,10 +454,10 @@ static void reflect_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pGrid->U[ks-k][j][i]    =  pGrid->U[ks+(k-1)][j][i];
-        pGrid->U[ks-k][j][i].M3 = -pGrid->U[ks-k][j][i].M3; /* reflect 3-mom. */
-        pGrid->U[ks-k][j][i].E +=
-          pGrid->U[ks+(k-1)][j][i].d*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
+        USET(pGrid,ks-k,j,i,UGET(pGrid,ks+(k-1),j,i));
+        UVAR(pGrid,ks-k,j,i,M3) = -UVAR(pGrid,ks-k,j,i,M3); /* reflect 3-mom. */
+        UVAR(pGrid,ks-k,j,i,E) +=
+          UVAR(pGrid,ks+(k-1),j,i,d)*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
       }
     }
   }
@@ -511,10 +511,10 @@ static void reflect_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pGrid->U[ke+k][j][i]    =  pGrid->U[ke-(k-1)][j][i];
-        pGrid->U[ke+k][j][i].M3 = -pGrid->U[ke+k][j][i].M3; /* reflect 3-mom. */
-        pGrid->U[ke+k][j][i].E -=
-          pGrid->U[ke-(k-1)][j][i].d*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
+        USET(pGrid,ke+k,j,i,UGET(pGrid,ke-(k-1),j,i));
+        UVAR(pGrid,ke+k,j,i,M3) = -UVAR(pGrid,ke+k,j,i,M3); /* reflect 3-mom. */
+        UVAR(pGrid,ke+k,j,i,E) -=
+          UVAR(pGrid,ke-(k-1),j,i,d)*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
       }
     }
   }
@@ -103,13 +103,13 @@ if(iprob==1) {
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].d = rho0 + rho1*cos(krho_i*(float)(i-is));
-      pGrid->U[k][j][i].M1 = pGrid->U[k][j][i].d * n_anal * rho1 * sin(krho_i*(float)(i-is)) / rho0 / krho * (-1.0);
-      pGrid->U[k][j][i].M2 = 0.0;
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = (n0*kb*T0)/Gamma_1 - n_anal*n_anal/ (krho * krho * Gamma_1) * rho1*cos(krho_i*(float)(i-is))
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+      UVAR(pGrid,k,j,i,d) = rho0 + rho1*cos(krho_i*(float)(i-is));
+      UVAR(pGrid,k,j,i,M1) = UVAR(pGrid,k,j,i,d) * n_anal * rho1 * sin(krho_i*(float)(i-is)) / rho0 / krho * (-1.0);
+      UVAR(pGrid,k,j,i,M2) = 0.0;
+      UVAR(pGrid,k,j,i,M3) = 0.0;
+      UVAR(pGrid,k,j,i,E) = (n0*kb*T0)/Gamma_1 - n_anal*n_anal/ (krho * krho * Gamma_1) * rho1*cos(krho_i*(float)(i-is))
+             + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+             + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
        }
      }
    } 
@@ -138,14 +138,14 @@ if(iprob==2) {
       phi = atan((float)(j-js)/(float)(i-is));
       }
       r_proj = r * sin(phi + angle) / sin ( 2 * angle);
-      pGrid->U[k][j][i].d = rho0 + rho1 * cos(krho_ij * r_proj);
-      pGrid->U[k][j][i].M1 = pGrid->U[k][j][i].d * n_anal * rho1 * sin(krho_ij * r_proj) / rho0 / krho * cos(angle) * (-1.0);
-      pGrid->U[k][j][i].M2 = pGrid->U[k][j][i].d * n_anal * rho1 * sin(krho_ij * r_proj) / rho0 / krho * sin(angle) * (-1.0);
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = (n0*kb*T0)/Gamma_1 
+      UVAR(pGrid,k,j,i,d) = rho0 + rho1 * cos(krho_ij * r_proj);
+      UVAR(pGrid,k,j,i,M1) = UVAR(pGrid,k,j,i,d) * n_anal * rho1 * sin(krho_ij * r_proj) / rho0 / krho * cos(angle) * (-1.0);
+      UVAR(pGrid,k,j,i,M2) = UVAR(pGrid,k,j,i,d) * n_anal * rho1 * sin(krho_ij * r_proj) / rho0 / krho * sin(angle) * (-1.0);
+      UVAR(pGrid,k,j,i,M3) = 0.0;
+      UVAR(pGrid,k,j,i,E) = (n0*kb*T0)/Gamma_1 
              - n_anal*n_anal/ (krho * krho * Gamma_1) * rho1 * cos(krho_ij * r_proj)
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+             + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+             + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
        }
      }
    }
@@ -162,27 +162,27 @@ if(iprob==2) {
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].d = rho0; 
-      pGrid->U[k][j][i].M1 = 0.0; 
-      pGrid->U[k][j][i].M2 = 0.0;  
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+      UVAR(pGrid,k,j,i,d) = rho0; 
+      UVAR(pGrid,k,j,i,M1) = 0.0; 
+      UVAR(pGrid,k,j,i,M2) = 0.0;  
+      UVAR(pGrid,k,j,i,M3) = 0.0;
+      UVAR(pGrid,k,j,i,E) = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
+             + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+             + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
 #ifdef MHD
       pGrid->B1i[k][j][i] = b0 * cos(angle);
       if (i == ie) pGrid->B1i[k][j][i+1] = b0 * cos(angle);
-      pGrid->U[k][j][i].B1c = b0 * cos(angle);
+      UVAR(pGrid,k,j,i,B1c) = b0 * cos(angle);
 
       pGrid->B2i[k][j][i] = b0 * sin(angle);
       if (j==je) pGrid->B2i[k][j+1][i] = b0 * sin(angle);
-      pGrid->U[k][j][i].B2c = b0 * sin(angle);
+      UVAR(pGrid,k,j,i,B2c) = b0 * sin(angle);
 
       pGrid->B3i[k][j][i] = 0.0;
       if (k==ke && pGrid->Nx3 > 1) pGrid->B3i[k+1][j][i] = 0.0;
-      pGrid->U[k][j][i].B3c = 0.0;
-      pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-                           + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+      UVAR(pGrid,k,j,i,B3c) = 0.0;
+      UVAR(pGrid,k,j,i,E) += 0.5*(SQR(UVAR(pGrid,k,j,i,B1c))
+                           + SQR(UVAR(pGrid,k,j,i,B2c)) + SQR(UVAR(pGrid,k,j,i,B3c)));
 #endif /* MHD */
       }
     }
@@ -245,13 +245,13 @@ if(iprob==4){
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].d = rho0;
-      pGrid->U[k][j][i].M1 = 0.0;
-      pGrid->U[k][j][i].M2 = 0.0;
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+      UVAR(pGrid,k,j,i,d) = rho0;
+      UVAR(pGrid,k,j,i,M1) = 0.0;
+      UVAR(pGrid,k,j,i,M2) = 0.0;
+      UVAR(pGrid,k,j,i,M3) = 0.0;
+      UVAR(pGrid,k,j,i,E) = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
+             + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+             + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
       pGrid->B1i[k][j][i] = (az[ks][j+1][i] - az[ks][j][i]);
       pGrid->B2i[k][j][i] =-(az[ks][j][i+1] - az[ks][j][i]);
 
@@ -283,11 +283,11 @@ if(iprob==4){
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-      pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-      pGrid->U[k][j][i].B3c = 0.0;
-      pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-                           + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+      UVAR(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+      UVAR(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+      UVAR(pGrid,k,j,i,B3c) = 0.0;
+      UVAR(pGrid,k,j,i,E) += 0.5*(SQR(UVAR(pGrid,k,j,i,B1c))
+                           + SQR(UVAR(pGrid,k,j,i,B2c)) + SQR(UVAR(pGrid,k,j,i,B3c)));
        }
      }
    }
@@ -309,27 +309,27 @@ if(iprob==4){
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].d = rho0;
-      pGrid->U[k][j][i].M1 = 0.0;
-      pGrid->U[k][j][i].M2 = 0.0;
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+      UVAR(pGrid,k,j,i,d) = rho0;
+      UVAR(pGrid,k,j,i,M1) = 0.0;
+      UVAR(pGrid,k,j,i,M2) = 0.0;
+      UVAR(pGrid,k,j,i,M3) = 0.0;
+      UVAR(pGrid,k,j,i,E) = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
+             + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+             + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
 #ifdef MHD
       pGrid->B1i[k][j][i] = b0 * cos(angle) * cos(ksi);
       if (i == ie) pGrid->B1i[k][j][i+1] = b0 * cos(angle) * cos(ksi);
-      pGrid->U[k][j][i].B1c = b0 * cos(angle) * cos(ksi);
+      UVAR(pGrid,k,j,i,B1c) = b0 * cos(angle) * cos(ksi);
 
       pGrid->B2i[k][j][i] = b0 * sin(angle) * cos(ksi);
       if (j==je) pGrid->B2i[k][j+1][i] = b0 * sin(angle) * cos(ksi);
-      pGrid->U[k][j][i].B2c = b0 * sin(angle) * cos(ksi);
+      UVAR(pGrid,k,j,i,B2c) = b0 * sin(angle) * cos(ksi);
 
       pGrid->B3i[k][j][i] = b0 * sin(ksi);
       if (k==ke && pGrid->Nx3 > 1) pGrid->B3i[k+1][j][i] = b0 * sin(ksi);
-      pGrid->U[k][j][i].B3c = b0 * sin(ksi);
-      pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-                           + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+      UVAR(pGrid,k,j,i,B3c) = b0 * sin(ksi);
+      UVAR(pGrid,k,j,i,E) += 0.5*(SQR(UVAR(pGrid,k,j,i,B1c))
+                           + SQR(UVAR(pGrid,k,j,i,B2c)) + SQR(UVAR(pGrid,k,j,i,B3c)));
 #endif /* MHD */
       }
     }
@@ -413,13 +413,13 @@ if(iprob==6){
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].d = rho0;
-      pGrid->U[k][j][i].M1 = 0.0;
-      pGrid->U[k][j][i].M2 = 0.0;
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+      UVAR(pGrid,k,j,i,d) = rho0;
+      UVAR(pGrid,k,j,i,M1) = 0.0;
+      UVAR(pGrid,k,j,i,M2) = 0.0;
+      UVAR(pGrid,k,j,i,M3) = 0.0;
+      UVAR(pGrid,k,j,i,E) = (n0*kb*T0)/Gamma_1 + (n0*kb*T0)/Gamma_1 * (ran2(&rseed) - 0.5) * dp
+             + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+             + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
       pGrid->B1i[k][j][i] = (az[k][j+1][i] - az[k][j][i]) -
                             (ay[k+1][j][i] - ay[k][j][i]);
       pGrid->B2i[k][j][i] = (ax[k+1][j][i] - ax[k][j][i]) -
@@ -454,11 +454,11 @@ if(iprob==6){
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-      pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-      pGrid->U[k][j][i].B3c = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
-      pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-                           + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+      UVAR(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+      UVAR(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+      UVAR(pGrid,k,j,i,B3c) = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+      UVAR(pGrid,k,j,i,E) += 0.5*(SQR(UVAR(pGrid,k,j,i,B1c))
+                           + SQR(UVAR(pGrid,k,j,i,B2c)) + SQR(UVAR(pGrid,k,j,i,B3c)));
        }
      }
    }
@@ -494,7 +494,7 @@ void problem_read_restart(Grid *pG, Domain *pD, FILE *fp)
  *  \brief Log10 of density */
 static Real logd(const Grid *pG, const int i, const int j, const int k)
 {
-  return log10(pG->U[k][j][i].d);
+  return log10(UVAR(pG,k,j,i,d));
 }
 
 Gasfun_t get_usr_expr(const char *expr)
@@ -53,18 +53,21 @@
 
 /* KEEP SEMI-COLONS OUT OF THESE PRE-PROCESSOR DIRECTIVES! */
 /* FFT indexing Nfast=k, Nmid=j, Nslow=i (opposite to Athena)
- * For OFST, i,j,k,nx2,nx3 reference the local grid */
-#define OFST(i, j, k) ((k) + nx3*((j) + nx2*(i)))
+ * For OFST, i,j,k,nx2,cnx3 reference the local half spectrum
+ * For ROFST, i,j,k,nx2,rnx3 reference the local grid (real data) */
+#define OFST(i, j, k) ((k) + cnx3*((j) + nx2*(i)))
+#define ROFST(i, j, k) ((k) + rnx3*((j) + nx2*(i)))
 /* KWVM: magnitude of wavenumber k in units of dkx */
 #define KWVM(i, j, k) (sqrt(SQR(KCOMP(i,gis,gnx1))+ \
-                            SQR(KCOMP(j,gjs,gnx2))+SQR(KCOMP(k,gks,gnx3))))
+                            SQR(KCOMP(j,gjs,gnx2))+SQR(KCOMP(k,cks,gnx3))))
 
 /* FFTW - Variables, Plan, etc. */
 /* These are made static global variables so that they need not be
    allocated AND destroyed with each call to pspect! */
 static struct ath_3d_fft_plan *plan;
 /* Between calls to generate(), these have unshifted, unnormalized
- * velocity perturbations. */
+ * velocity perturbations.  The c2r transform means only the half spectrum
+ * k3=0..gnx3/2 is set, and the result in real space is real. */
 static ath_fft_data *fv1=NULL, *fv2=NULL, *fv3=NULL;
 
 /* Normalized, shifted velocity perturbations */
@@ -81,6 +84,8 @@ static int ispect,idrive;
 static int nx1,nx2,nx3,gnx1,gnx2,gnx3;
 /* Starting and ending indices for global grid */
 static int gis,gie,gjs,gje,gks,gke;
+/* Local half spectrum in x3 (size, first global index), real data stride */
+static int cnx3,cks,rnx3;
 /* Seed for random number generator */
 long int rseed;
 #ifdef MHD
@@ -138,7 +143,7 @@ static void pspect(ath_fft_data *ampl)
   double q1,q2,q3;
 
   /* set random amplitudes with gaussian deviation */
-  for (k=0; k<nx3; k++) {
+  for (k=0; k<cnx3; k++) {
     for (j=0; j<nx2; j++) {
       for (i=0; i<nx1; i++) {
         q1 = ran2(&rseed);
@@ -155,7 +160,7 @@ static void pspect(ath_fft_data *ampl)
    *   ispect=1: power law - original form
    *   ispect=2: form from Gammie&Ostriker
    */
-  for (k=0; k<nx3; k++) {
+  for (k=0; k<cnx3; k++) {
     for (j=0; j<nx2; j++) {
       for (i=0; i<nx1; i++) {
         /* compute k/dkx */
@@ -197,12 +202,12 @@ static void project()
   ath_fft_data dot;
   
   /* Project off non-solenoidal component of velocity */
-  for (k=0; k<nx3; k++) {
-    kap[2] = sin(2.0*PI*(gks+k)/gnx3);
+  for (k=0; k<cnx3; k++) {
+    kap[2] = sin(2.0*PI*(cks+k)/gnx3);
     for (j=0; j<nx2; j++) {
       kap[1] = sin(2.0*PI*(gjs+j)/gnx2);
       for (i=0; i<nx1; i++) {
-        if (((gis+i)+(gjs+j)+(gks+k)) != 0) {
+        if (((gis+i)+(gjs+j)+(cks+k)) != 0) {
           kap[0] = sin(2.0*PI*(gis+i)/gnx1);
           ind = OFST(i,j,k);
 
@@ -293,10 +298,10 @@ static void perturb(GridS *pGrid, Real dt)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        ind = OFST(i-is,j-js,k-ks);
-        dv1[k][j][i] = fv1[ind][0]*dvol;
-        dv2[k][j][i] = fv2[ind][0]*dvol;
-        dv3[k][j][i] = fv3[ind][0]*dvol;
+        ind = ROFST(i-is,j-js,k-ks);
+        dv1[k][j][i] = ((ath_fft_real *)fv1)[ind]*dvol;
+        dv2[k][j][i] = ((ath_fft_real *)fv2)[ind]*dvol;
+        dv3[k][j][i] = ((ath_fft_real *)fv3)[ind]*dvol;
       }
     }
   }
@@ -308,12 +313,12 @@ static void perturb(GridS *pGrid, Real dt)
     for (j=js; j<=je; j++) {
       t0i = 0.0;  t1i = 0.0;  t2i = 0.0;  t3i = 0.0;
       for (i=is; i<=ie; i++) {
-        t0i += pGrid->U[k][j][i].d;
+        t0i += UVAR(pGrid,k,j,i,d);
 
 	/* The net momentum perturbation */
-        t1i += pGrid->U[k][j][i].d * dv1[k][j][i];
-        t2i += pGrid->U[k][j][i].d * dv2[k][j][i];
-        t3i += pGrid->U[k][j][i].d * dv3[k][j][i];
+        t1i += UVAR(pGrid,k,j,i,d) * dv1[k][j][i];
+        t2i += UVAR(pGrid,k,j,i,d) * dv2[k][j][i];
+        t3i += UVAR(pGrid,k,j,i,d) * dv3[k][j][i];
       }
       t0ij += t0i;  t1ij += t1i;  t2ij += t2i;  t3ij += t3i;
     }
@@ -353,9 +358,9 @@ static void perturb(GridS *pGrid, Real dt)
 	v2 = dv2[k][j][i];
 	v3 = dv3[k][j][i];
 
-        t1i += (pGrid->U[k][j][i].d)*(SQR(v1) + SQR(v2) + SQR(v3));
-	t2i +=  (pGrid->U[k][j][i].M1)*v1 + (pGrid->U[k][j][i].M2)*v2 +
-                     (pGrid->U[k][j][i].M3)*v3;
+        t1i += (UVAR(pGrid,k,j,i,d))*(SQR(v1) + SQR(v2) + SQR(v3));
+	t2i +=  (UVAR(pGrid,k,j,i,M1))*v1 + (UVAR(pGrid,k,j,i,M2))*v2 +
+                     (UVAR(pGrid,k,j,i,M3))*v3;
       }
       t1ij += t1i;  t2ij += t2i;
     }
@@ -394,10 +399,10 @@ static void perturb(GridS *pGrid, Real dt)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        qa = s*pGrid->U[k][j][i].d;
-        pGrid->U[k][j][i].M1 += qa*dv1[k][j][i];
-        pGrid->U[k][j][i].M2 += qa*dv2[k][j][i];
-        pGrid->U[k][j][i].M3 += qa*dv3[k][j][i];
+        qa = s*UVAR(pGrid,k,j,i,d);
+        UVAR(pGrid,k,j,i,M1) += qa*dv1[k][j][i];
+        UVAR(pGrid,k,j,i,M2) += qa*dv2[k][j][i];
+        UVAR(pGrid,k,j,i,M3) += qa*dv3[k][j][i];
       }
     }
   }
@@ -495,6 +500,9 @@ static void initialize(GridS *pGrid, DomainS *pD)
 
   /* Initialize the FFT plan */
   plan = ath_3d_fft_quick_plan(pD, NULL, ATH_FFT_BACKWARD);
+  cnx3 = plan->cnx3;
+  cks = plan->cks;
+  rnx3 = plan->rnx3;
 
   /* Allocate memory for FFTs */
   if (donedrive == 0) {
@@ -538,10 +546,10 @@ void problem(DomainS *pDomain)
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][j][i].d = rhobar;
-        pGrid->U[k][j][i].M1 = 0.0;
-        pGrid->U[k][j][i].M2 = 0.0;
-        pGrid->U[k][j][i].M3 = 0.0;
+        UVAR(pGrid,k,j,i,d) = rhobar;
+        UVAR(pGrid,k,j,i,M1) = 0.0;
+        UVAR(pGrid,k,j,i,M2) = 0.0;
+        UVAR(pGrid,k,j,i,M3) = 0.0;
       }
     }
   }
@@ -551,9 +559,9 @@ void problem(DomainS *pDomain)
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][j][i].B1c  = B0;
-        pGrid->U[k][j][i].B2c  = 0.0;
-        pGrid->U[k][j][i].B3c  = 0.0;
+        UVAR(pGrid,k,j,i,B1c)  = B0;
+        UVAR(pGrid,k,j,i,B2c)  = 0.0;
+        UVAR(pGrid,k,j,i,B3c)  = 0.0;
         pGrid->B1i[k][j][i] = B0;
         pGrid->B2i[k][j][i] = 0.0;
         pGrid->B3i[k][j][i] = 0.0;
@@ -713,9 +721,9 @@ void problem_read_restart(MeshS *pM, FILE *fp)
  *  \brief Dump kinetic energy in perturbations */
 static Real hst_dEk(const GridS *pG, const int i, const int j, const int k)
 { /* The kinetic energy in perturbations is 0.5*d*V^2 */
-  return 0.5*(pG->U[k][j][i].M1*pG->U[k][j][i].M1 +
-	      pG->U[k][j][i].M2*pG->U[k][j][i].M2 +
-	      pG->U[k][j][i].M3*pG->U[k][j][i].M3)/pG->U[k][j][i].d;
+  return 0.5*(UVAR(pG,k,j,i,M1)*UVAR(pG,k,j,i,M1) +
+	      UVAR(pG,k,j,i,M2)*UVAR(pG,k,j,i,M2) +
+	      UVAR(pG,k,j,i,M3)*UVAR(pG,k,j,i,M3))/UVAR(pG,k,j,i,d);
 }
 
 /*! \fn static Real hst_dEb(const Grid *pG, const int i,const int j,const int k)
@@ -723,9 +731,9 @@ static Real hst_dEk(const GridS *pG, const int i, const int j, const int k)
 static Real hst_dEb(const GridS *pG, const int i, const int j, const int k)
 { /* The magnetic energy in perturbations is 0.5*B^2 - 0.5*B0^2 */
 #ifdef MHD
-  return 0.5*((pG->U[k][j][i].B1c*pG->U[k][j][i].B1c +
-	       pG->U[k][j][i].B2c*pG->U[k][j][i].B2c +
-	       pG->U[k][j][i].B3c*pG->U[k][j][i].B3c)-B0*B0);
+  return 0.5*((UVAR(pG,k,j,i,B1c)*UVAR(pG,k,j,i,B1c) +
+	       UVAR(pG,k,j,i,B2c)*UVAR(pG,k,j,i,B2c) +
+	       UVAR(pG,k,j,i,B3c)*UVAR(pG,k,j,i,B3c))-B0*B0);
 #else /* MHD */
   return 0.0;
 #endif /* MHD */
@@ -0,0 +1,1299 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file amr.c
+ *  \brief Moves refined Domains to follow regions flagged by a refinement
+ *   criterion.
+ *
+ * PURPOSE: Moves refined Domains to follow regions flagged by a refinement
+ *   criterion, so that a refined Domain can track a shock or a collapsing
+ *   core instead of covering every place the feature might pass through.
+ *
+ *   This is NOT general AMR: the refined Domains are fixed-size boxes that
+ *   are moved.  No Domain is ever added, removed, resized or split, and the
+ *   Grids are never rebalanced, so a Domain only tracks a feature that fits
+ *   in it.  A feature that outgrows its Domain, such as the shell of a blast
+ *   wave, is only partly covered, and a second feature far from any Domain is
+ *   not refined at all.  Such problems need Domains placed in the input to
+ *   cover everything that must be refined.
+ *
+ *   Every <amr>/interval steps of the root level, the zones of each Domain
+ *   that has children are flagged where the criterion exceeds
+ *   <amr>/threshold.  Each flagged zone is assigned to the nearest child
+ *   Domain with <domain>/amr=1 (the default), and each such Domain is moved to
+ *   cover the zones assigned to it: centred on the box bounding them if it
+ *   fits, else over the slabs with the most of them, in each direction in
+ *   turn.  Domains keep their size and their division into Grids, so every
+ *   Grid stays on its processor and the load balance is unchanged.  A Domain
+ *   is only moved in steps of one root zone, it stays at least nghost/2 zones
+ *   inside its parent, it never overlaps or touches another Domain on the
+ *   same level, and it is not moved in a direction in which it touches the
+ *   edge of the root Domain.  Children of a moved Domain are moved as needed
+ *   to stay inside it.
+ *
+ *   Zones of a moved Domain that it covered before keep their values, copied
+ *   between Grids (and processors) as needed.  All other zones are filled by
+ *   prolongation from the parent, with the ProCon() and ProFld() operators of
+ *   smr.c, using the fine face-centred fields on faces shared with the zones
+ *   that were kept so that div(B) stays zero.  ProCon() prolongates the
+ *   pressure, so the thermal energy of each prolongated block is then scaled
+ *   to give it the total energy of its parent zone: the next restriction
+ *   leaves the parent, and the total energy of the root Domain, unchanged.
+ *   Regrid() reports any energy that could not be conserved this way.  The
+ *   new positions are stored as iDisp, jDisp and kDisp in the <domain> blocks,
+ *   so restarts use them.
+ *
+ *   The criterion is chosen by <amr>/criterion:
+ *   - "density"  - |grad(d)| dx/d  (default)
+ *   - "pressure" - |grad(P)| dx/P
+ *   - "current"  - |curl(B)| dx/|B|, with MHD only
+ *   - "user"     - the expression "refine_crit" returned by get_usr_expr()
+ *     in the problem generator
+ *   The criterion is evaluated on the zones of the parent Domain, and may use
+ *   their nearest neighbours, including ghost zones.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - AMR_init() - reads the <amr> block
+ * - Regrid()   - moves refined Domains, if due on this step
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - flag_zones()  - counts the flagged zones nearest each Domain
+ * - cover_zones() - position of a Domain that covers the most flagged zones
+ * - fit_domain()  - limits the position of a Domain to lie inside its parent
+ * - move_domain() - moves a Domain, and fills its Grid at the new position
+ * - fetch_region() - gets the data of a Domain in a box of zones
+ * - xfer_box()    - packs or unpacks the data of a box of zones
+ * - box_cut()     - intersection of two boxes of zones or faces
+ * - fill_grid()   - fills a moved Grid with kept and prolongated data
+ * - conserve_energy() - gives a prolongated block the energy of its parent
+ * - crit_*()      - built-in refinement criteria			      */
+/*============================================================================*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+#ifdef STATIC_MESH_REFINEMENT
+
+/*! \struct RegionS
+ *  \brief Copy of the data of one level in a box of zones.  The face-centred
+ *   fields include the faces on the right edges of the box. */
+typedef struct Region_s{
+  SideS box;        /*!< zones covered, as indices on their level */
+  ConsS ***U;       /*!< conserved variables in box */
+#ifdef MHD
+  Real ***B[3];     /*!< interface fields B1i,B2i,B3i on faces of box */
+#endif
+}RegionS;
+
+static int Interval=0;       /* root steps between regrids, 0 to never regrid */
+static Real Threshold;       /* zones are flagged where criterion > Threshold */
+static ConsFun_t CritFun=NULL;
+static int **DomAMR=NULL;    /* 1 for Domains that follow flagged zones */
+static int NDim;             /* number of dimensions of the Mesh */
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   flag_zones  - counts the flagged zones nearest each Domain
+ *   cover_zones - position of a Domain that covers the most flagged zones
+ *   fit_domain  - limits the position of a Domain to lie inside its parent
+ *   move_domain - moves a Domain, and fills its Grid at the new position
+ *   fetch_region - gets the data of a Domain in a box of zones
+ *   xfer_box    - packs or unpacks the data of a box of zones
+ *   box_cut     - intersection of two boxes of zones or faces
+ *   fill_grid   - fills a moved Grid with kept and prolongated data
+ *   conserve_energy - gives a prolongated block the energy of its parent
+ *   crit_*      - built-in refinement criteria
+ *============================================================================*/
+
+static void flag_zones(MeshS *pM, const int nl, int *parent, const int nh,
+  double **hist);
+static void cover_zones(DomainS *pD, DomainS *pPD, const int dir,
+  const double *h, int *disp);
+static void fit_domain(MeshS *pM, DomainS *pD, DomainS *pPD, int *disp);
+static void move_domain(DomainS *pD, DomainS *pPD, int *disp, double *de);
+static void fetch_region(DomainS *pS, DomainS *pD, SideS *want, RegionS *pR);
+static int xfer_box(GridS *pG, const SideS *pS, const SideS *pW, RegionS *pR,
+  double *pBuf, const int unpack);
+static int box_cut(const SideS *pA, const SideS *pB, const int dir,
+  SideS *pC);
+static void fill_grid(GridS *pG, RegionS *pF, RegionS *pP, const SideS *pOld,
+  const SideS *pV, double *de);
+#if !defined(BAROTROPIC) && !defined(SPECIAL_RELATIVITY)
+static void conserve_energy(ConsS PC[][2][2], const ConsS *pU);
+#endif
+static Real crit_density(const GridS *pG, const int i, const int j,
+  const int k);
+#ifndef SPECIAL_RELATIVITY
+static Real crit_pressure(const GridS *pG, const int i, const int j,
+  const int k);
+#endif
+#ifdef MHD
+static Real crit_current(const GridS *pG, const int i, const int j,
+  const int k);
+#endif
+
+/* defined in smr.c */
+void ProCon(const ConsS Uim1,const ConsS Ui,  const ConsS Uip1,
+            const ConsS Ujm1,const ConsS Ujp1,
+            const ConsS Ukm1,const ConsS Ukp1, ConsS PCon[][2][2]);
+#ifdef MHD
+void ProFld(Real3Vect BGZ[][3][3], Real3Vect PFld[][3][3],
+  const Real dx1c, const Real dx2c, const Real dx3c);
+#endif /* MHD */
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void AMR_init(MeshS *pM)
+ *  \brief Reads the <amr> block, and which Domains follow flagged zones */
+
+void AMR_init(MeshS *pM)
+{
+  char block[80],*crit;
+  int nl,nd,maxND=1;
+
+  Interval = par_geti_def("amr","interval",0);
+  if (Interval <= 0) return;
+
+#if defined(SELF_GRAVITY) || defined(PARTICLES)
+  ath_error("[AMR_init]: <amr>/interval > 0 not implemented with self-gravity or particles\n");
+#endif
+#if defined(CYLINDRICAL) || defined(SHEARING_BOX) || defined(FARGO)
+  ath_error("[AMR_init]: <amr>/interval > 0 not implemented with cylindrical coordinates, shearing box or FARGO\n");
+#endif
+  if (par_geti_def("job","overlap_halo",0) != 0)
+    ath_error("[AMR_init]: <job>/overlap_halo cannot be used with <amr>/interval > 0\n");
+
+  NDim = 1;
+  for (nd=1; nd<3; nd++) if (pM->Nx[nd] > 1) NDim++;
+
+/* Refinement criterion */
+
+  Threshold = par_getd_def("amr","threshold",0.1);
+  crit = par_gets_def("amr","criterion","density");
+  if (strcmp(crit,"density") == 0) {
+    CritFun = crit_density;
+  } else if (strcmp(crit,"pressure") == 0) {
+#ifdef SPECIAL_RELATIVITY
+    ath_error("[AMR_init]: criterion=pressure not implemented with special relativity\n");
+#else
+    CritFun = crit_pressure;
+#endif
+  } else if (strcmp(crit,"current") == 0) {
+#ifdef MHD
+    CritFun = crit_current;
+#else
+    ath_error("[AMR_init]: criterion=current needs MHD\n");
+#endif
+  } else if (strcmp(crit,"user") == 0) {
+    if ((CritFun = get_usr_expr("refine_crit")) == NULL)
+      ath_error("[AMR_init]: criterion=user needs expression refine_crit\n");
+  } else {
+    ath_error("[AMR_init]: unknown <amr>/criterion %s\n",crit);
+  }
+  free(crit);
+
+/* Domains on levels > 0 follow flagged zones unless <domain>/amr=0 */
+
+  for (nl=0; nl<(pM->NLevels); nl++) maxND=MAX(maxND,pM->DomainsPerLevel[nl]);
+  if ((DomAMR = (int**)calloc_2d_array(pM->NLevels,maxND,sizeof(int))) == NULL)
+    ath_error("[AMR_init]: Failed to allocate DomAMR\n");
+  for (nl=1; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      sprintf(block,"domain%d",pM->Domain[nl][nd].InputBlock);
+      DomAMR[nl][nd] = par_geti_def(block,"amr",1);
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Regrid(MeshS *pM)
+ *  \brief Moves refined Domains to the flagged zones, every <amr>/interval
+ *   steps.  Must be called by all processes, after boundary values have been
+ *   set on all levels.  Sets them again if any Domain moved. */
+
+void Regrid(MeshS *pM)
+{
+  DomainS *pD,*pPD;
+  SideS D1,D2;
+  char block[80];
+  int nl,nd,npd,ncd,i,nmoved,moved=0,maxND=1,maxNx=1,conflict,pass;
+  int **parent,**disp,old[3];
+  double **hist,de[2];
+#ifdef MPI_PARALLEL
+  double gde[2];
+  int ierr;
+#endif
+
+  if (Interval <= 0 || pM->NLevels < 2 || (pM->nstep % Interval) != 0) return;
+
+  for (nl=0; nl<(pM->NLevels); nl++) {
+    maxND = MAX(maxND,pM->DomainsPerLevel[nl]);
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++)
+      for (i=0; i<3; i++) maxNx = MAX(maxNx,pM->Domain[nl][nd].Nx[i]);
+  }
+  parent = (int**)calloc_2d_array(pM->NLevels,maxND,sizeof(int));
+  disp = (int**)calloc_2d_array(maxND,3,sizeof(int));
+  hist = (double**)calloc_2d_array(maxND,3*maxNx,sizeof(double));
+  if (parent == NULL || disp == NULL || hist == NULL)
+    ath_error("[Regrid]: calloc returned a NULL pointer\n");
+
+/* Find the parent of every Domain before any Domain moves */
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      for (i=0; i<3; i++) {
+        D2.ijkl[i] = pD->Disp[i]/2;
+        D2.ijkr[i] = 1;
+        if (pD->Nx[i] > 1) D2.ijkr[i] = (pD->Disp[i] + pD->Nx[i])/2;
+      }
+      parent[nl][nd] = -1;
+      for (npd=0; npd<(pM->DomainsPerLevel[nl-1]); npd++){
+        pPD = (DomainS*)&(pM->Domain[nl-1][npd]);
+        for (i=0; i<3; i++) {
+          D1.ijkl[i] = pPD->Disp[i];
+          D1.ijkr[i] = pPD->Disp[i] + pPD->Nx[i];
+        }
+        if (D1.ijkl[0] < D2.ijkr[0] && D1.ijkr[0] > D2.ijkl[0] &&
+            D1.ijkl[1] < D2.ijkr[1] && D1.ijkr[1] > D2.ijkl[1] &&
+            D1.ijkl[2] < D2.ijkr[2] && D1.ijkr[2] > D2.ijkl[2])
+          parent[nl][nd] = npd;
+      }
+      if (parent[nl][nd] < 0)
+        ath_error("[Regrid]: no parent for Domain %d\n",pD->InputBlock);
+    }
+  }
+
+/* Move Domains level by level, from the coarsest, so each Domain is placed in
+ * (and filled from) its parent at the parent's new position */
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    flag_zones(pM, nl, parent[nl], 3*maxNx, hist);
+
+/* New positions: covering as many of the flagged zones as possible */
+
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      pPD = (DomainS*)&(pM->Domain[nl-1][parent[nl][nd]]);
+
+      for (i=0; i<3; i++) disp[nd][i] = old[i] = pD->Disp[i];
+      if (DomAMR[nl][nd]) {
+        for (i=0; i<NDim; i++)
+          cover_zones(pD, pPD, i, &(hist[nd][i*maxNx]), &(disp[nd][i]));
+      }
+
+/* Keep it inside its parent, and away from other Domains on this level.  If
+ * the new position is not allowed, fall back to the old one (moved only as
+ * needed to stay inside the parent) */
+
+      for (pass=0; pass<2; pass++) {
+        if (pass == 1) for (i=0; i<3; i++) disp[nd][i] = old[i];
+        fit_domain(pM, pD, pPD, disp[nd]);
+
+        for (i=0; i<3; i++) {
+          D1.ijkl[i] = disp[nd][i];
+          D1.ijkr[i] = disp[nd][i] + pD->Nx[i];
+        }
+        conflict = 0;
+        for (ncd=0; ncd<(pM->DomainsPerLevel[nl]); ncd++){
+          if (ncd == nd) continue;
+          for (i=0; i<3; i++) {
+            D2.ijkl[i] = (ncd < nd ? disp[ncd][i] : pM->Domain[nl][ncd].Disp[i]);
+            D2.ijkr[i] = D2.ijkl[i] + pM->Domain[nl][ncd].Nx[i];
+          }
+          if (D1.ijkl[0] <= D2.ijkr[0] && D1.ijkr[0] >= D2.ijkl[0] &&
+              D1.ijkl[1] <= D2.ijkr[1] && D1.ijkr[1] >= D2.ijkl[1] &&
+              D1.ijkl[2] <= D2.ijkr[2] && D1.ijkr[2] >= D2.ijkl[2])
+            conflict = 1;
+        }
+        if (conflict == 0) break;
+      }
+      if (conflict == 1)
+        ath_error("[Regrid]: Domain %d cannot stay inside its parent without touching another Domain\n",
+          pD->InputBlock);
+    }
+
+/* Move the Domains, and record their new positions for restarts */
+
+    nmoved = 0;
+    de[0] = de[1] = 0.0;
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      if (disp[nd][0] == pD->Disp[0] && disp[nd][1] == pD->Disp[1] &&
+          disp[nd][2] == pD->Disp[2]) continue;
+
+      pPD = (DomainS*)&(pM->Domain[nl-1][parent[nl][nd]]);
+      ath_pout(0,"[Regrid]: level %d Domain %d moved to [%d %d %d]\n",nl,
+        pD->InputBlock,disp[nd][0],disp[nd][1],disp[nd][2]);
+      move_domain(pD, pPD, disp[nd], de);
+
+      sprintf(block,"domain%d",pD->InputBlock);
+      par_seti(block,"iDisp","%d",pD->Disp[0],"i-displacement (moved)");
+      if (pM->Nx[1] > 1)
+        par_seti(block,"jDisp","%d",pD->Disp[1],"j-displacement (moved)");
+      if (pM->Nx[2] > 1)
+        par_seti(block,"kDisp","%d",pD->Disp[2],"k-displacement (moved)");
+      nmoved++;
+    }
+
+/* The zones prolongated on this level must restrict back to their parents,
+ * else the next RestrictCorrect() changes the total energy of the root */
+
+#ifdef MPI_PARALLEL
+    ierr = MPI_Allreduce(de,gde,2,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+    de[0] = gde[0];
+    de[1] = gde[1];
+#endif
+    if (fabs(de[0]) > 1.0e-10*de[1])
+      ath_perr(0,"[Regrid]: prolongation on level %d changed the total energy by %e (of %e)\n",
+        nl,de[0],de[1]);
+
+/* Find the new overlaps between child and parent Grids.  The ghost zones of
+ * this level are needed by the criterion on the next level */
+
+    if (nmoved > 0) {
+      free_grid_smr(pM);
+      init_grid_smr(pM);
+      SMR_init(pM);
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (pM->Domain[nl][nd].Grid != NULL) bvals_mhd(&(pM->Domain[nl][nd]));
+      }
+      Prolongate_Level(pM, nl, 1.0);
+      moved = 1;
+    }
+  }
+
+/* Children of moved Domains need new ghost zones even if they did not move */
+
+  if (moved) {
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (pM->Domain[nl][nd].Grid != NULL) bvals_mhd(&(pM->Domain[nl][nd]));
+      }
+    }
+    Prolongate(pM);
+  }
+
+  free_2d_array(parent);
+  free_2d_array(disp);
+  free_2d_array(hist);
+  return;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void flag_zones(MeshS *pM, const int nl, int *parent,
+ *                             const int nh, double **hist)
+ *  \brief Flags zones of the Domains on level nl-1, and assigns each flagged
+ *   zone to the nearest Domain on level nl that follows flagged zones and is a
+ *   child of the Domain of the zone.  Returns for each Domain nd on level nl
+ *   the number of zones assigned to it in each slab of its parent normal to
+ *   x1, x2 and x3, in hist[nd][dir*nh/3 + c], where c is the index of the slab
+ *   counted from the left edge of the parent. */
+
+static void flag_zones(MeshS *pM, const int nl, int *parent, const int nh,
+  double **hist)
+{
+  DomainS *pD;
+  GridS *pG;
+  int i,j,k,n,nd,npd,ncd,idx[3];
+  double r2,rmin,dx;
+#ifdef MPI_PARALLEL
+  double *gsum;
+  int ierr;
+#endif
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++)
+    for (n=0; n<nh; n++) hist[nd][n] = 0.0;
+
+  for (npd=0; npd<(pM->DomainsPerLevel[nl-1]); npd++){
+    if (pM->Domain[nl-1][npd].Grid == NULL) continue;
+    pG = pM->Domain[nl-1][npd].Grid;
+
+    for (ncd=0, nd=0; nd<(pM->DomainsPerLevel[nl]); nd++)
+      if (parent[nd] == npd && DomAMR[nl][nd]) ncd++;
+    if (ncd == 0) continue;
+
+    for (k=pG->ks; k<=pG->ke; k++) {
+    for (j=pG->js; j<=pG->je; j++) {
+    for (i=pG->is; i<=pG->ie; i++) {
+      if ((*CritFun)(pG,i,j,k) <= Threshold) continue;
+
+      idx[0] = i - pG->is + pG->Disp[0];
+      idx[1] = j - pG->js + pG->Disp[1];
+      idx[2] = k - pG->ks + pG->Disp[2];
+      ncd = -1;
+      rmin = 0.0;
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (parent[nd] != npd || DomAMR[nl][nd] == 0) continue;
+        pD = (DomainS*)&(pM->Domain[nl][nd]);
+        for (r2=0.0, n=0; n<NDim; n++) {
+          dx = (double)idx[n] + 0.5
+             - 0.5*((double)(pD->Disp[n]) + 0.5*(double)(pD->Nx[n]));
+          r2 += dx*dx;
+        }
+        if (ncd < 0 || r2 < rmin) {
+          ncd = nd;
+          rmin = r2;
+        }
+      }
+
+      for (n=0; n<3; n++)
+        hist[ncd][n*(nh/3) + idx[n] - pM->Domain[nl-1][npd].Disp[n]] += 1.0;
+    }}}
+  }
+
+#ifdef MPI_PARALLEL
+  n = (pM->DomainsPerLevel[nl])*nh;
+  if ((gsum = (double*)calloc_1d_array(n,sizeof(double))) == NULL)
+    ath_error("[flag_zones]: calloc returned a NULL pointer\n");
+  ierr = MPI_Allreduce(hist[0],gsum,n,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  for (i=0; i<n; i++) hist[0][i] = gsum[i];
+  free_1d_array(gsum);
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void cover_zones(DomainS *pD, DomainS *pPD, const int dir,
+ *                              const double *h, int *disp)
+ *  \brief Sets the position disp of Domain pD in direction dir to the one
+ *   that covers the most flagged zones, given their number h[c] in each slab
+ *   c of the parent pPD normal to dir (from flag_zones()).  Positions are in
+ *   steps of one root zone, at least nghost/2 zones inside the parent.  If
+ *   several positions cover all flagged zones, the one centred on them is
+ *   taken.  If none does, the Domain is only moved if that covers at least
+ *   10% more flagged zones, so that it does not jitter between nearly equal
+ *   positions, and then to the best position nearest the old one.  disp is
+ *   left unchanged if no zone is flagged.
+ *
+ *   Since the zones are counted in slabs, each direction is placed on its
+ *   own: the Domain covers the box bounding the flagged zones if it fits,
+ *   else the slabs with the most flagged zones. */
+
+static void cover_zones(DomainS *pD, DomainS *pPD, const int dir,
+  const double *h, int *disp)
+{
+  int c,d,lo=-1,hi=-1,np,nw,dmin,dmax,dbest=-1,dist,dbmin=0,ctr,irefine=1;
+  double cnt,cmax=-1.0,cold=0.0,ctot=0.0;
+
+  np = pPD->Nx[dir];
+  for (c=0; c<np; c++) {
+    if (h[c] <= 0.0) continue;
+    if (lo < 0) lo = c;
+    hi = c;
+    ctot += h[c];
+  }
+  if (lo < 0) return;
+
+/* Positions allowed by fit_domain(), and the width of the Domain in zones of
+ * the parent */
+
+  for (c=1; c<=(pD->Level); c++) irefine *= 2;
+  dmin = 2*(pPD->Disp[dir]) + nghost;
+  dmin = ((dmin + irefine - 1)/irefine)*irefine;
+  dmax = 2*(pPD->Disp[dir] + np) - nghost - pD->Nx[dir];
+  dmax = (dmax/irefine)*irefine;
+  nw = pD->Nx[dir]/2;
+
+/* Most flagged zones covered by any position */
+
+  for (d=dmin; d<=dmax; d+=irefine) {
+    for (cnt=0.0, c=MAX(d/2-pPD->Disp[dir],0);
+         c<MIN(d/2-pPD->Disp[dir]+nw,np); c++) cnt += h[c];
+    cmax = MAX(cmax,cnt);
+  }
+  if (cmax < 0.0) return;
+
+  d = pD->Disp[dir];
+  for (c=MAX(d/2-pPD->Disp[dir],0); c<MIN(d/2-pPD->Disp[dir]+nw,np); c++)
+    cold += h[c];
+  if (cmax < ctot && 1.1*cold >= cmax) return;
+
+/* Of the positions covering that many, the one centred on the flagged zones
+ * if they are all covered, else the one nearest the old position.  ctr is
+ * twice the position centred on the flagged zones, in zones of this level */
+
+  ctr = 2*(2*(pPD->Disp[dir]) + lo + hi + 1) - pD->Nx[dir];
+  for (d=dmin; d<=dmax; d+=irefine) {
+    for (cnt=0.0, c=MAX(d/2-pPD->Disp[dir],0);
+         c<MIN(d/2-pPD->Disp[dir]+nw,np); c++) cnt += h[c];
+    if (cnt < cmax) continue;
+    dist = (cmax == ctot) ? abs(2*d - ctr) : abs(d - pD->Disp[dir]);
+    if (dbest < 0 || dist < dbmin) {
+      dbest = d;
+      dbmin = dist;
+    }
+  }
+  *disp = dbest;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fit_domain(MeshS *pM, DomainS *pD, DomainS *pPD, int *disp)
+ *  \brief Limits the position disp of Domain pD so that it is at least nghost/2
+ *   zones inside its parent pPD, in each direction in which pD does not touch
+ *   the edge of the root Domain (in which it keeps its position). */
+
+static void fit_domain(MeshS *pM, DomainS *pD, DomainS *pPD, int *disp)
+{
+  int i,irefine=1,lo,hi;
+
+  for (i=1; i<=(pD->Level); i++) irefine *= 2;
+
+  for (i=0; i<NDim; i++) {
+    if (pD->Disp[i] == 0 ||
+        (pD->Disp[i] + pD->Nx[i])/irefine == pM->Nx[i]) {
+      disp[i] = pD->Disp[i];
+      continue;
+    }
+
+    lo = 2*(pPD->Disp[i]) + nghost;
+    lo = ((lo + irefine - 1)/irefine)*irefine;
+    hi = 2*(pPD->Disp[i] + pPD->Nx[i]) - nghost - pD->Nx[i];
+    hi = (hi/irefine)*irefine;
+
+    if (disp[i] < lo) disp[i] = lo;
+    if (disp[i] > hi) disp[i] = hi;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void move_domain(DomainS *pD, DomainS *pPD, int *disp,
+ *                               double *de)
+ *  \brief Moves Domain pD to position disp, and fills the interior of its Grid
+ *   on this processor with the data it had before where it overlaps its old
+ *   position, and with data prolongated from the parent pPD elsewhere.  Adds
+ *   to de[] the total energy not conserved by the prolongation (see
+ *   fill_grid()). */
+
+static void move_domain(DomainS *pD, DomainS *pPD, int *disp, double *de)
+{
+  GridS *pG;
+  SideS *want,old,valid;
+  RegionS F,P;
+  int i,l,m,n,g,ng,shift[3];
+
+  ng = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  if ((want = (SideS*)calloc_1d_array(ng,sizeof(SideS))) == NULL)
+    ath_error("[move_domain]: calloc returned a NULL pointer\n");
+
+  for (i=0; i<3; i++) {
+    shift[i] = disp[i] - pD->Disp[i];
+    old.ijkl[i] = pD->Disp[i];
+    old.ijkr[i] = pD->Disp[i] + pD->Nx[i];
+    valid.ijkl[i] = pPD->Disp[i];
+    valid.ijkr[i] = pPD->Disp[i] + pPD->Nx[i];
+  }
+
+/* Zones each Grid needs from the Domain at its old position: the zones of the
+ * Grid at its new position, widened to whole zones of the parent */
+
+  for (n=0; n<(pD->NGrid[2]); n++){
+  for (m=0; m<(pD->NGrid[1]); m++){
+  for (l=0; l<(pD->NGrid[0]); l++){
+    g = (n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l;
+    for (i=0; i<3; i++) {
+      want[g].ijkl[i] = pD->GData[n][m][l].Disp[i] + shift[i];
+      want[g].ijkr[i] = want[g].ijkl[i] + pD->GData[n][m][l].Nx[i];
+      if (i < NDim) {
+        want[g].ijkl[i] = 2*(want[g].ijkl[i]/2);
+        want[g].ijkr[i] = 2*((want[g].ijkr[i] + 1)/2);
+      }
+    }
+  }}}
+  fetch_region(pD, pD, want, &F);
+
+/* Zones each Grid needs from the parent: those it covers, and one more on
+ * each side for the slopes */
+
+  for (g=0; g<ng; g++){
+    for (i=0; i<NDim; i++) {
+      want[g].ijkl[i] = want[g].ijkl[i]/2 - 1;
+      want[g].ijkr[i] = want[g].ijkr[i]/2 + 1;
+    }
+  }
+  fetch_region(pPD, pD, want, &P);
+
+/* Move the Domain and its Grids, computing positions as in init_mesh() and
+ * init_grid() so that a restart rebuilds the same Grids */
+
+  for (i=0; i<NDim; i++) {
+    pD->Disp[i] = disp[i];
+    pD->MinX[i] = pD->RootMinX[i] + ((Real)(pD->Disp[i]))*pD->dx[i];
+    pD->MaxX[i] = pD->MinX[i] + ((Real)(pD->Nx[i]))*pD->dx[i];
+  }
+  for (n=0; n<(pD->NGrid[2]); n++){
+  for (m=0; m<(pD->NGrid[1]); m++){
+  for (l=0; l<(pD->NGrid[0]); l++){
+    for (i=0; i<3; i++) pD->GData[n][m][l].Disp[i] += shift[i];
+  }}}
+
+  if (pD->Grid != NULL) {
+    pG = pD->Grid;
+    get_myGridIndex(pD, myID_Comm_world, &l, &m, &n);
+    for (i=0; i<3; i++) pG->Disp[i] += shift[i];
+    pG->MinX[0] = pD->MinX[0];
+    for (i=1; i<=l; i++)
+      pG->MinX[0] += (Real)(pD->GData[n][m][i-1].Nx[0])*pG->dx1;
+    pG->MaxX[0] = pG->MinX[0] + (Real)(pG->Nx[0])*pG->dx1;
+    pG->MinX[1] = pD->MinX[1];
+    for (i=1; i<=m; i++)
+      pG->MinX[1] += (Real)(pD->GData[n][i-1][l].Nx[1])*pG->dx2;
+    pG->MaxX[1] = pG->MinX[1] + (Real)(pG->Nx[1])*pG->dx2;
+    pG->MinX[2] = pD->MinX[2];
+    for (i=1; i<=n; i++)
+      pG->MinX[2] += (Real)(pD->GData[i-1][m][l].Nx[2])*pG->dx3;
+    pG->MaxX[2] = pG->MinX[2] + (Real)(pG->Nx[2])*pG->dx3;
+
+    fill_grid(pG, &F, &P, &old, &valid, de);
+
+    free_3d_array(F.U);
+    free_3d_array(P.U);
+#ifdef MHD
+    for (i=0; i<3; i++) {
+      free_3d_array(F.B[i]);
+      free_3d_array(P.B[i]);
+    }
+#endif
+  }
+
+  free_1d_array(want);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fetch_region(DomainS *pS, DomainS *pD, SideS *want,
+ *                               RegionS *pR)
+ *  \brief Copies the zones of Domain pS (at the position given by its GData
+ *   array) that lie in box want[g] into region pR of the Grid g of Domain pD
+ *   on this processor.  want[] is indexed by the position (l,m,n) of the Grids
+ *   of pD as (n*NGrid[1] + m)*NGrid[0] + l.  Must be called by all processes
+ *   with Grids in pS or pD.  pR is only allocated on processes with a Grid in
+ *   pD.  Zones of pR not in pS are left zero. */
+
+static void fetch_region(DomainS *pS, DomainS *pD, SideS *want, RegionS *pR)
+{
+  SideS src;
+  int i,l,m,n,g,s0=-1,g0=-1,nw,n1,n2,n3;
+  double *buf;
+#ifdef MPI_PARALLEL
+  double **rbuf,**sbuf;
+  MPI_Request *rrq,*srq;
+  int s,nsg,ndg,nr=0,ns=0,ierr;
+#endif
+
+  if (pS->Grid != NULL) {
+    get_myGridIndex(pS, myID_Comm_world, &l, &m, &n);
+    s0 = (n*(pS->NGrid[1]) + m)*(pS->NGrid[0]) + l;
+  }
+  if (pD->Grid != NULL) {
+    get_myGridIndex(pD, myID_Comm_world, &l, &m, &n);
+    g0 = (n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l;
+
+    pR->box = want[g0];
+    n1 = pR->box.ijkr[0] - pR->box.ijkl[0];
+    n2 = pR->box.ijkr[1] - pR->box.ijkl[1];
+    n3 = pR->box.ijkr[2] - pR->box.ijkl[2];
+    if ((pR->U = (ConsS***)calloc_3d_array(n3,n2,n1,sizeof(ConsS))) == NULL)
+      ath_error("[fetch_region]: calloc returned a NULL pointer\n");
+#ifdef MHD
+    for (i=0; i<3; i++) {
+      if ((pR->B[i] = (Real***)calloc_3d_array(n3+1,n2+1,n1+1,sizeof(Real)))
+        == NULL) ath_error("[fetch_region]: calloc returned a NULL pointer\n");
+    }
+#endif
+  }
+
+#ifdef MPI_PARALLEL
+  nsg = (pS->NGrid[0])*(pS->NGrid[1])*(pS->NGrid[2]);
+  ndg = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  rbuf = (double**)calloc_1d_array(nsg,sizeof(double*));
+  sbuf = (double**)calloc_1d_array(ndg,sizeof(double*));
+  rrq = (MPI_Request*)calloc_1d_array(nsg,sizeof(MPI_Request));
+  srq = (MPI_Request*)calloc_1d_array(ndg,sizeof(MPI_Request));
+  if (rbuf == NULL || sbuf == NULL || rrq == NULL || srq == NULL)
+    ath_error("[fetch_region]: calloc returned a NULL pointer\n");
+
+/* Post receives from the Grids of pS on other processors */
+
+  if (g0 >= 0) {
+    for (n=0; n<(pS->NGrid[2]); n++){
+    for (m=0; m<(pS->NGrid[1]); m++){
+    for (l=0; l<(pS->NGrid[0]); l++){
+      s = (n*(pS->NGrid[1]) + m)*(pS->NGrid[0]) + l;
+      if (pS->GData[n][m][l].ID_Comm_world == myID_Comm_world) continue;
+      for (i=0; i<3; i++) {
+        src.ijkl[i] = pS->GData[n][m][l].Disp[i];
+        src.ijkr[i] = src.ijkl[i] + pS->GData[n][m][l].Nx[i];
+      }
+      nw = xfer_box(NULL, &src, &want[g0], pR, NULL, 1);
+      if (nw == 0) continue;
+      if ((rbuf[s] = (double*)calloc_1d_array(nw,sizeof(double))) == NULL)
+        ath_error("[fetch_region]: calloc returned a NULL pointer\n");
+      ierr = MPI_Irecv(rbuf[s], nw, MPI_DOUBLE,
+        pS->GData[n][m][l].ID_Comm_world, pD->DomNumber, MPI_COMM_WORLD,
+        &(rrq[nr++]));
+    }}}
+  }
+#endif /* MPI_PARALLEL */
+
+/* Send the zones of the Grid of pS on this processor to every Grid of pD that
+ * needs them, copying directly to the Grid on this processor */
+
+  if (s0 >= 0) {
+    for (i=0; i<3; i++) {
+      src.ijkl[i] = pS->Grid->Disp[i];
+      src.ijkr[i] = src.ijkl[i] + pS->Grid->Nx[i];
+    }
+    for (n=0; n<(pD->NGrid[2]); n++){
+    for (m=0; m<(pD->NGrid[1]); m++){
+    for (l=0; l<(pD->NGrid[0]); l++){
+      g = (n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l;
+      nw = xfer_box(NULL, &src, &want[g], NULL, NULL, 0);
+      if (nw == 0) continue;
+      if ((buf = (double*)calloc_1d_array(nw,sizeof(double))) == NULL)
+        ath_error("[fetch_region]: calloc returned a NULL pointer\n");
+      xfer_box(pS->Grid, &src, &want[g], NULL, buf, 0);
+      if (g == g0) {
+        xfer_box(NULL, &src, &want[g], pR, buf, 1);
+        free_1d_array(buf);
+      } else {
+#ifdef MPI_PARALLEL
+        sbuf[g] = buf;
+        ierr = MPI_Isend(buf, nw, MPI_DOUBLE,
+          pD->GData[n][m][l].ID_Comm_world, pD->DomNumber, MPI_COMM_WORLD,
+          &(srq[ns++]));
+#endif
+      }
+    }}}
+  }
+
+#ifdef MPI_PARALLEL
+/* Unpack the zones received */
+
+  if (nr > 0) ierr = MPI_Waitall(nr, rrq, MPI_STATUSES_IGNORE);
+  for (n=0; n<(pS->NGrid[2]); n++){
+  for (m=0; m<(pS->NGrid[1]); m++){
+  for (l=0; l<(pS->NGrid[0]); l++){
+    s = (n*(pS->NGrid[1]) + m)*(pS->NGrid[0]) + l;
+    if (rbuf[s] == NULL) continue;
+    for (i=0; i<3; i++) {
+      src.ijkl[i] = pS->GData[n][m][l].Disp[i];
+      src.ijkr[i] = src.ijkl[i] + pS->GData[n][m][l].Nx[i];
+    }
+    xfer_box(NULL, &src, &want[g0], pR, rbuf[s], 1);
+    free_1d_array(rbuf[s]);
+  }}}
+
+  if (ns > 0) ierr = MPI_Waitall(ns, srq, MPI_STATUSES_IGNORE);
+  for (g=0; g<ndg; g++) if (sbuf[g] != NULL) free_1d_array(sbuf[g]);
+
+  free_1d_array(rbuf);
+  free_1d_array(sbuf);
+  free_1d_array(rrq);
+  free_1d_array(srq);
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int xfer_box(GridS *pG, const SideS *pS, const SideS *pW,
+ *                          RegionS *pR, double *pBuf, const int unpack)
+ *  \brief Counts, packs or unpacks the data in the zones common to the box pS
+ *   (the zones of a Grid) and the box pW (wanted by region pR), and the
+ *   interface fields on their faces.
+ *
+ *   With pBuf=NULL only returns the number of words.  Otherwise with unpack=0
+ *   packs the data from Grid pG into pBuf, and with unpack=1 unpacks pBuf into
+ *   region pR. */
+
+static int xfer_box(GridS *pG, const SideS *pS, const SideS *pW, RegionS *pR,
+  double *pBuf, const int unpack)
+{
+  SideS C;
+  int i,j,k,ii,jj,kk,n,nw;
+#ifdef MHD
+  int dir;
+  Real ***pB;
+#endif
+
+/* zones */
+
+  nw = (NVAR)*box_cut(pS, pW, -1, &C);
+  if (pBuf != NULL) {
+    for (k=C.ijkl[2]; k<C.ijkr[2]; k++) {
+    for (j=C.ijkl[1]; j<C.ijkr[1]; j++) {
+    for (i=C.ijkl[0]; i<C.ijkr[0]; i++) {
+      if (unpack) {
+        kk = k - pR->box.ijkl[2];
+        jj = j - pR->box.ijkl[1];
+        ii = i - pR->box.ijkl[0];
+        for (n=0; n<(NVAR); n++)
+          ((Real *)&(pR->U[kk][jj][ii]))[n] = *(pBuf++);
+      } else {
+        kk = k - pG->Disp[2] + pG->ks;
+        jj = j - pG->Disp[1] + pG->js;
+        ii = i - pG->Disp[0] + pG->is;
+        for (n=0; n<(NVAR); n++) *(pBuf++) = UCOMP(pG,kk,jj,ii,n);
+      }
+    }}}
+  }
+
+#ifdef MHD
+/* interface fields, including the right faces of both boxes */
+
+  for (dir=0; dir<3; dir++) {
+    n = box_cut(pS, pW, (dir < NDim ? dir : -1), &C);
+    nw += n;
+    if (pBuf == NULL || n == 0) continue;
+
+    if (unpack) {
+      pB = pR->B[dir];
+    } else {
+      if (dir == 0) pB = pG->B1i;
+      if (dir == 1) pB = pG->B2i;
+      if (dir == 2) pB = pG->B3i;
+    }
+    for (k=C.ijkl[2]; k<C.ijkr[2]; k++) {
+    for (j=C.ijkl[1]; j<C.ijkr[1]; j++) {
+    for (i=C.ijkl[0]; i<C.ijkr[0]; i++) {
+      if (unpack) {
+        pB[k-pR->box.ijkl[2]][j-pR->box.ijkl[1]][i-pR->box.ijkl[0]] =
+          *(pBuf++);
+      } else {
+        *(pBuf++) = pB[k - pG->Disp[2] + pG->ks][j - pG->Disp[1] + pG->js]
+                      [i - pG->Disp[0] + pG->is];
+      }
+    }}}
+  }
+#endif /* MHD */
+
+  return nw;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int box_cut(const SideS *pA, const SideS *pB, const int dir,
+ *                         SideS *pC)
+ *  \brief Sets pC to the zones common to boxes pA and pB, or with dir >= 0 to
+ *   their common faces normal to direction dir (including the faces on the
+ *   right edges).  Returns the number of zones or faces. */
+
+static int box_cut(const SideS *pA, const SideS *pB, const int dir, SideS *pC)
+{
+  int i,n=1;
+
+  for (i=0; i<3; i++) {
+    pC->ijkl[i] = MAX(pA->ijkl[i],pB->ijkl[i]);
+    pC->ijkr[i] = MIN(pA->ijkr[i],pB->ijkr[i]);
+    if (i == dir) pC->ijkr[i]++;
+    if (pC->ijkr[i] <= pC->ijkl[i]) {
+      pC->ijkr[i] = pC->ijkl[i];
+      n = 0;
+    }
+    n *= (pC->ijkr[i] - pC->ijkl[i]);
+  }
+
+  return n;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fill_grid(GridS *pG, RegionS *pF, RegionS *pP,
+ *                            const SideS *pOld, const SideS *pV, double *de)
+ *  \brief Fills the interior of the moved Grid pG.  Zones inside the old
+ *   position pOld of the Domain are copied from pF.  Others are prolongated
+ *   from the parent zones in pP, of which only those in box pV exist.
+ *
+ *   The Grid is filled in blocks of 2x2x2 zones (one parent zone).  Since the
+ *   old position of the Domain is made of whole parent zones, each block is
+ *   either kept or prolongated.  The face-centred fields of prolongated blocks
+ *   are set by ProFld(), given the fine fields on faces shared with kept
+ *   blocks, as in Prolongate().
+ *
+ *   Prolongated blocks get the total energy of their parent zone (see
+ *   conserve_energy()), so that restricting them leaves the parent, and the
+ *   total energy of the root Domain, unchanged.  Adds to de[0] the sum over
+ *   the prolongated zones of this Grid of the fine minus the parent energy
+ *   (per parent zone), and to de[1] the sum of |parent energy|. */
+
+static void fill_grid(GridS *pG, RegionS *pF, RegionS *pP, const SideS *pOld,
+  const SideS *pV, double *de)
+{
+  ConsS PC[2][2][2];
+  int ci,cj,ck,cl[3],cr[3],fi,fj,fk,i,j,k,l,m,n,lend,mend,nend,in[3];
+  int im,ip,jm,jp,km,kp;
+#ifdef MHD
+  Real3Vect BGZ[3][3][3], PF[3][3][3];
+  int ll,mm,nn,ic,jc,kc;
+#endif
+#ifndef BAROTROPIC
+  const ConsS *pU;
+  Real nz;
+#endif
+
+  lend = 1;
+  mend = (NDim > 1) ? 1 : 0;
+  nend = (NDim > 2) ? 1 : 0;
+#ifndef BAROTROPIC
+  nz = (Real)((lend+1)*(mend+1)*(nend+1));
+#endif
+
+/* parent zones that overlap this Grid */
+
+  for (i=0; i<3; i++) {
+    cl[i] = cr[i] = 0;
+    if (i < NDim) {
+      cl[i] = pG->Disp[i]/2;
+      cr[i] = (pG->Disp[i] + pG->Nx[i] - 1)/2;
+    }
+  }
+
+  for (ck=cl[2]; ck<=cr[2]; ck++) {
+  for (cj=cl[1]; cj<=cr[1]; cj++) {
+  for (ci=cl[0]; ci<=cr[0]; ci++) {
+    fi = 2*ci;
+    fj = (NDim > 1) ? 2*cj : 0;
+    fk = (NDim > 2) ? 2*ck : 0;
+
+    in[0] = (fi >= pOld->ijkl[0] && fi < pOld->ijkr[0]);
+    in[1] = (fj >= pOld->ijkl[1] && fj < pOld->ijkr[1]);
+    in[2] = (fk >= pOld->ijkl[2] && fk < pOld->ijkr[2]);
+
+/*--- Block kept from the old position ---------------------------------------*/
+
+    if (in[0] && in[1] && in[2]) {
+      for (n=0; n<=nend; n++) {
+      for (m=0; m<=mend; m++) {
+      for (l=0; l<=lend; l++) {
+        i = fi + l - pG->Disp[0];
+        j = fj + m - pG->Disp[1];
+        k = fk + n - pG->Disp[2];
+        if (i < 0 || i >= pG->Nx[0] || j < 0 || j >= pG->Nx[1] ||
+            k < 0 || k >= pG->Nx[2]) continue;
+        USET(pG, k+pG->ks, j+pG->js, i+pG->is,
+          pF->U[fk+n-pF->box.ijkl[2]][fj+m-pF->box.ijkl[1]]
+               [fi+l-pF->box.ijkl[0]]);
+#ifdef MHD
+        ll = fi + l - pF->box.ijkl[0];
+        mm = fj + m - pF->box.ijkl[1];
+        nn = fk + n - pF->box.ijkl[2];
+        pG->B1i[k+pG->ks][j+pG->js][i+pG->is] = pF->B[0][nn][mm][ll];
+        pG->B2i[k+pG->ks][j+pG->js][i+pG->is] = pF->B[1][nn][mm][ll];
+        pG->B3i[k+pG->ks][j+pG->js][i+pG->is] = pF->B[2][nn][mm][ll];
+        if (i == pG->Nx[0]-1)
+          pG->B1i[k+pG->ks][j+pG->js][i+pG->is+1] = pF->B[0][nn][mm][ll+1];
+        if (NDim > 1 && j == pG->Nx[1]-1)
+          pG->B2i[k+pG->ks][j+pG->js+1][i+pG->is] = pF->B[1][nn][mm+1][ll];
+        if (NDim > 2 && k == pG->Nx[2]-1)
+          pG->B3i[k+pG->ks+1][j+pG->js][i+pG->is] = pF->B[2][nn+1][mm][ll];
+#endif /* MHD */
+      }}}
+      continue;
+    }
+
+/*--- Block prolongated from the parent --------------------------------------*/
+/* Neighbours outside the parent Domain are replaced by the zone itself */
+
+    im = (ci-1 >= pV->ijkl[0]) ? ci-1 : ci;
+    ip = (ci+1 <  pV->ijkr[0]) ? ci+1 : ci;
+    jm = (NDim > 1 && cj-1 >= pV->ijkl[1]) ? cj-1 : cj;
+    jp = (NDim > 1 && cj+1 <  pV->ijkr[1]) ? cj+1 : cj;
+    km = (NDim > 2 && ck-1 >= pV->ijkl[2]) ? ck-1 : ck;
+    kp = (NDim > 2 && ck+1 <  pV->ijkr[2]) ? ck+1 : ck;
+
+#define PZ(kz,jz,iz) (pP->U[(kz)-pP->box.ijkl[2]][(jz)-pP->box.ijkl[1]] \
+                            [(iz)-pP->box.ijkl[0]])
+    ProCon(PZ(ck,cj,im),PZ(ck,cj,ci),PZ(ck,cj,ip),
+           PZ(ck,jm,ci),                PZ(ck,jp,ci),
+           PZ(km,cj,ci),                PZ(kp,cj,ci), PC);
+#ifndef BAROTROPIC
+    pU = &(PZ(ck,cj,ci));
+#endif
+#undef PZ
+
+#ifdef MHD
+/* Parent fields on the faces of the 3x3x3 parent zones around the block, with
+ * neighbours outside the parent Domain replaced as above */
+
+    if (NDim > 1) {
+      for (n=0; n<3; n++) {
+      for (m=0; m<3; m++) {
+      for (l=0; l<3; l++) {
+        ic = (l == 0) ? im : ((l == 2) ? ip : ci);
+        jc = (m == 0) ? jm : ((m == 2) ? jp : cj);
+        kc = (n == 0) ? km : ((n == 2) ? kp : ck);
+        ic -= pP->box.ijkl[0];
+        jc -= pP->box.ijkl[1];
+        kc -= pP->box.ijkl[2];
+        ll = ((l == 0) ? im : ci + l - 1) - pP->box.ijkl[0];
+        mm = ((m == 0) ? jm : cj + m - 1) - pP->box.ijkl[1];
+        nn = ((n == 0) ? km : ck + n - 1) - pP->box.ijkl[2];
+        if (NDim == 2) nn = ck - pP->box.ijkl[2];
+        BGZ[n][m][l].x1 = pP->B[0][kc][jc][ll];
+        BGZ[n][m][l].x2 = pP->B[1][kc][mm][ic];
+        BGZ[n][m][l].x3 = pP->B[2][nn][jc][ic];
+        PF[n][m][l].x1 = 0.0;
+        PF[n][m][l].x2 = 0.0;
+        PF[n][m][l].x3 = 0.0;
+      }}}
+
+/* Fine fields on faces shared with kept blocks */
+
+#define FB(d,kz,jz,iz) (pF->B[d][(kz)-pF->box.ijkl[2]][(jz)-pF->box.ijkl[1]] \
+                                [(iz)-pF->box.ijkl[0]])
+      for (l=0; l<=2; l+=2) {
+        ll = fi + (l == 0 ? -1 : 2);
+        if (in[1] && in[2] && ll >= pOld->ijkl[0] && ll < pOld->ijkr[0]) {
+          for (n=0; n<2; n++) {
+          for (m=0; m<2; m++) {
+            PF[n][m][l].x1 = FB(0, fk+n*nend, fj+m, fi+l);
+          }}
+        }
+      }
+      for (m=0; m<=2; m+=2) {
+        mm = fj + (m == 0 ? -1 : 2);
+        if (in[0] && in[2] && mm >= pOld->ijkl[1] && mm < pOld->ijkr[1]) {
+          for (n=0; n<2; n++) {
+          for (l=0; l<2; l++) {
+            PF[n][m][l].x2 = FB(1, fk+n*nend, fj+m, fi+l);
+          }}
+        }
+      }
+      if (NDim > 2) {
+        for (n=0; n<=2; n+=2) {
+          nn = fk + (n == 0 ? -1 : 2);
+          if (in[0] && in[1] && nn >= pOld->ijkl[2] && nn < pOld->ijkr[2]) {
+            for (m=0; m<2; m++) {
+            for (l=0; l<2; l++) {
+              PF[n][m][l].x3 = FB(2, fk+n, fj+m, fi+l);
+            }}
+          }
+        }
+      }
+#undef FB
+
+      ProFld(BGZ, PF, pG->dx1, pG->dx2, pG->dx3);
+
+      for (n=0; n<=nend; n++) {
+      for (m=0; m<=mend; m++) {
+      for (l=0; l<=lend; l++) {
+        PC[n][m][l].B1c = 0.5*(PF[n][m][l].x1 + PF[n][m][l+1].x1);
+        PC[n][m][l].B2c = 0.5*(PF[n][m][l].x2 + PF[n][m+1][l].x2);
+        PC[n][m][l].B3c = 0.5*(PF[n][m][l].x3 + PF[n+1][m][l].x3);
+      }}}
+    }
+#endif /* MHD */
+
+#if !defined(BAROTROPIC) && !defined(SPECIAL_RELATIVITY)
+    conserve_energy(PC, pU);
+#endif
+
+/* Store the zones of the block that are in this Grid */
+
+    for (n=0; n<=nend; n++) {
+    for (m=0; m<=mend; m++) {
+    for (l=0; l<=lend; l++) {
+      i = fi + l - pG->Disp[0];
+      j = fj + m - pG->Disp[1];
+      k = fk + n - pG->Disp[2];
+      if (i < 0 || i >= pG->Nx[0] || j < 0 || j >= pG->Nx[1] ||
+          k < 0 || k >= pG->Nx[2]) continue;
+      i += pG->is;
+      j += pG->js;
+      k += pG->ks;
+
+      USET(pG, k, j, i, PC[n][m][l]);
+#ifdef MHD
+      if (NDim == 1) {
+        pG->B1i[k][j][i] = UVAR(pG,k,j,i,B1c);
+        pG->B2i[k][j][i] = UVAR(pG,k,j,i,B2c);
+        pG->B3i[k][j][i] = UVAR(pG,k,j,i,B3c);
+        if (i == pG->ie) pG->B1i[k][j][i+1] = UVAR(pG,k,j,i,B1c);
+      } else {
+        pG->B1i[k][j][i] = PF[n][m][l].x1;
+        pG->B2i[k][j][i] = PF[n][m][l].x2;
+        pG->B3i[k][j][i] = PF[n][m][l].x3;
+        if (i == pG->ie) pG->B1i[k][j][i+1] = PF[n][m][l+1].x1;
+        if (j == pG->je) pG->B2i[k][j+1][i] = PF[n][m+1][l].x2;
+        if (NDim > 2 && k == pG->ke) pG->B3i[k+1][j][i] = PF[n+1][m][l].x3;
+      }
+#endif /* MHD */
+#ifndef BAROTROPIC
+      de[0] += (PC[n][m][l].E - pU->E)/nz;
+      de[1] += fabs(pU->E)/nz;
+#endif
+    }}}
+  }}}
+
+  return;
+}
+
+#if !defined(BAROTROPIC) && !defined(SPECIAL_RELATIVITY)
+/*----------------------------------------------------------------------------*/
+/*! \fn static void conserve_energy(ConsS PC[][2][2], const ConsS *pU)
+ *  \brief Gives the block PC prolongated from parent zone pU the total energy
+ *   of the parent.  ProCon() prolongates the pressure, not E, and the
+ *   cell-centred fields of the block may have been reset from its face-centred
+ *   fields, so the energy of the block differs from that of the parent.  The
+ *   kinetic and magnetic energy of the block are kept, and its thermal energy
+ *   is scaled to make up the rest.  If the kinetic and magnetic energy alone
+ *   exceed the energy of the parent, the block is first given the velocity of
+ *   the parent, which keeps its momentum and lowers its kinetic energy.  If
+ *   the energy of the parent is still too small, E is left as given by
+ *   ProCon() (Regrid() then reports the energy that was not conserved). */
+
+static void conserve_energy(ConsS PC[][2][2], const ConsS *pU)
+{
+  int i,j,k,iend,jend,kend,pass;
+  Real ek[2][2][2],eth[2][2][2],etot=0.0,esum=0.0,nz;
+
+  iend = 1;
+  jend = (NDim > 1) ? 1 : 0;
+  kend = (NDim > 2) ? 1 : 0;
+  nz = (Real)((iend+1)*(jend+1)*(kend+1));
+
+  for (pass=0; pass<2; pass++) {
+    if (pass == 1) {
+      for (k=0; k<=kend; k++) {
+      for (j=0; j<=jend; j++) {
+      for (i=0; i<=iend; i++) {
+        PC[k][j][i].M1 = PC[k][j][i].d*pU->M1/pU->d;
+        PC[k][j][i].M2 = PC[k][j][i].d*pU->M2/pU->d;
+        PC[k][j][i].M3 = PC[k][j][i].d*pU->M3/pU->d;
+      }}}
+    }
+
+/* energy of the parent left for the thermal energy of the block */
+
+    etot = nz*pU->E;
+    esum = 0.0;
+    for (k=0; k<=kend; k++) {
+    for (j=0; j<=jend; j++) {
+    for (i=0; i<=iend; i++) {
+      ek[k][j][i] = 0.5*(SQR(PC[k][j][i].M1) + SQR(PC[k][j][i].M2) +
+        SQR(PC[k][j][i].M3))/PC[k][j][i].d;
+#ifdef MHD
+      ek[k][j][i] += 0.5*(SQR(PC[k][j][i].B1c) + SQR(PC[k][j][i].B2c) +
+        SQR(PC[k][j][i].B3c));
+#endif /* MHD */
+      eth[k][j][i] = MAX(PC[k][j][i].E - ek[k][j][i], 0.0);
+      etot -= ek[k][j][i];
+      esum += eth[k][j][i];
+    }}}
+    if (etot > 0.0) break;
+  }
+  if (etot <= 0.0) return;
+
+  for (k=0; k<=kend; k++) {
+  for (j=0; j<=jend; j++) {
+  for (i=0; i<=iend; i++) {
+    if (esum > 0.0)
+      PC[k][j][i].E = ek[k][j][i] + eth[k][j][i]*(etot/esum);
+    else
+      PC[k][j][i].E = ek[k][j][i] + etot/nz;
+  }}}
+
+  return;
+}
+#endif /* !BAROTROPIC && !SPECIAL_RELATIVITY */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real crit_density(const GridS *pG, const int i, const int j,
+ *                               const int k)
+ *  \brief Refinement criterion |grad(d)| dx/d */
+
+static Real crit_density(const GridS *pG, const int i, const int j,
+  const int k)
+{
+  Real g1,g2=0.0,g3=0.0;
+
+  g1 = UVAR(pG,k,j,i+1,d) - UVAR(pG,k,j,i-1,d);
+  if (pG->Nx[1] > 1) g2 = UVAR(pG,k,j+1,i,d) - UVAR(pG,k,j-1,i,d);
+  if (pG->Nx[2] > 1) g3 = UVAR(pG,k+1,j,i,d) - UVAR(pG,k-1,j,i,d);
+
+  return 0.5*sqrt(g1*g1 + g2*g2 + g3*g3)/UVAR(pG,k,j,i,d);
+}
+
+#ifndef SPECIAL_RELATIVITY
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real zone_pressure(const GridS *pG, const int i, const int j,
+ *                                const int k)
+ *  \brief Gas pressure in zone [k][j][i] */
+
+static Real zone_pressure(const GridS *pG, const int i, const int j,
+  const int k)
+{
+#ifdef BAROTROPIC
+  return Iso_csound2*UVAR(pG,k,j,i,d);
+#else
+  Real P;
+
+  P = UVAR(pG,k,j,i,E) - 0.5*(SQR(UVAR(pG,k,j,i,M1)) + SQR(UVAR(pG,k,j,i,M2))
+    + SQR(UVAR(pG,k,j,i,M3)))/UVAR(pG,k,j,i,d);
+#ifdef MHD
+  P -= 0.5*(SQR(UVAR(pG,k,j,i,B1c)) + SQR(UVAR(pG,k,j,i,B2c))
+    + SQR(UVAR(pG,k,j,i,B3c)));
+#endif
+  return Gamma_1*P;
+#endif /* BAROTROPIC */
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real crit_pressure(const GridS *pG, const int i, const int j,
+ *                                const int k)
+ *  \brief Refinement criterion |grad(P)| dx/P */
+
+static Real crit_pressure(const GridS *pG, const int i, const int j,
+  const int k)
+{
+  Real g1,g2=0.0,g3=0.0;
+
+  g1 = zone_pressure(pG,i+1,j,k) - zone_pressure(pG,i-1,j,k);
+  if (pG->Nx[1] > 1) g2 = zone_pressure(pG,i,j+1,k) - zone_pressure(pG,i,j-1,k);
+  if (pG->Nx[2] > 1) g3 = zone_pressure(pG,i,j,k+1) - zone_pressure(pG,i,j,k-1);
+
+  return 0.5*sqrt(g1*g1 + g2*g2 + g3*g3)/zone_pressure(pG,i,j,k);
+}
+#endif /* SPECIAL_RELATIVITY */
+
+#ifdef MHD
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real crit_current(const GridS *pG, const int i, const int j,
+ *                               const int k)
+ *  \brief Refinement criterion |curl(B)| dx/|B|, from cell-centred B */
+
+static Real crit_current(const GridS *pG, const int i, const int j,
+  const int k)
+{
+  Real J1=0.0,J2=0.0,J3=0.0,B2;
+
+  J2 = -(UVAR(pG,k,j,i+1,B3c) - UVAR(pG,k,j,i-1,B3c));
+  J3 =   UVAR(pG,k,j,i+1,B2c) - UVAR(pG,k,j,i-1,B2c);
+  if (pG->Nx[1] > 1) {
+    J1 += UVAR(pG,k,j+1,i,B3c) - UVAR(pG,k,j-1,i,B3c);
+    J3 -= UVAR(pG,k,j+1,i,B1c) - UVAR(pG,k,j-1,i,B1c);
+  }
+  if (pG->Nx[2] > 1) {
+    J1 -= UVAR(pG,k+1,j,i,B2c) - UVAR(pG,k-1,j,i,B2c);
+    J2 += UVAR(pG,k+1,j,i,B1c) - UVAR(pG,k-1,j,i,B1c);
+  }
+  B2 = SQR(UVAR(pG,k,j,i,B1c)) + SQR(UVAR(pG,k,j,i,B2c))
+     + SQR(UVAR(pG,k,j,i,B3c));
+
+  return 0.5*sqrt(J1*J1 + J2*J2 + J3*J3)/(sqrt(B2) + TINY_NUMBER);
+}
+#endif /* MHD */
+
+#endif /* STATIC_MESH_REFINEMENT */
@@ -22,12 +22,20 @@
  *   - calloc_1d_array() - creates 1D array
  *   - calloc_2d_array() - creates 2D array
  *   - calloc_3d_array() - creates 3D array
+ *   - calloc_3d_aligned_array() - creates 3D array with aligned rows
+ *   - calloc_pencil()   - creates the 1D arrays of a Cons1DArrS/Prim1DArrS
+ *   - map_3d_array()    - creates 3D array over memory allocated elsewhere
  *   - free_1d_array()   - destroys 1D array
  *   - free_2d_array()   - destroys 2D array
- *   - free_3d_array()   - destroys 3D array				      */
+ *   - free_3d_array()   - destroys 3D array
+ *   - free_3d_map()     - destroys 3D array from map_3d_array(), not its data
+ *   - free_pencil()     - destroys the 1D arrays of a Cons1DArrS/Prim1DArrS */
 /*============================================================================*/
 
+/* posix_memalign() is POSIX.1-2001, not C89/C99 */
+#define _POSIX_C_SOURCE 200112L
 #include <stdlib.h>
+#include <string.h>
 #include "prototypes.h"
 
 /*----------------------------------------------------------------------------*/
@@ -119,6 +127,115 @@ void*** calloc_3d_array(size_t nt, size_t nr, size_t nc, size_t size)
   return array;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void*** calloc_3d_aligned_array(size_t nt, size_t nr, size_t nc,
+ *                                      size_t size)
+ *  \brief Construct 3D array = array[nt][nr][nc] in which the first element of
+ *   every row is aligned to ATH_ALIGN bytes.  Rows are padded to a multiple of
+ *   ATH_ALIGN bytes, so the data is contiguous only within each row.  Can be
+ *   destroyed with free_3d_array().  */
+void*** calloc_3d_aligned_array(size_t nt, size_t nr, size_t nc, size_t size)
+{
+  void ***array;
+  void *data;
+  size_t i,j,ncp;
+
+  ncp = ((nc*size + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+
+  if((array = (void ***)calloc(nt,sizeof(void**))) == NULL){
+    ath_error("[calloc_3d_aligned] failed to allocate memory for %d 1st-pointers\n",
+              (int)nt);
+    return NULL;
+  }
+
+  if((array[0] = (void **)calloc(nt*nr,sizeof(void*))) == NULL){
+    ath_error("[calloc_3d_aligned] failed to allocate memory for %d 2nd-pointers\n",
+              (int)(nt*nr));
+    free((void *)array);
+    return NULL;
+  }
+
+  if(posix_memalign(&data, ATH_ALIGN, nt*nr*ncp) != 0){
+    ath_error("[calloc_3d_aligned] failed to alloc. memory (%d X %d X %d of size %d)\n",
+              (int)nt,(int)nr,(int)nc,(int)size);
+    free((void *)array[0]);
+    free((void *)array);
+    return NULL;
+  }
+  memset(data, 0, nt*nr*ncp);
+
+  for(i=0; i<nt; i++){
+    array[i] = (void **)((unsigned char *)array[0] + i*nr*sizeof(void*));
+    for(j=0; j<nr; j++){
+      array[i][j] = (void *)((unsigned char *)data + (i*nr + j)*ncp);
+    }
+  }
+
+  return array;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void*** map_3d_array(void *data, size_t nt, size_t nr, size_t pitch)
+ *  \brief Construct 3D array = array[nt][nr][] over existing memory data, in
+ *   which consecutive rows are pitch bytes apart (e.g. memory shared between
+ *   processes).  The data is not cleared.  Must be destroyed with
+ *   free_3d_map(), which leaves the data in place.  */
+void*** map_3d_array(void *data, size_t nt, size_t nr, size_t pitch)
+{
+  void ***array;
+  size_t i,j;
+
+  if((array = (void ***)calloc(nt,sizeof(void**))) == NULL){
+    ath_error("[map_3d] failed to allocate memory for %d 1st-pointers\n",
+              (int)nt);
+    return NULL;
+  }
+
+  if((array[0] = (void **)calloc(nt*nr,sizeof(void*))) == NULL){
+    ath_error("[map_3d] failed to allocate memory for %d 2nd-pointers\n",
+              (int)(nt*nr));
+    free((void *)array);
+    return NULL;
+  }
+
+  for(i=0; i<nt; i++){
+    array[i] = (void **)((unsigned char *)array[0] + i*nr*sizeof(void*));
+    for(j=0; j<nr; j++){
+      array[i][j] = (void *)((unsigned char *)data + (i*nr + j)*pitch);
+    }
+  }
+
+  return array;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn Real* calloc_pencil(void *pencil, size_t nvar, size_t nc)
+ *  \brief Construct the nvar 1D arrays array[nc] of Real of a pencil, such as
+ *   a Cons1DArrS or Prim1DArrS, which must consist of exactly nvar pointers to
+ *   Real.  The arrays share one block of memory, and the first element of each
+ *   is aligned to ATH_ALIGN bytes.  Returns the block, or NULL on failure.  */
+Real* calloc_pencil(void *pencil, size_t nvar, size_t nc)
+{
+  Real **pp = (Real **)pencil;
+  void *data;
+  size_t n,ncp;
+
+  ncp = ((nc*sizeof(Real) + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+
+  if(posix_memalign(&data, ATH_ALIGN, nvar*ncp) != 0){
+    ath_error("[calloc_pencil] failed to alloc. memory (%d X %d of size %d)\n",
+              (int)nvar,(int)nc,(int)sizeof(Real));
+    return NULL;
+  }
+  memset(data, 0, nvar*ncp);
+
+  for(n=0; n<nvar; n++){
+    pp[n] = (Real *)((unsigned char *)data + n*ncp);
+  }
+
+  return (Real *)data;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void free_1d_array(void *array)
  *  \brief Free memory used by 1D array  */
@@ -149,3 +266,24 @@ void free_3d_array(void *array)
   free(ta[0]);
   free(array);
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void free_3d_map(void *array)
+ *  \brief Free the pointers of a 3D array from map_3d_array()  */
+void free_3d_map(void *array)
+{
+  void ***ta = (void ***)array;
+
+  free(ta[0]);
+  free(array);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void free_pencil(void *pencil)
+ *  \brief Free memory used by the arrays of a pencil from calloc_pencil()  */
+void free_pencil(void *pencil)
+{
+  Real **pp = (Real **)pencil;
+
+  free(pp[0]);
+}
@@ -7,9 +7,11 @@
  * PURPOSE: Contains definitions of the following data types and structures:
  * - Real    - either float or double, depending on configure option
  * - ConsS   - cell-centered conserved variables
+ * - ConsArrS - 3D arrays of each conserved variable (SOA_STORAGE only)
  * - PrimS   - cell-centered primitive variables
  * - Cons1DS - conserved variables in 1D: same as ConsS minus Bx
  * - Prim1DS - primitive variables in 1D: same as PrimS minus Bx
+ * - Cons1DArrS, Prim1DArrS - pencils of Cons1DS/Prim1DS stored as arrays
  * - GrainS  - basic properties of particles
  * - GridS   - everything in a single Grid
  * - DomainS - everything in a single Domain (potentially many Grids)
@@ -104,6 +106,35 @@ typedef struct Cons_s{
 #endif
 }ConsS;
 
+#ifdef SOA_STORAGE
+/*----------------------------------------------------------------------------*/
+/*! \struct ConsArrS
+ *  \brief Conserved variables stored as a separate 3D array for each variable.
+ *  IMPORTANT!! The order of the elements in ConsArrS must be the same as in
+ *  ConsS, so that the n-th array can be found with UCOMP().
+ */
+typedef struct ConsArr_s{
+  Real ***d;			/*!< density */
+  Real ***M1;			/*!< momentum density in 1-direction*/
+  Real ***M2;			/*!< momentum density in 2-direction*/
+  Real ***M3;			/*!< momentum density in 3-direction*/
+#ifndef BAROTROPIC
+  Real ***E;			/*!< total energy density */
+#endif /* BAROTROPIC */
+#ifdef MHD
+  Real ***B1c;			/*!< cell centered magnetic fields in 1-dir*/
+  Real ***B2c;			/*!< cell centered magnetic fields in 2-dir*/
+  Real ***B3c;			/*!< cell centered magnetic fields in 3-dir*/
+#endif /* MHD */
+#if (NSCALARS > 0)
+  Real ***s[NSCALARS];          /*!< passively advected scalars */
+#endif
+#ifdef CYLINDRICAL
+  Real ***Pflux;	 		/*!< pressure component of flux */
+#endif
+}ConsArrS;
+#endif /* SOA_STORAGE */
+
 /*----------------------------------------------------------------------------*/
 /*! \struct PrimS
  *  \brief Primitive variables.
@@ -174,6 +205,57 @@ typedef struct Prim1D_s{
 #endif
 }Prim1DS;
 
+/*----------------------------------------------------------------------------*/
+/*! \struct Cons1DArrS
+ *  \brief Conserved variables in 1D along a pencil of cells, stored as a
+ *  separate 1D array for each variable.  Used by the batched Riemann solvers.
+ *  IMPORTANT!! The order of the elements in Cons1DArrS must be the same as in
+ *  Cons1DS, so that the n-th array holds the n-th element of Cons1DS.
+ */
+typedef struct Cons1DArr_s{
+  Real *d;			/*!< density */
+  Real *Mx;			/*!< momentum density in X,Y,Z */
+  Real *My;
+  Real *Mz;
+#ifndef BAROTROPIC
+  Real *E;			/*!< total energy density */
+#endif /* BAROTROPIC */
+#ifdef MHD
+  Real *By;			/*!< cell centered magnetic fields in Y */
+  Real *Bz;			/*!< cell centered magnetic fields in Z */
+#endif /* MHD */
+#if (NSCALARS > 0)
+  Real *s[NSCALARS];            /*!< passively advected scalars */
+#endif
+#ifdef CYLINDRICAL
+  Real *Pflux;	 		/*!< pressure component of flux */
+#endif
+}Cons1DArrS;
+
+/*----------------------------------------------------------------------------*/
+/*! \struct Prim1DArrS
+ *  \brief Primitive variables in 1D along a pencil of cells, stored as a
+ *  separate 1D array for each variable.
+ *  IMPORTANT!! The order of the elements in Prim1DArrS must be the same as in
+ *  Prim1DS.
+ */
+typedef struct Prim1DArr_s{
+  Real *d;			/*!< density */
+  Real *Vx;			/*!< velocity in X-direction */
+  Real *Vy;			/*!< velocity in Y-direction */
+  Real *Vz;			/*!< velocity in Z-direction */
+#ifndef BAROTROPIC
+  Real *P;			/*!< pressure */
+#endif /* BAROTROPIC */
+#ifdef MHD
+  Real *By;			/*!< cell centered magnetic fields in Y-dir */
+  Real *Bz;			/*!< cell centered magnetic fields in Z-dir */
+#endif /* MHD */
+#if (NSCALARS > 0)
+  Real *r[NSCALARS];            /*!< density-normalized advected scalars */
+#endif
+}Prim1DArrS;
+
 /*----------------------------------------------------------------------------*/
 /* UnitS: Code units and physical constants in the code units
  *  */
@@ -260,6 +342,18 @@ typedef struct GPCouple_s{
 #endif
 }GPCouple;
 
+/*! \struct GrainBlock
+ *  \brief A block of up to NGRBLK particles stored as arrays of each field,
+ *  so the particle integrators can work on many particles per loop. */
+#define NGRBLK 64
+typedef struct GrainBlock_s{
+  int property[NGRBLK];	/*!< index of particle properties */
+  Real x1[NGRBLK], x2[NGRBLK], x3[NGRBLK];	/*!< coordinate in X,Y,Z */
+  Real v1[NGRBLK], v2[NGRBLK], v3[NGRBLK];	/*!< velocity in X,Y,Z */
+  Real dv1[NGRBLK], dv2[NGRBLK], dv3[NGRBLK];	/*!< velocity update */
+  Real ts[NGRBLK];	/*!< stopping time */
+}GrainBlock;
+
 #endif /* PARTICLES */
 
 /*----------------------------------------------------------------------------*/
@@ -278,6 +372,10 @@ typedef struct GridOvrlp_s{
   Real **myEMF2[6];      /*!< fluxes of magnetic field (EMF2) at 6 boundaries */
   Real **myEMF3[6];      /*!< fluxes of magnetic field (EMF3) at 6 boundaries */
 #endif
+#ifdef SELF_GRAVITY
+  Real **myPhiFlx[6]; /*!< mean gradient of Phi on child Grid at 6 boundaries,
+                       * set by RestrictCorrect_Phi() (CGrid only) */
+#endif
 }GridOvrlpS;
 #endif /* STATIC_MESH_REFINEMENT */
 
@@ -290,10 +388,18 @@ typedef struct GridOvrlp_s{
  *   Remember a Grid is defined as the region of a Domain at some
  *   refinement level being updated by a single processor.  Uses an array of
  *   ConsS, rather than arrays of each variable, to increase locality of data
- *   for a given cell in memory.  */
+ *   for a given cell in memory.  With SOA_STORAGE each variable is instead
+ *   stored in a separate aligned 3D array, so that loops over i are unit
+ *   stride in each variable.  The conserved variables should only be accessed
+ *   through the UVAR(), UCOMP(), UGET(), USET() and UPTR() macros below, which
+ *   work with either storage.  */
 
 typedef struct Grid_s{
+#ifdef SOA_STORAGE
+  ConsArrS U;                /*!< conserved variables */
+#else
   ConsS ***U;                /*!< conserved variables */
+#endif
 #ifdef MHD
   Real ***B1i,***B2i,***B3i;    /*!< interface magnetic fields */
 #ifdef RESISTIVITY
@@ -319,6 +425,16 @@ typedef struct Grid_s{
   int rx1_id, lx1_id;  /*!< ID of Grid to R/L in x1-dir (default=-1; no Grid) */
   int rx2_id, lx2_id;  /*!< ID of Grid to R/L in x2-dir (default=-1; no Grid) */
   int rx3_id, lx3_id;  /*!< ID of Grid to R/L in x3-dir (default=-1; no Grid) */
+  int nbr_id[27];      /*!< IDs of the Grids at offsets (o1,o2,o3) in {-1,0,1}
+                        * for the single-round exchange in bvals_mhd(), at
+                        * [(o3+1)*9+(o2+1)*3+(o1+1)]; all -1 if not used */
+#ifdef MPI_PARALLEL
+  MPI_Comm Comm_shm;   /*!< ranks of the Domain on this node, if U and B?i are
+                        * in shared memory (else MPI_COMM_NULL) */
+  MPI_Win Win_shm;     /*!< shared window holding U and B?i, or MPI_WIN_NULL */
+  Real wtime;          /*!< wall time spent integrating this Grid, recorded in
+                        * restart files for <domain>/LoadBalance=2 */
+#endif /* MPI_PARALLEL */
 
 #ifdef SELF_GRAVITY
   int rx1_Gid, lx1_Gid;  /*!< ID of Grid to R/L in x1-dir (default=-1; no Grid) */
@@ -332,6 +448,15 @@ typedef struct Grid_s{
   GrainS *particle;          /*!< array of all particles */
   GrainAux *parsub;          /*!< supplemental particle information */
   GPCouple ***Coup;          /*!< array of gas-particle coupling */
+  long *parcell;             /*!< particles with sort key n are parcell[n] to
+                                  parcell[n+1]-1, set by shuffle() */
+  int *cellkey;              /*!< sort key of each cell (NULL: cell index) */
+  int parsorted;             /*!< =1 while parcell[] matches particle[] */
+#ifdef MPI_PARALLEL
+  Real ptime;                /*!< part of wtime spent on the particles */
+  Real *parprof[3];          /*!< particles in each layer of cells in x1,x2,x3,
+                              * summed over steps, for <domain>/LoadBalance=2 */
+#endif /* MPI_PARALLEL */
 #endif /* PARTICLES */
 
 #ifdef STATIC_MESH_REFINEMENT
@@ -357,6 +482,31 @@ typedef struct Grid_s{
 
 }GridS;
 
+/*----------------------------------------------------------------------------*/
+/* Accessors for the conserved variables in a Grid, for either storage:
+ * - UVAR(pG,k,j,i,var) - variable var (d,M1,...,s[n]) in cell [k][j][i]
+ * - UCOMP(pG,k,j,i,n)  - n-th variable (0 <= n < NVAR) in cell [k][j][i]
+ * - UGET(pG,k,j,i)     - ConsS value of cell [k][j][i]
+ * - USET(pG,k,j,i,q)   - set cell [k][j][i] to ConsS value q
+ * - UPTR(pG,k,j,i)     - const ConsS pointer to cell [k][j][i].  With
+ *     SOA_STORAGE it points to a copy that is overwritten by the next call,
+ *     so it can only be used for reading, as in Cons_to_Prim(UPTR(...)).
+ * UVAR and UCOMP are lvalues. */
+
+#ifdef SOA_STORAGE
+#define UVAR(pG,k,j,i,var) ((pG)->U.var[k][j][i])
+#define UCOMP(pG,k,j,i,n) (((Real ****)&((pG)->U))[n][k][j][i])
+#define UGET(pG,k,j,i) get_cons((pG),(k),(j),(i))
+#define USET(pG,k,j,i,q) put_cons((pG),(k),(j),(i),(q))
+#define UPTR(pG,k,j,i) cons_ptr((pG),(k),(j),(i))
+#else
+#define UVAR(pG,k,j,i,var) ((pG)->U[k][j][i].var)
+#define UCOMP(pG,k,j,i,n) (((Real *)&((pG)->U[k][j][i]))[n])
+#define UGET(pG,k,j,i) ((pG)->U[k][j][i])
+#define USET(pG,k,j,i,q) ((pG)->U[k][j][i] = (q))
+#define UPTR(pG,k,j,i) ((const ConsS *)&((pG)->U[k][j][i]))
+#endif /* SOA_STORAGE */
+
 /*! \fn void (*VGFun_t)(GridS *pG)
  *  \brief Generic void function of Grid. */
 typedef void (*VGFun_t)(GridS *pG);    /* generic void function of Grid */
@@ -438,6 +588,9 @@ typedef struct Mesh_s{
   int *DomainsPerLevel;      /*!< number of Domains per level (DPL) */
   DomainS **Domain;        /*!< array of Domains, indexed over levels and DPL */
   char *outfilename;         /*!< basename for output files containing -id#  */
+#ifdef STATIC_MESH_REFINEMENT
+  int subcycle;   /*!< 1 if each level takes 2 steps per step of its parent */
+#endif
 }MeshS;
 
 /*----------------------------------------------------------------------------*/
@@ -29,10 +29,27 @@
  *
  * For case (2) -- MPI BOUNDARIES
  *   We do the parallel synchronization by having every grid:
- *   - 1) Post non-blocking receives for data from both L and R Grids
- *   - 2) Pack and send data to the Grids on both L and R
- *   - 3) Check for receives and unpack data in order of first to finish
+ *   - 1) Start non-blocking receives for data from both L and R Grids
+ *   - 2) Start non-blocking sends of data to the Grids on both L and R
+ *   - 3) Wait for the receives and sends to complete
  *   If the Grid is at the edge of the Domain, we set BCs as in case (1) or (3).
+ *   The receives and sends are persistent requests created once in
+ *   bvals_mhd_init(), with MPI datatypes that describe the ghost and active
+ *   zones of U (and the interface fields) in place, so no data is copied
+ *   through intermediate buffers.
+ *
+ *   With <job>/shm_halo=1, U and the interface fields of the Grids of a Domain
+ *   on the same node are allocated in a shared-memory window by init_grid(),
+ *   and ghost zones are copied directly from the arrays of neighbours on the
+ *   node; only neighbours on other nodes are sent messages.  The Grids on a
+ *   node synchronize (shm_sync()) before every stage, so that the zones read
+ *   are up to date, and at the end, so that they are not changed while read.
+ *
+ *   With <job>/halo_26=1, and every boundary of the Domain periodic, the three
+ *   directional stages are replaced by a single round of messages with all
+ *   26 neighbouring Grids (faces, edges and corners), which fills the corner
+ *   cells directly.  Neighbours are stored in GridS.nbr_id[] (possibly this
+ *   Grid itself, for a Domain with one Grid in some direction).
  *
  * For case (3) -- INTERNAL GRID LEVEL BOUNDARIES
  *   This step is complicated and must be handled separately, in the function
@@ -44,6 +61,8 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - bvals_mhd()      - calls appropriate functions to set ghost cells
+ * - bvals_mhd_start() - posts MPI messages of bvals_mhd() without waiting
+ * - bvals_mhd_finish() - completes bvals_mhd_start() and sets ghost cells
  * - bvals_mhd_init() - sets function pointers used by bvals_mhd()
  * - bvals_mhd_fun()  - enrolls a pointer to a user-defined BC function
  *
@@ -72,18 +91,17 @@
  * - conduct_ox2()  - conducting BCs at boundary ox2
  * - conduct_ix3()  - conducting BCs at boundary ix3
  * - conduct_ox3()  - conducting BCs at boundary ox3
- * - pack_ix1()     - pack data for MPI non-blocking send at ix1 boundary
- * - pack_ox1()     - pack data for MPI non-blocking send at ox1 boundary
- * - pack_ix2()     - pack data for MPI non-blocking send at ix2 boundary
- * - pack_ox2()     - pack data for MPI non-blocking send at ox2 boundary
- * - pack_ix3()     - pack data for MPI non-blocking send at ix3 boundary
- * - pack_ox3()     - pack data for MPI non-blocking send at ox3 boundary
- * - unpack_ix1()   - unpack data for MPI non-blocking receive at ix1 boundary
- * - unpack_ox1()   - unpack data for MPI non-blocking receive at ox1 boundary
- * - unpack_ix2()   - unpack data for MPI non-blocking receive at ix2 boundary
- * - unpack_ox2()   - unpack data for MPI non-blocking receive at ox2 boundary
- * - unpack_ix3()   - unpack data for MPI non-blocking receive at ix3 boundary
- * - unpack_ox3()   - unpack data for MPI non-blocking receive at ox3 boundary*/
+ * - nbr_range()    - index range of a region exchanged with one of 26 Grids
+ * - halo_range()   - index ranges of all variables in an exchanged region
+ * - block_type()   - MPI datatype for a block of a 3D array
+ * - region_type()  - MPI datatype for all variables in an exchanged region
+ * - halo_init()    - creates persistent requests for one exchanged region
+ * - get_plan()     - persistent requests of a Domain
+ * - start_dir()    - starts the persistent requests of a directional stage
+ * - shm_view()     - view of a neighbouring Grid in shared memory
+ * - shm_copy()     - copies ghost zones from a Grid in shared memory
+ * - shm_copy_dir() - shm_copy() for both sides of a directional stage
+ * - shm_sync()     - synchronizes the Grids sharing memory on a node */
 /*============================================================================*/
 
 #include <stdio.h>
@@ -94,19 +112,38 @@
 #include "prototypes.h"
 
 #ifdef MPI_PARALLEL
-/* MPI send and receive buffers */
-static double **send_buf = NULL, **recv_buf = NULL;
-static MPI_Request *recv_rq, *send_rq;
+/*! \struct HaloPlanS
+ *  \brief Persistent MPI requests of the boundary exchange of one Domain,
+ *   created once by bvals_mhd_init().  Each request sends from or receives
+ *   into the Grid arrays directly through an MPI datatype, so the arrays of
+ *   the Grid must not be reallocated after initialization.  Requests that are
+ *   not used are MPI_REQUEST_NULL.  Neighbours on the same node whose arrays
+ *   are in shared memory (<job>/shm_halo=1) are read through a view of their
+ *   Grid instead. */
+typedef struct HaloPlan_s{
+  DomainS *pD;                       /* Domain this plan belongs to */
+  MPI_Request send_rq[3][2];         /* directional stages, [dir][L,R] */
+  MPI_Request recv_rq[3][2];
+  MPI_Request nbr_send_rq[27];       /* single-round exchange, [offset] */
+  MPI_Request nbr_recv_rq[27];
+  GridS *shm[3][2];                  /* views of neighbours in shared memory,*/
+  GridS *nbr_shm[27];                /* used instead of requests, or NULL */
+}HaloPlanS;
+
+static HaloPlanS *Plan = NULL;
+static int NPlan = 0;
 #endif /* MPI_PARALLEL */
 
+/* Domain whose exchange was posted by bvals_mhd_start(), or NULL */
+static DomainS *pPending = NULL;
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   reflect_???()  - reflecting BCs at boundary ???
  *   outflow_???()  - outflow BCs at boundary ???
  *   periodic_???() - periodic BCs at boundary ???
  *   conduct_???()  - conducting BCs at boundary ???
- *   pack_???()     - pack data for MPI non-blocking send at ??? boundary
- *   unpack_???()   - unpack data for MPI non-blocking receive at ??? boundary
+ *   halo_???()     - persistent requests for MPI boundaries
  *============================================================================*/
 
 static void reflect_ix1(GridS *pG);
@@ -140,19 +177,22 @@ static void conduct_ox3(GridS *pG);
 static void ProlongateLater(GridS *pG);
 
 #ifdef MPI_PARALLEL
-static void pack_ix1(GridS *pG);
-static void pack_ox1(GridS *pG);
-static void pack_ix2(GridS *pG);
-static void pack_ox2(GridS *pG);
-static void pack_ix3(GridS *pG);
-static void pack_ox3(GridS *pG);
-
-static void unpack_ix1(GridS *pG);
-static void unpack_ox1(GridS *pG);
-static void unpack_ix2(GridS *pG);
-static void unpack_ox2(GridS *pG);
-static void unpack_ix3(GridS *pG);
-static void unpack_ox3(GridS *pG);
+static void nbr_range(const GridS *pG, const int dir, const int o,
+                      const int face, const int recv, int *lo, int *hi);
+static void halo_range(const GridS *pG, const int nfull, const int *o,
+                       const int recv, int lo[4][3], int hi[4][3]);
+static MPI_Datatype block_type(void ***a, const MPI_Aint esz, const int nel,
+                               const int *lo, const int *hi, MPI_Aint *pAddr);
+static MPI_Datatype region_type(GridS *pG, int lo[4][3], int hi[4][3]);
+static void halo_init(const int nfull, const int *o, GridS *pG, const int id,
+                      const int rtag, const int stag, MPI_Comm comm,
+                      MPI_Request *pRecv, MPI_Request *pSend);
+static HaloPlanS *get_plan(DomainS *pD);
+static void start_dir(HaloPlanS *pP, const int dir);
+static GridS *shm_view(DomainS *pD, const int l, const int m, const int n);
+static void shm_copy(GridS *pG, GridS *pS, const int nfull, const int *o);
+static void shm_copy_dir(HaloPlanS *pP, GridS *pG, const int dir);
+static void shm_sync(GridS *pG);
 #endif /* MPI_PARALLEL */
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
@@ -172,106 +212,140 @@ static void unpack_ox3(GridS *pG);
  */
 
 void bvals_mhd(DomainS *pD)
+{
+  bvals_mhd_start(pD);
+  bvals_mhd_finish(pD);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_start(DomainS *pD)
+ *  \brief First half of bvals_mhd(): starts the non-blocking receives and
+ *   sends of the x1-direction MPI boundaries, and returns without waiting.
+ *
+ *   The exchange must be completed with bvals_mhd_finish() before the ghost
+ *   zones are used.  Meanwhile the active zones within nghost of the edges of
+ *   the Grid, which are sent straight from U, may be read but not changed.
+ *   Only one exchange can be in flight at a time.
+ */
+
+void bvals_mhd_start(DomainS *pD)
+{
+#ifdef MPI_PARALLEL
+  GridS *pGrid = (pD->Grid);
+  HaloPlanS *pP;
+  int ierr, n;
+#endif /* MPI_PARALLEL */
+
+  if (pPending != NULL)
+    ath_error("[bvals_mhd_start]: boundary exchange is already in flight\n");
+  pPending = pD;
+
+#ifdef MPI_PARALLEL
+  pP = get_plan(pD);
+
+/* Grids on the node must have updated U before it is read from shared memory */
+  shm_sync(pGrid);
+
+/* Single-round exchange: start receives and sends for all 26 neighbours */
+  if (pGrid->nbr_id[13] >= 0) {
+    for (n=0; n<27; n++)
+      if (pP->nbr_recv_rq[n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->nbr_recv_rq[n]));
+    for (n=0; n<27; n++)
+      if (pP->nbr_send_rq[n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->nbr_send_rq[n]));
+    return;
+  }
+
+/* Start receives from and sends to the L and R Grids in x1 */
+  if (pGrid->Nx[0] > 1) start_dir(pP,0);
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_finish(DomainS *pD)
+ *  \brief Second half of bvals_mhd(): completes the exchange posted by
+ *   bvals_mhd_start() and sets all remaining ghost zones.  Returns at once if
+ *   no exchange is in flight for this Domain.
+ */
+
+void bvals_mhd_finish(DomainS *pD)
 {
   GridS *pGrid = (pD->Grid);
 #ifdef SHEARING_BOX
   int myL,myM,myN,BCFlag;
 #endif
 #ifdef MPI_PARALLEL
-  int cnt, cnt2, cnt3, ierr, mIndex;
+  HaloPlanS *pP;
+  int ierr,n,o[3];
+#endif /* MPI_PARALLEL */
+
+  if (pPending != pD) return;
+  pPending = NULL;
+
+#ifdef MPI_PARALLEL
+  pP = get_plan(pD);
+
+/* Single-round exchange.  All boundaries are periodic, so there are no
+ * physical BCs */
+  if (pGrid->nbr_id[13] >= 0) {
+    for (n=0; n<27; n++) {
+      if (pP->nbr_shm[n] != NULL) {
+        o[0] = n%3 - 1;  o[1] = (n/3)%3 - 1;  o[2] = n/9 - 1;
+        shm_copy(pGrid, pP->nbr_shm[n], 0, o);
+      }
+    }
+    ierr = MPI_Waitall(27, pP->nbr_recv_rq, MPI_STATUSES_IGNORE);
+    ierr = MPI_Waitall(27, pP->nbr_send_rq, MPI_STATUSES_IGNORE);
+    shm_sync(pGrid);
+    return;
+  }
 #endif /* MPI_PARALLEL */
 
 /*--- Step 1. ------------------------------------------------------------------
- * Boundary Conditions in x1-direction */
+ * Boundary Conditions in x1-direction.  The MPI messages were started by
+ * bvals_mhd_start() */
 
   if (pGrid->Nx[0] > 1){
 
 #ifdef MPI_PARALLEL
-    cnt = nghost*(pGrid->Nx[1])*(pGrid->Nx[2])*(NVAR);
-#ifdef MHD
-    cnt2 = (pGrid->Nx[1] > 1) ? (pGrid->Nx[1] + 1) : 1;
-    cnt3 = (pGrid->Nx[2] > 1) ? (pGrid->Nx[2] + 1) : 1;
-    cnt += (nghost-1)*(pGrid->Nx[1])*(pGrid->Nx[2]);
-    cnt += nghost*cnt2*(pGrid->Nx[2]);
-    cnt += nghost*(pGrid->Nx[1])*cnt3;
-#endif
+    /* copy from neighbours in shared memory */
+    shm_copy_dir(pP,pGrid,0);
 
 /* MPI blocks to both left and right */
     if (pGrid->rx1_id >= 0 && pGrid->lx1_id >= 0) {
 
-      /* Post non-blocking receives for data from L and R Grids */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_id,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_id,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data L and R */
-      pack_ix1(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_id,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
-      pack_ox1(pGrid); 
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_id,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
-      /* check non-blocking sends have completed. */
-      ierr = MPI_Waitall(2, send_rq, MPI_STATUS_IGNORE);
-
-      /* check non-blocking receives and unpack data in any order. */
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_ix1(pGrid);
-      if (mIndex == 1) unpack_ox1(pGrid);
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_ix1(pGrid);
-      if (mIndex == 1) unpack_ox1(pGrid);
+      /* wait for non-blocking receives and sends to complete. */
+      ierr = MPI_Waitall(2, pP->recv_rq[0], MPI_STATUSES_IGNORE);
+      ierr = MPI_Waitall(2, pP->send_rq[0], MPI_STATUSES_IGNORE);
 
     }
 
 /* Physical boundary on left, MPI block on right */
     if (pGrid->rx1_id >= 0 && pGrid->lx1_id < 0) {
 
-      /* Post non-blocking receive for data from R Grid */
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_id,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data R */
-      pack_ox1(pGrid); 
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_id,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
       /* set physical boundary */
       (*(pD->ix1_BCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[1]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from R and unpack data */
-      ierr = MPI_Wait(&(recv_rq[1]), MPI_STATUS_IGNORE);
-      unpack_ox1(pGrid);
+      /* wait for non-blocking receive from and send to R */
+      ierr = MPI_Wait(&(pP->recv_rq[0][1]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[0][1]), MPI_STATUS_IGNORE);
 
     }
 
 /* MPI block on left, Physical boundary on right */
     if (pGrid->rx1_id < 0 && pGrid->lx1_id >= 0) {
 
-      /* Post non-blocking receive for data from L grid */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_id,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-
-      /* pack and send data L */
-      pack_ix1(pGrid); 
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_id,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
       /* set physical boundary */
       (*(pD->ox1_BCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[0]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from L and unpack data */
-      ierr = MPI_Wait(&(recv_rq[0]), MPI_STATUS_IGNORE);
-      unpack_ix1(pGrid);
+      /* wait for non-blocking receive from and send to L */
+      ierr = MPI_Wait(&(pP->recv_rq[0][0]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[0][0]), MPI_STATUS_IGNORE);
 
     }
 #endif /* MPI_PARALLEL */
@@ -290,90 +364,44 @@ void bvals_mhd(DomainS *pD)
   if (pGrid->Nx[1] > 1){
 
 #ifdef MPI_PARALLEL
-    cnt = (pGrid->Nx[0] + 2*nghost)*nghost*(pGrid->Nx[2])*(NVAR);
-#ifdef MHD
-    cnt3 = (pGrid->Nx[2] > 1) ? (pGrid->Nx[2] + 1) : 1;
-    cnt += (pGrid->Nx[0] + 2*nghost - 1)*nghost*(pGrid->Nx[2]);
-    cnt += (pGrid->Nx[0] + 2*nghost)*(nghost-1)*(pGrid->Nx[2]);
-    cnt += (pGrid->Nx[0] + 2*nghost)*nghost*cnt3;
-#endif
+    /* ghost zones set in the previous direction are read in this one */
+    shm_sync(pGrid);
+
+    /* start non-blocking receives from and sends to L and R Grids, and copy
+     * from neighbours in shared memory */
+    start_dir(pP,1);
+    shm_copy_dir(pP,pGrid,1);
 
 /* MPI blocks to both left and right */
     if (pGrid->rx2_id >= 0 && pGrid->lx2_id >= 0) {
 
-      /* Post non-blocking receives for data from L and R Grids */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_id,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_id,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data L and R */
-      pack_ix2(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_id,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
-      pack_ox2(pGrid); 
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_id,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
-      /* check non-blocking sends have completed. */
-      ierr = MPI_Waitall(2, send_rq, MPI_STATUS_IGNORE);
-
-      /* check non-blocking receives and unpack data in any order. */
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_ix2(pGrid);
-      if (mIndex == 1) unpack_ox2(pGrid);
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_ix2(pGrid);
-      if (mIndex == 1) unpack_ox2(pGrid);
+      /* wait for non-blocking receives and sends to complete. */
+      ierr = MPI_Waitall(2, pP->recv_rq[1], MPI_STATUSES_IGNORE);
+      ierr = MPI_Waitall(2, pP->send_rq[1], MPI_STATUSES_IGNORE);
 
     }
 
 /* Physical boundary on left, MPI block on right */
     if (pGrid->rx2_id >= 0 && pGrid->lx2_id < 0) {
 
-      /* Post non-blocking receive for data from R Grid */
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_id,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data R */
-      pack_ox2(pGrid); 
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_id,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
       /* set physical boundary */
       (*(pD->ix2_BCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[1]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from R and unpack data */
-      ierr = MPI_Wait(&(recv_rq[1]), MPI_STATUS_IGNORE);
-      unpack_ox2(pGrid);
+      /* wait for non-blocking receive from and send to R */
+      ierr = MPI_Wait(&(pP->recv_rq[1][1]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[1][1]), MPI_STATUS_IGNORE);
 
     }
 
 /* MPI block on left, Physical boundary on right */
     if (pGrid->rx2_id < 0 && pGrid->lx2_id >= 0) {
 
-      /* Post non-blocking receive for data from L grid */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_id,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-
-      /* pack and send data L */
-      pack_ix2(pGrid); 
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_id,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
       /* set physical boundary */
       (*(pD->ox2_BCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[0]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from L and unpack data */
-      ierr = MPI_Wait(&(recv_rq[0]), MPI_STATUS_IGNORE);
-      unpack_ix2(pGrid);
+      /* wait for non-blocking receive from and send to L */
+      ierr = MPI_Wait(&(pP->recv_rq[1][0]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[1][0]), MPI_STATUS_IGNORE);
 
     }
 #endif /* MPI_PARALLEL */
@@ -407,89 +435,44 @@ void bvals_mhd(DomainS *pD)
   if (pGrid->Nx[2] > 1){
 
 #ifdef MPI_PARALLEL
-    cnt = (pGrid->Nx[0] + 2*nghost)*(pGrid->Nx[1] + 2*nghost)*nghost*(NVAR);
-#ifdef MHD
-    cnt += (pGrid->Nx[0] + 2*nghost - 1)*(pGrid->Nx[1] + 2*nghost)*nghost;
-    cnt += (pGrid->Nx[0] + 2*nghost)*(pGrid->Nx[1] + 2*nghost - 1)*nghost;
-    cnt += (pGrid->Nx[0] + 2*nghost)*(pGrid->Nx[1] + 2*nghost)*(nghost-1);
-#endif
+    /* ghost zones set in the previous direction are read in this one */
+    shm_sync(pGrid);
+
+    /* start non-blocking receives from and sends to L and R Grids, and copy
+     * from neighbours in shared memory */
+    start_dir(pP,2);
+    shm_copy_dir(pP,pGrid,2);
 
 /* MPI blocks to both left and right */
     if (pGrid->rx3_id >= 0 && pGrid->lx3_id >= 0) {
 
-      /* Post non-blocking receives for data from L and R Grids */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_id,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_id,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data L and R */
-      pack_ix3(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_id,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
-      pack_ox3(pGrid); 
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_id,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
-      /* check non-blocking sends have completed. */
-      ierr = MPI_Waitall(2, send_rq, MPI_STATUS_IGNORE);
-
-      /* check non-blocking receives and unpack data in any order. */
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_ix3(pGrid);
-      if (mIndex == 1) unpack_ox3(pGrid);
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_ix3(pGrid);
-      if (mIndex == 1) unpack_ox3(pGrid);
+      /* wait for non-blocking receives and sends to complete. */
+      ierr = MPI_Waitall(2, pP->recv_rq[2], MPI_STATUSES_IGNORE);
+      ierr = MPI_Waitall(2, pP->send_rq[2], MPI_STATUSES_IGNORE);
 
     }
 
 /* Physical boundary on left, MPI block on right */
     if (pGrid->rx3_id >= 0 && pGrid->lx3_id < 0) {
 
-      /* Post non-blocking receive for data from R Grid */
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_id,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data R */
-      pack_ox3(pGrid); 
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_id,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
       /* set physical boundary */
       (*(pD->ix3_BCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[1]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from R and unpack data */
-      ierr = MPI_Wait(&(recv_rq[1]), MPI_STATUS_IGNORE);
-      unpack_ox3(pGrid);
+      /* wait for non-blocking receive from and send to R */
+      ierr = MPI_Wait(&(pP->recv_rq[2][1]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[2][1]), MPI_STATUS_IGNORE);
 
     }
 
 /* MPI block on left, Physical boundary on right */
     if (pGrid->rx3_id < 0 && pGrid->lx3_id >= 0) {
 
-      /* Post non-blocking receive for data from L grid */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_id,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-
-      /* pack and send data L */
-      pack_ix3(pGrid); 
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_id,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
       /* set physical boundary */
       (*(pD->ox3_BCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[0]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from L and unpack data */
-      ierr = MPI_Wait(&(recv_rq[0]), MPI_STATUS_IGNORE);
-      unpack_ix3(pGrid);
+      /* wait for non-blocking receive from and send to L */
+      ierr = MPI_Wait(&(pP->recv_rq[2][0]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[2][0]), MPI_STATUS_IGNORE);
 
     }
 #endif /* MPI_PARALLEL */
@@ -502,13 +485,19 @@ void bvals_mhd(DomainS *pD)
 
   }
 
+#ifdef MPI_PARALLEL
+/* U must not be changed until the Grids on the node have finished reading */
+  shm_sync(pGrid);
+#endif /* MPI_PARALLEL */
+
   return;
 }
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void bvals_mhd_init(MeshS *pM)
  *  \brief Sets function pointers for physical boundaries during
- *   initialization, allocates memory for send/receive buffers with MPI.
+ *   initialization, and with MPI builds the communication plan (persistent
+ *   requests) of every Domain.
  */
 
 void bvals_mhd_init(MeshS *pM)
@@ -517,8 +506,19 @@ void bvals_mhd_init(MeshS *pM)
   DomainS *pD;
   int i,nl,nd,irefine;
 #ifdef MPI_PARALLEL
-  int myL,myM,myN,l,m,n,nx1t,nx2t,nx3t,size;
-  int x1cnt=0, x2cnt=0, x3cnt=0; /* Number of words passed in x1/x2/x3-dir. */
+  int myL,myM,myN,l,m,n,o[3],halo26,dir,id;
+  HaloPlanS *pP;
+#endif /* MPI_PARALLEL */
+
+#ifdef MPI_PARALLEL
+/* Allocate one communication plan per Domain with an active Grid */
+  for (nl=0, n=0; nl<(pM->NLevels); nl++)
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++)
+      if (pM->Domain[nl][nd].Grid != NULL) n++;
+  if (n > 0) {
+    if((Plan = (HaloPlanS*)calloc_1d_array(n,sizeof(HaloPlanS))) == NULL)
+      ath_error("[bvals_init]: Failed to allocate communication plans\n");
+  }
 #endif /* MPI_PARALLEL */
 
 /* Cycle through all the Domains that have active Grids on this proc */
@@ -831,79 +831,94 @@ void bvals_mhd_init(MeshS *pM)
       }
     }
 
-/* Figure out largest size needed for send/receive buffers with MPI ----------*/
+/* Neighbours for the single-round exchange.  Only used if all boundaries of
+ * the Domain are periodic, so that the Grid at every offset exists and no
+ * physical BCs have to be set in between the directional stages -----------*/
 
+    for (i=0; i<27; i++) pG->nbr_id[i] = -1;
 #ifdef MPI_PARALLEL
+    halo26 = par_geti_def("job","halo_26",0);
+#if defined(SHEARING_BOX) || defined(FARGO)
+    halo26 = 0;
+#endif
+    if (pG->Nx[0] > 1 && (pD->ix1_BCFun != periodic_ix1 ||
+                          pD->ox1_BCFun != periodic_ox1)) halo26 = 0;
+    if (pG->Nx[1] > 1 && (pD->ix2_BCFun != periodic_ix2 ||
+                          pD->ox2_BCFun != periodic_ox2)) halo26 = 0;
+    if (pG->Nx[2] > 1 && (pD->ix3_BCFun != periodic_ix3 ||
+                          pD->ox3_BCFun != periodic_ox3)) halo26 = 0;
+
+    if (halo26) {
+      for (o[2]=-1; o[2]<=1; o[2]++) {
+      for (o[1]=-1; o[1]<=1; o[1]++) {
+      for (o[0]=-1; o[0]<=1; o[0]++) {
+        if ((o[0] != 0 && pG->Nx[0] == 1) || (o[1] != 0 && pG->Nx[1] == 1) ||
+            (o[2] != 0 && pG->Nx[2] == 1)) continue;
+        l = (myL + o[0] + pD->NGrid[0]) % pD->NGrid[0];
+        m = (myM + o[1] + pD->NGrid[1]) % pD->NGrid[1];
+        n = (myN + o[2] + pD->NGrid[2]) % pD->NGrid[2];
+        pG->nbr_id[(o[2]+1)*9+(o[1]+1)*3+(o[0]+1)] =
+          pD->GData[n][m][l].ID_Comm_Domain;
+      }}}
+    } else if (par_geti_def("job","halo_26",0)) {
+      ath_pout(0,"[bvals_init]: level=%d domain=%d not periodic, halo_26 ignored\n",
+               nl,nd);
+    }
+#endif /* MPI_PARALLEL */
 
-    for (n=0; n<(pD->NGrid[2]); n++){
-    for (m=0; m<(pD->NGrid[1]); m++){
-      for (l=0; l<(pD->NGrid[0]); l++){
-
-/* x1cnt is surface area of x1 faces */
-	if(pD->NGrid[0] > 1){
-	  nx2t = pD->GData[n][m][l].Nx[1];
-	  if(nx2t > 1) nx2t += 1;
-
-	  nx3t = pD->GData[n][m][l].Nx[2];
-	  if(nx3t > 1) nx3t += 1;
-
-          if(nx2t*nx3t > x1cnt) x1cnt = nx2t*nx3t;
-	}
-
-/* x2cnt is surface area of x2 faces */
-	if(pD->NGrid[1] > 1){
-	  nx1t = pD->GData[n][m][l].Nx[0];
-	  if(nx1t > 1) nx1t += 2*nghost;
-
-	  nx3t = pD->GData[n][m][l].Nx[2];
-	  if(nx3t > 1) nx3t += 1;
-
-          if(nx1t*nx3t > x2cnt) x2cnt = nx1t*nx3t;
-	}
-
-/* x3cnt is surface area of x3 faces */
-	if(pD->NGrid[2] > 1){
-	  nx1t = pD->GData[n][m][l].Nx[0];
-	  if(nx1t > 1) nx1t += 2*nghost;
-
-	  nx2t = pD->GData[n][m][l].Nx[1];
-	  if(nx2t > 1) nx2t += 2*nghost;
+/* Communication plan: persistent requests for every MPI boundary.  The region
+ * sent to the Grid at offset n in the single-round exchange is received there
+ * as region 26-n, so it is tagged by the offset seen from the receiver ------*/
 
-          if(nx1t*nx2t > x3cnt) x3cnt = nx1t*nx2t;
-	}
+#ifdef MPI_PARALLEL
+    pP = &(Plan[NPlan++]);
+    pP->pD = pD;
+    for (n=0; n<27; n++) {
+      pP->nbr_send_rq[n] = MPI_REQUEST_NULL;
+      pP->nbr_recv_rq[n] = MPI_REQUEST_NULL;
+      pP->nbr_shm[n] = NULL;
+    }
+    for (dir=0; dir<3; dir++) {
+      for (i=0; i<2; i++) {
+        pP->send_rq[dir][i] = MPI_REQUEST_NULL;
+        pP->recv_rq[dir][i] = MPI_REQUEST_NULL;
+        pP->shm[dir][i] = NULL;
+      }
+    }
+
+    if (pG->nbr_id[13] >= 0) {
+      for (n=0; n<27; n++) {
+        if (n == 13 || pG->nbr_id[n] < 0) continue;
+        o[0] = n%3 - 1;  o[1] = (n/3)%3 - 1;  o[2] = n/9 - 1;
+        if (pG->Win_shm != MPI_WIN_NULL)
+          pP->nbr_shm[n] = shm_view(pD,myL+o[0],myM+o[1],myN+o[2]);
+        if (pP->nbr_shm[n] != NULL) continue;
+        halo_init(0,o,pG,pG->nbr_id[n],nbr26_tag+n,nbr26_tag+26-n,
+          pD->Comm_Domain,&(pP->nbr_recv_rq[n]),&(pP->nbr_send_rq[n]));
+      }
+    } else {
+      for (dir=0; dir<3; dir++) {
+        if (pG->Nx[dir] == 1) continue;
+        for (i=0; i<2; i++) {
+          if (dir == 0) id = (i == 0) ? pG->lx1_id : pG->rx1_id;
+          if (dir == 1) id = (i == 0) ? pG->lx2_id : pG->rx2_id;
+          if (dir == 2) id = (i == 0) ? pG->lx3_id : pG->rx3_id;
+          if (id < 0) continue;
+          o[0] = o[1] = o[2] = 0;
+          o[dir] = (i == 0) ? -1 : 1;
+          if (pG->Win_shm != MPI_WIN_NULL)
+            pP->shm[dir][i] = shm_view(pD,myL+o[0],myM+o[1],myN+o[2]);
+          if (pP->shm[dir][i] != NULL) continue;
+          halo_init(dir,o,pG,id,(i == 0) ? LtoR_tag : RtoL_tag,
+            (i == 0) ? RtoL_tag : LtoR_tag, pD->Comm_Domain,
+            &(pP->recv_rq[dir][i]),&(pP->send_rq[dir][i]));
+        }
       }
-    }}
+    }
 #endif /* MPI_PARALLEL */
 
   }}}  /* End loop over all Domains with active Grids -----------------------*/
 
-#ifdef MPI_PARALLEL
-/* Allocate memory for send/receive buffers and MPI_Requests */
-
-  size = x1cnt > x2cnt ? x1cnt : x2cnt;
-  size = x3cnt >  size ? x3cnt : size;
-
-#ifdef MHD
-  size *= nghost*((NVAR)+3);
-#else
-  size *= nghost*(NVAR);
-#endif
-
-  if (size > 0) {
-    if((send_buf = (double**)calloc_2d_array(2,size,sizeof(double))) == NULL)
-      ath_error("[bvals_init]: Failed to allocate send buffer\n");
-
-    if((recv_buf = (double**)calloc_2d_array(2,size,sizeof(double))) == NULL)
-      ath_error("[bvals_init]: Failed to allocate recv buffer\n");
-  }
-
-  if((recv_rq = (MPI_Request*) calloc_1d_array(2,sizeof(MPI_Request))) == NULL)
-    ath_error("[bvals_init]: Failed to allocate recv MPI_Request array\n");
-  if((send_rq = (MPI_Request*) calloc_1d_array(2,sizeof(MPI_Request))) == NULL)
-    ath_error("[bvals_init]: Failed to allocate send MPI_Request array\n");
-
-#endif /* MPI_PARALLEL */
-
   return;
 }
 
@@ -946,8 +961,7 @@ void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc)
  *   outflow_???
  *   periodic_???
  *   conduct_???
- *   pack_???
- *   unpack_???
+ *   halo_???
  */
 
 /*----------------------------------------------------------------------------*/
@@ -967,10 +981,10 @@ static void reflect_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i]    =  pGrid->U[k][j][is+(i-1)];
-        pGrid->U[k][j][is-i].M1 = -pGrid->U[k][j][is-i].M1; /* reflect 1-mom. */
+        USET(pGrid,k,j,is-i,UGET(pGrid,k,j,is+(i-1)));
+        UVAR(pGrid,k,j,is-i,M1) = -UVAR(pGrid,k,j,is-i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][is-i].B1c= -pGrid->U[k][j][is-i].B1c;/* reflect 1-fld. */
+        UVAR(pGrid,k,j,is-i,B1c)= -UVAR(pGrid,k,j,is-i,B1c);/* reflect 1-fld. */
 #endif
       }
     }
@@ -1026,10 +1040,10 @@ static void reflect_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i]    =  pGrid->U[k][j][ie-(i-1)];
-        pGrid->U[k][j][ie+i].M1 = -pGrid->U[k][j][ie+i].M1; /* reflect 1-mom. */
+        USET(pGrid,k,j,ie+i,UGET(pGrid,k,j,ie-(i-1)));
+        UVAR(pGrid,k,j,ie+i,M1) = -UVAR(pGrid,k,j,ie+i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][ie+i].B1c= -pGrid->U[k][j][ie+i].B1c;/* reflect 1-fld. */
+        UVAR(pGrid,k,j,ie+i,B1c)= -UVAR(pGrid,k,j,ie+i,B1c);/* reflect 1-fld. */
 #endif
       }
     }
@@ -1085,10 +1099,10 @@ static void reflect_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i]    =  pGrid->U[k][js+(j-1)][i];
-        pGrid->U[k][js-j][i].M2 = -pGrid->U[k][js-j][i].M2; /* reflect 2-mom. */
+        USET(pGrid,k,js-j,i,UGET(pGrid,k,js+(j-1),i));
+        UVAR(pGrid,k,js-j,i,M2) = -UVAR(pGrid,k,js-j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][js-j][i].B2c= -pGrid->U[k][js-j][i].B2c;/* reflect 2-fld. */
+        UVAR(pGrid,k,js-j,i,B2c)= -UVAR(pGrid,k,js-j,i,B2c);/* reflect 2-fld. */
 #endif
       }
     }
@@ -1146,10 +1160,10 @@ static void reflect_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i]    =  pGrid->U[k][je-(j-1)][i];
-        pGrid->U[k][je+j][i].M2 = -pGrid->U[k][je+j][i].M2; /* reflect 2-mom. */
+        USET(pGrid,k,je+j,i,UGET(pGrid,k,je-(j-1),i));
+        UVAR(pGrid,k,je+j,i,M2) = -UVAR(pGrid,k,je+j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][je+j][i].B2c= -pGrid->U[k][je+j][i].B2c;/* reflect 2-fld. */
+        UVAR(pGrid,k,je+j,i,B2c)= -UVAR(pGrid,k,je+j,i,B2c);/* reflect 2-fld. */
 #endif
       }
     }
@@ -1204,10 +1218,10 @@ static void reflect_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i]    =  pGrid->U[ks+(k-1)][j][i];
-        pGrid->U[ks-k][j][i].M3 = -pGrid->U[ks-k][j][i].M3; /* reflect 3-mom. */
+        USET(pGrid,ks-k,j,i,UGET(pGrid,ks+(k-1),j,i));
+        UVAR(pGrid,ks-k,j,i,M3) = -UVAR(pGrid,ks-k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ks-k][j][i].B3c= -pGrid->U[ks-k][j][i].B3c;/* reflect 3-fld.*/
+        UVAR(pGrid,ks-k,j,i,B3c)= -UVAR(pGrid,ks-k,j,i,B3c);/* reflect 3-fld.*/
 #endif
       }
     }
@@ -1264,10 +1278,10 @@ static void reflect_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i]    =  pGrid->U[ke-(k-1)][j][i];
-        pGrid->U[ke+k][j][i].M3 = -pGrid->U[ke+k][j][i].M3; /* reflect 3-mom. */
+        USET(pGrid,ke+k,j,i,UGET(pGrid,ke-(k-1),j,i));
+        UVAR(pGrid,ke+k,j,i,M3) = -UVAR(pGrid,ke+k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ke+k][j][i].B3c= -pGrid->U[ke+k][j][i].B3c;/* reflect 3-fld. */
+        UVAR(pGrid,ke+k,j,i,B3c)= -UVAR(pGrid,ke+k,j,i,B3c);/* reflect 3-fld. */
 #endif
       }
     }
@@ -1327,7 +1341,7 @@ static void outflow_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][is];
+        USET(pGrid,k,j,is-i,UGET(pGrid,k,j,is));
       }
     }
   }
@@ -1381,7 +1395,7 @@ static void outflow_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][ie];
+        USET(pGrid,k,j,ie+i,UGET(pGrid,k,j,ie));
       }
     }
   }
@@ -1435,7 +1449,7 @@ static void outflow_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i] = pGrid->U[k][js][i];
+        USET(pGrid,k,js-j,i,UGET(pGrid,k,js,i));
       }
     }
   }
@@ -1489,7 +1503,7 @@ static void outflow_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i] = pGrid->U[k][je][i];
+        USET(pGrid,k,je+j,i,UGET(pGrid,k,je,i));
       }
     }
   }
@@ -1540,7 +1554,7 @@ static void outflow_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i] = pGrid->U[ks][j][i];
+        USET(pGrid,ks-k,j,i,UGET(pGrid,ks,j,i));
       }
     }
   }
@@ -1591,7 +1605,7 @@ static void outflow_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i] = pGrid->U[ke][j][i];
+        USET(pGrid,ke+k,j,i,UGET(pGrid,ke,j,i));
       }
     }
   }
@@ -1645,7 +1659,7 @@ static void periodic_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][ie-(i-1)];
+        USET(pGrid,k,j,is-i,UGET(pGrid,k,j,ie-(i-1)));
       }
     }
   }
@@ -1699,7 +1713,7 @@ static void periodic_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][is+(i-1)];
+        USET(pGrid,k,j,ie+i,UGET(pGrid,k,j,is+(i-1)));
       }
     }
   }
@@ -1753,7 +1767,7 @@ static void periodic_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i] = pGrid->U[k][je-(j-1)][i];
+        USET(pGrid,k,js-j,i,UGET(pGrid,k,je-(j-1),i));
       }
     }
   }
@@ -1807,7 +1821,7 @@ static void periodic_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i] = pGrid->U[k][js+(j-1)][i];
+        USET(pGrid,k,je+j,i,UGET(pGrid,k,js+(j-1),i));
       }
     }
   }
@@ -1858,7 +1872,7 @@ static void periodic_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i] = pGrid->U[ke-(k-1)][j][i];
+        USET(pGrid,ks-k,j,i,UGET(pGrid,ke-(k-1),j,i));
       }
     }
   }
@@ -1909,7 +1923,7 @@ static void periodic_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i] = pGrid->U[ks+(k-1)][j][i];
+        USET(pGrid,ke+k,j,i,UGET(pGrid,ks+(k-1),j,i));
       }
     }
   }
@@ -1963,11 +1977,11 @@ static void conduct_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i]    =  pGrid->U[k][j][is+(i-1)];
-        pGrid->U[k][j][is-i].M1 = -pGrid->U[k][j][is-i].M1; /* reflect 1-mom. */
+        USET(pGrid,k,j,is-i,UGET(pGrid,k,j,is+(i-1)));
+        UVAR(pGrid,k,j,is-i,M1) = -UVAR(pGrid,k,j,is-i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][is-i].B2c= -pGrid->U[k][j][is-i].B2c;/* reflect fld */
-        pGrid->U[k][j][is-i].B3c= -pGrid->U[k][j][is-i].B3c;
+        UVAR(pGrid,k,j,is-i,B2c)= -UVAR(pGrid,k,j,is-i,B2c);/* reflect fld */
+        UVAR(pGrid,k,j,is-i,B3c)= -UVAR(pGrid,k,j,is-i,B3c);
 #endif
       }
     }
@@ -2022,11 +2036,11 @@ static void conduct_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i]    =  pGrid->U[k][j][ie-(i-1)];
-        pGrid->U[k][j][ie+i].M1 = -pGrid->U[k][j][ie+i].M1; /* reflect 1-mom. */
+        USET(pGrid,k,j,ie+i,UGET(pGrid,k,j,ie-(i-1)));
+        UVAR(pGrid,k,j,ie+i,M1) = -UVAR(pGrid,k,j,ie+i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][ie+i].B2c= -pGrid->U[k][j][ie+i].B2c;/* reflect fld */
-        pGrid->U[k][j][ie+i].B3c= -pGrid->U[k][j][ie+i].B3c;
+        UVAR(pGrid,k,j,ie+i,B2c)= -UVAR(pGrid,k,j,ie+i,B2c);/* reflect fld */
+        UVAR(pGrid,k,j,ie+i,B3c)= -UVAR(pGrid,k,j,ie+i,B3c);
 #endif
       }
     }
@@ -2081,11 +2095,11 @@ static void conduct_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i]    =  pGrid->U[k][js+(j-1)][i];
-        pGrid->U[k][js-j][i].M2 = -pGrid->U[k][js-j][i].M2; /* reflect 2-mom. */
+        USET(pGrid,k,js-j,i,UGET(pGrid,k,js+(j-1),i));
+        UVAR(pGrid,k,js-j,i,M2) = -UVAR(pGrid,k,js-j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][js-j][i].B1c= -pGrid->U[k][js-j][i].B1c;/* reflect fld */
-        pGrid->U[k][js-j][i].B3c= -pGrid->U[k][js-j][i].B3c;
+        UVAR(pGrid,k,js-j,i,B1c)= -UVAR(pGrid,k,js-j,i,B1c);/* reflect fld */
+        UVAR(pGrid,k,js-j,i,B3c)= -UVAR(pGrid,k,js-j,i,B3c);
 #endif
       }
     }
@@ -2140,11 +2154,11 @@ static void conduct_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i]    =  pGrid->U[k][je-(j-1)][i];
-        pGrid->U[k][je+j][i].M2 = -pGrid->U[k][je+j][i].M2; /* reflect 2-mom. */
+        USET(pGrid,k,je+j,i,UGET(pGrid,k,je-(j-1),i));
+        UVAR(pGrid,k,je+j,i,M2) = -UVAR(pGrid,k,je+j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][je+j][i].B1c= -pGrid->U[k][je+j][i].B1c;/* reflect fld */
-        pGrid->U[k][je+j][i].B3c= -pGrid->U[k][je+j][i].B3c;
+        UVAR(pGrid,k,je+j,i,B1c)= -UVAR(pGrid,k,je+j,i,B1c);/* reflect fld */
+        UVAR(pGrid,k,je+j,i,B3c)= -UVAR(pGrid,k,je+j,i,B3c);
 #endif
       }
     }
@@ -2196,11 +2210,11 @@ static void conduct_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i]    =  pGrid->U[ks+(k-1)][j][i];
-        pGrid->U[ks-k][j][i].M3 = -pGrid->U[ks-k][j][i].M3; /* reflect 3-mom. */
+        USET(pGrid,ks-k,j,i,UGET(pGrid,ks+(k-1),j,i));
+        UVAR(pGrid,ks-k,j,i,M3) = -UVAR(pGrid,ks-k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ks-k][j][i].B1c= -pGrid->U[ks-k][j][i].B1c;/* reflect fld */
-        pGrid->U[ks-k][j][i].B2c= -pGrid->U[ks-k][j][i].B2c;
+        UVAR(pGrid,ks-k,j,i,B1c)= -UVAR(pGrid,ks-k,j,i,B1c);/* reflect fld */
+        UVAR(pGrid,ks-k,j,i,B2c)= -UVAR(pGrid,ks-k,j,i,B2c);
 #endif
       }
     }
@@ -2252,11 +2266,11 @@ static void conduct_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i]    =  pGrid->U[ke-(k-1)][j][i];
-        pGrid->U[ke+k][j][i].M3 = -pGrid->U[ke+k][j][i].M3; /* reflect 3-mom. */
+        USET(pGrid,ke+k,j,i,UGET(pGrid,ke-(k-1),j,i));
+        UVAR(pGrid,ke+k,j,i,M3) = -UVAR(pGrid,ke+k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ke+k][j][i].B1c= -pGrid->U[ke+k][j][i].B1c;/* reflect fld */
-        pGrid->U[ke+k][j][i].B2c= -pGrid->U[ke+k][j][i].B2c;
+        UVAR(pGrid,ke+k,j,i,B1c)= -UVAR(pGrid,ke+k,j,i,B1c);/* reflect fld */
+        UVAR(pGrid,ke+k,j,i,B2c)= -UVAR(pGrid,ke+k,j,i,B2c);
 #endif
       }
     }
@@ -2307,722 +2321,290 @@ static void ProlongateLater(GridS *pGrid __attribute((unused)))
   return;
 }
 
-#ifdef MPI_PARALLEL  /* This ifdef wraps the next 12 funs; ~800 lines */
+#ifdef MPI_PARALLEL  /* This ifdef wraps the next 7 funs; ~220 lines */
 /*----------------------------------------------------------------------------*/
-/*! \fn static void pack_ix1(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Inner x1 boundary */
-
-static void pack_ix1(GridS *pG)
+/*! \fn static void nbr_range(const GridS *pG, const int dir, const int o,
+ *                            const int face, const int recv, int *lo, int *hi)
+ *  \brief Index range [lo,hi] in direction dir (0,1,2 for x1,x2,x3) of the
+ *   region exchanged with the Grid at offset o (-1,0,1) in that direction.
+ *   With recv=1 this is the range of ghost zones received, with recv=0 the
+ *   range of active zones sent.  With face=1 the range is for the interface
+ *   field normal to dir, which like the directional exchange is not set at
+ *   is-nghost, and includes ie+1 in the active range. */
+
+static void nbr_range(const GridS *pG, const int dir, const int o,
+                      const int face, const int recv, int *lo, int *hi)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#ifdef MHD
-  int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pSnd;
-  pSnd = (double*)&(send_buf[0][0]);
-
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=is; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i at i=is maps to B1i at i=ie+1 and is not passed */
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=is+1; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->B1i[k][j][i];
-      }
-    }
-  }
-
-  if (pG->Nx[1] > 1) ju=je+1; else ju=je;
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=ju; j++){
-      for (i=is; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->B2i[k][j][i];
-      }
-    }
-  }
+  int s = (dir == 0) ? pG->is : ((dir == 1) ? pG->js : pG->ks);
+  int e = (dir == 0) ? pG->ie : ((dir == 1) ? pG->je : pG->ke);
 
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++){
-    for (j=js; j<=je; j++){
-      for (i=is; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->B3i[k][j][i];
-      }
-    }
+  if (o == 0) {
+    *lo = s;
+    *hi = (face && pG->Nx[dir] > 1) ? e+1 : e;
+  } else if (recv) {
+    *lo = (o < 0) ? s-nghost+face : e+1+face;
+    *hi = (o < 0) ? s-1 : e+nghost;
+  } else {
+    *lo = (o < 0) ? s+face : e-nghost+1+face;
+    *hi = (o < 0) ? s+nghost-1 : e;
   }
-#endif
 
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void pack_ox1(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Outer x1 boundary */
-
-static void pack_ox1(GridS *pG)
+/*! \fn static void halo_range(const GridS *pG, const int nfull,
+ *                             const int *o, const int recv,
+ *                             int lo[4][3], int hi[4][3])
+ *  \brief Index ranges of the region exchanged with the Grid at offset o.
+ *   [0] is the range of the cell-centred variables, [1..3] the ranges of
+ *   B1i, B2i and B3i.  The first nfull directions span the active and ghost
+ *   zones (directions already set by earlier stages of the directional
+ *   exchange); the others are given by nbr_range(). */
+
+static void halo_range(const GridS *pG, const int nfull, const int *o,
+                       const int recv, int lo[4][3], int hi[4][3])
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#ifdef MHD
-  int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pSnd;
-  pSnd = (double*)&(send_buf[1][0]);
-
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=ie-(nghost-1); i<=ie; i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i at i=ie-(nghost-1) maps to B1i at i=is-nghost and is not passed */
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=ie-(nghost-2); i<=ie; i++){
-        *(pSnd++) = pG->B1i[k][j][i];
-      }
-    }
-  }
+  int f,dir,s,e;
 
-  if (pG->Nx[1] > 1) ju=je+1; else ju=je;
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=ju; j++){
-      for (i=ie-(nghost-1); i<=ie; i++){
-        *(pSnd++) = pG->B2i[k][j][i];
+  for (f=0; f<4; f++) {
+    for (dir=0; dir<3; dir++) {
+      if (dir < nfull && pG->Nx[dir] > 1) {
+        s = (dir == 0) ? pG->is : ((dir == 1) ? pG->js : pG->ks);
+        e = (dir == 0) ? pG->ie : ((dir == 1) ? pG->je : pG->ke);
+        lo[f][dir] = (f == dir+1) ? s-(nghost-1) : s-nghost;
+        hi[f][dir] = e+nghost;
+      } else {
+        nbr_range(pG,dir,o[dir],(f == dir+1),recv,&lo[f][dir],&hi[f][dir]);
       }
     }
   }
 
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++){
-    for (j=js; j<=je; j++){
-      for (i=ie-(nghost-1); i<=ie; i++){
-        *(pSnd++) = pG->B3i[k][j][i];
-      }
-    }
-  }
-#endif /* MHD */
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void pack_ix2(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Inner x2 boundary */
-
-static void pack_ix2(GridS *pG)
+/*! \fn static MPI_Datatype block_type(void ***a, const MPI_Aint esz,
+ *                             const int nel, const int *lo, const int *hi,
+ *                             MPI_Aint *pAddr)
+ *  \brief Datatype for the first nel doubles of each element a[k][j][i] with
+ *   (i,j,k) in [lo,hi], for a 3D array of elements of esz bytes.  The strides
+ *   are read from the array itself, so padded (aligned) rows are allowed.
+ *   Returns the absolute address of the first element in *pAddr. */
+
+static MPI_Datatype block_type(void ***a, const MPI_Aint esz, const int nel,
+                               const int *lo, const int *hi, MPI_Aint *pAddr)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#ifdef MHD
-  int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pSnd;
-  pSnd = (double*)&(send_buf[0][0]);
-
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=js+(nghost-1); j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=js+(nghost-1); j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B1i[k][j][i];
-      }
-    }
-  }
-
-/* B2i at j=js maps to B2i at j=je+1 and is not passed */
-  for (k=ks; k<=ke; k++) {
-    for (j=js+1; j<=js+(nghost-1); j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B2i[k][j][i];
-      }
-    }
-  }
-
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++) {
-    for (j=js; j<=js+(nghost-1); j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B3i[k][j][i];
-      }
-    }
-  }
-#endif /* MHD */
-
-  return;
+  MPI_Datatype t[4];
+  MPI_Aint sj=0, sk=0;
+  unsigned char *p0;
+  int n,ierr;
+
+  p0 = (unsigned char*)a[lo[2]][lo[1]];
+  if (hi[1] > lo[1]) sj = (unsigned char*)a[lo[2]][lo[1]+1] - p0;
+  if (hi[2] > lo[2]) sk = (unsigned char*)a[lo[2]+1][lo[1]] - p0;
+  p0 += lo[0]*esz;
+
+  ierr = MPI_Type_contiguous(nel, MPI_DOUBLE, &t[0]);
+  ierr = MPI_Type_create_hvector(hi[0]-lo[0]+1, 1, esz, t[0], &t[1]);
+  ierr = MPI_Type_create_hvector(hi[1]-lo[1]+1, 1, sj, t[1], &t[2]);
+  ierr = MPI_Type_create_hvector(hi[2]-lo[2]+1, 1, sk, t[2], &t[3]);
+  for (n=0; n<3; n++) ierr = MPI_Type_free(&t[n]);
+  ierr = MPI_Get_address(p0, pAddr);
+
+  return t[3];
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void pack_ox2(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Outer x2 boundary */
+/*! \fn static MPI_Datatype region_type(GridS *pG, int lo[4][3],
+ *                                      int hi[4][3])
+ *  \brief Committed datatype, relative to MPI_BOTTOM, for the U variables in
+ *   range [0] and B1i, B2i, B3i in ranges [1..3] of pG, so that messages are
+ *   sent from and received into the Grid arrays without staging copies. */
 
-static void pack_ox2(GridS *pG)
+static MPI_Datatype region_type(GridS *pG, int lo[4][3], int hi[4][3])
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
+  MPI_Datatype type, t[(NVAR)+3];
+  MPI_Aint addr[(NVAR)+3];
+  int len[(NVAR)+3];
+  int n,nb=0,ierr;
 #ifdef MHD
-  int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pSnd;
-  pSnd = (double*)&(send_buf[1][0]);
-
-  for (k=ks; k<=ke; k++){
-    for (j=je-(nghost-1); j<=je; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+  int f;
 #endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks; k<=ke; k++) {
-    for (j=je-(nghost-1); j<=je; j++){
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B1i[k][j][i];
-      }
-    }
-  }
-
-/* B2i at j=je-(nghost-1) maps to B2i at j=js-nghost and is not passed */
-  for (k=ks; k<=ke; k++) {
-    for (j=je-(nghost-2); j<=je; j++){
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B2i[k][j][i];
-      }
-    }
-  }
 
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++) {
-    for (j=je-(nghost-1); j<=je; j++){
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B3i[k][j][i];
-      }
-    }
+#ifdef SOA_STORAGE
+  for (n=0; n<NVAR; n++, nb++)
+    t[nb] = block_type((void***)(((Real ****)&(pG->U))[n]),
+                       (MPI_Aint)sizeof(Real), 1, lo[0], hi[0], &addr[nb]);
+#else
+  t[nb] = block_type((void***)pG->U, (MPI_Aint)sizeof(ConsS), NVAR,
+                     lo[0], hi[0], &addr[nb]);
+  nb++;
+#endif /* SOA_STORAGE */
+#ifdef MHD
+  for (f=1; f<4; f++) {
+    if (hi[f][0] < lo[f][0] || hi[f][1] < lo[f][1] || hi[f][2] < lo[f][2])
+      continue;
+    t[nb] = block_type((void***)(f == 1 ? pG->B1i : (f == 2 ? pG->B2i :
+      pG->B3i)), (MPI_Aint)sizeof(Real), 1, lo[f], hi[f], &addr[nb]);
+    nb++;
   }
 #endif /* MHD */
 
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_ix3(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Inner x3 boundary */
-
-static void pack_ix3(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pSnd;
-  pSnd = (double*)&(send_buf[0][0]);
+  for (n=0; n<nb; n++) len[n] = 1;
+  ierr = MPI_Type_create_struct(nb, len, addr, t, &type);
+  ierr = MPI_Type_commit(&type);
+  for (n=0; n<nb; n++) ierr = MPI_Type_free(&t[n]);
 
-  for (k=ks; k<=ks+(nghost-1); k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks; k<=ks+(nghost-1); k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B1i[k][j][i];
-      }
-    }
-  }
-
-/* B2i is not set at j=js-nghost */
-  for (k=ks; k<=ks+(nghost-1); k++) {
-    for (j=js-(nghost-1); j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B2i[k][j][i];
-      }
-    }
-  }
-
-/* B3i at k=ks maps to B3i at k=ke+1 and is not passed */
-  for (k=ks+1; k<=ks+(nghost-1); k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B3i[k][j][i];
-      }
-    }
-  }
-#endif /* MHD */
-
-  return;
+  return type;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void pack_ox3(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Outer x3 boundary */
-
-static void pack_ox3(GridS *pG)
+/*! \fn static void halo_init(const int nfull, const int *o, GridS *pG,
+ *                  const int id, const int rtag, const int stag,
+ *                  MPI_Comm comm, MPI_Request *pRecv, MPI_Request *pSend)
+ *  \brief Creates the persistent receive (tag rtag) and send (tag stag) of
+ *   the region exchanged with Grid id at offset o. */
+
+static void halo_init(const int nfull, const int *o, GridS *pG, const int id,
+                      const int rtag, const int stag, MPI_Comm comm,
+                      MPI_Request *pRecv, MPI_Request *pSend)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pSnd;
-  pSnd = (double*)&(send_buf[1][0]);
+  int lo[4][3],hi[4][3],ierr;
+  MPI_Datatype type;
 
-  for (k=ke-(nghost-1); k<=ke; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
-    }
-  }
+  halo_range(pG,nfull,o,1,lo,hi);
+  type = region_type(pG,lo,hi);
+  ierr = MPI_Recv_init(MPI_BOTTOM,1,type,id,rtag,comm,pRecv);
+  ierr = MPI_Type_free(&type);
 
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ke-(nghost-1); k<=ke; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B1i[k][j][i];
-      }
-    }
-  }
-
-/* B2i is not set at j=js-nghost */
-  for (k=ke-(nghost-1); k<=ke; k++) {
-    for (j=js-(nghost-1); j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B2i[k][j][i];
-      }
-    }
-  }
-
-/* B3i at k=ke-(nghost-1) maps to B3i at k=ks-nghost and is not passed */
-  for (k=ke-(nghost-2); k<=ke; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->B3i[k][j][i];
-      }
-    }
-  }
-#endif /* MHD */
+  halo_range(pG,nfull,o,0,lo,hi);
+  type = region_type(pG,lo,hi);
+  ierr = MPI_Send_init(MPI_BOTTOM,1,type,id,stag,comm,pSend);
+  ierr = MPI_Type_free(&type);
 
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_ix1(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Inner x1 boundary */
+/*! \fn static HaloPlanS *get_plan(DomainS *pD)
+ *  \brief Returns the communication plan of Domain pD */
 
-static void unpack_ix1(GridS *pG)
+static HaloPlanS *get_plan(DomainS *pD)
 {
-  int is = pG->is;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#ifdef MHD
-  int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
   int n;
-#endif
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[0][0]);
-
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=is-nghost; i<=is-1; i++){
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=je; j++) {
-      for (i=is-(nghost-1); i<=is-1; i++){
-        pG->B1i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  if (pG->Nx[1] > 1) ju=je+1; else ju=je;
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=ju; j++) {
-      for (i=is-nghost; i<=is-1; i++){
-        pG->B2i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++) {
-    for (j=js; j<=je; j++) {
-      for (i=is-nghost; i<=is-1; i++){
-        pG->B3i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-#endif /* MHD */
 
-  return;
+  for (n=0; n<NPlan; n++) if (Plan[n].pD == pD) return &(Plan[n]);
+  ath_error("[bvals_mhd]: no communication plan for Domain\n");
+  return NULL;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_ox1(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Outer x1 boundary */
+/*! \fn static void start_dir(HaloPlanS *pP, const int dir)
+ *  \brief Starts the persistent receives, then sends, of a directional stage*/
 
-static void unpack_ox1(GridS *pG)
+static void start_dir(HaloPlanS *pP, const int dir)
 {
-  int ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#ifdef MHD
-  int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[1][0]);
+  int n,ierr;
 
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=je; j++) {
-      for (i=ie+1; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=ie+1 */
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=je; j++) {
-      for (i=ie+2; i<=ie+nghost; i++) {
-        pG->B1i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  if (pG->Nx[1] > 1) ju=je+1; else ju=je;
-  for (k=ks; k<=ke; k++) {
-    for (j=js; j<=ju; j++) {
-      for (i=ie+1; i<=ie+nghost; i++) {
-        pG->B2i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++) {
-    for (j=js; j<=je; j++) {
-      for (i=ie+1; i<=ie+nghost; i++) {
-        pG->B3i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-#endif /* MHD */
+  for (n=0; n<2; n++)
+    if (pP->recv_rq[dir][n] != MPI_REQUEST_NULL)
+      ierr = MPI_Start(&(pP->recv_rq[dir][n]));
+  for (n=0; n<2; n++)
+    if (pP->send_rq[dir][n] != MPI_REQUEST_NULL)
+      ierr = MPI_Start(&(pP->send_rq[dir][n]));
 
   return;
 }
-
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_ix2(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Inner x2 boundary */
-
-static void unpack_ix2(GridS *pG)
+/*! \fn static GridS *shm_view(DomainS *pD, const int l, const int m,
+ *                             const int n)
+ *  \brief Returns a Grid whose U and interface fields point to those of the
+ *   Grid at index (l,m,n) (wrapped periodically) in the shared-memory window
+ *   of pD, or NULL if that Grid is not on this node.  Only the sizes and
+ *   index ranges of the view are set. */
+
+static GridS *shm_view(DomainS *pD, const int l, const int m, const int n)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-#ifdef MHD
-  int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[0][0]);
-
-  for (k=ks; k<=ke; k++) {
-    for (j=js-nghost; j<=js-1; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks; k<=ke; k++) {
-    for (j=js-nghost; j<=js-1; j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        pG->B1i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-/* B2i is not set at j=js-nghost */
-  for (k=ks; k<=ke; k++) {
-    for (j=js-(nghost-1); j<=js-1; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B2i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++) {
-    for (j=js-nghost; j<=js-1; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B3i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-#endif /* MHD */
-
-  return;
+  GridS *pG = pD->Grid, *pS;
+  MPI_Group gD, gS;
+  MPI_Aint size;
+  void *base;
+  int ll,mm,nn,id,shmid,disp,dir,ierr;
+
+  ll = (l + pD->NGrid[0]) % pD->NGrid[0];
+  mm = (m + pD->NGrid[1]) % pD->NGrid[1];
+  nn = (n + pD->NGrid[2]) % pD->NGrid[2];
+  id = pD->GData[nn][mm][ll].ID_Comm_Domain;
+
+  ierr = MPI_Comm_group(pD->Comm_Domain, &gD);
+  ierr = MPI_Comm_group(pG->Comm_shm, &gS);
+  ierr = MPI_Group_translate_ranks(gD, 1, &id, gS, &shmid);
+  ierr = MPI_Group_free(&gD);
+  ierr = MPI_Group_free(&gS);
+  if (shmid == MPI_UNDEFINED) return NULL;
+
+  if ((pS = (GridS*)calloc_1d_array(1,sizeof(GridS))) == NULL)
+    ath_error("[bvals_init]: Failed to allocate shared-memory view\n");
+  for (dir=0; dir<3; dir++) pS->Nx[dir] = pD->GData[nn][mm][ll].Nx[dir];
+  pS->is = (pS->Nx[0] > 1) ? nghost : 0;
+  pS->ie = (pS->Nx[0] > 1) ? pS->Nx[0] + nghost - 1 : 0;
+  pS->js = (pS->Nx[1] > 1) ? nghost : 0;
+  pS->je = (pS->Nx[1] > 1) ? pS->Nx[1] + nghost - 1 : 0;
+  pS->ks = (pS->Nx[2] > 1) ? nghost : 0;
+  pS->ke = (pS->Nx[2] > 1) ? pS->Nx[2] + nghost - 1 : 0;
+
+  ierr = MPI_Win_shared_query(pG->Win_shm, shmid, &size, &disp, &base);
+  shm_grid_map(pS, base);
+
+  return pS;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_ox2(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Outer x2 boundary */
+/*! \fn static void shm_copy(GridS *pG, GridS *pS, const int nfull,
+ *                           const int *o)
+ *  \brief Copies the region exchanged with the Grid at offset o, which is
+ *   pS in shared memory, into the ghost zones of pG.  Only the conserved
+ *   variables of U are copied. */
 
-static void unpack_ox2(GridS *pG)
+static void shm_copy(GridS *pG, GridS *pS, const int nfull, const int *o)
 {
-  int is = pG->is, ie = pG->ie;
-  int je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
+  int lo[4][3],hi[4][3],slo[4][3],shi[4][3],mo[3];
+  int i,j,k,n,di,dj,dk;
 #ifdef MHD
-  int ku; /* k-upper */
+  int f;
+  Real ***a, ***b;
 #endif
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[1][0]);
 
-  for (k=ks; k<=ke; k++) {
-    for (j=je+1; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
-    }
-  }
+  mo[0] = -o[0];  mo[1] = -o[1];  mo[2] = -o[2];
+  halo_range(pG,nfull,o,1,lo,hi);
+  halo_range(pS,nfull,mo,0,slo,shi);
 
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks; k<=ke; k++) {
-    for (j=je+1; j<=je+nghost; j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        pG->B1i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-/* B2i is not set at j=je+1 */
-  for (k=ks; k<=ke; k++) {
-    for (j=je+2; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B2i[k][j][i] = *(pRcv++);
+  di = slo[0][0] - lo[0][0];
+  dj = slo[0][1] - lo[0][1];
+  dk = slo[0][2] - lo[0][2];
+  for (n=0; n<NVAR; n++) {
+    for (k=lo[0][2]; k<=hi[0][2]; k++) {
+      for (j=lo[0][1]; j<=hi[0][1]; j++) {
+        for (i=lo[0][0]; i<=hi[0][0]; i++) {
+          UCOMP(pG,k,j,i,n) = UCOMP(pS,k+dk,j+dj,i+di,n);
+        }
       }
     }
   }
 
-  if (pG->Nx[2] > 1) ku=ke+1; else ku=ke;
-  for (k=ks; k<=ku; k++) {
-    for (j=je+1; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B3i[k][j][i] = *(pRcv++);
+#ifdef MHD
+  for (f=1; f<4; f++) {
+    a = (f == 1) ? pG->B1i : ((f == 2) ? pG->B2i : pG->B3i);
+    b = (f == 1) ? pS->B1i : ((f == 2) ? pS->B2i : pS->B3i);
+    di = slo[f][0] - lo[f][0];
+    dj = slo[f][1] - lo[f][1];
+    dk = slo[f][2] - lo[f][2];
+    for (k=lo[f][2]; k<=hi[f][2]; k++) {
+      for (j=lo[f][1]; j<=hi[f][1]; j++) {
+        for (i=lo[f][0]; i<=hi[f][0]; i++) {
+          a[k][j][i] = b[k+dk][j+dj][i+di];
+        }
       }
     }
   }
@@ -3032,141 +2614,37 @@ static void unpack_ox2(GridS *pG)
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_ix3(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Inner x3 boundary */
+/*! \fn static void shm_copy_dir(HaloPlanS *pP, GridS *pG, const int dir)
+ *  \brief Copies the ghost zones of both sides of directional stage dir from
+ *   neighbours in shared memory */
 
-static void unpack_ix3(GridS *pG)
+static void shm_copy_dir(HaloPlanS *pP, GridS *pG, const int dir)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks;
-  int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[0][0]);
+  int o[3],i;
 
-  for (k=ks-nghost; k<=ks-1; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ks-nghost; k<=ks-1; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        pG->B1i[k][j][i] = *(pRcv++);
-      }
-    }
+  for (i=0; i<2; i++) {
+    if (pP->shm[dir][i] == NULL) continue;
+    o[0] = o[1] = o[2] = 0;
+    o[dir] = (i == 0) ? -1 : 1;
+    shm_copy(pG,pP->shm[dir][i],dir,o);
   }
 
-/* B2i is not set at j=js-nghost */
-  for (k=ks-nghost; k<=ks-1; k++) {
-    for (j=js-(nghost-1); j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B2i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-/* B3i is not set at k=ks-nghost */
-  for (k=ks-(nghost-1); k<=ks-1; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B3i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-#endif /* MHD */
-
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_ox3(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Outer x3 boundary */
+/*! \fn static void shm_sync(GridS *pG)
+ *  \brief Memory barrier across the Grids of a Domain in shared memory on
+ *   this node.  Does nothing if U is not in shared memory. */
 
-static void unpack_ox3(GridS *pG)
+static void shm_sync(GridS *pG)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ke = pG->ke;
-  int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[1][0]);
+  int ierr;
 
-  for (k=ke+1; k<=ke+nghost; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
-    }
-  }
-
-#ifdef MHD
-/* B1i is not set at i=is-nghost */
-  for (k=ke+1; k<=ke+nghost; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-(nghost-1); i<=ie+nghost; i++) {
-        pG->B1i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-/* B2i is not set at j=js-nghost */
-  for (k=ke+1; k<=ke+nghost; k++) {
-    for (j=js-(nghost-1); j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B2i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-/* B3i is not set at k=ke+1 */
-  for (k=ke+2; k<=ke+nghost; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->B3i[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-#endif /* MHD */
+  if (pG->Win_shm == MPI_WIN_NULL) return;
+  ierr = MPI_Win_sync(pG->Win_shm);
+  ierr = MPI_Barrier(pG->Comm_shm);
+  ierr = MPI_Win_sync(pG->Win_shm);
 
   return;
 }
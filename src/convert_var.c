@@ -12,6 +12,11 @@
  * - Cons_to_Prim()     - converts Cons type to Prim type
  * - Cons1D_to_Prim1D() - converts 1D vector (Bx passed through arguments)
  * - Prim1D_to_Cons1D() - converts 1D vector (Bx passed through arguments)
+ * - Cons1D_to_Prim1D_pencil() - Cons1D_to_Prim1D() over a pencil of cells
+ * - Prim1D_to_Cons1D_pencil() - Prim1D_to_Cons1D() over a pencil of cells
+ * - Cons1D_to_pencil(), Prim1D_to_pencil(), pencil_to_Cons1D(),
+ *   pencil_to_Prim1D() - copy 1D vectors of Cons1DS/Prim1DS to and from
+ *                        pencils
  * - cfast()            - computes fast magnetosonic speed
  *
  * For special relativity, there are two versions of the Cons1D_to_Prim1D
@@ -534,8 +539,172 @@ Real cfast(const Cons1DS *U, const Real *Bx)
   return sqrt(cfsq);
 #endif
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Cons1D_to_Prim1D_pencil(const int il, const int iu,
+ *                 const Cons1DArrS *pU, const Real *Bx, Prim1DArrS *pW)
+ *  \brief Cons1D_to_Prim1D() for cells il..iu of a pencil: NEWTONIAN VERSION
+ *
+ *   Same arithmetic as Cons1D_to_Prim1D(), written as one loop over the cells
+ *   so that it can be vectorized.  Bx[i] is only used with MHD.
+ */
+
+void Cons1D_to_Prim1D_pencil(const int il, const int iu, const Cons1DArrS *pU,
+                             const Real *Bx, Prim1DArrS *pW)
+{
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+    Real di = 1.0/pU->d[i];
+#if (NSCALARS > 0)
+    int n;
+#endif
+
+    pW->d[i]  = pU->d[i];
+    pW->Vx[i] = pU->Mx[i]*di;
+    pW->Vy[i] = pU->My[i]*di;
+    pW->Vz[i] = pU->Mz[i]*di;
+
+#ifndef ISOTHERMAL
+    {
+      Real P = pU->E[i] - 0.5*(SQR(pU->Mx[i])+SQR(pU->My[i])+SQR(pU->Mz[i]))*di;
+#ifdef MHD
+      P -= 0.5*(SQR(Bx[i]) + SQR(pU->By[i]) + SQR(pU->Bz[i]));
+#endif /* MHD */
+      P *= Gamma_1;
+      pW->P[i] = MAX(P,TINY_NUMBER);
+    }
+#endif /* ISOTHERMAL */
+
+#ifdef MHD
+    pW->By[i] = pU->By[i];
+    pW->Bz[i] = pU->Bz[i];
+#endif /* MHD */
+
+#if (NSCALARS > 0)
+    for (n=0; n<NSCALARS; n++) pW->r[n][i] = pU->s[n][i]*di;
+#endif
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Prim1D_to_Cons1D_pencil(const int il, const int iu,
+ *                 const Prim1DArrS *pW, const Real *Bx, Cons1DArrS *pU)
+ *  \brief Prim1D_to_Cons1D() for cells il..iu of a pencil: NEWTONIAN VERSION
+ *
+ *   Same arithmetic as Prim1D_to_Cons1D(), written as one loop over the cells
+ *   so that it can be vectorized.  Bx[i] is only used with MHD.
+ */
+
+void Prim1D_to_Cons1D_pencil(const int il, const int iu, const Prim1DArrS *pW,
+                             const Real *Bx, Cons1DArrS *pU)
+{
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+#if (NSCALARS > 0)
+    int n;
+#endif
+
+    pU->d[i]  = pW->d[i];
+    pU->Mx[i] = pW->d[i]*pW->Vx[i];
+    pU->My[i] = pW->d[i]*pW->Vy[i];
+    pU->Mz[i] = pW->d[i]*pW->Vz[i];
+
+#ifndef ISOTHERMAL
+    pU->E[i] = pW->P[i]/Gamma_1
+      + 0.5*pW->d[i]*(SQR(pW->Vx[i]) + SQR(pW->Vy[i]) + SQR(pW->Vz[i]));
+#ifdef MHD
+    pU->E[i] += 0.5*(SQR(Bx[i]) + SQR(pW->By[i]) + SQR(pW->Bz[i]));
+#endif /* MHD */
+#endif /* ISOTHERMAL */
+
+#ifdef MHD
+    pU->By[i] = pW->By[i];
+    pU->Bz[i] = pW->Bz[i];
+#endif /* MHD */
+
+#if (NSCALARS > 0)
+    for (n=0; n<NSCALARS; n++) pU->s[n][i] = pW->r[n][i]*pW->d[i];
+#endif
+  }
+}
 #endif /* not SPECIAL_RELATIVITY */
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void Cons1D_to_pencil(const int il, const int iu, const Cons1DS *U,
+ *                             Cons1DArrS *pU)
+ *  \brief Copies elements il..iu of a 1D vector of Cons1DS into a pencil.
+ *   Relies on the elements of Cons1DArrS being in the same order as Cons1DS.
+ */
+
+void Cons1D_to_pencil(const int il, const int iu, const Cons1DS *U,
+                      Cons1DArrS *pU)
+{
+  Real **pp = (Real **)pU;
+  int i,n;
+
+  for (n=0; n<(int)(sizeof(Cons1DS)/sizeof(Real)); n++) {
+    for (i=il; i<=iu; i++) pp[n][i] = ((const Real *)&(U[i]))[n];
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Prim1D_to_pencil(const int il, const int iu, const Prim1DS *W,
+ *                             Prim1DArrS *pW)
+ *  \brief Copies elements il..iu of a 1D vector of Prim1DS into a pencil.
+ *   Relies on the elements of Prim1DArrS being in the same order as Prim1DS.
+ */
+
+void Prim1D_to_pencil(const int il, const int iu, const Prim1DS *W,
+                      Prim1DArrS *pW)
+{
+  Real **pp = (Real **)pW;
+  int i,n;
+
+  for (n=0; n<(int)(sizeof(Prim1DS)/sizeof(Real)); n++) {
+    for (i=il; i<=iu; i++) pp[n][i] = ((const Real *)&(W[i]))[n];
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void pencil_to_Cons1D(const int il, const int iu,
+ *                             const Cons1DArrS *pU, Cons1DS *U)
+ *  \brief Copies cells il..iu of a pencil into a 1D vector of Cons1DS.
+ */
+
+void pencil_to_Cons1D(const int il, const int iu, const Cons1DArrS *pU,
+                      Cons1DS *U)
+{
+  Real * const *pp = (Real * const *)pU;
+  int i,n;
+
+  for (i=il; i<=iu; i++) {
+    for (n=0; n<(int)(sizeof(Cons1DS)/sizeof(Real)); n++)
+      ((Real *)&(U[i]))[n] = pp[n][i];
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void pencil_to_Prim1D(const int il, const int iu,
+ *                             const Prim1DArrS *pW, Prim1DS *W)
+ *  \brief Copies cells il..iu of a pencil into a 1D vector of Prim1DS.
+ */
+
+void pencil_to_Prim1D(const int il, const int iu, const Prim1DArrS *pW,
+                      Prim1DS *W)
+{
+  Real * const *pp = (Real * const *)pW;
+  int i,n;
+
+  for (i=il; i<=iu; i++) {
+    for (n=0; n<(int)(sizeof(Prim1DS)/sizeof(Real)); n++)
+      ((Real *)&(W[i]))[n] = pp[n][i];
+  }
+}
+
 #if defined(SPECIAL_RELATIVITY) && defined(HYDRO) /* special relativity only */
 /*----------------------------------------------------------------------------*/
 /*! \fn Prim1DS Cons1D_to_Prim1D(const Cons1DS *U, const Real *Bx)
@@ -85,7 +85,7 @@ void dump_binary(MeshS *pM, OutputS *pOut)
           for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
           for (i=il; i<=iu; i++) {
-            W[k-kl][j-jl][i-il] = Cons_to_Prim(&(pGrid->U[k][j][i]));
+            W[k-kl][j-jl][i-il] = Cons_to_Prim(UPTR(pGrid,k,j,i));
           }}}
         }
 
@@ -199,7 +199,7 @@ void dump_binary(MeshS *pM, OutputS *pOut)
             for (i=0; i<ndata[0]; i++) {
 
               if (strcmp(pOut->out,"cons") == 0){
-                pData = ((Real*)&(pGrid->U[k+kl][j+jl][i+il])) + n;
+                pData = &UCOMP(pGrid,k+kl,j+jl,i+il,n);
               } else if(strcmp(pOut->out,"prim") == 0) {
                 pData = ((Real*)&(W[k][j][i])) + n;
               }
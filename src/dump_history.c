@@ -183,67 +183,67 @@ void dump_history(MeshS *pM, OutputS *pOut)
 #endif
 
               mhst = 2;
-              scal[mhst] += dVol*pG->U[k][j][i].d;
-              d1 = 1.0/pG->U[k][j][i].d;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,d);
+              d1 = 1.0/UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].E;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,E);
 #endif
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M1;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,M1);
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M2;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,M2);
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M3;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,M3);
               mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].M1)*d1;
+              scal[mhst] += dVol*0.5*SQR(UVAR(pG,k,j,i,M1))*d1;
               mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].M2)*d1;
+              scal[mhst] += dVol*0.5*SQR(UVAR(pG,k,j,i,M2))*d1;
               mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].M3)*d1;
+              scal[mhst] += dVol*0.5*SQR(UVAR(pG,k,j,i,M3))*d1;
 #ifdef MHD
               mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].B1c);
+              scal[mhst] += dVol*0.5*SQR(UVAR(pG,k,j,i,B1c));
               mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].B2c);
+              scal[mhst] += dVol*0.5*SQR(UVAR(pG,k,j,i,B2c));
               mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].B3c);
+              scal[mhst] += dVol*0.5*SQR(UVAR(pG,k,j,i,B3c));
 #endif
 #ifdef SELF_GRAVITY
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].d*pG->Phi[k][j][i];
+              scal[mhst] += dVol*UVAR(pG,k,j,i,d)*pG->Phi[k][j][i];
 #endif
 #if (NSCALARS > 0)
               for(n=0; n<NSCALARS; n++){
                 mhst++;
-                scal[mhst] += dVol*pG->U[k][j][i].s[n];
+                scal[mhst] += dVol*UVAR(pG,k,j,i,s[n]);
               }
 #endif
 
 #ifdef CYLINDRICAL
               mhst++;
-              scal[mhst] += dVol*(x1*pG->U[k][j][i].M2);
+              scal[mhst] += dVol*(x1*UVAR(pG,k,j,i,M2));
 #endif
 
 #else /* SPECIAL_RELATIVITY */
 
-              W = Cons_to_Prim (&(pG->U[k][j][i]));
+              W = Cons_to_Prim (UPTR(pG,k,j,i));
         
               /* calculate gamma */
-              g   = pG->U[k][j][i].d/W.d;
+              g   = UVAR(pG,k,j,i,d)/W.d;
               g2  = SQR(g);
               g_2 = 1.0/g2;
 
               mhst = 2;
-              scal[mhst] += dVol*pG->U[k][j][i].d;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,d);
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].E;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,E);
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M1;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,M1);
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M2;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,M2);
               mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M3;
+              scal[mhst] += dVol*UVAR(pG,k,j,i,M3);
 
               mhst++;
               scal[mhst] += dVol*SQR(g);
@@ -259,10 +259,10 @@ void dump_history(MeshS *pM, OutputS *pOut)
 
 #ifdef MHD
 
-              vB = W.V1*pG->U[k][j][i].B1c + W.V2*W.B2c + W.V3*W.B3c;
-              Bmag2 = SQR(pG->U[k][j][i].B1c) + SQR(W.B2c) + SQR(W.B3c);
+              vB = W.V1*UVAR(pG,k,j,i,B1c) + W.V2*W.B2c + W.V3*W.B3c;
+              Bmag2 = SQR(UVAR(pG,k,j,i,B1c)) + SQR(W.B2c) + SQR(W.B3c);
         
-              bx = g*(pG->U[k][j][i].B1c*g_2 + vB*W.V1);
+              bx = g*(UVAR(pG,k,j,i,B1c)*g_2 + vB*W.V1);
               by = g*(W.B2c*g_2 + vB*W.V2);
               bz = g*(W.B3c*g_2 + vB*W.V3);
         
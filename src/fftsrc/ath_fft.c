@@ -9,7 +9,15 @@
  *   write your own wrappers or to use the FFTW and/or block decomposition
  *   libraries directly.
  *
+ * Plans are cached in-process, keyed by size and decomposition, so a forward
+ *   and backward pair (or the same transform on several Domains) is only
+ *   planned once.  FFTW wisdom is read from and saved to <fft>/wisdom_file,
+ *   by default in the run directory, so measured plans (<fft>/planner) are
+ *   cheap on restarts and repeated runs.
+ *
  * CONTAINS PUBLIC FUNCTIONS:
+ * - ath_fft_init()            - set FFTW planner flags, read FFTW wisdom
+ * - ath_fft_save_wisdom()     - write FFTW wisdom of all processes to file
  * - ath_3d_fft_quick_plan()   - create a plan for global 3D grid
  * - ath_3d_fft_create_plan()  - create a more flexible plan for 3D FFT
  * - ath_3d_fft_malloc()       - allocate memory for 3D FFT data
@@ -21,10 +29,18 @@
  * - ath_2d_fft_malloc()       - allocate memory for 2D FFT data
  * - ath_2d_fft()              - perform a 2D FFT
  * - ath_2d_fft_free()         - free memory for 2D FFT data
- * - ath_2d_fft_destroy_plan() - free up memory				      */
+ * - ath_2d_fft_destroy_plan() - free up memory
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - plan_cache_get()          - look up a plan, adding a reference
+ * - plan_cache_add()          - store a newly made plan
+ * - plan_cache_release()      - drop a reference to a plan		      */
 /*============================================================================*/
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "../defs.h"
 #include "../athena.h"
 #include "../prototypes.h"
@@ -41,6 +57,203 @@
 #include "fftw3.h"
 #endif /* FFT_BLOCK_DECOMP */
 
+#ifndef FFT_BLOCK_DECOMP
+/* FFTW planner flags for serial plans (block decomp uses fft_plan_flags) */
+static unsigned ath_fft_flags = FFTW_MEASURE;
+#endif
+/* Absolute path of the FFTW wisdom file, NULL if wisdom is not used */
+static char *wisdom_file = NULL;
+/* Number of plans actually made (rather than found in the cache) */
+static int nplan_made = 0;
+
+/* In-process plan cache.  key[] holds the dimension, type, direction (only
+ * serial FFTW plans fix the direction), global size and local bounds. */
+#define NKEY 12
+typedef struct ath_fft_cache_s {
+  int key[NKEY];
+#ifdef FFT_BLOCK_DECOMP
+  MPI_Comm comm;
+#endif
+  void *plan;
+  int nref;
+  struct ath_fft_cache_s *next;
+} AthFFTCache;
+
+static AthFFTCache *plan_cache = NULL;
+
+static void *plan_cache_get(DomainS *pD, const int *key);
+static void plan_cache_add(DomainS *pD, const int *key, void *plan);
+static int plan_cache_release(void *plan);
+
+/**************************************************************************
+ *
+ *  Athena FFT setup
+ *
+ **************************************************************************/
+
+/*! \fn void ath_fft_init(const char *rundir)
+ *  \brief Sets FFTW planner flags from <fft>/planner and the number of
+ *  pipelined chunks per 3D transpose from <fft>/remap_chunks (MPI only), and
+ *  imports FFTW wisdom from <fft>/wisdom_file (default athena.fftw_wisdom in
+ *  rundir).  Must be
+ *  called by all processes before any plan is created.
+ */
+
+void ath_fft_init(const char *rundir)
+{
+  char *planner, *name, *def, cwd[MAXLEN];
+  unsigned flags = 0;
+  FILE *fp;
+  int ok = 0;
+#ifdef FFT_BLOCK_DECOMP
+  char *str = NULL;
+  int len = 0;
+#endif
+
+#ifdef FFT_BLOCK_DECOMP
+  planner = par_gets_def("fft","planner","estimate");
+#else
+  planner = par_gets_def("fft","planner","measure");
+#endif
+  if (strcmp(planner,"estimate") == 0) flags = FFTW_ESTIMATE;
+  else if (strcmp(planner,"measure") == 0) flags = FFTW_MEASURE;
+  else if (strcmp(planner,"patient") == 0) flags = FFTW_PATIENT;
+  else if (strcmp(planner,"exhaustive") == 0) flags = FFTW_EXHAUSTIVE;
+  else ath_error("[ath_fft_init]: unknown FFTW planner \"%s\"\n",planner);
+  free(planner);
+#ifdef FFT_BLOCK_DECOMP
+  fft_plan_flags = flags;
+#else
+  ath_fft_flags = flags;
+#endif
+
+#ifdef FFT_BLOCK_DECOMP
+/* Split each transpose of the 3D FFTs into this many chunks, pipelined with
+ * the 1D FFTs (1 = unpipelined) */
+  fft_remap_chunks = par_geti_def("fft","remap_chunks",1);
+  if (fft_remap_chunks < 1)
+    ath_error("[ath_fft_init]: <fft>/remap_chunks must be >= 1\n");
+#endif
+
+  if (par_geti_def("fft","wisdom",1) == 0) return;
+
+/* Relative names are taken from the directory athena was started in, which
+ * is still the working directory here (see change_rundir() in main.c) */
+  def = (char *)malloc(strlen(rundir == NULL ? "" : rundir) + 32);
+  if (def == NULL) ath_error("[ath_fft_init]: malloc returned a NULL pointer\n");
+  if (rundir != NULL && *rundir != '\0')
+    sprintf(def,"%s/athena.fftw_wisdom",rundir);
+  else
+    sprintf(def,"athena.fftw_wisdom");
+  name = par_gets_def("fft","wisdom_file",def);
+  free(def);
+
+  if (name[0] == '/' || getcwd(cwd,MAXLEN) == NULL) {
+    wisdom_file = name;
+  } else {
+    wisdom_file = (char *)malloc(strlen(cwd) + strlen(name) + 2);
+    if (wisdom_file == NULL)
+      ath_error("[ath_fft_init]: malloc returned a NULL pointer\n");
+    sprintf(wisdom_file,"%s/%s",cwd,name);
+    free(name);
+  }
+
+/* Only rank 0 reads the file, then shares the wisdom with the others */
+  if (myID_Comm_world == 0) {
+    if ((fp = fopen(wisdom_file,"r")) != NULL) {
+      ok = fftw_import_wisdom_from_file(fp);
+      fclose(fp);
+      if (ok)
+        ath_pout(0,"Imported FFTW wisdom from %s\n",wisdom_file);
+      else
+        ath_perr(-1,"[ath_fft_init]: could not read FFTW wisdom from %s\n",
+                 wisdom_file);
+    }
+  }
+#ifdef FFT_BLOCK_DECOMP
+  MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (!ok) return;
+  if (myID_Comm_world == 0) {
+    str = fftw_export_wisdom_to_string();
+    len = (str == NULL ? 0 : (int)strlen(str) + 1);
+  }
+  MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (len == 0) return;
+  if (myID_Comm_world != 0) {
+    str = (char *)malloc(len);
+    if (str == NULL) ath_error("[ath_fft_init]: malloc returned a NULL pointer\n");
+  }
+  MPI_Bcast(str, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+  if (myID_Comm_world != 0) fftw_import_wisdom_from_string(str);
+  free(str);
+#endif /* FFT_BLOCK_DECOMP */
+
+  return;
+}
+
+/*! \fn void ath_fft_save_wisdom(void)
+ *  \brief Writes the FFTW wisdom gathered by all processes to the wisdom
+ *  file, if any plans were made since ath_fft_init().  Must be called by all
+ *  processes; rank 0 writes the file.
+ */
+
+void ath_fft_save_wisdom(void)
+{
+  FILE *fp;
+  int nmade;
+#ifdef FFT_BLOCK_DECOMP
+  char *str, *buf = NULL;
+  int n, nproc, len, *lens = NULL, *disp = NULL;
+#endif
+
+  if (wisdom_file == NULL) return;
+
+#ifdef FFT_BLOCK_DECOMP
+  MPI_Allreduce(&nplan_made, &nmade, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  if (nmade == 0) return;
+
+/* Merge the wisdom of every process into that of rank 0 */
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+  str = fftw_export_wisdom_to_string();
+  len = (str == NULL ? 0 : (int)strlen(str) + 1);
+  if (myID_Comm_world == 0) {
+    lens = (int *)malloc(2*nproc*sizeof(int));
+    if (lens == NULL) ath_error("[ath_fft_save_wisdom]: malloc returned a NULL pointer\n");
+    disp = lens + nproc;
+  }
+  MPI_Gather(&len, 1, MPI_INT, lens, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (myID_Comm_world == 0) {
+    disp[0] = 0;
+    for (n=1; n<nproc; n++) disp[n] = disp[n-1] + lens[n-1];
+    buf = (char *)malloc(disp[nproc-1] + lens[nproc-1] + 1);
+    if (buf == NULL) ath_error("[ath_fft_save_wisdom]: malloc returned a NULL pointer\n");
+  }
+  MPI_Gatherv(str, len, MPI_CHAR, buf, lens, disp, MPI_CHAR, 0, MPI_COMM_WORLD);
+  if (myID_Comm_world == 0) {
+    for (n=1; n<nproc; n++)
+      if (lens[n] > 0) fftw_import_wisdom_from_string(buf + disp[n]);
+    free(buf);
+    free(lens);
+  }
+  free(str);
+#else /* FFT_BLOCK_DECOMP */
+  nmade = nplan_made;
+  if (nmade == 0) return;
+#endif /* FFT_BLOCK_DECOMP */
+
+  if (myID_Comm_world == 0) {
+    if ((fp = fopen(wisdom_file,"w")) == NULL) {
+      ath_perr(-1,"[ath_fft_save_wisdom]: could not open %s\n",wisdom_file);
+    } else {
+      fftw_export_wisdom_to_file(fp);
+      fclose(fp);
+    }
+  }
+  nplan_made = 0;
+
+  return;
+}
+
 /**************************************************************************
  *
  *  Athena 3D FFT functions
@@ -49,7 +262,7 @@
 
 /*! \fn struct ath_3d_fft_plan *ath_3d_fft_quick_plan(DomainS *pD,
  *	ath_fft_data *data, ath_fft_direction dir)
- *  \brief Sets up an FFT plan for the entire 3D grid, using
+ *  \brief Sets up a real-to-complex FFT plan for the entire 3D grid, using
  *      ath_3d_fft_create_plan()
  */
 
@@ -74,13 +287,13 @@ struct ath_3d_fft_plan *ath_3d_fft_quick_plan(DomainS *pD,
   /* Create the plan using a more generic function.
    * If the data hasn't already been allocated, it will now */
   return ath_3d_fft_create_plan(pD, gnx3, gnx2, gnx1, gks, gke, gjs, gje,
-				   gis, gie, data, 0, dir);
+				   gis, gie, data, 0, dir, ATH_FFT_R2C);
 }
 
 /*! \fn struct ath_3d_fft_plan *ath_3d_fft_create_plan(int gnx3, int gnx2,
  *				int gnx1, int gks, int gke, int gjs, int gje,
  *				int gis, int gie, ath_fft_data *data, int al,
- *				ath_fft_direction dir)
+ *				ath_fft_direction dir, ath_fft_type type)
  *  \brief Sets up a 3D FFT plan
  *
  *  - gnx3, gnx2, gnx1 are the dimensions of the GLOBAL data
@@ -90,15 +303,26 @@ struct ath_3d_fft_plan *ath_3d_fft_quick_plan(DomainS *pD,
  *      transform, for use in planning (contents will be trashed)
  *  - al != 0 means allocate data if it doesn't exist (otherwise temporary)
  *  - dir is either ATH_FFT_FOWARD or ATH_FFT_BACKWARD
+ *  - type is ATH_FFT_R2C (real data, half spectrum), ATH_FFT_C2C or
+ *      ATH_FFT_DST (real data, sine transform)
  *  FFTs will be done in place (overwrite data)
+ *
+ *  For R2C plans the half spectrum k3=0..gnx3/2 is shared out over processes
+ *  in proportion to the part of x3 each owns within the first
+ *  MIN(gnx3,pD->Nx[2]) zones, so zero padding beyond the Domain (as used by
+ *  selfg_fft_disk) does not unbalance the spectral data.
  */
 
 struct ath_3d_fft_plan *ath_3d_fft_create_plan(DomainS *pD, int gnx3, int gnx2,
 				int gnx1, int gks, int gke, int gjs, int gje,
 				int gis, int gie, ath_fft_data *data, int al,
-				ath_fft_direction dir)
+				ath_fft_direction dir, ath_fft_type type)
 {
-  int nbuf, tmp;
+  int nbuf, tmp, nx3, nhalf, key[NKEY];
+#ifdef FFT_BLOCK_DECOMP
+  int nmax, cke;
+#endif
+  long int rcnt;
   struct ath_3d_fft_plan *ath_plan;
 
   if ((dir != ATH_FFT_FORWARD) && (dir != ATH_FFT_BACKWARD)) {
@@ -112,10 +336,56 @@ struct ath_3d_fft_plan *ath_3d_fft_create_plan(DomainS *pD, int gnx3, int gnx2,
   }
   /* Set forward/backward FFT */
   ath_plan->dir = dir;
-  /* Set element count (for easy malloc and memset) */
-  ath_plan->cnt = (gke-gks+1)*(gje-gjs+1)*(gie-gis+1);
+  ath_plan->type = type;
+
+  /* Set the local layout of real and spectral data */
+  nx3 = gke-gks+1;
+  if (type == ATH_FFT_R2C) {
+    nhalf = gnx3/2 + 1;
+#ifdef FFT_BLOCK_DECOMP
+    nmax = (gnx3 < pD->Nx[2] ? gnx3 : pD->Nx[2]);
+    ath_plan->cks = ((gks < nmax ? gks : nmax)*nhalf)/nmax;
+    if (gke == gnx3-1)
+      cke = nhalf - 1;
+    else
+      cke = ((gke+1 < nmax ? gke+1 : nmax)*nhalf)/nmax - 1;
+    ath_plan->cnx3 = cke - ath_plan->cks + 1;
+    ath_plan->rnx3 = nx3;
+#else /* FFT_BLOCK_DECOMP */
+    /* FFTW in-place r2c pads the fast index to room for nhalf complex */
+    ath_plan->cks = 0;
+    ath_plan->cnx3 = nhalf;
+    ath_plan->rnx3 = 2*nhalf;
+#endif /* FFT_BLOCK_DECOMP */
+  } else {
+    ath_plan->cks = gks;
+    ath_plan->cnx3 = nx3;
+    ath_plan->rnx3 = nx3;
+  }
+
+  /* Set element count (for easy malloc and memset), enough for both the
+   * real and the spectral data */
+  ath_plan->cnt = (long int)(ath_plan->cnx3)*(gje-gjs+1)*(gie-gis+1);
+  if (type == ATH_FFT_DST) ath_plan->cnt = (ath_plan->cnt+1)/2;
+  if (type == ATH_FFT_R2C) {
+    rcnt = (long int)(ath_plan->rnx3)*(gje-gjs+1)*(gie-gis+1);
+    if ((rcnt+1)/2 > ath_plan->cnt) ath_plan->cnt = (rcnt+1)/2;
+  }
   ath_plan->gcnt = gnx3*gnx2*gnx1;
 
+  /* Reuse an identical plan if one has been made */
+  key[0] = 3;  key[1] = (int)type;
+#ifdef FFT_BLOCK_DECOMP
+  key[2] = 0;
+#else
+  key[2] = (type == ATH_FFT_DST ? 0 : (int)dir);
+#endif
+  key[3] = gnx3;  key[4] = gnx2;  key[5] = gnx1;
+  key[6] = gks;  key[7] = gke;  key[8] = gjs;  key[9] = gje;
+  key[10] = gis;  key[11] = gie;
+  ath_plan->plan = plan_cache_get(pD, key);
+  if (ath_plan->plan != NULL) return ath_plan;
+
   tmp = (al==0 ? 1 : 0);
   if (data != NULL) tmp = 0;
 
@@ -128,19 +398,46 @@ struct ath_3d_fft_plan *ath_3d_fft_create_plan(DomainS *pD, int gnx3, int gnx2,
   /* Create the plan */
 #ifdef FFT_BLOCK_DECOMP
   /* Block decomp library plans don't care if forward or backward */
-  ath_plan->plan = fft_3d_create_plan(pD->Comm_Domain, gnx3, gnx2, gnx1, 
+  if (type == ATH_FFT_R2C) {
+    ath_plan->plan = fft_3d_create_plan_r2c(pD->Comm_Domain, gnx3, gnx2, gnx1,
+					gks, gke, gjs, gje, gis, gie,
+					ath_plan->cks, cke, gjs, gje, gis, gie,
+					0, &nbuf);
+  } else if (type == ATH_FFT_DST) {
+    ath_plan->plan = fft_3d_create_plan_r2r(pD->Comm_Domain, gnx3, gnx2, gnx1,
+					gks, gke, gjs, gje, gis, gie,
+					gks, gke, gjs, gje, gis, gie,
+					FFTW_RODFT00, &nbuf);
+  } else {
+    ath_plan->plan = fft_3d_create_plan(pD->Comm_Domain, gnx3, gnx2, gnx1, 
 					gks, gke, gjs, gje, gis, gie, 
 			    		gks, gke, gjs, gje, gis, gie, 
                             		0, 0, &nbuf);
+  }
+  if (ath_plan->plan == NULL)
+    ath_error("Couldn't create block decomposition FFT plan.\n");
 #else /* FFT_BLOCK_DECOMP */
-  if (dir == ATH_FFT_FORWARD) {
+  if (type == ATH_FFT_R2C) {
+    if (dir == ATH_FFT_FORWARD) {
+      ath_plan->plan = fftw_plan_dft_r2c_3d(gnx1, gnx2, gnx3,
+			(ath_fft_real *)data, data, ath_fft_flags);
+    } else {
+      ath_plan->plan = fftw_plan_dft_c2r_3d(gnx1, gnx2, gnx3,
+			data, (ath_fft_real *)data, ath_fft_flags);
+    }
+  } else if (type == ATH_FFT_DST) {
+    ath_plan->plan = fftw_plan_r2r_3d(gnx1, gnx2, gnx3,
+			(ath_fft_real *)data, (ath_fft_real *)data,
+			FFTW_RODFT00, FFTW_RODFT00, FFTW_RODFT00, ath_fft_flags);
+  } else if (dir == ATH_FFT_FORWARD) {
     ath_plan->plan = fftw_plan_dft_3d(gnx1, gnx2, gnx3, data, data,
-					FFTW_FORWARD, FFTW_MEASURE);
+					FFTW_FORWARD, ath_fft_flags);
   } else {
     ath_plan->plan = fftw_plan_dft_3d(gnx1, gnx2, gnx3, data, data,
-					FFTW_BACKWARD, FFTW_MEASURE);
+					FFTW_BACKWARD, ath_fft_flags);
   }
 #endif /* FFT_BLOCK_DECOMP */
+  plan_cache_add(pD, key, (void *)ath_plan->plan);
 
   if (tmp) ath_3d_fft_free(data);
 
@@ -157,16 +454,31 @@ ath_fft_data *ath_3d_fft_malloc(struct ath_3d_fft_plan *ath_plan)
 }
 
 /*! \fn void ath_3d_fft(struct ath_3d_fft_plan *ath_plan, ath_fft_data *data)
- *  \brief Performs a 3D FFT in place
+ *  \brief Performs a 3D FFT in place.  For R2C plans the forward transform
+ *  reads real data and the backward transform writes it (see F3DI and rnx3).
+ *  DST plans transform real data in both directions.
  */
 
 void ath_3d_fft(struct ath_3d_fft_plan *ath_plan, ath_fft_data *data)
 {
 #ifdef FFT_BLOCK_DECOMP
-  fft_3d(data, data, ath_plan->dir, ath_plan->plan);
+  if (ath_plan->type == ATH_FFT_R2C)
+    fft_3d_r2c((ath_fft_real *)data, data, ath_plan->dir, ath_plan->plan);
+  else if (ath_plan->type == ATH_FFT_DST)
+    fft_3d_r2r((ath_fft_real *)data, (ath_fft_real *)data, ath_plan->plan);
+  else
+    fft_3d(data, data, ath_plan->dir, ath_plan->plan);
 #else /* FFT_BLOCK_DECOMP */
   /* Plan already includes forward/backward */
-  fftw_execute_dft(ath_plan->plan, data, data);
+  if (ath_plan->type == ATH_FFT_C2C)
+    fftw_execute_dft(ath_plan->plan, data, data);
+  else if (ath_plan->type == ATH_FFT_DST)
+    fftw_execute_r2r(ath_plan->plan, (ath_fft_real *)data,
+                     (ath_fft_real *)data);
+  else if (ath_plan->dir == ATH_FFT_FORWARD)
+    fftw_execute_dft_r2c(ath_plan->plan, (ath_fft_real *)data, data);
+  else
+    fftw_execute_dft_c2r(ath_plan->plan, data, (ath_fft_real *)data);
 #endif /* FFT_BLOCK_DECOMP */
 
   return;
@@ -190,11 +502,14 @@ void ath_3d_fft_free(ath_fft_data *data)
 void ath_3d_fft_destroy_plan(struct ath_3d_fft_plan *ath_plan)
 {
   if (ath_plan != NULL) {
+    /* The underlying plan may still be in use by other Athena plans */
+    if (plan_cache_release((void *)ath_plan->plan)) {
 #ifdef FFT_BLOCK_DECOMP
-    fft_3d_destroy_plan(ath_plan->plan);
+      fft_3d_destroy_plan(ath_plan->plan);
 #else /* FFT_BLOCK_DECOMP */
-    fftw_destroy_plan(ath_plan->plan);
+      fftw_destroy_plan(ath_plan->plan);
 #endif /* FFT_BLOCK_DECOMP */
+    }
     free(ath_plan);
   }
 
@@ -255,7 +570,7 @@ struct ath_2d_fft_plan *ath_2d_fft_create_plan(DomainS *pD, int gnx2, int gnx1,
 				ath_fft_data *data, int al,
 				ath_fft_direction dir)
 {
-  int nbuf, tmp;
+  int nbuf, tmp, key[NKEY];
   struct ath_2d_fft_plan *ath_plan;
 
   if ((dir != ATH_FFT_FORWARD) && (dir != ATH_FFT_BACKWARD)) {
@@ -273,6 +588,19 @@ struct ath_2d_fft_plan *ath_2d_fft_create_plan(DomainS *pD, int gnx2, int gnx1,
   ath_plan->cnt = (gje-gjs+1)*(gie-gis+1);
   ath_plan->gcnt = gnx2*gnx1;
 
+  /* Reuse an identical plan if one has been made */
+  key[0] = 2;  key[1] = (int)ATH_FFT_C2C;
+#ifdef FFT_BLOCK_DECOMP
+  key[2] = 0;
+#else
+  key[2] = (int)dir;
+#endif
+  key[3] = gnx2;  key[4] = gnx1;  key[5] = 0;
+  key[6] = gjs;  key[7] = gje;  key[8] = gis;  key[9] = gie;
+  key[10] = 0;  key[11] = 0;
+  ath_plan->plan = plan_cache_get(pD, key);
+  if (ath_plan->plan != NULL) return ath_plan;
+
   tmp = (al==0 ? 1 : 0);
   if (data != NULL) tmp = 0;
 
@@ -291,12 +619,13 @@ struct ath_2d_fft_plan *ath_2d_fft_create_plan(DomainS *pD, int gnx2, int gnx1,
 #else /* FFT_BLOCK_DECOMP */
   if (dir == ATH_FFT_FORWARD) {
     ath_plan->plan = fftw_plan_dft_2d(gnx1, gnx2, data, data, FFTW_FORWARD,
-					FFTW_MEASURE);
+					ath_fft_flags);
   } else {
     ath_plan->plan = fftw_plan_dft_2d(gnx1, gnx2, data, data, FFTW_BACKWARD,
-					FFTW_MEASURE);
+					ath_fft_flags);
   }
 #endif /* FFT_BLOCK_DECOMP */
+  plan_cache_add(pD, key, (void *)ath_plan->plan);
 
   if (tmp) ath_2d_fft_free(data);
 
@@ -347,15 +676,93 @@ void ath_2d_fft_free(ath_fft_data *data)
 void ath_2d_fft_destroy_plan(struct ath_2d_fft_plan *ath_plan)
 {
   if (ath_plan != NULL) {
+    /* The underlying plan may still be in use by other Athena plans */
+    if (plan_cache_release((void *)ath_plan->plan)) {
 #ifdef FFT_BLOCK_DECOMP
-    fft_2d_destroy_plan(ath_plan->plan);
+      fft_2d_destroy_plan(ath_plan->plan);
 #else /* FFT_BLOCK_DECOMP */
-    fftw_destroy_plan(ath_plan->plan);
+      fftw_destroy_plan(ath_plan->plan);
 #endif /* FFT_BLOCK_DECOMP */
+    }
     free(ath_plan);
   }
 
   return;
 }
 
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void *plan_cache_get(DomainS *pD, const int *key)
+ *  \brief Returns the cached plan matching key (and the Domain communicator
+ *  with MPI) with one more reference, or NULL if there is none.  Under MPI
+ *  every process of the Domain makes the same calls, so all either find the
+ *  plan or go on to make it collectively.
+ */
+
+static void *plan_cache_get(DomainS *pD, const int *key)
+{
+  AthFFTCache *pc;
+  int n;
+
+  for (pc = plan_cache; pc != NULL; pc = pc->next) {
+#ifdef FFT_BLOCK_DECOMP
+    if (pc->comm != pD->Comm_Domain) continue;
+#endif
+    for (n=0; n<NKEY; n++) if (pc->key[n] != key[n]) break;
+    if (n == NKEY) {
+      pc->nref++;
+      return pc->plan;
+    }
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void plan_cache_add(DomainS *pD, const int *key, void *plan)
+ *  \brief Adds a newly made plan to the cache with one reference
+ */
+
+static void plan_cache_add(DomainS *pD, const int *key, void *plan)
+{
+  AthFFTCache *pc;
+  int n;
+
+  if ((pc = (AthFFTCache *)malloc(sizeof(AthFFTCache))) == NULL)
+    ath_error("[plan_cache_add]: malloc returned a NULL pointer\n");
+  for (n=0; n<NKEY; n++) pc->key[n] = key[n];
+#ifdef FFT_BLOCK_DECOMP
+  pc->comm = pD->Comm_Domain;
+#endif
+  pc->plan = plan;
+  pc->nref = 1;
+  pc->next = plan_cache;
+  plan_cache = pc;
+  nplan_made++;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int plan_cache_release(void *plan)
+ *  \brief Drops a reference to plan, returns 1 if the caller should destroy
+ *  it (last reference, or a plan the cache does not know about)
+ */
+
+static int plan_cache_release(void *plan)
+{
+  AthFFTCache *pc, **ppc;
+
+  for (ppc = &plan_cache; (pc = *ppc) != NULL; ppc = &(pc->next)) {
+    if (pc->plan == plan) {
+      if (--(pc->nref) > 0) return 0;
+      *ppc = pc->next;
+      free(pc);
+      return 1;
+    }
+  }
+
+  return 1;
+}
+
 #endif /* FFT_ENABLED */
@@ -157,6 +157,8 @@ struct fft_plan_2d *fft_2d_create_plan(
   int second_ilo,second_ihi,second_jlo,second_jhi;
   int out_size,first_size,second_size,copy_size,scratch_size;
   int list[50];
+  int plan_size;
+  FFT_DATA *work;
 
 /* query MPI info */
 
@@ -304,44 +306,51 @@ struct fft_plan_2d *fft_2d_create_plan(
   *nbuf = copy_size + scratch_size;
 
   if (copy_size) {
-    plan->copy = (FFT_DATA *) malloc(copy_size*sizeof(FFT_DATA));
+    plan->copy = (FFT_DATA *) fftw_malloc(copy_size*sizeof(FFT_DATA));
     if (plan->copy == NULL) return NULL;
   }
   else plan->copy = NULL;
 
   if (scratch_size) {
-    plan->scratch = (FFT_DATA *) malloc(scratch_size*sizeof(FFT_DATA));
+    plan->scratch = (FFT_DATA *) fftw_malloc(scratch_size*sizeof(FFT_DATA));
     if (plan->scratch == NULL) return NULL;
   }
   else plan->scratch = NULL;
 
 /* system specific pre-computation of 1d FFT coeffs 
-   and scaling normalization */
+   and scaling normalization
+   planned on work, see fft_plan_flags in fft_3d.c */
+
+  plan_size = MAX(plan->total1,plan->total2);
+  work = (FFT_DATA *) fftw_malloc(plan_size*sizeof(FFT_DATA));
+  if (work == NULL) return NULL;
 
   plan->plan_fast_forward =
     fftw_plan_many_dft(1,&(plan->length1),plan->total1/plan->length1,
-                       plan->scratch,NULL,1,plan->length1,plan->scratch,
-                       NULL,1,plan->length1,FFTW_FORWARD,FFTW_ESTIMATE);
+                       work,NULL,1,plan->length1,work,
+                       NULL,1,plan->length1,FFTW_FORWARD,fft_plan_flags);
   plan->plan_fast_backward =
     fftw_plan_many_dft(1,&(plan->length1),plan->total1/plan->length1,
-                       plan->scratch,NULL,1,plan->length1,plan->scratch,
-                       NULL,1,plan->length1,FFTW_BACKWARD,FFTW_ESTIMATE);
+                       work,NULL,1,plan->length1,work,
+                       NULL,1,plan->length1,FFTW_BACKWARD,fft_plan_flags);
 
-  if (plan->length2 == plan->length1) {
+  if (plan->length2 == plan->length1 && plan->total2 == plan->total1) {
     plan->plan_slow_forward = plan->plan_fast_forward;
     plan->plan_slow_backward = plan->plan_fast_backward;
   }
   else {
     plan->plan_slow_forward =
       fftw_plan_many_dft(1,&(plan->length2),plan->total2/plan->length2,
-                         plan->scratch,NULL,1,plan->length2,plan->scratch,
-                         NULL,1,plan->length2,FFTW_FORWARD,FFTW_ESTIMATE);
+                         work,NULL,1,plan->length2,work,
+                         NULL,1,plan->length2,FFTW_FORWARD,fft_plan_flags);
     plan->plan_slow_backward =
       fftw_plan_many_dft(1,&(plan->length2),plan->total2/plan->length2,
-                         plan->scratch,NULL,1,plan->length2,plan->scratch,
-                         NULL,1,plan->length2,FFTW_BACKWARD,FFTW_ESTIMATE);
+                         work,NULL,1,plan->length2,work,
+                         NULL,1,plan->length2,FFTW_BACKWARD,fft_plan_flags);
   }
 
+  fftw_free(work);
+
   if (scaled == 0)
     plan->scaled = 0;
   else {
@@ -363,8 +372,8 @@ void fft_2d_destroy_plan(struct fft_plan_2d *plan)
   if (plan->mid_plan) remap_2d_destroy_plan(plan->mid_plan);
   if (plan->post_plan) remap_2d_destroy_plan(plan->post_plan);
 
-  if (plan->copy) free(plan->copy);
-  if (plan->scratch) free(plan->scratch);
+  if (plan->copy) fftw_free(plan->copy);
+  if (plan->scratch) fftw_free(plan->scratch);
 
   if (plan->plan_slow_forward != plan->plan_fast_forward) {
     fftw_destroy_plan(plan->plan_slow_forward);
@@ -64,4 +64,7 @@ struct fft_plan_2d *fft_2d_create_plan(MPI_Comm, int, int,
 void fft_2d_destroy_plan(struct fft_plan_2d *);
 void factor(int, int *, int *);
 
+/* FFTW planner flags for the 1d FFTs (defined in fft_3d.c) */
+extern unsigned fft_plan_flags;
+
 #endif
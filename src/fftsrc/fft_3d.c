@@ -26,6 +26,29 @@
 #define MIN(A,B) ((A) < (B)) ? (A) : (B)
 #define MAX(A,B) ((A) > (B)) ? (A) : (B)
 
+/* FFTW planner flags for the 1d FFTs, shared with fft_2d.c.  Anything but
+   FFTW_ESTIMATE times trial transforms, so plans are made on a buffer of
+   their own and all arrays they run on come from fftw_malloc() to keep
+   the alignment the plan was made for */
+
+unsigned fft_plan_flags = FFTW_ESTIMATE;
+
+/* # of chunks for the remaps that follow each set of 1d FFTs, see fft_3d.h
+   with more than 1, those remaps are created by
+   remap_3d_create_plan_chunked() and the FFTs before them are also planned
+   one slow plane at a time, FFTW_UNALIGNED since planes are at arbitrary
+   offsets */
+
+int fft_remap_chunks = 1;
+
+static struct remap_plan_3d *fft_remap_create(MPI_Comm,
+  int, int, int, int, int, int, int, int, int, int, int, int,
+  int, int, int);
+static fftw_plan fft_plane_plan(int, int, FFT_DATA *, int);
+static void fft_execute(int, fftw_plan, double *, double *);
+static void fft_stage(int, fftw_plan, fftw_plan, double *, int,
+  double *, int, double *, double *, struct remap_plan_3d *);
+
 /* ------------------------------------------------------------------- */
 /* Data layout for 3d FFTs:
 
@@ -64,6 +87,24 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   int i,offset,num;
   double norm;
   FFT_DATA *data,*copy;
+  fftw_plan pfast,pmid,pslow,plfast,plmid,plslow;
+
+  if (flag == -1) {
+    pfast = plan->plan_fast_forward;
+    pmid = plan->plan_mid_forward;
+    pslow = plan->plan_slow_forward;
+    plfast = plan->plane_fast_forward;
+    plmid = plan->plane_mid_forward;
+    plslow = plan->plane_slow_forward;
+  }
+  else {
+    pfast = plan->plan_fast_backward;
+    pmid = plan->plan_mid_backward;
+    pslow = plan->plan_slow_backward;
+    plfast = plan->plane_fast_backward;
+    plmid = plan->plane_mid_backward;
+    plslow = plan->plane_slow_backward;
+  }
 
 /* pre-remap to prepare for 1st FFTs if needed
    copy = loc for remap result */
@@ -80,55 +121,36 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   else
     data = in;
 
-/* 1d FFTs along fast axis */
-
-  if (flag == -1)
-    fftw_execute_dft(plan->plan_fast_forward,data,data);
-  else
-    fftw_execute_dft(plan->plan_fast_backward,data,data);
-
-/* 1st mid-remap to prepare for 2nd FFTs
+/* 1d FFTs along fast axis, then 1st mid-remap to prepare for 2nd FFTs
    copy = loc for remap result */
 
   if (plan->mid1_target == 0)
     copy = out;
   else
     copy = plan->copy;
-  remap_3d((double *) data, (double *) copy, (double *) plan->scratch,
-	   plan->mid1_plan);
+  fft_stage(0,pfast,plfast,(double *) data,2*plan->length1*plan->lines1,
+	    (double *) data,2*plan->length1*plan->lines1,(double *) copy,
+	    (double *) plan->scratch,plan->mid1_plan);
   data = copy;
 
-/* 1d FFTs along mid axis */
-
-  if (flag == -1)
-    fftw_execute_dft(plan->plan_mid_forward,data,data);
-  else
-    fftw_execute_dft(plan->plan_mid_backward,data,data);
-
-/* 2nd mid-remap to prepare for 3rd FFTs
+/* 1d FFTs along mid axis, then 2nd mid-remap to prepare for 3rd FFTs
    copy = loc for remap result */
 
   if (plan->mid2_target == 0)
     copy = out;
   else
     copy = plan->copy;
-  remap_3d((double *) data, (double *) copy, (double *) plan->scratch,
-	   plan->mid2_plan);
+  fft_stage(0,pmid,plmid,(double *) data,2*plan->length2*plan->lines2,
+	    (double *) data,2*plan->length2*plan->lines2,(double *) copy,
+	    (double *) plan->scratch,plan->mid2_plan);
   data = copy;
 
-/* 1d FFTs along slow axis */
-
-  if (flag == -1)
-    fftw_execute_dft(plan->plan_slow_forward,data,data);
-  else
-    fftw_execute_dft(plan->plan_slow_backward,data,data);
+/* 1d FFTs along slow axis, then post-remap to put data in output format
+   if needed, destination is always out */
 
-/* post-remap to put data in output format if needed
-   destination is always out */
-
-  if (plan->post_plan)
-    remap_3d((double *) data, (double *) out, (double *) plan->scratch,
-	     plan->post_plan);
+  fft_stage(0,pslow,plslow,(double *) data,2*plan->length3*plan->lines3,
+	    (double *) data,2*plan->length3*plan->lines3,(double *) out,
+	    (double *) plan->scratch,plan->post_plan);
 
 /* scaling if required */
 
@@ -182,6 +204,8 @@ struct fft_plan_3d *fft_3d_create_plan(
   int out_size,first_size,second_size,third_size,copy_size,scratch_size;
   int np1,np2,ip1,ip2;
   int list[50];
+  int plan_size;
+  FFT_DATA *work;
 
 /* query MPI info */
 
@@ -199,6 +223,11 @@ struct fft_plan_3d *fft_3d_create_plan(
   plan = (struct fft_plan_3d *) malloc(sizeof(struct fft_plan_3d));
   if (plan == NULL) return NULL;
 
+  plan->real = 0;
+  plan->pre_inv_plan = plan->mid1_inv_plan = NULL;
+  plan->mid2_inv_plan = plan->post_inv_plan = NULL;
+  plan->rcopy = NULL;
+
 /* remap from initial distribution to layout needed for 1st set of 1d FFTs
    not needed if all procs own entire fast axis initially
    first indices = distribution after 1st set of FFTs */
@@ -238,6 +267,7 @@ struct fft_plan_3d *fft_3d_create_plan(
 
   plan->length1 = nfast;
   plan->total1 = nfast * (first_jhi-first_jlo+1) * (first_khi-first_klo+1);
+  plan->lines1 = first_jhi - first_jlo + 1;
 
 /* remap from 1st to 2nd FFT
    choose which axis is split over np1 vs np2 to minimize communication
@@ -250,18 +280,19 @@ struct fft_plan_3d *fft_3d_create_plan(
   second_klo = ip2*nslow/np2;
   second_khi = (ip2+1)*nslow/np2 - 1;
   plan->mid1_plan =
-      remap_3d_create_plan(comm,
-			   first_ilo,first_ihi,first_jlo,first_jhi,
-			   first_klo,first_khi,
-			   second_ilo,second_ihi,second_jlo,second_jhi,
-			   second_klo,second_khi,
-			   FFT_PRECISION,1,0,2);
+      fft_remap_create(comm,
+		       first_ilo,first_ihi,first_jlo,first_jhi,
+		       first_klo,first_khi,
+		       second_ilo,second_ihi,second_jlo,second_jhi,
+		       second_klo,second_khi,
+		       FFT_PRECISION,1,fft_remap_chunks);
   if (plan->mid1_plan == NULL) return NULL;
 
 /* 1d FFTs along mid axis */
 
   plan->length2 = nmid;
   plan->total2 = (second_ihi-second_ilo+1) * nmid * (second_khi-second_klo+1);
+  plan->lines2 = second_khi - second_klo + 1;
 
 /* remap from 2nd to 3rd FFT
    if final distribution is permute=2 with all procs owning entire slow axis
@@ -293,18 +324,19 @@ struct fft_plan_3d *fft_3d_create_plan(
   }
   
   plan->mid2_plan =
-    remap_3d_create_plan(comm,
-			 second_jlo,second_jhi,second_klo,second_khi,
-			 second_ilo,second_ihi,
-			 third_jlo,third_jhi,third_klo,third_khi,
-			 third_ilo,third_ihi,
-			 FFT_PRECISION,1,0,2);
+    fft_remap_create(comm,
+		     second_jlo,second_jhi,second_klo,second_khi,
+		     second_ilo,second_ihi,
+		     third_jlo,third_jhi,third_klo,third_khi,
+		     third_ilo,third_ihi,
+		     FFT_PRECISION,1,fft_remap_chunks);
   if (plan->mid2_plan == NULL) return NULL;
 
 /* 1d FFTs along slow axis */
 
   plan->length3 = nslow;
   plan->total3 = (third_ihi-third_ilo+1) * (third_jhi-third_jlo+1) * nslow;
+  plan->lines3 = third_ihi - third_ilo + 1;
 
 /* remap from 3rd FFT to final distribution
    not needed if permute = 2 and third indices = out indices on all procs */
@@ -323,12 +355,12 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->post_plan = NULL;
   else {
     plan->post_plan =
-      remap_3d_create_plan(comm,
-			   third_klo,third_khi,third_ilo,third_ihi,
-			   third_jlo,third_jhi,
-			   out_klo,out_khi,out_ilo,out_ihi,
-			   out_jlo,out_jhi,
-			   FFT_PRECISION,(permute+1)%3,0,2);
+      fft_remap_create(comm,
+		       third_klo,third_khi,third_ilo,third_ihi,
+		       third_jlo,third_jhi,
+		       out_klo,out_khi,out_ilo,out_ihi,
+		       out_jlo,out_jhi,
+		       FFT_PRECISION,(permute+1)%3,fft_remap_chunks);
     if (plan->post_plan == NULL) return NULL;
   }
 
@@ -388,63 +420,97 @@ struct fft_plan_3d *fft_3d_create_plan(
   *nbuf = copy_size + scratch_size;
 
   if (copy_size) {
-    plan->copy = (FFT_DATA *) malloc(copy_size*sizeof(FFT_DATA));
+    plan->copy = (FFT_DATA *) fftw_malloc(copy_size*sizeof(FFT_DATA));
     if (plan->copy == NULL) return NULL;
   }
   else plan->copy = NULL;
 
   if (scratch_size) {
-    plan->scratch = (FFT_DATA *) malloc(scratch_size*sizeof(FFT_DATA));
+    plan->scratch = (FFT_DATA *) fftw_malloc(scratch_size*sizeof(FFT_DATA));
     if (plan->scratch == NULL) return NULL;
   }
   else plan->scratch = NULL;
 
 /* system specific pre-computation of 1d FFT coeffs 
-   and scaling normalization */
+   and scaling normalization
+   a 1d plan is only shared when both its length and count match */
+
+  plan_size = MAX(plan->total1,plan->total2);
+  plan_size = MAX(plan_size,plan->total3);
+  work = (FFT_DATA *) fftw_malloc(plan_size*sizeof(FFT_DATA));
+  if (work == NULL) return NULL;
 
   plan->plan_fast_forward =
     fftw_plan_many_dft(1,&(plan->length1),plan->total1/plan->length1,
-                       plan->scratch,NULL,1,plan->length1,plan->scratch,
-                       NULL,1,plan->length1,FFTW_FORWARD,FFTW_ESTIMATE);
+                       work,NULL,1,plan->length1,work,
+                       NULL,1,plan->length1,FFTW_FORWARD,fft_plan_flags);
   plan->plan_fast_backward =
     fftw_plan_many_dft(1,&(plan->length1),plan->total1/plan->length1,
-                       plan->scratch,NULL,1,plan->length1,plan->scratch,
-                       NULL,1,plan->length1,FFTW_BACKWARD,FFTW_ESTIMATE);
+                       work,NULL,1,plan->length1,work,
+                       NULL,1,plan->length1,FFTW_BACKWARD,fft_plan_flags);
 
-  if (plan->length2 == plan->length1) {
+  if (plan->length2 == plan->length1 && plan->total2 == plan->total1) {
     plan->plan_mid_forward = plan->plan_fast_forward;
     plan->plan_mid_backward = plan->plan_fast_backward;
   }
   else {
     plan->plan_mid_forward =
       fftw_plan_many_dft(1,&(plan->length2),plan->total2/plan->length2,
-                         plan->scratch,NULL,1,plan->length2,plan->scratch,
-                         NULL,1,plan->length2,FFTW_FORWARD,FFTW_ESTIMATE);
+                         work,NULL,1,plan->length2,work,
+                         NULL,1,plan->length2,FFTW_FORWARD,fft_plan_flags);
     plan->plan_mid_backward =
       fftw_plan_many_dft(1,&(plan->length2),plan->total2/plan->length2,
-                         plan->scratch,NULL,1,plan->length2,plan->scratch,
-                         NULL,1,plan->length2,FFTW_BACKWARD,FFTW_ESTIMATE);
+                         work,NULL,1,plan->length2,work,
+                         NULL,1,plan->length2,FFTW_BACKWARD,fft_plan_flags);
   }
 
-  if (plan->length3 == plan->length1) {
+  if (plan->length3 == plan->length1 && plan->total3 == plan->total1) {
     plan->plan_slow_forward = plan->plan_fast_forward;
     plan->plan_slow_backward = plan->plan_fast_backward;
   }
-  else if (plan->length3 == plan->length2) {
+  else if (plan->length3 == plan->length2 && plan->total3 == plan->total2) {
     plan->plan_slow_forward = plan->plan_mid_forward;
     plan->plan_slow_backward = plan->plan_mid_backward;
   }
   else {
     plan->plan_slow_forward =
       fftw_plan_many_dft(1,&(plan->length3),plan->total3/plan->length3,
-                         plan->scratch,NULL,1,plan->length3,plan->scratch,
-                         NULL,1,plan->length3,FFTW_FORWARD,FFTW_ESTIMATE);
+                         work,NULL,1,plan->length3,work,
+                         NULL,1,plan->length3,FFTW_FORWARD,fft_plan_flags);
     plan->plan_slow_backward =
       fftw_plan_many_dft(1,&(plan->length3),plan->total3/plan->length3,
-                         plan->scratch,NULL,1,plan->length3,plan->scratch,
-                         NULL,1,plan->length3,FFTW_BACKWARD,FFTW_ESTIMATE);
+                         work,NULL,1,plan->length3,work,
+                         NULL,1,plan->length3,FFTW_BACKWARD,fft_plan_flags);
+  }
+
+/* per-plane 1d FFTs for the stages followed by a chunked remap */
+
+  plan->plane_fast_r2c = plan->plane_fast_c2r = NULL;
+  plan->plane_fast_forward = plan->plane_fast_backward = NULL;
+  plan->plane_mid_forward = plan->plane_mid_backward = NULL;
+  plan->plane_slow_forward = plan->plane_slow_backward = NULL;
+
+  if (plan->mid1_plan->nchunk) {
+    plan->plane_fast_forward =
+      fft_plane_plan(plan->length1,plan->lines1,work,FFTW_FORWARD);
+    plan->plane_fast_backward =
+      fft_plane_plan(plan->length1,plan->lines1,work,FFTW_BACKWARD);
+  }
+  if (plan->mid2_plan->nchunk) {
+    plan->plane_mid_forward =
+      fft_plane_plan(plan->length2,plan->lines2,work,FFTW_FORWARD);
+    plan->plane_mid_backward =
+      fft_plane_plan(plan->length2,plan->lines2,work,FFTW_BACKWARD);
+  }
+  if (plan->post_plan && plan->post_plan->nchunk) {
+    plan->plane_slow_forward =
+      fft_plane_plan(plan->length3,plan->lines3,work,FFTW_FORWARD);
+    plan->plane_slow_backward =
+      fft_plane_plan(plan->length3,plan->lines3,work,FFTW_BACKWARD);
   }
 
+  fftw_free(work);
+
   if (scaled == 0)
     plan->scaled = 0;
   else {
@@ -457,6 +523,639 @@ struct fft_plan_3d *fft_3d_create_plan(
   return plan;
 }
 
+/* ------------------------------------------------------------------- */
+/* Perform 3d real-to-complex FFT */
+
+/* Arguments:
+
+   real         starting address of real data on this proc
+   cplx         starting address of half-spectrum data on this proc
+                  (can be same as real)
+   flag         -1 for forward FFT (real -> cplx),
+                 1 for inverse FFT (cplx -> real)
+   plan         plan returned by previous call to fft_3d_create_plan_r2c
+
+   the 1d r2c/c2r FFTs are always done along the fast axis, so the
+   forward transform runs fast,mid,slow and the inverse runs slow,mid,fast
+   with every remap replaced by its inverse
+   all intermediate stages live in plan->copy, so real and cplx are each
+   touched only once (read first, or written last)
+*/
+
+void fft_3d_r2c(double *real, FFT_DATA *cplx, int flag,
+		struct fft_plan_3d *plan)
+
+{
+  int i,num,nhalf;
+  double norm,*rdata;
+  FFT_DATA *data = plan->copy;
+
+  nhalf = plan->length1/2 + 1;
+
+  if (flag == -1) {
+
+/* pre-remap real data so each proc owns entire fast axis, if needed */
+
+    if (plan->pre_plan) {
+      remap_3d(real,plan->rcopy,(double *) plan->scratch,plan->pre_plan);
+      rdata = plan->rcopy;
+    }
+    else
+      rdata = real;
+
+/* 1d r2c FFTs along fast axis, nfast reals -> nfast/2+1 complex */
+
+    fft_stage(1,plan->plan_fast_r2c,plan->plane_fast_r2c,
+	      rdata,plan->length1*plan->lines1,
+	      (double *) data,2*nhalf*plan->lines1,(double *) data,
+	      (double *) plan->scratch,plan->mid1_plan);
+
+    fft_stage(0,plan->plan_mid_forward,plan->plane_mid_forward,
+	      (double *) data,2*plan->length2*plan->lines2,
+	      (double *) data,2*plan->length2*plan->lines2,(double *) data,
+	      (double *) plan->scratch,plan->mid2_plan);
+
+    fft_stage(0,plan->plan_slow_forward,plan->plane_slow_forward,
+	      (double *) data,2*plan->length3*plan->lines3,
+	      (double *) data,2*plan->length3*plan->lines3,(double *) cplx,
+	      (double *) plan->scratch,plan->post_plan);
+  }
+  else {
+
+    remap_3d((double *) cplx,(double *) data,(double *) plan->scratch,
+	     plan->post_inv_plan);
+
+    fft_stage(0,plan->plan_slow_backward,plan->plane_slow_backward,
+	      (double *) data,2*plan->length3*plan->lines3,
+	      (double *) data,2*plan->length3*plan->lines3,(double *) data,
+	      (double *) plan->scratch,plan->mid2_inv_plan);
+
+    fft_stage(0,plan->plan_mid_backward,plan->plane_mid_backward,
+	      (double *) data,2*plan->length2*plan->lines2,
+	      (double *) data,2*plan->length2*plan->lines2,(double *) data,
+	      (double *) plan->scratch,plan->mid1_inv_plan);
+
+/* 1d c2r FFTs along fast axis, then remap real data to output layout */
+
+    if (plan->pre_inv_plan)
+      rdata = plan->rcopy;
+    else
+      rdata = real;
+
+    fft_stage(2,plan->plan_fast_c2r,plan->plane_fast_c2r,
+	      (double *) data,2*nhalf*plan->lines1,
+	      rdata,plan->length1*plan->lines1,real,
+	      (double *) plan->scratch,plan->pre_inv_plan);
+
+    if (plan->scaled) {
+      norm = plan->norm;
+      num = plan->normnum;
+      for (i = 0; i < num; i++) real[i] *= norm;
+    }
+  }
+}
+
+/* ------------------------------------------------------------------- */
+/* Create plan for performing a 3d real-to-complex FFT */
+
+/* Arguments are as for fft_3d_create_plan, except:
+
+   in_*                 bounds of the REAL data I own, fast index
+                          0 to nfast-1
+   out_*                bounds of the COMPLEX data I own, fast index
+                          0 to nfast/2 (the half spectrum)
+   no permute option    output is stored fast,mid,slow like the input
+   scaled               1 = scale the real result of the inverse FFT
+*/
+
+struct fft_plan_3d *fft_3d_create_plan_r2c(
+       MPI_Comm comm, int nfast, int nmid, int nslow,
+       int in_ilo, int in_ihi, int in_jlo, int in_jhi,
+       int in_klo, int in_khi,
+       int out_ilo, int out_ihi, int out_jlo, int out_jhi,
+       int out_klo, int out_khi,
+       int scaled, int *nbuf)
+
+{
+  struct fft_plan_3d *plan;
+  int me,nprocs;
+  int flag,remapflag,nhalf;
+  int first_ilo,first_ihi,first_jlo,first_jhi,first_klo,first_khi;
+  int second_ilo,second_ihi,second_jlo,second_jhi,second_klo,second_khi;
+  int third_ilo,third_ihi,third_jlo,third_jhi,third_klo,third_khi;
+  int in_size,out_size,first_size,second_size,third_size;
+  int copy_size,scratch_size;
+  int np1,np2,ip1,ip2;
+  double *rwork;
+  FFT_DATA *work;
+
+  MPI_Comm_rank(comm,&me);
+  MPI_Comm_size(comm,&nprocs);
+
+  bifactor(nprocs,&np1,&np2);
+  ip1 = me % np1;
+  ip2 = me/np1;
+
+  plan = (struct fft_plan_3d *) malloc(sizeof(struct fft_plan_3d));
+  if (plan == NULL) return NULL;
+
+  plan->real = 1;
+  plan->pre_plan = plan->pre_inv_plan = NULL;
+  plan->rcopy = NULL;
+  nhalf = nfast/2 + 1;
+
+/* remap real data to own entire fast axis, unless all procs already do */
+
+  if (in_ilo == 0 && in_ihi == nfast-1)
+    flag = 0;
+  else
+    flag = 1;
+
+  MPI_Allreduce(&flag,&remapflag,1,MPI_INT,MPI_MAX,comm);
+
+  if (remapflag == 0) {
+    first_jlo = in_jlo;
+    first_jhi = in_jhi;
+    first_klo = in_klo;
+    first_khi = in_khi;
+  }
+  else {
+    first_jlo = ip1*nmid/np1;
+    first_jhi = (ip1+1)*nmid/np1 - 1;
+    first_klo = ip2*nslow/np2;
+    first_khi = (ip2+1)*nslow/np2 - 1;
+    plan->pre_plan =
+      remap_3d_create_plan(comm,in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
+			   0,nfast-1,first_jlo,first_jhi,first_klo,first_khi,
+			   1,0,0,2);
+    plan->pre_inv_plan =
+      fft_remap_create(comm,0,nfast-1,first_jlo,first_jhi,
+		       first_klo,first_khi,
+		       in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
+		       1,0,fft_remap_chunks);
+    if (plan->pre_plan == NULL || plan->pre_inv_plan == NULL) return NULL;
+  }
+
+/* 1d r2c FFTs along fast axis; from here on the fast axis has nhalf
+   complex elements */
+
+  plan->length1 = nfast;
+  plan->total1 = nfast * (first_jhi-first_jlo+1) * (first_khi-first_klo+1);
+  plan->lines1 = first_jhi - first_jlo + 1;
+  first_ilo = 0;
+  first_ihi = nhalf - 1;
+
+  second_ilo = ip1*nhalf/np1;
+  second_ihi = (ip1+1)*nhalf/np1 - 1;
+  second_jlo = 0;
+  second_jhi = nmid - 1;
+  second_klo = ip2*nslow/np2;
+  second_khi = (ip2+1)*nslow/np2 - 1;
+  plan->mid1_plan =
+    fft_remap_create(comm,
+		     first_ilo,first_ihi,first_jlo,first_jhi,
+		     first_klo,first_khi,
+		     second_ilo,second_ihi,second_jlo,second_jhi,
+		     second_klo,second_khi,
+		     FFT_PRECISION,1,fft_remap_chunks);
+  plan->mid1_inv_plan =
+    fft_remap_create(comm,
+		     second_jlo,second_jhi,second_klo,second_khi,
+		     second_ilo,second_ihi,
+		     first_jlo,first_jhi,first_klo,first_khi,
+		     first_ilo,first_ihi,
+		     FFT_PRECISION,2,fft_remap_chunks);
+  if (plan->mid1_plan == NULL || plan->mid1_inv_plan == NULL) return NULL;
+
+  plan->length2 = nmid;
+  plan->total2 = (second_ihi-second_ilo+1) * nmid * (second_khi-second_klo+1);
+  plan->lines2 = second_khi - second_klo + 1;
+
+  third_ilo = ip1*nhalf/np1;
+  third_ihi = (ip1+1)*nhalf/np1 - 1;
+  third_jlo = ip2*nmid/np2;
+  third_jhi = (ip2+1)*nmid/np2 - 1;
+  third_klo = 0;
+  third_khi = nslow - 1;
+  plan->mid2_plan =
+    fft_remap_create(comm,
+		     second_jlo,second_jhi,second_klo,second_khi,
+		     second_ilo,second_ihi,
+		     third_jlo,third_jhi,third_klo,third_khi,
+		     third_ilo,third_ihi,
+		     FFT_PRECISION,1,fft_remap_chunks);
+  plan->mid2_inv_plan =
+    fft_remap_create(comm,
+		     third_klo,third_khi,third_ilo,third_ihi,
+		     third_jlo,third_jhi,
+		     second_klo,second_khi,second_ilo,second_ihi,
+		     second_jlo,second_jhi,
+		     FFT_PRECISION,2,fft_remap_chunks);
+  if (plan->mid2_plan == NULL || plan->mid2_inv_plan == NULL) return NULL;
+
+  plan->length3 = nslow;
+  plan->total3 = (third_ihi-third_ilo+1) * (third_jhi-third_jlo+1) * nslow;
+  plan->lines3 = third_ihi - third_ilo + 1;
+
+  plan->post_plan =
+    fft_remap_create(comm,
+		     third_klo,third_khi,third_ilo,third_ihi,
+		     third_jlo,third_jhi,
+		     out_klo,out_khi,out_ilo,out_ihi,
+		     out_jlo,out_jhi,
+		     FFT_PRECISION,1,fft_remap_chunks);
+  plan->post_inv_plan =
+    remap_3d_create_plan(comm,
+			 out_ilo,out_ihi,out_jlo,out_jhi,out_klo,out_khi,
+			 third_ilo,third_ihi,third_jlo,third_jhi,
+			 third_klo,third_khi,
+			 FFT_PRECISION,2,0,2);
+  if (plan->post_plan == NULL || plan->post_inv_plan == NULL) return NULL;
+
+/* every complex stage is done in place in plan->copy
+   scratch must hold the largest remap result, real results counting
+   half as much as complex ones */
+
+  in_size = (in_ihi-in_ilo+1) * (in_jhi-in_jlo+1) * (in_khi-in_klo+1);
+  out_size = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) * (out_khi-out_klo+1);
+  first_size = nhalf * (first_jhi-first_jlo+1) * (first_khi-first_klo+1);
+  second_size = (second_ihi-second_ilo+1) * (second_jhi-second_jlo+1) *
+    (second_khi-second_klo+1);
+  third_size = (third_ihi-third_ilo+1) * (third_jhi-third_jlo+1) *
+    (third_khi-third_klo+1);
+
+  copy_size = MAX(first_size,second_size);
+  copy_size = MAX(copy_size,third_size);
+  scratch_size = MAX(copy_size,out_size);
+  scratch_size = MAX(scratch_size,(plan->total1+1)/2);
+  scratch_size = MAX(scratch_size,(in_size+1)/2);
+
+  plan->copy = (FFT_DATA *) fftw_malloc(copy_size*sizeof(FFT_DATA));
+  plan->scratch = (FFT_DATA *) fftw_malloc(scratch_size*sizeof(FFT_DATA));
+  if (plan->copy == NULL || plan->scratch == NULL) return NULL;
+
+  *nbuf = copy_size + scratch_size;
+
+  if (plan->pre_plan) {
+    plan->rcopy = (double *) fftw_malloc(plan->total1*sizeof(double));
+    if (plan->rcopy == NULL) return NULL;
+    *nbuf += (plan->total1+1)/2;
+  }
+
+/* 1d FFT plans: r2c/c2r along fast axis (out of place, real <-> copy),
+   complex in place along mid and slow axes
+   planned on rwork and work, see fft_plan_flags */
+
+  rwork = (double *) fftw_malloc(plan->total1*sizeof(double));
+  work = (FFT_DATA *) fftw_malloc(copy_size*sizeof(FFT_DATA));
+  if (rwork == NULL || work == NULL) return NULL;
+
+  plan->plan_fast_forward = NULL;
+  plan->plan_fast_backward = NULL;
+  plan->plan_fast_r2c =
+    fftw_plan_many_dft_r2c(1,&(plan->length1),plan->total1/plan->length1,
+                           rwork,NULL,1,plan->length1,
+                           work,NULL,1,nhalf,fft_plan_flags);
+  plan->plan_fast_c2r =
+    fftw_plan_many_dft_c2r(1,&(plan->length1),plan->total1/plan->length1,
+                           work,NULL,1,nhalf,
+                           rwork,NULL,1,plan->length1,
+                           fft_plan_flags);
+
+  plan->plan_mid_forward =
+    fftw_plan_many_dft(1,&(plan->length2),plan->total2/plan->length2,
+                       work,NULL,1,plan->length2,work,
+                       NULL,1,plan->length2,FFTW_FORWARD,fft_plan_flags);
+  plan->plan_mid_backward =
+    fftw_plan_many_dft(1,&(plan->length2),plan->total2/plan->length2,
+                       work,NULL,1,plan->length2,work,
+                       NULL,1,plan->length2,FFTW_BACKWARD,fft_plan_flags);
+
+  if (plan->length3 == plan->length2 && plan->total3 == plan->total2) {
+    plan->plan_slow_forward = plan->plan_mid_forward;
+    plan->plan_slow_backward = plan->plan_mid_backward;
+  }
+  else {
+    plan->plan_slow_forward =
+      fftw_plan_many_dft(1,&(plan->length3),plan->total3/plan->length3,
+                         work,NULL,1,plan->length3,work,
+                         NULL,1,plan->length3,FFTW_FORWARD,fft_plan_flags);
+    plan->plan_slow_backward =
+      fftw_plan_many_dft(1,&(plan->length3),plan->total3/plan->length3,
+                         work,NULL,1,plan->length3,work,
+                         NULL,1,plan->length3,FFTW_BACKWARD,fft_plan_flags);
+  }
+
+/* per-plane 1d FFTs for the stages followed by a chunked remap */
+
+  plan->plane_fast_r2c = plan->plane_fast_c2r = NULL;
+  plan->plane_fast_forward = plan->plane_fast_backward = NULL;
+  plan->plane_mid_forward = plan->plane_mid_backward = NULL;
+  plan->plane_slow_forward = plan->plane_slow_backward = NULL;
+
+  if (plan->mid1_plan->nchunk && plan->lines1 > 0)
+    plan->plane_fast_r2c =
+      fftw_plan_many_dft_r2c(1,&(plan->length1),plan->lines1,
+			     rwork,NULL,1,plan->length1,
+			     work,NULL,1,nhalf,
+			     fft_plan_flags | FFTW_UNALIGNED);
+  if (plan->pre_inv_plan && plan->pre_inv_plan->nchunk && plan->lines1 > 0)
+    plan->plane_fast_c2r =
+      fftw_plan_many_dft_c2r(1,&(plan->length1),plan->lines1,
+			     work,NULL,1,nhalf,
+			     rwork,NULL,1,plan->length1,
+			     fft_plan_flags | FFTW_UNALIGNED);
+  if (plan->mid2_plan->nchunk) {
+    plan->plane_mid_forward =
+      fft_plane_plan(plan->length2,plan->lines2,work,FFTW_FORWARD);
+    plan->plane_slow_forward =
+      fft_plane_plan(plan->length3,plan->lines3,work,FFTW_FORWARD);
+    plan->plane_mid_backward =
+      fft_plane_plan(plan->length2,plan->lines2,work,FFTW_BACKWARD);
+    plan->plane_slow_backward =
+      fft_plane_plan(plan->length3,plan->lines3,work,FFTW_BACKWARD);
+  }
+
+  fftw_free(rwork);
+  fftw_free(work);
+
+  if (scaled == 0)
+    plan->scaled = 0;
+  else {
+    plan->scaled = 1;
+    plan->norm = 1.0/(nfast*nmid*nslow);
+    plan->normnum = in_size;
+  }
+
+  return plan;
+}
+
+/* ------------------------------------------------------------------- */
+/* Perform 3d real-to-real FFT */
+
+/* Arguments:
+
+   in           starting address of input data on this proc
+   out          starting address of where output data for this proc
+                  will be placed (can be same as in)
+   plan         plan returned by previous call to fft_3d_create_plan_r2r
+
+   the same 1d r2r transform is done along each axis; there is no
+   direction or scaling, see fftw for the normalization of each kind
+   (e.g. FFTW_RODFT00 is its own inverse up to a factor 2(n+1) per axis)
+   all intermediate stages live in plan->rcopy
+*/
+
+void fft_3d_r2r(double *in, double *out, struct fft_plan_3d *plan)
+
+{
+  double *rdata;
+
+/* pre-remap so each proc owns entire fast axis, if needed
+   the 1d FFTs along the fast axis are out of place, into rcopy */
+
+  if (plan->pre_plan) {
+    remap_3d(in,(double *) plan->copy,(double *) plan->scratch,
+	     plan->pre_plan);
+    rdata = (double *) plan->copy;
+  }
+  else
+    rdata = in;
+
+  fft_stage(3,plan->plan_fast_forward,plan->plane_fast_forward,
+	    rdata,plan->length1*plan->lines1,
+	    plan->rcopy,plan->length1*plan->lines1,plan->rcopy,
+	    (double *) plan->scratch,plan->mid1_plan);
+
+  fft_stage(3,plan->plan_mid_forward,plan->plane_mid_forward,
+	    plan->rcopy,plan->length2*plan->lines2,
+	    plan->rcopy,plan->length2*plan->lines2,plan->rcopy,
+	    (double *) plan->scratch,plan->mid2_plan);
+
+  fft_stage(3,plan->plan_slow_forward,plan->plane_slow_forward,
+	    plan->rcopy,plan->length3*plan->lines3,
+	    plan->rcopy,plan->length3*plan->lines3,out,
+	    (double *) plan->scratch,plan->post_plan);
+}
+
+/* ------------------------------------------------------------------- */
+/* Create plan for performing a 3d real-to-real FFT */
+
+/* Arguments are as for fft_3d_create_plan, except:
+
+   in_*,out_*           bounds of the real data I own on input and output
+   no permute option    output is stored fast,mid,slow like the input
+   no scaled option     caller normalizes, see fft_3d_r2r
+   kind                 fftw r2r kind of the 1d transforms along each axis
+*/
+
+struct fft_plan_3d *fft_3d_create_plan_r2r(
+       MPI_Comm comm, int nfast, int nmid, int nslow,
+       int in_ilo, int in_ihi, int in_jlo, int in_jhi,
+       int in_klo, int in_khi,
+       int out_ilo, int out_ihi, int out_jlo, int out_jhi,
+       int out_klo, int out_khi,
+       fftw_r2r_kind kind, int *nbuf)
+
+{
+  struct fft_plan_3d *plan;
+  int me,nprocs;
+  int flag,remapflag;
+  int first_ilo,first_ihi,first_jlo,first_jhi,first_klo,first_khi;
+  int second_ilo,second_ihi,second_jlo,second_jhi,second_klo,second_khi;
+  int third_ilo,third_ihi,third_jlo,third_jhi,third_klo,third_khi;
+  int in_size,out_size,first_size,second_size,third_size;
+  int copy_size,scratch_size;
+  int np1,np2,ip1,ip2;
+  double *rwork,*work;
+
+  MPI_Comm_rank(comm,&me);
+  MPI_Comm_size(comm,&nprocs);
+
+  bifactor(nprocs,&np1,&np2);
+  ip1 = me % np1;
+  ip2 = me/np1;
+
+  plan = (struct fft_plan_3d *) malloc(sizeof(struct fft_plan_3d));
+  if (plan == NULL) return NULL;
+
+  plan->real = 2;
+  plan->pre_plan = NULL;
+  plan->pre_inv_plan = plan->mid1_inv_plan = NULL;
+  plan->mid2_inv_plan = plan->post_inv_plan = NULL;
+  plan->copy = NULL;
+
+/* remap to own entire fast axis, unless all procs already do
+   every remap moves 1 datum per element */
+
+  if (in_ilo == 0 && in_ihi == nfast-1)
+    flag = 0;
+  else
+    flag = 1;
+
+  MPI_Allreduce(&flag,&remapflag,1,MPI_INT,MPI_MAX,comm);
+
+  first_ilo = 0;
+  first_ihi = nfast - 1;
+  if (remapflag == 0) {
+    first_jlo = in_jlo;
+    first_jhi = in_jhi;
+    first_klo = in_klo;
+    first_khi = in_khi;
+  }
+  else {
+    first_jlo = ip1*nmid/np1;
+    first_jhi = (ip1+1)*nmid/np1 - 1;
+    first_klo = ip2*nslow/np2;
+    first_khi = (ip2+1)*nslow/np2 - 1;
+    plan->pre_plan =
+      remap_3d_create_plan(comm,in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
+			   first_ilo,first_ihi,first_jlo,first_jhi,
+			   first_klo,first_khi,
+			   1,0,0,2);
+    if (plan->pre_plan == NULL) return NULL;
+  }
+
+  plan->length1 = nfast;
+  plan->total1 = nfast * (first_jhi-first_jlo+1) * (first_khi-first_klo+1);
+  plan->lines1 = first_jhi - first_jlo + 1;
+
+  second_ilo = ip1*nfast/np1;
+  second_ihi = (ip1+1)*nfast/np1 - 1;
+  second_jlo = 0;
+  second_jhi = nmid - 1;
+  second_klo = ip2*nslow/np2;
+  second_khi = (ip2+1)*nslow/np2 - 1;
+  plan->mid1_plan =
+    fft_remap_create(comm,
+		     first_ilo,first_ihi,first_jlo,first_jhi,
+		     first_klo,first_khi,
+		     second_ilo,second_ihi,second_jlo,second_jhi,
+		     second_klo,second_khi,
+		     1,1,fft_remap_chunks);
+  if (plan->mid1_plan == NULL) return NULL;
+
+  plan->length2 = nmid;
+  plan->total2 = (second_ihi-second_ilo+1) * nmid * (second_khi-second_klo+1);
+  plan->lines2 = second_khi - second_klo + 1;
+
+  third_ilo = ip1*nfast/np1;
+  third_ihi = (ip1+1)*nfast/np1 - 1;
+  third_jlo = ip2*nmid/np2;
+  third_jhi = (ip2+1)*nmid/np2 - 1;
+  third_klo = 0;
+  third_khi = nslow - 1;
+  plan->mid2_plan =
+    fft_remap_create(comm,
+		     second_jlo,second_jhi,second_klo,second_khi,
+		     second_ilo,second_ihi,
+		     third_jlo,third_jhi,third_klo,third_khi,
+		     third_ilo,third_ihi,
+		     1,1,fft_remap_chunks);
+  if (plan->mid2_plan == NULL) return NULL;
+
+  plan->length3 = nslow;
+  plan->total3 = (third_ihi-third_ilo+1) * (third_jhi-third_jlo+1) * nslow;
+  plan->lines3 = third_ihi - third_ilo + 1;
+
+  plan->post_plan =
+    fft_remap_create(comm,
+		     third_klo,third_khi,third_ilo,third_ihi,
+		     third_jlo,third_jhi,
+		     out_klo,out_khi,out_ilo,out_ihi,
+		     out_jlo,out_jhi,
+		     1,1,fft_remap_chunks);
+  if (plan->post_plan == NULL) return NULL;
+
+/* every stage is done in place in plan->rcopy, except that the pre-remap
+   result goes to plan->copy so the fast FFTs are out of place either way
+   sizes are in doubles, the FFT_DATA buffers hold half as many elements */
+
+  in_size = (in_ihi-in_ilo+1) * (in_jhi-in_jlo+1) * (in_khi-in_klo+1);
+  out_size = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) * (out_khi-out_klo+1);
+  first_size = plan->total1;
+  second_size = plan->total2;
+  third_size = plan->total3;
+
+  copy_size = MAX(first_size,second_size);
+  copy_size = MAX(copy_size,third_size);
+  scratch_size = MAX(copy_size,out_size);
+  scratch_size = MAX(scratch_size,in_size);
+
+  plan->rcopy = (double *) fftw_malloc(copy_size*sizeof(double));
+  plan->scratch =
+    (FFT_DATA *) fftw_malloc(((scratch_size+1)/2)*sizeof(FFT_DATA));
+  if (plan->rcopy == NULL || plan->scratch == NULL) return NULL;
+
+  *nbuf = (copy_size+1)/2 + (scratch_size+1)/2;
+
+  if (plan->pre_plan) {
+    plan->copy =
+      (FFT_DATA *) fftw_malloc(((first_size+1)/2)*sizeof(FFT_DATA));
+    if (plan->copy == NULL) return NULL;
+    *nbuf += (first_size+1)/2;
+  }
+
+/* 1d FFT plans: out of place along fast axis (rwork -> work),
+   in place along mid and slow axes, see fft_plan_flags */
+
+  rwork = (double *) fftw_malloc(plan->total1*sizeof(double));
+  work = (double *) fftw_malloc(copy_size*sizeof(double));
+  if (rwork == NULL || work == NULL) return NULL;
+
+  plan->plan_fast_forward =
+    fftw_plan_many_r2r(1,&(plan->length1),plan->total1/plan->length1,
+		       rwork,NULL,1,plan->length1,
+		       work,NULL,1,plan->length1,&kind,fft_plan_flags);
+  plan->plan_mid_forward =
+    fftw_plan_many_r2r(1,&(plan->length2),plan->total2/plan->length2,
+		       work,NULL,1,plan->length2,
+		       work,NULL,1,plan->length2,&kind,fft_plan_flags);
+  plan->plan_slow_forward =
+    fftw_plan_many_r2r(1,&(plan->length3),plan->total3/plan->length3,
+		       work,NULL,1,plan->length3,
+		       work,NULL,1,plan->length3,&kind,fft_plan_flags);
+  plan->plan_fast_backward = NULL;
+  plan->plan_mid_backward = NULL;
+  plan->plan_slow_backward = NULL;
+  plan->plan_fast_r2c = plan->plan_fast_c2r = NULL;
+
+/* per-plane 1d FFTs for the stages followed by a chunked remap */
+
+  plan->plane_fast_r2c = plan->plane_fast_c2r = NULL;
+  plan->plane_fast_forward = plan->plane_fast_backward = NULL;
+  plan->plane_mid_forward = plan->plane_mid_backward = NULL;
+  plan->plane_slow_forward = plan->plane_slow_backward = NULL;
+
+  if (plan->mid1_plan->nchunk) {
+    if (plan->lines1 > 0)
+      plan->plane_fast_forward =
+	fftw_plan_many_r2r(1,&(plan->length1),plan->lines1,
+			   rwork,NULL,1,plan->length1,
+			   work,NULL,1,plan->length1,&kind,
+			   fft_plan_flags | FFTW_UNALIGNED);
+    if (plan->lines2 > 0)
+      plan->plane_mid_forward =
+	fftw_plan_many_r2r(1,&(plan->length2),plan->lines2,
+			   work,NULL,1,plan->length2,
+			   work,NULL,1,plan->length2,&kind,
+			   fft_plan_flags | FFTW_UNALIGNED);
+    if (plan->lines3 > 0)
+      plan->plane_slow_forward =
+	fftw_plan_many_r2r(1,&(plan->length3),plan->lines3,
+			   work,NULL,1,plan->length3,
+			   work,NULL,1,plan->length3,&kind,
+			   fft_plan_flags | FFTW_UNALIGNED);
+  }
+
+  fftw_free(rwork);
+  fftw_free(work);
+
+  plan->scaled = 0;
+
+  return plan;
+}
+
 /* ------------------------------------------------------------------- */
 /* Destroy a 3d fft plan */
 
@@ -468,20 +1167,145 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   if (plan->mid2_plan) remap_3d_destroy_plan(plan->mid2_plan);
   if (plan->post_plan) remap_3d_destroy_plan(plan->post_plan);
 
-  if (plan->copy) free(plan->copy);
-  if (plan->scratch) free(plan->scratch);
+  if (plan->pre_inv_plan) remap_3d_destroy_plan(plan->pre_inv_plan);
+  if (plan->mid1_inv_plan) remap_3d_destroy_plan(plan->mid1_inv_plan);
+  if (plan->mid2_inv_plan) remap_3d_destroy_plan(plan->mid2_inv_plan);
+  if (plan->post_inv_plan) remap_3d_destroy_plan(plan->post_inv_plan);
 
-  if (plan->plan_slow_forward != plan->plan_mid_forward &&
-      plan->plan_slow_forward != plan->plan_fast_forward) {
+  if (plan->copy) fftw_free(plan->copy);
+  if (plan->scratch) fftw_free(plan->scratch);
+  if (plan->rcopy) fftw_free(plan->rcopy);
+
+  if (plan->real == 2) {
+    fftw_destroy_plan(plan->plan_fast_forward);
+    fftw_destroy_plan(plan->plan_mid_forward);
     fftw_destroy_plan(plan->plan_slow_forward);
-    fftw_destroy_plan(plan->plan_slow_backward);
   }
-  if (plan->plan_mid_forward != plan->plan_fast_forward) {
-    fftw_destroy_plan(plan->plan_mid_forward);
-    fftw_destroy_plan(plan->plan_mid_backward);
+  else {
+    if (plan->plan_slow_forward != plan->plan_mid_forward &&
+	plan->plan_slow_forward != plan->plan_fast_forward) {
+      fftw_destroy_plan(plan->plan_slow_forward);
+      fftw_destroy_plan(plan->plan_slow_backward);
+    }
+    if (plan->plan_mid_forward != plan->plan_fast_forward) {
+      fftw_destroy_plan(plan->plan_mid_forward);
+      fftw_destroy_plan(plan->plan_mid_backward);
+    }
+    if (plan->real) {
+      fftw_destroy_plan(plan->plan_fast_r2c);
+      fftw_destroy_plan(plan->plan_fast_c2r);
+    }
+    else {
+      fftw_destroy_plan(plan->plan_fast_forward);
+      fftw_destroy_plan(plan->plan_fast_backward);
+    }
   }
-  fftw_destroy_plan(plan->plan_fast_forward);
-  fftw_destroy_plan(plan->plan_fast_backward);
+
+  if (plan->plane_fast_forward) fftw_destroy_plan(plan->plane_fast_forward);
+  if (plan->plane_fast_backward) fftw_destroy_plan(plan->plane_fast_backward);
+  if (plan->plane_mid_forward) fftw_destroy_plan(plan->plane_mid_forward);
+  if (plan->plane_mid_backward) fftw_destroy_plan(plan->plane_mid_backward);
+  if (plan->plane_slow_forward) fftw_destroy_plan(plan->plane_slow_forward);
+  if (plan->plane_slow_backward) fftw_destroy_plan(plan->plane_slow_backward);
+  if (plan->plane_fast_r2c) fftw_destroy_plan(plan->plane_fast_r2c);
+  if (plan->plane_fast_c2r) fftw_destroy_plan(plan->plane_fast_c2r);
 
   free(plan);
 }
+
+/* ------------------------------------------------------------------- */
+/* Create a remap that follows a set of 1d FFTs, chunked if nchunk > 1
+   (system provides no memory, double precision) */
+
+static struct remap_plan_3d *fft_remap_create(
+       MPI_Comm comm,
+       int in_ilo, int in_ihi, int in_jlo, int in_jhi,
+       int in_klo, int in_khi,
+       int out_ilo, int out_ihi, int out_jlo, int out_jhi,
+       int out_klo, int out_khi,
+       int nqty, int permute, int nchunk)
+
+{
+  if (nchunk > 1)
+    return remap_3d_create_plan_chunked(comm,
+					in_ilo,in_ihi,in_jlo,in_jhi,
+					in_klo,in_khi,
+					out_ilo,out_ihi,out_jlo,out_jhi,
+					out_klo,out_khi,
+					nqty,permute,2,nchunk);
+  else
+    return remap_3d_create_plan(comm,
+				in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
+				out_ilo,out_ihi,out_jlo,out_jhi,
+				out_klo,out_khi,
+				nqty,permute,0,2);
+}
+
+/* ------------------------------------------------------------------- */
+/* Plan the in place complex 1d FFTs of one slow plane (nlines FFTs of
+   the given length), NULL if there are none */
+
+static fftw_plan fft_plane_plan(int length, int nlines, FFT_DATA *work,
+				int sign)
+
+{
+  if (nlines <= 0) return NULL;
+
+  return fftw_plan_many_dft(1,&length,nlines,work,NULL,1,length,
+			    work,NULL,1,length,sign,
+			    fft_plan_flags | FFTW_UNALIGNED);
+}
+
+/* ------------------------------------------------------------------- */
+/* Execute a 1d FFT plan on new arrays
+   kind = 0 complex, 1 real-to-complex, 2 complex-to-real, 3 real-to-real */
+
+static void fft_execute(int kind, fftw_plan p, double *in, double *out)
+
+{
+  if (kind == 0)
+    fftw_execute_dft(p,(FFT_DATA *) in,(FFT_DATA *) out);
+  else if (kind == 1)
+    fftw_execute_dft_r2c(p,in,(FFT_DATA *) out);
+  else if (kind == 2)
+    fftw_execute_dft_c2r(p,(FFT_DATA *) in,out);
+  else
+    fftw_execute_r2r(p,in,out);
+}
+
+/* ------------------------------------------------------------------- */
+/* One set of 1d FFTs (in -> fftout) followed by a remap (fftout -> out)
+
+   p            plan for all the 1d FFTs at once
+   pplane       plan for the 1d FFTs of one slow plane
+   in_plane     # of doubles per slow plane of in
+   fft_plane    # of doubles per slow plane of fftout
+   buf          remap scratch space
+   remap        remap to do after the FFTs, can be NULL
+
+   if the remap is chunked, its recvs are posted first, then the FFTs of
+   each chunk of planes are done and that chunk is sent right away, so
+   the 1d FFTs of later chunks overlap the communication of earlier ones
+*/
+
+static void fft_stage(int kind, fftw_plan p, fftw_plan pplane,
+		      double *in, int in_plane, double *fftout, int fft_plane,
+		      double *out, double *buf, struct remap_plan_3d *remap)
+
+{
+  int ichunk,k;
+
+  if (remap == NULL || remap->nchunk == 0) {
+    fft_execute(kind,p,in,fftout);
+    if (remap) remap_3d(fftout,out,buf,remap);
+    return;
+  }
+
+  remap_3d_chunk_post(buf,remap);
+  for (ichunk = 0; ichunk < remap->nchunk; ichunk++) {
+    for (k = remap->chunk_klo[ichunk]; k <= remap->chunk_khi[ichunk]; k++)
+      fft_execute(kind,pplane,&in[k*in_plane],&fftout[k*fft_plane]);
+    remap_3d_chunk_send(fftout,ichunk,buf,remap);
+  }
+  remap_3d_chunk_wait(buf,out,remap);
+}
@@ -57,6 +57,29 @@ struct fft_plan_3d {
   fftw_plan plan_mid_backward;
   fftw_plan plan_slow_forward;
   fftw_plan plan_slow_backward;
+                                    /* real-to-complex plans only */
+  int real;                         /* 1 if created by fft_3d_create_plan_r2c */
+                                    /* 2 if by fft_3d_create_plan_r2r, */
+                                    /*   whose 1d plans are the *_forward */
+  struct remap_plan_3d *pre_inv_plan;   /* inverses of the four remaps, */
+  struct remap_plan_3d *mid1_inv_plan;  /* used by the c2r transform */
+  struct remap_plan_3d *mid2_inv_plan;
+  struct remap_plan_3d *post_inv_plan;
+  double *rcopy;                    /* real data after pre-remap (r2c), */
+                                    /*   all stages (r2r) */
+  fftw_plan plan_fast_r2c;
+  fftw_plan plan_fast_c2r;
+                                    /* pipelined (chunked) remaps only */
+  int lines1,lines2,lines3;         /* # of 1d FFTs per slow plane of the */
+                                    /*   1st,2nd,3rd FFTs */
+  fftw_plan plane_fast_forward;     /* 1d FFTs of one plane, NULL if the */
+  fftw_plan plane_fast_backward;    /*   remap that follows is not chunked */
+  fftw_plan plane_mid_forward;
+  fftw_plan plane_mid_backward;
+  fftw_plan plane_slow_forward;
+  fftw_plan plane_slow_backward;
+  fftw_plan plane_fast_r2c;
+  fftw_plan plane_fast_c2r;
 };
 
 /* function prototypes */
@@ -65,8 +88,24 @@ void fft_3d(FFT_DATA *, FFT_DATA *, int, struct fft_plan_3d *);
 struct fft_plan_3d *fft_3d_create_plan(MPI_Comm, int, int, int,
   int, int, int, int, int, int, int, int, int, int, int, int,
   int, int, int *);
+void fft_3d_r2c(double *, FFT_DATA *, int, struct fft_plan_3d *);
+struct fft_plan_3d *fft_3d_create_plan_r2c(MPI_Comm, int, int, int,
+  int, int, int, int, int, int, int, int, int, int, int, int,
+  int, int *);
+void fft_3d_r2r(double *, double *, struct fft_plan_3d *);
+struct fft_plan_3d *fft_3d_create_plan_r2r(MPI_Comm, int, int, int,
+  int, int, int, int, int, int, int, int, int, int, int, int,
+  fftw_r2r_kind, int *);
 void fft_3d_destroy_plan(struct fft_plan_3d *);
 void factor(int, int *, int *);
 void bifactor(int, int *, int *);
 
+/* FFTW planner flags for the 1d FFTs, FFTW_ESTIMATE unless set by caller */
+extern unsigned fft_plan_flags;
+
+/* # of chunks each remap that follows a set of 1d FFTs is split into, so
+   the FFTs of one chunk overlap the communication of the previous ones,
+   1 (no pipelining) unless set by caller before creating plans */
+extern int fft_remap_chunks;
+
 #endif
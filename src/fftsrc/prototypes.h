@@ -14,6 +14,11 @@
  *  The indexing convention of the FFT data is DIFFERENT than Athena's.
  *  See F3DI() and F2DI() macros below for how to access the data.
  *
+ *  3D plans are real-to-complex (r2c forward, c2r backward) unless created
+ *  with ATH_FFT_C2C.  Only the half spectrum k3=0..gnx3/2 is stored, and the
+ *  real data shares the same buffer with the fast (x3) index running over a
+ *  stride of rnx3, see struct ath_3d_fft_plan below.
+ *
  *  Written by Nicole Lemaster on February 25, 2007
  *
  *  Last updated June 14, 2007
@@ -42,6 +47,7 @@
 #endif /* FFT_BLOCK_DECOMP */
 
 #define ath_fft_data fftw_complex
+#define ath_fft_real double
 
 /* Indexing convention of FFT data
  * FFT Nfast=k, Nmid=j, Nslow=i (opposite to Athena) */
@@ -57,6 +63,20 @@ typedef enum {
   ATH_FFT_FORWARD=-1, ATH_FFT_BACKWARD=1
 } ath_fft_direction;
 
+/* ATH_FFT_R2C: real data in physical space (r2c forward, c2r backward)
+ * ATH_FFT_C2C: complex data in physical space
+ * ATH_FFT_DST: real data, sine transform (FFTW_RODFT00) along each axis.
+ *   This is its own inverse up to a factor 8(gnx1+1)(gnx2+1)(gnx3+1), so
+ *   forward and backward plans are the same transform */
+typedef enum {
+  ATH_FFT_C2C=0, ATH_FFT_R2C=1, ATH_FFT_DST=2
+} ath_fft_type;
+
+/* For R2C plans the LOCAL data is
+ *   real:    ((ath_fft_real*)data)[F3DI(i,j,k,nx1,nx2,rnx3)], k < local nx3
+ *   complex: data[F3DI(i,j,k,nx1,nx2,cnx3)], global k3 index = k + cks
+ * For C2C and DST plans rnx3 = cnx3 = local nx3 and cks = gks, and DST data
+ * is real, ((ath_fft_real*)data)[F3DI(i,j,k,nx1,nx2,rnx3)]. */
 struct ath_3d_fft_plan {
 #ifdef FFT_BLOCK_DECOMP
   struct fft_plan_3d *plan;
@@ -64,6 +84,9 @@ struct ath_3d_fft_plan {
   fftw_plan plan;
 #endif /* FFT_BLOCK_DECOMP */
   ath_fft_direction dir;
+  ath_fft_type type;
+  int rnx3;
+  int cnx3, cks;
   long int cnt;
   long int gcnt;
 };
@@ -79,6 +102,15 @@ struct ath_2d_fft_plan {
   long int gcnt;
 };
 
+/**************************************************************************
+ *
+ *  Athena FFT setup (planner flags, FFTW wisdom)
+ *
+ **************************************************************************/
+
+void ath_fft_init(const char *rundir);
+void ath_fft_save_wisdom(void);
+
 /**************************************************************************
  *
  *  Athena 3D FFT functions
@@ -90,7 +122,7 @@ struct ath_3d_fft_plan *ath_3d_fft_quick_plan(DomainS *pD,
 struct ath_3d_fft_plan *ath_3d_fft_create_plan(DomainS *pD, int gnx3, int gnx2,
 				int gnx1, int gks, int gke, int gjs, int gje,
 				int gis, int gie, ath_fft_data *data, int al,
-				ath_fft_direction dir);
+				ath_fft_direction dir, ath_fft_type type);
 ath_fft_data *ath_3d_fft_malloc(struct ath_3d_fft_plan *ath_plan);
 void ath_3d_fft(struct ath_3d_fft_plan *ath_plan, ath_fft_data *data);
 void ath_3d_fft_free(ath_fft_data *data);
@@ -70,6 +70,16 @@ void remap_3d(double *in, double *out, double *buf,
   int i,isend,irecv;
   double *scratch;
 
+/* a chunked plan does all its chunks back to back */
+
+  if (plan->nchunk) {
+    remap_3d_chunk_post(buf,plan);
+    for (i = 0; i < plan->nchunk; i++)
+      remap_3d_chunk_send(in,i,buf,plan);
+    remap_3d_chunk_wait(buf,out,plan);
+    return;
+  }
+
   if (plan->memory == 0)
     scratch = buf;
   else
@@ -396,6 +406,9 @@ struct remap_plan_3d *remap_3d_create_plan(
 /* init remaining fields in remap plan */
 
   plan->memory = memory;
+  plan->recv_total = ibuf;
+  plan->nchunk = 0;
+  plan->chunk = NULL;
 
   if (nrecv == plan->nrecv)
     plan->self = 0;
@@ -422,6 +435,20 @@ struct remap_plan_3d *remap_3d_create_plan(
     if (plan->sendbuf == NULL) return NULL;
   }
 
+/* total volume of sends (not including self) and requests for sending
+   them all at once, as a chunked remap does */
+
+  plan->send_total = 0;
+  for (nsend = 0; nsend < plan->nsend; nsend++)
+    plan->send_total += plan->send_size[nsend];
+
+  plan->send_request = NULL;
+  if (plan->nsend) {
+    plan->send_request =
+      (MPI_Request *) malloc(plan->nsend*sizeof(MPI_Request));
+    if (plan->send_request == NULL) return NULL;
+  }
+
 /* if requested, allocate internal scratch space for recvs,
    only need it if I will receive any data (including self) */
 
@@ -447,6 +474,208 @@ struct remap_plan_3d *remap_3d_create_plan(
   return plan;
 }
 
+/* ------------------------------------------------------------------- */
+/* Pipelined 3d remap, one chunk of input planes at a time */
+
+/* a chunked remap splits the slow index of the data I own on input
+   into nchunk contiguous ranges, and does a separate remap of each,
+   so the caller can compute chunk n+1 while chunk n is in flight:
+
+     remap_3d_chunk_post(buf,plan);
+     for each chunk n:
+       compute input planes of chunk n
+       remap_3d_chunk_send(in,n,buf,plan);
+     remap_3d_chunk_wait(buf,out,plan);
+
+   all recvs for all chunks are posted up front into buf, and sends are
+   nonblocking out of a send buffer that holds every chunk's messages,
+   so nothing is written to out until remap_3d_chunk_wait, and the remap
+   can be in place (out = in) just as for remap_3d
+
+   buf must be as large as for a remap_3d plan created with memory=0
+*/
+
+/* Arguments:
+
+   comm ... precision   same as for remap_3d_create_plan (memory=0 implied)
+   nchunk               # of chunks to split my input slow index into
+                          chunks with no planes are allowed, since
+			  every proc must create every chunk plan
+*/
+
+struct remap_plan_3d *remap_3d_create_plan_chunked(
+       MPI_Comm comm,
+       int in_ilo, int in_ihi, int in_jlo, int in_jhi,
+       int in_klo, int in_khi,
+       int out_ilo, int out_ihi, int out_jlo, int out_jhi,
+       int out_klo, int out_khi,
+       int nqty, int permute, int precision, int nchunk)
+
+{
+  struct remap_plan_3d *plan,*sub;
+  int ichunk,nk,klo,khi,send_total,recv_total;
+
+  if (nchunk < 1) nchunk = 1;
+
+  plan = (struct remap_plan_3d *) malloc(sizeof(struct remap_plan_3d));
+  if (plan == NULL) return NULL;
+
+  plan->nsend = plan->nrecv = plan->self = 0;
+  plan->memory = 0;
+  plan->scratch = NULL;
+  plan->send_request = NULL;
+  plan->nchunk = nchunk;
+  plan->chunk = (struct remap_plan_3d **)
+    malloc(nchunk*sizeof(struct remap_plan_3d *));
+  plan->chunk_klo = (int *) malloc(nchunk*sizeof(int));
+  plan->chunk_khi = (int *) malloc(nchunk*sizeof(int));
+  plan->chunk_send_base = (int *) malloc(nchunk*sizeof(int));
+  plan->chunk_recv_base = (int *) malloc(nchunk*sizeof(int));
+  if (plan->chunk == NULL || plan->chunk_klo == NULL ||
+      plan->chunk_khi == NULL || plan->chunk_send_base == NULL ||
+      plan->chunk_recv_base == NULL) return NULL;
+
+  plan->chunk_plane = nqty * (in_ihi-in_ilo+1) * (in_jhi-in_jlo+1);
+  nk = in_khi - in_klo + 1;
+  if (nk < 0) nk = 0;
+
+/* one remap plan per chunk, each with its own communicator, so messages
+   from different chunks of the same proc can never be confused */
+
+  send_total = 0;
+  recv_total = 0;
+  for (ichunk = 0; ichunk < nchunk; ichunk++) {
+    klo = ichunk*nk/nchunk;
+    khi = (ichunk+1)*nk/nchunk - 1;
+    plan->chunk_klo[ichunk] = klo;
+    plan->chunk_khi[ichunk] = khi;
+
+    sub = remap_3d_create_plan(comm,
+			       in_ilo,in_ihi,in_jlo,in_jhi,
+			       in_klo+klo,in_klo+khi,
+			       out_ilo,out_ihi,out_jlo,out_jhi,
+			       out_klo,out_khi,
+			       nqty,permute,0,precision);
+    if (sub == NULL) return NULL;
+
+/* sends go out of the shared buffer below */
+
+    if (sub->sendbuf) {
+      free(sub->sendbuf);
+      sub->sendbuf = NULL;
+    }
+
+    plan->chunk[ichunk] = sub;
+    plan->chunk_send_base[ichunk] = send_total;
+    plan->chunk_recv_base[ichunk] = recv_total;
+    send_total += sub->send_total;
+    recv_total += sub->recv_total;
+  }
+
+  plan->send_total = send_total;
+  plan->recv_total = recv_total;
+
+  plan->sendbuf = NULL;
+  if (send_total) {
+    plan->sendbuf = (double *) malloc(send_total*sizeof(double));
+    if (plan->sendbuf == NULL) return NULL;
+  }
+
+  return plan;
+}
+
+/* ------------------------------------------------------------------- */
+/* Post the recvs of every chunk of a chunked remap into buf */
+
+void remap_3d_chunk_post(double *buf, struct remap_plan_3d *plan)
+
+{
+  struct remap_plan_3d *sub;
+  int ichunk,irecv;
+  double *scratch;
+
+  for (ichunk = 0; ichunk < plan->nchunk; ichunk++) {
+    sub = plan->chunk[ichunk];
+    scratch = &buf[plan->chunk_recv_base[ichunk]];
+    for (irecv = 0; irecv < sub->nrecv; irecv++)
+      MPI_Irecv(&scratch[sub->recv_bufloc[irecv]],sub->recv_size[irecv],
+		MPI_DOUBLE,sub->recv_proc[irecv],0,
+		sub->comm,&sub->request[irecv]);
+  }
+}
+
+/* ------------------------------------------------------------------- */
+/* Send one chunk of a chunked remap */
+
+/* Arguments:
+
+   in           starting address of all my input data (not of the chunk)
+   ichunk       which chunk, its input planes must be final
+   buf          same buffer as passed to remap_3d_chunk_post
+   plan         plan returned by remap_3d_create_plan_chunked
+*/
+
+void remap_3d_chunk_send(double *in, int ichunk, double *buf,
+			 struct remap_plan_3d *plan)
+
+{
+  struct remap_plan_3d *sub = plan->chunk[ichunk];
+  double *chunk_in = &in[plan->chunk_klo[ichunk]*plan->chunk_plane];
+  double *sendbuf = &plan->sendbuf[plan->chunk_send_base[ichunk]];
+  double *scratch = &buf[plan->chunk_recv_base[ichunk]];
+  int isend;
+
+  for (isend = 0; isend < sub->nsend; isend++) {
+    sub->pack(&chunk_in[sub->send_offset[isend]],sendbuf,
+	      &sub->packplan[isend]);
+    MPI_Isend(sendbuf,sub->send_size[isend],MPI_DOUBLE,
+	      sub->send_proc[isend],0,sub->comm,&sub->send_request[isend]);
+    sendbuf += sub->send_size[isend];
+  }
+
+/* self data is only packed here, it is unpacked in remap_3d_chunk_wait */
+
+  if (sub->self)
+    sub->pack(&chunk_in[sub->send_offset[sub->nsend]],
+	      &scratch[sub->recv_bufloc[sub->nrecv]],
+	      &sub->packplan[sub->nsend]);
+}
+
+/* ------------------------------------------------------------------- */
+/* Complete a chunked remap, all chunks must have been sent */
+
+void remap_3d_chunk_wait(double *buf, double *out, struct remap_plan_3d *plan)
+
+{
+  MPI_Status status;
+  struct remap_plan_3d *sub;
+  int i,ichunk,irecv;
+  double *scratch;
+
+  for (ichunk = 0; ichunk < plan->nchunk; ichunk++) {
+    sub = plan->chunk[ichunk];
+    scratch = &buf[plan->chunk_recv_base[ichunk]];
+
+    if (sub->self) {
+      irecv = sub->nrecv;
+      sub->unpack(&scratch[sub->recv_bufloc[irecv]],
+		  &out[sub->recv_offset[irecv]],&sub->unpackplan[irecv]);
+    }
+
+    for (i = 0; i < sub->nrecv; i++) {
+      MPI_Waitany(sub->nrecv,sub->request,&irecv,&status);
+      sub->unpack(&scratch[sub->recv_bufloc[irecv]],
+		  &out[sub->recv_offset[irecv]],&sub->unpackplan[irecv]);
+    }
+  }
+
+  for (ichunk = 0; ichunk < plan->nchunk; ichunk++) {
+    sub = plan->chunk[ichunk];
+    if (sub->nsend)
+      MPI_Waitall(sub->nsend,sub->send_request,MPI_STATUSES_IGNORE);
+  }
+}
+
 /* ------------------------------------------------------------------- */
 /* Destroy a 3d remap plan */
 
@@ -458,6 +687,23 @@ struct remap_plan_3d *remap_3d_create_plan(
 void remap_3d_destroy_plan(struct remap_plan_3d *plan)
 
 {
+  int ichunk;
+
+  /* a chunked plan owns only its chunk plans and the shared send buffer */
+
+  if (plan->nchunk) {
+    for (ichunk = 0; ichunk < plan->nchunk; ichunk++)
+      remap_3d_destroy_plan(plan->chunk[ichunk]);
+    free(plan->chunk);
+    free(plan->chunk_klo);
+    free(plan->chunk_khi);
+    free(plan->chunk_send_base);
+    free(plan->chunk_recv_base);
+    if (plan->sendbuf) free(plan->sendbuf);
+    free(plan);
+    return;
+  }
+
   /* free MPI communicator */
 
   MPI_Comm_free(&plan->comm);
@@ -470,6 +716,7 @@ void remap_3d_destroy_plan(struct remap_plan_3d *plan)
     free(plan->send_proc);
     free(plan->packplan);
     if (plan->sendbuf) free(plan->sendbuf);
+    if (plan->send_request) free(plan->send_request);
   }
 
   if (plan->nrecv || plan->self) {
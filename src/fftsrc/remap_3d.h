@@ -37,6 +37,16 @@ struct remap_plan_3d {
   int self;                         /* whether I send/recv with myself */
   int memory;                       /* user provides scratch space or not */
   MPI_Comm comm;                    /* group of procs performing remap */
+  MPI_Request *send_request;        /* MPI request for each nonblocking send */
+  int send_total;                   /* # of datums sent (not including self) */
+  int recv_total;                   /* # of datums recvd (including self) */
+                                    /* chunked (pipelined) remaps only */
+  int nchunk;                       /* # of chunks, 0 if not chunked */
+  struct remap_plan_3d **chunk;     /* remap of each chunk of input planes */
+  int *chunk_klo,*chunk_khi;        /* local slow index range of each chunk */
+  int *chunk_send_base;             /* offset in sendbuf for each chunk */
+  int *chunk_recv_base;             /* offset in scratch buf for each chunk */
+  int chunk_plane;                  /* # of datums in one input plane */
 };
 
 /* collision between 2 regions */
@@ -53,6 +63,12 @@ void remap_3d(double *, double *, double *, struct remap_plan_3d *);
 struct remap_plan_3d *remap_3d_create_plan(MPI_Comm, 
   int, int, int, int, int, int,	int, int, int, int, int, int,
   int, int, int, int);
+struct remap_plan_3d *remap_3d_create_plan_chunked(MPI_Comm,
+  int, int, int, int, int, int,	int, int, int, int, int, int,
+  int, int, int, int);
+void remap_3d_chunk_post(double *, struct remap_plan_3d *);
+void remap_3d_chunk_send(double *, int, double *, struct remap_plan_3d *);
+void remap_3d_chunk_wait(double *, double *, struct remap_plan_3d *);
 void remap_3d_destroy_plan(struct remap_plan_3d *);
 int remap_3d_collide(struct extent_3d *, 
 		     struct extent_3d *, struct extent_3d *);
@@ -70,6 +70,9 @@ ShearFun_t ShearProfile = NULL;
 #endif
 
 Real etah=0.0;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(etah)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* definitions included everywhere except main.c  */
@@ -133,5 +136,11 @@ extern ShearFun_t ShearProfile;
 #endif
 
 extern Real etah;
+
+/* With OpenMP, etah and the work arrays of the integrators and lr_states_*.c
+ * are threadprivate, so every thread in the team allocates its own copy */
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(etah)
+#endif
 #endif /* MAIN_C */
 #endif /* GLOBALS_H */
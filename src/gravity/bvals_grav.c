@@ -28,17 +28,26 @@
 #ifdef SELF_GRAVITY
 
 #ifdef MPI_PARALLEL
-/* MPI send and receive buffers */
-static double **send_buf = NULL, **recv_buf = NULL;
-static MPI_Request *recv_rq, *send_rq;
+/*! \struct GravPlanS
+ *  \brief Persistent MPI requests for the boundaries of Phi in one Domain,
+ *   created once by bvals_grav_init().  Messages are sent from and received
+ *   into pG->Phi through subarray datatypes, with no staging copies. */
+typedef struct GravPlan_s{
+  DomainS *pD;                       /* Domain this plan belongs to */
+  MPI_Request send_rq[3][2];         /* [dir][L,R], or MPI_REQUEST_NULL */
+  MPI_Request recv_rq[3][2];
+}GravPlanS;
+
+static GravPlanS *Plan = NULL;
+static int NPlan = 0;
 #endif /* MPI_PARALLEL */
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   reflect_Phi_???()  - apply reflecting BCs at boundary ???
  *   periodic_Phi_???() - apply periodic BCs at boundary ???
- *   pack_Phi_???()   - pack data for MPI non-blocking send at ??? boundary
- *   unpack_Phi_???() - unpack data for MPI non-blocking receive at ??? boundary
+ *   phi_type()       - MPI datatype for a region of Phi
+ *   get_plan()       - persistent MPI requests of a Domain
  *============================================================================*/
 
 static void reflect_Phi_ix1(GridS *pG);
@@ -65,19 +74,9 @@ static void obc_fft_Phi_ox3(GridS *pG);
 static void ProlongateLater(GridS *pG);
 
 #ifdef MPI_PARALLEL
-static void pack_Phi_ix1(GridS *pG);
-static void pack_Phi_ox1(GridS *pG);
-static void pack_Phi_ix2(GridS *pG);
-static void pack_Phi_ox2(GridS *pG);
-static void pack_Phi_ix3(GridS *pG);
-static void pack_Phi_ox3(GridS *pG);
-
-static void unpack_Phi_ix1(GridS *pG);
-static void unpack_Phi_ox1(GridS *pG);
-static void unpack_Phi_ix2(GridS *pG);
-static void unpack_Phi_ox2(GridS *pG);
-static void unpack_Phi_ix3(GridS *pG);
-static void unpack_Phi_ox3(GridS *pG);
+static MPI_Datatype phi_type(const GridS *pG, const int dir, const int side,
+                             const int recv);
+static GravPlanS *get_plan(DomainS *pD);
 #endif /* MPI_PARALLEL */
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
@@ -102,7 +101,8 @@ void bvals_grav(DomainS *pD)
   int myL,myM,myN;
 #endif
 #ifdef MPI_PARALLEL
-  int cnt1, cnt2, cnt3, cnt, ierr, mIndex;
+  GravPlanS *pP = get_plan(pD);
+  int n, ierr;
 #endif /* MPI_PARALLEL */
 
 /*--- Step 1. ------------------------------------------------------------------
@@ -111,85 +111,44 @@ void bvals_grav(DomainS *pD)
   if (pGrid->Nx[0] > 1){
 
 #ifdef MPI_PARALLEL
-
-    cnt = nghost*(pGrid->Nx[1])*(pGrid->Nx[2]);
+    /* start non-blocking receives from and sends to L and R Grids */
+    for (n=0; n<2; n++)
+      if (pP->recv_rq[0][n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->recv_rq[0][n]));
+    for (n=0; n<2; n++)
+      if (pP->send_rq[0][n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->send_rq[0][n]));
 
 /* MPI blocks to both left and right */
     if (pGrid->rx1_Gid >= 0 && pGrid->lx1_Gid >= 0) {
 
-      /* Post non-blocking receives for data from L and R Grids */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_Gid,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_Gid,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data L and R */
-      pack_Phi_ix1(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_Gid,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
-      pack_Phi_ox1(pGrid);
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_Gid,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
-      /* check non-blocking sends have completed. */
-      ierr = MPI_Waitall(2, send_rq, MPI_STATUS_IGNORE);
-
-      /* check non-blocking receives and unpack data in any order. */
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_Phi_ix1(pGrid);
-      if (mIndex == 1) unpack_Phi_ox1(pGrid);
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_Phi_ix1(pGrid);
-      if (mIndex == 1) unpack_Phi_ox1(pGrid);
+      /* wait for non-blocking receives and sends to complete. */
+      ierr = MPI_Waitall(2, pP->recv_rq[0], MPI_STATUSES_IGNORE);
+      ierr = MPI_Waitall(2, pP->send_rq[0], MPI_STATUSES_IGNORE);
 
     }
 
 /* Physical boundary on left, MPI block on right */
     if (pGrid->rx1_Gid >= 0 && pGrid->lx1_Gid < 0) {
 
-      /* Post non-blocking receive for data from R Grid */
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_Gid,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data R */
-      pack_Phi_ox1(pGrid);
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx1_Gid,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
       /* set physical boundary */
       (*(pD->ix1_GBCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[1]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from R and unpack data */
-      ierr = MPI_Wait(&(recv_rq[1]), MPI_STATUS_IGNORE);
-      unpack_Phi_ox1(pGrid);
+      /* wait for non-blocking receive from and send to R */
+      ierr = MPI_Wait(&(pP->recv_rq[0][1]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[0][1]), MPI_STATUS_IGNORE);
 
     }
 
 /* MPI block on left, Physical boundary on right */
     if (pGrid->rx1_Gid < 0 && pGrid->lx1_Gid >= 0) {
 
-      /* Post non-blocking receive for data from L grid */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_Gid,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-
-      /* pack and send data L */
-      pack_Phi_ix1(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx1_Gid,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
       /* set physical boundary */
       (*(pD->ox1_GBCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[0]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from L and unpack data */
-      ierr = MPI_Wait(&(recv_rq[0]), MPI_STATUS_IGNORE);
-      unpack_Phi_ix1(pGrid);
+      /* wait for non-blocking receive from and send to L */
+      ierr = MPI_Wait(&(pP->recv_rq[0][0]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[0][0]), MPI_STATUS_IGNORE);
 
     }
 #endif /* MPI_PARALLEL */
@@ -208,85 +167,44 @@ void bvals_grav(DomainS *pD)
   if (pGrid->Nx[1] > 1){
 
 #ifdef MPI_PARALLEL
-
-    cnt = (pGrid->Nx[0] + 2*nghost)*nghost*(pGrid->Nx[2]);
+    /* start non-blocking receives from and sends to L and R Grids */
+    for (n=0; n<2; n++)
+      if (pP->recv_rq[1][n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->recv_rq[1][n]));
+    for (n=0; n<2; n++)
+      if (pP->send_rq[1][n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->send_rq[1][n]));
 
 /* MPI blocks to both left and right */
     if (pGrid->rx2_Gid >= 0 && pGrid->lx2_Gid >= 0) {
 
-      /* Post non-blocking receives for data from L and R Grids */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_Gid,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_Gid,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data L and R */
-      pack_Phi_ix2(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_Gid,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
-      pack_Phi_ox2(pGrid);
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_Gid,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
-      /* check non-blocking sends have completed. */
-      ierr = MPI_Waitall(2, send_rq, MPI_STATUS_IGNORE);
-
-      /* check non-blocking receives and unpack data in any order. */
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_Phi_ix2(pGrid);
-      if (mIndex == 1) unpack_Phi_ox2(pGrid);
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_Phi_ix2(pGrid);
-      if (mIndex == 1) unpack_Phi_ox2(pGrid);
+      /* wait for non-blocking receives and sends to complete. */
+      ierr = MPI_Waitall(2, pP->recv_rq[1], MPI_STATUSES_IGNORE);
+      ierr = MPI_Waitall(2, pP->send_rq[1], MPI_STATUSES_IGNORE);
 
     }
 
 /* Physical boundary on left, MPI block on right */
     if (pGrid->rx2_Gid >= 0 && pGrid->lx2_Gid < 0) {
 
-      /* Post non-blocking receive for data from R Grid */
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_Gid,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data R */
-      pack_Phi_ox2(pGrid);
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx2_Gid,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
       /* set physical boundary */
       (*(pD->ix2_GBCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[1]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from R and unpack data */
-      ierr = MPI_Wait(&(recv_rq[1]), MPI_STATUS_IGNORE);
-      unpack_Phi_ox2(pGrid);
+      /* wait for non-blocking receive from and send to R */
+      ierr = MPI_Wait(&(pP->recv_rq[1][1]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[1][1]), MPI_STATUS_IGNORE);
 
     }
 
 /* MPI block on left, Physical boundary on right */
     if (pGrid->rx2_Gid < 0 && pGrid->lx2_Gid >= 0) {
 
-      /* Post non-blocking receive for data from L grid */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_Gid,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-
-      /* pack and send data L */
-      pack_Phi_ix2(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx2_Gid,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
       /* set physical boundary */
       (*(pD->ox2_GBCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[0]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from L and unpack data */
-      ierr = MPI_Wait(&(recv_rq[0]), MPI_STATUS_IGNORE);
-      unpack_Phi_ix2(pGrid);
+      /* wait for non-blocking receive from and send to L */
+      ierr = MPI_Wait(&(pP->recv_rq[1][0]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[1][0]), MPI_STATUS_IGNORE);
 
     }
 #endif /* MPI_PARALLEL */
@@ -316,85 +234,45 @@ void bvals_grav(DomainS *pD)
   if (pGrid->Nx[2] > 1){
 
 #ifdef MPI_PARALLEL
-
-    cnt = (pGrid->Nx[0] + 2*nghost)*(pGrid->Nx[1] + 2*nghost)*nghost;
+    /* start non-blocking receives from and sends to L and R Grids */
+    for (n=0; n<2; n++)
+      if (pP->recv_rq[2][n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->recv_rq[2][n]));
+    for (n=0; n<2; n++)
+      if (pP->send_rq[2][n] != MPI_REQUEST_NULL)
+        ierr = MPI_Start(&(pP->send_rq[2][n]));
 
 /* MPI blocks to both left and right */
     if (pGrid->rx3_Gid >= 0 && pGrid->lx3_Gid >= 0) {
 
-      /* Post non-blocking receives for data from L and R Grids */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_Gid,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_Gid,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data L and R */
-      pack_Phi_ix3(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_Gid,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
-      pack_Phi_ox3(pGrid);
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_Gid,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
-      /* check non-blocking sends have completed. */
-      ierr = MPI_Waitall(2, send_rq, MPI_STATUS_IGNORE);
-
-      /* check non-blocking receives and unpack data in any order. */
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_Phi_ix3(pGrid);
-      if (mIndex == 1) unpack_Phi_ox3(pGrid);
-      ierr = MPI_Waitany(2,recv_rq,&mIndex,MPI_STATUS_IGNORE);
-      if (mIndex == 0) unpack_Phi_ix3(pGrid);
-      if (mIndex == 1) unpack_Phi_ox3(pGrid);
+      /* wait for non-blocking receives and sends to complete. */
+      ierr = MPI_Waitall(2, pP->recv_rq[2], MPI_STATUSES_IGNORE);
+      ierr = MPI_Waitall(2, pP->send_rq[2], MPI_STATUSES_IGNORE);
 
     }
 
 /* Physical boundary on left, MPI block on right */
     if (pGrid->rx3_Gid >= 0 && pGrid->lx3_Gid < 0) {
 
-      /* Post non-blocking receive for data from R Grid */
-      ierr = MPI_Irecv(&(recv_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_Gid,RtoL_tag,
-        pD->Comm_Domain, &(recv_rq[1]));
-
-      /* pack and send data R */
-      pack_Phi_ox3(pGrid);
-      ierr = MPI_Isend(&(send_buf[1][0]),cnt,MPI_DOUBLE,pGrid->rx3_Gid,LtoR_tag,
-        pD->Comm_Domain, &(send_rq[1]));
-
       /* set physical boundary */
       (*(pD->ix3_GBCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[1]), MPI_STATUS_IGNORE);
-
-      /* wait on non-blocking receive from R and unpack data */
-      ierr = MPI_Wait(&(recv_rq[1]), MPI_STATUS_IGNORE);
-      unpack_Phi_ox3(pGrid);
+      /* wait for non-blocking receive from and send to R */
+      ierr = MPI_Wait(&(pP->recv_rq[2][1]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[2][1]), MPI_STATUS_IGNORE);
 
     }
 
 /* MPI block on left, Physical boundary on right */
     if (pGrid->rx3_Gid < 0 && pGrid->lx3_Gid >= 0) {
 
-      /* Post non-blocking receive for data from L grid */
-      ierr = MPI_Irecv(&(recv_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_Gid,LtoR_tag,
-        pD->Comm_Domain, &(recv_rq[0]));
-
-      /* pack and send data L */
-      pack_Phi_ix3(pGrid);
-      ierr = MPI_Isend(&(send_buf[0][0]),cnt,MPI_DOUBLE,pGrid->lx3_Gid,RtoL_tag,
-        pD->Comm_Domain, &(send_rq[0]));
-
       /* set physical boundary */
       (*(pD->ox3_GBCFun))(pGrid);
 
-      /* check non-blocking send has completed. */
-      ierr = MPI_Wait(&(send_rq[0]), MPI_STATUS_IGNORE);
+      /* wait for non-blocking receive from and send to L */
+      ierr = MPI_Wait(&(pP->recv_rq[2][0]), MPI_STATUS_IGNORE);
+      ierr = MPI_Wait(&(pP->send_rq[2][0]), MPI_STATUS_IGNORE);
 
-      /* wait on non-blocking receive from L and unpack data */
-      ierr = MPI_Wait(&(recv_rq[0]), MPI_STATUS_IGNORE);
-      unpack_Phi_ix3(pGrid);
     }
 #endif /* MPI_PARALLEL */
 
@@ -412,7 +290,8 @@ void bvals_grav(DomainS *pD)
 /*----------------------------------------------------------------------------*/
 /*! \fn void bvals_grav_init(MeshS *pM) 
  *  \brief Sets function pointers for physical boundaries during
- *   initialization, allocates memory for send/receive buffers with MPI
+ *   initialization, and with MPI builds the communication plan (persistent
+ *   requests) of every Domain.
  */
 
 void bvals_grav_init(MeshS *pM)
@@ -421,8 +300,20 @@ void bvals_grav_init(MeshS *pM)
   DomainS *pD;
   int i,nl,nd,irefine;
 #ifdef MPI_PARALLEL
-  int myL,myM,myN,l,m,n,nx1t,nx2t,nx3t,size;
-  int x1cnt=0, x2cnt=0, x3cnt=0; /* Number of words passed in x1/x2/x3-dir. */
+  int myL,myM,myN,n,dir,id,ierr;
+  GravPlanS *pP;
+  MPI_Datatype type;
+#endif /* MPI_PARALLEL */
+
+#ifdef MPI_PARALLEL
+/* Allocate one communication plan per Domain with an active Grid */
+  for (nl=0, n=0; nl<(pM->NLevels); nl++)
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++)
+      if (pM->Domain[nl][nd].Grid != NULL) n++;
+  if (n > 0) {
+    if((Plan = (GravPlanS*)calloc_1d_array(n,sizeof(GravPlanS))) == NULL)
+      ath_error("[bvals_grav_init]: Failed to allocate communication plans\n");
+  }
 #endif /* MPI_PARALLEL */
 
 /* Cycle through all the Domains that have active Grids on this proc */
@@ -453,7 +344,8 @@ void bvals_grav_init(MeshS *pM)
 
 /* Domain is at L-edge of root Domain */
         } else {
-#ifndef SELF_GRAVITY_USING_FFT_OBC
+#if !defined(SELF_GRAVITY_USING_FFT_OBC) && \
+    !defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
           switch(pM->BCFlag_ix1){
 
           case 1: /* Reflecting */
@@ -481,7 +373,7 @@ void bvals_grav_init(MeshS *pM)
             ath_error("[bvals_grav_init]: BCFlag_ix1 = %d unknown\n",
             pM->BCFlag_ix1);
           }
-#else /* SELF_GRAVITY_USING_FFT_OBC */
+#else /* SELF_GRAVITY_USING_FFT_OBC || SELF_GRAVITY_USING_FFT_MULTIPOLE */
         pD->ix1_GBCFun = obc_fft_Phi_ix1;
 #endif
         }
@@ -497,7 +389,8 @@ void bvals_grav_init(MeshS *pM)
 
 /* Domain is at R-edge of root Domain */
         } else {
-#ifndef SELF_GRAVITY_USING_FFT_OBC
+#if !defined(SELF_GRAVITY_USING_FFT_OBC) && \
+    !defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
           switch(pM->BCFlag_ox1){
 
           case 1: /* Reflecting */
@@ -525,7 +418,7 @@ void bvals_grav_init(MeshS *pM)
             ath_error("[bvals_grav_init]: BCFlag_ox1 = %d unknown\n",
             pM->BCFlag_ox1);
           }
-#else /* SELF_GRAVITY_USING_FFT_OBC */
+#else /* SELF_GRAVITY_USING_FFT_OBC || SELF_GRAVITY_USING_FFT_MULTIPOLE */
           pD->ox1_GBCFun = obc_fft_Phi_ox1;
 #endif
         }
@@ -546,7 +439,8 @@ void bvals_grav_init(MeshS *pM)
 
 /* Domain is at L-edge of root Domain */
         } else {
-#ifndef SELF_GRAVITY_USING_FFT_OBC
+#if !defined(SELF_GRAVITY_USING_FFT_OBC) && \
+    !defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
           switch(pM->BCFlag_ix2){
 
           case 1: /* Reflecting */
@@ -574,7 +468,7 @@ void bvals_grav_init(MeshS *pM)
             ath_error("[bvals_grav_init]: BCFlag_ix2 = %d unknown\n",
             pM->BCFlag_ix2);
           }
-#else /* SELF_GRAVITY_USING_FFT_OBC */
+#else /* SELF_GRAVITY_USING_FFT_OBC || SELF_GRAVITY_USING_FFT_MULTIPOLE */
           pD->ix2_GBCFun = obc_fft_Phi_ix2;
 #endif
         }
@@ -590,7 +484,8 @@ void bvals_grav_init(MeshS *pM)
 
 /* Domain is at R-edge of root Domain */
         } else {
-#ifndef SELF_GRAVITY_USING_FFT_OBC
+#if !defined(SELF_GRAVITY_USING_FFT_OBC) && \
+    !defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
           switch(pM->BCFlag_ox2){
 
           case 1: /* Reflecting */
@@ -618,7 +513,7 @@ void bvals_grav_init(MeshS *pM)
             ath_error("[bvals_grav_init]: BCFlag_ox2 = %d unknown\n",
             pM->BCFlag_ox2);
           }
-#else /* SELF_GRAVITY_USING_FFT_OBC */
+#else /* SELF_GRAVITY_USING_FFT_OBC || SELF_GRAVITY_USING_FFT_MULTIPOLE */
           pD->ox2_GBCFun = obc_fft_Phi_ox2;
 #endif
         }
@@ -639,7 +534,8 @@ void bvals_grav_init(MeshS *pM)
 
 /* Domain is at L-edge of root Domain */
         } else {
-#if defined(SELF_GRAVITY_USING_FFT_OBC) || defined(SELF_GRAVITY_USING_FFT_DISK)
+#if defined(SELF_GRAVITY_USING_FFT_OBC) || defined(SELF_GRAVITY_USING_FFT_DISK) \
+ || defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
           pD->ix3_GBCFun = obc_fft_Phi_ix3;
 #else
           switch(pM->BCFlag_ix3){
@@ -669,7 +565,7 @@ void bvals_grav_init(MeshS *pM)
             ath_error("[bvals_grav_init]: BCFlag_ix3 = %d unknown\n",
             pM->BCFlag_ix3);
           }
-#endif /* SELF_GRAVITY_USING_FFT_OBC || SELF_GRAVITY_USING_FFT_DISK*/
+#endif /* FFT_OBC || FFT_DISK || FFT_MULTIPOLE */
         }
       }
 
@@ -683,7 +579,8 @@ void bvals_grav_init(MeshS *pM)
 
 /* Domain is at R-edge of root Domain */
         } else {
-#if defined(SELF_GRAVITY_USING_FFT_OBC) || defined(SELF_GRAVITY_USING_FFT_DISK)
+#if defined(SELF_GRAVITY_USING_FFT_OBC) || defined(SELF_GRAVITY_USING_FFT_DISK) \
+ || defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
           pD->ox3_GBCFun = obc_fft_Phi_ox3;
 #else
           switch(pM->BCFlag_ox3){
@@ -713,80 +610,43 @@ void bvals_grav_init(MeshS *pM)
             ath_error("[bvals_grav_init]: BCFlag_ox3 = %d unknown\n",
             pM->BCFlag_ox3);
           }
-#endif /* SELF_GRAVITY_USING_FFT_OBC || SELF_GRAVITY_USING_FFT_DISK*/
+#endif /* FFT_OBC || FFT_DISK || FFT_MULTIPOLE */
         }
       }
     }
 
-/* Figure out largest size needed for send/receive buffers with MPI ----------*/
+/* Communication plan: persistent requests for every MPI boundary ------------*/
 
 #ifdef MPI_PARALLEL
-
-    for (n=0; n<(pD->NGrid[2]); n++){
-    for (m=0; m<(pD->NGrid[1]); m++){
-      for (l=0; l<(pD->NGrid[0]); l++){
-
-/* x1cnt is surface area of x1 faces */
-        if(pD->NGrid[0] > 1){
-          nx2t = pD->GData[n][m][l].Nx[1];
-          if(nx2t > 1) nx2t += 1;
-
-          nx3t = pD->GData[n][m][l].Nx[2];
-          if(nx3t > 1) nx3t += 1;
-
-          if(nx2t*nx3t > x1cnt) x1cnt = nx2t*nx3t;
-        }
-
-/* x2cnt is surface area of x2 faces */
-        if(pD->NGrid[1] > 1){
-          nx1t = pD->GData[n][m][l].Nx[0];
-          if(nx1t > 1) nx1t += 2*nghost;
-
-          nx3t = pD->GData[n][m][l].Nx[2];
-          if(nx3t > 1) nx3t += 1;
-
-          if(nx1t*nx3t > x2cnt) x2cnt = nx1t*nx3t;
-        }
-
-/* x3cnt is surface area of x3 faces */
-        if(pD->NGrid[2] > 1){
-          nx1t = pD->GData[n][m][l].Nx[0];
-          if(nx1t > 1) nx1t += 2*nghost;
-
-          nx2t = pD->GData[n][m][l].Nx[1];
-          if(nx2t > 1) nx2t += 2*nghost;
-
-          if(nx1t*nx2t > x3cnt) x3cnt = nx1t*nx2t;
-        }
+    pP = &(Plan[NPlan++]);
+    pP->pD = pD;
+    for (dir=0; dir<3; dir++) {
+      for (n=0; n<2; n++) {
+        pP->send_rq[dir][n] = MPI_REQUEST_NULL;
+        pP->recv_rq[dir][n] = MPI_REQUEST_NULL;
+        if (pG->Nx[dir] == 1) continue;
+        if (dir == 0) id = (n == 0) ? pG->lx1_Gid : pG->rx1_Gid;
+        if (dir == 1) id = (n == 0) ? pG->lx2_Gid : pG->rx2_Gid;
+        if (dir == 2) id = (n == 0) ? pG->lx3_Gid : pG->rx3_Gid;
+        if (id < 0) continue;
+
+        type = phi_type(pG,dir,n,1);
+        ierr = MPI_Recv_init(&(pG->Phi[0][0][0]),1,type,id,
+          (n == 0) ? LtoR_tag : RtoL_tag, pD->Comm_Domain,
+          &(pP->recv_rq[dir][n]));
+        ierr = MPI_Type_free(&type);
+
+        type = phi_type(pG,dir,n,0);
+        ierr = MPI_Send_init(&(pG->Phi[0][0][0]),1,type,id,
+          (n == 0) ? RtoL_tag : LtoR_tag, pD->Comm_Domain,
+          &(pP->send_rq[dir][n]));
+        ierr = MPI_Type_free(&type);
       }
-    }}
+    }
 #endif /* MPI_PARALLEL */
 
   }}}  /* End loop over all Domains with active Grids -----------------------*/
 
-#ifdef MPI_PARALLEL
-/* Allocate memory for send/receive buffers and MPI_Requests */
-
-  size = x1cnt > x2cnt ? x1cnt : x2cnt;
-  size = x3cnt >  size ? x3cnt : size;
-
-  size *= nghost; /* Multiply by the third dimension */
-
-  if (size > 0) {
-    if((send_buf = (double**)calloc_2d_array(2,size,sizeof(double))) == NULL)
-      ath_error("[bvals_init]: Failed to allocate send buffer\n");
-
-    if((recv_buf = (double**)calloc_2d_array(2,size,sizeof(double))) == NULL)
-      ath_error("[bvals_init]: Failed to allocate recv buffer\n");
-  }
-
-  if((recv_rq = (MPI_Request*) calloc_1d_array(2,sizeof(MPI_Request))) == NULL)
-    ath_error("[bvals_init]: Failed to allocate recv MPI_Request array\n");
-  if((send_rq = (MPI_Request*) calloc_1d_array(2,sizeof(MPI_Request))) == NULL)
-    ath_error("[bvals_init]: Failed to allocate send MPI_Request array\n");
-
-#endif /* MPI_PARALLEL */
-
   return;
 }
 
@@ -1262,316 +1122,60 @@ static void ProlongateLater(GridS *pGrid)
   return;
 }
 
-#ifdef MPI_PARALLEL  /* This ifdef wraps the next 12 funs; ~550 lines */
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_Phi_ix1(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Inner x1 boundary */
-
-static void pack_Phi_ix1(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pSnd;
-  pSnd = (double*)&(send_buf[0][0]);
-
-/* Pack only Phi into send buffer */
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=is; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->Phi[k][j][i];
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_Phi_ox1(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Outer x1 boundary */
-
-static void pack_Phi_ox1(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pSnd;
-  pSnd = (double*)&(send_buf[1][0]);
-
-/* Pack only Phi into send buffer */
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=ie-(nghost-1); i<=ie; i++){
-        *(pSnd++) = pG->Phi[k][j][i];
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_Phi_ix2(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Inner x2 boundary */
-
-static void pack_Phi_ix2(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pSnd;
-  pSnd = (double*)&(send_buf[0][0]);
-
-/* Pack only Phi into send buffer */
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=js+(nghost-1); j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->Phi[k][j][i];
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_Phi_ox2(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Outer x2 boundary */
-
-static void pack_Phi_ox2(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pSnd;
-  pSnd = (double*)&(send_buf[1][0]);
-
-/* Pack only Phi into send buffer */
-
-  for (k=ks; k<=ke; k++){
-    for (j=je-(nghost-1); j<=je; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->Phi[k][j][i];
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_Phi_ix3(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Inner x3 boundary */
-
-static void pack_Phi_ix3(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pSnd;
-  pSnd = (double*)&(send_buf[0][0]);
-
-/* Pack only Phi into send buffer */
-
-  for (k=ks; k<=ks+(nghost-1); k++){
-    for (j=js-nghost; j<=je+nghost; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->Phi[k][j][i];
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void pack_Phi_ox3(GridS *pG)
- *  \brief PACK boundary conditions for MPI_Isend, Outer x3 boundary */
-
-static void pack_Phi_ox3(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pSnd;
-  pSnd = (double*)&(send_buf[1][0]);
-
-/* Pack only Phi into send buffer */
-
-  for (k=ke-(nghost-1); k<=ke; k++){
-    for (j=js-nghost; j<=je+nghost; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->Phi[k][j][i];
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_Phi_ix1(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Inner x1 boundary */
-
-static void unpack_Phi_ix1(GridS *pG)
-{
-  int is = pG->is;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[0][0]);
-
-/* Manually unpack the data from the receive buffer */
-
-  for (k=ks; k<=ke; k++){
-//    for (j=js; j<=js; j++){
-//MODIFIED BY HAO GONG
-    for (j=js; j<=je; j++){
-      for (i=is-nghost; i<=is-1; i++){
-        pG->Phi[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_Phi_ox1(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Outer x1 boundary */
-
-static void unpack_Phi_ox1(GridS *pG)
-{
-  int ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[1][0]);
-
-/* Manually unpack the data from the receive buffer */
-
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=ie+1; i<=ie+nghost; i++){
-        pG->Phi[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  return;
-}
-
+#ifdef MPI_PARALLEL  /* This ifdef wraps the next 2 funs; ~60 lines */
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_Phi_ix2(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Inner x2 boundary */
-
-static void unpack_Phi_ix2(GridS *pG)
+/*! \fn static MPI_Datatype phi_type(const GridS *pG, const int dir,
+ *                                   const int side, const int recv)
+ *  \brief Committed subarray datatype of pG->Phi for the ghost zones received
+ *   (recv=1) or active zones sent (recv=0) at the inner (side=0) or outer
+ *   (side=1) boundary in direction dir.  Directions before dir include the
+ *   ghost zones already set, directions after dir only the active zones. */
+
+static MPI_Datatype phi_type(const GridS *pG, const int dir, const int side,
+                             const int recv)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[0][0]);
-
-/* Manually unpack the data from the receive buffer */
-
-  for (k=ks; k<=ke; k++){
-    for (j=js-nghost; j<=js-1; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        pG->Phi[k][j][i] = *(pRcv++);
-      }
+  int sizes[3],subsizes[3],starts[3],lo,hi,s,e,n,ierr;
+  MPI_Datatype type;
+
+  for (n=0; n<3; n++) {
+    s = (n == 0) ? pG->is : ((n == 1) ? pG->js : pG->ks);
+    e = (n == 0) ? pG->ie : ((n == 1) ? pG->je : pG->ke);
+    sizes[2-n] = (pG->Nx[n] > 1) ? pG->Nx[n] + 2*nghost : 1;
+    if (n < dir && pG->Nx[n] > 1) {
+      lo = s - nghost;
+      hi = e + nghost;
+    } else if (n == dir && recv) {
+      lo = (side == 0) ? s - nghost : e + 1;
+      hi = (side == 0) ? s - 1 : e + nghost;
+    } else if (n == dir) {
+      lo = (side == 0) ? s : e - (nghost-1);
+      hi = (side == 0) ? s + (nghost-1) : e;
+    } else {
+      lo = s;
+      hi = e;
     }
+    subsizes[2-n] = hi - lo + 1;
+    starts[2-n] = lo;
   }
 
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_Phi_ox2(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Outer x2 boundary */
-
-static void unpack_Phi_ox2(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int je = pG->je;
-  int ks = pG->ks, ke = pG->ke;
-  int i,j,k;
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[1][0]);
-
-/* Manually unpack the data from the receive buffer */
+  ierr = MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C,
+                                  MPI_DOUBLE, &type);
+  ierr = MPI_Type_commit(&type);
 
-  for (k=ks; k<=ke; k++){
-    for (j=je+1; j<=je+nghost; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        pG->Phi[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  return;
-}
-
-/*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_Phi_ix3(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Inner x3 boundary */
-
-static void unpack_Phi_ix3(GridS *pG)
-{
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ks = pG->ks;
-  int i,j,k;
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[0][0]);
-
-/* Manually unpack the data from the receive buffer */
-
-  for (k=ks-nghost; k<=ks-1; k++){
-    for (j=js-nghost; j<=je+nghost; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        pG->Phi[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  return;
+  return type;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void unpack_Phi_ox3(GridS *pG)
- *  \brief UNPACK boundary conditions after MPI_Irecv, Outer x3 boundary */
+/*! \fn static GravPlanS *get_plan(DomainS *pD)
+ *  \brief Returns the communication plan of Domain pD */
 
-static void unpack_Phi_ox3(GridS *pG)
+static GravPlanS *get_plan(DomainS *pD)
 {
-  int is = pG->is, ie = pG->ie;
-  int js = pG->js, je = pG->je;
-  int ke = pG->ke;
-  int i,j,k;
-  double *pRcv;
-  pRcv = (double*)&(recv_buf[1][0]);
+  int n;
 
-/* Manually unpack the data from the receive buffer */
-
-  for (k=ke+1; k<=ke+nghost; k++){
-    for (j=js-nghost; j<=je+nghost; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        pG->Phi[k][j][i] = *(pRcv++);
-      }
-    }
-  }
-
-  return;
+  for (n=0; n<NPlan; n++) if (Plan[n].pD == pD) return &(Plan[n]);
+  ath_error("[bvals_grav]: no communication plan for Domain\n");
+  return NULL;
 }
 
 #endif /* MPI_PARALLEL */
@@ -54,6 +54,10 @@ void selfg_fft_disk_3d_init(MeshS *pM);
 void selfg_fft_obc_3d(DomainS *pD);
 void selfg_fft_obc_3d_init(MeshS *pM);
 #endif /* FFT_ENABLED SELF_GRAVITY_USING_FFT_OBC */
+#if defined(FFT_ENABLED) && defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
+void selfg_fft_multipole_3d(DomainS *pD);
+void selfg_fft_multipole_3d_init(MeshS *pM);
+#endif /* FFT_ENABLED SELF_GRAVITY_USING_FFT_MULTIPOLE */
 
 
 #endif /* SELF_GRAVITY */
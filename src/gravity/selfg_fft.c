@@ -72,15 +72,15 @@ void selfg_fft_1d(DomainS *pD)
 
   pG->Phi[ks][js][is] = 0.0;
   for (i=is; i<=ie; i++) {
-    drho = (pG->U[ks][js][i].d - grav_mean_rho);
+    drho = (UVAR(pG,ks,js,i,d) - grav_mean_rho);
     pG->Phi[ks][js][is] += ((float)(i-is+1))*four_pi_G*dx_sq*drho;
   }
   pG->Phi[ks][js][is] /= (float)(pG->Nx[0]);
 
-  drho = (pG->U[ks][js][is].d - grav_mean_rho);
+  drho = (UVAR(pG,ks,js,is,d) - grav_mean_rho);
   pG->Phi[ks][js][is+1] = 2.0*pG->Phi[ks][js][is] + four_pi_G*dx_sq*drho;
   for (i=is+2; i<=ie; i++) {
-    drho = (pG->U[ks][js][i-1].d - grav_mean_rho);
+    drho = (UVAR(pG,ks,js,i-1,d) - grav_mean_rho);
     pG->Phi[ks][js][i] = four_pi_G*dx_sq*drho 
       + 2.0*pG->Phi[ks][js][i-1] - pG->Phi[ks][js][i-2];
   }
@@ -145,7 +145,7 @@ void selfg_fft_2d_xy(DomainS *pD)
     for (i=is-nghost; i<=ie+nghost; i++){
       pG->Phi_old[ks][j][i] = pG->Phi[ks][j][i];
 #ifdef SHEARING_BOX
-      RollDen[ks][i][j] = pG->U[ks][j][i].d;
+      RollDen[ks][i][j] = UVAR(pG,ks,j,i,d);
 #endif
     }
   }
@@ -163,7 +163,7 @@ void selfg_fft_2d_xy(DomainS *pD)
 #ifdef SHEARING_BOX
         four_pi_G*(RollDen[ks][i][j] - grav_mean_rho);
 #else
-        four_pi_G*(pG->U[ks][j][i].d - grav_mean_rho);
+        four_pi_G*(UVAR(pG,ks,j,i,d) - grav_mean_rho);
 #endif
       work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1] = 0.0;
     }
@@ -291,7 +291,7 @@ void selfg_fft_2d(DomainS *pD)
   for (j=js; j<=je; j++){
     for (i=is; i<=ie; i++){
       work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] =
-        four_pi_G*(pG->U[ks][j][i].d - grav_mean_rho);
+        four_pi_G*(UVAR(pG,ks,j,i,d) - grav_mean_rho);
       work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1] = 0.0;
     }
   }
@@ -363,6 +363,8 @@ void selfg_fft_3d(DomainS *pD)
   int k, ks = pG->ks, ke = pG->ke;
   Real dx1sq=(pG->dx1*pG->dx1),dx2sq=(pG->dx2*pG->dx2),dx3sq=(pG->dx3*pG->dx3);
   Real dkx,dky,dkz,pcoeff;
+  ath_fft_real *rwork = (ath_fft_real *)work;
+  int rnx3 = fplan3d->rnx3, cnx3 = fplan3d->cnx3, cks = fplan3d->cks;
 
 #ifdef SHEARING_BOX
   Real qomt,Lx,Ly,dt;
@@ -398,7 +400,7 @@ void selfg_fft_3d(DomainS *pD)
     for (i=is-nghost; i<=ie+nghost; i++){
       pG->Phi_old[k][j][i] = pG->Phi[k][j][i];
 #ifdef SHEARING_BOX
-      RollDen[k][i][j] = pG->U[k][j][i].d;
+      RollDen[k][i][j] = UVAR(pG,k,j,i,d);
 #endif
     }
   }}
@@ -413,13 +415,12 @@ void selfg_fft_3d(DomainS *pD)
   for (k=ks; k<=ke; k++){
   for (j=js; j<=je; j++){
     for (i=is; i<=ie; i++){
-      work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = 
+      rwork[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],rnx3)] = 
 #ifdef SHEARING_BOX
         RollDen[k][i][j] - grav_mean_rho;
 #else
-        pG->U[k][j][i].d - grav_mean_rho;
+        UVAR(pG,k,j,i,d) - grav_mean_rho;
 #endif
-      work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] = 0.0;
     }
   }}
 
@@ -434,7 +435,9 @@ void selfg_fft_3d(DomainS *pD)
      
 /* Compute potential in Fourier space.  Multiple loops are used to avoid divide
  * by zero at i=is,j=js,k=ks, and to avoid if statement in loop   */
-/* To compute kx,ky,kz, note that indices relative to whole Domain are needed */
+/* To compute kx,ky,kz, note that indices relative to whole Domain are needed.
+ * Only the half spectrum k3=0..Nx3/2 is stored; the local part of it starts
+ * at k3=cks and has cnx3 entries */
 
   dkx = 2.0*PI/(double)(pD->Nx[0]);
   dky = 2.0*PI/(double)(pD->Nx[1]);
@@ -446,73 +449,73 @@ void selfg_fft_3d(DomainS *pD)
   kxtdx  = (ip+qomt*Lx/Ly*jp)*dkx;
 #endif
 
-  if ((pG->Disp[2])==0 && (pG->Disp[1])==0 && (pG->Disp[0])==0) {
-    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = 0.0;
-    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] = 0.0;
+  if ((pG->Disp[1])==0 && (pG->Disp[0])==0 && cks==0) {
+    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],cnx3)][0] = 0.0;
+    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],cnx3)][1] = 0.0;
   } else {
 #ifdef SHEARING_BOX
     pcoeff = 1.0/(((2.0*cos( kxtdx           )-2.0)/dx1sq) +
                   ((2.0*cos((pG->Disp[1])*dky)-2.0)/dx2sq) +
-                  ((2.0*cos((pG->Disp[2])*dkz)-2.0)/dx3sq));
+                  ((2.0*cos((        cks)*dkz)-2.0)/dx3sq));
 #else
     pcoeff = 1.0/(((2.0*cos((pG->Disp[0])*dkx)-2.0)/dx1sq) +
                   ((2.0*cos((pG->Disp[1])*dky)-2.0)/dx2sq) +
-                  ((2.0*cos((pG->Disp[2])*dkz)-2.0)/dx3sq));
+                  ((2.0*cos((        cks)*dkz)-2.0)/dx3sq));
 #endif
-    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] *= pcoeff;
-    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] *= pcoeff;
+    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],cnx3)][0] *= pcoeff;
+    work[F3DI(0,0,0,pG->Nx[0],pG->Nx[1],cnx3)][1] *= pcoeff;
   }
 
 
-  for (k=ks+1; k<=ke; k++){
+  for (k=1; k<cnx3; k++){
 #ifdef SHEARING_BOX
     pcoeff = 1.0/(((2.0*cos( kxtdx                    )-2.0)/dx1sq) +
                   ((2.0*cos((        pG->Disp[1] )*dky)-2.0)/dx2sq) +
-                  ((2.0*cos(( (k-ks)+pG->Disp[2] )*dkz)-2.0)/dx3sq));
+                  ((2.0*cos((      k+cks         )*dkz)-2.0)/dx3sq));
 #else
     pcoeff = 1.0/(((2.0*cos((        pG->Disp[0] )*dkx)-2.0)/dx1sq) +
                   ((2.0*cos((        pG->Disp[1] )*dky)-2.0)/dx2sq) +
-                  ((2.0*cos(( (k-ks)+pG->Disp[2] )*dkz)-2.0)/dx3sq));
+                  ((2.0*cos((      k+cks         )*dkz)-2.0)/dx3sq));
 #endif
-    work[F3DI(0,0,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] *= pcoeff;
-    work[F3DI(0,0,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] *= pcoeff;
+    work[F3DI(0,0,k,pG->Nx[0],pG->Nx[1],cnx3)][0] *= pcoeff;
+    work[F3DI(0,0,k,pG->Nx[0],pG->Nx[1],cnx3)][1] *= pcoeff;
   }
 
   for (j=js+1; j<=je; j++){
-    for (k=ks; k<=ke; k++){
+    for (k=0; k<cnx3; k++){
 #ifdef SHEARING_BOX
       jp=KCOMP(j-js ,pG->Disp[1],pD->Nx[1]);
       kxtdx  = (ip+qomt*Lx/Ly*jp)*dkx;
       pcoeff = 1.0/(((2.0*cos( kxtdx                    )-2.0)/dx1sq) +
                     ((2.0*cos(( (j-js)+pG->Disp[1] )*dky)-2.0)/dx2sq) +
-                    ((2.0*cos(( (k-ks)+pG->Disp[2] )*dkz)-2.0)/dx3sq));
+                    ((2.0*cos((      k+cks         )*dkz)-2.0)/dx3sq));
 #else
       pcoeff = 1.0/(((2.0*cos((        pG->Disp[0] )*dkx)-2.0)/dx1sq) +
                     ((2.0*cos(( (j-js)+pG->Disp[1] )*dky)-2.0)/dx2sq) +
-                    ((2.0*cos(( (k-ks)+pG->Disp[2] )*dkz)-2.0)/dx3sq));
+                    ((2.0*cos((      k+cks         )*dkz)-2.0)/dx3sq));
 #endif
-      work[F3DI(0,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] *= pcoeff;
-      work[F3DI(0,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] *= pcoeff;
+      work[F3DI(0,j-js,k,pG->Nx[0],pG->Nx[1],cnx3)][0] *= pcoeff;
+      work[F3DI(0,j-js,k,pG->Nx[0],pG->Nx[1],cnx3)][1] *= pcoeff;
     }
   }
 
   for (i=is+1; i<=ie; i++){
   for (j=js; j<=je; j++){
-    for (k=ks; k<=ke; k++){
+    for (k=0; k<cnx3; k++){
 #ifdef SHEARING_BOX
       ip=KCOMP(i-is ,pG->Disp[0],pD->Nx[0]);
       jp=KCOMP(j-js ,pG->Disp[1],pD->Nx[1]);
       kxtdx  = (ip+qomt*Lx/Ly*jp)*dkx;
       pcoeff = 1.0/(((2.0*cos( kxtdx                    )-2.0)/dx1sq) +
                     ((2.0*cos(( (j-js)+pG->Disp[1] )*dky)-2.0)/dx2sq) +
-                    ((2.0*cos(( (k-ks)+pG->Disp[2] )*dkz)-2.0)/dx3sq));
+                    ((2.0*cos((      k+cks         )*dkz)-2.0)/dx3sq));
 #else
       pcoeff = 1.0/(((2.0*cos(( (i-is)+pG->Disp[0] )*dkx)-2.0)/dx1sq) +
                     ((2.0*cos(( (j-js)+pG->Disp[1] )*dky)-2.0)/dx2sq) +
-                    ((2.0*cos(( (k-ks)+pG->Disp[2] )*dkz)-2.0)/dx3sq));
+                    ((2.0*cos((      k+cks         )*dkz)-2.0)/dx3sq));
 #endif
-      work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] *= pcoeff;
-      work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] *= pcoeff;
+      work[F3DI(i-is,j-js,k,pG->Nx[0],pG->Nx[1],cnx3)][0] *= pcoeff;
+      work[F3DI(i-is,j-js,k,pG->Nx[0],pG->Nx[1],cnx3)][1] *= pcoeff;
     }
   }}
 
@@ -526,11 +529,11 @@ void selfg_fft_3d(DomainS *pD)
     for (i=is; i<=ie; i++){
 #ifdef SHEARING_BOX
       UnRollPhi[k][i][j] = 
-       four_pi_G*work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0]
+       four_pi_G*rwork[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],rnx3)]
         / bplan3d->gcnt;
 #else
       pG->Phi[k][j][i] =
-       four_pi_G*work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0]
+       four_pi_G*rwork[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],rnx3)]
         / bplan3d->gcnt;
 #endif
     }
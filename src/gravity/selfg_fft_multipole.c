@@ -0,0 +1,411 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file selfg_fft_multipole.c
+ *  \brief Contains functions to solve Poisson's equation for self-gravity in
+ *   3D with OPEN (isolated) BCs, using a multipole expansion of the density
+ *   for the boundary potential and sine transforms for the interior.
+ *
+ *   The potential in the first layer of ghost cells is computed from a
+ *   multipole expansion (to order <gravity>/mpole_lmax, default 8) of the
+ *   mass in the Domain about its center.  Poisson's equation with the
+ *   7-point Laplacian is then solved in the interior with these Dirichlet
+ *   values, which are moved to the RHS so the remaining problem has zero
+ *   boundary values and is diagonalized by a sine transform (DST-I) along
+ *   each axis.  This needs one forward and one backward real transform of
+ *   the Domain, rather than the 8 complex transforms of selfg_fft_obc() (the
+ *   equivalent of zero-padding to twice the size in each dimension), and
+ *   half the FFT memory.
+ *
+ *   The expansion converges only where the potential is evaluated outside
+ *   all the mass, so the solver needs the mass well inside the Domain (as
+ *   for an isolated collapsing cloud); mass near the faces, and especially
+ *   near the corners, needs a larger lmax or selfg_fft_obc() instead.  Each
+ *   solve estimates the relative error of the expansion on the boundary as
+ *   the sum of |dm|*min(1,(r/rb)^(lmax+1)) over the total |dm|, where rb is
+ *   the distance from the center to the nearest ghost cell, and stops with
+ *   an error if it exceeds <gravity>/mpole_tol (default 1e-2).  A Domain
+ *   filled with mass (e.g. the Jeans test) fails this check.
+ *
+ *   This means to use these fns the code must be
+ *   - (1) configured with --with-gravity=fft_multipole --enable-fft
+ *   - (2) compiled with links to FFTW libraries (may need to edit Makeoptions)
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ *   - selfg_fft_multipole_3d() - 3D Poisson solver
+ *   - selfg_fft_multipole_3d_init() - initializes FFT plans for 3D
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   - regular_harmonics()   - regular solid harmonics up to lmax
+ *   - irregular_harmonics() - irregular solid harmonics up to lmax
+ *   - boundary_phi()        - potential of the multipole expansion at a point
+ *============================================================================*/
+
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "prototypes.h"
+#include "../prototypes.h"
+
+#ifdef SELF_GRAVITY_USING_FFT_MULTIPOLE
+
+#ifndef FFT_ENABLED
+#error self gravity with FFT requires configure --enable-fft
+#endif /* FFT_ENABLED */
+
+#ifdef STATIC_MESH_REFINEMENT
+#error self gravity with FFT not yet implemented to work with SMR
+#endif
+
+/* plan for the sine transform (forward and backward are the same);
+ * work space for FFTW */
+static struct ath_3d_fft_plan *dstplan3d;
+static ath_fft_data *work=NULL;
+
+/* order of the expansion; moments (re,im) of index l*(l+1)/2+m, m<=l; and
+ * solid harmonics of one point */
+static int lmax;
+static Real mpole_tol;
+static double *mom=NULL, *gmom=NULL;
+static double *hre=NULL, *him=NULL;
+
+/* (1-cos(pi*(m+1)/(N+1)))/dx^2 along each axis for the local Grid, so the
+ * eigenvalue of the 7-point Laplacian is -2*(lam1[i]+lam2[j]+lam3[k]) */
+static double *lam1=NULL, *lam2=NULL, *lam3=NULL;
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   regular_harmonics()   - regular solid harmonics up to lmax
+ *   irregular_harmonics() - irregular solid harmonics up to lmax
+ *   boundary_phi()        - potential of the multipole expansion at a point
+ *============================================================================*/
+
+static void regular_harmonics(const double x, const double y, const double z);
+static void irregular_harmonics(const double x, const double y,
+                                const double z);
+static Real boundary_phi(const double x, const double y, const double z);
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void selfg_fft_multipole_3d(DomainS *pD)
+ *  \brief Only works for uniform grid, open boundary conditions, and mass
+ *   well inside the Domain (see top of file)
+ */
+void selfg_fft_multipole_3d(DomainS *pD)
+{
+  GridS *pG = (pD->Grid);
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+  int nx1 = pG->Nx[0], nx2 = pG->Nx[1], nx3 = pG->Nx[2];
+  int l,m,lm,nlm = (lmax+1)*(lmax+2)/2;
+  int lx1,rx1,lx2,rx2,lx3,rx3;
+  double *rwork = (double *)work;
+  double x0[3],dm,idx1sq,idx2sq,idx3sq,rb2,r2;
+  Real x1,x2,x3,pcoeff;
+#ifdef MPI_PARALLEL
+  int mpi_err;
+#endif
+
+  idx1sq = 1.0/SQR(pG->dx1);
+  idx2sq = 1.0/SQR(pG->dx2);
+  idx3sq = 1.0/SQR(pG->dx3);
+
+  /* Copy current potential into old and zero-out */
+  for (k=ks-nghost; k<=ke+nghost; k++){
+    for (j=js-nghost; j<=je+nghost; j++){
+      for (i=is-nghost; i<=ie+nghost; i++){
+        pG->Phi_old[k][j][i] = pG->Phi[k][j][i];
+        pG->Phi[k][j][i] = 0.0;
+      }
+    }
+  }
+
+  /* STEP 1: Multipole moments of the mass about the center of the Domain,
+   * M_lm = sum of dm*conj(R_lm(x)), followed by the sums of |dm| and of
+   * |dm|*min(1,(r/rb)^(lmax+1)) for the convergence check */
+  for (l=0; l<3; l++) x0[l] = 0.5*(pD->MinX[l] + pD->MaxX[l]);
+  rb2 = MIN(MIN(pD->MaxX[0] - x0[0] + 0.5*pG->dx1,
+                pD->MaxX[1] - x0[1] + 0.5*pG->dx2),
+                pD->MaxX[2] - x0[2] + 0.5*pG->dx3);
+  rb2 = SQR(rb2);
+  for (lm=0; lm<2*nlm+2; lm++) mom[lm] = 0.0;
+
+  for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        cc_pos(pG,i,j,k,&x1,&x2,&x3);
+        dm = UVAR(pG,k,j,i,d)*pG->dx1*pG->dx2*pG->dx3;
+        regular_harmonics(x1-x0[0],x2-x0[1],x3-x0[2]);
+        for (lm=0; lm<nlm; lm++) {
+          mom[2*lm  ] += dm*hre[lm];
+          mom[2*lm+1] -= dm*him[lm];
+        }
+        r2 = SQR(x1-x0[0]) + SQR(x2-x0[1]) + SQR(x3-x0[2]);
+        mom[2*nlm  ] += fabs(dm);
+        mom[2*nlm+1] += fabs(dm)*(r2 < rb2 ? pow(r2/rb2,0.5*(lmax+1)) : 1.0);
+      }
+    }
+  }
+
+#ifdef MPI_PARALLEL
+  mpi_err = MPI_Allreduce(mom, gmom, 2*nlm+2, MPI_DOUBLE, MPI_SUM,
+                          pD->Comm_Domain);
+  if (mpi_err)
+    ath_error("[selfg_fft_multipole_3d]: MPI_Allreduce err = %d\n",mpi_err);
+#else
+  for (lm=0; lm<2*nlm+2; lm++) gmom[lm] = mom[lm];
+#endif
+
+  if (gmom[2*nlm+1] > mpole_tol*gmom[2*nlm])
+    ath_error("[selfg_fft_multipole_3d]: multipole expansion not valid, error"
+              " %.2e > mpole_tol = %.2e; the mass must be well inside the"
+              " Domain (or use fft_obc)\n",gmom[2*nlm+1]/gmom[2*nlm],
+              mpole_tol);
+
+  /* STEP 2: 4\piG*d in the interior, minus the boundary potential over dx^2
+   * in the cells next to each face of the Domain, so the transform can take
+   * the potential to be zero in the first ghost cells */
+  for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        rwork[F3DI(i-is,j-js,k-ks,nx1,nx2,nx3)] = four_pi_G*UVAR(pG,k,j,i,d);
+      }
+    }
+  }
+
+  lx1 = (pG->Disp[0] == pD->Disp[0]);
+  rx1 = (pG->Disp[0] + nx1 == pD->Disp[0] + pD->Nx[0]);
+  lx2 = (pG->Disp[1] == pD->Disp[1]);
+  rx2 = (pG->Disp[1] + nx2 == pD->Disp[1] + pD->Nx[1]);
+  lx3 = (pG->Disp[2] == pD->Disp[2]);
+  rx3 = (pG->Disp[2] + nx3 == pD->Disp[2] + pD->Nx[2]);
+
+  for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+      if (lx1) {
+        cc_pos(pG,is-1,j,k,&x1,&x2,&x3);
+        rwork[F3DI(0,j-js,k-ks,nx1,nx2,nx3)] -=
+          idx1sq*boundary_phi(x1-x0[0],x2-x0[1],x3-x0[2]);
+      }
+      if (rx1) {
+        cc_pos(pG,ie+1,j,k,&x1,&x2,&x3);
+        rwork[F3DI(nx1-1,j-js,k-ks,nx1,nx2,nx3)] -=
+          idx1sq*boundary_phi(x1-x0[0],x2-x0[1],x3-x0[2]);
+      }
+    }
+  }
+
+  for (k=ks; k<=ke; k++) {
+    for (i=is; i<=ie; i++) {
+      if (lx2) {
+        cc_pos(pG,i,js-1,k,&x1,&x2,&x3);
+        rwork[F3DI(i-is,0,k-ks,nx1,nx2,nx3)] -=
+          idx2sq*boundary_phi(x1-x0[0],x2-x0[1],x3-x0[2]);
+      }
+      if (rx2) {
+        cc_pos(pG,i,je+1,k,&x1,&x2,&x3);
+        rwork[F3DI(i-is,nx2-1,k-ks,nx1,nx2,nx3)] -=
+          idx2sq*boundary_phi(x1-x0[0],x2-x0[1],x3-x0[2]);
+      }
+    }
+  }
+
+  for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+      if (lx3) {
+        cc_pos(pG,i,j,ks-1,&x1,&x2,&x3);
+        rwork[F3DI(i-is,j-js,0,nx1,nx2,nx3)] -=
+          idx3sq*boundary_phi(x1-x0[0],x2-x0[1],x3-x0[2]);
+      }
+      if (rx3) {
+        cc_pos(pG,i,j,ke+1,&x1,&x2,&x3);
+        rwork[F3DI(i-is,j-js,nx3-1,nx1,nx2,nx3)] -=
+          idx3sq*boundary_phi(x1-x0[0],x2-x0[1],x3-x0[2]);
+      }
+    }
+  }
+
+  /* STEP 3: Sine transform, divide by the eigenvalues of the Laplacian
+   * (never zero with Dirichlet BCs), and transform back.  The data are
+   * distributed as in real space, so local indices plus Disp are global. */
+  ath_3d_fft(dstplan3d, work);
+
+  for (i=0; i<nx1; i++) {
+    for (j=0; j<nx2; j++) {
+      for (k=0; k<nx3; k++) {
+        rwork[F3DI(i,j,k,nx1,nx2,nx3)] *= -0.5/(lam1[i] + lam2[j] + lam3[k]);
+      }
+    }
+  }
+
+  ath_3d_fft(dstplan3d, work);
+
+  /* Finally, normalize the transforms.  DST-I applied twice multiplies by
+   * 2(N+1) along each axis. */
+  pcoeff = 1.0/(8.0*(pD->Nx[0]+1)*(pD->Nx[1]+1)*(pD->Nx[2]+1));
+  for (k=ks; k<=ke; k++){
+    for (j=js; j<=je; j++){
+      for (i=is; i<=ie; i++){
+        pG->Phi[k][j][i] = pcoeff*rwork[F3DI(i-is,j-js,k-ks,nx1,nx2,nx3)];
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void selfg_fft_multipole_3d_init(MeshS *pM)
+ *  \brief Initializes the sine transform plan, allocates memory needed by
+ *   FFTW and for the multipole moments, and tabulates the eigenvalues of the
+ *   Laplacian.
+ */
+void selfg_fft_multipole_3d_init(MeshS *pM)
+{
+  DomainS *pD;
+  GridS *pG;
+  int nl,nd,i,nlm;
+  int gis,gie,gjs,gje,gks,gke;
+
+  lmax = par_geti_def("gravity","mpole_lmax",8);
+  if (lmax < 0)
+    ath_error("[selfg_fft_multipole_3d_init]: mpole_lmax = %d < 0\n",lmax);
+  mpole_tol = par_getd_def("gravity","mpole_tol",1.0e-2);
+  nlm = (lmax+1)*(lmax+2)/2;
+
+  if ((mom  = (double*)calloc_1d_array(2*nlm+2,sizeof(double))) == NULL ||
+      (gmom = (double*)calloc_1d_array(2*nlm+2,sizeof(double))) == NULL ||
+      (hre  = (double*)calloc_1d_array(nlm,sizeof(double))) == NULL ||
+      (him  = (double*)calloc_1d_array(nlm,sizeof(double))) == NULL)
+    ath_error("[selfg_fft_multipole_3d_init]: malloc returned NULL\n");
+
+  for (nl=0; nl<(pM->NLevels); nl++) {
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++) {
+      if (pM->Domain[nl][nd].Grid != NULL) {
+        pD = (DomainS*)&(pM->Domain[nl][nd]);
+        pG = pD->Grid;
+        gis = pG->Disp[0] - pD->Disp[0];
+        gie = gis + pG->Nx[0] - 1;
+        gjs = pG->Disp[1] - pD->Disp[1];
+        gje = gjs + pG->Nx[1] - 1;
+        gks = pG->Disp[2] - pD->Disp[2];
+        gke = gks + pG->Nx[2] - 1;
+        dstplan3d = ath_3d_fft_create_plan(pD, pD->Nx[2], pD->Nx[1], pD->Nx[0],
+                      gks, gke, gjs, gje, gis, gie, NULL, 0,
+                      ATH_FFT_FORWARD, ATH_FFT_DST);
+        work = ath_3d_fft_malloc(dstplan3d);
+
+        if ((lam1 = (double*)calloc_1d_array(pG->Nx[0],sizeof(double))) == NULL
+         || (lam2 = (double*)calloc_1d_array(pG->Nx[1],sizeof(double))) == NULL
+         || (lam3 = (double*)calloc_1d_array(pG->Nx[2],sizeof(double))) == NULL)
+          ath_error("[selfg_fft_multipole_3d_init]: malloc returned NULL\n");
+        for (i=0; i<pG->Nx[0]; i++)
+          lam1[i] = (1.0 - cos(PI*(gis+i+1)/(double)(pD->Nx[0]+1)))
+                    /SQR(pG->dx1);
+        for (i=0; i<pG->Nx[1]; i++)
+          lam2[i] = (1.0 - cos(PI*(gjs+i+1)/(double)(pD->Nx[1]+1)))
+                    /SQR(pG->dx2);
+        for (i=0; i<pG->Nx[2]; i++)
+          lam3[i] = (1.0 - cos(PI*(gks+i+1)/(double)(pD->Nx[2]+1)))
+                    /SQR(pG->dx3);
+      }
+    }
+  }
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void regular_harmonics(const double x, const double y,
+ *                                    const double z)
+ *  \brief Sets hre,him to R_lm = r^l P_l^m(cos theta) e^{i m phi}/(l+m)!,
+ *   m=0..l, l=0..lmax (no Condon-Shortley phase), by recurrence in x,y,z.
+ */
+static void regular_harmonics(const double x, const double y, const double z)
+{
+  int l,m,lm;
+  double r2 = x*x + y*y + z*z, a, b;
+
+  hre[0] = 1.0;
+  him[0] = 0.0;
+  for (m=0; m<=lmax; m++) {
+    lm = m*(m+1)/2 + m;
+    if (m > 0) {
+      a = hre[lm-m-1];  b = him[lm-m-1];   /* R_{m-1,m-1} */
+      hre[lm] = (x*a - y*b)/(2.0*m);
+      him[lm] = (x*b + y*a)/(2.0*m);
+    }
+    if (m < lmax) {
+      hre[lm+m+1] = z*hre[lm];
+      him[lm+m+1] = z*him[lm];
+    }
+    for (l=m+2; l<=lmax; l++) {
+      lm = l*(l+1)/2 + m;
+      hre[lm] = ((2*l-1)*z*hre[lm-l] - r2*hre[lm-2*l+1])/((l-m)*(l+m));
+      him[lm] = ((2*l-1)*z*him[lm-l] - r2*him[lm-2*l+1])/((l-m)*(l+m));
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void irregular_harmonics(const double x, const double y,
+ *                                      const double z)
+ *  \brief Sets hre,him to I_lm = (l-m)! P_l^m(cos theta) e^{i m phi}/r^{l+1},
+ *   m=0..l, l=0..lmax, so that 1/|x-x'| = sum over l and m=-l..l of
+ *   conj(R_lm(x')) I_lm(x) for |x'| < |x|.
+ */
+static void irregular_harmonics(const double x, const double y,
+                                const double z)
+{
+  int l,m,lm;
+  double ir2 = 1.0/(x*x + y*y + z*z), a, b;
+
+  hre[0] = sqrt(ir2);
+  him[0] = 0.0;
+  for (m=0; m<=lmax; m++) {
+    lm = m*(m+1)/2 + m;
+    if (m > 0) {
+      a = hre[lm-m-1];  b = him[lm-m-1];   /* I_{m-1,m-1} */
+      hre[lm] = (2*m-1)*ir2*(x*a - y*b);
+      him[lm] = (2*m-1)*ir2*(x*b + y*a);
+    }
+    if (m < lmax) {
+      hre[lm+m+1] = (2*m+1)*ir2*z*hre[lm];
+      him[lm+m+1] = (2*m+1)*ir2*z*him[lm];
+    }
+    for (l=m+2; l<=lmax; l++) {
+      lm = l*(l+1)/2 + m;
+      hre[lm] = ir2*((2*l-1)*z*hre[lm-l]
+                     - (l+m-1)*(l-m-1)*hre[lm-2*l+1]);
+      him[lm] = ir2*((2*l-1)*z*him[lm-l]
+                     - (l+m-1)*(l-m-1)*him[lm-2*l+1]);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real boundary_phi(const double x, const double y,
+ *                               const double z)
+ *  \brief Potential of the multipole expansion gmom at (x,y,z) relative to
+ *   the expansion center, -G sum_l [M_l0 I_l0 + 2 sum_{m>0} Re(M_lm I_lm)].
+ */
+static Real boundary_phi(const double x, const double y, const double z)
+{
+  int l,m,lm;
+  double phi = 0.0;
+
+  irregular_harmonics(x,y,z);
+  for (l=0; l<=lmax; l++) {
+    lm = l*(l+1)/2;
+    phi += gmom[2*lm]*hre[lm];
+    for (m=1; m<=l; m++) {
+      phi += 2.0*(gmom[2*(lm+m)]*hre[lm+m] - gmom[2*(lm+m)+1]*him[lm+m]);
+    }
+  }
+
+  return (Real)(-four_pi_G*phi/(4.0*PI));
+}
+
+#endif /* SELF_GRAVITY_USING_FFT_MULTIPOLE */
@@ -95,7 +95,7 @@ void selfg_fft_obc_2d(DomainS *pD)
       /* Add gas density into work array 0. */
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] = pG->U[ks][j][i].d;
+          work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] = UVAR(pG,ks,j,i,d);
         }
       }
 
@@ -227,7 +227,7 @@ void selfg_fft_obc_3d(DomainS *pD)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = pG->U[k][j][i].d;
+            work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = UVAR(pG,k,j,i,d);
           }
         }
       }
@@ -370,13 +370,28 @@ void selfg_fft_obc_2d_init(MeshS *pM)
 void selfg_fft_obc_3d_init(MeshS *pM)
 {
   DomainS *pD;
+  GridS *pG;
   int nl,nd;
+  int gis,gie,gjs,gje,gks,gke;
   for (nl=0; nl<(pM->NLevels); nl++) {
     for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++) {
       if (pM->Domain[nl][nd].Grid != NULL) {
         pD = (DomainS*)&(pM->Domain[nl][nd]);
-        fplan3d = ath_3d_fft_quick_plan(pD, NULL, ATH_FFT_FORWARD);
-        bplan3d = ath_3d_fft_quick_plan(pD, NULL, ATH_FFT_BACKWARD);
+        pG = pD->Grid;
+        /* The half-cell offsets make the transformed data complex, so these
+         * need complex-to-complex plans rather than the default r2c ones */
+        gis = pG->Disp[0] - pD->Disp[0];
+        gie = gis + pG->Nx[0] - 1;
+        gjs = pG->Disp[1] - pD->Disp[1];
+        gje = gjs + pG->Nx[1] - 1;
+        gks = pG->Disp[2] - pD->Disp[2];
+        gke = gks + pG->Nx[2] - 1;
+        fplan3d = ath_3d_fft_create_plan(pD, pD->Nx[2], pD->Nx[1], pD->Nx[0],
+                    gks, gke, gjs, gje, gis, gie, NULL, 0,
+                    ATH_FFT_FORWARD, ATH_FFT_C2C);
+        bplan3d = ath_3d_fft_create_plan(pD, pD->Nx[2], pD->Nx[1], pD->Nx[0],
+                    gks, gke, gjs, gje, gis, gie, NULL, 0,
+                    ATH_FFT_BACKWARD, ATH_FFT_C2C);
         work = ath_3d_fft_malloc(fplan3d);
       }
     }
@@ -4,8 +4,42 @@
  *  \brief Contains functions to solve Poisson's equation for self-gravity in
  *   3D using multigrid.
  *
- *   These functions work for non-periodic domains.  A low-order multipole
- *   expansion is used to compute the potential on the boundaries.
+ *   These functions work for periodic and non-periodic domains.  For
+ *   non-periodic domains a low-order multipole expansion is used to compute
+ *   the potential on the boundaries.
+ *
+ *   The solver smooths with red-black Gauss-Seidel sweeps, and repeats V-,
+ *   W- or full multigrid (FMG) cycles until the RMS residual drops below
+ *   mg_tol times the RMS of the RHS.  Each solve starts from the potential
+ *   of the previous one.  The cycle is set in the <gravity> block:
+ *   - mg_cycle      = V, W or FMG (default V)
+ *   - mg_tol        = relative residual tolerance (default 1.0e-6)
+ *   - mg_max_cycles = maximum number of cycles per solve (default 20)
+ *   - mg_nsweep     = sweeps before and after coarse-grid correction (2)
+ *
+ *   With MPI, every level of the hierarchy is decomposed into the same blocks
+ *   as the Grids in the Domain, and ghost zones are exchanged between blocks
+ *   at every level.  Once the blocks would become smaller than MG_MIN_ZONES
+ *   in some direction, neighbouring blocks are agglomerated onto one process
+ *   (the one that owns the block at the lowest corner), so that the coarsest
+ *   levels are handled by fewer processes and the rest stay idle.
+ *
+ *   With SMR every Domain has its own hierarchy, and the potential on the
+ *   composite grid (all levels, with the fine solution replacing the coarse
+ *   one where Domains overlap) is found by iterating over the levels:
+ *   - each level is solved in turn from the root down, with the potential
+ *     on fine/coarse boundaries interpolated from the parent by
+ *     Prolongate_Phi() and held fixed
+ *   - from the finest level up, RestrictCorrect_Phi() replaces the parent
+ *     potential under each child Grid by the average of the fine one, and
+ *     returns the gradient of the fine potential across its boundaries
+ *   - on the next pass, the RHS of the parent in zones next to a child is
+ *     corrected so that the flux of the gradient through the fine/coarse
+ *     boundary is the fine one, and under the child is set so that the
+ *     parent reproduces the restricted solution.
+ *   The passes stop when every level starts a pass with its residual already
+ *   below mg_tol, or after mg_smr_cycles passes (default 10).  Every process
+ *   must own a Grid in some Domain.
  *
  * HISTORY:
  * - june-2007 - 2D and 3D solvers written by Irene Balmes
@@ -14,11 +48,15 @@
  * CONTAINS PUBLIC FUNCTIONS:
  * - selfg_by_multig_2d() - 2D Poisson solver using multigrid
  * - selfg_by_multig_3d() - 3D Poisson solver using multigrid
- * - selfg_by_multig_3d_init() - Initializes send/receive buffers for MPI */
+ * - selfg_by_multig_3d_init() - Initializes multigrid hierarchy and buffers */
 /*============================================================================*/
 
+/* posix_memalign() is POSIX.1-2001, not C89/C99 */
+#define _POSIX_C_SOURCE 200112L
 #include <math.h>
 #include <float.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../defs.h"
 #include "../athena.h"
 #include "../globals.h"
@@ -27,54 +65,156 @@
 
 #ifdef SELF_GRAVITY_USING_MULTIGRID
 
-#ifdef STATIC_MESH_REFINEMENT
-#error self gravity with multigrid not yet implemented to work with SMR
-#endif
-
-#ifdef MPI_PARALLEL
-#error self gravity with multigrid not yet implemented to work with MPI
-#endif
-
-#ifdef MPI_PARALLEL
-static double *send_buf=NULL, *recv_buf=NULL;
-#endif
+/* Blocks are agglomerated when they would have fewer zones than this */
+#define MG_MIN_ZONES 4
+/* Reduction of the residual on the coarsest level, and max sweeps there */
+#define MG_COARSE_TOL 1.0e-3
+#define MG_COARSE_MAX 1000
 
 /*! \struct MGrid
  *  \brief Holds RHS, potential, and information about grid
- * size for a given level in the multi-grid hierarchy  */
+ * size for a given level in the multi-grid hierarchy.
+ *
+ * Every process stores the decomposition of each level into blocks.  The
+ * block owned by this process (if any) has indices Blk[], and its size and
+ * neighbours are stored in Nx1..3 and l/r??_id.  */
 typedef struct MGrid_s{
   Real ***rhs,***Phi;  /* RHS of elliptic equation, and solution */
   Real dx1,dx2,dx3;
   int Nx1,Nx2,Nx3;
   int is,ie;
   int js,je;
-  int ks,ke; 
+  int ks,ke;
   int rx1_id, lx1_id;
   int rx2_id, lx2_id;
   int rx3_id, lx3_id;
+  int my_id;         /* ID of this process in Comm_Domain */
+  int NBlk[3];       /* number of blocks in each direction */
+  int *Cut[3];       /* zone index of left edge of each block, [0..NBlk] */
+  int ***ID;         /* ID in Comm_Domain of process owning each block */
+  int Blk[3];        /* indices of block owned by this process, or -1 */
+  int Merge[3];      /* blocks on this level per block on next coarser level */
 }MGrid;
 
+/*! \struct MGHier
+ *  \brief Multigrid hierarchy of one Domain, built by init_mg_hier() for
+ *   every Domain with a Grid on this process.  */
+typedef struct MGHier_s{
+  MGrid *Lev;        /* levels, finest first */
+  int NLev;
+  int all_periodic;  /* periodic BCs in all three directions */
+  int ncoarse;       /* sweeps on coarsest level between residual checks */
+  int edge[3][2];    /* Domain reaches [dir][L,R] edge of the root Domain */
+  void *pool;        /* memory holding the RHS and solution of all levels */
+#ifdef MPI_PARALLEL
+  MPI_Comm Comm;
+#endif
+}MGHier;
+
+/* hierarchies of all Domains [nl][nd] */
+static MGHier **MGH=NULL;
+
+/* hierarchy the solver is working on, set by use_mg_hier() */
+static MGrid *MGLev=NULL;
+static int NMGLev=0;
+static int all_periodic=0;  /* periodic BCs in all three directions */
+static int mg_ncoarse=4;
+
+/* parameters of the multigrid cycle, read from <gravity> block */
+static int mg_gamma=1;      /* coarse-grid cycles per level: 1=V, 2=W */
+static int mg_fmg=0;        /* start each solve with a full multigrid cycle */
+static int mg_max_cycles=20, mg_nsweep=2;
+static Real mg_tol=1.0e-6;
+
 /* 3D temporary array needed for restriction of errors  */
-Real ***error;
+static Real ***error=NULL;
+
+/* memory holding error */
+static void *mg_pool=NULL;
+
+#ifdef MPI_PARALLEL
+static MPI_Comm MG_Comm;
+static double *send_buf=NULL, *recv_buf=NULL;
+#endif
+
+#ifdef STATIC_MESH_REFINEMENT
+/* passes over the levels per solve, read from <gravity> block */
+static int mg_smr_cycles=10;
+static int smr_warm=0;          /* children have restricted a solution */
+static MeshS *pMesh=NULL;
+static DomainS *mg_first=NULL;  /* first Domain with a Grid on this process */
+static int root_periodic=0;     /* periodic BCs in all three directions */
+#endif
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
- *   multig_3d() -
+ *   multig_3d() - recursive V- or W-cycle starting at level nl
+ *   fmg_3d()    - full multigrid cycle
+ *   GaussSeidel_3d()  - red-black Gauss-Seidel sweeps on one level
+ *   CoarseSolve_3d()  - solves on the coarsest level
+ *   Residual_3d()     - residual of one level in the error array
+ *   sumsq_3d()        - sum of squares over the block of one level
+ *   rms_3d()          - RMS over the Domain of an array of the root level
+ *   zero_mg_Phi()     - sets solution on one level to zero
+ *   use_mg_hier()     - makes hierarchy of a Domain the current one
+ *   init_mg_hier()    - builds hierarchy of a Domain
+ *   save_Phi_old()    - copies potential into Phi_old
+ *   grid_mass()       - mass in a Grid
+ *   mg_bvals_3d()     - potential on edges of the root Domain by monopole
+ *   solve_mg_3d()     - solves on the current hierarchy
+ *   mg_pool_bytes()   - size of a 3D array in the memory pool
+ *   mg_pool_array()   - builds a 3D array in the memory pool
+ *   Restriction_3d()  - restricts residual to next coarser level
+ *   Prolongation_3d() - adds interpolated coarse correction to finer level
+ *   set_mg_bvals()    - sets ghost zones of iterates on one level
+ *   periodic_mg_x?()  - periodic ghost zones of a block spanning the Domain
+ *   swap_mg_???()     - MPI exchange of ghost zones with neighbouring block
+ *   gather_mg()       - moves residual onto agglomerated blocks
+ *   scatter_mg()      - moves correction back from agglomerated blocks
+ *   selfg_multig_smr_3d() - composite solve over all levels with SMR
+ *   smr_rhs_3d()      - corrects RHS under and next to child Grids
+ *   smr_defect_3d()   - adds mismatch of fine and coarse fluxes to RHS
  *============================================================================*/
 
-void multig_3d(MGrid *pMG);
-void Jacobi(MGrid *pMG);
+void multig_3d(int nl);
+static void fmg_3d(void);
+void GaussSeidel_3d(MGrid *pMG, int nsweep);
+static void Residual_3d(MGrid *pMG);
+static void CoarseSolve_3d(MGrid *pMG);
+static Real sumsq_3d(MGrid *pMG, Real ***a);
+static Real rms_3d(MGrid *pMG, Real ***a);
+static void zero_mg_Phi(MGrid *pMG);
+static void use_mg_hier(MGHier *pH);
+static void init_mg_hier(MeshS *pM, DomainS *pD, MGHier *pH, int size[3],
+                         int *bsize);
+static void save_Phi_old(GridS *pG);
+static Real grid_mass(GridS *pG);
+static void mg_bvals_3d(GridS *pG, MGHier *pH, Real tmass);
+static int solve_mg_3d(DomainS *pD, Real drho, int smr_rhs);
+static size_t mg_pool_bytes(int nt, int nr, int nc);
+static Real ***mg_pool_array(unsigned char **pp, int nt, int nr, int nc);
 void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse);
 void Prolongation_3d(MGrid *pMG_coarse, MGrid *pMG_fine);
+void set_mg_bvals(MGrid *pMG);
+static void periodic_mg_x1(MGrid *pMG);
+static void periodic_mg_x2(MGrid *pMG);
+static void periodic_mg_x3(MGrid *pMG);
 
 #ifdef MPI_PARALLEL
-void set_mg_bvals(MGrid *pMG);
 void swap_mg_ix1(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq);
 void swap_mg_ox1(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq);
 void swap_mg_ix2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq);
 void swap_mg_ox2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq);
 void swap_mg_ix3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq);
 void swap_mg_ox3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq);
+static void gather_mg(MGrid *pMG_fine, MGrid *pMG_coarse);
+static void scatter_mg(MGrid *pMG_coarse, MGrid *pMG_fine);
+#endif
+
+#ifdef STATIC_MESH_REFINEMENT
+static void selfg_multig_smr_3d(MeshS *pM);
+static void smr_rhs_3d(GridS *pG, MGrid *pMG);
+static void smr_defect_3d(GridS *pG, MGrid *pMG);
 #endif
 
 
@@ -103,26 +243,65 @@ void selfg_multig_2d(DomainS *pD)
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void selfg_multig_3d(DomainS *pD)
- *  \brief Do not use with periodic BCs, uses multipole expansion
- *   to compute potential at boundary
+ *  \brief With non-periodic BCs, uses multipole expansion
+ *   to compute potential at boundary.  With periodic BCs in all directions
+ *   the mean density grav_mean_rho is subtracted from the RHS.
+ *
+ *   With SMR the potential on every level is computed by the call for the
+ *   first Domain with a Grid on this process, and other calls return.
  */
 
 void selfg_multig_3d(DomainS *pD)
 {
+#ifdef STATIC_MESH_REFINEMENT
+  if (pD == mg_first) selfg_multig_smr_3d(pMesh);
+  return;
+#else
   GridS *pG = (pD->Grid);
-  int i, is = pG->is, ie = pG->ie;
-  int j, js = pG->js, je = pG->je;
-  int k, ks = pG->ks, ke = pG->ke;
-  int Nx1z, Nx2z, Nx3z;
-  MGrid Root_grid;
-  Real mass = 0.0, tmass, dVol, rad, x1, x2, x3;
-  Real Grav_const = four_pi_G/(4.0*PI);
+  MGHier *pH = &(MGH[0][0]);
+  Real mass, tmass;
 #ifdef MPI_PARALLEL
-  Real mpi_err;
+  int mpi_err;
 #endif
 
 /* Copy current potential into old */
 
+  save_Phi_old(pG);
+
+/* Compute solution at boundaries using monopole expansion */
+
+  mass = grid_mass(pG);
+
+#ifdef MPI_PARALLEL
+  mpi_err = MPI_Allreduce(&mass, &tmass,1,MPI_DOUBLE,MPI_SUM,pD->Comm_Domain);
+  if (mpi_err) ath_error("[selfg_multigrid]: MPI_Reduce returned err = %d\n",
+    mpi_err);
+#else
+  tmass = mass;
+#endif /* MPI_PARALLEL */
+
+  use_mg_hier(pH);
+  mg_bvals_3d(pG, pH, tmass);
+
+/* With periodic BCs in every direction, solve for perturbed potential */
+
+  solve_mg_3d(pD, (all_periodic ? grav_mean_rho : 0.0), 0);
+
+  return;
+#endif /* STATIC_MESH_REFINEMENT */
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void save_Phi_old(GridS *pG)
+ *  \brief Copies current potential into Phi_old, including ghost zones
+ */
+
+static void save_Phi_old(GridS *pG)
+{
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+
   for (k=ks-nghost; k<=ke+nghost; k++){
     for (j=js-nghost; j<=je+nghost; j++){
       for (i=is-nghost; i<=ie+nghost; i++){
@@ -131,28 +310,53 @@ void selfg_multig_3d(DomainS *pD)
     }
   }
 
-/* Compute solution at boundaries using monopole expansion */
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real grid_mass(GridS *pG)
+ *  \brief Mass in the active zones of a Grid
+ */
+
+static Real grid_mass(GridS *pG)
+{
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+  Real mass = 0.0, dVol = pG->dx1*pG->dx2*pG->dx3;
 
-  dVol = pG->dx1*pG->dx2*pG->dx3;
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
-        mass += pG->U[k][j][i].d*dVol;
+        mass += UVAR(pG,k,j,i,d)*dVol;
       }
     }
   }
 
-#ifdef MPI_PARALLEL
-  mpi_err = MPI_Allreduce(&mass, &tmass,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
-  if (mpi_err) ath_error("[selfg_multigrid]: MPI_Reduce returned err = %d\n",
-    mpi_err);
-#else
-  tmass = mass;
-#endif /* MPI_PARALLEL */
+  return mass;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void mg_bvals_3d(GridS *pG, MGHier *pH, Real tmass)
+ *  \brief Sets potential in ghost zones of a Grid on non-periodic edges of
+ *   the root Domain, using the monopole expansion of the total mass tmass.
+ *
+ *   Other edges of a Domain without neighbouring block are fine/coarse
+ *   boundaries, set by Prolongate_Phi().
+ */
+
+static void mg_bvals_3d(GridS *pG, MGHier *pH, Real tmass)
+{
+  MGrid *pRoot = &(pH->Lev[0]);
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+  Real rad, x1, x2, x3;
+  Real Grav_const = four_pi_G/(4.0*PI);
 
 /*  Inner and outer x1 boundaries */
 
-  if (pG->lx1_id < 0) {
+  if (pRoot->lx1_id < 0 && pH->edge[0][0]) {
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=1; i<=nghost; i++){
@@ -164,7 +368,7 @@ void selfg_multig_3d(DomainS *pD)
     }
   }
 
-  if (pG->rx1_id < 0) {
+  if (pRoot->rx1_id < 0 && pH->edge[0][1]) {
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=1; i<=nghost; i++){
@@ -178,7 +382,7 @@ void selfg_multig_3d(DomainS *pD)
 
 /*  Inner and outer x2 boundaries */
 
-  if (pG->lx2_id < 0) {
+  if (pRoot->lx2_id < 0 && pH->edge[1][0]) {
     for (k=ks; k<=ke; k++){
       for (j=1; j<=nghost; j++){
         for (i=is-nghost; i<=ie+nghost; i++){
@@ -190,7 +394,7 @@ void selfg_multig_3d(DomainS *pD)
     }
   }
 
-  if (pG->rx2_id < 0) {
+  if (pRoot->rx2_id < 0 && pH->edge[1][1]) {
     for (k=ks; k<=ke; k++){
       for (j=1; j<=nghost; j++){
         for (i=is-nghost; i<=ie+nghost; i++){
@@ -204,7 +408,7 @@ void selfg_multig_3d(DomainS *pD)
 
 /*  Inner and outer x3 boundaries */
 
-  if (pG->lx3_id < 0) {
+  if (pRoot->lx3_id < 0 && pH->edge[2][0]) {
     for (k=1; k<=nghost; k++){
       for (j=js-nghost; j<=je+nghost; j++){
         for (i=is-nghost; i<=ie+nghost; i++){
@@ -216,7 +420,7 @@ void selfg_multig_3d(DomainS *pD)
     }
   }
 
-  if (pG->rx3_id < 0) {
+  if (pRoot->rx3_id < 0 && pH->edge[2][1]) {
     for (k=1; k<=nghost; k++){
       for (j=js-nghost; j<=je+nghost; j++){
         for (i=is-nghost; i<=ie+nghost; i++){
@@ -228,50 +432,62 @@ void selfg_multig_3d(DomainS *pD)
     }
   }
 
-/* Initialize MGrid structure for top level (the root, or finest, level) */
+  return;
+}
 
-  Root_grid.Nx1 = pG->Nx[0];
-  Root_grid.Nx2 = pG->Nx[1];
-  Root_grid.Nx3 = pG->Nx[2];
-  Root_grid.is = 1;  Root_grid.ie = pG->Nx[0];
-  Root_grid.js = 1;  Root_grid.je = pG->Nx[1];
-  Root_grid.ks = 1;  Root_grid.ke = pG->Nx[2];
-  Root_grid.dx1 = pG->dx1;
-  Root_grid.dx2 = pG->dx2;
-  Root_grid.dx3 = pG->dx3;
-  Root_grid.rx1_id = pG->rx1_id; Root_grid.lx1_id = pG->lx1_id;
-  Root_grid.rx2_id = pG->rx2_id; Root_grid.lx2_id = pG->lx2_id;
-  Root_grid.rx3_id = pG->rx3_id; Root_grid.lx3_id = pG->lx3_id;
+/*----------------------------------------------------------------------------*/
+/*! \fn static int solve_mg_3d(DomainS *pD, Real drho, int smr_rhs)
+ *  \brief Solves Lap(Phi) = four_pi_G*(d - drho) on the Grid of Domain pD,
+ *   using the current hierarchy.  Ghost zones of pG->Phi on edges without
+ *   neighbouring block hold the boundary values.  With smr_rhs (SMR only)
+ *   the RHS is corrected under and next to child Grids by smr_rhs_3d().
+ *   Returns the number of cycles done.
+ */
 
-/* There is only one ghost zone needed at each level, not nghost */
-  Nx1z = pG->Nx[0] + 2;
-  Nx2z = pG->Nx[1] + 2;
-  Nx3z = pG->Nx[2] + 2;
-  Root_grid.rhs = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-  Root_grid.Phi = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-  if (Root_grid.rhs == NULL) {
-    ath_error("[selfg_by_multig_3d]: Error allocating memory\n");
-  }
-  if (Root_grid.Phi == NULL) {
-    ath_error("[selfg_by_multig_3d]: Error allocating memory\n");
-  }
+static int solve_mg_3d(DomainS *pD, Real drho, int smr_rhs)
+{
+  GridS *pG = (pD->Grid);
+  MGrid *pRoot = &(MGLev[0]);
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+  int n;
+  Real rhs_norm, res_norm;
 
-/* Initialize solution on root grid, including single ghost zone */
+/* Initialize solution on root grid, including single ghost zone.  The
+ * interior of pG->Phi still holds the previous solution (same as Phi_old),
+ * so each solve is warm-started from it. */
   for (k=ks-1; k<=ke+1; k++){
     for (j=js-1; j<=je+1; j++){
       for (i=is-1; i<=ie+1; i++){
-        Root_grid.rhs[k-ks+1][j-js+1][i-is+1] = four_pi_G*pG->U[k][j][i].d;
-        Root_grid.Phi[k-ks+1][j-js+1][i-is+1] = pG->Phi[k][j][i];
+        pRoot->rhs[k-ks+1][j-js+1][i-is+1] =
+          four_pi_G*(UVAR(pG,k,j,i,d) - drho);
+        pRoot->Phi[k-ks+1][j-js+1][i-is+1] = pG->Phi[k][j][i];
       }
     }
   }
-#ifdef MPI_PARALLEL
-  set_mg_bvals(&Root_grid);
+  set_mg_bvals(pRoot);
+#ifdef STATIC_MESH_REFINEMENT
+  if (smr_rhs) smr_rhs_3d(pG, pRoot);
 #endif
 
-/* Compute new potential.  Note multig_3d calls itself recursively. */
+/* Compute new potential.  Cycles are repeated until the RMS residual drops
+ * below mg_tol times the RMS of the RHS.  Note multig_3d calls itself
+ * recursively. */
+
+  rhs_norm = rms_3d(pRoot, pRoot->rhs);
+  Residual_3d(pRoot);
+  res_norm = rms_3d(pRoot, error);
 
-  multig_3d(&Root_grid);
+  for (n=0; n<mg_max_cycles && res_norm > mg_tol*rhs_norm; n++) {
+    if (n == 0 && mg_fmg) fmg_3d();
+    else multig_3d(0);
+    Residual_3d(pRoot);
+    res_norm = rms_3d(pRoot, error);
+  }
+  if (res_norm > mg_tol*rhs_norm)
+    ath_perr(-1,"[selfg_multig_3d]: residual %e not below %e after %d cycles\n",
+      res_norm, mg_tol*rhs_norm, n);
 
 /* copy solution for potential from MGrid into Grid structure.  Boundary
  * conditions for nghost ghost cells are set by set_bvals() call in main() */
@@ -279,204 +495,331 @@ void selfg_multig_3d(DomainS *pD)
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
-        pG->Phi[k][j][i] = Root_grid.Phi[k-ks+1][j-js+1][i-is+1];
+        pG->Phi[k][j][i] = pRoot->Phi[k-ks+1][j-js+1][i-is+1];
       }
     }
   }
 
-  free_3d_array(Root_grid.rhs);
-  free_3d_array(Root_grid.Phi);
-
-  return;
+  return n;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void multig_3d(MGrid *pMG)
- *  \brief Functions needed for the multigrid solver in 3D
+/*! \fn void multig_3d(int nl)
+ *  \brief Functions needed for the multigrid solver in 3D.  Does one V-cycle
+ *   (mg_gamma=1) or W-cycle (mg_gamma=2) starting at level nl.
+ *
+ *   Every process calls this function for every level, but only processes
+ *   owning a block on a level iterate on it.
  */
 
-void multig_3d(MGrid *pMG)
+void multig_3d(int nl)
 {
-  int i, is = pMG->is, ie = pMG->ie;
-  int j, js = pMG->js, je = pMG->je;
-  int k, ks = pMG->ks, ke = pMG->ke;
-  int Nx1z, Nx2z, Nx3z;
-  MGrid Coarse_grid;
-
-/* If we are down to 4 cells in any dimension do 10 iterations and return */
-
-  if (pMG->Nx1==4 || pMG->Nx2==4 || pMG->Nx3==4)
-    Jacobi(pMG);
-
-/* Else, do 10 iterations at this level, restrict to a coarser grid, and call
- * multig_3d again with this coarse grid */
-
-  else { 
-    Jacobi(pMG);
-
-/* Allocate and initialize MGrid at next coarsest level */
-
-    Coarse_grid.Nx1 = pMG->Nx1/2;
-    Coarse_grid.Nx2 = pMG->Nx2/2;
-    Coarse_grid.Nx3 = pMG->Nx3/2;
-    Coarse_grid.is = 1;  Coarse_grid.ie = Coarse_grid.Nx1;
-    Coarse_grid.js = 1;  Coarse_grid.je = Coarse_grid.Nx2;
-    Coarse_grid.ks = 1;  Coarse_grid.ke = Coarse_grid.Nx3;
-    Coarse_grid.dx1 = 2.0*pMG->dx1;
-    Coarse_grid.dx2 = 2.0*pMG->dx2;
-    Coarse_grid.dx3 = 2.0*pMG->dx3;
-    Coarse_grid.rx1_id = pMG->rx1_id; Coarse_grid.lx1_id = pMG->lx1_id;
-    Coarse_grid.rx2_id = pMG->rx2_id; Coarse_grid.lx2_id = pMG->lx2_id;
-    Coarse_grid.rx3_id = pMG->rx3_id; Coarse_grid.lx3_id = pMG->lx3_id;
-
-/* Again, only one ghost zone on each level */
-    Nx1z = (pMG->Nx1)/2 + 2;
-    Nx2z = (pMG->Nx2)/2 + 2;
-    Nx3z = (pMG->Nx3)/2 + 2;
-    Coarse_grid.rhs = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-    Coarse_grid.Phi = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-    if (Coarse_grid.rhs == NULL) {
-      ath_error("[multig_3d]: Error allocating memory for some level\n");
-    }
-    if (Coarse_grid.Phi == NULL) {
-      ath_error("[multig_3d]: Error allocating memory for some level\n");
-    }
+  MGrid *pMG = &(MGLev[nl]), *pCG;
+  int n;
 
-    Restriction_3d(pMG, &Coarse_grid);
-#ifdef MPI_PARALLEL
-    set_mg_bvals(&Coarse_grid);
-#endif
+/* If we are down to the coarsest level solve for the correction and return */
+
+  if (nl == NMGLev-1) {
+    if (pMG->Blk[0] >= 0) CoarseSolve_3d(pMG);
+    return;
+  }
+
+/* Else, smooth at this level, restrict residual to a coarser grid, and call
+ * multig_3d again (twice for W-cycles) with this coarse grid.  The coarse
+ * level solves for the correction, so it starts from zero, and its ghost
+ * zones stay zero at non-periodic boundaries. */
 
-    multig_3d(&Coarse_grid);
+  pCG = &(MGLev[nl+1]);
+  if (pMG->Blk[0] >= 0) GaussSeidel_3d(pMG, mg_nsweep);
 
-/* The following code is first reached after 10 iterations at the coarsest
- * level.  We then prolongate, do 10 iterations, and return.  This will return
+  Restriction_3d(pMG, pCG);
+  if (pCG->Blk[0] >= 0) zero_mg_Phi(pCG);
+
+  for (n=0; n<mg_gamma; n++) multig_3d(nl+1);
+
+/* The following code is first reached after smoothing at the coarsest
+ * level.  We then prolongate, smooth, and return.  This will return
  * execution to this same spot for the next coarsest level, so we will
- * prolongate, do 10 iterations, return, and so on.
+ * prolongate, smooth, return, and so on.
  */
 
-    Prolongation_3d(&Coarse_grid, pMG);
-    free_3d_array(Coarse_grid.rhs);
-    free_3d_array(Coarse_grid.Phi);
-#ifdef MPI_PARALLEL
+  Prolongation_3d(pCG, pMG);
+
+  if (pMG->Blk[0] >= 0) {
     set_mg_bvals(pMG);
-#endif
+    GaussSeidel_3d(pMG, mg_nsweep);
+  }
 
-/* End with 10 iterations at the finest level */
+  return;
+}
 
-    Jacobi(pMG);
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fmg_3d(void)
+ *  \brief Full multigrid cycle for the correction to the root level.
+ *
+ *   The residual of the root level is restricted down to the coarsest level
+ *   and solved for there.  The solution on each level is then interpolated
+ *   to the next finer one as the starting guess of a cycle on that level.
+ */
+
+static void fmg_3d(void)
+{
+  int nl;
+
+/* With zero solution on the coarse levels, their residual is the RHS */
+
+  for (nl=0; nl<NMGLev-1; nl++) {
+    Restriction_3d(&(MGLev[nl]), &(MGLev[nl+1]));
+    if (MGLev[nl+1].Blk[0] >= 0) zero_mg_Phi(&(MGLev[nl+1]));
+  }
+
+  multig_3d(NMGLev-1);
+  for (nl=NMGLev-2; nl>=0; nl--) {
+    Prolongation_3d(&(MGLev[nl+1]), &(MGLev[nl]));
+    if (MGLev[nl].Blk[0] >= 0) set_mg_bvals(&(MGLev[nl]));
+    multig_3d(nl);
   }
 
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void Jacobi(MGrid *pMG)
- *  \brief Jacobi iterations. 
+/*! \fn static void zero_mg_Phi(MGrid *pMG)
+ *  \brief Sets solution on one level to zero, including ghost zones
+ */
+
+static void zero_mg_Phi(MGrid *pMG)
+{
+  int i,j,k;
+
+  for (k=pMG->ks-1; k<=pMG->ke+1; k++){
+    for (j=pMG->js-1; j<=pMG->je+1; j++){
+      for (i=pMG->is-1; i<=pMG->ie+1; i++){
+        pMG->Phi[k][j][i] = 0.0;
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void use_mg_hier(MGHier *pH)
+ *  \brief Makes pH the hierarchy that the functions below work on
+ */
+
+static void use_mg_hier(MGHier *pH)
+{
+  MGLev = pH->Lev;
+  NMGLev = pH->NLev;
+  all_periodic = pH->all_periodic;
+  mg_ncoarse = pH->ncoarse;
+#ifdef MPI_PARALLEL
+  MG_Comm = pH->Comm;
+#endif
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void GaussSeidel_3d(MGrid *pMG, int nsweep)
+ *  \brief Red-black Gauss-Seidel sweeps.
  *
- *   Do not use with periodic BCs, uses multipole expansion
- *   to compute potential at boundary
+ *   Zones are coloured by the parity of their global index i+j+k, so the
+ *   result does not depend on the decomposition.  Ghost zones are exchanged
+ *   after each colour.  Boundary values at non-periodic edges of the Domain
+ *   are held fixed.
  */
-void Jacobi(MGrid *pMG)
+void GaussSeidel_3d(MGrid *pMG, int nsweep)
 {
   int i, is = pMG->is, ie = pMG->ie;
   int j, js = pMG->js, je = pMG->je;
   int k, ks = pMG->ks, ke = pMG->ke;
-  int n;
+  int n, color, off;
   Real dx1sq = (pMG->dx1*pMG->dx1);
   Real dx2sq = (pMG->dx2*pMG->dx2);
   Real dx3sq = (pMG->dx3*pMG->dx3);
+  Real diag = 1.0/(2.0/dx1sq + 2.0/dx2sq + 2.0/dx3sq);
 
-/* Jacobi iterations in 3D */
-
-  if (pMG->Nx3 > 1) {
-    for (n=0; n<=10; n++){  /* hardwired to do 10 iterations */
-      for (k=ks; k<=ke; k++){
-        for (j=js; j<=je; j++){
-          for (i=is; i<=ie; i++){
-            error[k][j][i] = -pMG->rhs[k][j][i];
-            error[k][j][i] += (pMG->Phi[k][j][i+1] + pMG->Phi[k][j][i-1])/dx1sq;
-            error[k][j][i] += (pMG->Phi[k][j+1][i] + pMG->Phi[k][j-1][i])/dx2sq;
-            error[k][j][i] += (pMG->Phi[k+1][j][i] + pMG->Phi[k-1][j][i])/dx3sq;
-          }
-        }
-      }
+  off = pMG->Cut[0][pMG->Blk[0]] + pMG->Cut[1][pMG->Blk[1]]
+      + pMG->Cut[2][pMG->Blk[2]];
 
+  for (n=0; n<nsweep; n++){
+    for (color=0; color<2; color++){
       for (k=ks; k<=ke; k++){
         for (j=js; j<=je; j++){
-          for (i=is; i<=ie; i++){
-            pMG->Phi[k][j][i] = error[k][j][i]/(2.0/dx1sq + 2.0/dx2sq + 2.0/dx3sq);
+          for (i=is+((is+j+k+off+color)&1); i<=ie; i+=2){
+            pMG->Phi[k][j][i] = diag*(
+                (pMG->Phi[k][j][i+1] + pMG->Phi[k][j][i-1])/dx1sq
+              + (pMG->Phi[k][j+1][i] + pMG->Phi[k][j-1][i])/dx2sq
+              + (pMG->Phi[k+1][j][i] + pMG->Phi[k-1][j][i])/dx3sq
+              - pMG->rhs[k][j][i]);
           }
         }
       }
-#ifdef MPI_PARALLEL
       set_mg_bvals(pMG);
-#endif
     }
   }
 
-/* Jacobi iterations in 2D (x-y plane) */
+  return;
+}
 
-  if (pMG->Nx3 == 1) {
-    for (n=0; n<=10; n++){  /* hardwired to do 10 iterations */
-      for (j=js; j<=je; j++){
-        for (i=is; i<=ie; i++){
-          error[ks][j][i] = -pMG->rhs[ks][j][i];
-          error[ks][j][i] += (pMG->Phi[ks][j][i+1] + pMG->Phi[ks][j][i-1])/dx1sq;
-          error[ks][j][i] += (pMG->Phi[ks][j+1][i] + pMG->Phi[ks][j-1][i])/dx2sq;
+/*----------------------------------------------------------------------------*/
+/*! \fn static void CoarseSolve_3d(MGrid *pMG)
+ *  \brief Solves on the coarsest level.
+ *
+ *   The coarsest level is normally owned by a single process, which sweeps
+ *   until the RMS residual has dropped by MG_COARSE_TOL (or MG_COARSE_MAX
+ *   sweeps).  With periodic BCs the mean of the RHS is removed first, since
+ *   the equation has no solution otherwise.  If the root level is also the
+ *   coarsest it may be shared by several processes, and a fixed number of
+ *   sweeps is done.
+ */
+
+static void CoarseSolve_3d(MGrid *pMG)
+{
+  int i,j,k,n;
+  Real mean=0.0, r0, r;
+
+  if (pMG->NBlk[0]*pMG->NBlk[1]*pMG->NBlk[2] > 1) {
+    GaussSeidel_3d(pMG, mg_ncoarse);
+    return;
+  }
+
+  if (all_periodic) {
+    for (k=pMG->ks; k<=pMG->ke; k++){
+      for (j=pMG->js; j<=pMG->je; j++){
+        for (i=pMG->is; i<=pMG->ie; i++){
+          mean += pMG->rhs[k][j][i];
         }
       }
-
-      for (j=js; j<=je; j++){
-        for (i=is; i<=ie; i++){
-          pMG->Phi[ks][j][i] = error[ks][j][i]/(2.0/dx1sq + 2.0/dx2sq);
+    }
+    mean /= (Real)(pMG->Nx1*pMG->Nx2*pMG->Nx3);
+    for (k=pMG->ks; k<=pMG->ke; k++){
+      for (j=pMG->js; j<=pMG->je; j++){
+        for (i=pMG->is; i<=pMG->ie; i++){
+          pMG->rhs[k][j][i] -= mean;
         }
       }
-#ifdef MPI_PARALLEL
-      set_mg_bvals(pMG);
-#endif
     }
   }
 
+  Residual_3d(pMG);
+  r0 = sumsq_3d(pMG, error);
+  for (n=0; n<MG_COARSE_MAX; n+=mg_ncoarse){
+    GaussSeidel_3d(pMG, mg_ncoarse);
+    Residual_3d(pMG);
+    r = sumsq_3d(pMG, error);
+    if (r <= MG_COARSE_TOL*MG_COARSE_TOL*r0) break;
+  }
+
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse) 
- *  \brief Averages fine grid solution onto coarse
+/*! \fn static void Residual_3d(MGrid *pMG)
+ *  \brief Computes residual rhs - Lap(Phi) of the block of one level in the
+ *   error array.  Ghost zones of Phi must be set.
  */
 
-void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse)
+static void Residual_3d(MGrid *pMG)
 {
-  int i, is = pMG_fine->is, ie = pMG_fine->ie;
-  int j, js = pMG_fine->js, je = pMG_fine->je;
-  int k, ks = pMG_fine->ks, ke = pMG_fine->ke;
-  Real dx1sq = (pMG_fine->dx1*pMG_fine->dx1);
-  Real dx2sq = (pMG_fine->dx2*pMG_fine->dx2);
-  Real dx3sq = (pMG_fine->dx3*pMG_fine->dx3);
+  int i, is = pMG->is, ie = pMG->ie;
+  int j, js = pMG->js, je = pMG->je;
+  int k, ks = pMG->ks, ke = pMG->ke;
+  Real dx1sq = (pMG->dx1*pMG->dx1);
+  Real dx2sq = (pMG->dx2*pMG->dx2);
+  Real dx3sq = (pMG->dx3*pMG->dx3);
 
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
-        error[k][j][i] = pMG_fine->rhs[k][j][i];
-        error[k][j][i] -= (pMG_fine->Phi[k][j][i+1] + pMG_fine->Phi[k][j][i-1]
-          - 2.0*pMG_fine->Phi[k][j][i]) / dx1sq;
-        error[k][j][i] -= (pMG_fine->Phi[k][j+1][i] + pMG_fine->Phi[k][j-1][i]
-          - 2.0*pMG_fine->Phi[k][j][i]) / dx2sq;
-        error[k][j][i] -= (pMG_fine->Phi[k+1][j][i] + pMG_fine->Phi[k-1][j][i]
-          - 2.0*pMG_fine->Phi[k][j][i]) / dx3sq;
+        error[k][j][i] = pMG->rhs[k][j][i];
+        error[k][j][i] -= (pMG->Phi[k][j][i+1] + pMG->Phi[k][j][i-1]
+          - 2.0*pMG->Phi[k][j][i]) / dx1sq;
+        error[k][j][i] -= (pMG->Phi[k][j+1][i] + pMG->Phi[k][j-1][i]
+          - 2.0*pMG->Phi[k][j][i]) / dx2sq;
+        error[k][j][i] -= (pMG->Phi[k+1][j][i] + pMG->Phi[k-1][j][i]
+          - 2.0*pMG->Phi[k][j][i]) / dx3sq;
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real sumsq_3d(MGrid *pMG, Real ***a)
+ *  \brief Sum of squares of array a over the block of one level
+ */
+
+static Real sumsq_3d(MGrid *pMG, Real ***a)
+{
+  int i,j,k;
+  Real sum = 0.0;
+
+  for (k=pMG->ks; k<=pMG->ke; k++){
+    for (j=pMG->js; j<=pMG->je; j++){
+      for (i=pMG->is; i<=pMG->ie; i++){
+        sum += a[k][j][i]*a[k][j][i];
       }
     }
   }
 
-  for(k=ks; k<=pMG_coarse->ke; k++){
-    for (j=js; j<=pMG_coarse->je; j++){
-      for (i=is; i<=pMG_coarse->ie; i++){
-        pMG_coarse->Phi[k][j][i] =
-          (pMG_fine->Phi[2*k  ][2*j  ][2*i] + pMG_fine->Phi[2*k  ][2*j  ][2*i-1]
-         + pMG_fine->Phi[2*k  ][2*j-1][2*i] + pMG_fine->Phi[2*k  ][2*j-1][2*i-1]
-         + pMG_fine->Phi[2*k-1][2*j  ][2*i] + pMG_fine->Phi[2*k-1][2*j  ][2*i-1]
-         + pMG_fine->Phi[2*k-1][2*j-1][2*i] + pMG_fine->Phi[2*k-1][2*j-1][2*i-1])/8.0 ;
+  return sum;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real rms_3d(MGrid *pMG, Real ***a)
+ *  \brief RMS over all blocks of the root level of array a
+ */
+
+static Real rms_3d(MGrid *pMG, Real ***a)
+{
+  Real sum[2], tsum[2];
+#ifdef MPI_PARALLEL
+  int mpi_err;
+#endif
+
+  sum[0] = sumsq_3d(pMG, a);
+  sum[1] = (Real)(pMG->Nx1*pMG->Nx2*pMG->Nx3);
+
+#ifdef MPI_PARALLEL
+  mpi_err = MPI_Allreduce(sum, tsum, 2, MPI_DOUBLE, MPI_SUM, MG_Comm);
+  if (mpi_err) ath_error("[rms_3d]: MPI_Allreduce returned err = %d\n",
+    mpi_err);
+#else
+  tsum[0] = sum[0];
+  tsum[1] = sum[1];
+#endif /* MPI_PARALLEL */
+
+  return sqrt(tsum[0]/tsum[1]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse)
+ *  \brief Averages residual on fine level onto RHS of coarse level.
+ *
+ *   The residual is computed in the error array on each fine block.  If the
+ *   coarse level is agglomerated, the residuals of all fine blocks covered by
+ *   a coarse block are first gathered into the error array of its owner.
+ */
+
+void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse)
+{
+  int i,j,k;
+
+  if (pMG_fine->Blk[0] >= 0) Residual_3d(pMG_fine);
+
+#ifdef MPI_PARALLEL
+  gather_mg(pMG_fine, pMG_coarse);
+#endif
+
+  if (pMG_coarse->Blk[0] < 0) return;
+
+  for(k=pMG_coarse->ks; k<=pMG_coarse->ke; k++){
+    for (j=pMG_coarse->js; j<=pMG_coarse->je; j++){
+      for (i=pMG_coarse->is; i<=pMG_coarse->ie; i++){
         pMG_coarse->rhs[k][j][i] =
            (error[2*k  ][2*j  ][2*i] + error[2*k  ][2*j  ][2*i-1]
           + error[2*k  ][2*j-1][2*i] + error[2*k  ][2*j-1][2*i-1]
@@ -491,78 +834,95 @@ void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse)
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void Prolongation_3d(MGrid *pMG_coarse, MGrid *pMG_fine)
- *  \brief Linear interpolation of coarse grid onto fine  
+ *  \brief Trilinear interpolation of coarse correction onto fine, which is
+ *   then added to the fine solution.
+ *
+ *   The interpolated correction is stored in the error array of the owner of
+ *   the coarse block, and sent back to the fine blocks it covers if the
+ *   coarse level is agglomerated.
  */
 void Prolongation_3d(MGrid *pMG_coarse, MGrid *pMG_fine)
 {
   int i, is = pMG_coarse->is, ie = pMG_coarse->ie;
   int j, js = pMG_coarse->js, je = pMG_coarse->je;
   int k, ks = pMG_coarse->ks, ke = pMG_coarse->ke;
+  int n, si, sj, sk;
+  Real ***pc = pMG_coarse->Phi;
 
-  for (k=ks; k<=ke; k++){
-  for (j=js; j<=je; j++){
-    for (i=is; i<=ie; i++){
-      pMG_fine->Phi[2*k  ][2*j  ][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j  ][2*i  ] += 0.25*pMG_coarse->Phi[k+1][j+1][i+1];
-
-      pMG_fine->Phi[2*k  ][2*j  ][2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j  ][2*i-1] += 0.25*pMG_coarse->Phi[k+1][j+1][i-1];
-
-      pMG_fine->Phi[2*k  ][2*j-1][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j-1][2*i  ] += 0.25*pMG_coarse->Phi[k+1][j-1][i+1];
-
-      pMG_fine->Phi[2*k-1][2*j  ][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j  ][2*i  ] += 0.25*pMG_coarse->Phi[k-1][j+1][i+1];
-
-      pMG_fine->Phi[2*k  ][2*j-1][2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j-1][2*i-1] += 0.25*pMG_coarse->Phi[k+1][j-1][i-1];
+  if (pMG_coarse->Blk[0] >= 0) {
+    for (k=ks; k<=ke; k++){
+    for (j=js; j<=je; j++){
+      for (i=is; i<=ie; i++){
+        for (n=0; n<8; n++){
+          si = (n & 1) ? 1 : -1;
+          sj = (n & 2) ? 1 : -1;
+          sk = (n & 4) ? 1 : -1;
+          error[2*k-(sk<0)][2*j-(sj<0)][2*i-(si<0)] =
+              (27.0*pc[k][j][i]
+             + 9.0*(pc[k][j][i+si] + pc[k][j+sj][i] + pc[k+sk][j][i])
+             + 3.0*(pc[k][j+sj][i+si] + pc[k+sk][j][i+si] + pc[k+sk][j+sj][i])
+             + pc[k+sk][j+sj][i+si])/64.0;
+        }
+      }
+    }}
+  }
 
-      pMG_fine->Phi[2*k-1][2*j-1][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j-1][2*i  ] += 0.25*pMG_coarse->Phi[k-1][j-1][i+1];
+#ifdef MPI_PARALLEL
+  scatter_mg(pMG_coarse, pMG_fine);
+#endif
 
-      pMG_fine->Phi[2*k-1][2*j]  [2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j]  [2*i-1] += 0.25*pMG_coarse->Phi[k-1][j+1][i-1];
+  if (pMG_fine->Blk[0] < 0) return;
 
-      pMG_fine->Phi[2*k-1][2*j-1][2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j-1][2*i-1] += 0.25*pMG_coarse->Phi[k-1][j-1][i-1];
+  for (k=pMG_fine->ks; k<=pMG_fine->ke; k++){
+    for (j=pMG_fine->js; j<=pMG_fine->je; j++){
+      for (i=pMG_fine->is; i<=pMG_fine->ie; i++){
+        pMG_fine->Phi[k][j][i] += error[k][j][i];
+      }
     }
-  }}
+  }
 
   return;
 }
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void set_mg_bvals(MGrid *pMG)
- *  \brief Sets BC for Jacobi iterates for MPI parallel jobs.
+ *  \brief Sets BC for Gauss-Seidel iterates on one level.
  *
- *   With self-gravity using multigrid, the boundary conditions at the edge of
- *   the Domain are held fixed.  So only ghostzones associated with internal
- *   boundaries between MPI grids need to be passed.
+ *   With self-gravity using multigrid, the boundary conditions at the
+ *   non-periodic edges of the Domain are held fixed.  So only ghostzones
+ *   associated with internal boundaries between blocks, or with periodic
+ *   boundaries, need to be set.  A block whose neighbour on both sides is
+ *   itself (periodic, one block in that direction) copies them locally.
  *
  * This routine is largely a copy of set_bvals().
  * Order for updating boundary conditions must always be x1-x2-x3 in order to
  * fill the corner cells properly
  */
 
-#ifdef MPI_PARALLEL
 void set_mg_bvals(MGrid *pMG)
 {
+#ifdef MPI_PARALLEL
   int cnt3, cnt, err;
-  MPI_Status stat;
   MPI_Request rq;
+#endif
 
 /*--- Step 1. ------------------------------------------------------------------
  * Boundary Conditions in x1-direction */
 
+  if (pMG->lx1_id == pMG->my_id) {
+    periodic_mg_x1(pMG);
+  }
+
+#ifdef MPI_PARALLEL
   cnt3 = 1;
   if (pMG->Nx3 > 1) cnt3 = pMG->Nx3;
   cnt = pMG->Nx2*cnt3;
 
 /* MPI blocks to both left and right */
-  if (pMG->rx1_id >= 0 && pMG->lx1_id >= 0) {
+  if (pMG->rx1_id >= 0 && pMG->lx1_id >= 0 && pMG->lx1_id != pMG->my_id) {
     /* Post a non-blocking receive for the input data from the left grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx1_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ox1(pMG,cnt,0,&rq);  /* send R */
@@ -570,7 +930,7 @@ void set_mg_bvals(MGrid *pMG)
 
     /* Post a non-blocking receive for the input data from the right grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx1_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ix1(pMG,cnt,0,&rq);  /* send L */
@@ -581,7 +941,7 @@ void set_mg_bvals(MGrid *pMG)
   if (pMG->rx1_id >= 0 && pMG->lx1_id < 0) {
     /* Post a non-blocking receive for the input data from the right grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx1_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ox1(pMG,cnt,0,&rq);  /* send R */
@@ -592,25 +952,31 @@ void set_mg_bvals(MGrid *pMG)
   if (pMG->rx1_id < 0 && pMG->lx1_id >= 0) {
     /* Post a non-blocking receive for the input data from the left grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx1_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ix1(pMG,cnt,0,&rq);  /* send L */
     swap_mg_ix1(pMG,cnt,1,&rq);  /* listen L */
   }
+#endif /* MPI_PARALLEL */
 
 /*--- Step 2. ------------------------------------------------------------------
  * Boundary Conditions in x2-direction */
 
+  if (pMG->lx2_id == pMG->my_id) {
+    periodic_mg_x2(pMG);
+  }
+
+#ifdef MPI_PARALLEL
   cnt3 = 1;
   if (pMG->Nx3 > 1) cnt3 = pMG->Nx3;
   cnt = (pMG->Nx1 + 2)*cnt3;
 
 /* MPI blocks to both left and right */
-  if (pMG->rx2_id >= 0 && pMG->lx2_id >= 0) {
+  if (pMG->rx2_id >= 0 && pMG->lx2_id >= 0 && pMG->lx2_id != pMG->my_id) {
     /* Post a non-blocking receive for the input data from the left grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx2_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ox2(pMG,cnt,0,&rq);  /* send R */
@@ -618,7 +984,7 @@ void set_mg_bvals(MGrid *pMG)
 
     /* Post a non-blocking receive for the input data from the right grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx2_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ix2(pMG,cnt,0,&rq);  /* send L */
@@ -629,7 +995,7 @@ void set_mg_bvals(MGrid *pMG)
   if (pMG->rx2_id >= 0 && pMG->lx2_id < 0) {
     /* Post a non-blocking receive for the input data from the right grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx2_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ox2(pMG,cnt,0,&rq);  /* send R */
@@ -640,65 +1006,155 @@ void set_mg_bvals(MGrid *pMG)
   if (pMG->rx2_id < 0 && pMG->lx2_id >= 0) {
     /* Post a non-blocking receive for the input data from the left grid */
     err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx2_id,
-      boundary_cells_tag, MPI_COMM_WORLD, &rq);
+      mg_halo_tag, MG_Comm, &rq);
     if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
 
     swap_mg_ix2(pMG,cnt,0,&rq);  /* send L */
     swap_mg_ix2(pMG,cnt,1,&rq);  /* listen L */
   }
+#endif /* MPI_PARALLEL */
+
+/*--- Step 3. ------------------------------------------------------------------
+ * Boundary Conditions in x3-direction */
+
+  if (pMG->Nx3 > 1){
+
+    if (pMG->lx3_id == pMG->my_id) {
+      periodic_mg_x3(pMG);
+    }
+
+#ifdef MPI_PARALLEL
+    cnt = (pMG->Nx1 + 2)*(pMG->Nx2 + 2);
+
+/* MPI blocks to both left and right */
+    if (pMG->rx3_id >= 0 && pMG->lx3_id >= 0 && pMG->lx3_id != pMG->my_id) {
+      /* Post a non-blocking receive for the input data from the left grid */
+      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx3_id,
+		      mg_halo_tag, MG_Comm, &rq);
+      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+
+      swap_mg_ox3(pMG,cnt,0,&rq);  /* send R */
+      swap_mg_ix3(pMG,cnt,1,&rq);  /* listen L */
+
+      /* Post a non-blocking receive for the input data from the right grid */
+      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx3_id,
+		      mg_halo_tag, MG_Comm, &rq);
+      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+
+      swap_mg_ix3(pMG,cnt,0,&rq);  /* send L */
+      swap_mg_ox3(pMG,cnt,1,&rq);  /* listen R */
+    }
+
+/* Physical boundary on left, MPI block on right */
+    if (pMG->rx3_id >= 0 && pMG->lx3_id < 0) {
+      /* Post a non-blocking receive for the input data from the right grid */
+      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx3_id,
+		      mg_halo_tag, MG_Comm, &rq);
+      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+
+      swap_mg_ox3(pMG,cnt,0,&rq);  /* send R */
+      swap_mg_ox3(pMG,cnt,1,&rq);  /* listen R */
+    }
+
+/* MPI block on left, Physical boundary on right */
+    if (pMG->rx3_id < 0 && pMG->lx3_id >= 0) {
+      /* Post a non-blocking receive for the input data from the left grid */
+      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx3_id,
+		      mg_halo_tag, MG_Comm, &rq);
+      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+
+      swap_mg_ix3(pMG,cnt,0,&rq);  /* send L */
+      swap_mg_ix3(pMG,cnt,1,&rq);  /* listen L */
+    }
+#endif /* MPI_PARALLEL */
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void periodic_mg_x1(MGrid *pMG)
+ *  \brief Periodic ghost zones in x1 of a block spanning the Domain in x1
+ */
+
+static void periodic_mg_x1(MGrid *pMG)
+{
+  int j,jl,ju,k,kl,ku;
+
+  jl = pMG->js;
+  ju = pMG->je;
+
+  if(pMG->Nx3 > 1){
+    kl = pMG->ks;
+    ku = pMG->ke;
+  } else {
+    kl = ku = pMG->ks;
+  }
 
-/*--- Step 3. ------------------------------------------------------------------
- * Boundary Conditions in x3-direction */
+  for (k=kl; k<=ku; k++){
+    for (j=jl; j<=ju; j++){
+      pMG->Phi[k][j][pMG->is-1] = pMG->Phi[k][j][pMG->ie];
+      pMG->Phi[k][j][pMG->ie+1] = pMG->Phi[k][j][pMG->is];
+    }
+  }
 
-  if (pMG->Nx3 > 1){
+  return;
+}
 
-    cnt = (pMG->Nx1 + 2)*(pMG->Nx2 + 2);
+/*----------------------------------------------------------------------------*/
+/*! \fn static void periodic_mg_x2(MGrid *pMG)
+ *  \brief Periodic ghost zones in x2 of a block spanning the Domain in x2
+ */
 
-/* MPI blocks to both left and right */
-    if (pMG->rx3_id >= 0 && pMG->lx3_id >= 0) {
-      /* Post a non-blocking receive for the input data from the left grid */
-      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx3_id,
-		      boundary_cells_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+static void periodic_mg_x2(MGrid *pMG)
+{
+  int i,il,iu,k,kl,ku;
 
-      swap_mg_ox3(pMG,cnt,0,&rq);  /* send R */
-      swap_mg_ix3(pMG,cnt,1,&rq);  /* listen L */
+  il = pMG->is - 1;
+  iu = pMG->ie + 1;
 
-      /* Post a non-blocking receive for the input data from the right grid */
-      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx3_id,
-		      boundary_cells_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+  if(pMG->Nx3 > 1){
+    kl = pMG->ks;
+    ku = pMG->ke;
+  } else {
+    kl = ku = pMG->ks;
+  }
 
-      swap_mg_ix3(pMG,cnt,0,&rq);  /* send L */
-      swap_mg_ox3(pMG,cnt,1,&rq);  /* listen R */
+  for (k=kl; k<=ku; k++){
+    for (i=il; i<=iu; i++){
+      pMG->Phi[k][pMG->js-1][i] = pMG->Phi[k][pMG->je][i];
+      pMG->Phi[k][pMG->je+1][i] = pMG->Phi[k][pMG->js][i];
     }
+  }
 
-/* Physical boundary on left, MPI block on right */
-    if (pMG->rx3_id >= 0 && pMG->lx3_id < 0) {
-      /* Post a non-blocking receive for the input data from the right grid */
-      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->rx3_id,
-		      boundary_cells_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+  return;
+}
 
-      swap_mg_ox3(pMG,cnt,0,&rq);  /* send R */
-      swap_mg_ox3(pMG,cnt,1,&rq);  /* listen R */
-    }
+/*----------------------------------------------------------------------------*/
+/*! \fn static void periodic_mg_x3(MGrid *pMG)
+ *  \brief Periodic ghost zones in x3 of a block spanning the Domain in x3
+ */
 
-/* MPI block on left, Physical boundary on right */
-    if (pMG->rx3_id < 0 && pMG->lx3_id >= 0) {
-      /* Post a non-blocking receive for the input data from the left grid */
-      err = MPI_Irecv(recv_buf, cnt, MPI_DOUBLE, pMG->lx3_id,
-		      boundary_cells_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_mg_bvals]: MPI_Irecv error = %d\n",err);
+static void periodic_mg_x3(MGrid *pMG)
+{
+  int i,il,iu,j,jl,ju;
 
-      swap_mg_ix3(pMG,cnt,0,&rq);  /* send L */
-      swap_mg_ix3(pMG,cnt,1,&rq);  /* listen L */
+  il = pMG->is - 1;
+  iu = pMG->ie + 1;
+  jl = pMG->js - 1;
+  ju = pMG->je + 1;
+
+  for (j=jl; j<=ju; j++){
+    for (i=il; i<=iu; i++){
+      pMG->Phi[pMG->ks-1][j][i] = pMG->Phi[pMG->ke][j][i];
+      pMG->Phi[pMG->ke+1][j][i] = pMG->Phi[pMG->ks][j][i];
     }
   }
 
   return;
 }
 
+#ifdef MPI_PARALLEL
 /*----------------------------------------------------------------------------*/
 /*! \fn void swap_mg_ix1(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
  *  \brief MPI_SWAP of boundary conditions, Inner x1 boundary
@@ -735,7 +1191,7 @@ void swap_mg_ix1(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
     /* send contents of buffer to the neighboring grid on L-x1 */
     err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pMG->lx1_id,
-                   boundary_cells_tag, MPI_COMM_WORLD);
+                   mg_halo_tag, MG_Comm);
     if(err) ath_error("[swap_mg_ix1]: MPI_Send error = %d\n",err);
   }
 
@@ -793,7 +1249,7 @@ void swap_mg_ox1(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
     /* send contents of buffer to the neighboring grid on R-x1 */
     err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pMG->rx1_id,
-      boundary_cells_tag, MPI_COMM_WORLD);
+      mg_halo_tag, MG_Comm);
     if(err) ath_error("[swap_mg_ox1]: MPI_Send error = %d\n",err);
   }
 
@@ -827,7 +1283,8 @@ void swap_mg_ix2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 {
   int i,il,iu,k,kl,ku,err;
   MPI_Status stat;
-  double *pd = send_buf;
+  double *psb = send_buf;
+  double *prb = recv_buf;
 
   il = pMG->is - 1;
   iu = pMG->ie + 1;
@@ -844,13 +1301,13 @@ void swap_mg_ix2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
   if (swap_flag == 0) {
     for (k=kl; k<=ku; k++){
       for (i=il; i<=iu; i++){
-        *(pd++) = pMG->Phi[k][pMG->js][i];
+        *(psb++) = pMG->Phi[k][pMG->js][i];
       }
     }
 
     /* send contents of buffer to the neighboring grid on L-x2 */
     err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pMG->lx2_id,
-       boundary_cells_tag, MPI_COMM_WORLD);
+       mg_halo_tag, MG_Comm);
     if(err) ath_error("[swap_mg_ix2]: MPI_Send error = %d\n",err);
   }
 
@@ -864,7 +1321,7 @@ void swap_mg_ix2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
     for (k=kl; k<=ku; k++){
       for (i=il; i<=iu; i++){
-        pMG->Phi[k][pMG->js-1][i] = *(pd++);
+        pMG->Phi[k][pMG->js-1][i] = *(prb++);
       }
     }
   }
@@ -884,7 +1341,8 @@ void swap_mg_ox2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 {
   int i,il,iu,k,kl,ku,err;
   MPI_Status stat;
-  double *pd = send_buf;
+  double *psb = send_buf;
+  double *prb = recv_buf;
 
   il = pMG->is - 1;
   iu = pMG->ie + 1;
@@ -901,13 +1359,13 @@ void swap_mg_ox2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
   if (swap_flag == 0) {
     for (k=kl; k<=ku; k++){
       for (i=il; i<=iu; i++){
-        *(pd++) = pMG->Phi[k][pMG->je][i];
+        *(psb++) = pMG->Phi[k][pMG->je][i];
       }
     }
 
     /* send contents of buffer to the neighboring grid on R-x2 */
     err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pMG->rx2_id,
-                   boundary_cells_tag, MPI_COMM_WORLD);
+                   mg_halo_tag, MG_Comm);
     if(err) ath_error("[swap_mg_ox2]: MPI_Send error = %d\n",err);
   }
 
@@ -921,7 +1379,7 @@ void swap_mg_ox2(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
     for (k=kl; k<=ku; k++){
       for (i=il; i<=iu; i++){
-        pMG->Phi[k][pMG->je+1][i] = *(pd++);
+        pMG->Phi[k][pMG->je+1][i] = *(prb++);
       }
     }
   }
@@ -941,7 +1399,8 @@ void swap_mg_ix3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 {
   int i,il,iu,j,jl,ju,err;
   MPI_Status stat;
-  double *pd = send_buf;
+  double *psb = send_buf;
+  double *prb = recv_buf;
 
   il = pMG->is - 1;
   iu = pMG->ie + 1;
@@ -953,13 +1412,13 @@ void swap_mg_ix3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
   if (swap_flag == 0) {
     for (j=jl; j<=ju; j++){
       for (i=il; i<=iu; i++){
-        *(pd++) = pMG->Phi[pMG->ks][j][i];
+        *(psb++) = pMG->Phi[pMG->ks][j][i];
       }
     }
 
     /* send contents of buffer to the neighboring grid on L-x3 */
     err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pMG->lx3_id,
-                   boundary_cells_tag, MPI_COMM_WORLD);
+                   mg_halo_tag, MG_Comm);
     if(err) ath_error("[swap_mg_ix3]: MPI_Send error = %d\n",err);
   }
 
@@ -973,7 +1432,7 @@ void swap_mg_ix3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
     for (j=jl; j<=ju; j++){
       for (i=il; i<=iu; i++){
-        pMG->Phi[pMG->ks-1][j][i] = *(pd++);
+        pMG->Phi[pMG->ks-1][j][i] = *(prb++);
       }
     }
   }
@@ -993,7 +1452,8 @@ void swap_mg_ox3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 {
   int i,il,iu,j,jl,ju,err;
   MPI_Status stat;
-  double *pd = send_buf;
+  double *psb = send_buf;
+  double *prb = recv_buf;
 
   il = pMG->is - 1;
   iu = pMG->ie + 1;
@@ -1005,13 +1465,13 @@ void swap_mg_ox3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
   if (swap_flag == 0) {
     for (j=jl; j<=ju; j++){
       for (i=il; i<=iu; i++){
-        *(pd++) = pMG->Phi[pMG->ke][j][i];
+        *(psb++) = pMG->Phi[pMG->ke][j][i];
       }
     }
 
     /* send contents of buffer to the neighboring grid on R-x3 */
     err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pMG->rx3_id,
-                   boundary_cells_tag, MPI_COMM_WORLD);
+                   mg_halo_tag, MG_Comm);
     if(err) ath_error("[swap_mg_ox3]: MPI_Send error = %d\n",err);
   }
 
@@ -1025,7 +1485,160 @@ void swap_mg_ox3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
     for (j=jl; j<=ju; j++){
       for (i=il; i<=iu; i++){
-        pMG->Phi[pMG->ke+1][j][i] = *(pd++);
+        pMG->Phi[pMG->ke+1][j][i] = *(prb++);
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void gather_mg(MGrid *pMG_fine, MGrid *pMG_coarse)
+ *  \brief Sends the residual in the error array of each fine block to the
+ *   owner of the coarse block covering it, which unpacks it at the right
+ *   offset in its own error array.  Nothing is sent if the coarse level is
+ *   not agglomerated.
+ *
+ *   The owner of a coarse block also owns the fine block at its lowest
+ *   corner, whose residual is already in place.
+ */
+
+static void gather_mg(MGrid *pMG_fine, MGrid *pMG_coarse)
+{
+  MGrid *pF = pMG_fine, *pC = pMG_coarse;
+  int i,j,k,l,m,n,il,iu,jl,ju,kl,ku,cnt,err,owner;
+  MPI_Status stat;
+  double *pd;
+
+  if (pF->Merge[0] == 1 && pF->Merge[1] == 1 && pF->Merge[2] == 1) return;
+
+/* Fine blocks not owned by the owner of the coarse block send residual */
+
+  if (pF->Blk[0] >= 0) {
+    owner = pC->ID[pF->Blk[2]/pF->Merge[2]][pF->Blk[1]/pF->Merge[1]]
+                  [pF->Blk[0]/pF->Merge[0]];
+    if (owner != pF->my_id) {
+      pd = send_buf;
+      for (k=pF->ks; k<=pF->ke; k++){
+        for (j=pF->js; j<=pF->je; j++){
+          for (i=pF->is; i<=pF->ie; i++){
+            *(pd++) = error[k][j][i];
+          }
+        }
+      }
+      cnt = pF->Nx1*pF->Nx2*pF->Nx3;
+      err = MPI_Send(send_buf, cnt, MPI_DOUBLE, owner, mg_transfer_tag,
+                     MG_Comm);
+      if(err) ath_error("[gather_mg]: MPI_Send error = %d\n",err);
+    }
+  }
+
+/* Owner of the coarse block receives residual of all other fine blocks */
+
+  if (pC->Blk[0] >= 0) {
+    for (n=pC->Blk[2]*pF->Merge[2];
+         n<MIN((pC->Blk[2]+1)*pF->Merge[2],pF->NBlk[2]); n++){
+    for (m=pC->Blk[1]*pF->Merge[1];
+         m<MIN((pC->Blk[1]+1)*pF->Merge[1],pF->NBlk[1]); m++){
+    for (l=pC->Blk[0]*pF->Merge[0];
+         l<MIN((pC->Blk[0]+1)*pF->Merge[0],pF->NBlk[0]); l++){
+      if (pF->ID[n][m][l] == pC->my_id) continue;
+
+      il = pF->Cut[0][l] - 2*pC->Cut[0][pC->Blk[0]] + 1;
+      iu = pF->Cut[0][l+1] - 2*pC->Cut[0][pC->Blk[0]];
+      jl = pF->Cut[1][m] - 2*pC->Cut[1][pC->Blk[1]] + 1;
+      ju = pF->Cut[1][m+1] - 2*pC->Cut[1][pC->Blk[1]];
+      kl = pF->Cut[2][n] - 2*pC->Cut[2][pC->Blk[2]] + 1;
+      ku = pF->Cut[2][n+1] - 2*pC->Cut[2][pC->Blk[2]];
+      cnt = (iu-il+1)*(ju-jl+1)*(ku-kl+1);
+
+      err = MPI_Recv(recv_buf, cnt, MPI_DOUBLE, pF->ID[n][m][l],
+                     mg_transfer_tag, MG_Comm, &stat);
+      if(err) ath_error("[gather_mg]: MPI_Recv error = %d\n",err);
+
+      pd = recv_buf;
+      for (k=kl; k<=ku; k++){
+        for (j=jl; j<=ju; j++){
+          for (i=il; i<=iu; i++){
+            error[k][j][i] = *(pd++);
+          }
+        }
+      }
+    }}}
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void scatter_mg(MGrid *pMG_coarse, MGrid *pMG_fine)
+ *  \brief Reverse of gather_mg(): sends the interpolated correction in the
+ *   error array of the owner of each coarse block back to the fine blocks
+ *   it covers.
+ */
+
+static void scatter_mg(MGrid *pMG_coarse, MGrid *pMG_fine)
+{
+  MGrid *pF = pMG_fine, *pC = pMG_coarse;
+  int i,j,k,l,m,n,il,iu,jl,ju,kl,ku,cnt,err,owner;
+  MPI_Status stat;
+  double *pd;
+
+  if (pF->Merge[0] == 1 && pF->Merge[1] == 1 && pF->Merge[2] == 1) return;
+
+/* Owner of the coarse block sends correction to all other fine blocks */
+
+  if (pC->Blk[0] >= 0) {
+    for (n=pC->Blk[2]*pF->Merge[2];
+         n<MIN((pC->Blk[2]+1)*pF->Merge[2],pF->NBlk[2]); n++){
+    for (m=pC->Blk[1]*pF->Merge[1];
+         m<MIN((pC->Blk[1]+1)*pF->Merge[1],pF->NBlk[1]); m++){
+    for (l=pC->Blk[0]*pF->Merge[0];
+         l<MIN((pC->Blk[0]+1)*pF->Merge[0],pF->NBlk[0]); l++){
+      if (pF->ID[n][m][l] == pC->my_id) continue;
+
+      il = pF->Cut[0][l] - 2*pC->Cut[0][pC->Blk[0]] + 1;
+      iu = pF->Cut[0][l+1] - 2*pC->Cut[0][pC->Blk[0]];
+      jl = pF->Cut[1][m] - 2*pC->Cut[1][pC->Blk[1]] + 1;
+      ju = pF->Cut[1][m+1] - 2*pC->Cut[1][pC->Blk[1]];
+      kl = pF->Cut[2][n] - 2*pC->Cut[2][pC->Blk[2]] + 1;
+      ku = pF->Cut[2][n+1] - 2*pC->Cut[2][pC->Blk[2]];
+      cnt = (iu-il+1)*(ju-jl+1)*(ku-kl+1);
+
+      pd = send_buf;
+      for (k=kl; k<=ku; k++){
+        for (j=jl; j<=ju; j++){
+          for (i=il; i<=iu; i++){
+            *(pd++) = error[k][j][i];
+          }
+        }
+      }
+
+      err = MPI_Send(send_buf, cnt, MPI_DOUBLE, pF->ID[n][m][l],
+                     mg_transfer_tag, MG_Comm);
+      if(err) ath_error("[scatter_mg]: MPI_Send error = %d\n",err);
+    }}}
+  }
+
+/* Other fine blocks receive correction into their error array */
+
+  if (pF->Blk[0] >= 0) {
+    owner = pC->ID[pF->Blk[2]/pF->Merge[2]][pF->Blk[1]/pF->Merge[1]]
+                  [pF->Blk[0]/pF->Merge[0]];
+    if (owner != pF->my_id) {
+      cnt = pF->Nx1*pF->Nx2*pF->Nx3;
+      err = MPI_Recv(recv_buf, cnt, MPI_DOUBLE, owner, mg_transfer_tag,
+                     MG_Comm, &stat);
+      if(err) ath_error("[scatter_mg]: MPI_Recv error = %d\n",err);
+
+      pd = recv_buf;
+      for (k=pF->ks; k<=pF->ke; k++){
+        for (j=pF->js; j<=pF->je; j++){
+          for (i=pF->is; i<=pF->ie; i++){
+            error[k][j][i] = *(pd++);
+          }
+        }
       }
     }
   }
@@ -1034,99 +1647,596 @@ void swap_mg_ox3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 }
 #endif /* MPI_PARALLEL */
 
+#ifdef STATIC_MESH_REFINEMENT
 /*----------------------------------------------------------------------------*/
-/*! \fn void selfg_multig_3d_init(MeshS *pM)
- *  \brief Initialize send/receive buffers needed to swap
- *   iterates during Jacobi iterations.
+/*! \fn static void selfg_multig_smr_3d(MeshS *pM)
+ *  \brief Solves for the potential on the composite grid of all levels by
+ *   passes over the levels, as described at the top of this file.  Must be
+ *   called by every process.
  */
 
-void selfg_multig_3d_init(MeshS *pM)
+static void selfg_multig_smr_3d(MeshS *pM)
 {
+  DomainS *pD;
+  int nl,nd,n,ncyc,tcyc;
+  Real mass, tmass, drho;
 #ifdef MPI_PARALLEL
-  int i,j,k,x1cnt,x2cnt,x3cnt;
-  int nx1t,nx2t,nx3t, size;
-  int NGrid_x1, NGrid_x2, NGrid_x3;
+  int mpi_err;
 #endif
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
 
-/* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
+/* Copy current potential into old on every Grid */
+
   for (nl=0; nl<(pM->NLevels); nl++){
     for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-      if (pM->Domain[nl][nd].Grid != NULL) {
-        if (pM->Domain[nl][nd].Grid->Nx[0] > size1){
-          size1 = pM->Domain[nl][nd].Grid->Nx[0];
-        }
-        if (pM->Domain[nl][nd].Grid->Nx[1] > size2){
-          size2 = pM->Domain[nl][nd].Grid->Nx[1];
-        }
-        if (pM->Domain[nl][nd].Grid->Nx[2] > size3){
-          size3 = pM->Domain[nl][nd].Grid->Nx[2];
+      if (pM->Domain[nl][nd].Grid != NULL)
+        save_Phi_old(pM->Domain[nl][nd].Grid);
+    }
+  }
+
+/* Boundary values use the mass on the root Domain, which holds the
+ * restricted density of all finer levels */
+
+  mass = 0.0;
+  if (pM->Domain[0][0].Grid != NULL) mass = grid_mass(pM->Domain[0][0].Grid);
+#ifdef MPI_PARALLEL
+  mpi_err = MPI_Allreduce(&mass, &tmass, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  if (mpi_err) ath_error("[selfg_multig_smr_3d]: MPI_Allreduce err = %d\n",
+    mpi_err);
+#else
+  tmass = mass;
+#endif /* MPI_PARALLEL */
+  drho = (root_periodic ? grav_mean_rho : 0.0);
+
+  for (n=0; n<mg_smr_cycles; n++){
+
+/* Solve on each level from the root down.  Boundary values on fine/coarse
+ * boundaries are interpolated from the parent.  The RHS of parents uses the
+ * restricted solution and fluxes of children, once they exist. */
+
+    ncyc = 0;
+    for (nl=0; nl<(pM->NLevels); nl++){
+      if (nl > 0) {
+        for (nd=0; nd<(pM->DomainsPerLevel[nl-1]); nd++){
+          if (pM->Domain[nl-1][nd].Grid != NULL)
+            bvals_grav(&(pM->Domain[nl-1][nd]));
         }
+        Prolongate_Phi(pM, nl-1);
+      }
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        pD = &(pM->Domain[nl][nd]);
+        if (pD->Grid == NULL) continue;
+        use_mg_hier(&(MGH[nl][nd]));
+        mg_bvals_3d(pD->Grid, &(MGH[nl][nd]), tmass);
+        ncyc += solve_mg_3d(pD, drho, (n > 0 || smr_warm));
       }
     }
+
+/* The composite solution is converged once no level needed a cycle */
+
+#ifdef MPI_PARALLEL
+    mpi_err = MPI_Allreduce(&ncyc, &tcyc, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (mpi_err) ath_error("[selfg_multig_smr_3d]: MPI_Allreduce err = %d\n",
+      mpi_err);
+#else
+    tcyc = ncyc;
+#endif /* MPI_PARALLEL */
+    if (pM->NLevels == 1 || (tcyc == 0 && (n > 0 || smr_warm))) break;
+
+/* Restrict solution and fluxes from the finest level up */
+
+    for (nl=(pM->NLevels)-1; nl>0; nl--) RestrictCorrect_Phi(pM, nl);
   }
+  if (n == mg_smr_cycles)
+    ath_perr(-1,"[selfg_multig_smr_3d]: not converged after %d passes\n",n);
+  smr_warm = 1;
+
+/* Set ghost zones on fine/coarse boundaries from the final solution on the
+ * parent.  Other ghost zones are set by bvals_grav() in main() */
 
-  size1 += 2;
-  size2 += 2;
-  size3 += 2;
-  error = (Real ***)calloc_3d_array(size3, size2, size1, sizeof(Real));
-  if (error == NULL) {
-    ath_error("[multig_3d]: Error allocating memory for error array\n");
+  for (nl=0; nl<(pM->NLevels)-1; nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if (pM->Domain[nl][nd].Grid != NULL) bvals_grav(&(pM->Domain[nl][nd]));
+    }
+    Prolongate_Phi(pM, nl);
   }
 
-/* Allocate memory for send and receive buffers for Phi in MultiGrid
- * structure for MPI parallel.
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void smr_rhs_3d(GridS *pG, MGrid *pMG)
+ *  \brief Corrects the RHS on level 0 of the hierarchy of Grid pG (its
+ *   parent Grid, pMG) under and next to its child Grids.
+ *
+ *   Under a child, the RHS is the Laplacian of the restricted solution, so
+ *   that it is unchanged by the solve once the passes have converged.  Next
+ *   to a child, the flux of the gradient through the fine/coarse boundary is
+ *   replaced by the fine one (see smr_defect_3d()).  The Phi array of pMG
+ *   and its ghost zones must be set.
  */
-#ifdef MPI_PARALLEL
-  NGrid_x1 = par_geti("parallel","NGrid_x1");
-  NGrid_x2 = par_geti("parallel","NGrid_x2");
-  NGrid_x3 = par_geti("parallel","NGrid_x3");
-
-  x1cnt = x2cnt = x3cnt = 0;
-        
-  for (k=0; k<NGrid_x3; k++){
-    for (j=0; j<NGrid_x2; j++){
-      for (i=0; i<NGrid_x1; i++){
-        if(NGrid_x1 > 1){
-          nx2t = pD->grid_block[k][j][i].jde - pD->grid_block[k][j][i].jds + 1;
-          nx3t = pD->grid_block[k][j][i].kde - pD->grid_block[k][j][i].kds + 1;
-        
-          x1cnt = nx2t*nx3t > x1cnt ? nx2t*nx3t : x1cnt;
-        }
-        
-        if(NGrid_x2 > 1){
-          nx1t = pD->grid_block[k][j][i].ide - pD->grid_block[k][j][i].ids + 1;
-          if(nx1t > 1) nx1t += 2;
-          nx3t = pD->grid_block[k][j][i].kde - pD->grid_block[k][j][i].kds + 1;
 
-          x2cnt = nx1t*nx3t > x2cnt ? nx1t*nx3t : x2cnt;
+static void smr_rhs_3d(GridS *pG, MGrid *pMG)
+{
+  GridOvrlpS *pCO;
+  int i,j,k,ii,jj,kk,ncg;
+  Real dx1sq = (pMG->dx1*pMG->dx1);
+  Real dx2sq = (pMG->dx2*pMG->dx2);
+  Real dx3sq = (pMG->dx3*pMG->dx3);
+
+  for (ncg=0; ncg<(pG->NCGrid); ncg++){
+    pCO = &(pG->CGrid[ncg]);
+    if (pCO->nWordsRC == 0) continue;
+
+    for (k=pCO->ijks[2]; k<=pCO->ijke[2]; k++){
+      kk = k - pG->ks + 1;
+      for (j=pCO->ijks[1]; j<=pCO->ijke[1]; j++){
+        jj = j - pG->js + 1;
+        for (i=pCO->ijks[0]; i<=pCO->ijke[0]; i++){
+          ii = i - pG->is + 1;
+          pMG->rhs[kk][jj][ii] =
+              (pMG->Phi[kk][jj][ii+1] + pMG->Phi[kk][jj][ii-1]
+             - 2.0*pMG->Phi[kk][jj][ii]) / dx1sq
+            + (pMG->Phi[kk][jj+1][ii] + pMG->Phi[kk][jj-1][ii]
+             - 2.0*pMG->Phi[kk][jj][ii]) / dx2sq
+            + (pMG->Phi[kk+1][jj][ii] + pMG->Phi[kk-1][jj][ii]
+             - 2.0*pMG->Phi[kk][jj][ii]) / dx3sq;
         }
+      }
+    }
+  }
+
+  smr_defect_3d(pG, pMG);
+
+  return;
+}
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void smr_defect_3d(GridS *pG, MGrid *pMG)
+ *  \brief Adds to the RHS of pMG (level 0 of the hierarchy of pG) the
+ *   mismatch of coarse and fine fluxes through the fine/coarse boundaries of
+ *   the child Grids of pG, in the zones of pG next to them.
+ *
+ *   The defect D in a zone is (coarse flux - fine flux)/dx of the face it
+ *   shares with the child, with the fine flux from RestrictCorrect_Phi().
+ *   With D added to its RHS, the standard 7-point Laplacian gives the
+ *   composite one.  D is not zero on the composite solution.
+ */
+
+static void smr_defect_3d(GridS *pG, MGrid *pMG)
+{
+  GridOvrlpS *pCO;
+  Real ***phi = pMG->Phi;
+  int oi = pG->is - 1, oj = pG->js - 1, ok = pG->ks - 1;
+  int i,j,k,ii,jj,kk,ib,jb,kb,lo,hi,ncg,dim;
+  int ics,ice,jcs,jce,kcs,kce;
+  Real D;
+
+  for (ncg=0; ncg<(pG->NCGrid); ncg++){
+    pCO = &(pG->CGrid[ncg]);
+    if (pCO->nWordsRC == 0) continue;
+    ics = pCO->ijks[0];
+    ice = pCO->ijke[0];
+    jcs = pCO->ijks[1];
+    jce = pCO->ijke[1];
+    kcs = pCO->ijks[2];
+    kce = pCO->ijke[2];
+
+/* x1-faces.  Zone i is next to the child, and ib is under it */
+
+    for (dim=0; dim<2; dim++){
+      if (pCO->myPhiFlx[dim] == NULL) continue;
+      if (dim == 0) {i = ics-1; ib = ics;}
+      else          {i = ice+1; ib = ice;}
+      if (i < pG->is || i > pG->ie) continue;
+      lo = MIN(i,ib) - oi;
+      hi = MAX(i,ib) - oi;
+      for (k=kcs, kk=0; k<=kce; k++, kk++){
+        for (j=jcs, jj=0; j<=jce; j++, jj++){
+          D = ((phi[k-ok][j-oj][hi] - phi[k-ok][j-oj][lo])/pG->dx1
+              - pCO->myPhiFlx[dim][kk][jj])/pG->dx1;
+          if (dim == 1) D = -D;
+          pMG->rhs[k-ok][j-oj][i-oi] += D;
+        }
+      }
+    }
 
-        if(NGrid_x3 > 1){
-          nx1t = pD->grid_block[k][j][i].ide - pD->grid_block[k][j][i].ids + 1;
-          if(nx1t > 1) nx1t += 2;
-          nx2t = pD->grid_block[k][j][i].jde - pD->grid_block[k][j][i].jds + 1;
-          if(nx2t > 1) nx2t += 2;
+/* x2-faces */
+
+    for (dim=2; dim<4; dim++){
+      if (pCO->myPhiFlx[dim] == NULL) continue;
+      if (dim == 2) {j = jcs-1; jb = jcs;}
+      else          {j = jce+1; jb = jce;}
+      if (j < pG->js || j > pG->je) continue;
+      lo = MIN(j,jb) - oj;
+      hi = MAX(j,jb) - oj;
+      for (k=kcs, kk=0; k<=kce; k++, kk++){
+        for (i=ics, ii=0; i<=ice; i++, ii++){
+          D = ((phi[k-ok][hi][i-oi] - phi[k-ok][lo][i-oi])/pG->dx2
+              - pCO->myPhiFlx[dim][kk][ii])/pG->dx2;
+          if (dim == 3) D = -D;
+          pMG->rhs[k-ok][j-oj][i-oi] += D;
+        }
+      }
+    }
 
-          x3cnt = nx1t*nx2t > x3cnt ? nx1t*nx2t : x3cnt;
+/* x3-faces */
+
+    for (dim=4; dim<6; dim++){
+      if (pCO->myPhiFlx[dim] == NULL) continue;
+      if (dim == 4) {k = kcs-1; kb = kcs;}
+      else          {k = kce+1; kb = kce;}
+      if (k < pG->ks || k > pG->ke) continue;
+      lo = MIN(k,kb) - ok;
+      hi = MAX(k,kb) - ok;
+      for (j=jcs, jj=0; j<=jce; j++, jj++){
+        for (i=ics, ii=0; i<=ice; i++, ii++){
+          D = ((phi[hi][j-oj][i-oi] - phi[lo][j-oj][i-oi])/pG->dx3
+              - pCO->myPhiFlx[dim][jj][ii])/pG->dx3;
+          if (dim == 5) D = -D;
+          pMG->rhs[k-ok][j-oj][i-oi] += D;
         }
       }
     }
   }
 
-  size = x1cnt > x2cnt ? x1cnt : x2cnt;
-  size = x3cnt >  size ? x3cnt : size;
+  return;
+}
+#endif /* STATIC_MESH_REFINEMENT */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static size_t mg_pool_bytes(int nt, int nr, int nc)
+ *  \brief Bytes taken in the memory pool by a 3D array of Real
+ *   array[nt][nr][nc] whose rows are padded to a multiple of ATH_ALIGN bytes
+ */
+
+static size_t mg_pool_bytes(int nt, int nr, int nc)
+{
+  size_t pitch = ((nc*sizeof(Real) + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+
+  return (size_t)nt*(size_t)nr*pitch;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real ***mg_pool_array(unsigned char **pp, int nt, int nr,
+ *                                   int nc)
+ *  \brief Builds 3D array of Real array[nt][nr][nc] over the memory pool at
+ *   *pp, and advances *pp past it
+ */
+
+static Real ***mg_pool_array(unsigned char **pp, int nt, int nr, int nc)
+{
+  size_t pitch = ((nc*sizeof(Real) + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+  Real ***array;
+
+  array = (Real ***)map_3d_array(*pp, nt, nr, pitch);
+  if (array == NULL)
+    ath_error("[mg_pool_array]: Error allocating memory for some level\n");
+  *pp += mg_pool_bytes(nt, nr, nc);
+
+  return array;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void selfg_multig_3d_init(MeshS *pM)
+ *  \brief Builds the multigrid hierarchy of every Domain with a Grid on this
+ *   process, the error array, and the send/receive buffers needed to swap
+ *   iterates during Gauss-Seidel iterations.  Reads the parameters
+ *   of the multigrid cycle.
+ */
+
+void selfg_multig_3d_init(MeshS *pM)
+{
+  DomainS *pD;
+  int nl,nd,size[3],bsize=0;
+  size_t pool;
+  unsigned char *pp;
+  char *cycle;
+
+/* Parameters of the multigrid cycle */
+
+  cycle = par_gets_def("gravity","mg_cycle","V");
+  if (strcmp(cycle,"V") == 0) {
+    mg_gamma = 1;  mg_fmg = 0;
+  } else if (strcmp(cycle,"W") == 0) {
+    mg_gamma = 2;  mg_fmg = 0;
+  } else if (strcmp(cycle,"FMG") == 0) {
+    mg_gamma = 1;  mg_fmg = 1;
+  } else {
+    ath_error("[selfg_multig_3d_init]: mg_cycle = %s unknown\n",cycle);
+  }
+  free(cycle);
+  mg_tol = par_getd_def("gravity","mg_tol",1.0e-6);
+  mg_max_cycles = par_geti_def("gravity","mg_max_cycles",20);
+  mg_nsweep = par_geti_def("gravity","mg_nsweep",2);
+#ifdef STATIC_MESH_REFINEMENT
+  mg_smr_cycles = par_geti_def("gravity","mg_smr_cycles",10);
+  pMesh = pM;
+  root_periodic = (pM->BCFlag_ix1 == 4 && pM->BCFlag_ox1 == 4) &&
+                  (pM->BCFlag_ix2 == 4 && pM->BCFlag_ox2 == 4) &&
+                  (pM->BCFlag_ix3 == 4 && pM->BCFlag_ox3 == 4);
+#endif
+
+/* Build the hierarchy of every Domain with a Grid on this process */
+
+  if ((MGH = (MGHier**)calloc_1d_array(pM->NLevels, sizeof(MGHier*))) == NULL)
+    ath_error("[selfg_multig_3d_init]: Error allocating hierarchies\n");
+  size[0] = size[1] = size[2] = 0;
+  for (nl=0; nl<(pM->NLevels); nl++){
+    MGH[nl] = (MGHier*)calloc_1d_array(pM->DomainsPerLevel[nl],sizeof(MGHier));
+    if (MGH[nl] == NULL)
+      ath_error("[selfg_multig_3d_init]: Error allocating hierarchies\n");
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      if (pD->Grid == NULL) continue;
+#ifdef STATIC_MESH_REFINEMENT
+      if (mg_first == NULL) mg_first = pD;
+#endif
+      init_mg_hier(pM, pD, &(MGH[nl][nd]), size, &bsize);
+    }
+  }
+#ifdef STATIC_MESH_REFINEMENT
+  if (mg_first == NULL)
+    ath_error("[selfg_multig_3d_init]: multigrid with SMR needs a Grid on every process\n");
+#endif
+  if (size[0] == 0) return;
+
+/* The error array holds any block, and the fine-level region covered by it.
+ * Like the levels, it is built once and reused by every solve. */
 
-  if (size > 0) {
-    if((send_buf = (double*)malloc(size*sizeof(double))) == NULL)
+  pool = mg_pool_bytes(size[2]+2, size[1]+2, size[0]+2);
+  if (posix_memalign(&mg_pool, ATH_ALIGN, pool) != 0)
+    ath_error("[selfg_multig_3d_init]: Error allocating memory pool\n");
+  memset(mg_pool, 0, pool);
+  pp = (unsigned char *)mg_pool;
+  error = mg_pool_array(&pp, size[2]+2, size[1]+2, size[0]+2);
+
+/* Allocate memory for send and receive buffers for Phi in MultiGrid
+ * structure for MPI parallel, shared by all hierarchies.
+ */
+#ifdef MPI_PARALLEL
+  if (bsize > 0) {
+    if((send_buf = (double*)malloc(bsize*sizeof(double))) == NULL)
       ath_error("[selfg_by_multig_3d_init]: Failed to allocate send buffer\n");
 
-    if((recv_buf = (double*)malloc(size*sizeof(double))) == NULL)
+    if((recv_buf = (double*)malloc(bsize*sizeof(double))) == NULL)
       ath_error("[selfg_by_multig_3d_init]: Failed to allocate recv buffer\n");
   }
 #endif /* MPI_PARALLEL */
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void init_mg_hier(MeshS *pM, DomainS *pD, MGHier *pH,
+ *                               int size[3], int *bsize)
+ *  \brief Builds the multigrid hierarchy of Domain pD: the decomposition of
+ *   every level, and the arrays of the levels owned by this process.
+ *   Increases size[] to the largest block (or region of the finer level
+ *   covered by a block) in each direction, and *bsize to the largest MPI
+ *   message, over all levels.
+ *
+ *   Levels are coarsened by factors of two until some direction has 4 or
+ *   fewer zones, or an odd number of zones.  Level 0 is decomposed like the
+ *   Grids in the Domain.  Going to the next level, pairs of blocks in a
+ *   direction are merged (repeatedly) while some block would have an odd
+ *   number of zones, or fewer than MG_MIN_ZONES zones on the coarse level.
+ *   The coarsest level is always agglomerated onto a single process, so that
+ *   it can be solved to convergence without communication.
+ */
+
+static void init_mg_hier(MeshS *pM, DomainS *pD, MGHier *pH, int size[3],
+                         int *bsize)
+{
+  MGrid *pF, *pC;
+  int l,m,n,dir,nl,nlev,nx[3],b,f,bad,cnt;
+  size_t pool;
+  unsigned char *pp;
+  int my_id=0,per[3],bc[3][2],nroot;
+#ifdef MPI_PARALLEL
+  int i,j,k,myL,myM,myN;
+#endif
+
+/* Count levels, and allocate hierarchy */
+
+  for (dir=0; dir<3; dir++) nx[dir] = pD->Nx[dir];
+  nlev = 1;
+  while (nx[0] > 4 && nx[1] > 4 && nx[2] > 4 &&
+         nx[0]%2 == 0 && nx[1]%2 == 0 && nx[2]%2 == 0) {
+    for (dir=0; dir<3; dir++) nx[dir] /= 2;
+    nlev++;
+  }
+  pH->NLev = nlev;
+
+/* Sweeps on the coarsest level between checks of its residual */
+  pH->ncoarse = MAX(nx[0],MAX(nx[1],nx[2]));
+  if ((pH->Lev = (MGrid*)calloc_1d_array(nlev, sizeof(MGrid))) == NULL)
+    ath_error("[selfg_multig_3d_init]: Error allocating hierarchy\n");
+
+#ifdef MPI_PARALLEL
+  pH->Comm = pD->Comm_Domain;
+  get_myGridIndex(pD, myID_Comm_world, &myL, &myM, &myN);
+  my_id = pD->GData[myN][myM][myL].ID_Comm_Domain;
+#endif
+
+/* A direction is periodic if the BCs of the Mesh are, and the Domain spans
+ * the root Domain in that direction.  Edges of the Domain inside the root
+ * Domain are fine/coarse boundaries. */
+
+  bc[0][0] = pM->BCFlag_ix1;  bc[0][1] = pM->BCFlag_ox1;
+  bc[1][0] = pM->BCFlag_ix2;  bc[1][1] = pM->BCFlag_ox2;
+  bc[2][0] = pM->BCFlag_ix3;  bc[2][1] = pM->BCFlag_ox3;
+  for (dir=0; dir<3; dir++) {
+    nroot = pM->Nx[dir]*(1 << pD->Level);
+    pH->edge[dir][0] = (pD->Disp[dir] == 0);
+    pH->edge[dir][1] = (pD->Disp[dir] + pD->Nx[dir] == nroot);
+    per[dir] = (bc[dir][0] == 4 && bc[dir][1] == 4 &&
+                pH->edge[dir][0] && pH->edge[dir][1]);
+  }
+  pH->all_periodic = per[0] && per[1] && per[2];
+
+/* Level 0 is decomposed like the Grids of the Domain */
+
+  pF = &(pH->Lev[0]);
+  for (dir=0; dir<3; dir++) {
+    pF->NBlk[dir] = pD->NGrid[dir];
+    if ((pF->Cut[dir] = (int*)calloc_1d_array(pF->NBlk[dir]+1, sizeof(int)))
+        == NULL) ath_error("[selfg_multig_3d_init]: Error allocating cuts\n");
+  }
+  for (l=0; l<pF->NBlk[0]; l++)
+    pF->Cut[0][l+1] = pF->Cut[0][l] + pD->GData[0][0][l].Nx[0];
+  for (m=0; m<pF->NBlk[1]; m++)
+    pF->Cut[1][m+1] = pF->Cut[1][m] + pD->GData[0][m][0].Nx[1];
+  for (n=0; n<pF->NBlk[2]; n++)
+    pF->Cut[2][n+1] = pF->Cut[2][n] + pD->GData[n][0][0].Nx[2];
+
+  pF->ID = (int***)calloc_3d_array(pF->NBlk[2],pF->NBlk[1],pF->NBlk[0],
+    sizeof(int));
+  if (pF->ID == NULL)
+    ath_error("[selfg_multig_3d_init]: Error allocating block IDs\n");
+#ifdef MPI_PARALLEL
+  for (n=0; n<pF->NBlk[2]; n++)
+    for (m=0; m<pF->NBlk[1]; m++)
+      for (l=0; l<pF->NBlk[0]; l++)
+        pF->ID[n][m][l] = pD->GData[n][m][l].ID_Comm_Domain;
+#endif
+  pF->dx1 = pD->dx[0];
+  pF->dx2 = pD->dx[1];
+  pF->dx3 = pD->dx[2];
+
+/* Each coarser level merges blocks of the finer level that are too small */
+
+  for (nl=1; nl<nlev; nl++) {
+    pF = &(pH->Lev[nl-1]);
+    pC = &(pH->Lev[nl]);
+    for (dir=0; dir<3; dir++) {
+      f = 1;
+      do {
+        bad = (nl == nlev-1);
+        for (b=0; b<pF->NBlk[dir]; b+=f) {
+          cnt = pF->Cut[dir][MIN(b+f,pF->NBlk[dir])] - pF->Cut[dir][b];
+          if (cnt%2 != 0 || cnt < 2*MG_MIN_ZONES) bad = 1;
+        }
+        if (bad && f < pF->NBlk[dir]) f *= 2;
+        else break;
+      } while (1);
+      pF->Merge[dir] = f;
+      pC->NBlk[dir] = (pF->NBlk[dir] + f - 1)/f;
+      if ((pC->Cut[dir] = (int*)calloc_1d_array(pC->NBlk[dir]+1, sizeof(int)))
+          == NULL) ath_error("[selfg_multig_3d_init]: Error allocating cuts\n");
+      for (b=0; b<pC->NBlk[dir]; b++) pC->Cut[dir][b] = pF->Cut[dir][b*f]/2;
+      pC->Cut[dir][pC->NBlk[dir]] = pF->Cut[dir][pF->NBlk[dir]]/2;
+    }
+    pC->ID = (int***)calloc_3d_array(pC->NBlk[2],pC->NBlk[1],pC->NBlk[0],
+      sizeof(int));
+    if (pC->ID == NULL)
+      ath_error("[selfg_multig_3d_init]: Error allocating block IDs\n");
+    for (n=0; n<pC->NBlk[2]; n++)
+      for (m=0; m<pC->NBlk[1]; m++)
+        for (l=0; l<pC->NBlk[0]; l++)
+          pC->ID[n][m][l] =
+            pF->ID[n*pF->Merge[2]][m*pF->Merge[1]][l*pF->Merge[0]];
+    pC->dx1 = 2.0*pF->dx1;
+    pC->dx2 = 2.0*pF->dx2;
+    pC->dx3 = 2.0*pF->dx3;
+  }
+  pC = &(pH->Lev[nlev-1]);
+  pC->Merge[0] = pC->Merge[1] = pC->Merge[2] = 1;
+
+/* Find the block owned by this process on each level, and its neighbours.
+ * Neighbours across periodic boundaries wrap around, possibly onto the
+ * same block. */
+
+  for (nl=0; nl<nlev; nl++) {
+    pF = &(pH->Lev[nl]);
+    pF->my_id = my_id;
+    pF->Blk[0] = pF->Blk[1] = pF->Blk[2] = -1;
+    for (n=0; n<pF->NBlk[2]; n++)
+      for (m=0; m<pF->NBlk[1]; m++)
+        for (l=0; l<pF->NBlk[0]; l++)
+          if (pF->ID[n][m][l] == my_id) {
+            pF->Blk[0] = l;  pF->Blk[1] = m;  pF->Blk[2] = n;
+          }
+
+    pF->lx1_id = pF->rx1_id = pF->lx2_id = pF->rx2_id = -1;
+    pF->lx3_id = pF->rx3_id = -1;
+    if (pF->Blk[0] < 0) continue;
+    l = pF->Blk[0];  m = pF->Blk[1];  n = pF->Blk[2];
+
+    pF->Nx1 = pF->Cut[0][l+1] - pF->Cut[0][l];
+    pF->Nx2 = pF->Cut[1][m+1] - pF->Cut[1][m];
+    pF->Nx3 = pF->Cut[2][n+1] - pF->Cut[2][n];
+    pF->is = 1;  pF->ie = pF->Nx1;
+    pF->js = 1;  pF->je = pF->Nx2;
+    pF->ks = 1;  pF->ke = pF->Nx3;
+
+    if (l > 0) pF->lx1_id = pF->ID[n][m][l-1];
+    else if (per[0]) pF->lx1_id = pF->ID[n][m][pF->NBlk[0]-1];
+    if (l < pF->NBlk[0]-1) pF->rx1_id = pF->ID[n][m][l+1];
+    else if (per[0]) pF->rx1_id = pF->ID[n][m][0];
+
+    if (m > 0) pF->lx2_id = pF->ID[n][m-1][l];
+    else if (per[1]) pF->lx2_id = pF->ID[n][pF->NBlk[1]-1][l];
+    if (m < pF->NBlk[1]-1) pF->rx2_id = pF->ID[n][m+1][l];
+    else if (per[1]) pF->rx2_id = pF->ID[n][0][l];
+
+    if (n > 0) pF->lx3_id = pF->ID[n-1][m][l];
+    else if (per[2]) pF->lx3_id = pF->ID[pF->NBlk[2]-1][m][l];
+    if (n < pF->NBlk[2]-1) pF->rx3_id = pF->ID[n+1][m][l];
+    else if (per[2]) pF->rx3_id = pF->ID[0][m][l];
+
+/* The error array holds the block, and the fine-level region covered by it */
+
+    size[0] = MAX(size[0], pF->Nx1);
+    size[1] = MAX(size[1], pF->Nx2);
+    size[2] = MAX(size[2], pF->Nx3);
+    if (nl > 0) {
+      size[0] = MAX(size[0], 2*pF->Nx1);
+      size[1] = MAX(size[1], 2*pF->Nx2);
+      size[2] = MAX(size[2], 2*pF->Nx3);
+    }
+  }
+
+/* The RHS and solution of every level owned by this process, with one ghost
+ * zone each, are built once from a single pool of memory, and reused by
+ * every solve.  Every row is aligned to ATH_ALIGN. */
+
+  pool = 0;
+  for (nl=0; nl<nlev; nl++) {
+    pF = &(pH->Lev[nl]);
+    if (pF->Blk[0] >= 0)
+      pool += 2*mg_pool_bytes(pF->Nx3+2, pF->Nx2+2, pF->Nx1+2);
+  }
+  if (posix_memalign(&(pH->pool), ATH_ALIGN, pool) != 0)
+    ath_error("[selfg_multig_3d_init]: Error allocating memory pool\n");
+  memset(pH->pool, 0, pool);
+
+  pp = (unsigned char *)pH->pool;
+  for (nl=0; nl<nlev; nl++) {
+    pF = &(pH->Lev[nl]);
+    if (pF->Blk[0] < 0) continue;
+    pF->rhs = mg_pool_array(&pp, pF->Nx3+2, pF->Nx2+2, pF->Nx1+2);
+    pF->Phi = mg_pool_array(&pp, pF->Nx3+2, pF->Nx2+2, pF->Nx1+2);
+  }
+
+/* Send and receive buffers must hold one face (with ghost zones) of any
+ * block, and any block of a level that is merged onto the next. */
+#ifdef MPI_PARALLEL
+  for (nl=0; nl<nlev; nl++) {
+    pF = &(pH->Lev[nl]);
+    for (n=0; n<pF->NBlk[2]; n++){
+      for (m=0; m<pF->NBlk[1]; m++){
+        for (l=0; l<pF->NBlk[0]; l++){
+          i = pF->Cut[0][l+1] - pF->Cut[0][l] + 2;
+          j = pF->Cut[1][m+1] - pF->Cut[1][m] + 2;
+          k = pF->Cut[2][n+1] - pF->Cut[2][n] + 2;
+          *bsize = MAX(*bsize, MAX(i*j, MAX(i*k, j*k)));
+          if (pF->Merge[0]*pF->Merge[1]*pF->Merge[2] > 1)
+            *bsize = MAX(*bsize, i*j*k);
+        }
+      }
+    }
+  }
+#endif /* MPI_PARALLEL */
+  return;
+}
+
 #endif /* SELF_GRAVITY_USING_MULTIGRID */
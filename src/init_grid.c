@@ -8,17 +8,27 @@
  *   between child and parent Grids, and initializes data needed for restriction
  *   flux-correction, and prolongation steps.
  *
+ *   With MPI and <job>/shm_halo=1, U and the interface fields of all Grids of
+ *   a Domain on the same node are allocated in one MPI-3 shared-memory window,
+ *   so that bvals_mhd() can copy ghost zones directly from neighbouring Grids.
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - init_grid()
+ * - init_grid_smr() - finds overlaps between child and parent Grids with SMR
+ * - free_grid_smr() - frees the arrays allocated by init_grid_smr()
+ * - shm_grid_bytes() - size of U and B?i of a Grid in shared memory
+ * - shm_grid_map()   - sets U and B?i of a Grid to arrays in shared memory
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - checkOverlap() - checks for overlap of cubes, and returns overlap coords
- * - checkOverlapTouch() - same as above, but checks for overlap and/or touch */
+ * - checkOverlapTouch() - same as above, but checks for overlap and/or touch
+ * - shm_grid_alloc() - allocates U and B?i of a Grid in shared memory */
 /*============================================================================*/
 
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "defs.h"
 #include "athena.h"
 #include "globals.h"
@@ -37,6 +47,11 @@ int checkOverlap(SideS *pC1, SideS *pC2, SideS *pC3);
  *  \brief Same as above, but checks for overlap and/or touch */
 int checkOverlapTouch(SideS *pC1, SideS *pC2, SideS *pC3);
 #endif
+#ifdef MPI_PARALLEL
+/*! \fn static void shm_grid_alloc(DomainS *pD);
+ *  \brief Allocates U and B?i of the Grid in shared memory, if possible */
+static void shm_grid_alloc(DomainS *pD);
+#endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void init_grid(MeshS *pM)
@@ -49,14 +64,6 @@ void init_grid(MeshS *pM)
   GridS *pG;
   int nDim,nl,nd,myL,myM,myN;
   int i,l,m,n,n1z,n2z,n3z;
-#ifdef STATIC_MESH_REFINEMENT
-  DomainS *pCD,*pPD;
-  SideS D1,D2,D3,G1,G2,G3;
-  int isDOverlap,isGOverlap,irefine,ncd,npd,dim,iGrid;
-  int ncg,nCG,nMyCG,nCB[6],nMyCB[6],nb;
-  int npg,nPG,nMyPG,nPB[6],nMyPB[6];
-  int n1r,n2r,n1p,n2p;
-#endif
 
 /* number of dimensions in Grid. */
   nDim=1;
@@ -165,10 +172,32 @@ void init_grid(MeshS *pM)
       else
         n3z = 1;
 
-/* Build a 3D array of type ConsS */
-
+/* With <job>/shm_halo=1, U and the interface field are placed in memory
+ * shared with the other Grids of this Domain on the same node.  wtime starts
+ * measuring the cost of the Grid for load balancing */
+
+#ifdef MPI_PARALLEL
+      pG->wtime = 0.0;
+      pG->Comm_shm = MPI_COMM_NULL;
+      pG->Win_shm = MPI_WIN_NULL;
+      if (par_geti_def("job","shm_halo",0)) shm_grid_alloc(pD);
+      if (pG->Win_shm == MPI_WIN_NULL) {
+#endif /* MPI_PARALLEL */
+
+/* Build a 3D array of type ConsS, or with SOA_STORAGE an aligned 3D array
+ * for each conserved variable */
+
+#ifdef SOA_STORAGE
+      for (n=0; n<NVAR; n++) ((Real ****)&(pG->U))[n] = NULL;
+      for (n=0; n<NVAR; n++) {
+        ((Real ****)&(pG->U))[n] = 
+          (Real***)calloc_3d_aligned_array(n3z, n2z, n1z, sizeof(Real));
+        if (((Real ****)&(pG->U))[n] == NULL) goto on_error1;
+      }
+#else
       pG->U = (ConsS***)calloc_3d_array(n3z, n2z, n1z, sizeof(ConsS));
       if (pG->U == NULL) goto on_error1;
+#endif
     
 /* Build 3D arrays to hold interface field */
 
@@ -182,6 +211,14 @@ void init_grid(MeshS *pM)
       pG->B3i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
       if (pG->B3i == NULL) goto on_error4;
 #endif /* MHD */
+#ifdef MPI_PARALLEL
+      }
+#endif /* MPI_PARALLEL */
+
+#if defined(SOA_STORAGE) && defined(CYLINDRICAL)
+      pG->U.Pflux = (Real***)calloc_3d_aligned_array(n3z,n2z,n1z,sizeof(Real));
+      if (pG->U.Pflux == NULL) goto on_error1;
+#endif
 
 /* Build 3D arrays to magnetic diffusivities */
 
@@ -286,6 +323,81 @@ void init_grid(MeshS *pM)
   }}
 
 #ifdef STATIC_MESH_REFINEMENT
+  init_grid_smr(pM);
+#endif
+
+  return;
+
+/*--- Error messages ---------------------------------------------------------*/
+
+#ifdef CYLINDRICAL
+  on_error15:
+    free_1d_array(pG->ri);
+  on_error14:
+    free_1d_array(pG->r);
+#endif
+#ifdef SELF_GRAVITY
+  on_error13:
+    free_3d_array(pG->x3MassFlux);
+  on_error12:
+    free_3d_array(pG->x2MassFlux);
+  on_error11:
+    free_3d_array(pG->x1MassFlux);
+  on_error10:
+    free_3d_array(pG->Phi_old);
+  on_error9:
+    free_3d_array(pG->Phi);
+#endif
+#ifdef RESISTIVITY
+  on_error7:
+    free_3d_array(pG->eta_AD);
+  on_error6:
+    free_3d_array(pG->eta_Hall);
+  on_error5:
+    free_3d_array(pG->eta_Ohm);
+#endif
+#ifdef MHD
+  on_error4:
+    free_3d_array(pG->B3i);
+  on_error3:
+    free_3d_array(pG->B2i);
+  on_error2:
+    free_3d_array(pG->B1i);
+#endif
+  on_error1:
+#ifdef SOA_STORAGE
+    for (n=0; n<NVAR; n++)
+      if (((Real ****)&(pG->U))[n] != NULL)
+        free_3d_array(((Real ****)&(pG->U))[n]);
+#else
+    free_3d_array(pG->U);
+#endif
+    ath_error("[init_grid]: Error allocating memory\n");
+}
+
+#ifdef STATIC_MESH_REFINEMENT
+/*----------------------------------------------------------------------------*/
+/*! \fn void init_grid_smr(MeshS *pM)
+ *  \brief Finds all overlaps between child and parent Grids, and allocates the
+ *   arrays of fluxes and EMFs used for flux correction.  Called by init_grid(),
+ *   and again by Regrid() (after free_grid_smr()) when Domains have moved. */
+
+void init_grid_smr(MeshS *pM)
+{
+  DomainS *pD,*pCD,*pPD;
+  GridS *pG;
+  SideS D1,D2,D3,G1,G2,G3;
+  int nDim,nl,nd,myL,myM,myN;
+  int i,l,m,n,n1z,n2z,n3z;
+  int isDOverlap,isGOverlap,irefine,ncd,npd,dim,iGrid;
+  int ncg,nCG,nMyCG;
+  int npg,nPG,nMyPG;
+  int n1r,n2r,n1p,n2p;
+
+/* number of dimensions in Grid. */
+  nDim=1;
+  for (i=1; i<3; i++) if (pM->Nx[i]>1) nDim++;
+
 /*------------------- Count number of child Grids ----------------------------*/
 /* For each Grid, count the total number of child Grids before allocating the
  * CGrid array.  This way we know how many child Grids there are on the same
@@ -374,6 +486,9 @@ void init_grid(MeshS *pM)
             pG->CGrid[ncg].myEMF2[dim] = NULL;
             pG->CGrid[ncg].myEMF3[dim] = NULL;
 #endif /* MHD */
+#ifdef SELF_GRAVITY
+            pG->CGrid[ncg].myPhiFlx[dim] = NULL;
+#endif
           }
         }
       }
@@ -525,6 +640,12 @@ G3.ijkl[0],G3.ijkr[0]);
                       (ConsS**)calloc_2d_array(n2z,n1z, sizeof(ConsS));
                     if(pG->CGrid[ncg].myFlx[2*dim] == NULL) ath_error(
                      "[init_grid]:failed to allocate CGrid ixb myFlx\n");
+#ifdef SELF_GRAVITY
+                    pG->CGrid[ncg].myPhiFlx[2*dim] =
+                      (Real**)calloc_2d_array(n2z,n1z, sizeof(Real));
+                    if(pG->CGrid[ncg].myPhiFlx[2*dim] == NULL) ath_error(
+                     "[init_grid]:failed to allocate CGrid ixb myPhiFlx\n");
+#endif
 #ifdef MHD
                     pG->CGrid[ncg].nWordsP += 3*((nghost/2)+2)*n1p*n2p;
 
@@ -610,6 +731,12 @@ G3.ijkl[0],G3.ijkr[0]);
                       (ConsS**)calloc_2d_array(n2z,n1z, sizeof(ConsS));
                     if(pG->CGrid[ncg].myFlx[(2*dim)+1] == NULL) ath_error(
                       "[init_grid]:failed to allocate CGrid oxb myFlx\n");
+#ifdef SELF_GRAVITY
+                    pG->CGrid[ncg].myPhiFlx[(2*dim)+1] =
+                      (Real**)calloc_2d_array(n2z,n1z, sizeof(Real));
+                    if(pG->CGrid[ncg].myPhiFlx[(2*dim)+1] == NULL) ath_error(
+                     "[init_grid]:failed to allocate CGrid oxb myPhiFlx\n");
+#endif
 #ifdef MHD
                     pG->CGrid[ncg].nWordsP += 3*((nghost/2)+2)*n1p*n2p;
 
@@ -1085,50 +1212,54 @@ G3.ijkl[2],G3.ijkr[2]);
     } 
   }}
 
-#endif /* STATIC_MESH_REFINEMENT */
-
   return;
+}
 
-/*--- Error messages ---------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void free_grid_smr(MeshS *pM)
+ *  \brief Frees the CGrid and PGrid arrays, and the fluxes and EMFs in them,
+ *   allocated by init_grid_smr(). */
 
-#ifdef CYLINDRICAL
-  on_error15:
-    free_1d_array(pG->ri);
-  on_error14:
-    free_1d_array(pG->r);
-#endif
-#ifdef SELF_GRAVITY
-  on_error13:
-    free_3d_array(pG->x3MassFlux);
-  on_error12:
-    free_3d_array(pG->x2MassFlux);
-  on_error11:
-    free_3d_array(pG->x1MassFlux);
-  on_error10:
-    free_3d_array(pG->Phi_old);
-  on_error9:
-    free_3d_array(pG->Phi);
-#endif
-#ifdef RESISTIVITY
-  on_error7:
-    free_3d_array(pG->eta_AD);
-  on_error6:
-    free_3d_array(pG->eta_Hall);
-  on_error5:
-    free_3d_array(pG->eta_Ohm);
-#endif
+void free_grid_smr(MeshS *pM)
+{
+  GridS *pG;
+  GridOvrlpS *pO;
+  int nl,nd,n,dim;
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid == NULL) continue;
+    pG = pM->Domain[nl][nd].Grid;
+
+    for (n=0; n<(pG->NCGrid + pG->NPGrid); n++){
+      pO = (n < pG->NCGrid) ? &(pG->CGrid[n]) : &(pG->PGrid[n-pG->NCGrid]);
+      for (dim=0; dim<6; dim++) {
+        if (pO->myFlx[dim] != NULL) free_2d_array(pO->myFlx[dim]);
 #ifdef MHD
-  on_error4:
-    free_3d_array(pG->B3i);
-  on_error3:
-    free_3d_array(pG->B2i);
-  on_error2:
-    free_3d_array(pG->B1i);
+        if (pO->myEMF1[dim] != NULL) free_2d_array(pO->myEMF1[dim]);
+        if (pO->myEMF2[dim] != NULL) free_2d_array(pO->myEMF2[dim]);
+        if (pO->myEMF3[dim] != NULL) free_2d_array(pO->myEMF3[dim]);
+#endif /* MHD */
+#ifdef SELF_GRAVITY
+        if (n < pG->NCGrid && pO->myPhiFlx[dim] != NULL)
+          free_2d_array(pO->myPhiFlx[dim]);
 #endif
-  on_error1:
-    free_3d_array(pG->U);
-    ath_error("[init_grid]: Error allocating memory\n");
+      }
+    }
+    if (pG->CGrid != NULL) free_1d_array(pG->CGrid);
+    if (pG->PGrid != NULL) free_1d_array(pG->PGrid);
+
+    pG->NCGrid = 0;
+    pG->NPGrid = 0;
+    pG->NmyCGrid = 0;
+    pG->NmyPGrid = 0;
+    pG->CGrid = NULL;
+    pG->PGrid = NULL;
+  }}
+
+  return;
 }
+#endif /* STATIC_MESH_REFINEMENT */
 
 #ifdef STATIC_MESH_REFINEMENT
 /*=========================== PRIVATE FUNCTIONS ==============================*/
@@ -1204,3 +1335,127 @@ int checkOverlapTouch(SideS *pC1, SideS *pC2, SideS *pC3)
   return isOverlap;
 }
 #endif /* STATIC_MESH_REFINEMENT */
+
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn size_t shm_grid_bytes(const GridS *pG)
+ *  \brief Number of bytes of shared memory taken by U and B?i of a Grid with
+ *   dimensions pG->Nx, as laid out by shm_grid_map() */
+
+size_t shm_grid_bytes(const GridS *pG)
+{
+  size_t n1z,n2z,n3z,nb,bytes;
+
+  n1z = (pG->Nx[0] > 1) ? pG->Nx[0] + 2*nghost : 1;
+  n2z = (pG->Nx[1] > 1) ? pG->Nx[1] + 2*nghost : 1;
+  n3z = (pG->Nx[2] > 1) ? pG->Nx[2] + 2*nghost : 1;
+
+/* Each array starts on an ATH_ALIGN boundary; allow for aligning the base */
+  bytes = ATH_ALIGN;
+#ifdef SOA_STORAGE
+  nb = ((n1z*sizeof(Real) + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+  bytes += NVAR*n3z*n2z*nb;
+#else
+  nb = n3z*n2z*n1z*sizeof(ConsS);
+  bytes += ((nb + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+#endif /* SOA_STORAGE */
+#ifdef MHD
+  nb = n3z*n2z*n1z*sizeof(Real);
+  bytes += 3*(((nb + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN);
+#endif /* MHD */
+
+  return bytes;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void shm_grid_map(GridS *pG, void *base)
+ *  \brief Sets U and B?i of a Grid with dimensions pG->Nx to arrays in the
+ *   shared memory at base.  Used both for the Grid on this process and for
+ *   views of neighbouring Grids in bvals_mhd().  Only the pointers have to
+ *   be freed, with free_3d_map(). */
+
+void shm_grid_map(GridS *pG, void *base)
+{
+  size_t n1z,n2z,n3z,nb;
+  unsigned char *p = (unsigned char *)base;
+#ifdef SOA_STORAGE
+  int n;
+#endif
+
+  n1z = (pG->Nx[0] > 1) ? pG->Nx[0] + 2*nghost : 1;
+  n2z = (pG->Nx[1] > 1) ? pG->Nx[1] + 2*nghost : 1;
+  n3z = (pG->Nx[2] > 1) ? pG->Nx[2] + 2*nghost : 1;
+
+  p += (ATH_ALIGN - ((size_t)p)%ATH_ALIGN)%ATH_ALIGN;
+
+#ifdef SOA_STORAGE
+  nb = ((n1z*sizeof(Real) + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+  for (n=0; n<NVAR; n++) {
+    ((Real ****)&(pG->U))[n] = (Real***)map_3d_array(p, n3z, n2z, nb);
+    p += n3z*n2z*nb;
+  }
+#else
+  pG->U = (ConsS***)map_3d_array(p, n3z, n2z, n1z*sizeof(ConsS));
+  nb = n3z*n2z*n1z*sizeof(ConsS);
+  p += ((nb + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+#endif /* SOA_STORAGE */
+
+#ifdef MHD
+  nb = n3z*n2z*n1z*sizeof(Real);
+  nb = ((nb + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+  pG->B1i = (Real***)map_3d_array(p, n3z, n2z, n1z*sizeof(Real));
+  pG->B2i = (Real***)map_3d_array(p+nb, n3z, n2z, n1z*sizeof(Real));
+  pG->B3i = (Real***)map_3d_array(p+2*nb, n3z, n2z, n1z*sizeof(Real));
+#endif /* MHD */
+
+  return;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void shm_grid_alloc(DomainS *pD)
+ *  \brief Allocates U and B?i of the Grid of pD in a shared-memory window of
+ *   the ranks of the Domain on this node, and sets pG->Comm_shm and
+ *   pG->Win_shm.  Leaves both NULL if the Grid is alone on its node, in which
+ *   case the arrays are allocated as usual. */
+
+static void shm_grid_alloc(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  MPI_Comm comm;
+  MPI_Info info;
+  MPI_Win win;
+  MPI_Aint bytes;
+  void *base;
+  int size,ierr;
+
+  ierr = MPI_Comm_split_type(pD->Comm_Domain, MPI_COMM_TYPE_SHARED, 0,
+                             MPI_INFO_NULL, &comm);
+  ierr = MPI_Comm_size(comm, &size);
+  if (size == 1) {
+    ierr = MPI_Comm_free(&comm);
+    return;
+  }
+
+/* Separate segments, so that each Grid's memory is local to its process */
+  ierr = MPI_Info_create(&info);
+  ierr = MPI_Info_set(info, "alloc_shared_noncontig", "true");
+  bytes = (MPI_Aint)shm_grid_bytes(pG);
+  ierr = MPI_Win_allocate_shared(bytes, 1, info, comm, &base, &win);
+  ierr = MPI_Info_free(&info);
+  if (ierr != MPI_SUCCESS)
+    ath_error("[init_grid]: failed to allocate shared memory for Grid\n");
+
+  memset(base, 0, (size_t)bytes);
+  shm_grid_map(pG, base);
+
+/* Passive-target epoch for the life of the window; see shm_sync() in
+ * bvals_mhd.c for the synchronization of accesses */
+  ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+
+  pG->Comm_shm = comm;
+  pG->Win_shm = win;
+
+  return;
+}
+#endif /* MPI_PARALLEL */
@@ -34,18 +34,60 @@
  *   The init_grid() function initializes the data in each Grid structure in 
  *   each Domain, including finding all child and parent Grids with SMR.
  *
+ *   By default all Grids of a Domain have (nearly) the same size.  With MPI,
+ *   <domain>/LoadBalance moves the boundaries between Grids so that each Grid
+ *   has the same cost, given a cost per zone from either
+ *   - LoadBalance=1: the expression "load_weight" returned by get_usr_expr()
+ *     in the problem generator.  It is called before any Grid exists, with a
+ *     Grid covering the whole Domain with is=js=ks=0, so it may only use the
+ *     position of the zone (from cc_pos()), not the solution.
+ *   - LoadBalance=2: the wall time per zone of each Grid measured by an
+ *     earlier run, which every restart file records in GridCost_m_n (for the
+ *     row of Grids m,n in x2,x3) together with the boundaries of those Grids
+ *     in CostCuts_x1, CostCuts_x2 and CostCuts_x3.  This is an offline
+ *     re-decomposition: "athena -i file.rst <domain>/LoadBalance=2" reads
+ *     only the input parameters of the restart file, and starts a NEW run
+ *     from t=0 (from the problem generator) on Grids cut for the costs of the
+ *     earlier run.  A running simulation is never re-cut: a restart with -r
+ *     reads the data into the Grids it was written from, so LoadBalance > 0
+ *     is an error there.  It pays off when the same problem is run again, or
+ *     when the expensive regions of a run form in the same place every time.
+ *     With PARTICLES the part of that time spent on the particles
+ *     (ParCost_m_n) is spread over each Grid of the Domain with the particles
+ *     in proportion to where they were, given by the fraction of them in
+ *     each of up to NPROF slabs of the Grid in x1, x2 and x3 (ParProf_l_m_n),
+ *     so that the new Grid boundaries close in on where the particles of the
+ *     earlier run clumped.  The particles of the new run start from the
+ *     problem generator, so this only helps if they clump there again.
+ *   The Grid boundaries stay planes across the Domain in each direction, so
+ *   the cost is balanced over each row, column and layer of Grids.  The cuts
+ *   found are stored in Cuts_x1,x2,x3 and LoadBalance is reset to 0, so that
+ *   restarts use the same Grids.
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - init_mesh()
- * - get_myGridIndex()							      
+ * - get_myGridIndex()
+ * - record_grid_cost()
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - dom_decomp()    - calls auto domain decomposition functions 
  * - dom_decomp_2d() - finds optimum domain decomposition in 2D 
- * - dom_decomp_3d() - finds optimum domain decomposition in 3D		      */
+ * - dom_decomp_3d() - finds optimum domain decomposition in 3D
+ * - dom_balance()   - cuts a Domain into Grids of equal cost
+ * - balance_dir()   - optimizes the cuts in one direction
+ * - slab_cuts()     - cuts in one direction for a maximum cost per Grid
+ * - grid_cost()     - cost of every Grid for given cuts
+ * - zone_cost()     - cost of one zone
+ * - read_cuts()     - reads Grid boundaries from the input file
+ * - write_cuts()    - stores Grid boundaries in the input parameters
+ * - read_vals()     - reads a list of numbers from the input file
+ * - record_par_cost() - stores the cost of the particles on every Grid	      */
 /*============================================================================*/
 
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "defs.h"
 #include "athena.h"
 #include "globals.h"
@@ -75,20 +117,84 @@ static int dom_decomp_2d(const int Nx, const int Ny, const int Np,
  *  \brief finds optimum domain decomposition in 3D  */
 static int dom_decomp_3d(const int Nx, const int Ny, const int Nz, const int Np,
   int *pNGx, int *pNGy, int *pNGz);
+
+/*! \fn static void dom_balance(DomainS *pD, char *block, int *cut[3],
+ *                                 const int ires)
+ *  \brief cuts a Domain into Grids of equal cost */
+static void dom_balance(DomainS *pD, char *block, int *cut[3],
+                        const int ires);
+
+/*! \fn static int balance_dir(DomainS *pD, int *cut[3], const int dir)
+ *  \brief optimizes the cuts in one direction */
+static int balance_dir(DomainS *pD, int *cut[3], const int dir);
+
+/*! \fn static int slab_cuts(Real **proj, const int N, const int P,
+ *                           const int nb, const int minw, const Real cmax,
+ *                           const int even, int *c, Real *sum, Real *rem)
+ *  \brief cuts in one direction for a maximum cost per Grid */
+static int slab_cuts(Real **proj, const int N, const int P, const int nb,
+  const int minw, const Real cmax, const int even, int *c, Real *sum,
+  Real *rem);
+
+/*! \fn static void grid_cost(DomainS *pD, int *cut[3], Real *pmax,
+ *                            Real *pmean)
+ *  \brief cost of every Grid for given cuts */
+static void grid_cost(DomainS *pD, int *cut[3], Real *pmax, Real *pmean);
+
+/*! \fn static Real zone_cost(const int i, const int j, const int k)
+ *  \brief cost of one zone */
+static Real zone_cost(const int i, const int j, const int k);
+
+/*! \fn static int read_cuts(char *block, char *name, const int dir,
+ *                           const int nx, int **pcut)
+ *  \brief reads Grid boundaries from the input file */
+static int read_cuts(char *block, char *name, const int dir, const int nx,
+  int **pcut);
+
+/*! \fn static int write_cuts(char *block, char *name, DomainS *pD,
+ *                            int *cut[3])
+ *  \brief stores Grid boundaries in the input parameters */
+static int write_cuts(char *block, char *name, DomainS *pD, int *cut[3]);
+
+/*! \fn static void read_vals(char *block, char *name, const int n, Real *v)
+ *  \brief reads a list of numbers from the input file */
+static void read_vals(char *block, char *name, const int n, Real *v);
+
+#ifdef PARTICLES
+/*! \fn static void record_par_cost(DomainS *pD, char *block, int *cut[3])
+ *  \brief stores the cost of the particles on every Grid */
+static void record_par_cost(DomainS *pD, char *block, int *cut[3]);
+#endif
+
+/* Largest number of slabs of a Grid in each direction over which the
+ * particles are recorded for LoadBalance=2 */
+#define NPROF 8
+
+/* Source of zone_cost(): the "load_weight" expression evaluated on CostGrid,
+ * or the measured cost per zone CostData[] of the Grids of an earlier run,
+ * where CostOwn[dir][i] is the index of the Grid owning cell i and CostCut[]
+ * are the boundaries of those Grids.  ParData[] is the part of the cost per
+ * zone due to particles, and ParProf[(g*3+dir)*NPROF+b] the density of the
+ * particles in slab b of Grid g in dir relative to their mean on the Grid */
+static ConsFun_t CostFun = NULL;
+static GridS CostGrid;
+static int *CostOwn[3], *CostCut[3], CostNG[3];
+static Real *CostData = NULL, *ParData = NULL, *ParProf = NULL;
 #endif
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void init_mesh(MeshS *pM)
- *  \brief General initialization of the nested mesh hierarchy.		      */
+/*! \fn void init_mesh(MeshS *pM, const int ires)
+ *  \brief General initialization of the nested mesh hierarchy.  ires=1 on a
+ *   restart (-r), for which the Grids may not be re-cut by LoadBalance.     */
 
-void init_mesh(MeshS *pM)
+void init_mesh(MeshS *pM, const int ires)
 {
   int nblock,num_domains,nd,nl,level,maxlevel=0,nd_this_level;
   int nDim,nDim_test,dim;
   int *next_domainid;
   char block[80];
   int ncd,ir,irefine,l,m,n,roffset;
-  int i,Nx[3],izones;
+  int i,Nx[3],izones,*cut[3];
   div_t xdiv[3];  /* divisor with quot and rem members */
   Real root_xmin[3], root_xmax[3];  /* min/max of x in each dir on root grid */
   int Nproc_Comm_world=1,nproc=0,next_procID;
@@ -129,6 +235,26 @@ void init_mesh(MeshS *pM)
 
   pM->NLevels = maxlevel + 1;  /* level counting starts at 0 */
 
+/* With <time>/subcycle=1, each level is advanced with its own timestep, half
+ * that of the level above (Berger-Oliger time refinement).  Physics that is
+ * applied once per step of the whole Mesh is not yet subcycled. */
+
+#ifdef STATIC_MESH_REFINEMENT
+  pM->subcycle = par_geti_def("time","subcycle",0);
+  if (pM->subcycle != 0) {
+    pM->subcycle = 1;
+#if defined(SELF_GRAVITY) || defined(PARTICLES)
+    ath_error("[init_mesh]: subcycle=1 not implemented with self-gravity or particles\n");
+#endif
+#if defined(THERMAL_CONDUCTION) || defined(RESISTIVITY) || defined(VISCOSITY)
+    ath_error("[init_mesh]: subcycle=1 not implemented with explicit diffusion\n");
+#endif
+#if defined(OPERATOR_SPLIT_COOLING) || defined(SHEARING_BOX) || defined(FARGO)
+    ath_error("[init_mesh]: subcycle=1 not implemented with operator split cooling, shearing box or FARGO\n");
+#endif
+  }
+#endif /* STATIC_MESH_REFINEMENT */
+
   pM->DomainsPerLevel = (int*)calloc_1d_array(pM->NLevels,sizeof(int));
   if (pM->DomainsPerLevel == NULL)
     ath_error("[init_mesh]: malloc returned a NULL pointer\n");
@@ -544,12 +670,27 @@ void init_mesh(MeshS *pM)
         pD->NGrid[0],sizeof(GridsDataS))) == NULL) ath_error(
         "[init_mesh]: GData calloc returned a NULL pointer\n");
 
-/* Divide the domain into blocks */
+/* Divide the domain into blocks.  The Grids in the l-th column in x1 span
+ * cells cut[0][l] to cut[0][l+1]-1 of the Domain, etc.  If the Domain is not
+ * evenly divisible put the extra cells on the first Grids in each direction,
+ * maintaining the load balance as much as possible */
 
       for (i=0; i<3; i++) {
         xdiv[i] = div(pD->Nx[i], pD->NGrid[i]);
+        cut[i] = (int*)calloc_1d_array(pD->NGrid[i]+1,sizeof(int));
+        if (cut[i] == NULL)
+          ath_error("[init_mesh]: cut calloc returned a NULL pointer\n");
+        for (l=0; l<(pD->NGrid[i]); l++)
+          cut[i][l+1] = cut[i][l] + xdiv[i].quot + (l < xdiv[i].rem ? 1 : 0);
       }
 
+/* With <domain>/LoadBalance, or Grid boundaries given by Cuts_x1,x2,x3,
+ * replace the equal cuts by cuts that balance the cost of the Grids */
+
+#ifdef MPI_PARALLEL
+      dom_balance(pD,block,cut,ires);
+#endif
+
 /* Distribute cells in Domain to Grids.  Assign each Grid to a processor ID in
  * the MPI_COMM_WORLD communicator.  For single-processor jobs, there is only
  * one ID=0, and the GData array will have only one element. */
@@ -557,40 +698,13 @@ void init_mesh(MeshS *pM)
       for(n=0; n<(pD->NGrid[2]); n++){
       for(m=0; m<(pD->NGrid[1]); m++){
       for(l=0; l<(pD->NGrid[0]); l++){
-        for (i=0; i<3; i++) pD->GData[n][m][l].Nx[i] = xdiv[i].quot;
+        pD->GData[n][m][l].Nx[0] = cut[0][l+1] - cut[0][l];
+        pD->GData[n][m][l].Nx[1] = cut[1][m+1] - cut[1][m];
+        pD->GData[n][m][l].Nx[2] = cut[2][n+1] - cut[2][n];
         pD->GData[n][m][l].ID_Comm_world = next_procID++;
         if (next_procID > ((Nproc_Comm_world)-1)) next_procID=0;
       }}}
-
-/* If the Domain is not evenly divisible put the extra cells on the first
- * Grids in each direction, maintaining the load balance as much as possible */
-
-      for(n=0; n<(pD->NGrid[2]); n++){
-        for(m=0; m<(pD->NGrid[1]); m++){
-          for(l=0; l<xdiv[0].rem; l++){
-            pD->GData[n][m][l].Nx[0]++;
-          }
-        }
-      }
-      xdiv[0].rem=0;
-
-      for(n=0; n<(pD->NGrid[2]); n++){
-        for(m=0; m<xdiv[1].rem; m++) {
-          for(l=0; l<(pD->NGrid[0]); l++){
-            pD->GData[n][m][l].Nx[1]++;
-          }
-        }
-      }
-      xdiv[1].rem=0;
-
-      for(n=0; n<xdiv[2].rem; n++){
-        for(m=0; m<(pD->NGrid[1]); m++){
-          for(l=0; l<(pD->NGrid[0]); l++){
-            pD->GData[n][m][l].Nx[2]++;
-          }
-        }
-      }
-      xdiv[2].rem=0;
+      for (i=0; i<3; i++) free_1d_array(cut[i]);
 
 /* Initialize displacements from origin for each Grid */
 
@@ -848,6 +962,86 @@ void get_myGridIndex(DomainS *pD, const int myID,
   ath_error("[get_myGridIndex]: Can't find ID=%i in GData\n", myID);
 }
 
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn void record_grid_cost(MeshS *pM)
+ *  \brief Stores the wall time per zone measured on every Grid of every
+ *   Domain, and the Grid boundaries, in the input parameters (as GridCost_m_n
+ *   and CostCuts_x1,x2,x3 in the <domain> block), so that they are written at
+ *   the start of restart files for <domain>/LoadBalance=2.  With PARTICLES
+ *   the cost of the particles is stored as well, by record_par_cost().
+ *   Nothing is stored before any time has been measured.  Must be called by
+ *   all processes. */
+
+void record_grid_cost(MeshS *pM)
+{
+  DomainS *pD;
+  GridS *pG;
+  char block[80],name[80],val[MAXLEN];
+  double *cost,*sum,smax;
+  int nl,nd,i,l,m,n,ng,len,ierr,*cut[3];
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    pD = (DomainS*)&(pM->Domain[nl][nd]);
+    sprintf(block,"domain%d",pD->InputBlock);
+    ng = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+
+    cost = (double*)calloc_1d_array(ng,sizeof(double));
+    sum = (double*)calloc_1d_array(ng,sizeof(double));
+    if (cost == NULL || sum == NULL)
+      ath_error("[record_grid_cost]: calloc returned a NULL pointer\n");
+    if (pD->Grid != NULL) {
+      pG = pD->Grid;
+      get_myGridIndex(pD, myID_Comm_world, &l, &m, &n);
+      cost[(n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l] =
+        pG->wtime/((Real)(pG->Nx[0])*(Real)(pG->Nx[1])*(Real)(pG->Nx[2]));
+    }
+    ierr = MPI_Allreduce(cost,sum,ng,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+    for (smax=0.0, n=0; n<ng; n++) smax = MAX(smax,sum[n]);
+    free_1d_array(cost);
+    if (smax == 0.0) {
+      free_1d_array(sum);
+      continue;
+    }
+
+/* Grid boundaries, from the sizes of the Grids */
+    for (i=0; i<3; i++)
+      cut[i] = (int*)calloc_1d_array(pD->NGrid[i]+1,sizeof(int));
+    for (l=0; l<(pD->NGrid[0]); l++)
+      cut[0][l+1] = cut[0][l] + pD->GData[0][0][l].Nx[0];
+    for (m=0; m<(pD->NGrid[1]); m++)
+      cut[1][m+1] = cut[1][m] + pD->GData[0][m][0].Nx[1];
+    for (n=0; n<(pD->NGrid[2]); n++)
+      cut[2][n+1] = cut[2][n] + pD->GData[n][0][0].Nx[2];
+
+    if (11*(pD->NGrid[0]) > MAXLEN-100 ||
+        write_cuts(block,"CostCuts",pD,cut) == 0) {
+      ath_perr(-1,"[record_grid_cost]: too many Grids in %s to record\n",
+               block);
+    } else {
+      for (n=0; n<(pD->NGrid[2]); n++){
+      for (m=0; m<(pD->NGrid[1]); m++){
+        len = 0;
+        for (l=0; l<(pD->NGrid[0]); l++)
+          len += sprintf(&val[len],"%s%.3e",(l > 0 ? " " : ""),
+                         sum[(n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l]);
+        sprintf(name,"GridCost_%d_%d",m,n);
+        par_sets(block,name,val,"s/zone");
+      }}
+#ifdef PARTICLES
+      if (nl == 0 && nd == 0) record_par_cost(pD,block,cut);
+#endif
+    }
+
+    for (i=0; i<3; i++) free_1d_array(cut[i]);
+    free_1d_array(sum);
+  }}
+
+  return;
+}
+#endif /* MPI_PARALLEL */
+
 #ifdef MPI_PARALLEL
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /*! \fn static int dom_decomp(const int Nx, const int Ny, const int Nz,
@@ -1015,4 +1209,540 @@ static int dom_decomp_3d(const int Nx, const int Ny, const int Nz,
   return 0;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void dom_balance(DomainS *pD, char *block, int *cut[3],
+ *                                 const int ires)
+ *  \brief Replaces the equal cuts cut[dir][0..NGrid[dir]] of Domain pD by the
+ *   cuts given in <block>/Cuts_x1,x2,x3, or by cuts that balance the cost of
+ *   the Grids if <block>/LoadBalance > 0 (see top of file).  The cuts are
+ *   optimized in turn in each direction, given the cuts in the other two, by
+ *   balance_dir().  On a restart (ires=1) only Cuts_x1,x2,x3 are used, which
+ *   give back the Grids of the run that wrote the restart file; new cuts are
+ *   only found for a run starting from t=0. */
+
+static void dom_balance(DomainS *pD, char *block, int *cut[3],
+                        const int ires)
+{
+  int lb,i,l,m,n,g,b,z,nb,nz,ng,prof,sweep,nchange,gi[3],wb[NPROF],*old[3];
+  char name[80];
+  Real cmax0,cmax,cmean,f[3*NPROF],*pp;
+
+  lb = par_geti_def(block,"LoadBalance",0);
+
+/* Grid boundaries recorded by an earlier run, if they fit the Grids */
+
+  if (lb == 0) {
+    if (par_exist(block,"Cuts_x1") == 0) return;
+    for (i=0, ng=0; i<3; i++)
+      if (read_cuts(block,"Cuts",i,pD->Nx[i],&old[i]) == pD->NGrid[i]) ng++;
+    if (ng == 3) {
+      for (i=0; i<3; i++)
+        for (l=0; l<=(pD->NGrid[i]); l++) cut[i][l] = old[i][l];
+    } else {
+      ath_pout(0,"[init_mesh]: %s/Cuts_x? do not match NGrid, ignored\n",
+               block);
+    }
+    for (i=0; i<3; i++) free_1d_array(old[i]);
+    return;
+  }
+
+/* The data in a restart file is read into the Grids it was written from */
+
+  if (ires)
+    ath_error("[init_mesh]: %s/LoadBalance=%d cannot be used with -r, start a"
+              " new run with -i file.rst instead\n",block,lb);
+
+/* Cost per zone from the problem generator */
+
+  if (lb == 1) {
+    if ((CostFun = get_usr_expr("load_weight")) == NULL)
+      ath_error("[init_mesh]: %s/LoadBalance=1 needs expression load_weight\n",
+                block);
+    memset(&CostGrid,0,sizeof(GridS));
+    for (i=0; i<3; i++) {
+      CostGrid.MinX[i] = pD->MinX[i];
+      CostGrid.MaxX[i] = pD->MaxX[i];
+      CostGrid.Nx[i] = pD->Nx[i];
+      CostGrid.Disp[i] = pD->Disp[i];
+    }
+    CostGrid.dx1 = pD->dx[0];
+    CostGrid.dx2 = pD->dx[1];
+    CostGrid.dx3 = pD->dx[2];
+    CostGrid.ie = pD->Nx[0]-1;
+    CostGrid.je = pD->Nx[1]-1;
+    CostGrid.ke = pD->Nx[2]-1;
+  }
+
+/* Cost per zone measured on the Grids of an earlier run */
+
+  else if (lb == 2) {
+    for (i=0; i<3; i++) {
+      if ((CostNG[i] = read_cuts(block,"CostCuts",i,pD->Nx[i],&CostCut[i]))
+          == 0)
+        ath_error("[init_mesh]: %s/LoadBalance=2 needs CostCuts_x%d\n",
+                  block,i+1);
+      if ((CostOwn[i] = (int*)calloc_1d_array(pD->Nx[i],sizeof(int))) == NULL)
+        ath_error("[init_mesh]: calloc returned a NULL pointer\n");
+      for (l=0; l<CostNG[i]; l++)
+        for (m=CostCut[i][l]; m<CostCut[i][l+1]; m++) CostOwn[i][m] = l;
+    }
+    ng = CostNG[0]*CostNG[1]*CostNG[2];
+    if ((CostData = (Real*)calloc_1d_array(ng,sizeof(Real))) == NULL)
+      ath_error("[init_mesh]: calloc returned a NULL pointer\n");
+    for (n=0; n<CostNG[2]; n++){
+    for (m=0; m<CostNG[1]; m++){
+      sprintf(name,"GridCost_%d_%d",m,n);
+      read_vals(block,name,CostNG[0],&(CostData[(n*CostNG[1] + m)*CostNG[0]]));
+    }}
+
+/* Cost of the particles, taken out of the cost of the Grids, and where on
+ * each Grid they were (uniform if not recorded) */
+
+    if (par_exist(block,"ParCost_0_0")) {
+      ParData = (Real*)calloc_1d_array(ng,sizeof(Real));
+      ParProf = (Real*)calloc_1d_array(ng*3*NPROF,sizeof(Real));
+      if (ParData == NULL || ParProf == NULL)
+        ath_error("[init_mesh]: calloc returned a NULL pointer\n");
+      for (n=0; n<CostNG[2]; n++){
+      for (m=0; m<CostNG[1]; m++){
+        sprintf(name,"ParCost_%d_%d",m,n);
+        read_vals(block,name,CostNG[0],&(ParData[(n*CostNG[1]+m)*CostNG[0]]));
+      }}
+
+      for (n=0; n<CostNG[2]; n++){
+      for (m=0; m<CostNG[1]; m++){
+      for (l=0; l<CostNG[0]; l++){
+        g = (n*CostNG[1] + m)*CostNG[0] + l;
+        gi[0] = l;  gi[1] = m;  gi[2] = n;
+        ParData[g] = MAX(ParData[g],0.0);
+        CostData[g] -= ParData[g];
+
+        sprintf(name,"ParProf_%d_%d_%d",l,m,n);
+        prof = par_exist(block,name);
+        for (i=0, nb=0; i<3; i++)
+          nb += MIN(CostCut[i][gi[i]+1] - CostCut[i][gi[i]], NPROF);
+        if (prof) read_vals(block,name,nb,f);
+
+/* zone z of the nz zones of a Grid in dir i lies in slab z*nb/nz */
+        for (i=0, pp=f; i<3; i++) {
+          nz = CostCut[i][gi[i]+1] - CostCut[i][gi[i]];
+          nb = MIN(nz,NPROF);
+          for (b=0; b<nb; b++) wb[b] = 0;
+          for (z=0; z<nz; z++) wb[z*nb/nz]++;
+          for (b=0; b<nb; b++)
+            ParProf[(g*3 + i)*NPROF + b] =
+              (prof ? MAX(pp[b],0.0)*(Real)nz/(Real)wb[b] : 1.0);
+          pp += nb;
+        }
+      }}}
+    }
+  }
+
+  else {
+    ath_error("[init_mesh]: invalid LoadBalance=%d in %s\n",lb,block);
+  }
+
+/* Optimize the cuts in each direction in turn, until they do not change */
+
+  grid_cost(pD,cut,&cmax0,&cmean);
+  if (cmean <= 0.0)
+    ath_error("[init_mesh]: cost of all zones of %s is zero\n",block);
+  for (sweep=0; sweep<3; sweep++) {
+    nchange = 0;
+    for (i=0; i<3; i++)
+      if (pD->NGrid[i] > 1) nchange += balance_dir(pD,cut,i);
+    if (nchange == 0) break;
+  }
+  grid_cost(pD,cut,&cmax,&cmean);
+  ath_pout(0,"[init_mesh]: %s max/mean Grid cost %5.3f (equal Grids %5.3f)\n",
+           block,cmax/cmean,cmax0/cmean);
+
+/* Keep these Grids for restarts */
+
+  if (write_cuts(block,"Cuts",pD,cut) == 0)
+    ath_error("[init_mesh]: too many Grids in %s to record Cuts_x?\n",block);
+  par_seti(block,"LoadBalance","%d",0,"Grids given by Cuts_x?");
+
+  CostFun = NULL;
+  if (CostData != NULL) {
+    for (i=0; i<3; i++) {
+      free_1d_array(CostOwn[i]);
+      free_1d_array(CostCut[i]);
+    }
+    free_1d_array(CostData);
+    CostData = NULL;
+  }
+  if (ParData != NULL) {
+    free_1d_array(ParData);
+    free_1d_array(ParProf);
+    ParData = ParProf = NULL;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int balance_dir(DomainS *pD, int *cut[3], const int dir)
+ *  \brief Sets the cuts in direction dir that minimize the largest cost of
+ *   any Grid, given the cuts in the other two directions.  The cost of each
+ *   layer of cells in dir is summed over each block of Grids in the other
+ *   directions, and the smallest maximum cost for which slab_cuts() finds
+ *   cuts is found by bisection.  Grids are at least nghost cells wide.
+ *   Returns the number of cuts changed. */
+
+static int balance_dir(DomainS *pD, int *cut[3], const int dir)
+{
+  int d1=(dir+1)%3, d2=(dir+2)%3;
+  int N=pD->Nx[dir], P=pD->NGrid[dir], nb, minw, idx[3], p, b, it, nchange=0;
+  int *own1, *own2, *c;
+  Real **proj, *sum, *rem, lo, hi, w;
+
+  nb = (pD->NGrid[d1])*(pD->NGrid[d2]);
+  minw = MIN(nghost, N/P);
+  if (minw < 1) minw = 1;
+
+  proj = (Real**)calloc_2d_array(N,nb,sizeof(Real));
+  sum = (Real*)calloc_1d_array(nb,sizeof(Real));
+  rem = (Real*)calloc_1d_array(nb,sizeof(Real));
+  c = (int*)calloc_1d_array(P+1,sizeof(int));
+  own1 = (int*)calloc_1d_array(pD->Nx[d1],sizeof(int));
+  own2 = (int*)calloc_1d_array(pD->Nx[d2],sizeof(int));
+  if (proj == NULL || sum == NULL || rem == NULL || c == NULL ||
+      own1 == NULL || own2 == NULL)
+    ath_error("[init_mesh]: calloc returned a NULL pointer\n");
+
+  for (p=0; p<(pD->NGrid[d1]); p++)
+    for (b=cut[d1][p]; b<cut[d1][p+1]; b++) own1[b] = p;
+  for (p=0; p<(pD->NGrid[d2]); p++)
+    for (b=cut[d2][p]; b<cut[d2][p+1]; b++) own2[b] = p;
+
+/* Cost of each layer in dir, for each block of Grids in d1,d2 */
+
+  for (idx[2]=0; idx[2]<(pD->Nx[2]); idx[2]++){
+  for (idx[1]=0; idx[1]<(pD->Nx[1]); idx[1]++){
+  for (idx[0]=0; idx[0]<(pD->Nx[0]); idx[0]++){
+    w = zone_cost(idx[0],idx[1],idx[2]);
+    proj[idx[dir]][own2[idx[d2]]*(pD->NGrid[d1]) + own1[idx[d1]]] += w;
+  }}}
+
+/* Bisect on the largest cost of a Grid, starting from one Grid in dir */
+
+  lo = hi = 0.0;
+  for (b=0; b<nb; b++) {
+    for (w=0.0, p=0; p<N; p++) w += proj[p][b];
+    hi = MAX(hi,w);
+  }
+  for (it=0; it<64 && (hi - lo) > 1.0e-6*hi; it++) {
+    w = 0.5*(lo + hi);
+    if (slab_cuts(proj,N,P,nb,minw,w,0,c,sum,rem)) hi = w;
+    else lo = w;
+  }
+
+/* Spread the cost evenly if possible, rather than filling Grids in order */
+
+  if (slab_cuts(proj,N,P,nb,minw,hi,1,c,sum,rem) == 0)
+    slab_cuts(proj,N,P,nb,minw,hi,0,c,sum,rem);
+
+  for (p=0; p<=P; p++) {
+    if (c[p] != cut[dir][p]) nchange++;
+    cut[dir][p] = c[p];
+  }
+
+  free_2d_array(proj);
+  free_1d_array(sum);
+  free_1d_array(rem);
+  free_1d_array(c);
+  free_1d_array(own1);
+  free_1d_array(own2);
+
+  return nchange;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int slab_cuts(Real **proj, const int N, const int P,
+ *                           const int nb, const int minw, const Real cmax,
+ *                           const int even, int *c, Real *sum, Real *rem)
+ *  \brief Cuts N layers with costs proj[layer][block] into P slabs of at least
+ *   minw layers, c[0..P], filling each slab while the cost of every block
+ *   stays below cmax.  With even=1 a slab is also closed once its cost
+ *   reaches an equal share of the remaining cost.  Returns 1 if no block of
+ *   any slab costs more than cmax, else 0.  sum[] and rem[] are work arrays
+ *   of nb elements. */
+
+static int slab_cuts(Real **proj, const int N, const int P, const int nb,
+  const int minw, const Real cmax, const int even, int *c, Real *sum,
+  Real *rem)
+{
+  int s,b,pos,end,maxend,fits,ok=1;
+  Real share,smax;
+
+  for (b=0; b<nb; b++) rem[b] = 0.0;
+  for (pos=0; pos<N; pos++)
+    for (b=0; b<nb; b++) rem[b] += proj[pos][b];
+
+  pos = 0;
+  c[0] = 0;
+  for (s=0; s<P; s++) {
+    maxend = N - (P-1-s)*minw;
+    share = 0.0;
+    if (even) {
+      for (b=0; b<nb; b++) share = MAX(share,rem[b]);
+      share /= (Real)(P-s);
+    }
+    for (b=0; b<nb; b++) sum[b] = 0.0;
+    smax = 0.0;
+
+    for (end=pos; end<maxend; end++) {
+      if (s < P-1 && end >= pos+minw) {
+        if (even && smax >= share) break;
+        for (fits=1, b=0; b<nb; b++)
+          if (sum[b] + proj[end][b] > cmax) fits = 0;
+        if (!fits) break;
+      }
+      for (b=0; b<nb; b++) {
+        sum[b] += proj[end][b];
+        smax = MAX(smax,sum[b]);
+      }
+    }
+
+    for (b=0; b<nb; b++) {
+      if (sum[b] > cmax) ok = 0;
+      rem[b] -= sum[b];
+    }
+    c[s+1] = end;
+    pos = end;
+  }
+
+  return ok;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void grid_cost(DomainS *pD, int *cut[3], Real *pmax,
+ *                            Real *pmean)
+ *  \brief Returns the largest and the mean cost of the Grids given by cut */
+
+static void grid_cost(DomainS *pD, int *cut[3], Real *pmax, Real *pmean)
+{
+  int i,j,k,l,m,n,ng;
+  Real *cost;
+
+  ng = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  if ((cost = (Real*)calloc_1d_array(ng,sizeof(Real))) == NULL)
+    ath_error("[init_mesh]: calloc returned a NULL pointer\n");
+
+  for (n=0; n<(pD->NGrid[2]); n++){
+  for (m=0; m<(pD->NGrid[1]); m++){
+  for (l=0; l<(pD->NGrid[0]); l++){
+    for (k=cut[2][n]; k<cut[2][n+1]; k++){
+    for (j=cut[1][m]; j<cut[1][m+1]; j++){
+    for (i=cut[0][l]; i<cut[0][l+1]; i++){
+      cost[(n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l] += zone_cost(i,j,k);
+    }}}
+  }}}
+
+  *pmax = *pmean = 0.0;
+  for (n=0; n<ng; n++) {
+    *pmax = MAX(*pmax,cost[n]);
+    *pmean += cost[n]/(Real)ng;
+  }
+  free_1d_array(cost);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real zone_cost(const int i, const int j, const int k)
+ *  \brief Cost of cell i,j,k of the Domain being balanced (never negative) */
+
+static Real zone_cost(const int i, const int j, const int k)
+{
+  int g,d,z,nz,idx[3];
+  Real w,rel;
+
+  if (CostFun != NULL)
+    return MAX((*CostFun)(&CostGrid,i,j,k),0.0);
+
+  g = (CostOwn[2][k]*CostNG[1] + CostOwn[1][j])*CostNG[0] + CostOwn[0][i];
+  w = MAX(CostData[g],0.0);
+
+/* cost of the particles, from their density in the slabs of the Grid */
+  if (ParData != NULL && ParData[g] > 0.0) {
+    idx[0] = i;  idx[1] = j;  idx[2] = k;
+    for (rel=1.0, d=0; d<3; d++) {
+      z = idx[d] - CostCut[d][CostOwn[d][idx[d]]];
+      nz = CostCut[d][CostOwn[d][idx[d]]+1] - CostCut[d][CostOwn[d][idx[d]]];
+      rel *= ParProf[(g*3 + d)*NPROF + z*MIN(nz,NPROF)/nz];
+    }
+    w += ParData[g]*rel;
+  }
+
+  return w;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int read_cuts(char *block, char *name, const int dir,
+ *                           const int nx, int **pcut)
+ *  \brief Reads the Grid boundaries <block>/<name>_x(dir+1), which must run
+ *   from 0 to nx, into a new array *pcut.  Returns the number of Grids, or 0
+ *   (with *pcut NULL) if the parameter does not exist. */
+
+static int read_cuts(char *block, char *name, const int dir, const int nx,
+                     int **pcut)
+{
+  char par[80],*val,*cp,*ep;
+  long c;
+  int n=0;
+
+  *pcut = NULL;
+  sprintf(par,"%s_x%d",name,dir+1);
+  if (par_exist(block,par) == 0) return 0;
+
+  cp = val = par_gets(block,par);
+  if ((*pcut = (int*)calloc_1d_array(strlen(val)/2+2,sizeof(int))) == NULL)
+    ath_error("[init_mesh]: calloc returned a NULL pointer\n");
+  while ((c = strtol(cp,&ep,10)), ep != cp) {
+    if ((n == 0 && c != 0) || (n > 0 && c <= (*pcut)[n-1]))
+      ath_error("[init_mesh]: %s/%s must increase from 0\n",block,par);
+    (*pcut)[n++] = (int)c;
+    cp = ep;
+  }
+  free(val);
+  if (n < 2 || (*pcut)[n-1] != nx)
+    ath_error("[init_mesh]: %s/%s must end at Nx%d=%d\n",block,par,dir+1,nx);
+
+  return n-1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int write_cuts(char *block, char *name, DomainS *pD,
+ *                            int *cut[3])
+ *  \brief Stores cut[dir][0..NGrid[dir]] in <block>/<name>_x1,x2,x3.  Returns
+ *   0 without storing them if they do not fit in an input line. */
+
+static int write_cuts(char *block, char *name, DomainS *pD, int *cut[3])
+{
+  char par[80],val[3][MAXLEN];
+  int i,l,len;
+
+  for (i=0; i<3; i++) {
+    len = 0;
+    for (l=0; l<=(pD->NGrid[i]); l++) {
+      if (len > MAXLEN-100) return 0;
+      len += sprintf(&val[i][len],"%s%d",(l > 0 ? " " : ""),cut[i][l]);
+    }
+  }
+  for (i=0; i<3; i++) {
+    sprintf(par,"%s_x%d",name,i+1);
+    par_sets(block,par,val[i],"Grid boundaries");
+  }
+
+  return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void read_vals(char *block, char *name, const int n, Real *v)
+ *  \brief Reads the first n numbers of <block>/<name> into v[0..n-1] */
+
+static void read_vals(char *block, char *name, const int n, Real *v)
+{
+  char *val,*cp,*ep;
+  int l;
+
+  cp = val = par_gets(block,name);
+  for (l=0; l<n; l++){
+    v[l] = strtod(cp,&ep);
+    if (ep == cp)
+      ath_error("[init_mesh]: %s/%s has fewer than %d values\n",block,name,n);
+    cp = ep;
+  }
+  free(val);
+
+  return;
+}
+
+#ifdef PARTICLES
+/*----------------------------------------------------------------------------*/
+/*! \fn static void record_par_cost(DomainS *pD, char *block, int *cut[3])
+ *  \brief Stores the wall time per zone spent on the particles of every Grid
+ *   of Domain pD (as ParCost_m_n, like GridCost_m_n), and for each Grid with
+ *   particles the fraction of them in each of nb=MIN(Nx,NPROF) slabs of the
+ *   Grid in x1, then x2, then x3 (as ParProf_l_m_n), where zone z of a Grid
+ *   is in slab z*nb/Nx.  The particles are counted every step by
+ *   count_particles().  cut[] are the Grid boundaries.  These are only read
+ *   back by a new run with LoadBalance=2 (see top of file).  Must be called
+ *   by all processes. */
+
+static void record_par_cost(DomainS *pD, char *block, int *cut[3])
+{
+  GridS *pG;
+  char name[80],val[MAXLEN];
+  double *cost,*sum,smax,tot;
+  int d,b,l,m,n,g,z,nz,nb,nw,ng,len,ierr,gi[3];
+
+  ng = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  nw = 1 + 3*NPROF;  /* cost, then profiles in x1,x2,x3, of each Grid */
+
+  cost = (double*)calloc_1d_array(ng*nw,sizeof(double));
+  sum = (double*)calloc_1d_array(ng*nw,sizeof(double));
+  if (cost == NULL || sum == NULL)
+    ath_error("[record_grid_cost]: calloc returned a NULL pointer\n");
+  if (pD->Grid != NULL) {
+    pG = pD->Grid;
+    get_myGridIndex(pD, myID_Comm_world, &l, &m, &n);
+    g = ((n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l)*nw;
+    cost[g] =
+      pG->ptime/((Real)(pG->Nx[0])*(Real)(pG->Nx[1])*(Real)(pG->Nx[2]));
+    for (d=0; d<3; d++) {
+      nb = MIN(pG->Nx[d],NPROF);
+      for (tot=0.0, z=0; z<(pG->Nx[d]); z++) tot += pG->parprof[d][z];
+      if (tot > 0.0)
+        for (z=0; z<(pG->Nx[d]); z++)
+          cost[g + 1 + d*NPROF + z*nb/(pG->Nx[d])] += pG->parprof[d][z]/tot;
+    }
+  }
+  ierr = MPI_Allreduce(cost,sum,ng*nw,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  free_1d_array(cost);
+
+  for (smax=0.0, g=0; g<ng; g++) smax = MAX(smax,sum[g*nw]);
+  if (smax == 0.0) {
+    free_1d_array(sum);
+    return;
+  }
+
+  for (n=0; n<(pD->NGrid[2]); n++){
+  for (m=0; m<(pD->NGrid[1]); m++){
+    len = 0;
+    for (l=0; l<(pD->NGrid[0]); l++)
+      len += sprintf(&val[len],"%s%.3e",(l > 0 ? " " : ""),
+                     sum[((n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l)*nw]);
+    sprintf(name,"ParCost_%d_%d",m,n);
+    par_sets(block,name,val,"s/zone on particles");
+  }}
+
+/* At most 3*NPROF fractions of 6 characters in each line */
+
+  for (n=0; n<(pD->NGrid[2]); n++){
+  for (m=0; m<(pD->NGrid[1]); m++){
+  for (l=0; l<(pD->NGrid[0]); l++){
+    g = ((n*(pD->NGrid[1]) + m)*(pD->NGrid[0]) + l)*nw;
+    for (tot=0.0, b=0; b<NPROF; b++) tot += sum[g + 1 + b];
+    if (sum[g] == 0.0 || tot == 0.0) continue;  /* read as uniform */
+    gi[0] = l;  gi[1] = m;  gi[2] = n;
+    len = 0;
+    for (d=0; d<3; d++) {
+      nz = cut[d][gi[d]+1] - cut[d][gi[d]];
+      for (b=0; b<MIN(nz,NPROF); b++)
+        len += sprintf(&val[len],"%s%.3f",(len > 0 ? " " : ""),
+                       sum[g + 1 + d*NPROF + b]);
+    }
+    sprintf(name,"ParProf_%d_%d_%d",l,m,n);
+    par_sets(block,name,val,"fraction of particles in slabs");
+  }}}
+
+  free_1d_array(sum);
+
+  return;
+}
+#endif /* PARTICLES */
+
 #endif /* MPI_PARALLEL */
@@ -29,6 +29,15 @@ VDFun_t integrate_init(MeshS *pM)
   dim = 0;
   for (i=0; i<3; i++) if(pM->Nx[i] > 1) dim++;
 
+/* Only the 3D CTU integrator can overlap the halo exchange with computation */
+  if (par_geti_def("job","overlap_halo",0) != 0) {
+#ifndef CTU_INTEGRATOR
+    ath_error("[integrate_init]: overlap_halo requires the CTU integrator\n");
+#endif
+    if (dim != 3)
+      ath_error("[integrate_init]: overlap_halo requires a 3D problem\n");
+  }
+
 /* set function pointer to appropriate integrator based on dimensions */
   switch(dim){
 
@@ -119,21 +119,21 @@ void integrate_1d_ctu(DomainS *pD)
  */
 
   for (i=is-nghost; i<=ie+nghost; i++) {
-    U1d[i].d  = pG->U[ks][js][i].d;
-    U1d[i].Mx = pG->U[ks][js][i].M1;
-    U1d[i].My = pG->U[ks][js][i].M2;
-    U1d[i].Mz = pG->U[ks][js][i].M3;
+    U1d[i].d  = UVAR(pG,ks,js,i,d);
+    U1d[i].Mx = UVAR(pG,ks,js,i,M1);
+    U1d[i].My = UVAR(pG,ks,js,i,M2);
+    U1d[i].Mz = UVAR(pG,ks,js,i,M3);
 #ifndef BAROTROPIC
-    U1d[i].E  = pG->U[ks][js][i].E;
+    U1d[i].E  = UVAR(pG,ks,js,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-    U1d[i].By = pG->U[ks][js][i].B2c;
-    U1d[i].Bz = pG->U[ks][js][i].B3c;
-    Bxc[i] = pG->U[ks][js][i].B1c;
+    U1d[i].By = UVAR(pG,ks,js,i,B2c);
+    U1d[i].Bz = UVAR(pG,ks,js,i,B3c);
+    Bxc[i] = UVAR(pG,ks,js,i,B1c);
     Bxi[i] = pG->B1i[ks][js][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-    for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[ks][js][i].s[n];
+    for (n=0; n<NSCALARS; n++) U1d[i].s[n] = UVAR(pG,ks,js,i,s[n]);
 #endif
   }
 
@@ -326,7 +326,7 @@ void integrate_1d_ctu(DomainS *pD)
 #endif
   {
     for (i=il+1; i<=iu-1; i++) {
-      dhalf[i] = pG->U[ks][js][i].d - hdtodx1*(x1Flux[i+1].d - x1Flux[i].d );
+      dhalf[i] = UVAR(pG,ks,js,i,d) - hdtodx1*(x1Flux[i+1].d - x1Flux[i].d );
       if ((dhalf[i] < d_MIN) || (dhalf[i] != dhalf[i])) {
         dhalf[i] = d_MIN;
       }
@@ -345,11 +345,11 @@ void integrate_1d_ctu(DomainS *pD)
 #endif /* PARTICLES */
   {
     for (i=il+1; i<=iu-1; i++) {
-      M1h = pG->U[ks][js][i].M1 - hdtodx1*(x1Flux[i+1].Mx - x1Flux[i].Mx);
-      M2h = pG->U[ks][js][i].M2 - hdtodx1*(x1Flux[i+1].My - x1Flux[i].My);
-      M3h = pG->U[ks][js][i].M3 - hdtodx1*(x1Flux[i+1].Mz - x1Flux[i].Mz);
+      M1h = UVAR(pG,ks,js,i,M1) - hdtodx1*(x1Flux[i+1].Mx - x1Flux[i].Mx);
+      M2h = UVAR(pG,ks,js,i,M2) - hdtodx1*(x1Flux[i+1].My - x1Flux[i].My);
+      M3h = UVAR(pG,ks,js,i,M3) - hdtodx1*(x1Flux[i+1].Mz - x1Flux[i].Mz);
 #ifndef BAROTROPIC
-      Eh  = pG->U[ks][js][i].E  - hdtodx1*(x1Flux[i+1].E  - x1Flux[i].E );
+      Eh  = UVAR(pG,ks,js,i,E)  - hdtodx1*(x1Flux[i+1].E  - x1Flux[i].E );
 #endif
 
 /* Add source terms for fixed gravitational potential */
@@ -357,14 +357,14 @@ void integrate_1d_ctu(DomainS *pD)
         cc_pos(pG,i,js,ks,&x1,&x2,&x3);
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
-        M1h -= hdtodx1*(phir-phil)*pG->U[ks][js][i].d;
+        M1h -= hdtodx1*(phir-phil)*UVAR(pG,ks,js,i,d);
       }
 
 /* Add source terms due to self-gravity  */
 #ifdef SELF_GRAVITY
       phir = 0.5*(pG->Phi[ks][js][i] + pG->Phi[ks][js][i+1]);
       phil = 0.5*(pG->Phi[ks][js][i] + pG->Phi[ks][js][i-1]);
-      M1h -= hdtodx1*(phir-phil)*pG->U[ks][js][i].d;
+      M1h -= hdtodx1*(phir-phil)*UVAR(pG,ks,js,i,d);
 #endif /* SELF_GRAVITY */
 
 /* Add the particle feedback terms */
@@ -378,9 +378,9 @@ void integrate_1d_ctu(DomainS *pD)
       phalf[i] = Eh - 0.5*(M1h*M1h + M2h*M2h + M3h*M3h)/dhalf[i];
 
 #ifdef MHD
-      B1ch = pG->U[ks][js][i].B1c;
-      B2ch = pG->U[ks][js][i].B2c - hdtodx1*(x1Flux[i+1].By - x1Flux[i].By);
-      B3ch = pG->U[ks][js][i].B3c - hdtodx1*(x1Flux[i+1].Bz - x1Flux[i].Bz);
+      B1ch = UVAR(pG,ks,js,i,B1c);
+      B2ch = UVAR(pG,ks,js,i,B2c) - hdtodx1*(x1Flux[i+1].By - x1Flux[i].By);
+      B3ch = UVAR(pG,ks,js,i,B3c) - hdtodx1*(x1Flux[i+1].Bz - x1Flux[i].Bz);
       phalf[i] -= 0.5*(B1ch*B1ch + B2ch*B2ch + B3ch*B3ch);
 #endif /* MHD */
 
@@ -422,24 +422,24 @@ void integrate_1d_ctu(DomainS *pD)
     rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 
     /* calculate density at time n+1/2 */
-    dhalf[i] = pG->U[ks][js][i].d
+    dhalf[i] = UVAR(pG,ks,js,i,d)
              - hdtodx1*(rsf*x1Flux[i+1].d - lsf*x1Flux[i].d);
 
     /* calculate x2-momentum at time n+1/2 */
-    M2h = pG->U[ks][js][i].M2
+    M2h = UVAR(pG,ks,js,i,M2)
         - hdtodx1*(SQR(rsf)*x1Flux[i+1].My - SQR(lsf)*x1Flux[i].My);
 
     /* compute geometric source term at time n+1/2 */
     geom_src[i] = SQR(M2h)/dhalf[i];
 #ifdef MHD
-    B2ch = pG->U[ks][js][i].B2c - hdtodx1*(x1Flux[i+1].By - x1Flux[i].By);
+    B2ch = UVAR(pG,ks,js,i,B2c) - hdtodx1*(x1Flux[i+1].By - x1Flux[i].By);
     geom_src[i] -= SQR(B2ch);
 #endif
 #ifdef ISOTHERMAL
     geom_src[i] += Iso_csound2*dhalf[i];
 #ifdef MHD
-    B1ch = pG->U[ks][js][i].B1c;
-    B3ch = pG->U[ks][js][i].B3c - hdtodx1*(rsf*x1Flux[i+1].Bz - lsf*x1Flux[i].Bz);
+    B1ch = UVAR(pG,ks,js,i,B1c);
+    B3ch = UVAR(pG,ks,js,i,B3c) - hdtodx1*(rsf*x1Flux[i+1].Bz - lsf*x1Flux[i].Bz);
     geom_src[i] += 0.5*(SQR(B1ch)+SQR(B2ch)+SQR(B3ch));
 #endif
 #else /* ISOTHERMAL */
@@ -450,7 +450,7 @@ void integrate_1d_ctu(DomainS *pD)
     geom_src[i] /= r[i];
 
     /* add time-centered geometric source term for full dt */
-    pG->U[ks][js][i].M1 += pG->dt*geom_src[i];
+    UVAR(pG,ks,js,i,M1) += pG->dt*geom_src[i];
   }
 #endif /* CYLINDRICAL */
 
@@ -471,14 +471,14 @@ void integrate_1d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
 //       g = (*x1GravAcc)(x1vc(pG,i),x2,x3);
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
-//       pG->U[ks][js][i].M1 -= pG->dt*dhalf[i]*g;
-      pG->U[ks][js][i].M1 -= dtodx1*dhalf[i]*(phir-phil);
+//       UVAR(pG,ks,js,i,M1) -= pG->dt*dhalf[i]*g;
+      UVAR(pG,ks,js,i,M1) -= dtodx1*dhalf[i]*(phir-phil);
 #else
-      pG->U[ks][js][i].M1 -= dtodx1*dhalf[i]*(phir-phil);
+      UVAR(pG,ks,js,i,M1) -= dtodx1*dhalf[i]*(phir-phil);
 #endif
 
 #ifndef BAROTROPIC
-      pG->U[ks][js][i].E -= dtodx1*(lsf*x1Flux[i  ].d*(phic - phil) +
+      UVAR(pG,ks,js,i,E) -= dtodx1*(lsf*x1Flux[i  ].d*(phic - phil) +
                                     rsf*x1Flux[i+1].d*(phir - phic));
 #endif
     }
@@ -503,9 +503,9 @@ void integrate_1d_ctu(DomainS *pD)
       flux_m1l = 0.5*(gxl*gxl)/four_pi_G + grav_mean_rho*phil;
       flux_m1r = 0.5*(gxr*gxr)/four_pi_G + grav_mean_rho*phir;
 
-      pG->U[ks][js][i].M1 -= dtodx1*(flux_m1r - flux_m1l);
+      UVAR(pG,ks,js,i,M1) -= dtodx1*(flux_m1r - flux_m1l);
 #ifndef BAROTROPIC
-      pG->U[ks][js][i].E -= dtodx1*(x1Flux[i  ].d*(phic - phil) +
+      UVAR(pG,ks,js,i,E) -= dtodx1*(x1Flux[i  ].d*(phic - phil) +
                                     x1Flux[i+1].d*(phir - phic));
 #endif
   }
@@ -524,7 +524,7 @@ void integrate_1d_ctu(DomainS *pD)
   if (CoolingFunc != NULL){
     for (i=is; i<=ie; i++) {
       coolf = (*CoolingFunc)(dhalf[i],phalf[i],pG->dt);
-      pG->U[ks][js][i].E -= pG->dt*coolf;
+      UVAR(pG,ks,js,i,E) -= pG->dt*coolf;
     }
   }
 #endif /* BAROTROPIC */
@@ -535,11 +535,11 @@ void integrate_1d_ctu(DomainS *pD)
 
 #ifdef FEEDBACK
   for (i=is; i<=ie; i++) {
-    pG->U[ks][js][i].M1 -= pG->Coup[ks][js][i].fb1;
-    pG->U[ks][js][i].M2 -= pG->Coup[ks][js][i].fb2;
-    pG->U[ks][js][i].M3 -= pG->Coup[ks][js][i].fb3;
+    UVAR(pG,ks,js,i,M1) -= pG->Coup[ks][js][i].fb1;
+    UVAR(pG,ks,js,i,M2) -= pG->Coup[ks][js][i].fb2;
+    UVAR(pG,ks,js,i,M3) -= pG->Coup[ks][js][i].fb3;
 #ifndef BAROTROPIC
-    pG->U[ks][js][i].E += pG->Coup[ks][js][i].Eloss;
+    UVAR(pG,ks,js,i,E) += pG->Coup[ks][js][i].Eloss;
     pG->Coup[ks][js][i].Eloss *= dt1;
 #endif
   }
@@ -555,23 +555,23 @@ void integrate_1d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
     rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-    pG->U[ks][js][i].d  -= dtodx1*(rsf*x1Flux[i+1].d  - lsf*x1Flux[i].d );
-    pG->U[ks][js][i].M1 -= dtodx1*(rsf*x1Flux[i+1].Mx - lsf*x1Flux[i].Mx);
-    pG->U[ks][js][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[i+1].My - SQR(lsf)*x1Flux[i].My);
-    pG->U[ks][js][i].M3 -= dtodx1*(rsf*x1Flux[i+1].Mz - lsf*x1Flux[i].Mz);
+    UVAR(pG,ks,js,i,d)  -= dtodx1*(rsf*x1Flux[i+1].d  - lsf*x1Flux[i].d );
+    UVAR(pG,ks,js,i,M1) -= dtodx1*(rsf*x1Flux[i+1].Mx - lsf*x1Flux[i].Mx);
+    UVAR(pG,ks,js,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[i+1].My - SQR(lsf)*x1Flux[i].My);
+    UVAR(pG,ks,js,i,M3) -= dtodx1*(rsf*x1Flux[i+1].Mz - lsf*x1Flux[i].Mz);
 #ifndef BAROTROPIC
-    pG->U[ks][js][i].E  -= dtodx1*(rsf*x1Flux[i+1].E  - lsf*x1Flux[i].E );
+    UVAR(pG,ks,js,i,E)  -= dtodx1*(rsf*x1Flux[i+1].E  - lsf*x1Flux[i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-    pG->U[ks][js][i].B2c -= dtodx1*(x1Flux[i+1].By - x1Flux[i].By);
-    pG->U[ks][js][i].B3c -= dtodx1*(rsf*x1Flux[i+1].Bz - lsf*x1Flux[i].Bz);
+    UVAR(pG,ks,js,i,B2c) -= dtodx1*(x1Flux[i+1].By - x1Flux[i].By);
+    UVAR(pG,ks,js,i,B3c) -= dtodx1*(rsf*x1Flux[i+1].Bz - lsf*x1Flux[i].Bz);
 /* For consistency, set B2i and B3i to cell-centered values.  */
-    pG->B2i[ks][js][i] = pG->U[ks][js][i].B2c;
-    pG->B3i[ks][js][i] = pG->U[ks][js][i].B3c;
+    pG->B2i[ks][js][i] = UVAR(pG,ks,js,i,B2c);
+    pG->B3i[ks][js][i] = UVAR(pG,ks,js,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
     for (n=0; n<NSCALARS; n++)
-      pG->U[ks][js][i].s[n] -= dtodx1*(rsf*x1Flux[i+1].s[n] - lsf*x1Flux[i].s[n]);
+      UVAR(pG,ks,js,i,s[n]) -= dtodx1*(rsf*x1Flux[i+1].s[n] - lsf*x1Flux[i].s[n]);
 #endif
   }
 
@@ -91,8 +91,8 @@ void integrate_1d_vl(DomainS *pD)
   int il=is-(nghost-1), iu=ie+(nghost-1);
 
   for (i=is-nghost; i<=ie+nghost; i++) {
-    Uhalf[i] = pG->U[ks][js][i];
-    W[i] = Cons_to_Prim(&(pG->U[ks][js][i]));
+    Uhalf[i] = UGET(pG,ks,js,i);
+    W[i] = Cons_to_Prim(UPTR(pG,ks,js,i));
   }
 
 /*=== STEP 1: Compute first-order fluxes at t^{n} in x1-direction ============*/
@@ -189,7 +189,7 @@ void integrate_1d_vl(DomainS *pD)
       phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
       phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-      Uhalf[i].M1 -= hdtodx1*pG->U[ks][js][i].d*(phir-phil);
+      Uhalf[i].M1 -= hdtodx1*UVAR(pG,ks,js,i,d)*(phir-phil);
       Uhalf[i].E -= hdtodx1*(x1Flux[i  ].d*(phic - phil) +
                              x1Flux[i+1].d*(phir - phic));
     }
@@ -325,9 +325,9 @@ void integrate_1d_vl(DomainS *pD)
       phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
       phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-      pG->U[ks][js][i].M1 -= dtodx1*Uhalf[i].d*(phir-phil);
+      UVAR(pG,ks,js,i,M1) -= dtodx1*Uhalf[i].d*(phir-phil);
 #ifndef BAROTROPIC
-      pG->U[ks][js][i].E -= dtodx1*(x1Flux[i  ].d*(phic - phil) +
+      UVAR(pG,ks,js,i,E) -= dtodx1*(x1Flux[i  ].d*(phic - phil) +
                                     x1Flux[i+1].d*(phir - phic));
 #endif
     }
@@ -340,23 +340,23 @@ void integrate_1d_vl(DomainS *pD)
  */
 
   for (i=is; i<=ie; i++) {
-    pG->U[ks][js][i].d  -= dtodx1*(x1Flux[i+1].d  - x1Flux[i].d );
-    pG->U[ks][js][i].M1 -= dtodx1*(x1Flux[i+1].Mx - x1Flux[i].Mx);
-    pG->U[ks][js][i].M2 -= dtodx1*(x1Flux[i+1].My - x1Flux[i].My);
-    pG->U[ks][js][i].M3 -= dtodx1*(x1Flux[i+1].Mz - x1Flux[i].Mz);
+    UVAR(pG,ks,js,i,d)  -= dtodx1*(x1Flux[i+1].d  - x1Flux[i].d );
+    UVAR(pG,ks,js,i,M1) -= dtodx1*(x1Flux[i+1].Mx - x1Flux[i].Mx);
+    UVAR(pG,ks,js,i,M2) -= dtodx1*(x1Flux[i+1].My - x1Flux[i].My);
+    UVAR(pG,ks,js,i,M3) -= dtodx1*(x1Flux[i+1].Mz - x1Flux[i].Mz);
 #ifndef BAROTROPIC
-    pG->U[ks][js][i].E  -= dtodx1*(x1Flux[i+1].E  - x1Flux[i].E );
+    UVAR(pG,ks,js,i,E)  -= dtodx1*(x1Flux[i+1].E  - x1Flux[i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-    pG->U[ks][js][i].B2c -= dtodx1*(x1Flux[i+1].By - x1Flux[i].By);
-    pG->U[ks][js][i].B3c -= dtodx1*(x1Flux[i+1].Bz - x1Flux[i].Bz);
+    UVAR(pG,ks,js,i,B2c) -= dtodx1*(x1Flux[i+1].By - x1Flux[i].By);
+    UVAR(pG,ks,js,i,B3c) -= dtodx1*(x1Flux[i+1].Bz - x1Flux[i].Bz);
 /* For consistency, set B2i and B3i to cell-centered values.  */
-    pG->B2i[ks][js][i] = pG->U[ks][js][i].B2c;
-    pG->B3i[ks][js][i] = pG->U[ks][js][i].B3c;
+    pG->B2i[ks][js][i] = UVAR(pG,ks,js,i,B2c);
+    pG->B3i[ks][js][i] = UVAR(pG,ks,js,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
     for (n=0; n<NSCALARS; n++)
-      pG->U[ks][js][i].s[n] -= dtodx1*(x1Flux[i+1].s[n] - x1Flux[i].s[n]);
+      UVAR(pG,ks,js,i,s[n]) -= dtodx1*(x1Flux[i+1].s[n] - x1Flux[i].s[n]);
 #endif
   }
 
@@ -368,7 +368,7 @@ void integrate_1d_vl(DomainS *pD)
  * by using 1st order predictor fluxes */
         
   for (i=is; i<=ie; i++) {
-      Wcheck = check_Prim(&(pG->U[ks][js][i]));
+      Wcheck = check_Prim(UPTR(pG,ks,js,i));
       if (Wcheck.d < 0.0) {
         flag_cell = 1;
         BadCell.i = i;
@@ -422,7 +422,7 @@ void integrate_1d_vl(DomainS *pD)
   superl = 0;
   for (i=is; i<=ie; i++) {
     flag_cell=0;
-    Wcheck = check_Prim(&(pG->U[ks][js][i]));
+    Wcheck = check_Prim(UPTR(pG,ks,js,i));
     if (Wcheck.d < 0.0) {
       flag_cell = 1;
       negd++;
@@ -438,14 +438,14 @@ void integrate_1d_vl(DomainS *pD)
     }
     if (flag_cell != 0) {
       final++;
-      Wcheck = fix_vsq (&(pG->U[ks][js][i]));
+      Wcheck = fix_vsq (UPTR(pG,ks,js,i));
       U = Prim_to_Cons(&Wcheck);
-      pG->U[ks][js][i].d = U.d;
-      pG->U[ks][js][i].M1 = U.M1;
-      pG->U[ks][js][i].M2 = U.M2;
-      pG->U[ks][js][i].M3 = U.M3;
-      pG->U[ks][js][i].E = U.E;
-      Wcheck = check_Prim(&(pG->U[ks][js][i]));
+      UVAR(pG,ks,js,i,d) = U.d;
+      UVAR(pG,ks,js,i,M1) = U.M1;
+      UVAR(pG,ks,js,i,M2) = U.M2;
+      UVAR(pG,ks,js,i,M3) = U.M3;
+      UVAR(pG,ks,js,i,E) = U.E;
+      Wcheck = check_Prim(UPTR(pG,ks,js,i));
       Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
       if (Wcheck.d < 0.0 || Wcheck.P < 0.0 || Vsq > 1.0){
 	fail++;
@@ -647,54 +647,54 @@ static void FixCell(GridS *pG, Int3Vect indx)
 #endif /* BAROTROPIC */
         
   /* Use flux differences to correct bad cell */
-  pG->U[ks][js][indx.i].d  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
-  pG->U[ks][js][indx.i].M1 += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
-  pG->U[ks][js][indx.i].M2 += dtodx1*(x1FD_ip1.My - x1FD_i.My);
-  pG->U[ks][js][indx.i].M3 += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
+  UVAR(pG,ks,js,indx.i,d)  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
+  UVAR(pG,ks,js,indx.i,M1) += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
+  UVAR(pG,ks,js,indx.i,M2) += dtodx1*(x1FD_ip1.My - x1FD_i.My);
+  UVAR(pG,ks,js,indx.i,M3) += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
 #ifdef MHD
-  pG->U[ks][js][indx.i].B2c += dtodx1*(x1FD_ip1.By - x1FD_i.By);
-  pG->U[ks][js][indx.i].B3c += dtodx1*(x1FD_ip1.Bz - x1FD_i.Bz);
+  UVAR(pG,ks,js,indx.i,B2c) += dtodx1*(x1FD_ip1.By - x1FD_i.By);
+  UVAR(pG,ks,js,indx.i,B3c) += dtodx1*(x1FD_ip1.Bz - x1FD_i.Bz);
   /* For consistency, set B2i and B3i to cell-centered values.  */
-  pG->B2i[ks][js][indx.i] = pG->U[ks][js][indx.i].B2c;
-  pG->B3i[ks][js][indx.i] = pG->U[ks][js][indx.i].B3c;
+  pG->B2i[ks][js][indx.i] = UVAR(pG,ks,js,indx.i,B2c);
+  pG->B3i[ks][js][indx.i] = UVAR(pG,ks,js,indx.i,B3c);
 #endif
 #ifndef BAROTROPIC
-  pG->U[ks][js][indx.i].E  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
+  UVAR(pG,ks,js,indx.i,E)  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
 #endif /* BAROTROPIC */
         
         
   /* Use flux differences to correct bad cell neighbors at i-1 and i+1 */      
   if (indx.i > pG->is) {
-    pG->U[ks][js][indx.i-1].d  += dtodx1*(x1FD_i.d );
-    pG->U[ks][js][indx.i-1].M1 += dtodx1*(x1FD_i.Mx);
-    pG->U[ks][js][indx.i-1].M2 += dtodx1*(x1FD_i.My);
-    pG->U[ks][js][indx.i-1].M3 += dtodx1*(x1FD_i.Mz);
+    UVAR(pG,ks,js,indx.i-1,d)  += dtodx1*(x1FD_i.d );
+    UVAR(pG,ks,js,indx.i-1,M1) += dtodx1*(x1FD_i.Mx);
+    UVAR(pG,ks,js,indx.i-1,M2) += dtodx1*(x1FD_i.My);
+    UVAR(pG,ks,js,indx.i-1,M3) += dtodx1*(x1FD_i.Mz);
 #ifdef MHD
-    pG->U[ks][js][indx.i-1].B2c += dtodx1*(x1FD_i.By);
-    pG->U[ks][js][indx.i-1].B3c += dtodx1*(x1FD_i.Bz);
+    UVAR(pG,ks,js,indx.i-1,B2c) += dtodx1*(x1FD_i.By);
+    UVAR(pG,ks,js,indx.i-1,B3c) += dtodx1*(x1FD_i.Bz);
     /* For consistency, set B2i and B3i to cell-centered values.  */
-    pG->B2i[ks][js][indx.i-1] = pG->U[ks][js][indx.i-1].B2c;
-    pG->B3i[ks][js][indx.i-1] = pG->U[ks][js][indx.i-1].B3c;
+    pG->B2i[ks][js][indx.i-1] = UVAR(pG,ks,js,indx.i-1,B2c);
+    pG->B3i[ks][js][indx.i-1] = UVAR(pG,ks,js,indx.i-1,B3c);
 #endif
 #ifndef BAROTROPIC
-    pG->U[ks][js][indx.i-1].E  += dtodx1*(x1FD_i.E );
+    UVAR(pG,ks,js,indx.i-1,E)  += dtodx1*(x1FD_i.E );
 #endif /* BAROTROPIC */
   }
         
   if (indx.i < pG->ie) {
-    pG->U[ks][js][indx.i+1].d  -= dtodx1*(x1FD_ip1.d );
-    pG->U[ks][js][indx.i+1].M1 -= dtodx1*(x1FD_ip1.Mx);
-    pG->U[ks][js][indx.i+1].M2 -= dtodx1*(x1FD_ip1.My);
-    pG->U[ks][js][indx.i+1].M3 -= dtodx1*(x1FD_ip1.Mz);
+    UVAR(pG,ks,js,indx.i+1,d)  -= dtodx1*(x1FD_ip1.d );
+    UVAR(pG,ks,js,indx.i+1,M1) -= dtodx1*(x1FD_ip1.Mx);
+    UVAR(pG,ks,js,indx.i+1,M2) -= dtodx1*(x1FD_ip1.My);
+    UVAR(pG,ks,js,indx.i+1,M3) -= dtodx1*(x1FD_ip1.Mz);
 #ifdef MHD
-    pG->U[ks][js][indx.i+1].B2c -= dtodx1*(x1FD_ip1.By);
-    pG->U[ks][js][indx.i+1].B3c -= dtodx1*(x1FD_ip1.Bz);
+    UVAR(pG,ks,js,indx.i+1,B2c) -= dtodx1*(x1FD_ip1.By);
+    UVAR(pG,ks,js,indx.i+1,B3c) -= dtodx1*(x1FD_ip1.Bz);
     /* For consistency, set B2i and B3i to cell-centered values.  */
-    pG->B2i[ks][js][indx.i+1] = pG->U[ks][js][indx.i+1].B2c;
-    pG->B3i[ks][js][indx.i+1] = pG->U[ks][js][indx.i+1].B3c;
+    pG->B2i[ks][js][indx.i+1] = UVAR(pG,ks,js,indx.i+1,B2c);
+    pG->B3i[ks][js][indx.i+1] = UVAR(pG,ks,js,indx.i+1,B3c);
 #endif /* MHD */
 #ifndef BAROTROPIC
-    pG->U[ks][js][indx.i+1].E  -= dtodx1*(x1FD_ip1.E );
+    UVAR(pG,ks,js,indx.i+1,E)  -= dtodx1*(x1FD_ip1.E );
 #endif /* BAROTROPIC */
   }
         
@@ -193,22 +193,22 @@ void integrate_2d_ctu(DomainS *pD)
 
   for (j=jl; j<=ju; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
-      U1d[i].d  = pG->U[ks][j][i].d;
-      U1d[i].Mx = pG->U[ks][j][i].M1;
-      U1d[i].My = pG->U[ks][j][i].M2;
-      U1d[i].Mz = pG->U[ks][j][i].M3;
+      U1d[i].d  = UVAR(pG,ks,j,i,d);
+      U1d[i].Mx = UVAR(pG,ks,j,i,M1);
+      U1d[i].My = UVAR(pG,ks,j,i,M2);
+      U1d[i].Mz = UVAR(pG,ks,j,i,M3);
 #ifndef BAROTROPIC
-      U1d[i].E  = pG->U[ks][j][i].E;
+      U1d[i].E  = UVAR(pG,ks,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-      U1d[i].By = pG->U[ks][j][i].B2c;
-      U1d[i].Bz = pG->U[ks][j][i].B3c;
-      Bxc[i] = pG->U[ks][j][i].B1c;
+      U1d[i].By = UVAR(pG,ks,j,i,B2c);
+      U1d[i].Bz = UVAR(pG,ks,j,i,B3c);
+      Bxc[i] = UVAR(pG,ks,j,i,B1c);
       Bxi[i] = pG->B1i[ks][j][i];
       B1_x1Face[j][i] = pG->B1i[ks][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-      for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[ks][j][i].s[n];
+      for (n=0; n<NSCALARS; n++) U1d[i].s[n] = UVAR(pG,ks,j,i,s[n]);
 #endif
     }
 
@@ -253,14 +253,14 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i]/r[i-1];  lsf = ri[i-1]/r[i-1];
 #endif
-      MHD_src = (pG->U[ks][j][i-1].M2/pG->U[ks][j][i-1].d)*
+      MHD_src = (UVAR(pG,ks,j,i-1,M2)/UVAR(pG,ks,j,i-1,d))*
                 (rsf*pG->B1i[ks][j][i] - lsf*pG->B1i[ks][j][i-1])*dx1i;
       Wl[i].By += hdt*MHD_src;
 
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      MHD_src = (pG->U[ks][j][i].M2/pG->U[ks][j][i].d)*
+      MHD_src = (UVAR(pG,ks,j,i,M2)/UVAR(pG,ks,j,i,d))*
                (rsf*pG->B1i[ks][j][i+1] - lsf*pG->B1i[ks][j][i])*dx1i;
       Wr[i].By += hdt*MHD_src;
     }
@@ -519,22 +519,22 @@ void integrate_2d_ctu(DomainS *pD)
     hdtodx2 = 0.5*dtodx2;
 #endif
     for (j=js-nghost; j<=je+nghost; j++) {
-      U1d[j].d  = pG->U[ks][j][i].d;
-      U1d[j].Mx = pG->U[ks][j][i].M2;
-      U1d[j].My = pG->U[ks][j][i].M3;
-      U1d[j].Mz = pG->U[ks][j][i].M1;
+      U1d[j].d  = UVAR(pG,ks,j,i,d);
+      U1d[j].Mx = UVAR(pG,ks,j,i,M2);
+      U1d[j].My = UVAR(pG,ks,j,i,M3);
+      U1d[j].Mz = UVAR(pG,ks,j,i,M1);
 #ifndef BAROTROPIC
-      U1d[j].E  = pG->U[ks][j][i].E;
+      U1d[j].E  = UVAR(pG,ks,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-      U1d[j].By = pG->U[ks][j][i].B3c;
-      U1d[j].Bz = pG->U[ks][j][i].B1c;
-      Bxc[j] = pG->U[ks][j][i].B2c;
+      U1d[j].By = UVAR(pG,ks,j,i,B3c);
+      U1d[j].Bz = UVAR(pG,ks,j,i,B1c);
+      Bxc[j] = UVAR(pG,ks,j,i,B2c);
       Bxi[j] = pG->B2i[ks][j][i];
       B2_x2Face[j][i] = pG->B2i[ks][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-      for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[ks][j][i].s[n];
+      for (n=0; n<NSCALARS; n++) U1d[j].s[n] = UVAR(pG,ks,j,i,s[n]);
 #endif
     }
 
@@ -560,11 +560,11 @@ void integrate_2d_ctu(DomainS *pD)
 
 #ifdef MHD
     for (j=jl+1; j<=ju; j++) {
-      MHD_src = (pG->U[ks][j-1][i].M1/pG->U[ks][j-1][i].d)*
+      MHD_src = (UVAR(pG,ks,j-1,i,M1)/UVAR(pG,ks,j-1,i,d))*
         (pG->B2i[ks][j][i] - pG->B2i[ks][j-1][i])*dx2i;
       Wl[j].Bz += hdt*MHD_src;
 
-      MHD_src = (pG->U[ks][j][i].M1/pG->U[ks][j][i].d)*
+      MHD_src = (UVAR(pG,ks,j,i,M1)/UVAR(pG,ks,j,i,d))*
         (pG->B2i[ks][j+1][i] - pG->B2i[ks][j][i])*dx2i;
       Wr[j].Bz += hdt*MHD_src;
     }
@@ -668,8 +668,8 @@ void integrate_2d_ctu(DomainS *pD)
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
       emf3_cc[j][i] =
-        (pG->U[ks][j][i].B1c*pG->U[ks][j][i].M2 -
-         pG->U[ks][j][i].B2c*pG->U[ks][j][i].M1 )/pG->U[ks][j][i].d;
+        (UVAR(pG,ks,j,i,B1c)*UVAR(pG,ks,j,i,M2) -
+         UVAR(pG,ks,j,i,B2c)*UVAR(pG,ks,j,i,M1) )/UVAR(pG,ks,j,i,d);
     }
   }
 
@@ -760,10 +760,10 @@ void integrate_2d_ctu(DomainS *pD)
 #else
       dbx = pG->B1i[ks][j][i] - pG->B1i[ks][j][i-1];
 #endif
-      B1 = pG->U[ks][j][i-1].B1c;
-      B2 = pG->U[ks][j][i-1].B2c;
-      B3 = pG->U[ks][j][i-1].B3c;
-      V3 = pG->U[ks][j][i-1].M3/pG->U[ks][j][i-1].d;
+      B1 = UVAR(pG,ks,j,i-1,B1c);
+      B2 = UVAR(pG,ks,j,i-1,B2c);
+      B3 = UVAR(pG,ks,j,i-1,B3c);
+      V3 = UVAR(pG,ks,j,i-1,M3)/UVAR(pG,ks,j,i-1,d);
 
       Ul_x1Face[j][i].Mx += hdtodx1*B1*dbx;
       Ul_x1Face[j][i].My += hdtodx1*B2*dbx;
@@ -778,10 +778,10 @@ void integrate_2d_ctu(DomainS *pD)
 #else
       dbx = pG->B1i[ks][j][i+1] - pG->B1i[ks][j][i];
 #endif
-      B1 = pG->U[ks][j][i].B1c;
-      B2 = pG->U[ks][j][i].B2c;
-      B3 = pG->U[ks][j][i].B3c;
-      V3 = pG->U[ks][j][i].M3/pG->U[ks][j][i].d;
+      B1 = UVAR(pG,ks,j,i,B1c);
+      B2 = UVAR(pG,ks,j,i,B2c);
+      B3 = UVAR(pG,ks,j,i,B3c);
+      V3 = UVAR(pG,ks,j,i,M3)/UVAR(pG,ks,j,i,d);
 
       Ur_x1Face[j][i].Mx += hdtodx1*B1*dbx;
       Ur_x1Face[j][i].My += hdtodx1*B2*dbx;
@@ -812,10 +812,10 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
-        Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
 
 #ifdef ROTATING_FRAME
-        Ur_x1Face[j][i].My -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+        Ur_x1Face[j][i].My -= (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
 
 #ifndef BAROTROPIC
@@ -830,10 +830,10 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         hdtodx2 = hdt/(r[i-1]*pG->dx2);
 #endif
-        Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i-1].d;
+        Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i-1,d);
 
 #ifdef ROTATING_FRAME
-        Ul_x1Face[j][i].My -= (pG->dt)*Omega_0*pG->U[ks][j][i-1].M1;
+        Ul_x1Face[j][i].My -= (pG->dt)*Omega_0*UVAR(pG,ks,j,i-1,M1);
 #endif /*ROTATING_FRAME*/
 
 #ifndef BAROTROPIC
@@ -856,7 +856,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j+1][i]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j-1][i]);
 
-      Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+      Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
 #ifndef BAROTROPIC
       Ur_x1Face[j][i].E -= hdtodx2*(x2Flux[j  ][i  ].d*(phic - phil) +
                                     x2Flux[j+1][i  ].d*(phir - phic));
@@ -866,7 +866,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i-1] + pG->Phi[ks][j+1][i-1]);
       phil = 0.5*(pG->Phi[ks][j][i-1] + pG->Phi[ks][j-1][i-1]);
 
-      Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i-1].d;
+      Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i-1,d);
 #ifndef BAROTROPIC
       Ul_x1Face[j][i].E -= hdtodx2*(x2Flux[j  ][i-1].d*(phic - phil) +
                                     x2Flux[j+1][i-1].d*(phir - phic));
@@ -930,10 +930,10 @@ void integrate_2d_ctu(DomainS *pD)
       hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
       dby = pG->B2i[ks][j][i] - pG->B2i[ks][j-1][i];
-      B1 = pG->U[ks][j-1][i].B1c;
-      B2 = pG->U[ks][j-1][i].B2c;
-      B3 = pG->U[ks][j-1][i].B3c;
-      V3 = pG->U[ks][j-1][i].M3/pG->U[ks][j-1][i].d;
+      B1 = UVAR(pG,ks,j-1,i,B1c);
+      B2 = UVAR(pG,ks,j-1,i,B2c);
+      B3 = UVAR(pG,ks,j-1,i,B3c);
+      V3 = UVAR(pG,ks,j-1,i,M3)/UVAR(pG,ks,j-1,i,d);
 
       Ul_x2Face[j][i].Mz += hdtodx2*B1*dby;
       Ul_x2Face[j][i].Mx += hdtodx2*B2*dby;
@@ -944,10 +944,10 @@ void integrate_2d_ctu(DomainS *pD)
 #endif /* BAROTROPIC */
 
       dby = pG->B2i[ks][j+1][i] - pG->B2i[ks][j][i];
-      B1 = pG->U[ks][j][i].B1c;
-      B2 = pG->U[ks][j][i].B2c;
-      B3 = pG->U[ks][j][i].B3c;
-      V3 = pG->U[ks][j][i].M3/pG->U[ks][j][i].d;
+      B1 = UVAR(pG,ks,j,i,B1c);
+      B2 = UVAR(pG,ks,j,i,B2c);
+      B3 = UVAR(pG,ks,j,i,B3c);
+      V3 = UVAR(pG,ks,j,i,M3)/UVAR(pG,ks,j,i,d);
 
       Ur_x2Face[j][i].Mz += hdtodx2*B1*dby;
       Ur_x2Face[j][i].Mx += hdtodx2*B2*dby;
@@ -983,12 +983,12 @@ void integrate_2d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ur_x2Face[j][i].Mz -= hdt*pG->U[ks][j][i].d*g;
+        Ur_x2Face[j][i].Mz -= hdt*UVAR(pG,ks,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
+        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j][i].d*Om*x1vc(pG,i);
+        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,ks,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 
@@ -1010,12 +1010,12 @@ void integrate_2d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ul_x2Face[j][i].Mz -= hdt*pG->U[ks][j-1][i].d*g;
+        Ul_x2Face[j][i].Mz -= hdt*UVAR(pG,ks,j-1,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j-1][i].M2;
+        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,ks,j-1,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j-1][i].d*Om*x1vc(pG,i);
+        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,ks,j-1,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 
@@ -1045,7 +1045,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i+1]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i-1]);
 
-      Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+      Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*UVAR(pG,ks,j,i,d);
 #ifndef BAROTROPIC
       Ur_x2Face[j][i].E -= hdtodx1*(x1Flux[j  ][i  ].d*(phic - phil) +
                                     x1Flux[j  ][i+1].d*(phir - phic));
@@ -1056,7 +1056,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j-1][i] + pG->Phi[ks][j-1][i+1]);
       phil = 0.5*(pG->Phi[ks][j-1][i] + pG->Phi[ks][j-1][i-1]);
 
-      Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j-1][i].d;
+      Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*UVAR(pG,ks,j-1,i,d);
 #ifndef BAROTROPIC
       Ul_x2Face[j][i].E -= hdtodx1*(x1Flux[j-1][i  ].d*(phic - phil) +
                                     x1Flux[j-1][i+1].d*(phir - phic));
@@ -1084,7 +1084,7 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+        Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*UVAR(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[j][i].E -= hdtodx1*(x1Flux[j  ][i  ].d*(phic - phil) +
                                       x1Flux[j  ][i+1].d*(phir - phic));
@@ -1094,7 +1094,7 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),(x2-pG->dx2),x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),(x2-pG->dx2),x3);
 
-        Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j-1][i].d;
+        Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*UVAR(pG,ks,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[j][i].E -= hdtodx1*(x1Flux[j-1][i  ].d*(phic - phil) +
                                       x1Flux[j-1][i+1].d*(phir - phic));
@@ -1106,14 +1106,14 @@ void integrate_2d_ctu(DomainS *pD)
   if (ShBoxCoord == xz){
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j][i].M3;
-        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j-1][i].M3;
+        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*UVAR(pG,ks,j,i,M3);
+        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*UVAR(pG,ks,j-1,i,M3);
 #ifdef FARGO
-        Ur_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*UVAR(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*UVAR(pG,ks,j-1,i,M1);
 #else
-        Ur_x2Face[j][i].My -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].My -= pG->dt*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].My -= pG->dt*Omega_0*UVAR(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].My -= pG->dt*Omega_0*UVAR(pG,ks,j-1,i,M1);
 #endif
       }
     }
@@ -1122,14 +1122,14 @@ void integrate_2d_ctu(DomainS *pD)
   if (ShBoxCoord == xy){
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j][i].M2;
-        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j-1][i].M2;
+        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*UVAR(pG,ks,j,i,M2);
+        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*UVAR(pG,ks,j-1,i,M2);
 #ifdef FARGO
-        Ur_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*UVAR(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*UVAR(pG,ks,j-1,i,M1);
 #else
-        Ur_x2Face[j][i].Mx -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].Mx -= pG->dt*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].Mx -= pG->dt*Omega_0*UVAR(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].Mx -= pG->dt*Omega_0*UVAR(pG,ks,j-1,i,M1);
 #endif
       }
     }
@@ -1142,11 +1142,11 @@ void integrate_2d_ctu(DomainS *pD)
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
 
-      Ur_x2Face[j][i].Mz += pG->dt*Om*pG->U[ks][j][i].M2;
-      Ur_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[ks][j][i].M1;
+      Ur_x2Face[j][i].Mz += pG->dt*Om*UVAR(pG,ks,j,i,M2);
+      Ur_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*UVAR(pG,ks,j,i,M1);
 
-      Ul_x2Face[j][i].Mz += pG->dt*Om*pG->U[ks][j-1][i].M2;
-      Ul_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[ks][j-1][i].M1;
+      Ul_x2Face[j][i].Mz += pG->dt*Om*UVAR(pG,ks,j-1,i,M2);
+      Ul_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*UVAR(pG,ks,j-1,i,M1);
     }
   }
 #endif
@@ -1206,7 +1206,7 @@ void integrate_2d_ctu(DomainS *pD)
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
         hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
-        dhalf[j][i] = pG->U[ks][j][i].d
+        dhalf[j][i] = UVAR(pG,ks,j,i,d)
           - hdtodx1*(rsf*x1Flux[j  ][i+1].d - lsf*x1Flux[j][i].d)
           - hdtodx2*(    x2Flux[j+1][i  ].d -     x2Flux[j][i].d);
 
@@ -1236,20 +1236,20 @@ void integrate_2d_ctu(DomainS *pD)
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
       hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
-      M1h = pG->U[ks][j][i].M1
+      M1h = UVAR(pG,ks,j,i,M1)
         - hdtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx)
         - hdtodx2*(    x2Flux[j+1][i].Mz -     x2Flux[j][i].Mz);
 
-      M2h = pG->U[ks][j][i].M2
+      M2h = UVAR(pG,ks,j,i,M2)
         - hdtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My)
         - hdtodx2*(         x2Flux[j+1][i].Mx -          x2Flux[j][i].Mx);
 
-      M3h = pG->U[ks][j][i].M3
+      M3h = UVAR(pG,ks,j,i,M3)
         - hdtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz)
         - hdtodx2*(    x2Flux[j+1][i].My -     x2Flux[j][i].My);
 
 #ifndef BAROTROPIC
-      Eh = pG->U[ks][j][i].E
+      Eh = UVAR(pG,ks,j,i,E)
         - hdtodx1*(rsf*x1Flux[j][i+1].E - lsf*x1Flux[j][i].E)
         - hdtodx2*(    x2Flux[j+1][i].E -     x2Flux[j][i].E);
 #endif
@@ -1264,20 +1264,20 @@ void integrate_2d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
-        M1h -= hdt*pG->U[ks][j][i].d*g; 
+        M1h -= hdt*UVAR(pG,ks,j,i,d)*g; 
 #ifdef ROTATING_FRAME
-        M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
+        M1h += (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].d*Om*x1vc(pG,i);
+        M1h += (pG->dt)*Omega_0*UVAR(pG,ks,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-        M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        M2h -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
 #ifdef ROTATING_FRAME
-        M2h -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+        M2h -= (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
 
       }
@@ -1286,11 +1286,11 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef SELF_GRAVITY
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i+1]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i-1]);
-      M1h -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+      M1h -= hdtodx1*(phir-phil)*UVAR(pG,ks,j,i,d);
 
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j+1][i]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j-1][i]);
-      M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+      M2h -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
 #endif /* SELF_GRAVITY */
 
       /* Add the tidal gravity and Coriolis terms for shearing box. */
@@ -1299,28 +1299,28 @@ void integrate_2d_ctu(DomainS *pD)
         cc_pos(pG,i,j,ks,&x1,&x2,&x3);
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
-        M1h -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+        M1h -= hdtodx1*(phir-phil)*UVAR(pG,ks,j,i,d);
 
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
-        M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        M2h -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
       }
 
-      if (ShBoxCoord == xy) M1h += pG->dt*Omega_0*pG->U[ks][j][i].M2;
-      if (ShBoxCoord == xz) M1h += pG->dt*Omega_0*pG->U[ks][j][i].M3;
+      if (ShBoxCoord == xy) M1h += pG->dt*Omega_0*UVAR(pG,ks,j,i,M2);
+      if (ShBoxCoord == xz) M1h += pG->dt*Omega_0*UVAR(pG,ks,j,i,M3);
 #ifdef FARGO
-      if (ShBoxCoord == xy) M2h += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
-      if (ShBoxCoord == xz) M3h += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
+      if (ShBoxCoord == xy) M2h += hdt*(qshear-2.)*Omega_0*UVAR(pG,ks,j,i,M1);
+      if (ShBoxCoord == xz) M3h += hdt*(qshear-2.)*Omega_0*UVAR(pG,ks,j,i,M1);
 #else
-      if (ShBoxCoord == xy) M2h -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
-      if (ShBoxCoord == xz) M3h -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
+      if (ShBoxCoord == xy) M2h -= pG->dt*Omega_0*UVAR(pG,ks,j,i,M1);
+      if (ShBoxCoord == xz) M3h -= pG->dt*Omega_0*UVAR(pG,ks,j,i,M1);
 #endif
 #endif /* SHEARING_BOX */
 #if defined(CYLINDRICAL) && defined(FARGO)
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
-      M1h += hdt*2.0*Om*pG->U[ks][j][i].M2;
-      M2h += hdt*Om*(qshear-2.0)*pG->U[ks][j][i].M1;
+      M1h += hdt*2.0*Om*UVAR(pG,ks,j,i,M2);
+      M2h += hdt*Om*(qshear-2.0)*UVAR(pG,ks,j,i,M1);
 #endif
 
       /* Add the particle feedback terms */
@@ -1343,7 +1343,7 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef MHD
       B1ch = 0.5*(lsf*B1_x1Face[j][i] + rsf*B1_x1Face[j][i+1]);
       B2ch = 0.5*(    B2_x2Face[j][i] +     B2_x2Face[j+1][i]);
-      B3ch = pG->U[ks][j][i].B3c 
+      B3ch = UVAR(pG,ks,j,i,B3c) 
         - hdtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz)
         - hdtodx2*(    x2Flux[j+1][i].By -     x2Flux[j][i].By);
       emf3_cc[j][i] = (B1ch*M2h - B2ch*M1h)/dhalf[j][i];
@@ -1502,15 +1502,15 @@ void integrate_2d_ctu(DomainS *pD)
       hdtodx2 = hdt/(r[i]*pG->dx2);
 
       /* Calculate d at time n+1/2 */
-      dhalf[j][i] = pG->U[ks][j][i].d
+      dhalf[j][i] = UVAR(pG,ks,j,i,d)
         - hdtodx1*(rsf*x1Flux[j  ][i+1].d - lsf*x1Flux[j][i].d)
         - hdtodx2*(    x2Flux[j+1][i  ].d -     x2Flux[j][i].d);
 
 #ifdef FARGO
       dtodx2 = pG->dt/(r[i]*pG->dx2);
       /* Save current R/phi momenta */
-      Mrn = pG->U[ks][j][i].M1;
-      Mpn = pG->U[ks][j][i].M2;
+      Mrn = UVAR(pG,ks,j,i,M1);
+      Mpn = UVAR(pG,ks,j,i,M2);
 
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
@@ -1530,17 +1530,17 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
         g = (phir-phil)*dx1i;
-	Mre -= pG->dt*pG->U[ks][j][i].d*g;
+	Mre -= pG->dt*UVAR(pG,ks,j,i,d)*g;
 
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-	Mpe -= dtodx2*(phir-phil)*pG->U[ks][j][i].d;
+	Mpe -= dtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
       }
 
-        Mre += pG->dt*pG->U[ks][j][i].d *r[i]*SQR((*OrbitalProfile)(r[i]));
+        Mre += pG->dt*UVAR(pG,ks,j,i,d) *r[i]*SQR((*OrbitalProfile)(r[i]));
 #ifdef ROTATING_FRAME
-        Mre += (pG->dt)*2.0*Omega_0*(pG->U[ks][j][i].M2+pG->U[ks][j][i].d*Om*x1vc(pG,i));
-        Mpe -= (pG->dt)*2.0*Omega_0*pG->U[ks][j][i].M1;
+        Mre += (pG->dt)*2.0*Omega_0*(UVAR(pG,ks,j,i,M2)+UVAR(pG,ks,j,i,d)*Om*x1vc(pG,i));
+        Mpe -= (pG->dt)*2.0*Omega_0*UVAR(pG,ks,j,i,M1);
 #endif
 
       /* Average forward euler and current values to approximate at t^{n+1/2} */
@@ -1552,10 +1552,10 @@ void integrate_2d_ctu(DomainS *pD)
 #else /* FARGO */
 
       /* Calculate m1 and m2 at time n+1/2 */
-      M1h = pG->U[ks][j][i].M1
+      M1h = UVAR(pG,ks,j,i,M1)
         - hdtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx)
         - hdtodx2*(    x2Flux[j+1][i].Mz -     x2Flux[j][i].Mz);
-      M2h = pG->U[ks][j][i].M2
+      M2h = UVAR(pG,ks,j,i,M2)
         - hdtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My)
         - hdtodx2*(         x2Flux[j+1][i].Mx -          x2Flux[j][i].Mx);
       /* Add the geometric source term */
@@ -1567,16 +1567,16 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
         g = (phir-phil)*dx1i;
-        M1h -= hdt*pG->U[ks][j][i].d*g;
+        M1h -= hdt*UVAR(pG,ks,j,i,d)*g;
 
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-        M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        M2h -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
       }
 
 #ifdef ROTATING_FRAME
-        M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
-	M2h -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+        M1h += (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M2);
+	M2h -= (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
       /* compute geometric source term at time n+1/2 */
       geom_src[j][i] = SQR(M2h)/dhalf[j][i];
@@ -1590,7 +1590,7 @@ void integrate_2d_ctu(DomainS *pD)
       geom_src[j][i] += Iso_csound2*dhalf[j][i];
 #ifdef MHD
       B1ch = 0.5*(rsf*B1_x1Face[j][i+1] + lsf*B1_x1Face[j][i]);
-      B3ch = pG->U[ks][j][i].B3c
+      B3ch = UVAR(pG,ks,j,i,B3c)
         - hdtodx1*(rsf*x1Flux[j  ][i+1].Bz - lsf*x1Flux[j][i].Bz)
         - hdtodx2*(    x2Flux[j+1][i  ].By -     x2Flux[j][i].By);
       geom_src[j][i] += 0.5*(SQR(B1ch)+SQR(B2ch)+SQR(B3ch));
@@ -1603,18 +1603,18 @@ void integrate_2d_ctu(DomainS *pD)
 
 #ifdef FARGO
       /* Use average values to apply source terms for full time-step */
-      pG->U[ks][j][i].M1 += pG->dt*( 2.0*Om*Mpav + geom_src[j][i]);
-      pG->U[ks][j][i].M2 += pG->dt*( Om*(qshear-2.0)*Mrav);
+      UVAR(pG,ks,j,i,M1) += pG->dt*( 2.0*Om*Mpav + geom_src[j][i]);
+      UVAR(pG,ks,j,i,M2) += pG->dt*( Om*(qshear-2.0)*Mrav);
 #ifdef ROTATING_FRAME
-      pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
-      pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*Mrav;
+      UVAR(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
+      UVAR(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*Mrav;
 #endif 
 #else /* FARGO*/
       /* add time-centered geometric source term for full dt */
-      pG->U[ks][j][i].M1 += pG->dt*geom_src[j][i];
+      UVAR(pG,ks,j,i,M1) += pG->dt*geom_src[j][i];
 #ifdef ROTATING_FRAME
-      pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*M2h;
-      pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*M1h;
+      UVAR(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*M2h;
+      UVAR(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*M1h;
 #endif /* ROTATING_FRAME */
 #endif /* FARGO */
     }
@@ -1638,13 +1638,13 @@ void integrate_2d_ctu(DomainS *pD)
       cc_pos(pG,i,j,ks,&x1,&x2,&x3);
 
 /* Store the current state */
-      M1n  = pG->U[ks][j][i].M1;
+      M1n  = UVAR(pG,ks,j,i,M1);
 #ifdef FARGO
-      if (ShBoxCoord==xy) dM2n = pG->U[ks][j][i].M2;
-      if (ShBoxCoord==xz) dM3n = pG->U[ks][j][i].M3;
+      if (ShBoxCoord==xy) dM2n = UVAR(pG,ks,j,i,M2);
+      if (ShBoxCoord==xz) dM3n = UVAR(pG,ks,j,i,M3);
 #else
-      if (ShBoxCoord==xy) dM2n = pG->U[ks][j][i].M2 + qom*x1*pG->U[ks][j][i].d;
-      if (ShBoxCoord==xz) dM3n = pG->U[ks][j][i].M3 + qom*x1*pG->U[ks][j][i].d;
+      if (ShBoxCoord==xy) dM2n = UVAR(pG,ks,j,i,M2) + qom*x1*UVAR(pG,ks,j,i,d);
+      if (ShBoxCoord==xz) dM3n = UVAR(pG,ks,j,i,M3) + qom*x1*UVAR(pG,ks,j,i,d);
 #endif
 
 /* Calculate the flux for the y-momentum fluctuation (M3 in 2D) */
@@ -1699,17 +1699,17 @@ void integrate_2d_ctu(DomainS *pD)
  * discretization for the momentum fluctuation equation. */
 
       if (ShBoxCoord==xy){
-        pG->U[ks][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[ks][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+        UVAR(pG,ks,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        UVAR(pG,ks,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 #ifndef FARGO
-        pG->U[ks][j][i].M2 -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
+        UVAR(pG,ks,j,i,M2) -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
 #endif
       }
       if (ShBoxCoord==xz){
-        pG->U[ks][j][i].M1 += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[ks][j][i].M3 += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
+        UVAR(pG,ks,j,i,M1) += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        UVAR(pG,ks,j,i,M3) += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
 #ifndef FARGO
-        pG->U[ks][j][i].M3 -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
+        UVAR(pG,ks,j,i,M3) -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
 #endif
       }
 
@@ -1720,14 +1720,14 @@ void integrate_2d_ctu(DomainS *pD)
       phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
       phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
+      UVAR(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
                                    x1Flux[j][i+1].d*(phir - phic));
 #endif
 
       phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
       phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+      UVAR(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                    x2Flux[j+1][i].d*(phir - phic));
 #endif
     }
@@ -1751,24 +1751,24 @@ void integrate_2d_ctu(DomainS *pD)
         g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif /* CYLINDRICAL */
-        pG->U[ks][j][i].M1 -= pG->dt*dhalf[j][i]*g;
+        UVAR(pG,ks,j,i,M1) -= pG->dt*dhalf[j][i]*g;
 
 #ifndef BAROTROPIC
 #ifdef CYLINDRICAL
-        pG->U[ks][j][i].E -= hdt*g*(lsf*x1Flux[j][i  ].d +
+        UVAR(pG,ks,j,i,E) -= hdt*g*(lsf*x1Flux[j][i  ].d +
                                      rsf*x1Flux[j][i+1].d);
 #else        
-        pG->U[ks][j][i].E -= dtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil) +
+        UVAR(pG,ks,j,i,E) -= dtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil) +
                                      rsf*x1Flux[j][i+1].d*(phir - phic));
 #endif
 #endif
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        pG->U[ks][j][i].M2 -= dtodx2*dhalf[j][i]*(phir-phil);
+        UVAR(pG,ks,j,i,M2) -= dtodx2*dhalf[j][i]*(phir-phil);
 
 #ifndef BAROTROPIC
-        pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+        UVAR(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                      x2Flux[j+1][i].d*(phir - phic));
 #endif
       }
@@ -1808,10 +1808,10 @@ void integrate_2d_ctu(DomainS *pD)
       flux_m2r = gxr*gyr/four_pi_G;
 
 /* Update momenta and energy with d/dx1 terms  */
-      pG->U[ks][j][i].M1 -= dtodx1*(flux_m1r - flux_m1l);
-      pG->U[ks][j][i].M2 -= dtodx1*(flux_m2r - flux_m2l);
+      UVAR(pG,ks,j,i,M1) -= dtodx1*(flux_m1r - flux_m1l);
+      UVAR(pG,ks,j,i,M2) -= dtodx1*(flux_m2r - flux_m2l);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
+      UVAR(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
                                    x1Flux[j][i+1].d*(phir - phic));
 #endif
     }
@@ -1842,10 +1842,10 @@ void integrate_2d_ctu(DomainS *pD)
       flux_m2r = 0.5*(gyr*gyr-gxr*gxr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx2 terms  */
-      pG->U[ks][j][i].M1 -= dtodx2*(flux_m1r - flux_m1l);
-      pG->U[ks][j][i].M2 -= dtodx2*(flux_m2r - flux_m2l);
+      UVAR(pG,ks,j,i,M1) -= dtodx2*(flux_m1r - flux_m1l);
+      UVAR(pG,ks,j,i,M2) -= dtodx2*(flux_m2r - flux_m2l);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+      UVAR(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                    x2Flux[j+1][i].d*(phir - phic));
 #endif
     }
@@ -1869,7 +1869,7 @@ void integrate_2d_ctu(DomainS *pD)
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
         coolf = (*CoolingFunc)(dhalf[j][i],phalf[j][i],pG->dt);
-        pG->U[ks][j][i].E -= pG->dt*coolf;
+        UVAR(pG,ks,j,i,E) -= pG->dt*coolf;
       }
     }
   }
@@ -1882,11 +1882,11 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef FEEDBACK
   for (j=js; j<=je; j++)
     for (i=is; i<=ie; i++) {
-      pG->U[ks][j][i].M1 -= pG->Coup[ks][j][i].fb1;
-      pG->U[ks][j][i].M2 -= pG->Coup[ks][j][i].fb2;
-      pG->U[ks][j][i].M3 -= pG->Coup[ks][j][i].fb3;
+      UVAR(pG,ks,j,i,M1) -= pG->Coup[ks][j][i].fb1;
+      UVAR(pG,ks,j,i,M2) -= pG->Coup[ks][j][i].fb2;
+      UVAR(pG,ks,j,i,M3) -= pG->Coup[ks][j][i].fb3;
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E += pG->Coup[ks][j][i].Eloss;
+      UVAR(pG,ks,j,i,E) += pG->Coup[ks][j][i].Eloss;
       pG->Coup[ks][j][i].Eloss *= dt1; /* for history output purpose */
 #endif
     }
@@ -1903,20 +1903,20 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][j][i].d  -= dtodx1*(rsf*x1Flux[j][i+1].d  - lsf*x1Flux[j][i].d );
-      pG->U[ks][j][i].M1 -= dtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx);
-      pG->U[ks][j][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My);
-      pG->U[ks][j][i].M3 -= dtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz);
+      UVAR(pG,ks,j,i,d)  -= dtodx1*(rsf*x1Flux[j][i+1].d  - lsf*x1Flux[j][i].d );
+      UVAR(pG,ks,j,i,M1) -= dtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx);
+      UVAR(pG,ks,j,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My);
+      UVAR(pG,ks,j,i,M3) -= dtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E  -= dtodx1*(rsf*x1Flux[j][i+1].E  - lsf*x1Flux[j][i].E );
+      UVAR(pG,ks,j,i,E)  -= dtodx1*(rsf*x1Flux[j][i+1].E  - lsf*x1Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B2c -= dtodx1*(x1Flux[j][i+1].By - x1Flux[j][i].By);
-      pG->U[ks][j][i].B3c -= dtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz);
+      UVAR(pG,ks,j,i,B2c) -= dtodx1*(x1Flux[j][i+1].By - x1Flux[j][i].By);
+      UVAR(pG,ks,j,i,B3c) -= dtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx1*(rsf*x1Flux[j][i+1].s[n] 
+        UVAR(pG,ks,j,i,s[n]) -= dtodx1*(rsf*x1Flux[j][i+1].s[n] 
                                       - lsf*x1Flux[j][i  ].s[n]);
 #endif
     }
@@ -1931,20 +1931,20 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
       dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-      pG->U[ks][j][i].d  -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
-      pG->U[ks][j][i].M1 -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
-      pG->U[ks][j][i].M2 -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
-      pG->U[ks][j][i].M3 -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
+      UVAR(pG,ks,j,i,d)  -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
+      UVAR(pG,ks,j,i,M1) -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
+      UVAR(pG,ks,j,i,M2) -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
+      UVAR(pG,ks,j,i,M3) -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E  -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
+      UVAR(pG,ks,j,i,E)  -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B3c -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
-      pG->U[ks][j][i].B1c -= dtodx2*(x2Flux[j+1][i].Bz - x2Flux[j][i].Bz);
+      UVAR(pG,ks,j,i,B3c) -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
+      UVAR(pG,ks,j,i,B1c) -= dtodx2*(x2Flux[j+1][i].Bz - x2Flux[j][i].Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx2*(x2Flux[j+1][i].s[n] 
+        UVAR(pG,ks,j,i,s[n]) -= dtodx2*(x2Flux[j+1][i].s[n] 
                                          - x2Flux[j  ][i].s[n]);
 #endif
     }
@@ -1961,10 +1961,10 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][j][i].B1c =0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
-      pG->U[ks][j][i].B2c =0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
+      UVAR(pG,ks,j,i,B1c) =0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
+      UVAR(pG,ks,j,i,B2c) =0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
       /* Set the 3-interface magnetic field equal to the cell center field. */
-      pG->B3i[ks][j][i] = pG->U[ks][j][i].B3c;
+      pG->B3i[ks][j][i] = UVAR(pG,ks,j,i,B3c);
     }
   }
 #endif /* MHD */
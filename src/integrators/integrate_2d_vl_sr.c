@@ -143,15 +143,15 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
-      Uhalf[j][i] = pG->U[ks][j][i];
-      W[j][i] = Cons_to_Prim(&(pG->U[ks][j][i]));
+      Uhalf[j][i] = UGET(pG,ks,j,i);
+      W[j][i] = Cons_to_Prim(UPTR(pG,ks,j,i));
 #ifdef MHD
       B1_x1Face[j][i] = pG->B1i[ks][j][i]; 
       B2_x2Face[j][i] = pG->B2i[ks][j][i]; 
 #endif /* MHD */
 #ifdef USE_ENTROPY_FIX
       S[j][i] = W[j][i].P * pow(W[j][i].d,1.0-Gamma);
-      S[j][i]*= pG->U[ks][j][i].d / W[j][i].d;
+      S[j][i]*= UVAR(pG,ks,j,i,d) / W[j][i].d;
       Shalf[j][i] = S[j][i];
 #endif
     }
@@ -427,7 +427,7 @@ void integrate_2d_vl(DomainS *pD)
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Uhalf[j][i].M1 -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+        Uhalf[j][i].M1 -= hdtodx1*(phir-phil)*UVAR(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[j][i].E -= hdtodx1*(x1Flux[j][i  ].d*(phic - phil)
                            + x1Flux[j][i+1].d*(phir - phic));
@@ -435,7 +435,7 @@ void integrate_2d_vl(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*UVAR(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[j][i].E -= hdtodx2*(x2Flux[j  ][i].d*(phic - phil)
                                 + x2Flux[j+1][i].d*(phir - phic));
@@ -803,8 +803,8 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pG->U[ks][j][i].B1c = 0.5*(pG->B1i[ks][j][i]+pG->B1i[ks][j][i+1]);
-      pG->U[ks][j][i].B2c = 0.5*(pG->B2i[ks][j][i]+pG->B2i[ks][j+1][i]);
+      UVAR(pG,ks,j,i,B1c) = 0.5*(pG->B1i[ks][j][i]+pG->B1i[ks][j][i+1]);
+      UVAR(pG,ks,j,i,B2c) = 0.5*(pG->B2i[ks][j][i]+pG->B2i[ks][j+1][i]);
     }
   }
 #endif /* MHD */
@@ -826,17 +826,17 @@ void integrate_2d_vl(DomainS *pD)
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-        pG->U[ks][j][i].M1 -= dtodx1*(phir-phil)*Uhalf[j][i].d;
+        UVAR(pG,ks,j,i,M1) -= dtodx1*(phir-phil)*Uhalf[j][i].d;
 #ifndef BAROTROPIC
-        pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil)
+        UVAR(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil)
                                    + x1Flux[j][i+1].d*(phir - phic));
 #endif
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        pG->U[ks][j][i].M2 -= dtodx2*(phir-phil)*Uhalf[j][i].d;
+        UVAR(pG,ks,j,i,M2) -= dtodx2*(phir-phil)*Uhalf[j][i].d;
 #ifndef BAROTROPIC
-        pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil)
+        UVAR(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil)
                                    + x2Flux[j+1][i].d*(phir - phic));
 #endif
       }
@@ -851,19 +851,19 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pG->U[ks][j][i].d   -= dtodx1*(x1Flux[j][i+1].d  - x1Flux[j][i].d );
-      pG->U[ks][j][i].M1  -= dtodx1*(x1Flux[j][i+1].Mx - x1Flux[j][i].Mx);
-      pG->U[ks][j][i].M2  -= dtodx1*(x1Flux[j][i+1].My - x1Flux[j][i].My);
-      pG->U[ks][j][i].M3  -= dtodx1*(x1Flux[j][i+1].Mz - x1Flux[j][i].Mz);
+      UVAR(pG,ks,j,i,d)   -= dtodx1*(x1Flux[j][i+1].d  - x1Flux[j][i].d );
+      UVAR(pG,ks,j,i,M1)  -= dtodx1*(x1Flux[j][i+1].Mx - x1Flux[j][i].Mx);
+      UVAR(pG,ks,j,i,M2)  -= dtodx1*(x1Flux[j][i+1].My - x1Flux[j][i].My);
+      UVAR(pG,ks,j,i,M3)  -= dtodx1*(x1Flux[j][i+1].Mz - x1Flux[j][i].Mz);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E   -= dtodx1*(x1Flux[j][i+1].E  - x1Flux[j][i].E );
+      UVAR(pG,ks,j,i,E)   -= dtodx1*(x1Flux[j][i+1].E  - x1Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B3c -= dtodx1*(x1Flux[j][i+1].Bz - x1Flux[j][i].Bz);
+      UVAR(pG,ks,j,i,B3c) -= dtodx1*(x1Flux[j][i+1].Bz - x1Flux[j][i].Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx1*(x1Flux[j][i+1].s[n]
+        UVAR(pG,ks,j,i,s[n]) -= dtodx1*(x1Flux[j][i+1].s[n]
                                       - x1Flux[j][i  ].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -878,19 +878,19 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pG->U[ks][j][i].d   -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
-      pG->U[ks][j][i].M1  -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
-      pG->U[ks][j][i].M2  -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
-      pG->U[ks][j][i].M3  -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
+      UVAR(pG,ks,j,i,d)   -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
+      UVAR(pG,ks,j,i,M1)  -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
+      UVAR(pG,ks,j,i,M2)  -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
+      UVAR(pG,ks,j,i,M3)  -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E   -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
+      UVAR(pG,ks,j,i,E)   -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B3c -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
+      UVAR(pG,ks,j,i,B3c) -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx2*(x2Flux[j+1][i].s[n]
+        UVAR(pG,ks,j,i,s[n]) -= dtodx2*(x2Flux[j+1][i].s[n]
                                       - x2Flux[j  ][i].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -909,7 +909,7 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      Wcheck = check_Prim(&(pG->U[ks][j][i]));
+      Wcheck = check_Prim(UPTR(pG,ks,j,i));
       if (Wcheck.d < 0.0) {
         flag_cell = 1;
         BadCell.i = i;
@@ -965,7 +965,7 @@ void integrate_2d_vl(DomainS *pD)
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
       flag_cell=0;
-      Wcheck = check_Prim(&(pG->U[ks][j][i]));
+      Wcheck = check_Prim(UPTR(pG,ks,j,i));
       if (Wcheck.d < 0.0) {
         flag_cell = 1;
         negd++;
@@ -982,30 +982,30 @@ void integrate_2d_vl(DomainS *pD)
 #ifdef USE_ENTROPY_FIX
       if (flag_cell != 0) {
 	entropy++;
-	Wcheck = entropy_fix (&(pG->U[ks][j][i]),&(S[j][i]));
+	Wcheck = entropy_fix (UPTR(pG,ks,j,i),&(S[j][i]));
 	Ucheck = Prim_to_Cons(&Wcheck);
 	Wcheck = check_Prim(&Ucheck);
 	Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
 	if (Wcheck.d > 0.0 && Wcheck.P > 0.0 && Vsq < 1.0){
-          pG->U[ks][j][i].d = Ucheck.d;
-          pG->U[ks][j][i].M1 = Ucheck.M1;
-          pG->U[ks][j][i].M2 = Ucheck.M2;
-          pG->U[ks][j][i].M3 = Ucheck.M3;
-          pG->U[ks][j][i].E = Ucheck.E;
+          UVAR(pG,ks,j,i,d) = Ucheck.d;
+          UVAR(pG,ks,j,i,M1) = Ucheck.M1;
+          UVAR(pG,ks,j,i,M2) = Ucheck.M2;
+          UVAR(pG,ks,j,i,M3) = Ucheck.M3;
+          UVAR(pG,ks,j,i,E) = Ucheck.E;
 	  flag_cell = 0;
 	}
       }
 #endif
       if (flag_cell != 0) {
 	final++;
-	Wcheck = fix_vsq (&(pG->U[ks][j][i]));
+	Wcheck = fix_vsq (UPTR(pG,ks,j,i));
 	Ucheck = Prim_to_Cons(&Wcheck);
-	pG->U[ks][j][i].d = Ucheck.d;
-	pG->U[ks][j][i].M1 = Ucheck.M1;
-	pG->U[ks][j][i].M2 = Ucheck.M2;
-	pG->U[ks][j][i].M3 = Ucheck.M3;
-	pG->U[ks][j][i].E = Ucheck.E;
-	Wcheck = check_Prim(&(pG->U[ks][j][i]));
+	UVAR(pG,ks,j,i,d) = Ucheck.d;
+	UVAR(pG,ks,j,i,M1) = Ucheck.M1;
+	UVAR(pG,ks,j,i,M2) = Ucheck.M2;
+	UVAR(pG,ks,j,i,M3) = Ucheck.M3;
+	UVAR(pG,ks,j,i,E) = Ucheck.E;
+	Wcheck = check_Prim(UPTR(pG,ks,j,i));
 	Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
 	if (Wcheck.d < 0.0 || Wcheck.P < 0.0 || Vsq > 1.0){
 	  fail++;
@@ -1517,29 +1517,29 @@ static void FixCell(GridS *pG, Int3Vect ix)
 
 /* Use flux differences to correct bad cell-centered quantities */
 
-  pG->U[ks][ix.j][ix.i].d  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
-  pG->U[ks][ix.j][ix.i].M1 += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
-  pG->U[ks][ix.j][ix.i].M2 += dtodx1*(x1FD_ip1.My - x1FD_i.My);
-  pG->U[ks][ix.j][ix.i].M3 += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
+  UVAR(pG,ks,ix.j,ix.i,d)  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
+  UVAR(pG,ks,ix.j,ix.i,M1) += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
+  UVAR(pG,ks,ix.j,ix.i,M2) += dtodx1*(x1FD_ip1.My - x1FD_i.My);
+  UVAR(pG,ks,ix.j,ix.i,M3) += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
 #ifndef BAROTROPIC
-  pG->U[ks][ix.j][ix.i].E  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
+  UVAR(pG,ks,ix.j,ix.i,E)  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-  pG->U[ks][ix.j][ix.i].B3c += dtodx1*(x1FD_ip1.Bz - x1FD_i.Bz);
+  UVAR(pG,ks,ix.j,ix.i,B3c) += dtodx1*(x1FD_ip1.Bz - x1FD_i.Bz);
 #endif /* MHD */
   /*#ifdef USE_ENTROPY_FIX
   S[ix.j][ix.i]  += dtodx1*(x1SFD_ip1  - x1SFD_i );
   #endif*/
 
-  pG->U[ks][ix.j][ix.i].d  += dtodx2*(x2FD_jp1.d  - x2FD_j.d );
-  pG->U[ks][ix.j][ix.i].M1 += dtodx2*(x2FD_jp1.Mz - x2FD_j.Mz);
-  pG->U[ks][ix.j][ix.i].M2 += dtodx2*(x2FD_jp1.Mx - x2FD_j.Mx);
-  pG->U[ks][ix.j][ix.i].M3 += dtodx2*(x2FD_jp1.My - x2FD_j.My);
+  UVAR(pG,ks,ix.j,ix.i,d)  += dtodx2*(x2FD_jp1.d  - x2FD_j.d );
+  UVAR(pG,ks,ix.j,ix.i,M1) += dtodx2*(x2FD_jp1.Mz - x2FD_j.Mz);
+  UVAR(pG,ks,ix.j,ix.i,M2) += dtodx2*(x2FD_jp1.Mx - x2FD_j.Mx);
+  UVAR(pG,ks,ix.j,ix.i,M3) += dtodx2*(x2FD_jp1.My - x2FD_j.My);
 #ifndef BAROTROPIC
-  pG->U[ks][ix.j][ix.i].E  += dtodx2*(x2FD_jp1.E  - x2FD_j.E );
+  UVAR(pG,ks,ix.j,ix.i,E)  += dtodx2*(x2FD_jp1.E  - x2FD_j.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-  pG->U[ks][ix.j][ix.i].B3c += dtodx2*(x2FD_jp1.By - x2FD_j.By);
+  UVAR(pG,ks,ix.j,ix.i,B3c) += dtodx2*(x2FD_jp1.By - x2FD_j.By);
 #endif /* MHD */
   /*#ifdef USE_ENTROPY_FIX
   S[ix.j][ix.i]  += dtodx2*(x2SFD_jp1  - x2SFD_j );
@@ -1548,15 +1548,15 @@ static void FixCell(GridS *pG, Int3Vect ix)
 /* Use flux differences to correct cell-centered values at i-1 and i+1 */
 
   if (ix.i > pG->is) {
-    pG->U[ks][ix.j][ix.i-1].d  += dtodx1*(x1FD_i.d );
-    pG->U[ks][ix.j][ix.i-1].M1 += dtodx1*(x1FD_i.Mx);
-    pG->U[ks][ix.j][ix.i-1].M2 += dtodx1*(x1FD_i.My);
-    pG->U[ks][ix.j][ix.i-1].M3 += dtodx1*(x1FD_i.Mz);
+    UVAR(pG,ks,ix.j,ix.i-1,d)  += dtodx1*(x1FD_i.d );
+    UVAR(pG,ks,ix.j,ix.i-1,M1) += dtodx1*(x1FD_i.Mx);
+    UVAR(pG,ks,ix.j,ix.i-1,M2) += dtodx1*(x1FD_i.My);
+    UVAR(pG,ks,ix.j,ix.i-1,M3) += dtodx1*(x1FD_i.Mz);
 #ifndef BAROTROPIC
-    pG->U[ks][ix.j][ix.i-1].E  += dtodx1*(x1FD_i.E );
+    UVAR(pG,ks,ix.j,ix.i-1,E)  += dtodx1*(x1FD_i.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-    pG->U[ks][ix.j][ix.i-1].B3c += dtodx1*(x1FD_i.Bz);
+    UVAR(pG,ks,ix.j,ix.i-1,B3c) += dtodx1*(x1FD_i.Bz);
 #endif /* MHD */
     /*#ifdef USE_ENTROPY_FIX
     S[ix.j][ix.i-1]  += dtodx1*(x1SFD_i );
@@ -1564,15 +1564,15 @@ static void FixCell(GridS *pG, Int3Vect ix)
   }
 
   if (ix.i < pG->ie) {
-    pG->U[ks][ix.j][ix.i+1].d  -= dtodx1*(x1FD_ip1.d );
-    pG->U[ks][ix.j][ix.i+1].M1 -= dtodx1*(x1FD_ip1.Mx);
-    pG->U[ks][ix.j][ix.i+1].M2 -= dtodx1*(x1FD_ip1.My);
-    pG->U[ks][ix.j][ix.i+1].M3 -= dtodx1*(x1FD_ip1.Mz);
+    UVAR(pG,ks,ix.j,ix.i+1,d)  -= dtodx1*(x1FD_ip1.d );
+    UVAR(pG,ks,ix.j,ix.i+1,M1) -= dtodx1*(x1FD_ip1.Mx);
+    UVAR(pG,ks,ix.j,ix.i+1,M2) -= dtodx1*(x1FD_ip1.My);
+    UVAR(pG,ks,ix.j,ix.i+1,M3) -= dtodx1*(x1FD_ip1.Mz);
 #ifndef BAROTROPIC
-    pG->U[ks][ix.j][ix.i+1].E  -= dtodx1*(x1FD_ip1.E );
+    UVAR(pG,ks,ix.j,ix.i+1,E)  -= dtodx1*(x1FD_ip1.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-    pG->U[ks][ix.j][ix.i+1].B3c -= dtodx1*(x1FD_ip1.Bz);
+    UVAR(pG,ks,ix.j,ix.i+1,B3c) -= dtodx1*(x1FD_ip1.Bz);
 #endif /* MHD */
     /*#ifdef USE_ENTROPY_FIX
     S[ix.j][ix.i+1]  -= dtodx1*(x1SFD_ip1 );
@@ -1582,15 +1582,15 @@ static void FixCell(GridS *pG, Int3Vect ix)
 /* Use flux differences to correct cell-centered values at j-1 and j+1 */
 
   if (ix.j > pG->js) {
-    pG->U[ks][ix.j-1][ix.i].d  += dtodx2*(x2FD_j.d );
-    pG->U[ks][ix.j-1][ix.i].M1 += dtodx2*(x2FD_j.Mz);
-    pG->U[ks][ix.j-1][ix.i].M2 += dtodx2*(x2FD_j.Mx);
-    pG->U[ks][ix.j-1][ix.i].M3 += dtodx2*(x2FD_j.My);
+    UVAR(pG,ks,ix.j-1,ix.i,d)  += dtodx2*(x2FD_j.d );
+    UVAR(pG,ks,ix.j-1,ix.i,M1) += dtodx2*(x2FD_j.Mz);
+    UVAR(pG,ks,ix.j-1,ix.i,M2) += dtodx2*(x2FD_j.Mx);
+    UVAR(pG,ks,ix.j-1,ix.i,M3) += dtodx2*(x2FD_j.My);
 #ifndef BAROTROPIC
-    pG->U[ks][ix.j-1][ix.i].E  += dtodx2*(x2FD_j.E );
+    UVAR(pG,ks,ix.j-1,ix.i,E)  += dtodx2*(x2FD_j.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-    pG->U[ks][ix.j-1][ix.i].B3c += dtodx2*(x2FD_j.By);
+    UVAR(pG,ks,ix.j-1,ix.i,B3c) += dtodx2*(x2FD_j.By);
 #endif /* MHD */
     /*#ifdef USE_ENTROPY_FIX
    S[ix.j-1][ix.i]  += dtodx2*(x2SFD_j );
@@ -1598,15 +1598,15 @@ static void FixCell(GridS *pG, Int3Vect ix)
   }
 
   if (ix.j < pG->je) {
-    pG->U[ks][ix.j+1][ix.i].d  -= dtodx2*(x2FD_jp1.d );
-    pG->U[ks][ix.j+1][ix.i].M1 -= dtodx2*(x2FD_jp1.Mz);
-    pG->U[ks][ix.j+1][ix.i].M2 -= dtodx2*(x2FD_jp1.Mx);
-    pG->U[ks][ix.j+1][ix.i].M3 -= dtodx2*(x2FD_jp1.My);
+    UVAR(pG,ks,ix.j+1,ix.i,d)  -= dtodx2*(x2FD_jp1.d );
+    UVAR(pG,ks,ix.j+1,ix.i,M1) -= dtodx2*(x2FD_jp1.Mz);
+    UVAR(pG,ks,ix.j+1,ix.i,M2) -= dtodx2*(x2FD_jp1.Mx);
+    UVAR(pG,ks,ix.j+1,ix.i,M3) -= dtodx2*(x2FD_jp1.My);
 #ifndef BAROTROPIC
-    pG->U[ks][ix.j+1][ix.i].E  -= dtodx2*(x2FD_jp1.E );
+    UVAR(pG,ks,ix.j+1,ix.i,E)  -= dtodx2*(x2FD_jp1.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-    pG->U[ks][ix.j+1][ix.i].B3c -= dtodx2*(x2FD_jp1.By);
+    UVAR(pG,ks,ix.j+1,ix.i,B3c) -= dtodx2*(x2FD_jp1.By);
 #endif /* MHD */
     /*#ifdef USE_ENTROPY_FIX
     S[ix.j+1][ix.i]  -= dtodx2*(x2SFD_jp1 );
@@ -1642,8 +1642,8 @@ static void FixCell(GridS *pG, Int3Vect ix)
 /* compute new cell-centered fields */
   for (j=(ix.j-1); j<=(ix.j+1); j++) {
   for (i=(ix.i-1); i<=(ix.i+1); i++) {
-    pG->U[ks][j][i].B1c = 0.5*(pG->B1i[ks][j][i] + pG->B1i[ks][j][i+1]);
-    pG->U[ks][j][i].B2c = 0.5*(pG->B2i[ks][j][i] + pG->B2i[ks][j+1][i]);
+    UVAR(pG,ks,j,i,B1c) = 0.5*(pG->B1i[ks][j][i] + pG->B1i[ks][j][i+1]);
+    UVAR(pG,ks,j,i,B2c) = 0.5*(pG->B2i[ks][j][i] + pG->B2i[ks][j+1][i]);
   }}
 #endif /* MHD */
 
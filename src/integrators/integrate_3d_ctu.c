@@ -69,6 +69,25 @@ static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(Bxc,Bxi,W,Wl,Wr,U1d)
+#endif
+
+#ifdef FLUXES_PENCIL
+/* L/R states and fluxes along a pencil of interfaces, for fluxes_pencil() */
+static Cons1DArrS UlPen, UrPen, FluxPen;
+static Prim1DArrS WlPen, WrPen;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(UlPen,UrPen,FluxPen,WlPen,WrPen)
+#endif
+
+/* Row of interface Bx for fluxes_pencil(); it is not used for hydro */
+#ifdef MHD
+#define BX_ROW(B,k,j) ((B)[k][j])
+#else
+#define BX_ROW(B,k,j) NULL
+#endif
+#endif /* FLUXES_PENCIL */
 
 /* density and Pressure at t^{n+1/2} needed by MHD, cooling, and gravity */
 static Real ***dhalf = NULL, ***phalf=NULL;
@@ -89,18 +108,145 @@ static ConsS **rFlxiib=NULL, **rFlxoib=NULL;
 static Real ***geom_src=NULL;
 #endif
 
+/* Cache-blocked tiles: with <job>/tile_nx2 or tile_nx3 > 0, Steps 1-10a are
+ * executed one tile of TileNx2*TileNx3 pencils at a time.  The face states,
+ * emf_cc and eta are then only stored for one tile plus nghost halo cells, in
+ * a slab addressed through a view of row pointers indexed with the usual
+ * [k][j][i] Grid indices.  The views are re-pointed at the slab for each tile.
+ * The fluxes, emfs, dhalf and phalf are computed in tile views (TileArr.view)
+ * and saved into the Grid-size arrays (TileArr.full) at the end of each tile */
+
+/* Overlap of halo exchange with computation: with <job>/overlap_halo=1 the
+ * main loop only starts the exchange of ghost zones with bvals_mhd_start().
+ * Steps 1-10a are then first executed for the interior box of cells at least
+ * nghost from the Grid edges, which needs no ghost zones, and the exchange is
+ * completed with bvals_mhd_finish() before the boundary shells are done.
+ * Boxes are executed with the tile machinery, intersected with the tiles. */
+#define MAX_BOXES 7
+static int OverlapHalo=0;
+
+typedef struct TileArr_s{
+  void ***view;    /* [Nx3+2*nghost][Nx2+2*nghost] pointers to rows of slab */
+  void ***slab;    /* storage for one tile plus halo */
+  void ****pArr;   /* address of pointer used in integrator, if saved */
+  void ***full;    /* Grid-size array into which tile is saved, or NULL */
+  size_t size;     /* size of one element */
+}TileArrS;
+
+#define MAX_TILE_ARR 32
+static int TileNx2=0, TileNx3=0, NTileArr=0, Tiled=0;
+static int TileSize[3], ViewSize[2];
+static TileArrS TileArr[MAX_TILE_ARR];
+static Cons1DS ***x1FluxT=NULL, ***x2FluxT=NULL, ***x3FluxT=NULL;
+static Real ***dhalfT=NULL, ***phalfT=NULL;
+#ifdef MHD
+static Real ***emf1T=NULL, ***emf2T=NULL, ***emf3T=NULL;
+#endif /* MHD */
+
+/* With OpenMP the pencil loops in integrate_3d_ctu() are divided over the
+ * outer (k or j) index.  The temporaries below are declared at function scope
+ * and so must be private to each thread; those which carry an initial value
+ * into the loops (Bx for hydro, and the geometric factors which are only
+ * reset in cylindrical coordinates) must be firstprivate. */
+#ifndef BAROTROPIC
+#define CTU_OMP_ADB ,coolfl,coolfr,coolf,Eh
+#else
+#define CTU_OMP_ADB
+#endif
+#ifdef MHD
+#define CTU_OMP_MHD ,MHD_src_By,MHD_src_Bz,mdb1,mdb2,mdb3,db1,db2,db3,\
+  l1,l2,l3,B1,B2,B3,V1,V2,V3,B1ch,B2ch,B3ch
+#else
+#define CTU_OMP_MHD
+#endif
+#ifdef H_CORRECTION
+#define CTU_OMP_HCORR ,cfr,cfl,lambdar,lambdal
+#else
+#define CTU_OMP_HCORR
+#endif
+#if (NSCALARS > 0)
+#define CTU_OMP_SCAL ,n
+#else
+#define CTU_OMP_SCAL
+#endif
+#ifdef SELF_GRAVITY
+#define CTU_OMP_SELFG ,gxl,gxr,gyl,gyr,gzl,gzr,\
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r
+#else
+#define CTU_OMP_SELFG
+#endif
+#ifdef SHEARING_BOX
+#define CTU_OMP_SHBOX ,M1n,dM2n,M1e,dM2e,\
+  flx1_dM2,frx1_dM2,flx2_dM2,frx2_dM2,flx3_dM2,frx3_dM2,fact,qom
+#else
+#define CTU_OMP_SHBOX
+#endif
+#ifdef PARTICLES
+#define CTU_OMP_PART ,d1
+#else
+#define CTU_OMP_PART
+#endif
+#ifdef CYLINDRICAL
+#if defined(FARGO)
+#define CTU_OMP_FARGO ,Om,qshear,Mrn,Mpn,Mre,Mpe,Mrav,Mpav
+#else
+#define CTU_OMP_FARGO
+#endif
+#ifndef ISOTHERMAL
+#define CTU_OMP_CYL ,rinv,geom_src_d,geom_src_Vx,geom_src_Vy,geom_src_P,\
+  geom_src_By,geom_src_Bz,Pavgh CTU_OMP_FARGO
+#else
+#define CTU_OMP_CYL ,rinv,geom_src_d,geom_src_Vx,geom_src_Vy,geom_src_P,\
+  geom_src_By,geom_src_Bz CTU_OMP_FARGO
+#endif
+#else
+#define CTU_OMP_CYL
+#endif
+
+#define CTU_OMP_PRIVATE private(i,j,k,x1,x2,x3,phicl,phicr,phifc,phil,phir,\
+  phic,M1h,M2h,M3h,g,gl,gr CTU_OMP_ADB CTU_OMP_MHD CTU_OMP_HCORR CTU_OMP_SCAL \
+  CTU_OMP_SELFG CTU_OMP_SHBOX CTU_OMP_PART CTU_OMP_CYL) \
+  firstprivate(Bx,lsf,rsf,dx2,dx2i,q2,dtodx2)
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
  *   integrate_emf1_corner() - the upwind CT method in GS05, for emf1
  *   integrate_emf2_corner() - the upwind CT method in GS05, for emf2
  *   integrate_emf3_corner() - the upwind CT method in GS05, for emf3
+ *   scratch_3d_array() - allocate Grid-size or tiled scratch array
+ *   free_scratch_3d()  - free array allocated by scratch_3d_array()
+ *   tile_link()   - register Grid-size array into which a tile view is saved
+ *   tile_map()    - point all tile views at the slabs for one tile
+ *   tile_swap()   - swap the saved arrays between their tile views and Grid
+ *   tile_save()   - copy the tile results into Grid-size arrays
+ *   overlap_boxes() - interior box and boundary shells of a Grid
+ *   fluxes_from_cons() - fluxes along a row from L/R conserved variables
+ *   fluxes_from_prim() - fluxes along a row from L/R primitive variables
  *============================================================================*/
 
 #ifdef MHD
-static void integrate_emf1_corner(const GridS *pG);
-static void integrate_emf2_corner(const GridS *pG);
-static void integrate_emf3_corner(const GridS *pG);
+static void integrate_emf1_corner(const GridS *pG, int is, int ie,
+                                  int js, int je, int ks, int ke);
+static void integrate_emf2_corner(const GridS *pG, int is, int ie,
+                                  int js, int je, int ks, int ke);
+static void integrate_emf3_corner(const GridS *pG, int is, int ie,
+                                  int js, int je, int ks, int ke);
 #endif /* MHD */
+static void ***scratch_3d_array(size_t nt, size_t nr, size_t nc, size_t size);
+static void free_scratch_3d(void *array);
+static void tile_link(void *pArr, void *view);
+static void tile_map(const int j0, const int k0);
+static void tile_swap(const int to_view);
+static void tile_save(const GridS *pG, int is, int ie, int js, int je,
+                      int ks, int ke);
+static int overlap_boxes(const GridS *pG, int box[][6]);
+#ifdef FLUXES_PENCIL
+static void fluxes_from_cons(const int il, const int iu,
+  const Cons1DS *Ul, const Cons1DS *Ur, const Real *Bx, Cons1DS *Flux);
+static void fluxes_from_prim(const int il, const int iu,
+  const Prim1DS *Wl, const Prim1DS *Wr, const Real *Bx,
+  Cons1DS *Ul, Cons1DS *Ur, Cons1DS *Flux);
+#endif /* FLUXES_PENCIL */
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -116,6 +262,7 @@ void integrate_3d_ctu(DomainS *pD)
   int i,il,iu, is = pG->is, ie = pG->ie;
   int j,jl,ju, js = pG->js, je = pG->je;
   int k,kl,ku, ks = pG->ks, ke = pG->ke;
+  int jt,kt,ntj,ntk,nb,nbox,box[MAX_BOXES][6];
   Real x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,M1h,M2h,M3h,Bx=0.0;
 #ifndef BAROTROPIC
   Real coolfl,coolfr,coolf,Eh=0.0;
@@ -196,15 +343,55 @@ void integrate_3d_ctu(DomainS *pD)
   ku = ke + 2;
 #endif
 
-/* Set etah=0 so first calls to flux functions do not use H-correction */
-  etah = 0.0;
-
 /* Compute predictor feedback from particle drag */
 #ifdef FEEDBACK
   feedback_predictor(pD);
   exchange_gpcouple(pD,1);
 #endif
 
+/*--- Loop over boxes and tiles -----------------------------------------------
+ * Steps 1-10a are executed for each tile in turn, with is,ie,js,je,ks,ke set
+ * to the bounds of the tile.  Without tiles the loop is executed once for the
+ * Grid.  When overlapping the halo exchange, each box from overlap_boxes() is
+ * intersected with the tiles, and the exchange is completed after box 0.
+ */
+
+  ntj = (TileNx2 > 0) ? TileNx2 : pG->Nx[1];
+  ntk = (TileNx3 > 0) ? TileNx3 : pG->Nx[2];
+  if (NTileArr > 0) tile_swap(1);
+
+  if (OverlapHalo) {
+    nbox = overlap_boxes(pG,box);
+  } else {
+    nbox = 1;
+    box[0][0] = pG->is;  box[0][1] = pG->ie;
+    box[0][2] = pG->js;  box[0][3] = pG->je;
+    box[0][4] = pG->ks;  box[0][5] = pG->ke;
+  }
+
+  for (nb=0; nb<nbox; nb++) {
+  if (OverlapHalo && nb == 1) bvals_mhd_finish(pD);
+  for (kt=pG->ks; kt<=pG->ke; kt+=ntk) {
+  for (jt=pG->js; jt<=pG->je; jt+=ntj) {
+  is = box[nb][0];  ie = box[nb][1];
+  js = MAX(jt, box[nb][2]);  je = MIN(MIN(jt+ntj-1, pG->je), box[nb][3]);
+  ks = MAX(kt, box[nb][4]);  ke = MIN(MIN(kt+ntk-1, pG->ke), box[nb][5]);
+  if (is > ie || js > je || ks > ke) continue;
+#ifndef PARTICLES
+  il = is - 2;
+  iu = ie + 2;
+  jl = js - 2;
+  ju = je + 2;
+  kl = ks - 2;
+  ku = ke + 2;
+#endif
+  if (NTileArr > 0) tile_map(jt-nghost, kt-nghost);
+
+/* Set etah=0 so first calls to flux functions do not use H-correction.
+ * etah is threadprivate, so it is reset on every thread of the team. */
+#pragma omp parallel
+  etah = 0.0;
+
 /*=== STEP 1: Compute L/R x1-interface states and 1D x1-Fluxes ===============*/
 
 /*--- Step 1a ------------------------------------------------------------------
@@ -212,25 +399,26 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        U1d[i].d  = pG->U[k][j][i].d;
-        U1d[i].Mx = pG->U[k][j][i].M1;
-        U1d[i].My = pG->U[k][j][i].M2;
-        U1d[i].Mz = pG->U[k][j][i].M3;
+        U1d[i].d  = UVAR(pG,k,j,i,d);
+        U1d[i].Mx = UVAR(pG,k,j,i,M1);
+        U1d[i].My = UVAR(pG,k,j,i,M2);
+        U1d[i].Mz = UVAR(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        U1d[i].E  = pG->U[k][j][i].E;
+        U1d[i].E  = UVAR(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        U1d[i].By = pG->U[k][j][i].B2c;
-        U1d[i].Bz = pG->U[k][j][i].B3c;
-        Bxc[i] = pG->U[k][j][i].B1c;
+        U1d[i].By = UVAR(pG,k,j,i,B2c);
+        U1d[i].Bz = UVAR(pG,k,j,i,B3c);
+        Bxc[i] = UVAR(pG,k,j,i,B1c);
         Bxi[i] = pG->B1i[k][j][i];
         B1_x1Face[k][j][i] = pG->B1i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = UVAR(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -296,8 +484,8 @@ void integrate_3d_ctu(DomainS *pD)
 	  l2 = l2 < 0.0 ? l2 : 0.0;
 	}
 
-        MHD_src_By = (pG->U[k][j][i-1].M2/pG->U[k][j][i-1].d)*l2;
-        MHD_src_Bz = (pG->U[k][j][i-1].M3/pG->U[k][j][i-1].d)*l3;
+        MHD_src_By = (UVAR(pG,k,j,i-1,M2)/UVAR(pG,k,j,i-1,d))*l2;
+        MHD_src_Bz = (UVAR(pG,k,j,i-1,M3)/UVAR(pG,k,j,i-1,d))*l3;
 
         Wl[i].By += hdt*MHD_src_By;
         Wl[i].Bz += hdt*MHD_src_Bz;
@@ -326,8 +514,8 @@ void integrate_3d_ctu(DomainS *pD)
           l2 = l2 < 0.0 ? l2 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j][i].M2/pG->U[k][j][i].d)*l2;
-        MHD_src_Bz = (pG->U[k][j][i].M3/pG->U[k][j][i].d)*l3;
+        MHD_src_By = (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d))*l2;
+        MHD_src_Bz = (UVAR(pG,k,j,i,M3)/UVAR(pG,k,j,i,d))*l3;
 
         Wr[i].By += hdt*MHD_src_By;
         Wr[i].Bz += hdt*MHD_src_Bz;
@@ -545,6 +733,10 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 1D fluxes in x1-direction, storing into 3D array
  */
 
+#ifdef FLUXES_PENCIL
+      fluxes_from_prim(il+1,iu,Wl,Wr,Bxi,Ul_x1Face[k][j],Ur_x1Face[k][j],
+        x1Flux[k][j]);
+#else
       for (i=il+1; i<=iu; i++) {
         Ul_x1Face[k][j][i] = Prim1D_to_Cons1D(&Wl[i],&Bxi[i]);
         Ur_x1Face[k][j][i] = Prim1D_to_Cons1D(&Wr[i],&Bxi[i]);
@@ -555,6 +747,7 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x1Face[k][j][i],Ur_x1Face[k][j][i],Wl[i],Wr[i],Bx,
           &x1Flux[k][j][i]);
       }
+#endif /* FLUXES_PENCIL */
     }
   }
 
@@ -565,6 +758,7 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (i=il; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -573,22 +767,22 @@ void integrate_3d_ctu(DomainS *pD)
       dtodx2 = pG->dt/dx2;
 #endif
       for (j=js-nghost; j<=je+nghost; j++) {
-        U1d[j].d  = pG->U[k][j][i].d;
-        U1d[j].Mx = pG->U[k][j][i].M2;
-        U1d[j].My = pG->U[k][j][i].M3;
-        U1d[j].Mz = pG->U[k][j][i].M1;
+        U1d[j].d  = UVAR(pG,k,j,i,d);
+        U1d[j].Mx = UVAR(pG,k,j,i,M2);
+        U1d[j].My = UVAR(pG,k,j,i,M3);
+        U1d[j].Mz = UVAR(pG,k,j,i,M1);
 #ifndef BAROTROPIC
-        U1d[j].E  = pG->U[k][j][i].E;
+        U1d[j].E  = UVAR(pG,k,j,i,E);
 #endif
 #ifdef MHD
-        U1d[j].By = pG->U[k][j][i].B3c;
-        U1d[j].Bz = pG->U[k][j][i].B1c;
-        Bxc[j] = pG->U[k][j][i].B2c;
+        U1d[j].By = UVAR(pG,k,j,i,B3c);
+        U1d[j].Bz = UVAR(pG,k,j,i,B1c);
+        Bxc[j] = UVAR(pG,k,j,i,B2c);
         Bxi[j] = pG->B2i[k][j][i];
         B2_x2Face[k][j][i] = pG->B2i[k][j][i];
 #endif
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = UVAR(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -637,8 +831,8 @@ void integrate_3d_ctu(DomainS *pD)
           l3 = l3 < 0.0 ? l3 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j-1][i].M3/pG->U[k][j-1][i].d)*l3;
-        MHD_src_Bz = (pG->U[k][j-1][i].M1/pG->U[k][j-1][i].d)*l1;
+        MHD_src_By = (UVAR(pG,k,j-1,i,M3)/UVAR(pG,k,j-1,i,d))*l3;
+        MHD_src_Bz = (UVAR(pG,k,j-1,i,M1)/UVAR(pG,k,j-1,i,d))*l1;
 
         Wl[j].By += hdt*MHD_src_By;
         Wl[j].Bz += hdt*MHD_src_Bz;
@@ -663,8 +857,8 @@ void integrate_3d_ctu(DomainS *pD)
           l3 = l3 < 0.0 ? l3 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j][i].M3/pG->U[k][j][i].d)*l3;
-        MHD_src_Bz = (pG->U[k][j][i].M1/pG->U[k][j][i].d)*l1;
+        MHD_src_By = (UVAR(pG,k,j,i,M3)/UVAR(pG,k,j,i,d))*l3;
+        MHD_src_Bz = (UVAR(pG,k,j,i,M1)/UVAR(pG,k,j,i,d))*l1;
 
         Wr[j].By += hdt*MHD_src_By;
         Wr[j].Bz += hdt*MHD_src_Bz;
@@ -768,25 +962,26 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
-        U1d[k].d  = pG->U[k][j][i].d;
-        U1d[k].Mx = pG->U[k][j][i].M3;
-        U1d[k].My = pG->U[k][j][i].M1;
-        U1d[k].Mz = pG->U[k][j][i].M2;
+        U1d[k].d  = UVAR(pG,k,j,i,d);
+        U1d[k].Mx = UVAR(pG,k,j,i,M3);
+        U1d[k].My = UVAR(pG,k,j,i,M1);
+        U1d[k].Mz = UVAR(pG,k,j,i,M2);
 #ifndef BAROTROPIC
-        U1d[k].E  = pG->U[k][j][i].E;
+        U1d[k].E  = UVAR(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        U1d[k].By = pG->U[k][j][i].B1c;
-        U1d[k].Bz = pG->U[k][j][i].B2c;
-        Bxc[k] = pG->U[k][j][i].B3c;
+        U1d[k].By = UVAR(pG,k,j,i,B1c);
+        U1d[k].Bz = UVAR(pG,k,j,i,B2c);
+        Bxc[k] = UVAR(pG,k,j,i,B3c);
         Bxi[k] = pG->B3i[k][j][i];
         B3_x3Face[k][j][i] = pG->B3i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = UVAR(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -836,8 +1031,8 @@ void integrate_3d_ctu(DomainS *pD)
           l2 = l2 < 0.0 ? l2 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k-1][j][i].M1/pG->U[k-1][j][i].d)*l1;
-        MHD_src_Bz = (pG->U[k-1][j][i].M2/pG->U[k-1][j][i].d)*l2;
+        MHD_src_By = (UVAR(pG,k-1,j,i,M1)/UVAR(pG,k-1,j,i,d))*l1;
+        MHD_src_Bz = (UVAR(pG,k-1,j,i,M2)/UVAR(pG,k-1,j,i,d))*l2;
 
         Wl[k].By += hdt*MHD_src_By;
         Wl[k].Bz += hdt*MHD_src_Bz;
@@ -862,8 +1057,8 @@ void integrate_3d_ctu(DomainS *pD)
           l2 = l2 < 0.0 ? l2 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j][i].M1/pG->U[k][j][i].d)*l1;
-        MHD_src_Bz = (pG->U[k][j][i].M2/pG->U[k][j][i].d)*l2;
+        MHD_src_By = (UVAR(pG,k,j,i,M1)/UVAR(pG,k,j,i,d))*l1;
+        MHD_src_Bz = (UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d))*l2;
 
         Wr[k].By += hdt*MHD_src_By;
         Wr[k].Bz += hdt*MHD_src_Bz;
@@ -963,29 +1158,31 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef MHD
 /* emf1 */
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        emf1_cc[k][j][i] = (pG->U[k][j][i].B2c*pG->U[k][j][i].M3 -
-                            pG->U[k][j][i].B3c*pG->U[k][j][i].M2)
-                              /pG->U[k][j][i].d;
-        emf2_cc[k][j][i] = (pG->U[k][j][i].B3c*pG->U[k][j][i].M1 -
-                            pG->U[k][j][i].B1c*pG->U[k][j][i].M3)
-                              /pG->U[k][j][i].d;
-        emf3_cc[k][j][i] = (pG->U[k][j][i].B1c*pG->U[k][j][i].M2 -
-                            pG->U[k][j][i].B2c*pG->U[k][j][i].M1)
-                              /pG->U[k][j][i].d;
+        emf1_cc[k][j][i] = (UVAR(pG,k,j,i,B2c)*UVAR(pG,k,j,i,M3) -
+                            UVAR(pG,k,j,i,B3c)*UVAR(pG,k,j,i,M2))
+                              /UVAR(pG,k,j,i,d);
+        emf2_cc[k][j][i] = (UVAR(pG,k,j,i,B3c)*UVAR(pG,k,j,i,M1) -
+                            UVAR(pG,k,j,i,B1c)*UVAR(pG,k,j,i,M3))
+                              /UVAR(pG,k,j,i,d);
+        emf3_cc[k][j][i] = (UVAR(pG,k,j,i,B1c)*UVAR(pG,k,j,i,M2) -
+                            UVAR(pG,k,j,i,B2c)*UVAR(pG,k,j,i,M1))
+                              /UVAR(pG,k,j,i,d);
       }
     }
   }
-  integrate_emf1_corner(pG);
-  integrate_emf2_corner(pG);
-  integrate_emf3_corner(pG);
+  integrate_emf1_corner(pG,is,ie,js,je,ks,ke);
+  integrate_emf2_corner(pG,is,ie,js,je,ks,ke);
+  integrate_emf3_corner(pG,is,ie,js,je,ks,ke);
 
 /*--- Step 4b ------------------------------------------------------------------
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1033,6 +1230,7 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x2-sweep, (x,y,z) on RHS -> (z,x,y) on LHS 
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1132,6 +1330,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1142,11 +1341,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i  ] - lsf*pG->B1i[k][j][i-1])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i-1] -     pG->B2i[k][j][i-1])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i-1] -     pG->B3i[k][j][i-1])*dx3i;
-        B1 = pG->U[k][j][i-1].B1c;
-        B2 = pG->U[k][j][i-1].B2c;
-        B3 = pG->U[k][j][i-1].B3c;
-        V2 = pG->U[k][j][i-1].M2/pG->U[k][j][i-1].d;
-        V3 = pG->U[k][j][i-1].M3/pG->U[k][j][i-1].d;
+        B1 = UVAR(pG,k,j,i-1,B1c);
+        B2 = UVAR(pG,k,j,i-1,B2c);
+        B3 = UVAR(pG,k,j,i-1,B3c);
+        V2 = UVAR(pG,k,j,i-1,M2)/UVAR(pG,k,j,i-1,d);
+        V3 = UVAR(pG,k,j,i-1,M3)/UVAR(pG,k,j,i-1,d);
 
         /* Calculate mdb2 = min_mod(-db1,db2) */
         if(db1 > 0.0 && db2 < 0.0){
@@ -1182,11 +1381,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i+1] - lsf*pG->B1i[k][j][i])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i  ] -     pG->B2i[k][j][i])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i  ] -     pG->B3i[k][j][i])*dx3i;
-        B1 = pG->U[k][j][i].B1c;
-        B2 = pG->U[k][j][i].B2c;
-        B3 = pG->U[k][j][i].B3c;
-        V2 = pG->U[k][j][i].M2/pG->U[k][j][i].d;
-        V3 = pG->U[k][j][i].M3/pG->U[k][j][i].d;
+        B1 = UVAR(pG,k,j,i,B1c);
+        B2 = UVAR(pG,k,j,i,B2c);
+        B3 = UVAR(pG,k,j,i,B3c);
+        V2 = UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d);
+        V3 = UVAR(pG,k,j,i,M3)/UVAR(pG,k,j,i,d);
 
         /* Calculate mdb2 = min_mod(-db1,db2) */
         if(db1 > 0.0 && db2 < 0.0){
@@ -1227,6 +1426,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1239,9 +1439,9 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         q2 = hdt/(r[i]*pG->dx2);
 #endif
-        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
-        Ur_x1Face[k][j][i].My -= (pG->dt)*Omega_0*pG->U[k][j][i].M1;
+        Ur_x1Face[k][j][i].My -= (pG->dt)*Omega_0*UVAR(pG,k,j,i,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i  ].d*(phic - phil)
@@ -1251,7 +1451,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i  ].d*(phic - phil)
                                   + x3Flux[k+1][j][i  ].d*(phir - phic));
@@ -1265,9 +1465,9 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         q2 = hdt/(r[i-1]*pG->dx2);
 #endif
-        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*UVAR(pG,k,j,i-1,d);
 #ifdef ROTATING_FRAME
-        Ul_x1Face[k][j][i].My -= (pG->dt)*Omega_0*pG->U[k][j][i-1].M1;
+        Ul_x1Face[k][j][i].My -= (pG->dt)*Omega_0*UVAR(pG,k,j,i-1,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i-1].d*(phic - phil)
@@ -1277,7 +1477,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)((x1-pG->dx1),x2,(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)((x1-pG->dx1),x2,(x3-0.5*pG->dx3));
 
-        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*UVAR(pG,k,j,i-1,d);
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i-1].d*(phic - phil)
                                   + x3Flux[k+1][j][i-1].d*(phir - phic));
@@ -1292,6 +1492,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1300,7 +1501,7 @@ void integrate_3d_ctu(DomainS *pD)
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
 
         /* correct right states; x2 and x3 gradients */
-        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i  ].d*(phic - phil)
                                   + x2Flux[k][j+1][i  ].d*(phir - phic));
@@ -1309,7 +1510,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
 
-        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i  ].d*(phic - phil)
                                   + x3Flux[k+1][j][i  ].d*(phir - phic));
@@ -1320,7 +1521,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k][j+1][i-1]);
         phil = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k][j-1][i-1]);
 
-        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*UVAR(pG,k,j,i-1,d);
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i-1].d*(phic - phil)
                                   + x2Flux[k][j+1][i-1].d*(phir - phic));
@@ -1329,7 +1530,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k+1][j][i-1]);
         phil = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k-1][j][i-1]);
 
-        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*UVAR(pG,k,j,i-1,d);
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i-1].d*(phic - phil)
                                   + x3Flux[k+1][j][i-1].d*(phir - phic));
@@ -1347,6 +1548,7 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (y,z,x) on LHS
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1439,6 +1641,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1449,11 +1652,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j-1][i+1] - lsf*pG->B1i[k][j-1][i])*dx1i;
         db2 = (    pG->B2i[k  ][j  ][i  ] -     pG->B2i[k][j-1][i])*dx2i;
         db3 = (    pG->B3i[k+1][j-1][i  ] -     pG->B3i[k][j-1][i])*dx3i;
-        B1 = pG->U[k][j-1][i].B1c;
-        B2 = pG->U[k][j-1][i].B2c;
-        B3 = pG->U[k][j-1][i].B3c;
-        V1 = pG->U[k][j-1][i].M1/pG->U[k][j-1][i].d;
-        V3 = pG->U[k][j-1][i].M3/pG->U[k][j-1][i].d;
+        B1 = UVAR(pG,k,j-1,i,B1c);
+        B2 = UVAR(pG,k,j-1,i,B2c);
+        B3 = UVAR(pG,k,j-1,i,B3c);
+        V1 = UVAR(pG,k,j-1,i,M1)/UVAR(pG,k,j-1,i,d);
+        V3 = UVAR(pG,k,j-1,i,M3)/UVAR(pG,k,j-1,i,d);
 
         /* Calculate mdb1 = min_mod(-db2,db1) */
         if(db2 > 0.0 && db1 < 0.0){
@@ -1485,11 +1688,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i+1] - lsf*pG->B1i[k][j][i])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i  ] -     pG->B2i[k][j][i])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i  ] -     pG->B3i[k][j][i])*dx3i;
-        B1 = pG->U[k][j][i].B1c;
-        B2 = pG->U[k][j][i].B2c;
-        B3 = pG->U[k][j][i].B3c;
-        V1 = pG->U[k][j][i].M1/pG->U[k][j][i].d;
-        V3 = pG->U[k][j][i].M3/pG->U[k][j][i].d;
+        B1 = UVAR(pG,k,j,i,B1c);
+        B2 = UVAR(pG,k,j,i,B2c);
+        B3 = UVAR(pG,k,j,i,B3c);
+        V1 = UVAR(pG,k,j,i,M1)/UVAR(pG,k,j,i,d);
+        V3 = UVAR(pG,k,j,i,M3)/UVAR(pG,k,j,i,d);
 
         /* Calculate mdb1 = min_mod(-db2,db1) */
         if(db2 > 0.0 && db1 < 0.0){
@@ -1530,6 +1733,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1547,12 +1751,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ur_x2Face[k][j][i].Mz -= hdt*pG->U[k][j][i].d*g;
+        Ur_x2Face[k][j][i].Mz -= hdt*UVAR(pG,k,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j][i].M2;
+        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,k,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j][i].d*Om*x1vc(pG,i);
+        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,k,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -1567,7 +1771,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j  ][i].d*(phic - phil)
                                   + x3Flux[k+1][j  ][i].d*(phir - phic));
@@ -1582,12 +1786,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ul_x2Face[k][j][i].Mz -= hdt*pG->U[k][j-1][i].d*g;
+        Ul_x2Face[k][j][i].Mz -= hdt*UVAR(pG,k,j-1,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j-1][i].M2;
+        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,k,j-1,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j-1][i].d*Om*x1vc(pG,i);
+        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*UVAR(pG,k,j-1,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -1602,7 +1806,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2-pG->dx2),(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)(x1,(x2-pG->dx2),(x3-0.5*pG->dx3));
 
-        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*UVAR(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j-1][i].d*(phic - phil)
                                   + x3Flux[k+1][j-1][i].d*(phir - phic));
@@ -1617,6 +1821,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1625,7 +1830,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
 
-        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                                   + x1Flux[k][j][i+1].d*(phir - phic));
@@ -1634,7 +1839,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
 
-        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                                   + x3Flux[k+1][j][i].d*(phir - phic));
@@ -1645,7 +1850,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k][j-1][i+1]);
         phil = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k][j-1][i-1]);
 
-        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*UVAR(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q1*(x1Flux[k][j-1][i  ].d*(phic - phil)
                                   + x1Flux[k][j-1][i+1].d*(phir - phic));
@@ -1653,7 +1858,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k+1][j-1][i]);
         phil = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k-1][j-1][i]);
 
-        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*UVAR(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j-1][i].d*(phic - phil)
                                   + x3Flux[k+1][j-1][i].d*(phir - phic));
@@ -1683,7 +1888,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q1*(x1Flux[k][j  ][i  ].d*(phic - phil)
                                   + x1Flux[k][j  ][i+1].d*(phir - phic));
@@ -1692,7 +1897,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j  ][i].d*(phic - phil)
                                   + x3Flux[k+1][j  ][i].d*(phir - phic));
@@ -1703,7 +1908,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),(x2-pG->dx2),x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),(x2-pG->dx2),x3);
 
-        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*UVAR(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q1*(x1Flux[k][j-1][i  ].d*(phic - phil)
                                   + x1Flux[k][j-1][i+1].d*(phir - phic));
@@ -1711,7 +1916,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2-pG->dx2),(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,(x2-pG->dx2),(x3-0.5*pG->dx3));
 
-        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*UVAR(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j-1][i].d*(phic - phil)
                                   + x3Flux[k+1][j-1][i].d*(phir - phic));
@@ -1723,14 +1928,14 @@ void integrate_3d_ctu(DomainS *pD)
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x2Face[k][j][i].Mz += pG->dt*Omega_0*pG->U[k][j][i].M2;
-        Ul_x2Face[k][j][i].Mz += pG->dt*Omega_0*pG->U[k][j-1][i].M2;
+        Ur_x2Face[k][j][i].Mz += pG->dt*Omega_0*UVAR(pG,k,j,i,M2);
+        Ul_x2Face[k][j][i].Mz += pG->dt*Omega_0*UVAR(pG,k,j-1,i,M2);
 #ifdef FARGO
-        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
-        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[k][j-1][i].M1;
+        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*UVAR(pG,k,j,i,M1);
+        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*UVAR(pG,k,j-1,i,M1);
 #else
-        Ur_x2Face[k][j][i].Mx -= pG->dt*Omega_0*pG->U[k][j][i].M1;
-        Ul_x2Face[k][j][i].Mx -= pG->dt*Omega_0*pG->U[k][j-1][i].M1;
+        Ur_x2Face[k][j][i].Mx -= pG->dt*Omega_0*UVAR(pG,k,j,i,M1);
+        Ul_x2Face[k][j][i].Mx -= pG->dt*Omega_0*UVAR(pG,k,j-1,i,M1);
 #endif
       }
     }
@@ -1744,11 +1949,11 @@ void integrate_3d_ctu(DomainS *pD)
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
 
-        Ur_x2Face[k][j][i].Mz += pG->dt*Om*pG->U[k][j][i].M2;
-        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[k][j][i].M1;
+        Ur_x2Face[k][j][i].Mz += pG->dt*Om*UVAR(pG,k,j,i,M2);
+        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*UVAR(pG,k,j,i,M1);
 
-        Ul_x2Face[k][j][i].Mz += pG->dt*Om*pG->U[k][j-1][i].M2;
-        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[k][j-1][i].M1;
+        Ul_x2Face[k][j][i].Mz += pG->dt*Om*UVAR(pG,k,j-1,i,M2);
+        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*UVAR(pG,k,j-1,i,M1);
       }
     }
   }
@@ -1776,6 +1981,7 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (z,x,y) on LHS 
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1869,6 +2075,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1879,11 +2086,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k-1][j  ][i+1] - lsf*pG->B1i[k-1][j][i])*dx1i;
         db2 = (    pG->B2i[k-1][j+1][i  ] -     pG->B2i[k-1][j][i])*dx2i;
         db3 = (    pG->B3i[k  ][j  ][i  ] -     pG->B3i[k-1][j][i])*dx3i;
-        B1 = pG->U[k-1][j][i].B1c;
-        B2 = pG->U[k-1][j][i].B2c;
-        B3 = pG->U[k-1][j][i].B3c;
-        V1 = pG->U[k-1][j][i].M1/pG->U[k-1][j][i].d;
-        V2 = pG->U[k-1][j][i].M2/pG->U[k-1][j][i].d;
+        B1 = UVAR(pG,k-1,j,i,B1c);
+        B2 = UVAR(pG,k-1,j,i,B2c);
+        B3 = UVAR(pG,k-1,j,i,B3c);
+        V1 = UVAR(pG,k-1,j,i,M1)/UVAR(pG,k-1,j,i,d);
+        V2 = UVAR(pG,k-1,j,i,M2)/UVAR(pG,k-1,j,i,d);
 
         /* Calculate mdb1 = min_mod(-db3,db1) */
         if(db3 > 0.0 && db1 < 0.0){
@@ -1915,11 +2122,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i+1] - lsf*pG->B1i[k][j][i])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i  ] -     pG->B2i[k][j][i])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i  ] -     pG->B3i[k][j][i])*dx3i;
-        B1 = pG->U[k][j][i].B1c;
-        B2 = pG->U[k][j][i].B2c;
-        B3 = pG->U[k][j][i].B3c;
-        V1 = pG->U[k][j][i].M1/pG->U[k][j][i].d;
-        V2 = pG->U[k][j][i].M2/pG->U[k][j][i].d;
+        B1 = UVAR(pG,k,j,i,B1c);
+        B2 = UVAR(pG,k,j,i,B2c);
+        B3 = UVAR(pG,k,j,i,B3c);
+        V1 = UVAR(pG,k,j,i,M1)/UVAR(pG,k,j,i,d);
+        V2 = UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d);
 
         /* Calculate mdb1 = min_mod(-db3,db1) */
         if(db3 > 0.0 && db1 < 0.0){
@@ -1960,6 +2167,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1977,12 +2185,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ur_x3Face[k][j][i].My -= hdt*pG->U[k][j][i].d*g;
+        Ur_x3Face[k][j][i].My -= hdt*UVAR(pG,k,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k][j][i].M2;
+        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*UVAR(pG,k,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k][j][i].d*Om*x1vc(pG,i);
+        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*UVAR(pG,k,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -1997,9 +2205,9 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
-        Ur_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*pG->U[k][j][i].M1;
+        Ur_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*UVAR(pG,k,j,i,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q2*(x2Flux[k  ][j  ][i].d*(phic - phil)
@@ -2014,12 +2222,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ul_x3Face[k][j][i].My -= hdt*pG->U[k-1][j][i].d*g;
+        Ul_x3Face[k][j][i].My -= hdt*UVAR(pG,k-1,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k-1][j][i].M2;
+        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*UVAR(pG,k-1,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k-1][j][i].d*Om*x1vc(pG,i);
+        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*UVAR(pG,k-1,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -2034,9 +2242,9 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),(x3-pG->dx3));
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),(x3-pG->dx3));
 
-        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*UVAR(pG,k-1,j,i,d);
 #ifdef ROTATING_FRAME
-        Ul_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*pG->U[k-1][j][i].M1;
+        Ul_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*UVAR(pG,k-1,j,i,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q2*(x2Flux[k-1][j  ][i].d*(phic - phil)
@@ -2052,6 +2260,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2060,7 +2269,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
 
-        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                                   + x1Flux[k][j][i+1].d*(phir - phic));
@@ -2069,7 +2278,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j+1][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
 
-        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                                   + x2Flux[k][j+1][i].d*(phir - phic));
@@ -2080,7 +2289,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j][i+1]);
         phil = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j][i-1]);
 
-        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*UVAR(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q1*(x1Flux[k-1][j][i  ].d*(phic - phil)
                                   + x1Flux[k-1][j][i+1].d*(phir - phic));
@@ -2089,7 +2298,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j+1][i]);
         phil = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j-1][i]);
 
-        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*UVAR(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q2*(x2Flux[k-1][j  ][i].d*(phic - phil)
                                   + x2Flux[k-1][j+1][i].d*(phir - phic));
@@ -2118,7 +2327,7 @@ void integrate_3d_ctu(DomainS *pD)
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
         /* correct right states; x1 and x2 gradients */
-        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q1*(x1Flux[k  ][j][i  ].d*(phic - phil)
                                   + x1Flux[k  ][j][i+1].d*(phir - phic));
@@ -2127,7 +2336,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q2*(x2Flux[k  ][j  ][i].d*(phic - phil)
                                   + x2Flux[k  ][j+1][i].d*(phir - phic));
@@ -2138,7 +2347,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,(x3-pG->dx3));
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,(x3-pG->dx3));
 
-        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*UVAR(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q1*(x1Flux[k-1][j][i  ].d*(phic - phil)
                                   + x1Flux[k-1][j][i+1].d*(phir - phic));
@@ -2147,7 +2356,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),(x3-pG->dx3));
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),(x3-pG->dx3));
 
-        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*UVAR(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q2*(x2Flux[k-1][j  ][i].d*(phic - phil)
                                   + x2Flux[k-1][j+1][i].d*(phir - phic));
@@ -2159,14 +2368,14 @@ void integrate_3d_ctu(DomainS *pD)
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x3Face[k][j][i].My += pG->dt*Omega_0*pG->U[k][j][i].M2;
-        Ul_x3Face[k][j][i].My += pG->dt*Omega_0*pG->U[k-1][j][i].M2;
+        Ur_x3Face[k][j][i].My += pG->dt*Omega_0*UVAR(pG,k,j,i,M2);
+        Ul_x3Face[k][j][i].My += pG->dt*Omega_0*UVAR(pG,k-1,j,i,M2);
 #ifdef FARGO
-        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
-        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*pG->U[k-1][j][i].M1;
+        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*UVAR(pG,k,j,i,M1);
+        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*UVAR(pG,k-1,j,i,M1);
 #else
-        Ur_x3Face[k][j][i].Mz -= pG->dt*Omega_0*pG->U[k][j][i].M1;
-        Ul_x3Face[k][j][i].Mz -= pG->dt*Omega_0*pG->U[k-1][j][i].M1;
+        Ur_x3Face[k][j][i].Mz -= pG->dt*Omega_0*UVAR(pG,k,j,i,M1);
+        Ul_x3Face[k][j][i].Mz -= pG->dt*Omega_0*UVAR(pG,k-1,j,i,M1);
 #endif
       }
     }
@@ -2180,11 +2389,11 @@ void integrate_3d_ctu(DomainS *pD)
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
 
-        Ur_x3Face[k][j][i].My += pG->dt*Om*pG->U[k][j][i].M2;
-        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*pG->U[k][j][i].M1;
+        Ur_x3Face[k][j][i].My += pG->dt*Om*UVAR(pG,k,j,i,M2);
+        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*UVAR(pG,k,j,i,M1);
 
-        Ul_x3Face[k][j][i].My += pG->dt*Om*pG->U[k-1][j][i].M2;
-        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*pG->U[k-1][j][i].M1;
+        Ul_x3Face[k][j][i].My += pG->dt*Om*UVAR(pG,k-1,j,i,M2);
+        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*UVAR(pG,k-1,j,i,M1);
       }
     }
   }
@@ -2208,6 +2417,7 @@ void integrate_3d_ctu(DomainS *pD)
 /*--- Step 7e ------------------------------------------------------------------
  * Apply density floor
  */
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
   for (j=jl+1; j<=ju-1; j++) {
   for (i=il+1; i<=iu-1; i++) {
@@ -2248,6 +2458,7 @@ void integrate_3d_ctu(DomainS *pD)
 #endif
 #endif
   {
+#pragma omp parallel for CTU_OMP_PRIVATE
     for (k=kl+1; k<=ku-1; k++) {
       for (j=jl+1; j<=ju-1; j++) {
 	for (i=il+1; i<=iu-1; i++) {
@@ -2255,7 +2466,7 @@ void integrate_3d_ctu(DomainS *pD)
           rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
           q2 = hdt/(r[i]*pG->dx2);
 #endif
-          dhalf[k][j][i] = pG->U[k][j][i].d 
+          dhalf[k][j][i] = UVAR(pG,k,j,i,d) 
             - q1*(rsf*x1Flux[k  ][j  ][i+1].d - lsf*x1Flux[k][j][i].d)
             - q2*(    x2Flux[k  ][j+1][i  ].d -     x2Flux[k][j][i].d)
             - q3*(    x3Flux[k+1][j  ][i  ].d -     x3Flux[k][j][i].d);
@@ -2281,6 +2492,7 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* PARTICLES */
 #endif /* MHD */
   {
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2288,23 +2500,23 @@ void integrate_3d_ctu(DomainS *pD)
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
         q2 = hdt/(r[i]/pG->dx2);
 #endif
-        M1h = pG->U[k][j][i].M1
+        M1h = UVAR(pG,k,j,i,M1)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].Mx - lsf*x1Flux[k][j][i].Mx)
            - q2*(    x2Flux[k  ][j+1][i  ].Mz -     x2Flux[k][j][i].Mz)
            - q3*(    x3Flux[k+1][j  ][i  ].My -     x3Flux[k][j][i].My);
 
-        M2h = pG->U[k][j][i].M2
+        M2h = UVAR(pG,k,j,i,M2)
            - q1*(SQR(rsf)*x1Flux[k  ][j  ][i+1].My - SQR(lsf)*x1Flux[k][j][i].My)
            - q2*(         x2Flux[k  ][j+1][i  ].Mx -          x2Flux[k][j][i].Mx)
            - q3*(         x3Flux[k+1][j  ][i  ].Mz -          x3Flux[k][j][i].Mz);
 
-        M3h = pG->U[k][j][i].M3
+        M3h = UVAR(pG,k,j,i,M3)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].Mz - lsf*x1Flux[k][j][i].Mz)
            - q2*(    x2Flux[k  ][j+1][i  ].My -     x2Flux[k][j][i].My)
            - q3*(    x3Flux[k+1][j  ][i  ].Mx -     x3Flux[k][j][i].Mx);
 
 #ifndef BAROTROPIC
-        Eh = pG->U[k][j][i].E
+        Eh = UVAR(pG,k,j,i,E)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].E - lsf*x1Flux[k][j][i].E)
            - q2*(    x2Flux[k  ][j+1][i  ].E -     x2Flux[k][j][i].E)
            - q3*(    x3Flux[k+1][j  ][i  ].E -     x3Flux[k][j][i].E);
@@ -2320,40 +2532,40 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
-          M1h -= hdt*pG->U[k][j][i].d*g;
+          M1h -= hdt*UVAR(pG,k,j,i,d)*g;
 #ifdef ROTATING_FRAME
-          M1h += (pG->dt)*Omega_0*pG->U[k][j][i].M2;
+          M1h += (pG->dt)*Omega_0*UVAR(pG,k,j,i,M2);
         #ifdef FARGO
           Om = (*OrbitalProfile)(x1vc(pG,i));
-          M1h += (pG->dt)*Omega_0*pG->U[k][j][i].d*Om*x1vc(pG,i);
+          M1h += (pG->dt)*Omega_0*UVAR(pG,k,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif
 
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+          M2h -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
-          M2h -= (pG->dt)*Omega_0*pG->U[k][j][i].M1;
+          M2h -= (pG->dt)*Omega_0*UVAR(pG,k,j,i,M1);
 #endif
 
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
-          M3h -= q3*(phir-phil)*pG->U[k][j][i].d;
+          M3h -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
         }
 
         /* Add source terms due to self-gravity  */
 #ifdef SELF_GRAVITY
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
-        M1h -= q1*(phir-phil)*pG->U[k][j][i].d;
+        M1h -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j+1][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
-        M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+        M2h -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
-        M3h -= q3*(phir-phil)*pG->U[k][j][i].d;
+        M3h -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #endif /* SELF_GRAVITY */
 
         /* Add the tidal gravity and Coriolis terms for shearing box. */
@@ -2362,29 +2574,29 @@ void integrate_3d_ctu(DomainS *pD)
           cc_pos(pG,i,j,k,&x1,&x2,&x3);
           phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
-          M1h -= q1*(phir-phil)*pG->U[k][j][i].d;
+          M1h -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 
           phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
-          M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+          M2h -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 
           phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
-          M3h -= q3*(phir-phil)*pG->U[k][j][i].d;
+          M3h -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
         }
 
-        M1h += pG->dt*Omega_0*pG->U[k][j][i].M2;
+        M1h += pG->dt*Omega_0*UVAR(pG,k,j,i,M2);
 #ifdef FARGO
-        M2h += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
+        M2h += hdt*(qshear-2.)*Omega_0*UVAR(pG,k,j,i,M1);
 #else
-        M2h -= pG->dt*Omega_0*pG->U[k][j][i].M1;
+        M2h -= pG->dt*Omega_0*UVAR(pG,k,j,i,M1);
 #endif
 #endif /* SHEARING_BOX */
 #if defined(CYLINDRICAL) && defined(FARGO)
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
-        M1h += hdt*2.0*Om*pG->U[k][j][i].M2;
-        M2h += hdt*Om*(qshear-2.0)*pG->U[k][j][i].M1;
+        M1h += hdt*2.0*Om*UVAR(pG,k,j,i,M2);
+        M2h += hdt*Om*(qshear-2.0)*UVAR(pG,k,j,i,M1);
 #endif
 
         /* Add the particle feedback terms */
@@ -2451,6 +2663,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -2466,6 +2679,7 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2481,6 +2695,7 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2501,8 +2716,13 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x1-fluxes from corrected L/R states.
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
+#ifdef FLUXES_PENCIL
+      fluxes_from_cons(is,ie+1,Ul_x1Face[k][j],Ur_x1Face[k][j],
+        BX_ROW(B1_x1Face,k,j),x1Flux[k][j]);
+#else
       for (i=is; i<=ie+1; i++) {
 #ifdef H_CORRECTION
         etah = MAX(eta2[k][j][i-1],eta2[k][j][i]);
@@ -2525,6 +2745,7 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x1Face[k][j][i],Ur_x1Face[k][j][i],Wl[i],Wr[i],Bx,
                &x1Flux[k][j][i]);
       }
+#endif /* FLUXES_PENCIL */
     }
   }
 
@@ -2532,8 +2753,13 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x2-fluxes from corrected L/R states.
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
+#ifdef FLUXES_PENCIL
+      fluxes_from_cons(is-1,ie+1,Ul_x2Face[k][j],Ur_x2Face[k][j],
+        BX_ROW(B2_x2Face,k,j),x2Flux[k][j]);
+#else
       for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
         etah = MAX(eta1[k][j-1][i],eta1[k][j][i]);
@@ -2556,6 +2782,7 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x2Face[k][j][i],Ur_x2Face[k][j][i],Wl[i],Wr[i],Bx,
                &x2Flux[k][j][i]);
       }
+#endif /* FLUXES_PENCIL */
     }
   }
 
@@ -2563,8 +2790,13 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x3-fluxes from corrected L/R states.
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
+#ifdef FLUXES_PENCIL
+      fluxes_from_cons(is-1,ie+1,Ul_x3Face[k][j],Ur_x3Face[k][j],
+        BX_ROW(B3_x3Face,k,j),x3Flux[k][j]);
+#else
       for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
         etah = MAX(eta1[k-1][j][i],eta1[k][j][i]);
@@ -2587,6 +2819,7 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x3Face[k][j][i],Ur_x3Face[k][j][i],Wl[i],Wr[i],Bx,
                &x3Flux[k][j][i]);
       }
+#endif /* FLUXES_PENCIL */
     }
   }
 
@@ -2597,11 +2830,19 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
-  integrate_emf1_corner(pG);
-  integrate_emf2_corner(pG);
-  integrate_emf3_corner(pG);
+  integrate_emf1_corner(pG,is,ie,js,je,ks,ke);
+  integrate_emf2_corner(pG,is,ie,js,je,ks,ke);
+  integrate_emf3_corner(pG,is,ie,js,je,ks,ke);
 #endif
 
+  if (NTileArr > 0) tile_save(pG,is,ie,js,je,ks,ke);
+  }}} /* end loop over boxes and tiles */
+
+  if (NTileArr > 0) tile_swap(0);
+  is = pG->is;  ie = pG->ie;
+  js = pG->js;  je = pG->je;
+  ks = pG->ks;  ke = pG->ke;
+
 /* Remap Fluxes at is and ie+1 to conserve quantities in shearing box */
 
 #ifdef SHEARING_BOX
@@ -2688,6 +2929,7 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -2743,7 +2985,7 @@ void integrate_3d_ctu(DomainS *pD)
         q2 = hdt/(r[i]*pG->dx2);
 
         /* calculate d at time n+1/2 */
-        dhalf[k][j][i] = pG->U[k][j][i].d 
+        dhalf[k][j][i] = UVAR(pG,k,j,i,d) 
           - q1*(rsf*x1Flux[k  ][j  ][i+1].d - lsf*x1Flux[k][j][i].d)
           - q2*(    x2Flux[k  ][j+1][i  ].d -     x2Flux[k][j][i].d)
           - q3*(    x3Flux[k+1][j  ][i  ].d -     x3Flux[k][j][i].d);
@@ -2751,8 +2993,8 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef FARGO
         dtodx2 = pG->dt/(r[i]*pG->dx2);
         /* Save current R/phi momenta */
-        Mrn = pG->U[k][j][i].M1;
-        Mpn = pG->U[k][j][i].M2;
+        Mrn = UVAR(pG,k,j,i,M1);
+        Mpn = UVAR(pG,k,j,i,M2);
 
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
@@ -2774,17 +3016,17 @@ void integrate_3d_ctu(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
           g = (phir-phil)/pG->dx1;
-	  Mre -= pG->dt*pG->U[k][j][i].d*g;
+	  Mre -= pG->dt*UVAR(pG,k,j,i,d)*g;
 
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          Mpe -= dtodx2*(phir-phil)*pG->U[k][j][i].d;
+          Mpe -= dtodx2*(phir-phil)*UVAR(pG,k,j,i,d);
         }
 
-          Mre += pG->dt*pG->U[k][j][i].d*r[i]*SQR((*OrbitalProfile)(r[i]));
+          Mre += pG->dt*UVAR(pG,k,j,i,d)*r[i]*SQR((*OrbitalProfile)(r[i]));
 #ifdef ROTATING_FRAME
-          Mre += (pG->dt)*2.0*Omega_0*(pG->U[k][j][i].M2+pG->U[k][j][i].d*Om*x1vc(pG,i));
-          Mpe -= (pG->dt)*2.0*Omega_0*pG->U[k][j][i].M1;
+          Mre += (pG->dt)*2.0*Omega_0*(UVAR(pG,k,j,i,M2)+UVAR(pG,k,j,i,d)*Om*x1vc(pG,i));
+          Mpe -= (pG->dt)*2.0*Omega_0*UVAR(pG,k,j,i,M1);
 #endif
 
         /* Average forward euler and current values to approximate at t^{n+1/2} */
@@ -2796,12 +3038,12 @@ void integrate_3d_ctu(DomainS *pD)
 #else /* FARGO */
 
         /* calculate M1 and M2 at time n+1/2 */
-        M1h = pG->U[k][j][i].M1
+        M1h = UVAR(pG,k,j,i,M1)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].Mx - lsf*x1Flux[k][j][i].Mx)
            - q2*(    x2Flux[k  ][j+1][i  ].Mz -     x2Flux[k][j][i].Mz)
            - q3*(    x3Flux[k+1][j  ][i  ].My -     x3Flux[k][j][i].My);
         M1h += hdt*geom_src[k][j][i];
-        M2h = pG->U[k][j][i].M2
+        M2h = UVAR(pG,k,j,i,M2)
            - q1*(SQR(rsf)*x1Flux[k  ][j  ][i+1].My - SQR(lsf)*x1Flux[k][j][i].My)
            - q2*(         x2Flux[k  ][j+1][i  ].Mx -          x2Flux[k][j][i].Mx)
            - q3*(         x3Flux[k+1][j  ][i  ].Mz -          x3Flux[k][j][i].Mz);
@@ -2811,15 +3053,15 @@ void integrate_3d_ctu(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
           g = (phir-phil)/pG->dx1;
-          M1h -= hdt*pG->U[ks][j][i].d*g;
+          M1h -= hdt*UVAR(pG,ks,j,i,d)*g;
 
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+          M2h -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
         }
 #ifdef ROTATING_FRAME
-          M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
-          M2h -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+          M1h += (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M2);
+          M2h -= (pG->dt)*Omega_0*UVAR(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
 
         /* Compute geometric source term at time n+1/2 */
@@ -2845,18 +3087,18 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef FARGO
         /* Use average values to apply source terms for full time-step */
-        pG->U[k][j][i].M1 += pG->dt*( 2.0*Om*Mpav + geom_src[k][j][i]);
-        pG->U[k][j][i].M2 += pG->dt*( Om*(qshear-2.0)*Mrav);
+        UVAR(pG,k,j,i,M1) += pG->dt*( 2.0*Om*Mpav + geom_src[k][j][i]);
+        UVAR(pG,k,j,i,M2) += pG->dt*( Om*(qshear-2.0)*Mrav);
 #ifdef ROTATING_FRAME
-        pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
-        pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*Mrav;
+        UVAR(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
+        UVAR(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*Mrav;
 #endif
 #else /* FARGO */
         /* Add time-centered geometric source term for full dt */
-        pG->U[k][j][i].M1 += pG->dt*geom_src[k][j][i];
+        UVAR(pG,k,j,i,M1) += pG->dt*geom_src[k][j][i];
 #ifdef ROTATING_FRAME
-        pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*M2h;
-        pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*M1h;
+        UVAR(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*M2h;
+        UVAR(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*M1h;
 #endif /* ROTATING_FRAME */
 #endif /* FARGO */
       }
@@ -2882,11 +3124,11 @@ void integrate_3d_ctu(DomainS *pD)
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
 
         /* Store the current state */
-        M1n  = pG->U[k][j][i].M1;
+        M1n  = UVAR(pG,k,j,i,M1);
 #ifdef FARGO
-        dM2n = pG->U[k][j][i].M2;
+        dM2n = UVAR(pG,k,j,i,M2);
 #else
-        dM2n = pG->U[k][j][i].M2 + qom*x1*pG->U[k][j][i].d;
+        dM2n = UVAR(pG,k,j,i,M2) + qom*x1*UVAR(pG,k,j,i,d);
 #endif
 
         /* Calculate the flux for the y-momentum fluctuation */
@@ -2923,11 +3165,11 @@ void integrate_3d_ctu(DomainS *pD)
  * potential momentum source terms using a Crank-Nicholson
  * discretization for the momentum fluctuation equation. */
 
-        pG->U[k][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[k][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+        UVAR(pG,k,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        UVAR(pG,k,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 
 #ifndef FARGO
-        pG->U[k][j][i].M2 -= 0.5*qshear*om_dt*
+        UVAR(pG,k,j,i,M2) -= 0.5*qshear*om_dt*
             (x1Flux[k][j][i].d + x1Flux[k][j][i+1].d);
 #endif
 
@@ -2938,21 +3180,21 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif
 
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif
 
         phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif
       }
@@ -2977,28 +3219,28 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
-          pG->U[k][j][i].M1 -= pG->dt*dhalf[k][j][i]*g;
+          UVAR(pG,k,j,i,M1) -= pG->dt*dhalf[k][j][i]*g;
 #ifndef BAROTROPIC
 #ifdef CYLINDRICAL
-          pG->U[k][j][i].E -= hdt*g*(lsf*x1Flux[k][j][i  ].d +
+          UVAR(pG,k,j,i,E) -= hdt*g*(lsf*x1Flux[k][j][i  ].d +
                                      rsf*x1Flux[k][j][i+1].d);
 #else
-          pG->U[k][j][i].E -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil) +
+          UVAR(pG,k,j,i,E) -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil) +
                                       rsf*x1Flux[k][j][i+1].d*(phir - phic));
 #endif
 #endif
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          pG->U[k][j][i].M2 -= dtodx2*(phir-phil)*dhalf[k][j][i];
+          UVAR(pG,k,j,i,M2) -= dtodx2*(phir-phil)*dhalf[k][j][i];
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+          UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                       x2Flux[k][j+1][i].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
-          pG->U[k][j][i].M3 -= dtodx3*(phir-phil)*dhalf[k][j][i];
+          UVAR(pG,k,j,i,M3) -= dtodx3*(phir-phil)*dhalf[k][j][i];
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+          UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                       x3Flux[k+1][j][i].d*(phir - phic));
 #endif
         }
@@ -3047,11 +3289,11 @@ void integrate_3d_ctu(DomainS *pD)
         flx_m3r = gxr*gzr/four_pi_G;
 
         /* Update momenta and energy with d/dx1 terms  */
-        pG->U[k][j][i].M1 -= dtodx1*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx1*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx1*(flx_m3r - flx_m3l);
+        UVAR(pG,k,j,i,M1) -= dtodx1*(flx_m1r - flx_m1l);
+        UVAR(pG,k,j,i,M2) -= dtodx1*(flx_m2r - flx_m2l);
+        UVAR(pG,k,j,i,M3) -= dtodx1*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -3092,11 +3334,11 @@ void integrate_3d_ctu(DomainS *pD)
         flx_m3r = gyr*gzr/four_pi_G;
 
         /* Update momenta and energy with d/dx2 terms  */
-        pG->U[k][j][i].M1 -= dtodx2*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx2*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx2*(flx_m3r - flx_m3l);
+        UVAR(pG,k,j,i,M1) -= dtodx2*(flx_m1r - flx_m1l);
+        UVAR(pG,k,j,i,M2) -= dtodx2*(flx_m2r - flx_m2l);
+        UVAR(pG,k,j,i,M3) -= dtodx2*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -3137,11 +3379,11 @@ void integrate_3d_ctu(DomainS *pD)
         flx_m3r = 0.5*(gzr*gzr-gxr*gxr-gyr*gyr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx3 terms  */
-        pG->U[k][j][i].M1 -= dtodx3*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx3*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx3*(flx_m3r - flx_m3l);
+        UVAR(pG,k,j,i,M1) -= dtodx3*(flx_m1r - flx_m1l);
+        UVAR(pG,k,j,i,M2) -= dtodx3*(flx_m2r - flx_m2l);
+        UVAR(pG,k,j,i,M3) -= dtodx3*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -3171,7 +3413,7 @@ void integrate_3d_ctu(DomainS *pD)
       for (j=js; j<=je; j++){
         for (i=is; i<=ie; i++){
           coolf = (*CoolingFunc)(dhalf[k][j][i],phalf[k][j][i],pG->dt);
-          pG->U[k][j][i].E -= pG->dt*coolf;
+          UVAR(pG,k,j,i,E) -= pG->dt*coolf;
         }
       }
     }
@@ -3186,11 +3428,11 @@ void integrate_3d_ctu(DomainS *pD)
   for (k=ks; k<=ke; k++)
     for (j=js; j<=je; j++)
       for (i=is; i<=ie; i++) {
-      pG->U[k][j][i].M1 -= pG->Coup[k][j][i].fb1;
-      pG->U[k][j][i].M2 -= pG->Coup[k][j][i].fb2;
-      pG->U[k][j][i].M3 -= pG->Coup[k][j][i].fb3;
+      UVAR(pG,k,j,i,M1) -= pG->Coup[k][j][i].fb1;
+      UVAR(pG,k,j,i,M2) -= pG->Coup[k][j][i].fb2;
+      UVAR(pG,k,j,i,M3) -= pG->Coup[k][j][i].fb3;
 #ifndef BAROTROPIC
-      pG->U[k][j][i].E += pG->Coup[k][j][i].Eloss;
+      UVAR(pG,k,j,i,E) += pG->Coup[k][j][i].Eloss;
       pG->Coup[k][j][i].Eloss *= dt1; /* for history output purpose */
       pG->Eloss[k][j][i] *= dt1; /* for history output purpose */
 #endif
@@ -3203,22 +3445,23 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].d  -= dtodx1*(rsf*x1Flux[k][j][i+1].d -lsf*x1Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx-lsf*x1Flux[k][j][i].Mx);
-        pG->U[k][j][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My-SQR(lsf)*x1Flux[k][j][i].My);
-        pG->U[k][j][i].M3 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz-lsf*x1Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,d)  -= dtodx1*(rsf*x1Flux[k][j][i+1].d -lsf*x1Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx-lsf*x1Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My-SQR(lsf)*x1Flux[k][j][i].My);
+        UVAR(pG,k,j,i,M3) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz-lsf*x1Flux[k][j][i].Mz);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx1*(rsf*x1Flux[k][j][i+1].E -lsf*x1Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E)  -= dtodx1*(rsf*x1Flux[k][j][i+1].E -lsf*x1Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
                                        - lsf*x1Flux[k][j][i  ].s[n]);
 #endif
       }
@@ -3229,22 +3472,23 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-        pG->U[k][j][i].d  -= dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
-        pG->U[k][j][i].M2 -= dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
-        pG->U[k][j][i].M3 -= dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
+        UVAR(pG,k,j,i,d)  -= dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1) -= dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,M2) -= dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,M3) -= dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E) -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx2*(x2Flux[k][j+1][i].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx2*(x2Flux[k][j+1][i].s[n]
                                        - x2Flux[k][j  ][i].s[n]);
 #endif
       }
@@ -3255,19 +3499,20 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d  -= dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
-        pG->U[k][j][i].M2 -= dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
-        pG->U[k][j][i].M3 -= dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,d)  -= dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1) -= dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
+        UVAR(pG,k,j,i,M2) -= dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,M3) -= dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E)  -= dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx3*(x3Flux[k+1][j][i].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx3*(x3Flux[k+1][j][i].s[n]
                                        - x3Flux[k  ][j][i].s[n]);
 #endif
       }
@@ -3279,15 +3524,16 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for CTU_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-        pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+        UVAR(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+        UVAR(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+        UVAR(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
       }
     }
   }
@@ -3598,7 +3844,7 @@ void integrate_3d_ctu(DomainS *pD)
 */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -3622,6 +3868,45 @@ void integrate_init_3d(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
+/* Cache-blocked tiles.  Not available with particles or in cylindrical
+ * coordinates, since the face states are also needed after Step 10 */
+  TileNx2 = par_geti_def("job","tile_nx2",0);
+  TileNx3 = par_geti_def("job","tile_nx3",0);
+  if (TileNx2 < 0 || TileNx3 < 0)
+    ath_error("[integrate_init]: tile_nx2=%d and tile_nx3=%d must be >= 0\n",
+              TileNx2,TileNx3);
+
+/* Overlap of the halo exchange with Steps 1-10a.  Not available where ghost
+ * zones are needed between the end of one step and Step 1 of the next, or
+ * boundary values are set other than by bvals_mhd() */
+  OverlapHalo = par_geti_def("job","overlap_halo",0);
+#if defined(STATIC_MESH_REFINEMENT) || defined(SHEARING_BOX) || defined(FARGO)
+  if (OverlapHalo)
+    ath_error("[integrate_init]: overlap_halo cannot be used with SMR, the shearing box or FARGO\n");
+#endif
+#if defined(SELF_GRAVITY) || defined(OPERATOR_SPLIT_COOLING)
+  if (OverlapHalo)
+    ath_error("[integrate_init]: overlap_halo cannot be used with self-gravity or operator-split cooling\n");
+#endif
+#if defined(RESISTIVITY) || defined(VISCOSITY) || defined(THERMAL_CONDUCTION)
+  if (OverlapHalo)
+    ath_error("[integrate_init]: overlap_halo cannot be used with explicit diffusion\n");
+#endif
+
+  Tiled = (TileNx2 > 0 || TileNx3 > 0 || OverlapHalo);
+  if (Tiled) {
+#if defined(PARTICLES) || defined(CYLINDRICAL)
+    ath_error("[integrate_init]: tiles and overlap_halo cannot be used with particles or in cylindrical coordinates\n");
+#endif
+    TileSize[0] = size1;
+    TileSize[1] = size2;
+    TileSize[2] = size3;
+    if (TileNx2 > 0) TileSize[1] = MIN(TileNx2,size2-2*nghost) + 2*nghost;
+    if (TileNx3 > 0) TileSize[2] = MIN(TileNx3,size3-2*nghost) + 2*nghost;
+    ViewSize[0] = size2;
+    ViewSize[1] = size3;
+  }
+
 #ifdef MHD
   if ((emf1 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
@@ -3630,50 +3915,65 @@ void integrate_init_3d(MeshS *pM)
   if ((emf3 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
 
-  if ((emf1_cc=(Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((emf1_cc=(Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((emf2_cc=(Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((emf2_cc=(Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((emf3_cc=(Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((emf3_cc=(Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
 #endif /* MHD */
 #ifdef H_CORRECTION
-  if ((eta1 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((eta1 = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((eta2 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((eta2 = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((eta3 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((eta3 = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
 #endif /* H_CORRECTION */
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-
 #ifdef MHD
-  if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((B1_x1Face = (Real***)scratch_3d_array(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
-  if ((B2_x2Face = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((B2_x2Face = (Real***)scratch_3d_array(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
-  if ((B3_x3Face = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((B3_x3Face = (Real***)scratch_3d_array(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d=(Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W  =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* The 1D scratch vectors are threadprivate, so with OpenMP every thread in the
+ * team allocates its own copy */
+#pragma omp parallel reduction(+:nerr)
+  {
+    Bxc = (Real*)malloc(nmax*sizeof(Real));
+    Bxi = (Real*)malloc(nmax*sizeof(Real));
+    U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS));
+    W   = (Prim1DS*)malloc(nmax*sizeof(Prim1DS));
+    Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS));
+    Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS));
+    if (Bxc == NULL || Bxi == NULL || U1d == NULL || W == NULL ||
+        Wl == NULL || Wr == NULL) nerr++;
+#ifdef FLUXES_PENCIL
+    if (calloc_pencil(&UlPen,  sizeof(Cons1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&UrPen,  sizeof(Cons1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&FluxPen,sizeof(Cons1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&WlPen,  sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&WrPen,  sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL)
+      nerr++;
+#endif /* FLUXES_PENCIL */
+  }
+  if (nerr > 0) goto on_error;
 
-  if ((Ul_x1Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
+  if ((Ul_x1Face=(Cons1DS***)scratch_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((Ur_x1Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
+  if ((Ur_x1Face=(Cons1DS***)scratch_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((Ul_x2Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
+  if ((Ul_x2Face=(Cons1DS***)scratch_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((Ur_x2Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
+  if ((Ur_x2Face=(Cons1DS***)scratch_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((Ul_x3Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
+  if ((Ul_x3Face=(Cons1DS***)scratch_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((Ur_x3Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
+  if ((Ur_x3Face=(Cons1DS***)scratch_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
   if ((x1Flux   =(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
@@ -3707,6 +4007,36 @@ void integrate_init_3d(MeshS *pM)
     goto on_error;
 #endif
 
+/* Tile views of the arrays which are saved into the Grid-size arrays */
+  if (Tiled) {
+    if ((x1FluxT = (Cons1DS***)scratch_3d_array(size3,size2,size1,
+      sizeof(Cons1DS))) == NULL) goto on_error;
+    if ((x2FluxT = (Cons1DS***)scratch_3d_array(size3,size2,size1,
+      sizeof(Cons1DS))) == NULL) goto on_error;
+    if ((x3FluxT = (Cons1DS***)scratch_3d_array(size3,size2,size1,
+      sizeof(Cons1DS))) == NULL) goto on_error;
+    if ((dhalfT = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))
+      == NULL) goto on_error;
+    if ((phalfT = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))
+      == NULL) goto on_error;
+    tile_link(&x1Flux,x1FluxT);
+    tile_link(&x2Flux,x2FluxT);
+    tile_link(&x3Flux,x3FluxT);
+    tile_link(&dhalf,dhalfT);
+    tile_link(&phalf,phalfT);
+#ifdef MHD
+    if ((emf1T = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))
+      == NULL) goto on_error;
+    if ((emf2T = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))
+      == NULL) goto on_error;
+    if ((emf3T = (Real***)scratch_3d_array(size3,size2,size1,sizeof(Real)))
+      == NULL) goto on_error;
+    tile_link(&emf1,emf1T);
+    tile_link(&emf2,emf2T);
+    tile_link(&emf3,emf3T);
+#endif /* MHD */
+  }
+
   /* data structures for cylindrical coordinates */
 #ifdef CYLINDRICAL
   if ((geom_src = (Real***)calloc_3d_array(size3, size2, size1, sizeof(Real))) == NULL)
@@ -3731,40 +4061,65 @@ void integrate_destruct_3d(void)
   if (emf1    != NULL) free_3d_array(emf1);
   if (emf2    != NULL) free_3d_array(emf2);
   if (emf3    != NULL) free_3d_array(emf3);
-  if (emf1_cc != NULL) free_3d_array(emf1_cc);
-  if (emf2_cc != NULL) free_3d_array(emf2_cc);
-  if (emf3_cc != NULL) free_3d_array(emf3_cc);
+  if (emf1_cc != NULL) free_scratch_3d(emf1_cc);
+  if (emf2_cc != NULL) free_scratch_3d(emf2_cc);
+  if (emf3_cc != NULL) free_scratch_3d(emf3_cc);
 #endif /* MHD */
 #ifdef H_CORRECTION
-  if (eta1 != NULL) free_3d_array(eta1);
-  if (eta2 != NULL) free_3d_array(eta2);
-  if (eta3 != NULL) free_3d_array(eta3);
+  if (eta1 != NULL) free_scratch_3d(eta1);
+  if (eta2 != NULL) free_scratch_3d(eta2);
+  if (eta3 != NULL) free_scratch_3d(eta3);
 #endif /* H_CORRECTION */
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
-  if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
-  if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
-  if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
+  if (B1_x1Face != NULL) free_scratch_3d(B1_x1Face);
+  if (B2_x2Face != NULL) free_scratch_3d(B2_x2Face);
+  if (B3_x3Face != NULL) free_scratch_3d(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d      != NULL) free(U1d);
-  if (W        != NULL) free(W);
-  if (Wl       != NULL) free(Wl);
-  if (Wr       != NULL) free(Wr);
-
-  if (Ul_x1Face != NULL) free_3d_array(Ul_x1Face);
-  if (Ur_x1Face != NULL) free_3d_array(Ur_x1Face);
-  if (Ul_x2Face != NULL) free_3d_array(Ul_x2Face);
-  if (Ur_x2Face != NULL) free_3d_array(Ur_x2Face);
-  if (Ul_x3Face != NULL) free_3d_array(Ul_x3Face);
-  if (Ur_x3Face != NULL) free_3d_array(Ur_x3Face);
+#pragma omp parallel
+  {
+    if (Bxc      != NULL) free(Bxc);
+    if (Bxi      != NULL) free(Bxi);
+    if (U1d      != NULL) free(U1d);
+    if (W        != NULL) free(W);
+    if (Wl       != NULL) free(Wl);
+    if (Wr       != NULL) free(Wr);
+    Bxc = Bxi = NULL;
+    U1d = NULL;
+    W = Wl = Wr = NULL;
+#ifdef FLUXES_PENCIL
+    if (UlPen.d   != NULL) free_pencil(&UlPen);
+    if (UrPen.d   != NULL) free_pencil(&UrPen);
+    if (FluxPen.d != NULL) free_pencil(&FluxPen);
+    if (WlPen.d   != NULL) free_pencil(&WlPen);
+    if (WrPen.d   != NULL) free_pencil(&WrPen);
+    UlPen.d = UrPen.d = FluxPen.d = NULL;
+    WlPen.d = WrPen.d = NULL;
+#endif /* FLUXES_PENCIL */
+  }
+
+  if (Ul_x1Face != NULL) free_scratch_3d(Ul_x1Face);
+  if (Ur_x1Face != NULL) free_scratch_3d(Ur_x1Face);
+  if (Ul_x2Face != NULL) free_scratch_3d(Ul_x2Face);
+  if (Ur_x2Face != NULL) free_scratch_3d(Ur_x2Face);
+  if (Ul_x3Face != NULL) free_scratch_3d(Ul_x3Face);
+  if (Ur_x3Face != NULL) free_scratch_3d(Ur_x3Face);
   if (x1Flux    != NULL) free_3d_array(x1Flux);
   if (x2Flux    != NULL) free_3d_array(x2Flux);
   if (x3Flux    != NULL) free_3d_array(x3Flux);
   if (dhalf     != NULL) free_3d_array(dhalf);
   if (phalf     != NULL) free_3d_array(phalf);
+  if (x1FluxT   != NULL) free_scratch_3d(x1FluxT);
+  if (x2FluxT   != NULL) free_scratch_3d(x2FluxT);
+  if (x3FluxT   != NULL) free_scratch_3d(x3FluxT);
+  if (dhalfT    != NULL) free_scratch_3d(dhalfT);
+  if (phalfT    != NULL) free_scratch_3d(phalfT);
+#ifdef MHD
+  if (emf1T     != NULL) free_scratch_3d(emf1T);
+  if (emf2T     != NULL) free_scratch_3d(emf2T);
+  if (emf3T     != NULL) free_scratch_3d(emf3T);
+#endif /* MHD */
 #ifdef SHEARING_BOX
   if (Flxiib != NULL) free_2d_array(Flxiib);
   if (Flxoib != NULL) free_2d_array(Flxoib);
@@ -3783,7 +4138,8 @@ void integrate_destruct_3d(void)
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void integrate_emf1_corner(const GridS *pG)
+/*! \fn static void integrate_emf1_corner(const GridS *pG, int js, int je,
+ *                                 int ks, int ke)
  *  \brief Integrates face centered B-fluxes to compute corner EMFs.  
  *
  *  Note: 
@@ -3795,13 +4151,13 @@ void integrate_destruct_3d(void)
  * - x3Flux.Bz = VxBz - BxVz = v3*b2-b3*v2 = EMFX 
  */
 #ifdef MHD
-static void integrate_emf1_corner(const GridS *pG)
+static void integrate_emf1_corner(const GridS *pG, int is, int ie,
+                                  int js, int je, int ks, int ke)
 {
-  int i, is = pG->is, ie = pG->ie;
-  int j, js = pG->js, je = pG->je;
-  int k, ks = pG->ks, ke = pG->ke;
+  int i,j,k;
   Real de1_l2, de1_r2, de1_l3, de1_r3;
 
+#pragma omp parallel for private(i,j,de1_l2,de1_r2,de1_l3,de1_r3)
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-2; i<=ie+2; i++) {
@@ -3853,7 +4209,8 @@ static void integrate_emf1_corner(const GridS *pG)
   return;
 }
 
-/*! \fn static void integrate_emf2_corner(const GridS *pG)
+/*! \fn static void integrate_emf2_corner(const GridS *pG, int js, int je,
+ *                                 int ks, int ke)
  *  \brief Integrates face centered B-fluxes to compute corner EMFs.  
  *
  *  Note: 
@@ -3864,13 +4221,13 @@ static void integrate_emf1_corner(const GridS *pG)
  * - x3Flux.By = VxBy - BxVy = v3*b1-b3*v1 = -EMFY
  * - x3Flux.Bz = VxBz - BxVz = v3*b2-b3*v2 = EMFX 
  */
-static void integrate_emf2_corner(const GridS *pG)
+static void integrate_emf2_corner(const GridS *pG, int is, int ie,
+                                  int js, int je, int ks, int ke)
 {
-  int i, is = pG->is, ie = pG->ie;
-  int j, js = pG->js, je = pG->je;
-  int k, ks = pG->ks, ke = pG->ke;
+  int i,j,k;
   Real de2_l1, de2_r1, de2_l3, de2_r3;
 
+#pragma omp parallel for private(i,j,de2_l1,de2_r1,de2_l3,de2_r3)
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-2; j<=je+2; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -3922,7 +4279,8 @@ static void integrate_emf2_corner(const GridS *pG)
   return;
 }
 
-/*! \fn static void integrate_emf3_corner(const GridS *pG)
+/*! \fn static void integrate_emf3_corner(const GridS *pG, int js, int je,
+ *                                 int ks, int ke)
  *  \brief Integrates face centered B-fluxes to compute corner EMFs.  
  *
  *  Note: 
@@ -3933,14 +4291,15 @@ static void integrate_emf2_corner(const GridS *pG)
  * - x3Flux.By = VxBy - BxVy = v3*b1-b3*v1 = -EMFY
  * - x3Flux.Bz = VxBz - BxVz = v3*b2-b3*v2 = EMFX 
  */
-static void integrate_emf3_corner(const GridS *pG)
+static void integrate_emf3_corner(const GridS *pG, int is, int ie,
+                                  int js, int je, int ks, int ke)
 {
-  int i, is = pG->is, ie = pG->ie;
-  int j, js = pG->js, je = pG->je;
-  int k, ks = pG->ks, ke = pG->ke;
+  int i,j,k;
   Real de3_l1, de3_r1, de3_l2, de3_r2;
   Real rsf=1.0,lsf=1.0;
 
+#pragma omp parallel for private(i,j,de3_l1,de3_r1,de3_l2,de3_r2) \
+  firstprivate(rsf,lsf)
   for (k=ks-2; k<=ke+2; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -3996,4 +4355,247 @@ static void integrate_emf3_corner(const GridS *pG)
 }
 #endif /* MHD */
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void ***scratch_3d_array(size_t nt, size_t nr, size_t nc,
+ *                                      size_t size)
+ *  \brief Construct scratch array[nt][nr][nc].  With tiles only a slab for
+ *   one tile plus halo is allocated, and the returned array is a view into
+ *   it which must be pointed at the current tile with tile_map().
+ */
+
+static void ***scratch_3d_array(size_t nt, size_t nr, size_t nc, size_t size)
+{
+  TileArrS *pT;
+
+  if (!Tiled) return calloc_3d_array(nt,nr,nc,size);
+
+  if (NTileArr == MAX_TILE_ARR)
+    ath_error("[scratch_3d_array]: too many tiled arrays\n");
+  pT = &(TileArr[NTileArr]);
+  pT->slab = calloc_3d_array(TileSize[2],TileSize[1],TileSize[0],size);
+  if (pT->slab == NULL) return NULL;
+  pT->view = (void***)calloc_2d_array(ViewSize[1],ViewSize[0],sizeof(void*));
+  if (pT->view == NULL) {
+    free_3d_array(pT->slab);
+    return NULL;
+  }
+  pT->pArr = NULL;
+  pT->full = NULL;
+  pT->size = size;
+  NTileArr++;
+
+  return pT->view;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void free_scratch_3d(void *array)
+ *  \brief Free array constructed with scratch_3d_array() */
+
+static void free_scratch_3d(void *array)
+{
+  int n;
+
+  for (n=0; n<NTileArr; n++) {
+    if (TileArr[n].view == (void***)array) {
+      free_2d_array(TileArr[n].view);
+      free_3d_array(TileArr[n].slab);
+      TileArr[n] = TileArr[--NTileArr];
+      return;
+    }
+  }
+  free_3d_array(array);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void tile_link(void *pArr, void *view)
+ *  \brief Register the Grid-size array pointed to by *pArr as the array into
+ *   which the tile view is saved.  tile_swap() exchanges *pArr between them.
+ */
+
+static void tile_link(void *pArr, void *view)
+{
+  int n;
+
+  for (n=0; n<NTileArr; n++) {
+    if (TileArr[n].view == (void***)view) {
+      TileArr[n].pArr = (void****)pArr;
+      TileArr[n].full = *(TileArr[n].pArr);
+      return;
+    }
+  }
+  ath_error("[tile_link]: array is not tiled\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void tile_map(const int j0, const int k0)
+ *  \brief Point rows [k0..k0+TileSize[2]-1][j0..j0+TileSize[1]-1] of all
+ *   views at the slabs, clipped to the extent of the views.
+ */
+
+static void tile_map(const int j0, const int k0)
+{
+  int n,j,k,nj,nk;
+
+  nj = MIN(TileSize[1], ViewSize[0]-j0);
+  nk = MIN(TileSize[2], ViewSize[1]-k0);
+  for (n=0; n<NTileArr; n++) {
+    for (k=0; k<nk; k++) {
+      for (j=0; j<nj; j++) {
+        TileArr[n].view[k0+k][j0+j] = TileArr[n].slab[k][j];
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void tile_swap(const int to_view)
+ *  \brief Point the arrays registered with tile_link() at their tile view
+ *   (to_view=1), or back at the Grid-size arrays (to_view=0).
+ */
+
+static void tile_swap(const int to_view)
+{
+  int n;
+
+  for (n=0; n<NTileArr; n++) {
+    if (TileArr[n].pArr != NULL)
+      *(TileArr[n].pArr) = (to_view ? TileArr[n].view : TileArr[n].full);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void tile_save(const GridS *pG, int is, int ie, int js, int je,
+ *                            int ks, int ke)
+ *  \brief Copy [ks..ke][js..je][is..ie] of the tile views registered with
+ *   tile_link() into the Grid-size arrays, extended by one to the faces at
+ *   ie+1, je+1 and ke+1 on the Grid boundary.  Every face is then saved by
+ *   the tile containing it, whatever order the tiles are executed in.
+ */
+
+static void tile_save(const GridS *pG, int is, int ie, int js, int je,
+                      int ks, int ke)
+{
+  int n,j,k;
+  size_t off,len;
+
+  if (ie == pG->ie) ie++;
+  if (je == pG->je) je++;
+  if (ke == pG->ke) ke++;
+
+  for (n=0; n<NTileArr; n++) {
+    if (TileArr[n].full == NULL) continue;
+    off = is*TileArr[n].size;
+    len = (ie-is+1)*TileArr[n].size;
+    for (k=ks; k<=ke; k++) {
+      for (j=js; j<=je; j++) {
+        memcpy((unsigned char*)TileArr[n].full[k][j] + off,
+               (unsigned char*)TileArr[n].view[k][j] + off, len);
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int overlap_boxes(const GridS *pG, int box[][6])
+ *  \brief Divide the active zones of a Grid into the interior box[0] of cells
+ *   at least nghost from the Grid edges, and the six boundary shells around
+ *   it, as [is,ie,js,je,ks,ke] bounds.  If the Grid is too small to have an
+ *   interior, box[0] is empty and box[1] is the whole Grid.  Returns the
+ *   number of boxes.
+ */
+
+static int overlap_boxes(const GridS *pG, int box[][6])
+{
+  int n,b[6];
+
+  b[0] = pG->is;  b[1] = pG->ie;
+  b[2] = pG->js;  b[3] = pG->je;
+  b[4] = pG->ks;  b[5] = pG->ke;
+
+  if (pG->Nx[0] <= 2*nghost || pG->Nx[1] <= 2*nghost ||
+      pG->Nx[2] <= 2*nghost) {
+    for (n=0; n<6; n++) box[0][n] = box[1][n] = b[n];
+    box[0][1] = b[0] - 1;
+    return 2;
+  }
+
+/* interior, then shells at ks and ke spanning all j and i, then shells at
+ * js and je spanning the interior k, then shells at is and ie */
+  for (n=0; n<6; n++) box[0][n] = b[n] + ((n%2) ? -nghost : nghost);
+  for (n=1; n<MAX_BOXES; n++) {
+    box[n][0] = b[0];  box[n][1] = b[1];
+    box[n][2] = b[2];  box[n][3] = b[3];
+    box[n][4] = box[0][4];  box[n][5] = box[0][5];
+  }
+  box[1][4] = b[4];           box[1][5] = box[0][4] - 1;
+  box[2][4] = box[0][5] + 1;  box[2][5] = b[5];
+  box[3][3] = box[0][2] - 1;
+  box[4][2] = box[0][3] + 1;
+  box[5][2] = box[0][2];  box[5][3] = box[0][3];  box[5][1] = box[0][0] - 1;
+  box[6][2] = box[0][2];  box[6][3] = box[0][3];  box[6][0] = box[0][1] + 1;
+
+  return MAX_BOXES;
+}
+
+#ifdef FLUXES_PENCIL
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fluxes_from_cons(const int il, const int iu,
+ *             const Cons1DS *Ul, const Cons1DS *Ur, const Real *Bx,
+ *             Cons1DS *Flux)
+ *  \brief Computes the fluxes Flux[il..iu] along a row of interfaces from the
+ *   L/R conserved variables Ul,Ur, with one call to fluxes_pencil().
+ *   Equivalent to calling fluxes() with Wl,Wr from Cons1D_to_Prim1D() at each
+ *   interface.  Bx is the row of interface fields (NULL for hydro).
+ */
+
+static void fluxes_from_cons(const int il, const int iu,
+  const Cons1DS *Ul, const Cons1DS *Ur, const Real *Bx, Cons1DS *Flux)
+{
+  Cons1D_to_pencil(il,iu,Ul,&UlPen);
+  Cons1D_to_pencil(il,iu,Ur,&UrPen);
+  Cons1D_to_Prim1D_pencil(il,iu,&UlPen,Bx,&WlPen);
+  Cons1D_to_Prim1D_pencil(il,iu,&UrPen,Bx,&WrPen);
+
+  fluxes_pencil(il,iu,&UlPen,&UrPen,&WlPen,&WrPen,Bx,&FluxPen);
+
+  pencil_to_Cons1D(il,iu,&FluxPen,Flux);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fluxes_from_prim(const int il, const int iu,
+ *             const Prim1DS *Wl, const Prim1DS *Wr, const Real *Bx,
+ *             Cons1DS *Ul, Cons1DS *Ur, Cons1DS *Flux)
+ *  \brief Computes the L/R conserved variables Ul,Ur and the fluxes Flux
+ *   [il..iu] along a row of interfaces from the L/R primitive variables Wl,Wr,
+ *   with one call to fluxes_pencil().  Equivalent to calling
+ *   Prim1D_to_Cons1D() and fluxes() at each interface.
+ */
+
+static void fluxes_from_prim(const int il, const int iu,
+  const Prim1DS *Wl, const Prim1DS *Wr, const Real *Bx,
+  Cons1DS *Ul, Cons1DS *Ur, Cons1DS *Flux)
+{
+  Prim1D_to_pencil(il,iu,Wl,&WlPen);
+  Prim1D_to_pencil(il,iu,Wr,&WrPen);
+  Prim1D_to_Cons1D_pencil(il,iu,&WlPen,Bx,&UlPen);
+  Prim1D_to_Cons1D_pencil(il,iu,&WrPen,Bx,&UrPen);
+
+  fluxes_pencil(il,iu,&UlPen,&UrPen,&WlPen,&WrPen,Bx,&FluxPen);
+
+  pencil_to_Cons1D(il,iu,&UlPen,Ul);
+  pencil_to_Cons1D(il,iu,&UrPen,Ur);
+  pencil_to_Cons1D(il,iu,&FluxPen,Flux);
+
+  return;
+}
+#endif /* FLUXES_PENCIL */
+
 #endif /* CTU_INTEGRATOR */
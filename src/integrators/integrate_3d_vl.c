@@ -68,6 +68,25 @@ static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W1d=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(Bxc,Bxi,W1d,Wl,Wr,U1d,Ul,Ur)
+#endif
+
+#ifdef FLUXES_PENCIL
+/* L/R states and fluxes along a pencil of interfaces, for fluxes_pencil() */
+static Cons1DArrS UlPen, UrPen, FluxPen;
+static Prim1DArrS WlPen, WrPen;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(UlPen,UrPen,FluxPen,WlPen,WrPen)
+#endif
+
+/* Row of interface Bx for fluxes_pencil(); it is not used for hydro */
+#ifdef MHD
+#define BX_ROW(B,k,j) ((B)[k][j])
+#else
+#define BX_ROW(B,k,j) NULL
+#endif
+#endif /* FLUXES_PENCIL */
 
 /* conserved variables at t^{n+1/2} computed in predict step */
 static ConsS ***Uhalf=NULL;
@@ -82,12 +101,60 @@ static Real ***eta1=NULL, ***eta2=NULL, ***eta3=NULL;
 static ConsS **Flxiib=NULL, **Flxoib=NULL;
 static ConsS **rFlxiib=NULL, **rFlxoib=NULL;
 #endif
+
+/* With OpenMP the pencil loops in integrate_3d_vl() are divided over the
+ * outer (k or j) index.  The temporaries below are declared at function scope
+ * and so must be private to each thread; the geometric factors which are only
+ * reset in cylindrical coordinates must be firstprivate. */
+#if (NSCALARS > 0)
+#define VL_OMP_SCAL ,n
+#else
+#define VL_OMP_SCAL
+#endif
+#ifdef SELF_GRAVITY
+#define VL_OMP_SELFG ,gxl,gxr,gyl,gyr,gzl,gzr,\
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r
+#else
+#define VL_OMP_SELFG
+#endif
+#ifdef H_CORRECTION
+#define VL_OMP_HCORR ,cfr,cfl,lambdar,lambdal
+#else
+#define VL_OMP_HCORR
+#endif
+#ifdef SHEARING_BOX
+#define VL_OMP_SHBOX ,M1n,dM2n,M1e,dM2e,\
+  flx1_dM2,frx1_dM2,flx2_dM2,frx2_dM2,flx3_dM2,frx3_dM2,fact,qom
+#else
+#define VL_OMP_SHBOX
+#endif
+#ifdef CYLINDRICAL
+#ifdef FARGO
+#define VL_OMP_CYL ,Ekin,Emag,Ptot,B2sq,Om,qshear
+#else
+#define VL_OMP_CYL ,Ekin,Emag,Ptot,B2sq
+#endif
+#else
+#define VL_OMP_CYL
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#define VL_OMP_NANFLUX reduction(+:NaNFlux)
+#else
+#define VL_OMP_NANFLUX
+#endif
+
+#define VL_OMP_PRIVATE private(i,j,k,W,Whalf,x1,x2,x3,phicl,phicr,phifc,\
+  phil,phir,phic,Bx,g VL_OMP_SCAL VL_OMP_SELFG VL_OMP_HCORR VL_OMP_SHBOX \
+  VL_OMP_CYL) firstprivate(lsf,rsf,q2,dtodx2)
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
  *   integrate_emf1_corner() - upwind CT method of GS (2005) for emf1
  *   integrate_emf2_corner() - upwind CT method of GS (2005) for emf2 
  *   integrate_emf3_corner() - upwind CT method of GS (2005) for emf3
  *   FixCell() - apply first-order correction to one cell
+ *   fluxes_from_states() - fluxes along a row from L/R states
+ *   fluxes_from_prim()   - fluxes along a row from L/R primitive variables
  *============================================================================*/
 #ifdef MHD
 static void integrate_emf1_corner(const GridS *pG);
@@ -99,6 +166,14 @@ static void FixCell(GridS *pG, Int3Vect);
 static void ApplyCorr(GridS *pG, int i, int j, int k, 
                       int lx1, int rx1, int lx2, int rx2, int lx3, int rx3);
 #endif
+#ifdef FLUXES_PENCIL
+static void fluxes_from_states(const int il, const int iu,
+  const Cons1DS *Ul, const Cons1DS *Ur, const Prim1DS *Wl, const Prim1DS *Wr,
+  const Real *Bx, Cons1DS *Flux);
+static void fluxes_from_prim(const int il, const int iu,
+  const Prim1DS *Wl, const Prim1DS *Wr, const Real *Bx,
+  Cons1DS *Ul, Cons1DS *Ur, Cons1DS *Flux);
+#endif /* FLUXES_PENCIL */
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -160,13 +235,16 @@ void integrate_3d_vl(DomainS *pD)
     ath_error("[integrate_3d_vl]:  OrbitalProfile() and ShearProfile() *must* be defined.\n");
 #endif
 
-/* Set etah=0 so first calls to flux functions do not use H-correction */
+/* Set etah=0 so first calls to flux functions do not use H-correction.
+ * etah is threadprivate, so it is reset on every thread of the team. */
+#pragma omp parallel
   etah = 0.0;
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        Uhalf[k][j][i] = pG->U[k][j][i];
+        Uhalf[k][j][i] = UGET(pG,k,j,i);
 #ifdef MHD
         B1_x1Face[k][j][i] = pG->B1i[k][j][i];
         B2_x2Face[k][j][i] = pG->B2i[k][j][i];
@@ -184,24 +262,25 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-	U1d[i].d  = pG->U[k][j][i].d;
-	U1d[i].Mx = pG->U[k][j][i].M1;
-	U1d[i].My = pG->U[k][j][i].M2;
-	U1d[i].Mz = pG->U[k][j][i].M3;
+	U1d[i].d  = UVAR(pG,k,j,i,d);
+	U1d[i].Mx = UVAR(pG,k,j,i,M1);
+	U1d[i].My = UVAR(pG,k,j,i,M2);
+	U1d[i].Mz = UVAR(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-	U1d[i].E  = pG->U[k][j][i].E;
+	U1d[i].E  = UVAR(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-	U1d[i].By = pG->U[k][j][i].B2c;
-	U1d[i].Bz = pG->U[k][j][i].B3c;
-        Bxc[i] = pG->U[k][j][i].B1c;
+	U1d[i].By = UVAR(pG,k,j,i,B2c);
+	U1d[i].Bz = UVAR(pG,k,j,i,B3c);
+        Bxc[i] = UVAR(pG,k,j,i,B1c);
         Bxi[i] = pG->B1i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = UVAR(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -228,9 +307,13 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 1d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
+#ifdef FLUXES_PENCIL
+      fluxes_from_states(il,ie+nghost,Ul,Ur,Wl,Wr,Bxi,x1Flux[k][j]);
+#else
       for (i=il; i<=ie+nghost; i++) {
         fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1Flux[k][j][i]);
       }
+#endif /* FLUXES_PENCIL */
     }
   }
 
@@ -242,24 +325,25 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (j=js-nghost; j<=je+nghost; j++) {
-	U1d[j].d  = pG->U[k][j][i].d;
-	U1d[j].Mx = pG->U[k][j][i].M2;
-	U1d[j].My = pG->U[k][j][i].M3;
-	U1d[j].Mz = pG->U[k][j][i].M1;
+	U1d[j].d  = UVAR(pG,k,j,i,d);
+	U1d[j].Mx = UVAR(pG,k,j,i,M2);
+	U1d[j].My = UVAR(pG,k,j,i,M3);
+	U1d[j].Mz = UVAR(pG,k,j,i,M1);
 #ifndef BAROTROPIC
-	U1d[j].E  = pG->U[k][j][i].E;
+	U1d[j].E  = UVAR(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-	U1d[j].By = pG->U[k][j][i].B3c;
-	U1d[j].Bz = pG->U[k][j][i].B1c;
-        Bxc[j] = pG->U[k][j][i].B2c;
+	U1d[j].By = UVAR(pG,k,j,i,B3c);
+	U1d[j].Bz = UVAR(pG,k,j,i,B1c);
+        Bxc[j] = UVAR(pG,k,j,i,B2c);
         Bxi[j] = pG->B2i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = UVAR(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -300,24 +384,25 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
-	U1d[k].d  = pG->U[k][j][i].d;
-	U1d[k].Mx = pG->U[k][j][i].M3;
-	U1d[k].My = pG->U[k][j][i].M1;
-	U1d[k].Mz = pG->U[k][j][i].M2;
+	U1d[k].d  = UVAR(pG,k,j,i,d);
+	U1d[k].Mx = UVAR(pG,k,j,i,M3);
+	U1d[k].My = UVAR(pG,k,j,i,M1);
+	U1d[k].Mz = UVAR(pG,k,j,i,M2);
 #ifndef BAROTROPIC
-	U1d[k].E  = pG->U[k][j][i].E;
+	U1d[k].E  = UVAR(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-	U1d[k].By = pG->U[k][j][i].B1c;
-	U1d[k].Bz = pG->U[k][j][i].B2c;
-        Bxc[k] = pG->U[k][j][i].B3c;
+	U1d[k].By = UVAR(pG,k,j,i,B1c);
+	U1d[k].Bz = UVAR(pG,k,j,i,B2c);
+        Bxc[k] = UVAR(pG,k,j,i,B3c);
         Bxi[k] = pG->B3i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = UVAR(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -358,10 +443,11 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        Whalf = Cons_to_Prim(&pG->U[k][j][i]);
+        Whalf = Cons_to_Prim(UPTR(pG,k,j,i));
         emf1_cc[k][j][i] = (Whalf.B2c*Whalf.V3 - Whalf.B3c*Whalf.V2);
         emf2_cc[k][j][i] = (Whalf.B3c*Whalf.V1 - Whalf.B1c*Whalf.V3);
         emf3_cc[k][j][i] = (Whalf.B1c*Whalf.V2 - Whalf.B2c*Whalf.V1);
@@ -376,6 +462,7 @@ void integrate_3d_vl(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -420,6 +507,7 @@ void integrate_3d_vl(DomainS *pD)
  * face-centered fields.
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -440,6 +528,7 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x1-fluxes
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -466,6 +555,7 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x2-fluxes
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -492,6 +582,7 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x3-fluxes
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -516,6 +607,7 @@ void integrate_3d_vl(DomainS *pD)
  * With first-order flux correction, save predict fluxes and emf3
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -619,6 +711,7 @@ void integrate_3d_vl(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#pragma omp parallel for VL_OMP_PRIVATE
     for (k=kl; k<=ku; k++) {
       for (j=jl; j<=ju; j++) {
         for (i=il; i<=iu; i++) {
@@ -635,7 +728,7 @@ void integrate_3d_vl(DomainS *pD)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif /* CYLINDRICAL */
-          Uhalf[k][j][i].M1 -= hdt*pG->U[k][j][i].d*g;
+          Uhalf[k][j][i].M1 -= hdt*UVAR(pG,k,j,i,d)*g;
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q1*(lsf*x1Flux[k][j][i  ].d*(phic - phil)
                                 + rsf*x1Flux[k][j][i+1].d*(phir - phic));
@@ -643,7 +736,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M2 -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                                 + x2Flux[k][j+1][i].d*(phir - phic));
@@ -651,7 +744,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M3 -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                                 + x3Flux[k+1][j][i].d*(phir - phic));
@@ -667,6 +760,7 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -674,7 +768,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
 
-        Uhalf[k][j][i].M1 -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M1 -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                               + x1Flux[k][j][i+1].d*(phir - phic));
@@ -682,7 +776,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j+1][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
 
-        Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M2 -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                               + x2Flux[k][j+1][i].d*(phir - phic));
@@ -690,7 +784,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
 
-        Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d; 
+        Uhalf[k][j][i].M3 -= q3*(phir-phil)*UVAR(pG,k,j,i,d); 
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                               + x3Flux[k+1][j][i].d*(phir - phic));
@@ -718,7 +812,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Uhalf[k][j][i].M1 -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M1 -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                               + x1Flux[k][j][i+1].d*(phir - phic));
@@ -726,7 +820,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M2 -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                               + x2Flux[k][j+1][i].d*(phir - phic));
@@ -734,7 +828,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M3 -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                               + x3Flux[k+1][j][i].d*(phir - phic));
@@ -746,11 +840,11 @@ void integrate_3d_vl(DomainS *pD)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        Uhalf[k][j][i].M1 += pG->dt*Omega_0*pG->U[k][j][i].M2;
+        Uhalf[k][j][i].M1 += pG->dt*Omega_0*UVAR(pG,k,j,i,M2);
 #ifdef FARGO
-        Uhalf[k][j][i].M2 += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
+        Uhalf[k][j][i].M2 += hdt*(qshear-2.)*Omega_0*UVAR(pG,k,j,i,M1);
 #else
-        Uhalf[k][j][i].M2 -= pG->dt*Omega_0*pG->U[k][j][i].M1;
+        Uhalf[k][j][i].M2 -= pG->dt*Omega_0*UVAR(pG,k,j,i,M1);
 #endif
       }
     }
@@ -764,8 +858,8 @@ void integrate_3d_vl(DomainS *pD)
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
         /* This *is* a half-timestep update below (see note above) */
-        Uhalf[k][j][i].M1 += pG->dt*Om*pG->U[k][j][i].M2;
-        Uhalf[k][j][i].M2 += hdt*(qshear - 2.0)*Om*pG->U[k][j][i].M1;
+        Uhalf[k][j][i].M1 += pG->dt*Om*UVAR(pG,k,j,i,M2);
+        Uhalf[k][j][i].M2 += hdt*(qshear - 2.0)*Om*UVAR(pG,k,j,i,M1);
       }
     }
   }
@@ -777,28 +871,29 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef CYLINDRICAL
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
 
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1)+SQR(pG->U[k][j][i].M2)+SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+        Ekin = 0.5*(SQR(UVAR(pG,k,j,i,M1))+SQR(UVAR(pG,k,j,i,M2))+SQR(UVAR(pG,k,j,i,M3)))/UVAR(pG,k,j,i,d);
 #ifdef MHD
-        B2sq = SQR(pG->U[k][j][i].B2c);
-        Emag = 0.5*(SQR(pG->U[k][j][i].B1c) + B2sq + SQR(pG->U[k][j][i].B3c));
+        B2sq = SQR(UVAR(pG,k,j,i,B2c));
+        Emag = 0.5*(SQR(UVAR(pG,k,j,i,B1c)) + B2sq + SQR(UVAR(pG,k,j,i,B3c)));
 #else
         B2sq = 0.0;
         Emag = 0.0;
 #endif
 
 #ifdef ISOTHERMAL
-        Ptot = Iso_csound2*pG->U[k][j][i].d;
+        Ptot = Iso_csound2*UVAR(pG,k,j,i,d);
 #else
-        Ptot = Gamma_1*(pG->U[k][j][i].E - Ekin - Emag);
+        Ptot = Gamma_1*(UVAR(pG,k,j,i,E) - Ekin - Emag);
 #endif
         Ptot = MAX(Ptot,TINY_NUMBER);
         Ptot += Emag;
 
-        Uhalf[k][j][i].M1 += hdt*(SQR(pG->U[k][j][i].M2)/pG->U[k][j][i].d - B2sq + Ptot)/r[i];
+        Uhalf[k][j][i].M1 += hdt*(SQR(UVAR(pG,k,j,i,M2))/UVAR(pG,k,j,i,d) - B2sq + Ptot)/r[i];
       }
     }
   }
@@ -811,6 +906,7 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -855,6 +951,7 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (i=is-1; i<=ie+1; i++) {
       for (j=jl; j<=ju; j++) {
@@ -902,6 +999,7 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (j=js-1; j<=je+1; j++) {
     for (i=is-1; i<=ie+1; i++) {
       for (k=kl; k<=ku; k++) {
@@ -947,6 +1045,7 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=iu; i++) {
@@ -962,6 +1061,7 @@ void integrate_3d_vl(DomainS *pD)
     }
   }
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=ju; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -977,6 +1077,7 @@ void integrate_3d_vl(DomainS *pD)
     }
   }
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-1; k<=ku; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -997,9 +1098,15 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x1-direction
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE VL_OMP_NANFLUX
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
+#ifdef FLUXES_PENCIL
+      fluxes_from_prim(is,ie+1,Wl_x1Face[k][j],Wr_x1Face[k][j],
+        BX_ROW(B1_x1Face,k,j),Ul,Ur,x1Flux[k][j]);
+#endif
       for (i=is; i<=ie+1; i++) {
+#ifndef FLUXES_PENCIL
 #ifdef H_CORRECTION
         etah = MAX(eta2[k][j][i-1],eta2[k][j][i]);
         etah = MAX(etah,eta2[k][j+1][i-1]);
@@ -1020,6 +1127,7 @@ void integrate_3d_vl(DomainS *pD)
 
         fluxes(Ul[i],Ur[i],Wl_x1Face[k][j][i],Wr_x1Face[k][j][i],Bx,
                &x1Flux[k][j][i]);
+#endif /* FLUXES_PENCIL */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
 /* revert to predictor flux if this flux Nan'ed */
@@ -1047,9 +1155,15 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x2-direction
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE VL_OMP_NANFLUX
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
+#ifdef FLUXES_PENCIL
+      fluxes_from_prim(is-1,ie+1,Wl_x2Face[k][j],Wr_x2Face[k][j],
+        BX_ROW(B2_x2Face,k,j),Ul,Ur,x2Flux[k][j]);
+#endif
       for (i=is-1; i<=ie+1; i++) {
+#ifndef FLUXES_PENCIL
 #ifdef H_CORRECTION
         etah = MAX(eta1[k][j-1][i],eta1[k][j][i]);
         etah = MAX(etah,eta1[k][j-1][i+1]);
@@ -1070,6 +1184,7 @@ void integrate_3d_vl(DomainS *pD)
 
         fluxes(Ul[i],Ur[i],Wl_x2Face[k][j][i],Wr_x2Face[k][j][i],Bx,
                &x2Flux[k][j][i]);
+#endif /* FLUXES_PENCIL */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
 /* revert to predictor flux if this flux NaN'ed */
@@ -1097,9 +1212,15 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x3-direction
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE VL_OMP_NANFLUX
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
+#ifdef FLUXES_PENCIL
+      fluxes_from_prim(is-1,ie+1,Wl_x3Face[k][j],Wr_x3Face[k][j],
+        BX_ROW(B3_x3Face,k,j),Ul,Ur,x3Flux[k][j]);
+#endif
       for (i=is-1; i<=ie+1; i++) {
+#ifndef FLUXES_PENCIL
 #ifdef H_CORRECTION
         etah = MAX(eta1[k-1][j][i],eta1[k][j][i]);
         etah = MAX(etah,eta1[k-1][j][i+1]);
@@ -1120,6 +1241,7 @@ void integrate_3d_vl(DomainS *pD)
 
         fluxes(Ul[i],Ur[i],Wl_x3Face[k][j][i],Wr_x3Face[k][j][i],Bx,
                &x3Flux[k][j][i]);
+#endif /* FLUXES_PENCIL */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
 /* revert to predictor flux if this flux NaN'ed */
@@ -1157,6 +1279,7 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -1266,6 +1389,7 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1312,15 +1436,16 @@ void integrate_3d_vl(DomainS *pD)
  * Set cell centered magnetic fields to average of updated face centered fields.
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-        pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+        UVAR(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+        UVAR(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+        UVAR(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
       }
     }
   }
@@ -1345,11 +1470,11 @@ void integrate_3d_vl(DomainS *pD)
 	cc_pos(pG,i,j,k,&x1,&x2,&x3);
 
 /* Store the current state */
-	M1n  = pG->U[k][j][i].M1;
+	M1n  = UVAR(pG,k,j,i,M1);
 #ifdef FARGO
-	dM2n = pG->U[k][j][i].M2;
+	dM2n = UVAR(pG,k,j,i,M2);
 #else
-	dM2n = pG->U[k][j][i].M2 + qom*x1*pG->U[k][j][i].d;
+	dM2n = UVAR(pG,k,j,i,M2) + qom*x1*UVAR(pG,k,j,i,d);
 #endif
 
 /* Calculate the flux for the y-momentum fluctuation */
@@ -1381,11 +1506,11 @@ void integrate_3d_vl(DomainS *pD)
  * potential momentum source terms using a Crank-Nicholson
  * discretization for the momentum fluctuation equation. */
 
-	pG->U[k][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-	pG->U[k][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+	UVAR(pG,k,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+	UVAR(pG,k,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 
 #ifndef FARGO
-	pG->U[k][j][i].M2 -= 0.5*qshear*om_dt*
+	UVAR(pG,k,j,i,M2) -= 0.5*qshear*om_dt*
            (x1Flux[k][j][i].d + x1Flux[k][j][i+1].d);
 #endif
 
@@ -1396,21 +1521,21 @@ void integrate_3d_vl(DomainS *pD)
 	phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
 	phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-	pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+	UVAR(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif
 
 	phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
 	phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-	pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+	UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif
 
 	phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
 	phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 #ifndef BAROTROPIC
-	pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+	UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif
       }
@@ -1436,25 +1561,25 @@ void integrate_3d_vl(DomainS *pD)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif
-          pG->U[k][j][i].M1 -= pG->dt*Uhalf[k][j][i].d*g;
+          UVAR(pG,k,j,i,M1) -= pG->dt*Uhalf[k][j][i].d*g;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil)
+          UVAR(pG,k,j,i,E) -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil)
                                     + rsf*x1Flux[k][j][i+1].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          pG->U[k][j][i].M2 -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
+          UVAR(pG,k,j,i,M2) -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
+          UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
                                     + x2Flux[k][j+1][i].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          pG->U[k][j][i].M3 -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
+          UVAR(pG,k,j,i,M3) -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
+          UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
                                     + x3Flux[k+1][j][i].d*(phir - phic));
 #endif
         }
@@ -1503,11 +1628,11 @@ void integrate_3d_vl(DomainS *pD)
         flx_m3r = gxr*gzr/four_pi_G;
 
 /* Update momenta and energy with d/dx1 terms  */
-        pG->U[k][j][i].M1 -= dtodx1*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx1*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx1*(flx_m3r - flx_m3l);
+        UVAR(pG,k,j,i,M1) -= dtodx1*(flx_m1r - flx_m1l);
+        UVAR(pG,k,j,i,M2) -= dtodx1*(flx_m2r - flx_m2l);
+        UVAR(pG,k,j,i,M3) -= dtodx1*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -1548,11 +1673,11 @@ void integrate_3d_vl(DomainS *pD)
         flx_m3r = gyr*gzr/four_pi_G;
 
 /* Update momenta and energy with d/dx2 terms  */
-        pG->U[k][j][i].M1 -= dtodx2*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx2*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx2*(flx_m3r - flx_m3l);
+        UVAR(pG,k,j,i,M1) -= dtodx2*(flx_m1r - flx_m1l);
+        UVAR(pG,k,j,i,M2) -= dtodx2*(flx_m2r - flx_m2l);
+        UVAR(pG,k,j,i,M3) -= dtodx2*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -1593,11 +1718,11 @@ void integrate_3d_vl(DomainS *pD)
         flx_m3r = 0.5*(gzr*gzr-gxr*gxr-gyr*gyr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx3 terms  */
-        pG->U[k][j][i].M1 -= dtodx3*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx3*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx3*(flx_m3r - flx_m3l);
+        UVAR(pG,k,j,i,M1) -= dtodx3*(flx_m1r - flx_m1l);
+        UVAR(pG,k,j,i,M2) -= dtodx3*(flx_m2r - flx_m2l);
+        UVAR(pG,k,j,i,M3) -= dtodx3*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+        UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -1623,6 +1748,7 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef CYLINDRICAL
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1644,14 +1770,14 @@ void integrate_3d_vl(DomainS *pD)
         Ptot = MAX(Ptot,TINY_NUMBER);
         Ptot += Emag;
 
-        pG->U[k][j][i].M1 += pG->dt*(SQR(Uhalf[k][j][i].M2)/Uhalf[k][j][i].d - B2sq + Ptot)/r[i];
+        UVAR(pG,k,j,i,M1) += pG->dt*(SQR(Uhalf[k][j][i].M2)/Uhalf[k][j][i].d - B2sq + Ptot)/r[i];
 
 #ifdef FARGO
         /* Use average values to apply source terms for full time-step */
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
-        pG->U[k][j][i].M1 += pG->dt*(2.0*Om*Uhalf[k][j][i].M2);
-        pG->U[k][j][i].M2 += pG->dt*(Om*(qshear-2.0)*Uhalf[k][j][i].M1);
+        UVAR(pG,k,j,i,M1) += pG->dt*(2.0*Om*Uhalf[k][j][i].M2);
+        UVAR(pG,k,j,i,M2) += pG->dt*(Om*(qshear-2.0)*Uhalf[k][j][i].M1);
 #endif /* FARGO */
       }
     }
@@ -1664,22 +1790,23 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].d  -= dtodx1*(rsf*x1Flux[k][j][i+1].d  - lsf*x1Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx - lsf*x1Flux[k][j][i].Mx);
-        pG->U[k][j][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My - SQR(lsf)*x1Flux[k][j][i].My);
-        pG->U[k][j][i].M3 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz - lsf*x1Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,d)  -= dtodx1*(rsf*x1Flux[k][j][i+1].d  - lsf*x1Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx - lsf*x1Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My - SQR(lsf)*x1Flux[k][j][i].My);
+        UVAR(pG,k,j,i,M3) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz - lsf*x1Flux[k][j][i].Mz);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx1*(rsf*x1Flux[k][j][i+1].E  - lsf*x1Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E)  -= dtodx1*(rsf*x1Flux[k][j][i+1].E  - lsf*x1Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
                                        - lsf*x1Flux[k][j][i  ].s[n]);
 #endif
       }
@@ -1690,22 +1817,23 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-        pG->U[k][j][i].d  -= dtodx2*(x2Flux[k][j+1][i].d  - x2Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx2*(x2Flux[k][j+1][i].Mz - x2Flux[k][j][i].Mz);
-        pG->U[k][j][i].M2 -= dtodx2*(x2Flux[k][j+1][i].Mx - x2Flux[k][j][i].Mx);
-        pG->U[k][j][i].M3 -= dtodx2*(x2Flux[k][j+1][i].My - x2Flux[k][j][i].My);
+        UVAR(pG,k,j,i,d)  -= dtodx2*(x2Flux[k][j+1][i].d  - x2Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1) -= dtodx2*(x2Flux[k][j+1][i].Mz - x2Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,M2) -= dtodx2*(x2Flux[k][j+1][i].Mx - x2Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,M3) -= dtodx2*(x2Flux[k][j+1][i].My - x2Flux[k][j][i].My);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx2*(x2Flux[k][j+1][i].E  - x2Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E)  -= dtodx2*(x2Flux[k][j+1][i].E  - x2Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx2*(x2Flux[k][j+1][i].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx2*(x2Flux[k][j+1][i].s[n]
                                        - x2Flux[k][j  ][i].s[n]);
 #endif
       }
@@ -1716,19 +1844,20 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#pragma omp parallel for VL_OMP_PRIVATE
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d  -= dtodx3*(x3Flux[k+1][j][i].d  - x3Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx3*(x3Flux[k+1][j][i].My - x3Flux[k][j][i].My);
-        pG->U[k][j][i].M2 -= dtodx3*(x3Flux[k+1][j][i].Mz - x3Flux[k][j][i].Mz);
-        pG->U[k][j][i].M3 -= dtodx3*(x3Flux[k+1][j][i].Mx - x3Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,d)  -= dtodx3*(x3Flux[k+1][j][i].d  - x3Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1) -= dtodx3*(x3Flux[k+1][j][i].My - x3Flux[k][j][i].My);
+        UVAR(pG,k,j,i,M2) -= dtodx3*(x3Flux[k+1][j][i].Mz - x3Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,M3) -= dtodx3*(x3Flux[k+1][j][i].Mx - x3Flux[k][j][i].Mx);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx3*(x3Flux[k+1][j][i].E  - x3Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E)  -= dtodx3*(x3Flux[k+1][j][i].E  - x3Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx3*(x3Flux[k+1][j][i].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx3*(x3Flux[k+1][j][i].s[n]
                                        - x3Flux[k  ][j][i].s[n]);
 #endif
       }
@@ -1744,7 +1873,7 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        W = Cons_to_Prim(&(pG->U[k][j][i]));
+        W = Cons_to_Prim(UPTR(pG,k,j,i));
         if (W.d < 0.0) {
           flag_cell = 1;
           BadCell.i = i;
@@ -2083,7 +2212,7 @@ void integrate_3d_vl(DomainS *pD)
  *  \brief Allocate temporary integration arrays */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -2143,9 +2272,6 @@ void integrate_init_3d(MeshS *pM)
   if ((Wr_x3Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
     == NULL) goto on_error;
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-
 #ifdef MHD
   if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))
     == NULL) goto on_error;
@@ -2155,12 +2281,30 @@ void integrate_init_3d(MeshS *pM)
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* The 1D scratch vectors are threadprivate, so with OpenMP every thread in the
+ * team allocates its own copy */
+#pragma omp parallel reduction(+:nerr)
+  {
+    Bxc = (Real*)malloc(nmax*sizeof(Real));
+    Bxi = (Real*)malloc(nmax*sizeof(Real));
+    U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS));
+    Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS));
+    Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS));
+    W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS));
+    Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS));
+    Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS));
+    if (Bxc == NULL || Bxi == NULL || U1d == NULL || Ul == NULL ||
+        Ur == NULL || W1d == NULL || Wl == NULL || Wr == NULL) nerr++;
+#ifdef FLUXES_PENCIL
+    if (calloc_pencil(&UlPen,  sizeof(Cons1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&UrPen,  sizeof(Cons1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&FluxPen,sizeof(Cons1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&WlPen,  sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&WrPen,  sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL)
+      nerr++;
+#endif /* FLUXES_PENCIL */
+  }
+  if (nerr > 0) goto on_error;
 
   if ((x1Flux = (Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
@@ -2232,20 +2376,35 @@ void integrate_destruct_3d(void)
   if (Wl_x3Face != NULL) free_3d_array(Wl_x3Face);
   if (Wr_x3Face != NULL) free_3d_array(Wr_x3Face);
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
   if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d != NULL) free(U1d);
-  if (Ul  != NULL) free(Ul);
-  if (Ur  != NULL) free(Ur);
-  if (W1d != NULL) free(W1d);
-  if (Wl  != NULL) free(Wl);
-  if (Wr  != NULL) free(Wr);
+#pragma omp parallel
+  {
+    if (Bxc != NULL) free(Bxc);
+    if (Bxi != NULL) free(Bxi);
+    if (U1d != NULL) free(U1d);
+    if (Ul  != NULL) free(Ul);
+    if (Ur  != NULL) free(Ur);
+    if (W1d != NULL) free(W1d);
+    if (Wl  != NULL) free(Wl);
+    if (Wr  != NULL) free(Wr);
+    Bxc = Bxi = NULL;
+    U1d = Ul = Ur = NULL;
+    W1d = Wl = Wr = NULL;
+#ifdef FLUXES_PENCIL
+    if (UlPen.d   != NULL) free_pencil(&UlPen);
+    if (UrPen.d   != NULL) free_pencil(&UrPen);
+    if (FluxPen.d != NULL) free_pencil(&FluxPen);
+    if (WlPen.d   != NULL) free_pencil(&WlPen);
+    if (WrPen.d   != NULL) free_pencil(&WrPen);
+    UlPen.d = UrPen.d = FluxPen.d = NULL;
+    WlPen.d = WrPen.d = NULL;
+#endif /* FLUXES_PENCIL */
+  }
 
   if (x1Flux  != NULL) free_3d_array(x1Flux);
   if (x2Flux  != NULL) free_3d_array(x2Flux);
@@ -2300,6 +2459,7 @@ static void integrate_emf1_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#pragma omp parallel for private(i,j,de1_l2,de1_r2,de1_l3,de1_r3)
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -2373,6 +2533,7 @@ static void integrate_emf2_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#pragma omp parallel for private(i,j,de2_l1,de2_r1,de2_l3,de2_r3)
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu+1; i++) {
@@ -2447,6 +2608,8 @@ static void integrate_emf3_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#pragma omp parallel for private(i,j,de3_l1,de3_r1,de3_l2,de3_r2) \
+  firstprivate(rsf,lsf)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu+1; i++) {
@@ -2689,9 +2852,9 @@ static void FixCell(GridS *pG, Int3Vect ix)
 #ifdef CYLINDRICAL
     rsf = pG->ri[i+1]/pG->r[i];  lsf = pG->ri[i]/pG->r[i];
 #endif
-    pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-    pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-    pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+    UVAR(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+    UVAR(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+    UVAR(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
   }}}
 #endif /* MHD */
 
@@ -2749,40 +2912,40 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   lsf = (lx1>0) ? pG->ri[i  ]/pG->r[i] : pG->ri[i+1]/pG->r[i];
   dtodx2 = pG->dt/(pG->r[i]*pG->dx2);
 #endif
-  pG->U[k][j][i].d  += dtodx1*(rsf*rx1*x1FD_ip1.d  - lsf*lx1*x1FD_i.d );
-  pG->U[k][j][i].M1 += dtodx1*(rsf*rx1*x1FD_ip1.Mx - lsf*lx1*x1FD_i.Mx);
-  pG->U[k][j][i].M2 += dtodx1*(SQR(rsf)*rx1*x1FD_ip1.My - SQR(lsf)*lx1*x1FD_i.My);
-  pG->U[k][j][i].M3 += dtodx1*(rsf*rx1*x1FD_ip1.Mz - lsf*lx1*x1FD_i.Mz);
+  UVAR(pG,k,j,i,d)  += dtodx1*(rsf*rx1*x1FD_ip1.d  - lsf*lx1*x1FD_i.d );
+  UVAR(pG,k,j,i,M1) += dtodx1*(rsf*rx1*x1FD_ip1.Mx - lsf*lx1*x1FD_i.Mx);
+  UVAR(pG,k,j,i,M2) += dtodx1*(SQR(rsf)*rx1*x1FD_ip1.My - SQR(lsf)*lx1*x1FD_i.My);
+  UVAR(pG,k,j,i,M3) += dtodx1*(rsf*rx1*x1FD_ip1.Mz - lsf*lx1*x1FD_i.Mz);
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E  += dtodx1*(rsf*rx1*x1FD_ip1.E  - lsf*lx1*x1FD_i.E );
+  UVAR(pG,k,j,i,E)  += dtodx1*(rsf*rx1*x1FD_ip1.E  - lsf*lx1*x1FD_i.E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[k][j][i].s[n] += dtodx1*(rsf*rx1*x1FD_ip1.s[n] - lsf*lx1*x1FD_i.s[n]);
+    UVAR(pG,k,j,i,s[n]) += dtodx1*(rsf*rx1*x1FD_ip1.s[n] - lsf*lx1*x1FD_i.s[n]);
 #endif
 
-  pG->U[k][j][i].d  += dtodx2*(rx2*x2FD_jp1.d  - lx2*x2FD_j.d );
-  pG->U[k][j][i].M1 += dtodx2*(rx2*x2FD_jp1.Mz - lx2*x2FD_j.Mz);
-  pG->U[k][j][i].M2 += dtodx2*(rx2*x2FD_jp1.Mx - lx2*x2FD_j.Mx);
-  pG->U[k][j][i].M3 += dtodx2*(rx2*x2FD_jp1.My - lx2*x2FD_j.My);
+  UVAR(pG,k,j,i,d)  += dtodx2*(rx2*x2FD_jp1.d  - lx2*x2FD_j.d );
+  UVAR(pG,k,j,i,M1) += dtodx2*(rx2*x2FD_jp1.Mz - lx2*x2FD_j.Mz);
+  UVAR(pG,k,j,i,M2) += dtodx2*(rx2*x2FD_jp1.Mx - lx2*x2FD_j.Mx);
+  UVAR(pG,k,j,i,M3) += dtodx2*(rx2*x2FD_jp1.My - lx2*x2FD_j.My);
 #ifndef BAROTROPIC                                   
-  pG->U[k][j][i].E  += dtodx2*(rx2*x2FD_jp1.E  - lx2*x2FD_j.E );
+  UVAR(pG,k,j,i,E)  += dtodx2*(rx2*x2FD_jp1.E  - lx2*x2FD_j.E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[k][j][i].s[n] += dtodx2*(rx2*x2FD_jp1.s[n] - lx2*x2FD_j.s[n]);
+    UVAR(pG,k,j,i,s[n]) += dtodx2*(rx2*x2FD_jp1.s[n] - lx2*x2FD_j.s[n]);
 #endif
 
-  pG->U[k][j][i].d  += dtodx3*(rx3*x3FD_kp1.d  - lx3*x3FD_k.d );
-  pG->U[k][j][i].M1 += dtodx3*(rx3*x3FD_kp1.My - lx3*x3FD_k.My);
-  pG->U[k][j][i].M2 += dtodx3*(rx3*x3FD_kp1.Mz - lx3*x3FD_k.Mz);
-  pG->U[k][j][i].M3 += dtodx3*(rx3*x3FD_kp1.Mx - lx3*x3FD_k.Mx);
+  UVAR(pG,k,j,i,d)  += dtodx3*(rx3*x3FD_kp1.d  - lx3*x3FD_k.d );
+  UVAR(pG,k,j,i,M1) += dtodx3*(rx3*x3FD_kp1.My - lx3*x3FD_k.My);
+  UVAR(pG,k,j,i,M2) += dtodx3*(rx3*x3FD_kp1.Mz - lx3*x3FD_k.Mz);
+  UVAR(pG,k,j,i,M3) += dtodx3*(rx3*x3FD_kp1.Mx - lx3*x3FD_k.Mx);
 #ifndef BAROTROPIC                                   
-  pG->U[k][j][i].E  += dtodx3*(rx3*x3FD_kp1.E  - lx3*x3FD_k.E );
+  UVAR(pG,k,j,i,E)  += dtodx3*(rx3*x3FD_kp1.E  - lx3*x3FD_k.E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[k][j][i].s[n] += dtodx3*(rx3*x3FD_kp1.s[n] - lx3*x3FD_k.s[n]);
+    UVAR(pG,k,j,i,s[n]) += dtodx3*(rx3*x3FD_kp1.s[n] - lx3*x3FD_k.s[n]);
 #endif
 
 #ifdef SHEARING_BOX
@@ -2820,11 +2983,11 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
  * potential momentum source terms using a Crank-Nicholson
  * discretization for the momentum fluctuation equation. */
 
-  pG->U[k][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-  pG->U[k][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+  UVAR(pG,k,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+  UVAR(pG,k,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 
 #ifndef FARGO
-  pG->U[k][j][i].M2 += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d + ABS(rx1)*x1FD_ip1.d);
+  UVAR(pG,k,j,i,M2) += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d + ABS(rx1)*x1FD_ip1.d);
 #endif
 
 /* Update the energy for a fixed potential.
@@ -2834,21 +2997,21 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = (*ShearingBoxPot)((x1+rx1*0.5*pG->dx1),x2,x3);
   phil = (*ShearingBoxPot)((x1-lx1*0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
+  UVAR(pG,k,j,i,E) += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
                               rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
   phir = (*ShearingBoxPot)(x1,(x2+rx2*0.5*pG->dx2),x3);
   phil = (*ShearingBoxPot)(x1,(x2-lx2*0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+  UVAR(pG,k,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                               rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
   phir = (*ShearingBoxPot)(x1,x2,(x3+rx3*0.5*pG->dx3));
   phil = (*ShearingBoxPot)(x1,x2,(x3-lx3*0.5*pG->dx3));
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
+  UVAR(pG,k,j,i,E) += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
                               rx3*x3FD_kp1.d*(phir - phic));
 #endif
 #endif /* SHEARING_BOX */
@@ -2860,7 +3023,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
     phil = (*StaticGravPot)((x1-lx1*0.5*pG->dx1),x2,x3);
 
 #ifndef BAROTROPIC
-    pG->U[k][j][i].E += dtodx1*(lsf*lx1*x1FD_i.d*(phic - phil) +
+    UVAR(pG,k,j,i,E) += dtodx1*(lsf*lx1*x1FD_i.d*(phic - phil) +
                                 rsf*rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
@@ -2868,7 +3031,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
     phil = (*StaticGravPot)(x1,(x2-lx2*0.5*pG->dx2),x3);
 
 #ifndef BAROTROPIC
-    pG->U[k][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+    UVAR(pG,k,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                                 rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
@@ -2876,7 +3039,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
     phil = (*StaticGravPot)(x1,x2,(x3-lx3*0.5*pG->dx3));
 
 #ifndef BAROTROPIC
-    pG->U[k][j][i].E += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
+    UVAR(pG,k,j,i,E) += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
                                 rx3*x3FD_kp1.d*(phir - phic));
 #endif
   }
@@ -2887,7 +3050,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = 0.5*(pG->Phi[k][j][i  ] + pG->Phi[k][j][i+rx1]);
 
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
+  UVAR(pG,k,j,i,E) += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
                               rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
@@ -2895,7 +3058,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = 0.5*(pG->Phi[k][j  ][i] + pG->Phi[k][j+rx2][i]);
 
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+  UVAR(pG,k,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                               rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
@@ -2903,7 +3066,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = 0.5*(pG->Phi[k  ][j][i] + pG->Phi[k+rx3][j][i]);
 
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
+  UVAR(pG,k,j,i,E) += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
                               rx3*x3FD_kp1.d*(phir - phic));
 #endif
 
@@ -2941,6 +3104,61 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
 
 #endif /* FIRST_ORDER_FLUX_CORRECTION */
 
+#ifdef FLUXES_PENCIL
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fluxes_from_states(const int il, const int iu,
+ *             const Cons1DS *Ul, const Cons1DS *Ur, const Prim1DS *Wl,
+ *             const Prim1DS *Wr, const Real *Bx, Cons1DS *Flux)
+ *  \brief Computes the fluxes Flux[il..iu] along a row of interfaces from the
+ *   L/R states Ul,Ur,Wl,Wr with one call to fluxes_pencil().  Equivalent to
+ *   calling fluxes() at each interface.
+ */
+
+static void fluxes_from_states(const int il, const int iu,
+  const Cons1DS *Ul, const Cons1DS *Ur, const Prim1DS *Wl, const Prim1DS *Wr,
+  const Real *Bx, Cons1DS *Flux)
+{
+  Cons1D_to_pencil(il,iu,Ul,&UlPen);
+  Cons1D_to_pencil(il,iu,Ur,&UrPen);
+  Prim1D_to_pencil(il,iu,Wl,&WlPen);
+  Prim1D_to_pencil(il,iu,Wr,&WrPen);
+
+  fluxes_pencil(il,iu,&UlPen,&UrPen,&WlPen,&WrPen,Bx,&FluxPen);
+
+  pencil_to_Cons1D(il,iu,&FluxPen,Flux);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fluxes_from_prim(const int il, const int iu,
+ *             const Prim1DS *Wl, const Prim1DS *Wr, const Real *Bx,
+ *             Cons1DS *Ul, Cons1DS *Ur, Cons1DS *Flux)
+ *  \brief Computes the L/R conserved variables Ul,Ur and the fluxes Flux
+ *   [il..iu] along a row of interfaces from the L/R primitive variables Wl,Wr,
+ *   with one call to fluxes_pencil().  Equivalent to calling
+ *   Prim1D_to_Cons1D() and fluxes() at each interface.
+ */
+
+static void fluxes_from_prim(const int il, const int iu,
+  const Prim1DS *Wl, const Prim1DS *Wr, const Real *Bx,
+  Cons1DS *Ul, Cons1DS *Ur, Cons1DS *Flux)
+{
+  Prim1D_to_pencil(il,iu,Wl,&WlPen);
+  Prim1D_to_pencil(il,iu,Wr,&WrPen);
+  Prim1D_to_Cons1D_pencil(il,iu,&WlPen,Bx,&UlPen);
+  Prim1D_to_Cons1D_pencil(il,iu,&WrPen,Bx,&UrPen);
+
+  fluxes_pencil(il,iu,&UlPen,&UrPen,&WlPen,&WrPen,Bx,&FluxPen);
+
+  pencil_to_Cons1D(il,iu,&UlPen,Ul);
+  pencil_to_Cons1D(il,iu,&UrPen,Ur);
+  pencil_to_Cons1D(il,iu,&FluxPen,Flux);
+
+  return;
+}
+#endif /* FLUXES_PENCIL */
+
 #endif /* VL_INTEGRATOR */
 
 #endif /* SPECIAL_RELATIVITY */
@@ -152,11 +152,11 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        Uhalf[k][j][i] = pG->U[k][j][i];
-        W[k][j][i] = Cons_to_Prim(&(pG->U[k][j][i]));
+        Uhalf[k][j][i] = UGET(pG,k,j,i);
+        W[k][j][i] = Cons_to_Prim(UPTR(pG,k,j,i));
 #ifdef USE_ENTROPY_FIX
 	S[k][j][i] = W[k][j][i].P * pow(W[k][j][i].d,1.0-Gamma);
-	S[k][j][i]*= pG->U[k][j][i].d / W[k][j][i].d;
+	S[k][j][i]*= UVAR(pG,k,j,i,d) / W[k][j][i].d;
 	Shalf[k][j][i] = S[k][j][i];
 #endif
 #ifdef MHD
@@ -578,7 +578,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-          Uhalf[k][j][i].M1 -= q1*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M1 -= q1*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                                 + x1Flux[k][j][i+1].d*(phir - phic));
@@ -586,7 +586,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M2 -= q2*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                                 + x2Flux[k][j+1][i].d*(phir - phic));
@@ -594,7 +594,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M3 -= q3*(phir-phil)*UVAR(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                                 + x3Flux[k+1][j][i].d*(phir - phic));
@@ -1182,9 +1182,9 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i]+pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i]+pG->B2i[k][j+1][i]);
-        pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i]+pG->B3i[k+1][j][i]);
+        UVAR(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i]+pG->B1i[k][j][i+1]);
+        UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i]+pG->B2i[k][j+1][i]);
+        UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i]+pG->B3i[k+1][j][i]);
       }
     }
   }
@@ -1208,25 +1208,25 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-          pG->U[k][j][i].M1 -= dtodx1*(phir-phil)*Uhalf[k][j][i].d;
+          UVAR(pG,k,j,i,M1) -= dtodx1*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil)
+          UVAR(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil)
                                     + x1Flux[k][j][i+1].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          pG->U[k][j][i].M2 -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
+          UVAR(pG,k,j,i,M2) -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
+          UVAR(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
                                     + x2Flux[k][j+1][i].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          pG->U[k][j][i].M3 -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
+          UVAR(pG,k,j,i,M3) -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
+          UVAR(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
                                     + x3Flux[k+1][j][i].d*(phir - phic));
 #endif
         }
@@ -1243,16 +1243,16 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d -=dtodx1*(x1Flux[k][j][i+1].d -x1Flux[k][j][i].d );
-        pG->U[k][j][i].M1-=dtodx1*(x1Flux[k][j][i+1].Mx-x1Flux[k][j][i].Mx);
-        pG->U[k][j][i].M2-=dtodx1*(x1Flux[k][j][i+1].My-x1Flux[k][j][i].My);
-        pG->U[k][j][i].M3-=dtodx1*(x1Flux[k][j][i+1].Mz-x1Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,d) -=dtodx1*(x1Flux[k][j][i+1].d -x1Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1)-=dtodx1*(x1Flux[k][j][i+1].Mx-x1Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,M2)-=dtodx1*(x1Flux[k][j][i+1].My-x1Flux[k][j][i].My);
+        UVAR(pG,k,j,i,M3)-=dtodx1*(x1Flux[k][j][i+1].Mz-x1Flux[k][j][i].Mz);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx1*(x1Flux[k][j][i+1].E -x1Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E) -=dtodx1*(x1Flux[k][j][i+1].E -x1Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx1*(x1Flux[k][j][i+1].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx1*(x1Flux[k][j][i+1].s[n]
                                        - x1Flux[k][j][i  ].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -1269,16 +1269,16 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d -=dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
-        pG->U[k][j][i].M1-=dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
-        pG->U[k][j][i].M2-=dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
-        pG->U[k][j][i].M3-=dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
+        UVAR(pG,k,j,i,d) -=dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1)-=dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,M2)-=dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,M3)-=dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E) -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx2*(x2Flux[k][j+1][i].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx2*(x2Flux[k][j+1][i].s[n]
                                        - x2Flux[k][j  ][i].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -1295,16 +1295,16 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d -=dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
-        pG->U[k][j][i].M1-=dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
-        pG->U[k][j][i].M2-=dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
-        pG->U[k][j][i].M3-=dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
+        UVAR(pG,k,j,i,d) -=dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
+        UVAR(pG,k,j,i,M1)-=dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
+        UVAR(pG,k,j,i,M2)-=dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
+        UVAR(pG,k,j,i,M3)-=dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
+        UVAR(pG,k,j,i,E) -=dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx3*(x3Flux[k+1][j][i].s[n]
+          UVAR(pG,k,j,i,s[n]) -= dtodx3*(x3Flux[k+1][j][i].s[n]
                                        - x3Flux[k  ][j][i].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -1323,7 +1323,7 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        Wcheck = check_Prim(&(pG->U[k][j][i]));
+        Wcheck = check_Prim(UPTR(pG,k,j,i));
         if (Wcheck.d < 0.0) {
           flag_cell = 1;
           BadCell.i = i;
@@ -1381,7 +1381,7 @@ void integrate_3d_vl(DomainS *pD)
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 	flag_cell = 0;
-        Wcheck = check_Prim(&(pG->U[k][j][i]));
+        Wcheck = check_Prim(UPTR(pG,k,j,i));
         if (Wcheck.d < 0.0) {
           flag_cell = 1;
           negd++;
@@ -1398,30 +1398,30 @@ void integrate_3d_vl(DomainS *pD)
 #ifdef USE_ENTROPY_FIX
 	if (flag_cell != 0) {
 	  entropy++;
-	  Wcheck = entropy_fix (&(pG->U[k][j][i]),&(S[k][j][i]));
+	  Wcheck = entropy_fix (UPTR(pG,k,j,i),&(S[k][j][i]));
 	  Ucheck = Prim_to_Cons(&Wcheck);
 	  Wcheck = check_Prim(&Ucheck);
 	  Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
 	  if (Wcheck.d > 0.0 && Wcheck.P > 0.0 && Vsq < 1.0){
-	    pG->U[k][j][i].d = Ucheck.d;
-	    pG->U[k][j][i].M1 = Ucheck.M1;
-	    pG->U[k][j][i].M2 = Ucheck.M2;
-	    pG->U[k][j][i].M3 = Ucheck.M3;
-	    pG->U[k][j][i].E = Ucheck.E;
+	    UVAR(pG,k,j,i,d) = Ucheck.d;
+	    UVAR(pG,k,j,i,M1) = Ucheck.M1;
+	    UVAR(pG,k,j,i,M2) = Ucheck.M2;
+	    UVAR(pG,k,j,i,M3) = Ucheck.M3;
+	    UVAR(pG,k,j,i,E) = Ucheck.E;
 	    flag_cell = 0;
 	  }
 	}
 #endif /* USE_ENTROPY_FIX */
 	if (flag_cell != 0) {
 	  final++;
-	  Wcheck = fix_vsq (&(pG->U[k][j][i]));
+	  Wcheck = fix_vsq (UPTR(pG,k,j,i));
 	  Ucheck = Prim_to_Cons(&Wcheck);
-	  pG->U[k][j][i].d = Ucheck.d;
-	  pG->U[k][j][i].M1 = Ucheck.M1;
-	  pG->U[k][j][i].M2 = Ucheck.M2;
-	  pG->U[k][j][i].M3 = Ucheck.M3;
-	  pG->U[k][j][i].E = Ucheck.E;
-	  Wcheck = check_Prim(&(pG->U[k][j][i]));
+	  UVAR(pG,k,j,i,d) = Ucheck.d;
+	  UVAR(pG,k,j,i,M1) = Ucheck.M1;
+	  UVAR(pG,k,j,i,M2) = Ucheck.M2;
+	  UVAR(pG,k,j,i,M3) = Ucheck.M3;
+	  UVAR(pG,k,j,i,E) = Ucheck.E;
+	  Wcheck = check_Prim(UPTR(pG,k,j,i));
 	  Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
 	  if (Wcheck.d < 0.0 || Wcheck.P < 0.0 || Vsq > 1.0){
 	    fail++;
@@ -2268,93 +2268,93 @@ static void FixCell(GridS *pG, Int3Vect ix)
 
 /* Use flux differences to correct bad cell-centered quantities */
   
-  pG->U[ix.k][ix.j][ix.i].d  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
-  pG->U[ix.k][ix.j][ix.i].M1 += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
-  pG->U[ix.k][ix.j][ix.i].M2 += dtodx1*(x1FD_ip1.My - x1FD_i.My);
-  pG->U[ix.k][ix.j][ix.i].M3 += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
+  UVAR(pG,ix.k,ix.j,ix.i,d)  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
+  UVAR(pG,ix.k,ix.j,ix.i,M1) += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
+  UVAR(pG,ix.k,ix.j,ix.i,M2) += dtodx1*(x1FD_ip1.My - x1FD_i.My);
+  UVAR(pG,ix.k,ix.j,ix.i,M3) += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
 #ifndef BAROTROPIC
-  pG->U[ix.k][ix.j][ix.i].E  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
+  UVAR(pG,ix.k,ix.j,ix.i,E)  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
 #endif /* BAROTROPIC */
   
-  pG->U[ix.k][ix.j][ix.i].d  += dtodx2*(x2FD_jp1.d  - x2FD_j.d );
-  pG->U[ix.k][ix.j][ix.i].M1 += dtodx2*(x2FD_jp1.Mz - x2FD_j.Mz);
-  pG->U[ix.k][ix.j][ix.i].M2 += dtodx2*(x2FD_jp1.Mx - x2FD_j.Mx);
-  pG->U[ix.k][ix.j][ix.i].M3 += dtodx2*(x2FD_jp1.My - x2FD_j.My);
+  UVAR(pG,ix.k,ix.j,ix.i,d)  += dtodx2*(x2FD_jp1.d  - x2FD_j.d );
+  UVAR(pG,ix.k,ix.j,ix.i,M1) += dtodx2*(x2FD_jp1.Mz - x2FD_j.Mz);
+  UVAR(pG,ix.k,ix.j,ix.i,M2) += dtodx2*(x2FD_jp1.Mx - x2FD_j.Mx);
+  UVAR(pG,ix.k,ix.j,ix.i,M3) += dtodx2*(x2FD_jp1.My - x2FD_j.My);
 #ifndef BAROTROPIC
-  pG->U[ix.k][ix.j][ix.i].E  += dtodx2*(x2FD_jp1.E  - x2FD_j.E );
+  UVAR(pG,ix.k,ix.j,ix.i,E)  += dtodx2*(x2FD_jp1.E  - x2FD_j.E );
 #endif /* BAROTROPIC */
 
-  pG->U[ix.k][ix.j][ix.i].d  += dtodx3*(x3FD_kp1.d  - x3FD_k.d );
-  pG->U[ix.k][ix.j][ix.i].M1 += dtodx3*(x3FD_kp1.Mz - x3FD_k.Mz);
-  pG->U[ix.k][ix.j][ix.i].M2 += dtodx3*(x3FD_kp1.Mx - x3FD_k.Mx);
-  pG->U[ix.k][ix.j][ix.i].M3 += dtodx3*(x3FD_kp1.My - x3FD_k.My);
+  UVAR(pG,ix.k,ix.j,ix.i,d)  += dtodx3*(x3FD_kp1.d  - x3FD_k.d );
+  UVAR(pG,ix.k,ix.j,ix.i,M1) += dtodx3*(x3FD_kp1.Mz - x3FD_k.Mz);
+  UVAR(pG,ix.k,ix.j,ix.i,M2) += dtodx3*(x3FD_kp1.Mx - x3FD_k.Mx);
+  UVAR(pG,ix.k,ix.j,ix.i,M3) += dtodx3*(x3FD_kp1.My - x3FD_k.My);
 #ifndef BAROTROPIC
-  pG->U[ix.k][ix.j][ix.i].E  += dtodx3*(x3FD_kp1.E  - x3FD_k.E );
+  UVAR(pG,ix.k,ix.j,ix.i,E)  += dtodx3*(x3FD_kp1.E  - x3FD_k.E );
 #endif /* BAROTROPIC */
 
 /* Use flux differences to correct cell-centered values at i-1 and i+1 */
   
   if (ix.i > pG->is) {
-    pG->U[ix.k][ix.j][ix.i-1].d  += dtodx1*(x1FD_i.d );
-    pG->U[ix.k][ix.j][ix.i-1].M1 += dtodx1*(x1FD_i.Mx);
-    pG->U[ix.k][ix.j][ix.i-1].M2 += dtodx1*(x1FD_i.My);
-    pG->U[ix.k][ix.j][ix.i-1].M3 += dtodx1*(x1FD_i.Mz);
+    UVAR(pG,ix.k,ix.j,ix.i-1,d)  += dtodx1*(x1FD_i.d );
+    UVAR(pG,ix.k,ix.j,ix.i-1,M1) += dtodx1*(x1FD_i.Mx);
+    UVAR(pG,ix.k,ix.j,ix.i-1,M2) += dtodx1*(x1FD_i.My);
+    UVAR(pG,ix.k,ix.j,ix.i-1,M3) += dtodx1*(x1FD_i.Mz);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j][ix.i-1].E  += dtodx1*(x1FD_i.E );
+    UVAR(pG,ix.k,ix.j,ix.i-1,E)  += dtodx1*(x1FD_i.E );
 #endif /* BAROTROPIC */
   }
   
   if (ix.i < pG->ie) {
-    pG->U[ix.k][ix.j][ix.i+1].d  -= dtodx1*(x1FD_ip1.d );
-    pG->U[ix.k][ix.j][ix.i+1].M1 -= dtodx1*(x1FD_ip1.Mx);
-    pG->U[ix.k][ix.j][ix.i+1].M2 -= dtodx1*(x1FD_ip1.My);
-    pG->U[ix.k][ix.j][ix.i+1].M3 -= dtodx1*(x1FD_ip1.Mz);
+    UVAR(pG,ix.k,ix.j,ix.i+1,d)  -= dtodx1*(x1FD_ip1.d );
+    UVAR(pG,ix.k,ix.j,ix.i+1,M1) -= dtodx1*(x1FD_ip1.Mx);
+    UVAR(pG,ix.k,ix.j,ix.i+1,M2) -= dtodx1*(x1FD_ip1.My);
+    UVAR(pG,ix.k,ix.j,ix.i+1,M3) -= dtodx1*(x1FD_ip1.Mz);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j][ix.i+1].E  -= dtodx1*(x1FD_ip1.E );
+    UVAR(pG,ix.k,ix.j,ix.i+1,E)  -= dtodx1*(x1FD_ip1.E );
 #endif /* BAROTROPIC */
   }
 
 /* Use flux differences to correct cell-centered values at j-1 and j+1 */
   
   if (ix.j > pG->js) {
-    pG->U[ix.k][ix.j-1][ix.i].d  += dtodx2*(x2FD_j.d );
-    pG->U[ix.k][ix.j-1][ix.i].M1 += dtodx2*(x2FD_j.Mz);
-    pG->U[ix.k][ix.j-1][ix.i].M2 += dtodx2*(x2FD_j.Mx);
-    pG->U[ix.k][ix.j-1][ix.i].M3 += dtodx2*(x2FD_j.My);
+    UVAR(pG,ix.k,ix.j-1,ix.i,d)  += dtodx2*(x2FD_j.d );
+    UVAR(pG,ix.k,ix.j-1,ix.i,M1) += dtodx2*(x2FD_j.Mz);
+    UVAR(pG,ix.k,ix.j-1,ix.i,M2) += dtodx2*(x2FD_j.Mx);
+    UVAR(pG,ix.k,ix.j-1,ix.i,M3) += dtodx2*(x2FD_j.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j-1][ix.i].E  += dtodx2*(x2FD_j.E );
+    UVAR(pG,ix.k,ix.j-1,ix.i,E)  += dtodx2*(x2FD_j.E );
 #endif /* BAROTROPIC */
   }
   
   if (ix.j < pG->je) {
-    pG->U[ix.k][ix.j+1][ix.i].d  -= dtodx2*(x2FD_jp1.d );
-    pG->U[ix.k][ix.j+1][ix.i].M1 -= dtodx2*(x2FD_jp1.Mz);
-    pG->U[ix.k][ix.j+1][ix.i].M2 -= dtodx2*(x2FD_jp1.Mx);
-    pG->U[ix.k][ix.j+1][ix.i].M3 -= dtodx2*(x2FD_jp1.My);
+    UVAR(pG,ix.k,ix.j+1,ix.i,d)  -= dtodx2*(x2FD_jp1.d );
+    UVAR(pG,ix.k,ix.j+1,ix.i,M1) -= dtodx2*(x2FD_jp1.Mz);
+    UVAR(pG,ix.k,ix.j+1,ix.i,M2) -= dtodx2*(x2FD_jp1.Mx);
+    UVAR(pG,ix.k,ix.j+1,ix.i,M3) -= dtodx2*(x2FD_jp1.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j+1][ix.i].E  -= dtodx2*(x2FD_jp1.E );
+    UVAR(pG,ix.k,ix.j+1,ix.i,E)  -= dtodx2*(x2FD_jp1.E );
 #endif /* BAROTROPIC */
   }
 
 /* Use flux differences to correct cell-centered values at k-1 and k+1 */
  
   if (ix.k > pG->ks) {
-    pG->U[ix.k-1][ix.j][ix.i].d  += dtodx3*(x3FD_k.d );
-    pG->U[ix.k-1][ix.j][ix.i].M1 += dtodx3*(x3FD_k.Mz);
-    pG->U[ix.k-1][ix.j][ix.i].M2 += dtodx3*(x3FD_k.Mx);
-    pG->U[ix.k-1][ix.j][ix.i].M3 += dtodx3*(x3FD_k.My);
+    UVAR(pG,ix.k-1,ix.j,ix.i,d)  += dtodx3*(x3FD_k.d );
+    UVAR(pG,ix.k-1,ix.j,ix.i,M1) += dtodx3*(x3FD_k.Mz);
+    UVAR(pG,ix.k-1,ix.j,ix.i,M2) += dtodx3*(x3FD_k.Mx);
+    UVAR(pG,ix.k-1,ix.j,ix.i,M3) += dtodx3*(x3FD_k.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k-1][ix.j][ix.i].E  += dtodx3*(x3FD_k.E );
+    UVAR(pG,ix.k-1,ix.j,ix.i,E)  += dtodx3*(x3FD_k.E );
 #endif /* BAROTROPIC */
   }
  
   if (ix.k < pG->ke) {
-    pG->U[ix.k+1][ix.j][ix.i].d  -= dtodx3*(x3FD_kp1.d );
-    pG->U[ix.k+1][ix.j][ix.i].M1 -= dtodx3*(x3FD_kp1.Mz);
-    pG->U[ix.k+1][ix.j][ix.i].M2 -= dtodx3*(x3FD_kp1.Mx);
-    pG->U[ix.k+1][ix.j][ix.i].M3 -= dtodx3*(x3FD_kp1.My);
+    UVAR(pG,ix.k+1,ix.j,ix.i,d)  -= dtodx3*(x3FD_kp1.d );
+    UVAR(pG,ix.k+1,ix.j,ix.i,M1) -= dtodx3*(x3FD_kp1.Mz);
+    UVAR(pG,ix.k+1,ix.j,ix.i,M2) -= dtodx3*(x3FD_kp1.Mx);
+    UVAR(pG,ix.k+1,ix.j,ix.i,M3) -= dtodx3*(x3FD_kp1.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k+1][ix.j][ix.i].E  -= dtodx3*(x3FD_kp1.E );
+    UVAR(pG,ix.k+1,ix.j,ix.i,E)  -= dtodx3*(x3FD_kp1.E );
 #endif /* BAROTROPIC */
   }
 
@@ -2417,9 +2417,9 @@ static void FixCell(GridS *pG, Int3Vect ix)
   for (k=(ix.k-1); k<=(ix.k+1); k++) {
   for (j=(ix.j-1); j<=(ix.j+1); j++) {
   for (i=(ix.i-1); i<=(ix.i+1); i++) {
-    pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
-    pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
-    pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+    UVAR(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+    UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+    UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
   }}}
 #endif /* MHD */
 
@@ -26,7 +26,10 @@
  *									        
  * PRIVATE FUNCTION PROTOTYPES:
  * - change_rundir() - creates and outputs data to new directory
- * - usage()         - outputs help message and terminates execution	      */
+ * - usage()         - outputs help message and terminates execution
+ * - integrate_level() - calls the integrator on all Grids at one level
+ * - advance_level() - advances a level and its children with subcycling
+ * - bvals_level()   - sets boundary values on all Grids at one level	      */
 /*============================================================================*/
 static char *athena_version = "version 4.0 - 01-Jul-2010";
 
@@ -45,15 +48,27 @@ static char *athena_version = "version 4.0 - 01-Jul-2010";
 #include "globals.h"
 #include "prototypes.h"
 #include "particles/prototypes.h"
+#ifdef OPENMP_PARALLEL
+#include <omp.h>
+#endif
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   change_rundir - creates and outputs data to new directory
  *   usage         - outputs help message and terminates execution
+ *   integrate_level - calls the integrator on all Grids at one level
+ *   advance_level - advances a level and its children with subcycling
+ *   bvals_level   - sets boundary values on all Grids at one level
  *============================================================================*/
 
 static void change_rundir(const char *name);
 static void usage(const char *prog);
+static void integrate_level(MeshS *pM, VDFun_t Integrate, const int nl);
+#ifdef STATIC_MESH_REFINEMENT
+static void advance_level(MeshS *pM, VDFun_t Integrate, const int nl,
+  const int isub);
+static void bvals_level(MeshS *pM, const int nl);
+#endif
 
 /* Maximum number of mkdir() and chdir() file operations that will be executed
  * at once in the change_rundir() function when running in parallel, passed to
@@ -96,6 +111,7 @@ int main(int argc, char *argv[])
   FILE *fp;               /* file pointer for data outputs */
   int nflag=0;            /* set to 1 if -n argument is given on command line */
   int i,nlim;             /* cycle index and limit */
+  int overlap;            /* set to 1 to overlap halo exchange with Integrate */
   Real tlim;              /* time limit (in code units) */
 
   int out_level, err_level, lazy; /* diagnostic output & error log levels */
@@ -119,8 +135,16 @@ int main(int argc, char *argv[])
   char *pc, *suffix, new_name[MAXLEN];
   int len, h, m, s, err, use_wtlim=0;
   double wtend;
+#ifdef OPENMP_PARALLEL
+/* Only the master thread makes MPI calls */
+  if(MPI_SUCCESS != MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &err))
+    ath_error("[main]: Error on calling MPI_Init_thread\n");
+  if(err < MPI_THREAD_FUNNELED)
+    ath_error("[main]: MPI library does not support MPI_THREAD_FUNNELED\n");
+#else
   if(MPI_SUCCESS != MPI_Init(&argc, &argv))
     ath_error("[main]: Error on calling MPI_Init\n");
+#endif
 #endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
@@ -332,15 +356,29 @@ int main(int argc, char *argv[])
   if(have_time > 0) /* current calendar time (UTC) is available */
     ath_pout(0,"Simulation started on %s\n",ctime(&start));
 
+/* Set the size of the thread team used by each MPI process.  Dynamic
+ * adjustment is disabled so threadprivate scratch arrays persist between
+ * parallel regions. */
+#ifdef OPENMP_PARALLEL
+  omp_set_dynamic(0);
+  omp_set_num_threads(par_geti_def("job","num_threads",omp_get_max_threads()));
+  ath_pout(0,"Using %d OpenMP threads per process\n",omp_get_max_threads());
+#endif
+
 /*--- Step 4. ----------------------------------------------------------------*/
 /* Initialize nested mesh hierarchy. */
 
-  init_mesh(&Mesh);
+  init_mesh(&Mesh, ires);
   init_grid(&Mesh);
 #ifdef PARTICLES
   init_particle(&Mesh);
 #endif
 
+/* Set FFTW planner flags and read FFTW wisdom before any plan is made */
+#ifdef FFT_ENABLED
+  ath_fft_init(rundir);
+#endif
+
 /*--- Step 5. ----------------------------------------------------------------*/
 /* Set initial conditions, either by reading from restart or calling problem
  * generator.  But first start by setting variables in <time> block (these
@@ -348,6 +386,11 @@ int main(int argc, char *argv[])
 
   CourNo = par_getd("time","cour_no");
   nlim = par_geti_def("time","nlim",-1);
+  overlap = par_geti_def("job","overlap_halo",0);
+#ifdef STATIC_MESH_REFINEMENT
+  if (overlap && Mesh.subcycle)
+    ath_error("[main]: <job>/overlap_halo cannot be used with subcycling\n");
+#endif
   tlim = par_getd("time","tlim");
 
 #ifdef ISOTHERMAL
@@ -380,6 +423,7 @@ int main(int argc, char *argv[])
 #ifdef STATIC_MESH_REFINEMENT
   SMR_init(&Mesh);
   RestrictCorrect(&Mesh);
+  AMR_init(&Mesh);
 #endif
 
 /* Initialize the first nstep value to flush the output and error logs. */
@@ -459,6 +503,9 @@ int main(int argc, char *argv[])
   }
   change_rundir(rundir); /* Change to run directory */
   ath_sig_init();        /* Install a signal handler */
+#ifdef FFT_ENABLED
+  ath_fft_save_wisdom(); /* Save FFTW wisdom of plans made during setup */
+#endif
   for (nl=1; nl<(Mesh.NLevels); nl++){
     sprintf(level_dir,"lev%d",nl);
     mkdir(level_dir, 0775); /* Create directories for levels > 0 */
@@ -540,27 +587,25 @@ int main(int argc, char *argv[])
 #endif /* Explicit diffusion */
 
 /*--- Step 9c. ---------------------------------------------------------------*/
-/* Loop over all Domains and call Integrator */
+/* Loop over all Domains and call Integrator.  With <time>/subcycle=1 the levels
+ * are instead advanced recursively, each with its own timestep, and each level
+ * is restricted to its parent after its two steps (see advance_level()) */
 
-    for (nl=0; nl<(Mesh.NLevels); nl++){ 
-      for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
-        if (Mesh.Domain[nl][nd].Grid != NULL){
-          (*Integrate)(&(Mesh.Domain[nl][nd]));
-#ifdef FARGO
-          Fargo(&(Mesh.Domain[nl][nd]));
-#ifdef PARTICLES
-          advect_particles(&(Mesh.Domain[nl][nd]));
-#endif
-#endif /* FARGO */
-        }
-      }
+#ifdef STATIC_MESH_REFINEMENT
+    if (Mesh.subcycle) {
+      advance_level(&Mesh, Integrate, 0, 0);
+    } else {
+      for (nl=0; nl<(Mesh.NLevels); nl++) integrate_level(&Mesh, Integrate, nl);
     }
+#else
+    for (nl=0; nl<(Mesh.NLevels); nl++) integrate_level(&Mesh, Integrate, nl);
+#endif
 
 /*--- Step 9d. ---------------------------------------------------------------*/
 /* With SMR, restrict solution from Child --> Parent grids  */
 
 #ifdef STATIC_MESH_REFINEMENT
-    RestrictCorrect(&Mesh);
+    if (!Mesh.subcycle) RestrictCorrect(&Mesh);
 #endif
 
 /*--- Step 9e. ---------------------------------------------------------------*/
@@ -601,12 +646,17 @@ int main(int argc, char *argv[])
 
 /*--- Step 9h. ---------------------------------------------------------------*/
 /* Boundary values must be set after time is updated for t-dependent BCs.
- * With SMR, ghost zones at internal fine/coarse boundaries set by Prolongate */
+ * With SMR, ghost zones at internal fine/coarse boundaries set by Prolongate
+ * With <job>/overlap_halo=1 the exchange is only started here, and completed
+ * by the integrator (or data_output) once the interior has been computed */
 
     for (nl=0; nl<(Mesh.NLevels); nl++){ 
       for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
         if (Mesh.Domain[nl][nd].Grid != NULL){
-          bvals_mhd(&(Mesh.Domain[nl][nd]));
+          if (overlap)
+            bvals_mhd_start(&(Mesh.Domain[nl][nd]));
+          else
+            bvals_mhd(&(Mesh.Domain[nl][nd]));
 #ifdef PARTICLES
           bvals_particle(&(Mesh.Domain[nl][nd]));
 #endif
@@ -616,6 +666,9 @@ int main(int argc, char *argv[])
 
 #ifdef STATIC_MESH_REFINEMENT
     Prolongate(&Mesh);
+
+/* With <amr>/interval > 0, move refined Domains to follow flagged zones */
+    Regrid(&Mesh);
 #endif
 
 /*--- Step 9i. ---------------------------------------------------------------*/
@@ -648,6 +701,16 @@ int main(int argc, char *argv[])
 /*--- Step 10. ---------------------------------------------------------------*/
 /* Finish up by computing zc/sec, dumping data, and deallocate memory */
 
+/* Complete any halo exchange left in flight by Step 9h */
+
+  for (nl=0; nl<(Mesh.NLevels); nl++){ 
+    for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
+      if (Mesh.Domain[nl][nd].Grid != NULL){
+        bvals_mhd_finish(&(Mesh.Domain[nl][nd]));
+      }
+    }
+  }
+
 /* Print diagnostic message as to why run terminated */
 
   if (Mesh.nstep == nlim)
@@ -831,6 +894,107 @@ void change_rundir(const char *name)
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void integrate_level(MeshS *pM, VDFun_t Integrate, const int nl)
+ *  \brief Calls the integrator on all Grids at level nl.  The wall time taken
+ *   by each Grid is its measured cost for load balancing (see init_mesh()) */
+
+static void integrate_level(MeshS *pM, VDFun_t Integrate, const int nl)
+{
+  int nd;
+#ifdef MPI_PARALLEL
+  double twork;
+#endif
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){  
+    if (pM->Domain[nl][nd].Grid != NULL){
+#ifdef MPI_PARALLEL
+      twork = MPI_Wtime();
+#endif
+      (*Integrate)(&(pM->Domain[nl][nd]));
+#ifdef FARGO
+      Fargo(&(pM->Domain[nl][nd]));
+#ifdef PARTICLES
+      advect_particles(&(pM->Domain[nl][nd]));
+#endif
+#endif /* FARGO */
+#ifdef MPI_PARALLEL
+      pM->Domain[nl][nd].Grid->wtime += MPI_Wtime() - twork;
+#endif
+    }
+  }
+
+  return;
+}
+
+#ifdef STATIC_MESH_REFINEMENT
+/*----------------------------------------------------------------------------*/
+/*! \fn static void advance_level(MeshS *pM, VDFun_t Integrate, const int nl,
+ *                               const int isub)
+ *  \brief Takes one step of the Grids at level nl, then (recursively) two
+ *   steps of level nl+1, then restricts level nl+1 to level nl and corrects
+ *   the fluxes on their boundaries.
+ *
+ *   isub=0,1 is which of the two steps per step of level nl-1 this is.  Ghost
+ *   zones of level nl must be set on entry.  They are set again after the
+ *   step, on fine/coarse boundaries by interpolating in time between the
+ *   solutions at level nl-1 before and after its step.  The fluxes of level nl
+ *   on those boundaries are averaged over its two steps. */
+
+static void advance_level(MeshS *pM, VDFun_t Integrate, const int nl,
+  const int isub)
+{
+  int nd,n;
+
+  if (nl < (pM->NLevels)-1) Prolongate_Save(pM, nl);
+
+  integrate_level(pM, Integrate, nl);
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL)
+      pM->Domain[nl][nd].Grid->time += pM->Domain[nl][nd].Grid->dt;
+  }
+
+/* Ghost zones at the new time are needed by the next step of this level, and
+ * by the prolongation into the children of this level */
+
+  bvals_level(pM, nl);
+  if (nl > 0) {
+    Prolongate_Level(pM, nl, 0.5*(isub+1));
+    Average_FineFlux(pM, nl, isub);
+  }
+  if (nl == (pM->NLevels)-1) return;
+
+/* Two steps of level nl+1, the first starting from ghost zones prolongated
+ * from the solution on this level at the start of its step */
+
+  Prolongate_Level(pM, nl+1, 0.0);
+  for (n=0; n<2; n++) advance_level(pM, Integrate, nl+1, n);
+
+/* Restriction changes zones of this level that may be ghost zones of its
+ * neighbours, so boundary values are set once more */
+
+  RestrictCorrect_Level(pM, nl);
+  bvals_level(pM, nl);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void bvals_level(MeshS *pM, const int nl)
+ *  \brief Sets boundary values on all Grids at level nl */
+
+static void bvals_level(MeshS *pM, const int nl)
+{
+  int nd;
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) bvals_mhd(&(pM->Domain[nl][nd]));
+  }
+
+  return;
+}
+#endif /* STATIC_MESH_REFINEMENT */
+
 /*----------------------------------------------------------------------------*/
 /*! \fn static void usage(const char *prog)
  *  \brief Outputs help
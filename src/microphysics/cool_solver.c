@@ -81,7 +81,7 @@ void cooling_solver(GridS *pG)
       for(i=is;i<=ie;i++){ 
         my_dt=pG->dt;
 
-        U=pG->U[k][j][i];
+        U=UGET(pG,k,j,i);
 
         t_old = U.E - (0.5/U.d)*(SQR(U.M1)+SQR(U.M2)+SQR(U.M3));
 #ifdef MHD
@@ -128,7 +128,7 @@ void cooling_solver(GridS *pG)
       for(i=is;i<=ie;i++){ 
         reset_dt:
 
-        U=pG->U[k][j][i];
+        U=UGET(pG,k,j,i);
 
         t_old = U.E - (0.5/U.d)*(SQR(U.M1)+SQR(U.M2)+SQR(U.M3));
 #ifdef MHD
@@ -171,12 +171,12 @@ void cooling_solver(GridS *pG)
         }
 
         temp=MAX(temp,Tmin)/unitT;
-        pG->U[k][j][i].E = temp*pG->U[k][j][i].d/Gamma_1;
-        pG->U[k][j][i].E += (0.5/pG->U[k][j][i].d)*
-             (SQR(pG->U[k][j][i].M1)+SQR(pG->U[k][j][i].M2)+SQR(pG->U[k][j][i].M3));
+        UVAR(pG,k,j,i,E) = temp*UVAR(pG,k,j,i,d)/Gamma_1;
+        UVAR(pG,k,j,i,E) += (0.5/UVAR(pG,k,j,i,d))*
+             (SQR(UVAR(pG,k,j,i,M1))+SQR(UVAR(pG,k,j,i,M2))+SQR(UVAR(pG,k,j,i,M3)));
 #ifdef MHD
-        pG->U[k][j][i].E += (0.5)*
-             (SQR(pG->U[k][j][i].B1c)+SQR(pG->U[k][j][i].B2c)+SQR(pG->U[k][j][i].B3c));
+        UVAR(pG,k,j,i,E) += (0.5)*
+             (SQR(UVAR(pG,k,j,i,B1c))+SQR(UVAR(pG,k,j,i,B2c))+SQR(UVAR(pG,k,j,i,B3c)));
 #endif
       }
     }
@@ -102,12 +102,12 @@ void eta_standard(GridS *pG, int i, int j, int k,
 
   if ((Q_Hall > 0.0) || (Q_AD > 0.0))
   {
-    Bsq  = SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-                                   + SQR(pG->U[k][j][i].B3c);
+    Bsq  = SQR(UVAR(pG,k,j,i,B1c)) + SQR(UVAR(pG,k,j,i,B2c))
+                                   + SQR(UVAR(pG,k,j,i,B3c));
     Bmag = sqrt(Bsq);
 
-    *eta_H = Q_Hall * Bmag / pow(pG->U[k][j][i].d, d_ind);
-    *eta_A = Q_AD * Bsq / pow(pG->U[k][j][i].d, 1.0+d_ind);
+    *eta_H = Q_Hall * Bmag / pow(UVAR(pG,k,j,i,d), d_ind);
+    *eta_A = Q_AD * Bsq / pow(UVAR(pG,k,j,i,d), 1.0+d_ind);
   }
 
   return;
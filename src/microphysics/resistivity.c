@@ -156,11 +156,11 @@ void resistivity(DomainS *pD)
   if (ndim == 1){
     for (i=is-3; i<=ie+4; i++) {
       J[ks][js][i].x1 = 0.0;
-      J[ks][js][i].x2 = -(pG->U[ks][js][i].B3c - pG->U[ks][js][i-1].B3c)/pG->dx1;
+      J[ks][js][i].x2 = -(UVAR(pG,ks,js,i,B3c) - UVAR(pG,ks,js,i-1,B3c))/pG->dx1;
 #ifdef CYLINDRICAL
       rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
 #endif
-      J[ks][js][i].x3 =  (rsf*pG->U[ks][js][i].B2c - lsf*pG->U[ks][js][i-1].B2c)/pG->dx1;
+      J[ks][js][i].x3 =  (rsf*UVAR(pG,ks,js,i,B2c) - lsf*UVAR(pG,ks,js,i-1,B2c))/pG->dx1;
     }
     J[ks][js][0].x1 = 0.0;
   }
@@ -172,8 +172,8 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
         dx2i = 1.0/(r[i]*pG->dx2);
 #endif
-        J[ks][j][i].x1=  dx2i*(pG->U[ks][j][i].B3c - pG->U[ks][j-1][i  ].B3c);
-        J[ks][j][i].x2= -dx1i*(pG->U[ks][j][i].B3c - pG->U[ks][j  ][i-1].B3c);
+        J[ks][j][i].x1=  dx2i*(UVAR(pG,ks,j,i,B3c) - UVAR(pG,ks,j-1,i,B3c));
+        J[ks][j][i].x2= -dx1i*(UVAR(pG,ks,j,i,B3c) - UVAR(pG,ks,j,i-1,B3c));
 #ifdef CYLINDRICAL
         rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
         dx2i = 1.0/(ri[i]*pG->dx2);
@@ -185,11 +185,11 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
       dx2i = 1.0/(r[i]*pG->dx2);
 #endif
-      J[ks][j][i].x1=  dx2i*(pG->U[ks][j][i].B3c - pG->U[ks][j-1][i  ].B3c);
+      J[ks][j][i].x1=  dx2i*(UVAR(pG,ks,j,i,B3c) - UVAR(pG,ks,j-1,i,B3c));
     }
     j = js-4;
     for (i=is-3; i<=ie+4; i++) {
-      J[ks][j][i].x2= -dx1i*(pG->U[ks][j][i].B3c - pG->U[ks][j  ][i-1].B3c);
+      J[ks][j][i].x2= -dx1i*(UVAR(pG,ks,j,i,B3c) - UVAR(pG,ks,j,i-1,B3c));
     }
   }
 
@@ -334,8 +334,8 @@ void resistivity(DomainS *pD)
       rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
 #endif
       EnerFlux[ks][js][i].x1 =
-         0.5*(rsf*pG->U[ks][js][i].B2c + lsf*pG->U[ks][js][i-1].B2c)*emf[ks][js][i].x3
-       - 0.5*(rsf*pG->U[ks][js][i].B3c + lsf*pG->U[ks][js][i-1].B3c)*emf[ks][js][i].x2;
+         0.5*(rsf*UVAR(pG,ks,js,i,B2c) + lsf*UVAR(pG,ks,js,i-1,B2c))*emf[ks][js][i].x3
+       - 0.5*(rsf*UVAR(pG,ks,js,i,B3c) + lsf*UVAR(pG,ks,js,i-1,B3c))*emf[ks][js][i].x2;
     }
   } 
       
@@ -346,9 +346,9 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
 #endif
-      EnerFlux[ks][j][i].x1 = 0.25*(rsf*pG->U[ks][j][i].B2c + lsf*pG->U[ks][j][i-1].B2c)*
+      EnerFlux[ks][j][i].x1 = 0.25*(rsf*UVAR(pG,ks,j,i,B2c) + lsf*UVAR(pG,ks,j,i-1,B2c))*
                             (emf[ks][j][i].x3 + emf[ks][j+1][i].x3)
-         - 0.5*(rsf*pG->U[ks][j][i].B3c + lsf*pG->U[ks][j][i-1].B3c)*emf[ks][j][i].x2;
+         - 0.5*(rsf*UVAR(pG,ks,j,i,B3c) + lsf*UVAR(pG,ks,j,i-1,B3c))*emf[ks][j][i].x2;
     }}
     
     for (j=js; j<=je+1; j++) {
@@ -357,12 +357,12 @@ void resistivity(DomainS *pD)
       rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
 #endif
       EnerFlux[ks][j][i].x2 =
-         0.5*(rsf*pG->U[ks][j][i].B3c + lsf*pG->U[ks][j-1][i].B3c)*emf[ks][j][i].x1;
+         0.5*(rsf*UVAR(pG,ks,j,i,B3c) + lsf*UVAR(pG,ks,j-1,i,B3c))*emf[ks][j][i].x1;
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
       EnerFlux[ks][j][i].x2 -=
-         0.25*(pG->U[ks][j][i].B1c + pG->U[ks][j-1][i].B1c)*
+         0.25*(UVAR(pG,ks,j,i,B1c) + UVAR(pG,ks,j-1,i,B1c))*
                 (lsf*emf[ks][j][i].x3 + rsf*emf[ks][j][i+1].x3);
     }}
   }   
@@ -375,9 +375,9 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
         rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
 #endif
-        EnerFlux[k][j][i].x1 = 0.25*(rsf*pG->U[k][j][i].B2c + lsf*pG->U[k][j][i-1].B2c)*
+        EnerFlux[k][j][i].x1 = 0.25*(rsf*UVAR(pG,k,j,i,B2c) + lsf*UVAR(pG,k,j,i-1,B2c))*
                              (emf[k][j][i].x3 + emf[k][j+1][i].x3)
-                            - 0.25*(rsf*pG->U[k][j][i].B3c + lsf*pG->U[k][j][i-1].B3c)*
+                            - 0.25*(rsf*UVAR(pG,k,j,i,B3c) + lsf*UVAR(pG,k,j,i-1,B3c))*
                              (emf[k][j][i].x2 + emf[k+1][j][i].x2);
       }
     }}
@@ -388,12 +388,12 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
         rsf = r[i]/ri[i];  lsf = r[i-1]/ri[i];
 #endif
-        EnerFlux[k][j][i].x2 = 0.25*(rsf*pG->U[k][j][i].B3c + lsf*pG->U[k][j-1][i].B3c)*
+        EnerFlux[k][j][i].x2 = 0.25*(rsf*UVAR(pG,k,j,i,B3c) + lsf*UVAR(pG,k,j-1,i,B3c))*
                              (emf[k][j][i].x1 + emf[k+1][j][i].x1);
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        EnerFlux[k][j][i].x2-= 0.25*(pG->U[k][j][i].B1c + pG->U[k][j-1][i].B1c)*
+        EnerFlux[k][j][i].x2-= 0.25*(UVAR(pG,k,j,i,B1c) + UVAR(pG,k,j-1,i,B1c))*
                              (lsf*emf[k][j][i].x3 + rsf*emf[k][j][i+1].x3);
       }
     }}
@@ -404,9 +404,9 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        EnerFlux[k][j][i].x3 = 0.25*(pG->U[k][j][i].B1c + pG->U[k-1][j][i].B1c)*
+        EnerFlux[k][j][i].x3 = 0.25*(UVAR(pG,k,j,i,B1c) + UVAR(pG,k-1,j,i,B1c))*
                              (lsf*emf[k][j][i].x2 + emf[k][j][i+1].x2)
-                            - 0.25*(pG->U[k][j][i].B2c + pG->U[k-1][j][i].B2c)*
+                            - 0.25*(UVAR(pG,k,j,i,B2c) + UVAR(pG,k-1,j,i,B2c))*
                              (lsf*emf[k][j][i].x1 + rsf*emf[k][j+1][i].x1);
       }
     }}
@@ -421,7 +421,7 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[k][j][i].E += dtodx1*(rsf*EnerFlux[k][j][i+1].x1 - lsf*EnerFlux[k][j][i].x1);
+      UVAR(pG,k,j,i,E) += dtodx1*(rsf*EnerFlux[k][j][i+1].x1 - lsf*EnerFlux[k][j][i].x1);
     }
   }}
 
@@ -434,7 +434,7 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
         dtodx2 = my_dt/(r[i]*pG->dx2);
 #endif
-        pG->U[k][j][i].E += dtodx2*(EnerFlux[k][j+1][i].x2 -EnerFlux[k][j][i].x2);
+        UVAR(pG,k,j,i,E) += dtodx2*(EnerFlux[k][j+1][i].x2 -EnerFlux[k][j][i].x2);
       }
     }}
   }
@@ -445,7 +445,7 @@ void resistivity(DomainS *pD)
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].E += dtodx3*(EnerFlux[k+1][j][i].x3 -EnerFlux[k][j][i].x3);
+        UVAR(pG,k,j,i,E) += dtodx3*(EnerFlux[k+1][j][i].x3 -EnerFlux[k][j][i].x3);
       }
     }}
   }
@@ -461,11 +461,11 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][js][i].B2c += dtodx1*(    emf[ks][js][i+1].x3 -     emf[ks][js][i].x3);
-      pG->U[ks][js][i].B3c -= dtodx1*(rsf*emf[ks][js][i+1].x2 - lsf*emf[ks][js][i].x2);
+      UVAR(pG,ks,js,i,B2c) += dtodx1*(    emf[ks][js][i+1].x3 -     emf[ks][js][i].x3);
+      UVAR(pG,ks,js,i,B3c) -= dtodx1*(rsf*emf[ks][js][i+1].x2 - lsf*emf[ks][js][i].x2);
 /* For consistency, set B2i and B3i to cell-centered values. */
-      pG->B2i[ks][js][i] = pG->U[ks][js][i].B2c;
-      pG->B3i[ks][js][i] = pG->U[ks][js][i].B3c;
+      pG->B2i[ks][js][i] = UVAR(pG,ks,js,i,B2c);
+      pG->B3i[ks][js][i] = UVAR(pG,ks,js,i,B3c);
     }
   }
 
@@ -483,7 +483,7 @@ void resistivity(DomainS *pD)
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
         dtodx2 = my_dt/(r[i]*pG->dx2);
 #endif
-        pG->U[ks][j][i].B3c += dtodx2*(    emf[ks][j+1][i  ].x1 -     emf[ks][j][i].x1) -
+        UVAR(pG,ks,j,i,B3c) += dtodx2*(    emf[ks][j+1][i  ].x1 -     emf[ks][j][i].x1) -
                                dtodx1*(rsf*emf[ks][j  ][i+1].x2 - lsf*emf[ks][j][i].x2);
       }
 #ifdef CYLINDRICAL
@@ -500,10 +500,10 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[ks][j][i].B1c = 0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
-        pG->U[ks][j][i].B2c = 0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
+        UVAR(pG,ks,j,i,B1c) = 0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
+        UVAR(pG,ks,j,i,B2c) = 0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
 /* Set the 3-interface magnetic field equal to the cell center field. */
-        pG->B3i[ks][j][i] = pG->U[ks][j][i].B3c;
+        pG->B3i[ks][j][i] = UVAR(pG,ks,j,i,B3c);
       }
     }
   }
@@ -557,9 +557,9 @@ void resistivity(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-      pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-      pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+      UVAR(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+      UVAR(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+      UVAR(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
     }}}
   }
 
@@ -708,8 +708,8 @@ void EField_Hall(DomainS *pD)
   for (j=jl; j<=ju; j++) {
   for (i=il; i<=iu; i++) {
 
-      Bmag = sqrt(SQR(pG->U[k][j][i].B1c)
-                + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+      Bmag = sqrt(SQR(UVAR(pG,k,j,i,B1c))
+                + SQR(UVAR(pG,k,j,i,B2c)) + SQR(UVAR(pG,k,j,i,B3c)));
 
       pG->eta_Hall[k][j][i] /= Bmag+TINY_NUMBER;
   }}}
@@ -1104,8 +1104,8 @@ void EField_AD(DomainS *pD)
       eta_A = 0.5*(rsf*pG->eta_AD[ks][js][i] + lsf*pG->eta_AD[ks][js][i-1]);
 
       intBx = pG->B1i[ks][js][i];
-      intBy = 0.5*(rsf*pG->U[ks][js][i].B2c + lsf*pG->U[ks][js][i-1].B2c);
-      intBz = 0.5*(rsf*pG->U[ks][js][i].B3c + lsf*pG->U[ks][js][i-1].B3c);
+      intBy = 0.5*(rsf*UVAR(pG,ks,js,i,B2c) + lsf*UVAR(pG,ks,js,i-1,B2c));
+      intBz = 0.5*(rsf*UVAR(pG,ks,js,i,B3c) + lsf*UVAR(pG,ks,js,i-1,B3c));
 
       Bsq = SQR(intBx) + SQR(intBy) + SQR(intBz) + TINY_NUMBER;
       JdotB = J[ks][js][i].x2*intBy + J[ks][js][i].x3*intBz;
@@ -1135,9 +1135,9 @@ void EField_AD(DomainS *pD)
                   + lsf*J[ks][j-1][i].x2 + rsf*J[ks][j-1][i+1].x2);
       intJz = 0.5 *(lsf*J[ks][j][i].x3   + rsf*J[ks][j][i+1].x3);
 
-      intBx = 0.5*(pG->U[ks][j][i].B1c + pG->U[ks][j-1][i].B1c);
+      intBx = 0.5*(UVAR(pG,ks,j,i,B1c) + UVAR(pG,ks,j-1,i,B1c));
       intBy = pG->B2i[ks][j][i];
-      intBz = 0.5*(pG->U[ks][j][i].B3c + pG->U[ks][j-1][i].B3c);
+      intBz = 0.5*(UVAR(pG,ks,j,i,B3c) + UVAR(pG,ks,j-1,i,B3c));
 
       Bsq = SQR(intBx) + SQR(intBy) + SQR(intBz) + TINY_NUMBER;
       JdotB = intJx*intBx + intJy*intBy + intJz*intBz;
@@ -1156,8 +1156,8 @@ void EField_AD(DomainS *pD)
       intJz = 0.5 *(    J[ks][j][i].x3   +     J[ks][j+1][i].x3);
 
       intBx = pG->B1i[ks][j][i];
-      intBy = 0.5*(rsf*pG->U[ks][j][i].B2c + lsf*pG->U[ks][j][i-1].B2c);
-      intBz = 0.5*(lsf*pG->U[ks][j][i].B3c + lsf*pG->U[ks][j][i-1].B3c);
+      intBy = 0.5*(rsf*UVAR(pG,ks,j,i,B2c) + lsf*UVAR(pG,ks,j,i-1,B2c));
+      intBz = 0.5*(lsf*UVAR(pG,ks,j,i,B3c) + lsf*UVAR(pG,ks,j,i-1,B3c));
 
       Bsq = SQR(intBx) + SQR(intBy) + SQR(intBz) + TINY_NUMBER;
       JdotB = intJx*intBx + intJy*intBy + intJz*intBz;
@@ -1177,8 +1177,8 @@ void EField_AD(DomainS *pD)
 
       intBx = 0.5*(    pG->B1i[ks][j][i] +     pG->B1i[ks][j-1][i]);
       intBy = 0.5*(rsf*pG->B2i[ks][j][i] + lsf*pG->B2i[ks][j][i-1]);
-      intBz = 0.25*(rsf*pG->U[ks][j  ][i].B3c + rsf*pG->U[ks][j  ][i-1].B3c
-                  + lsf*pG->U[ks][j-1][i].B3c + lsf*pG->U[ks][j-1][i-1].B3c);
+      intBz = 0.25*(rsf*UVAR(pG,ks,j,i,B3c) + rsf*UVAR(pG,ks,j,i-1,B3c)
+                  + lsf*UVAR(pG,ks,j-1,i,B3c) + lsf*UVAR(pG,ks,j-1,i-1,B3c));
 
       Bsq = SQR(intBx) + SQR(intBy) + SQR(intBz) + TINY_NUMBER;
       JdotB = intJx*intBx + intJy*intBy + intJz*intBz;
@@ -1210,8 +1210,8 @@ void EField_AD(DomainS *pD)
         intJz = 0.25*(lsf*J[k  ][j][i].x3 + rsf*J[k  ][j][i+1].x3
                     + lsf*J[k-1][j][i].x3 + rsf*J[k-1][j][i+1].x3);
 
-        intBx = 0.25*(pG->U[k][j  ][i].B1c + pG->U[k-1][j  ][i].B1c +
-                      pG->U[k][j-1][i].B1c + pG->U[k-1][j-1][i].B1c);
+        intBx = 0.25*(UVAR(pG,k,j,i,B1c) + UVAR(pG,k-1,j,i,B1c) +
+                      UVAR(pG,k,j-1,i,B1c) + UVAR(pG,k-1,j-1,i,B1c));
         intBy = 0.5*(pG->B2i[k][j][i] + pG->B2i[k-1][j][i]);
         intBz = 0.5*(pG->B3i[k][j][i] + pG->B3i[k][j-1][i]);
 
@@ -1234,8 +1234,8 @@ void EField_AD(DomainS *pD)
                     +     J[k-1][j][i].x3 +     J[k-1][j+1][i].x3);
 
         intBx = 0.5*(    pG->B1i[k][j][i] +     pG->B1i[k-1][j][i]);
-        intBy = 0.25*(rsf*pG->U[k][j][i  ].B2c + rsf*pG->U[k-1][j][i  ].B2c +
-                      lsf*pG->U[k][j][i-1].B2c + lsf*pG->U[k-1][j][i-1].B2c);
+        intBy = 0.25*(rsf*UVAR(pG,k,j,i,B2c) + rsf*UVAR(pG,k-1,j,i,B2c) +
+                      lsf*UVAR(pG,k,j,i-1,B2c) + lsf*UVAR(pG,k-1,j,i-1,B2c));
         intBz = 0.5*(rsf*pG->B3i[k][j][i] + lsf*pG->B3i[k][j][i-1]);
 
         Bsq = SQR(intBx) + SQR(intBy) + SQR(intBz) + TINY_NUMBER;
@@ -1258,8 +1258,8 @@ void EField_AD(DomainS *pD)
 
         intBx = 0.5*(    pG->B1i[k][j][i] +     pG->B1i[k][j-1][i]);
         intBy = 0.5*(rsf*pG->B2i[k][j][i] + lsf*pG->B2i[k][j][i-1]);
-        intBz = 0.25*(rsf*pG->U[k][j  ][i].B3c + rsf*pG->U[k][j  ][i-1].B3c +
-                      lsf*pG->U[k][j-1][i].B3c + lsf*pG->U[k][j-1][i-1].B3c);
+        intBz = 0.25*(rsf*UVAR(pG,k,j,i,B3c) + rsf*UVAR(pG,k,j,i-1,B3c) +
+                      lsf*UVAR(pG,k,j-1,i,B3c) + lsf*UVAR(pG,k,j-1,i-1,B3c));
 
         Bsq = SQR(intBx) + SQR(intBy) + SQR(intBz) + TINY_NUMBER;
         JdotB = intJx*intBx + intJy*intBy + intJz*intBz;
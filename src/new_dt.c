@@ -64,7 +64,7 @@ void new_dt(MeshS *pM)
 #endif
 #endif
   int nl,nd;
-  Real max_v1=0.0,max_v2=0.0,max_v3=0.0,max_dti = 0.0;
+  Real max_v1=0.0,max_v2=0.0,max_v3=0.0,max_dti = 0.0,lfac;
   Real tlim,old_dt;
 #ifdef CYLINDRICAL
   Real x1,x2,x3;
@@ -86,25 +86,25 @@ void new_dt(MeshS *pM)
     for (k=pGrid->ks; k<=pGrid->ke; k++) {
     for (j=pGrid->js; j<=pGrid->je; j++) {
       for (i=pGrid->is; i<=pGrid->ie; i++) {
-        di = 1.0/(pGrid->U[k][j][i].d);
-        v1 = pGrid->U[k][j][i].M1*di;
-        v2 = pGrid->U[k][j][i].M2*di;
-        v3 = pGrid->U[k][j][i].M3*di;
+        di = 1.0/(UVAR(pGrid,k,j,i,d));
+        v1 = UVAR(pGrid,k,j,i,M1)*di;
+        v2 = UVAR(pGrid,k,j,i,M2)*di;
+        v3 = UVAR(pGrid,k,j,i,M3)*di;
         qsq = v1*v1 + v2*v2 + v3*v3;
 
 #ifdef MHD
 
 /* Use maximum of face-centered fields (always larger than cell-centered B) */
-        b1 = pGrid->U[k][j][i].B1c 
-          + fabs((double)(pGrid->B1i[k][j][i] - pGrid->U[k][j][i].B1c));
-        b2 = pGrid->U[k][j][i].B2c 
-          + fabs((double)(pGrid->B2i[k][j][i] - pGrid->U[k][j][i].B2c));
-        b3 = pGrid->U[k][j][i].B3c 
-          + fabs((double)(pGrid->B3i[k][j][i] - pGrid->U[k][j][i].B3c));
+        b1 = UVAR(pGrid,k,j,i,B1c) 
+          + fabs((double)(pGrid->B1i[k][j][i] - UVAR(pGrid,k,j,i,B1c)));
+        b2 = UVAR(pGrid,k,j,i,B2c) 
+          + fabs((double)(pGrid->B2i[k][j][i] - UVAR(pGrid,k,j,i,B2c)));
+        b3 = UVAR(pGrid,k,j,i,B3c) 
+          + fabs((double)(pGrid->B3i[k][j][i] - UVAR(pGrid,k,j,i,B3c)));
         bsq = b1*b1 + b2*b2 + b3*b3;
 /* compute sound speed squared */
 #ifdef ADIABATIC
-        p = MAX(Gamma_1*(pGrid->U[k][j][i].E - 0.5*pGrid->U[k][j][i].d*qsq
+        p = MAX(Gamma_1*(UVAR(pGrid,k,j,i,E) - 0.5*UVAR(pGrid,k,j,i,d)*qsq
                 - 0.5*bsq), TINY_NUMBER);
         asq = Gamma*p*di;
 #elif defined ISOTHERMAL
@@ -122,7 +122,7 @@ void new_dt(MeshS *pM)
 
 /* compute sound speed squared */
 #ifdef ADIABATIC
-        p = MAX(Gamma_1*(pGrid->U[k][j][i].E - 0.5*pGrid->U[k][j][i].d*qsq),
+        p = MAX(Gamma_1*(UVAR(pGrid,k,j,i,E) - 0.5*UVAR(pGrid,k,j,i,d)*qsq),
                 TINY_NUMBER);
         asq = Gamma*p*di;
 #elif defined ISOTHERMAL
@@ -165,13 +165,19 @@ void new_dt(MeshS *pM)
     }
 #endif /* PARTICLES */
 
-/* compute maximum inverse of dt (corresponding to minimum dt) */
+/* compute maximum inverse of dt (corresponding to minimum dt).  With
+ * subcycling, level nl takes 2^nl steps per step of the Mesh, so it limits
+ * the Mesh timestep 2^nl times less. */
+    lfac = 1.0;
+#ifdef STATIC_MESH_REFINEMENT
+    if (pM->subcycle) lfac = 1.0/(Real)(1<<nl);
+#endif
     if (pGrid->Nx[0] > 1)
-      max_dti = MAX(max_dti, max_v1/pGrid->dx1);
+      max_dti = MAX(max_dti, lfac*max_v1/pGrid->dx1);
     if (pGrid->Nx[1] > 1)
-      max_dti = MAX(max_dti, max_v2/pGrid->dx2);
+      max_dti = MAX(max_dti, lfac*max_v2/pGrid->dx2);
     if (pGrid->Nx[2] > 1)
-      max_dti = MAX(max_dti, max_v3/pGrid->dx3);
+      max_dti = MAX(max_dti, lfac*max_v3/pGrid->dx3);
 
   }}} /*--- End loop over Domains --------------------------------------------*/
 
@@ -234,12 +240,16 @@ void new_dt(MeshS *pM)
 
 #endif /* Explicit Diffusion */
 
-/* Spread timestep across all Grid structures in all Domains */
+/* Spread timestep across all Grid structures in all Domains.  With
+ * subcycling, Grids at level nl take steps of dt/2^nl */
 
   for (nl=0; nl<=(pM->NLevels)-1; nl++){
     for (nd=0; nd<=(pM->DomainsPerLevel[nl])-1; nd++){
       if (pM->Domain[nl][nd].Grid != NULL) {
         pM->Domain[nl][nd].Grid->dt = pM->dt;
+#ifdef STATIC_MESH_REFINEMENT
+        if (pM->subcycle) pM->Domain[nl][nd].Grid->dt = pM->dt/(Real)(1<<nl);
+#endif
       }
     }
   }
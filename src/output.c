@@ -484,7 +484,7 @@ void data_output(MeshS *pM, const int flag)
   GridS *pG = pD->Grid;
   PropFun_t mypar_prop = NULL;
 #endif
-  int n;
+  int n,nl,nd,ndump=0;
   int dump_flag[MAXOUT_DEFAULT+1];
   char block[80];
 
@@ -497,6 +497,20 @@ void data_output(MeshS *pM, const int flag)
       OutArray[n].t += OutArray[n].dt;
       dump_flag[n] = 1;
     }
+    ndump += dump_flag[n];
+  }
+  if (rst_flag && (flag != 0 || pM->time >= rst_out.t)) ndump++;
+
+/* Ghost zones must be complete before anything is written, so finish any
+ * halo exchange started by bvals_mhd_start() in the main loop */
+
+  if (ndump > 0) {
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (pM->Domain[nl][nd].Grid != NULL)
+          bvals_mhd_finish(&(pM->Domain[nl][nd]));
+      }
+    }
   }
 
 /* Now check for restart dump, and make restart if dump_flag != 0 */
@@ -1102,28 +1116,28 @@ Real *OutData1(GridS *pgrid, OutputS *pout, int *Nx1)
 /*! \fn Real expr_d(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Density */
 Real expr_d(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].d;
+  return UVAR(pG,k,j,i,d);
 }
 /*! \fn Real expr_M1(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 1-component of momentum */ 
 Real expr_M1(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M1;
+  return UVAR(pG,k,j,i,M1);
 }
 /*! \fn Real expr_M2(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 2-component of momentum */
 Real expr_M2(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M2;
+  return UVAR(pG,k,j,i,M2);
 }
 /*! \fn Real expr_M3(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 3-component of momentum */
 Real expr_M3(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M3;
+  return UVAR(pG,k,j,i,M3);
 }
 #ifndef BAROTROPIC
 /*! \fn Real expr_E(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Total energy */
 Real expr_E(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].E;
+  return UVAR(pG,k,j,i,E);
 }
 #endif
 
@@ -1134,24 +1148,24 @@ Real expr_E(const GridS *pG, const int i, const int j, const int k) {
 /*! \fn Real expr_B1c(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 1-component of cell-centered B-field */
 Real expr_B1c(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].B1c;
+  return UVAR(pG,k,j,i,B1c);
 }
 /*! \fn Real expr_B2c(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 2-component of cell-centered B-field */
 Real expr_B2c(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].B2c;
+  return UVAR(pG,k,j,i,B2c);
 }
 /*! \fn Real expr_B3c(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 3-component of cell-centered B-field */
 Real expr_B3c(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].B3c;
+  return UVAR(pG,k,j,i,B3c);
 }
 /*! \fn Real expr_ME(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Magnetic field energy */
 Real expr_ME(const GridS *pG, const int i, const int j, const int k) {
-  return 0.5*(pG->U[k][j][i].B1c*pG->U[k][j][i].B1c + 
-	      pG->U[k][j][i].B2c*pG->U[k][j][i].B2c + 
-	      pG->U[k][j][i].B3c*pG->U[k][j][i].B3c);
+  return 0.5*(UVAR(pG,k,j,i,B1c)*UVAR(pG,k,j,i,B1c) + 
+	      UVAR(pG,k,j,i,B2c)*UVAR(pG,k,j,i,B2c) + 
+	      UVAR(pG,k,j,i,B3c)*UVAR(pG,k,j,i,B3c));
 }
 #endif
 
@@ -1161,26 +1175,26 @@ Real expr_ME(const GridS *pG, const int i, const int j, const int k) {
 /*! \fn Real expr_V1(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 1-velocity */
 Real expr_V1(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M1/pG->U[k][j][i].d;
+  return UVAR(pG,k,j,i,M1)/UVAR(pG,k,j,i,d);
 }
 /*! \fn Real expr_V2(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 2-velocity */
 Real expr_V2(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M2/pG->U[k][j][i].d;
+  return UVAR(pG,k,j,i,M2)/UVAR(pG,k,j,i,d);
 }
 /*! \fn Real expr_V3(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 3-velocity */
 Real expr_V3(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  return UVAR(pG,k,j,i,M3)/UVAR(pG,k,j,i,d);
 }
 
 /*! \fn Real expr_P(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Pressure */
 Real expr_P(const GridS *pG, const int i, const int j, const int k) {
 #ifdef ISOTHERMAL
-  return  pG->U[k][j][i].d*Iso_csound2;
+  return  UVAR(pG,k,j,i,d)*Iso_csound2;
 #else
-  ConsS *gp = &(pG->U[k][j][i]);
+  const ConsS *gp = UPTR(pG,k,j,i);
   return Gamma_1*(gp->E 
 #ifdef MHD
 		  - 0.5*(gp->B1c*gp->B1c + gp->B2c*gp->B2c + gp->B3c*gp->B3c)
@@ -1196,7 +1210,7 @@ Real expr_P(const GridS *pG, const int i, const int j, const int k) {
 #ifdef ADIABATIC
 Real expr_cs2(const GridS *pG, const int i, const int j, const int k)
 {
-  ConsS *gp = &(pG->U[k][j][i]);
+  const ConsS *gp = UPTR(pG,k,j,i);
   return (Gamma*Gamma_1*(gp->E 
 #ifdef MHD
 	  - 0.5*(gp->B1c*gp->B1c + gp->B2c*gp->B2c + gp->B3c*gp->B3c)
@@ -1212,7 +1226,7 @@ Real expr_cs2(const GridS *pG, const int i, const int j, const int k)
 #ifdef ADIABATIC
 Real expr_S(const GridS *pG, const int i, const int j, const int k)
 {
-  ConsS *gp = &(pG->U[k][j][i]);
+  const ConsS *gp = UPTR(pG,k,j,i);
   Real P = Gamma_1*(gp->E 
 #ifdef MHD
 		   - 0.5*(gp->B1c*gp->B1c + gp->B2c*gp->B2c + gp->B3c*gp->B3c)
@@ -1230,7 +1244,7 @@ Real expr_S(const GridS *pG, const int i, const int j, const int k)
 Real expr_G(const GridS *pG, const int i, const int j, const int k)
 {
   PrimS W;
-  W = Cons_to_Prim(&(pG->U[k][j][i]));
+  W = Cons_to_Prim(UPTR(pG,k,j,i));
   return 1.0/sqrt(1.0 - (SQR(W.V1)+SQR(W.V2)+SQR(W.V3)));
 }
 #endif /* SPECIAL_RELATIVITY */
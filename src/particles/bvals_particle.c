@@ -3,15 +3,20 @@
 /*! \file bvals_particle.c
  *  \brief Sets boundary conditions for particles. 
  *
- * PURPOSE: Sets boundary conditions for particles. The basic algorithm is
- *   similar to the MHD boundary conditions. In setting B.C., particles are
- *   always packed to the send buffer (for both MPI and non-MPI cases), then
- *   unpacked with certain shifts in position or velocity. In the case of MPI,
- *   two communications are needed for sending and receiving particle, first on
- *   the number of particles to be sent/received, then to send/receive real
- *   data. The shearing box B.C. is first treated as periodic B.C., then move
- *   the particles in the ghost cells accordingly. Advection of particles when
- *   FARGO is turned on is also included.
+ * PURPOSE: Sets boundary conditions for particles. Physical (reflecting,
+ *   outflow or user-defined) boundaries are applied first, in the order
+ *   x1-x2-x3: the particles are packed to the send buffer, then unpacked with
+ *   certain shifts in position or velocity.  All MPI and periodic boundaries,
+ *   including the shearing box B.C., are then set in a single pass.  Every
+ *   crossing particle is routed directly to the Grid that owns it, which can
+ *   be any of the 26 neighbours or, across the shearing x1 boundaries, the
+ *   Grid found from the sheared y position.  The particles for all
+ *   destinations are counted first and packed into segments of one send
+ *   buffer.  With MPI the counts are exchanged with all neighbours at once,
+ *   followed by one round of messages of exactly that size.  Ghost particles
+ *   in the nbc boundary layers are sent in the same pass.  Advection of
+ *   particles when FARGO is turned on is also included, and exchanges the
+ *   particles in the same way.
  * 
  * CONTAINS PUBLIC FUNCTIONS:
  * - set_bvals_particle()
@@ -21,18 +26,21 @@
  * - set_bvals_particle_destruct()
  *
  * PRIVATE FUNCTION PROTOTYPES:
- * - realloc_???()            - reallocate send/recv buffer
+ * - fit_buffer()             - size send/recv buffer from recent exchanges
+ * - realloc_sendbuf()        - enlarge the send buffer
  * - update_particle_status() - reset particle status (either ghost or grid)
  * - reflect_???_particle()   - apply reflecting BCs at boundary ???
  * - outflow_particle()       - apply outflow BCs at boundary ???
- * - periodic_???_particle()  - apply periodic BCs at boundary ???
+ * - periodic_particle()      - mark a periodic boundary
+ * - add_nbr()                - add a Grid to the exchange partners
+ * - route_pass()             - count or pack the particles to be exchanged
+ * - route_particle()         - map a particle to its destination Grid
  * - packing_???_particle()   - pack particles at boundary ???
- * - shift_packed_particle()  - shift packed particle (v or x) by certain amount
  * - unpack_particle()        - upack received particles
- * - shearingbox_???_particle()-shearing box BC at boundary ???
- * - packing_???_particle_shear()- pack particles for shearing box BC
- * - packing_particle_fargo() - pack particles for FARGO
- * - gridshift()              - calculate shift in grid in y for FARGO
+ * - shear_nbrs()             - exchange partners across shearing boundaries
+ * - shear_overlap()          - overlap of a sheared y range with a Grid
+ * - shear_row()              - shear a particle in y and find its Grid
+ * - fargo_slot()             - find the Grid of a particle advected by FARGO
  *
  *============================================================================*/
 #include <stdio.h>
@@ -62,14 +70,32 @@ static double *send_buf = NULL, *recv_buf = NULL;
 static long NBUF;	 /* buffer size unit (in number of particle) */
 static long send_bufsize;/* size of the send buffer (in unit of particles) */
 static long recv_bufsize;/* size of the recv buffer (in unit of particles) */
+static long send_peak;	 /* decaying peak of the particles sent */
+static long recv_peak;	 /* decaying peak of the particles received */
 static int  nbc;	 /* number of boundary layers for particle BC */
 
+/* Grids exchanging particles with this one: the neighbours at offsets in
+ * {-1,0,1} in each direction, then the Grids across the shearing x1
+ * boundaries.  Each is listed once, by processor id; nbr_self is this Grid.
+ */
+#define MAXNBR 64
+static int nnbr, nnbr_fix, nbr_self;
+static int nbr_id[MAXNBR];
+static long nbr_cnt[MAXNBR], nbr_off[MAXNBR];/* particles sent, and offsets */
+static long rcv_cnt[MAXNBR], rcv_off[MAXNBR];/* particles recv'd, and offsets*/
+/* 1 if particles cross boundary [dir][0: inner, 1: outer] by the exchange
+ * (MPI or periodic B.C.), 0 for physical B.C. */
+static int xchg[3][2];
+
 /* processor indices in the computational domain */
 static int my_iproc, my_jproc, my_kproc;
 /* min and max coordinate limits of the computational domain */
 static Real x1min,x1max,x2min,x2max,x3min,x3max;
 static Real Lx1, Lx2, Lx3;/* domain size in x1, x2, x3 direction */
 static Real TShuffle;	  /* number of time steps for resorting particles */
+#ifdef SHEARING_BOX
+static Real yshift;	  /* amount the domain has sheared in y, mod Lx2 */
+#endif
 
 /* boundary condition function pointers. local to this function  */
 static VGFun_t apply_ix1 = NULL, apply_ox1 = NULL;
@@ -78,22 +104,25 @@ static VGFun_t apply_ix3 = NULL, apply_ox3 = NULL;
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
- *   realloc_???()            - reallocate send/recv buffer
+ *   fit_buffer()             - size send/recv buffer from recent exchanges
+ *   realloc_sendbuf()        - enlarge the send buffer
  *   update_particle_status() - reset particle status (either ghost or grid)
  *   reflect_???_particle()   - apply reflecting BCs at boundary ???
  *   outflow_particle()       - apply outflow BCs at boundary ???
- *   periodic_???_particle()  - apply periodic BCs at boundary ???
+ *   periodic_particle()      - mark a periodic boundary
+ *   add_nbr()                - add a Grid to the exchange partners
+ *   route_pass()             - count or pack the particles to be exchanged
+ *   route_particle()         - map a particle to its destination Grid
  *   packing_???_particle()   - pack particles at boundary ???
- *   shift_packed_particle()  - shift packed particle (v or x) by certain amount
  *   unpack_particle()        - upack received particles
- *   shearingbox_???_particle()-shearing box BC at boundary ???
- *   packing_???_particle_shear()- pack particles for shearing box BC
- *   packing_particle_fargo() - pack particles for FARGO
- *   gridshift()              - calculate shift in grid in y for FARGO
+ *   shear_nbrs()             - exchange partners across shearing boundaries
+ *   shear_overlap()          - overlap of a sheared y range with a Grid
+ *   shear_row()              - shear a particle in y and find its Grid
+ *   fargo_slot()             - find the Grid of a particle advected by FARGO
  *============================================================================*/
 
+static void fit_buffer(double **buf, long *size, long *peak, long n);
 static void realloc_sendbuf();
-static void realloc_recvbuf(long newsize);
 
 static void update_particle_status(GridS *pG);
 
@@ -105,13 +134,11 @@ static void reflect_ix3_particle(GridS *pG);
 static void reflect_ox3_particle(GridS *pG);
 
 static void outflow_particle(GridS *pG);
+static void periodic_particle(GridS *pG);
 
-static void periodic_ix1_particle(GridS *pG);
-static void periodic_ox1_particle(GridS *pG);
-static void periodic_ix2_particle(GridS *pG);
-static void periodic_ox2_particle(GridS *pG);
-static void periodic_ix3_particle(GridS *pG);
-static void periodic_ox3_particle(GridS *pG);
+static int add_nbr(int id);
+static void route_pass(GridS *pG, DomainS *pD, int pack);
+static int route_particle(GridS *pG, DomainS *pD, const int *d, GrainS *gr);
 
 static long packing_ix1_particle(GridS *pG, int nlayer);
 static long packing_ox1_particle(GridS *pG, int nlayer);
@@ -120,20 +147,19 @@ static long packing_ox2_particle(GridS *pG, int nlayer);
 static long packing_ix3_particle(GridS *pG, int nlayer);
 static long packing_ox3_particle(GridS *pG, int nlayer);
 static void packing_one_particle(GrainS *gr, long n, short pos);
-static void shift_packed_particle(double *buf, long n, int index, double shift);
 static void unpack_particle(GridS *pG, double *buf, long n);
 
 #ifdef SHEARING_BOX
-static void shearingbox_ix1_particle(GridS *pG, DomainS *pD, long numpar);
-static void shearingbox_ox1_particle(GridS *pG, DomainS *pD, long numpar);
+static void shear_nbrs(GridS *pG, DomainS *pD);
+static int shear_overlap(Real a0, Real a1, Real b0, Real b1,
+                         Real shift, Real dy);
+static int shear_row(GridS *pG, DomainS *pD, int k, int i,
+                     Real shift, GrainS *gr);
 
-static long packing_ix1_particle_shear(GridS *pG, int reg, long numpar);
-static long packing_ox1_particle_shear(GridS *pG, int reg, long numpar);
-
-#ifdef FARGO
-static long packing_particle_fargo(GridS *pG, Real yl, Real yu);
-static int gridshift(Real shift);
-#endif /* FARGO */
+#if defined(FARGO) && defined(MPI_PARALLEL)
+static int fargo_slot(GridS *pG, DomainS *pD, const GrainS *gr,
+                      int nf, const int *frow);
+#endif /* FARGO && MPI_PARALLEL */
 
 #endif /* SHEARING_BOX */
 
@@ -142,766 +168,130 @@ extern void Delete_Ghost(GridS *pG);
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
 /*! \fn void bvals_particle(GridS *pG, Domain *pD)
- *  \brief Calls appropriate functions to set particle BCs. 
+ *  \brief Calls appropriate functions to set particle BCs.
  *
  *   The
  *   function pointers (*apply_???) are set during initialization by
  *   set_bvals_particle_init() to be either a user-defined function, or one of
- *   the functions corresponding to reflecting, periodic, or outflow.  If the
- *   left- or right-Grid ID numbers are >= 1 (neighboring grids exist), then
- *   MPI calls are used.
- *
- * Order for updating boundary conditions must always be x1-x2-x3 in order to
- * fill the corner cells properly
+ *   the functions corresponding to reflecting, periodic, or outflow.  Physical
+ *   boundaries are applied first, in the order x1-x2-x3, so that particles
+ *   crossing a physical boundary and an MPI (or periodic) boundary at the same
+ *   time are mapped before they are sent.  All MPI and periodic boundaries are
+ *   then set in a single exchange with the neighbouring Grids.
  */
 
 void bvals_particle(DomainS *pD)
 {
   GridS *pG = pD->Grid;
+  long nsend, nrecv;
+  int s;
 #ifdef MPI_PARALLEL
-  int err;
-  long cnt_send, cnt_recv;
-  MPI_Request rq;
-  MPI_Status stat;
+  int err, nrq;
+  MPI_Request rq[2*MAXNBR];
 #endif /* MPI_PARALLEL */
-#ifdef SHEARING_BOX
-  long numpar;  /* number of particles before applying B.C. */
-  int vyind;	/* index for vy, 5 for 3D (x1,x2,x3)=(X,Y,Z),
-                                 6 for 2D (x1,x2,x3)=(X,Z,Y) */
-#endif
 
 /*--- Step 1. ------------------------------------------------------------------
- * shuffle if necessary */
+ * Particles are added and removed below, so the cell offsets of the last
+ * shuffle no longer match the particle array */
 
-  /* shuffle every time interval TShuffle */
-  /* if TShuffle is not positive, don't shuffle */
-  if ((TShuffle>0) && (fmod(pG->time, TShuffle)<pG->dt))
-    shuffle(pG);
+  pG->parsorted = 0;
 
 /*--- Step 2. ------------------------------------------------------------------
- * Boundary Conditions in x1-direction */
-
-  if (pG->Nx[0] > 1){
-
-#ifdef SHEARING_BOX
-  numpar = pG->nparticle;
-  if (ShBoxCoord == xy) /* (x1,x2,x3)=(X,Y,Z) */
-    vyind = 5;
-  else                  /* (x1,x2,x3)=(X,Z,Y) */
-    vyind = 6;
-#endif
-
-#ifdef MPI_PARALLEL
-
-/* MPI blocks to both left and right */
-    if (pG->rx1_id >= 0 && pG->lx1_id >= 0) {
-
-    /*-------- sub-step 1: send to right and receive from left ------------*/
-
-      /* Post a non-blocking receive for the data size from the left grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->lx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* packing particle on the right to send buffer */
-      cnt_send = packing_ox1_particle(pG, nbc);
-
-      /* send buffer size to the right grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->rx1_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-
-      if (my_iproc == pD->NGrid[0]-1) {
-        /* physical boundary on the rignt in periodic B.C. */
-        shift_packed_particle(send_buf, cnt_send, 1, -Lx1);
-#ifdef SHEARING_BOX
-#ifndef FARGO
-        /* velocity shift for shearing box */
-        shift_packed_particle(send_buf, cnt_send, vyind, vshear);
-#endif
-#endif /* SHEARING_BOX */
-      }
-
-      /* receive buffer size from the left grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix1_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      /* send send_buf to the right and obtain recv_buf from the left */
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the left grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->lx1_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->rx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-      }
+ * Physical boundary conditions, in the order x1-x2-x3 */
 
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ix1_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-
-    /*-------- sub-step 2: send to left and receive from right --------*/
+  if (pG->Nx[0] > 1) {
+    if (!xchg[0][0]) (*apply_ix1)(pG);
+    if (!xchg[0][1]) (*apply_ox1)(pG);
+  }
 
-      /* Post a non-blocking receive for the data size from the right grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->rx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
+  if (pG->Nx[1] > 1) {
+    if (!xchg[1][0]) (*apply_ix2)(pG);
+    if (!xchg[1][1]) (*apply_ox2)(pG);
+  }
 
-      /* packing particle on the left to send buffer */
-      cnt_send = packing_ix1_particle(pG, nbc);
+  if (pG->Nx[2] > 1) {
+    if (!xchg[2][0]) (*apply_ix3)(pG);
+    if (!xchg[2][1]) (*apply_ox3)(pG);
+  }
 
-      /* send buffer size to the left grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->lx1_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
+/*--- Step 3. ------------------------------------------------------------------
+ * Count the particles for every destination, then pack them into consecutive
+ * segments of the send buffer sized exactly for this step */
 
-      if (my_iproc == 0) {
-        /* physical boundary on the left in periodic B.C. */
-        shift_packed_particle(send_buf, cnt_send, 1, Lx1);
 #ifdef SHEARING_BOX
-#ifndef FARGO
-        /* velocity shift for shearing box */
-        shift_packed_particle(send_buf, cnt_send, vyind, -vshear);
+  /* amount the computational domain has sheared in y */
+  yshift = fmod(vshear*pG->time, Lx2);
+  shear_nbrs(pG, pD);
 #endif
-#endif /* SHEARING_BOX */
-      }
-
-      /* receive buffer size from the right grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix1_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      /* send send_buf to the left and obtain recv_buf from the right */
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the right grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->rx1_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->lx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ox1_particle]: MPI_Send error = %d\n",err);
-      }
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ox1_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-
-/* Physical boundary on left, MPI block on right */
-    if ((pG->rx1_id >= 0) && (pG->lx1_id < 0)) {
-
-    /*-------- sub-step 1: send to right  --------*/
-
-      /* packing particle on the right to send buffer */
-      cnt_send = packing_ox1_particle(pG, nbc);
-
-      /* send buffer size to the right grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->rx1_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->rx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-      }
-
-    /*-------- sub-step 2: apply left boundary condition --------*/
-      (*apply_ix1)(pG);
-
-    /*-------- sub-step 3: receive from right  --------*/
-
-      /* Post a non-blocking receive for the data size from the right grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->rx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
 
-     /* receive buffer size from the right grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix1_particle]: MPI_Wait error = %d\n",err);
+  for (s=0; s<nnbr; s++)
+    nbr_cnt[s] = 0;
 
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the right grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->rx1_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ox1_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-
-/* MPI block on left, Physical boundary on right */
-    if ((pG->lx1_id >= 0) && (pG->rx1_id < 0)) {
-
-    /*-------- sub-step 1: receive from left --------*/
-
-      /* Post a non-blocking receive for the data size from the left grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->lx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* receive buffer size from the left grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix1_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the left grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->lx1_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-    /*-------- sub-step 2: apply right boundary condition --------*/
-      (*apply_ox1)(pG);
-
-    /*-------- sub-step 3: send to left --------*/
-
-      /* packing particle on the left to send buffer */
-      cnt_send = packing_ix1_particle(pG, nbc);
-
-      /* send buffer size to the left grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->lx1_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->lx1_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ox1_particle]: MPI_Send error = %d\n",err);
-      }
-
-    /*-------- sub-step 1: receive from left (cont) --------*/
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ix1_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-#endif /* MPI_PARALLEL */
-
-/* Physical boundaries on both left and right */
-    if (pG->rx1_id < 0 && pG->lx1_id < 0) {
-      (*apply_ix1)(pG);
-      (*apply_ox1)(pG);
-    }
-
-#ifdef SHEARING_BOX
-   if (ShBoxCoord == xy) {
-      if (my_iproc == 0) /* inner boundary */
-        shearingbox_ix1_particle(pG, pD, numpar);
-
-      if (my_iproc == (pD->NGrid[0]-1)) /* outer boundary */
-        shearingbox_ox1_particle(pG, pD, numpar);
-    }
-#endif /* SHEARING_BOX */
+  route_pass(pG, pD, 0);
 
+  for (s=0, nsend=0; s<nnbr; s++) {
+    nbr_off[s] = nsend;
+    nsend += nbr_cnt[s];
   }
+  fit_buffer(&send_buf, &send_bufsize, &send_peak, nsend);
 
-/*--- Step 3. ------------------------------------------------------------------
- * Boundary Conditions in x2-direction */
+  route_pass(pG, pD, 1);
 
-  if (pG->Nx[1] > 1) {
-
-#ifdef MPI_PARALLEL
-
-/* MPI blocks to both left and right */
-    if (pG->rx2_id >= 0 && pG->lx2_id >= 0) {
-
-    /*-------- sub-step 1: send to right and receive from left --------*/
-
-      /* Post a non-blocking receive for the data size from the left grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->lx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* packing particle on the right to send buffer */
-      cnt_send = packing_ox2_particle(pG, nbc);
-
-      /* send buffer size to the right grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->rx2_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix2_particle]: MPI_Send error = %d\n",err);
-
-      /* physical boundary on the rignt in periodic B.C. */
-      if (my_jproc == pD->NGrid[1]-1)
-        shift_packed_particle(send_buf, cnt_send, 2, -Lx2);
-
-      /* receive buffer size from the left grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix2_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      /* send send_buf to the right and obtain recv_buf from the left */
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the left grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->lx2_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->rx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ix2_particle]: MPI_Send error = %d\n",err);
-      }
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ix2_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-
-    /*-------- sub-step 2: send to left and receive from right --------*/
-
-      /* Post a non-blocking receive for the data size from the right grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->rx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* packing particle on the left to send buffer */
-      cnt_send = packing_ix2_particle(pG, nbc);
-
-      /* send buffer size to the left grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->lx2_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix2_particle]: MPI_Send error = %d\n",err);
-
-      if (my_jproc == 0) /* physical boundary on the left in periodic B.C. */
-        shift_packed_particle(send_buf, cnt_send, 2, Lx2);
-
-      /* receive buffer size from the right grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix2_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      /* send send_buf to the left and obtain recv_buf from the right */
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the right grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->rx2_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->lx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ox2_particle]: MPI_Send error = %d\n",err);
-      }
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ox2_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-
-/* Physical boundary on left, MPI block on right */
-    if (pG->rx2_id >= 0 && pG->lx2_id < 0) {
-
-    /*-------- sub-step 1: send to right --------*/
-
-      /* packing particle on the right to send buffer */
-      cnt_send = packing_ox2_particle(pG, nbc);
-
-      /* send buffer size to the right grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->rx2_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-
-      /* send buffer to the right grid */
-      if (cnt_send > 0) {
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->rx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ix1_particle]: MPI_Send error = %d\n",err);
-      }
-
-    /*-------- sub-step 2: apply left boundary condition --------*/
-
-      (*apply_ix2)(pG);
-
-    /*-------- sub-step 3: receive from right --------*/
-
-      /* Post a non-blocking receive for the data size from the right grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->rx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* receive buffer size from the right grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix2_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the right grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->rx2_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ox2_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-
-/* MPI block on left, Physical boundary on right */
-    if (pG->rx2_id < 0 && pG->lx2_id >= 0) {
-
-    /*-------- sub-step 1: receive from left --------*/
-
-      /* Post a non-blocking receive for the data size from the left grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->lx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* receive buffer size from the left grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix2_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the left grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->lx2_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-    /*-------- sub-step 2: apply right boundary condition --------*/
-
-      (*apply_ox2)(pG);
-
-    /*-------- sub-step 3: send to left --------*/
-
-      /* packing particle on the left to send buffer */
-      cnt_send = packing_ix2_particle(pG, nbc);
-
-      /* send buffer size to the left grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->lx2_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix2_particle]: MPI_Send error = %d\n",err);
-
-      /* send buffer to the right grid */
-      if (cnt_send > 0) {
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->lx2_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ox2_particle]: MPI_Send error = %d\n",err);
-      }
-
-    /*-------- sub-step 1: receive from left (cont) --------*/
+/*--- Step 4. ------------------------------------------------------------------
+ * Exchange the numbers of particles with all neighbours, then the particles
+ * themselves in one round of messages of exactly that size */
 
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ix2_particle]: MPI_Wait error = %d\n",err);
+  for (s=0; s<nnbr; s++)
+    rcv_cnt[s] = 0;
 
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
+#ifdef MPI_PARALLEL
+  for (s=0, nrq=0; s<nnbr; s++) {
+    if (s == nbr_self) continue;
+    err = MPI_Irecv(&(rcv_cnt[s]), 1, MPI_LONG, nbr_id[s],
+                    boundary_particle_tag, MPI_COMM_WORLD, &(rq[nrq++]));
+    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
+  }
+  for (s=0; s<nnbr; s++) {
+    if (s == nbr_self) continue;
+    err = MPI_Isend(&(nbr_cnt[s]), 1, MPI_LONG, nbr_id[s],
+                    boundary_particle_tag, MPI_COMM_WORLD, &(rq[nrq++]));
+    if(err) ath_error("[set_bvals_particle]: MPI_Isend error = %d\n",err);
+  }
+  err = MPI_Waitall(nrq, rq, MPI_STATUSES_IGNORE);
+  if(err) ath_error("[set_bvals_particle]: MPI_Waitall error = %d\n",err);
 #endif /* MPI_PARALLEL */
 
-/* Physical boundaries on both left and right */
-    if (pG->rx2_id < 0 && pG->lx2_id < 0) {
-      (*apply_ix2)(pG);
-      (*apply_ox2)(pG);
-    }
+  for (s=0, nrecv=0; s<nnbr; s++) {
+    rcv_off[s] = nrecv;
+    nrecv += rcv_cnt[s];
   }
-
-/*--- Step 4. ------------------------------------------------------------------
- * Boundary Conditions in x3-direction */
-
-  if (pG->Nx[2] > 1){
+  fit_buffer(&recv_buf, &recv_bufsize, &recv_peak, nrecv);
 
 #ifdef MPI_PARALLEL
-
-/* MPI blocks to both left and right */
-    if (pG->rx3_id >= 0 && pG->lx3_id >= 0) {
-
-    /*-------- sub-step 1: send to right and receive from left --------*/
-
-      /* Post a non-blocking receive for the data size from the left grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->lx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* packing particle on the right to send buffer */
-      cnt_send = packing_ox3_particle(pG, nbc);
-
-      /* send buffer size to the right grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->rx3_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix3_particle]: MPI_Send error = %d\n",err);
-
-      /* physical boundary on the rignt in periodic B.C. */
-      if (my_kproc == pD->NGrid[2]-1) 
-        shift_packed_particle(send_buf, cnt_send, 3, -Lx3);
-
-      /* receive buffer size from the left grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix3_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      /* send send_buf to the right and obtain recv_buf from the left */
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the left grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->lx3_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->rx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ix3_particle]: MPI_Send error = %d\n",err);
-      }
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ix3_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-
-    /*-------- sub-step 2: send to left and receive from right --------*/
-
-      /* Post a non-blocking receive for the data size from the right grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->rx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* packing particle on the left to send buffer */
-      cnt_send = packing_ix3_particle(pG, nbc);
-
-      /* send buffer size to the left grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->lx3_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix3_particle]: MPI_Send error = %d\n",err);
-
-      if (my_kproc == 0) /* physical boundary on the left in periodic B.C. */
-        shift_packed_particle(send_buf, cnt_send, 3, Lx3);
-
-      /* receive buffer size from the right grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix3_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      /* send send_buf to the left and obtain recv_buf from the right */
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the right grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->rx3_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->lx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ox3_particle]: MPI_Send error = %d\n",err);
-      }
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ox3_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-
-/* Physical boundary on left, MPI block on right */
-    if (pG->rx3_id >= 0 && pG->lx3_id < 0) {
-
-    /*-------- sub-step 1: send to right --------*/
-
-      /* packing particle on the right to send buffer */
-      cnt_send = packing_ox3_particle(pG, nbc);
-
-      /* send buffer size to the right grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->rx3_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix3_particle]: MPI_Send error = %d\n",err);
-
-      /* send buffer to the right grid */
-      if (cnt_send > 0) {
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->rx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ix3_particle]: MPI_Send error = %d\n",err);
-      }
-
-    /*-------- sub-step 2: apply left boundary condition --------*/
-
-      (*apply_ix3)(pG);
-
-    /*-------- sub-step 3: receive from right --------*/
-
-      /* Post a non-blocking receive for the data size from the right grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->rx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      /* receive buffer size from the right grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix3_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the right grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->rx3_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ox3_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
-
-/* MPI block on left, Physical boundary on right */
-    if (pG->rx3_id < 0 && pG->lx3_id >= 0) {
-
-    /*-------- sub-step 1: receive from left --------*/
-
-      /* Post a non-blocking receive for the data size from the left grid */
-      err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, pG->lx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-      /* receive buffer size from the left grid */
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[receive_ix3_particle]: MPI_Wait error = %d\n",err);
-
-      /* check space for the receive buffer */
-      if ((cnt_recv+1) >= recv_bufsize)
-        realloc_recvbuf(cnt_recv+1);
-
-      if (cnt_recv > 0) {
-        /* Post a non-blocking receive for the input data from the left grid */
-        err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, pG->lx3_id,
-                                  boundary_particle_tag, MPI_COMM_WORLD, &rq);
-        if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-      }
-
-    /*-------- sub-step 2: apply right boundary condition --------*/
-
-      (*apply_ox3)(pG);
-
-    /*-------- sub-step 3: send to left --------*/
-
-      /* packing particle on the left to send buffer */
-      cnt_send = packing_ix3_particle(pG, nbc);
-
-      /* send buffer size to the left grid */
-      err = MPI_Send(&cnt_send, 1, MPI_LONG, pG->lx3_id,
-                                boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ix3_particle]: MPI_Send error = %d\n",err);
-
-      if (cnt_send > 0) {
-        /* send buffer to the right grid */
-        err = MPI_Send(send_buf, cnt_send*NVAR_P, MPI_DOUBLE, pG->lx3_id,
-                                 boundary_particle_tag, MPI_COMM_WORLD);
-        if(err) ath_error("[send_ox3_particle]: MPI_Send error = %d\n",err);
-      }
-
-    /*-------- sub-step 1: receive from left (cont) --------*/
-
-      if (cnt_recv > 0) {
-        /* receive buffer from the left grid */
-        err = MPI_Wait(&rq, &stat);
-        if(err) ath_error("[receive_ix3_particle]: MPI_Wait error = %d\n",err);
-
-        /* unpack the received particle */
-        unpack_particle(pG, recv_buf, cnt_recv);
-      }
-    }
+  for (s=0, nrq=0; s<nnbr; s++) {
+    if (rcv_cnt[s] == 0) continue;
+    err = MPI_Irecv(&(recv_buf[NVAR_P*rcv_off[s]]), (int)(NVAR_P*rcv_cnt[s]),
+          MPI_DOUBLE, nbr_id[s], boundary_particle_tag, MPI_COMM_WORLD,
+          &(rq[nrq++]));
+    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
+  }
+  for (s=0; s<nnbr; s++) {
+    if ((s == nbr_self) || (nbr_cnt[s] == 0)) continue;
+    err = MPI_Isend(&(send_buf[NVAR_P*nbr_off[s]]), (int)(NVAR_P*nbr_cnt[s]),
+          MPI_DOUBLE, nbr_id[s], boundary_particle_tag, MPI_COMM_WORLD,
+          &(rq[nrq++]));
+    if(err) ath_error("[set_bvals_particle]: MPI_Isend error = %d\n",err);
+  }
+  err = MPI_Waitall(nrq, rq, MPI_STATUSES_IGNORE);
+  if(err) ath_error("[set_bvals_particle]: MPI_Waitall error = %d\n",err);
 #endif /* MPI_PARALLEL */
 
-/* Physical boundaries on both left and right */
-    if (pG->rx3_id < 0 && pG->lx3_id < 0) {
-      (*apply_ix3)(pG);
-      (*apply_ox3)(pG);
-    }
-  }
+  /* unpack the received particles, and the ghost particles kept here */
+  if (nrecv > 0)
+    unpack_particle(pG, recv_buf, nrecv);
+  if (nbr_cnt[nbr_self] > 0)
+    unpack_particle(pG, &(send_buf[NVAR_P*nbr_off[nbr_self]]),
+                        nbr_cnt[nbr_self]);
 
 /*--- Step 5. ------------------------------------------------------------------
  * Update the status of the crossing particles */
@@ -909,38 +299,44 @@ void bvals_particle(DomainS *pD)
 
   Delete_Ghost(pG);
 
+/*--- Step 6. ------------------------------------------------------------------
+ * shuffle if necessary, once the particle array is final for the next step */
+
+  /* shuffle every time interval TShuffle (every step if TShuffle <= dt) */
+  /* if TShuffle is not positive, don't shuffle */
+  if ((TShuffle>0) && (fmod(pG->time, TShuffle)<pG->dt))
+    shuffle(pG);
+
   return;
 }
 
-
 #ifdef FARGO
 /*----------------------------------------------------------------------------*/
 /*! \fn void advect_particles(DomainS *pD)
- *  \brief Advect particles by qshear*Omega_0*x1*dt for the FARGO algorithm. */
+ *  \brief Advect particles by qshear*Omega_0*x1*dt for the FARGO algorithm.
+ *
+ * With MPI the particles leaving the Grid in y are sent to the Grids of the
+ * same column that own them, as in bvals_particle(): they are counted for
+ * each destination and packed into segments of the send buffer, the counts
+ * are exchanged, followed by one round of messages of exactly that size.
+ */
 void advect_particles(DomainS *pD)
 {
   GridS *pG = pD->Grid;
   GrainS *gr;
   long p;
-  Real x1l, x1u;
 #ifdef MPI_PARALLEL
-  long cnt_recv, n;
-  int ishl, ishu, i;
-  int inds, indr, ids, idr;
-  Real x2len, yl, yu;
-  int err;
-  MPI_Request rq;
-  MPI_Status stat;
+  long nsend, nrecv, cur[MAXNBR];
+  long snd_cnt[MAXNBR], snd_off[MAXNBR], rcv_cnt[MAXNBR], rcv_off[MAXNBR];
+  int j, s, nf, nrq, err, fid[MAXNBR], frow[MAXNBR];
+  Real a0, a1, b0, b1, sh, dy;
+  MPI_Request rq[2*MAXNBR];
 #endif /* MPI_PARALLEL */
 
   /* Do nothing if the azimuthal dimension is not present */
   if (ShBoxCoord != xy)
     return;
 
-  /* lower and upper bound of the grid in x1 direction */
-  x1l = pG->MinX[0];
-  x1u = pG->MaxX[0];
-
   /* shift the particles */
   for (p=0; p<pG->nparticle; p++) {
     gr = &(pG->particle[p]);
@@ -948,70 +344,95 @@ void advect_particles(DomainS *pD)
   }
 
 #ifdef MPI_PARALLEL
-  /* calculate the farthest grid that advection can reach */
-  x2len = pG->dx2*pG->Nx[1];
-  ishl = gridshift((qshear*Omega_0*(x1l-pG->dx1)*pG->dt - pG->dx2)/x2len);
-  ishu = gridshift((qshear*Omega_0*(x1u+pG->dx1)*pG->dt + pG->dx2)/x2len);
-
-  /* loop over all the possible destination grids */
-  for (i=ishl; i<=ishu; i++)
-  if (i != 0) { /* avoid moving particles to the same grid */
-
-    /* find the processor id to send/receive data */
-    inds = my_jproc + i;
-    if (inds < 0) inds += pD->NGrid[1];
-    if (inds > (pD->NGrid[1]-1)) inds -= pD->NGrid[1];
-    ids = pD->GData[my_kproc][inds][my_iproc].ID_Comm_Domain; /* send to */
-
-    indr = my_jproc - i;
-    if (indr < 0) indr += pD->NGrid[1];
-    if (indr > (pD->NGrid[1]-1)) indr -= pD->NGrid[1];
-    idr = pD->GData[my_kproc][indr][my_iproc].ID_Comm_Domain;/* receive from */
-
-    /* Post a non-blocking receive for the data size */
-    err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, idr, boundary_particle_tag,
-                                                 MPI_COMM_WORLD, &rq);
-    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-    /* packing particles */
-    yl = x2min + inds*x2len;	yu = x2min + (inds+1)*x2len;
-    n = packing_particle_fargo(pG, yl, yu);
-
-    /* send buffer size */
-    err = MPI_Send(&n, 1, MPI_LONG, ids, boundary_particle_tag, MPI_COMM_WORLD);
-    if(err) ath_error("[send_ox1_particle_shear]: MPI_Send error = %d\n",err);
-
-    /* receive buffer size */
-    err = MPI_Wait(&rq, &stat);
-    if(err) ath_error("[recv_ox1_particle_shear]: MPI_Wait error = %d\n",err);
-
-    /* check space for the receive buffer */
-    if ((cnt_recv+1) >= recv_bufsize)
-      realloc_recvbuf(cnt_recv+1);
-
-    /* Post a non-blocking receive for data */
-    if (cnt_recv > 0) {
-      err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, idr,
-                                boundary_particle_tag, MPI_COMM_WORLD, &rq);
-      if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
+  /* Grids of this column which the particles may move to or come from: the
+   * shift lies in sh-dy..sh+dy (with one cell to spare) over the x1 range */
+  sh = -0.5*qshear*Omega_0*(pG->MinX[0] + pG->MaxX[0])*pG->dt;
+  dy = 0.5*fabs(qshear*Omega_0*(pG->MaxX[0] - pG->MinX[0] + 2.0*pG->dx1)
+                *pG->dt) + pG->dx2;
+  a0 = pG->MinX[1];	a1 = pG->MaxX[1];
+
+  nf = 0;
+  for (j=0; j<pD->NGrid[1]; j++) {
+    if (j == my_jproc) continue;
+    b0 = x2min + pD->GData[my_kproc][j][my_iproc].Disp[1]*pG->dx2;
+    b1 = b0 + pD->GData[my_kproc][j][my_iproc].Nx[1]*pG->dx2;
+    if (shear_overlap(a0, a1, b0, b1, sh, dy) ||
+        shear_overlap(b0, b1, a0, a1, sh, dy)) {
+      if (nf == MAXNBR)
+        ath_error("[advect_particles]: more than %d Grids to exchange with\n",
+                  MAXNBR);
+      fid[nf] = pD->GData[my_kproc][j][my_iproc].ID_Comm_Domain;
+      frow[nf++] = j;
     }
+  }
+
+  /* count the particles for every destination, then pack them and remove
+   * them from the particle array */
+  for (s=0; s<nf; s++)
+    snd_cnt[s] = 0;
+  for (p=0; p<pG->nparticle; p++)
+    if ((s = fargo_slot(pG, pD, &(pG->particle[p]), nf, frow)) >= 0)
+      snd_cnt[s] += 1;
+
+  for (s=0, nsend=0; s<nf; s++) {
+    cur[s] = snd_off[s] = nsend;
+    nsend += snd_cnt[s];
+  }
+  fit_buffer(&send_buf, &send_bufsize, &send_peak, nsend);
 
-    /* send buffer */
-    if (n > 0) {
-      err = MPI_Send(send_buf, n*NVAR_P, MPI_DOUBLE, ids,
-                               boundary_particle_tag, MPI_COMM_WORLD);
-      if(err) ath_error("[send_ox1_particle_shear]: MPI_Send error = %d\n",err);
+  p = 0;
+  while (p < pG->nparticle) {
+    gr = &(pG->particle[p]);
+    if ((s = fargo_slot(pG, pD, gr, nf, frow)) < 0) {
+      p += 1;
+      continue;
     }
+    packing_one_particle(gr, cur[s]++, gr->pos);
+    pG->nparticle -= 1;
+    grproperty[gr->property].num -= 1;
+    pG->particle[p] = pG->particle[pG->nparticle];
+  }
 
-    /* receive buffer */
-    if (cnt_recv > 0) {
-      err = MPI_Wait(&rq, &stat);
-      if(err) ath_error("[recv_ox1_particle_shear]: MPI_Wait error = %d\n",err);
+  /* exchange the counts, then the particles */
+  for (s=0, nrq=0; s<nf; s++) {
+    rcv_cnt[s] = 0;
+    err = MPI_Irecv(&(rcv_cnt[s]), 1, MPI_LONG, fid[s],
+                    boundary_particle_tag, MPI_COMM_WORLD, &(rq[nrq++]));
+    if(err) ath_error("[advect_particles]: MPI_Irecv error = %d\n",err);
+  }
+  for (s=0; s<nf; s++) {
+    err = MPI_Isend(&(snd_cnt[s]), 1, MPI_LONG, fid[s],
+                    boundary_particle_tag, MPI_COMM_WORLD, &(rq[nrq++]));
+    if(err) ath_error("[advect_particles]: MPI_Isend error = %d\n",err);
+  }
+  err = MPI_Waitall(nrq, rq, MPI_STATUSES_IGNORE);
+  if(err) ath_error("[advect_particles]: MPI_Waitall error = %d\n",err);
 
-      /* unpack the received particle */
-      unpack_particle(pG, recv_buf, cnt_recv);
-    }
+  for (s=0, nrecv=0; s<nf; s++) {
+    rcv_off[s] = nrecv;
+    nrecv += rcv_cnt[s];
+  }
+  fit_buffer(&recv_buf, &recv_bufsize, &recv_peak, nrecv);
+
+  for (s=0, nrq=0; s<nf; s++) {
+    if (rcv_cnt[s] == 0) continue;
+    err = MPI_Irecv(&(recv_buf[NVAR_P*rcv_off[s]]), (int)(NVAR_P*rcv_cnt[s]),
+          MPI_DOUBLE, fid[s], boundary_particle_tag, MPI_COMM_WORLD,
+          &(rq[nrq++]));
+    if(err) ath_error("[advect_particles]: MPI_Irecv error = %d\n",err);
   }
+  for (s=0; s<nf; s++) {
+    if (snd_cnt[s] == 0) continue;
+    err = MPI_Isend(&(send_buf[NVAR_P*snd_off[s]]), (int)(NVAR_P*snd_cnt[s]),
+          MPI_DOUBLE, fid[s], boundary_particle_tag, MPI_COMM_WORLD,
+          &(rq[nrq++]));
+    if(err) ath_error("[advect_particles]: MPI_Isend error = %d\n",err);
+  }
+  err = MPI_Waitall(nrq, rq, MPI_STATUSES_IGNORE);
+  if(err) ath_error("[advect_particles]: MPI_Waitall error = %d\n",err);
+
+  if (nrecv > 0)
+    unpack_particle(pG, recv_buf, nrecv);
 #endif /* MPI_PARALLEL */
 
   return;
@@ -1027,6 +448,7 @@ void bvals_particle_init(MeshS *pM)
 {
   GridS *pG;
   DomainS *pD;
+  int o1,o2,o3,l,m,n;
 
   if (pM->NLevels > 1)
     ath_error("[bval_particle_init]: particle module does not support SMR\n");
@@ -1045,6 +467,8 @@ void bvals_particle_init(MeshS *pM)
   recv_bufsize = NBUF;
   send_buf = (double*)calloc_1d_array(NVAR_P*send_bufsize, sizeof(double));
   recv_buf = (double*)calloc_1d_array(NVAR_P*recv_bufsize, sizeof(double));
+  send_peak = 0;
+  recv_peak = 0;
 
 /* number of boundary layers to pack the particles */
 #ifdef FEEDBACK
@@ -1095,7 +519,7 @@ void bvals_particle_init(MeshS *pM)
 	break;
 
       case 4: /* Periodic */
-	apply_ix1 = periodic_ix1_particle;
+	apply_ix1 = periodic_particle;
 #ifdef MPI_PARALLEL
 	if(pG->lx1_id < 0 && pD->NGrid[0] > 1){
 	  pG->lx1_id =
@@ -1128,7 +552,7 @@ void bvals_particle_init(MeshS *pM)
 	break;
 
       case 4: /* Periodic */
-	apply_ox1 = periodic_ox1_particle;
+	apply_ox1 = periodic_particle;
 #ifdef MPI_PARALLEL
 	if(pG->rx1_id < 0 && pD->NGrid[0] > 1){
 	  pG->rx1_id = pD->GData[my_kproc][my_jproc][0].ID_Comm_Domain;
@@ -1164,7 +588,7 @@ void bvals_particle_init(MeshS *pM)
 	break;
 
       case 4: /* Periodic */
-	apply_ix2 = periodic_ix2_particle;
+	apply_ix2 = periodic_particle;
 #ifdef MPI_PARALLEL
 	if(pG->lx2_id < 0 && pD->NGrid[1] > 1){
 	  pG->lx2_id =
@@ -1197,7 +621,7 @@ void bvals_particle_init(MeshS *pM)
 	break;
 
       case 4: /* Periodic */
-	apply_ox2 = periodic_ox2_particle;
+	apply_ox2 = periodic_particle;
 #ifdef MPI_PARALLEL
 	if(pG->rx2_id < 0 && pD->NGrid[1] > 1){
 	  pG->rx2_id = pD->GData[my_kproc][0][my_iproc].ID_Comm_Domain;
@@ -1233,7 +657,7 @@ void bvals_particle_init(MeshS *pM)
 	break;
 
       case 4: /* Periodic */
-	apply_ix3 = periodic_ix3_particle;
+	apply_ix3 = periodic_particle;
 #ifdef MPI_PARALLEL
 	if(pG->lx3_id < 0 && pD->NGrid[2] > 1){
 	  pG->lx3_id =
@@ -1266,7 +690,7 @@ void bvals_particle_init(MeshS *pM)
 	break;
 
       case 4: /* Periodic */
-	apply_ox3 = periodic_ox3_particle;
+	apply_ox3 = periodic_particle;
 #ifdef MPI_PARALLEL
 	if(pG->rx3_id < 0 && pD->NGrid[2] > 1){
 	  pG->rx3_id = pD->GData[0][my_jproc][my_iproc].ID_Comm_Domain;
@@ -1283,6 +707,43 @@ void bvals_particle_init(MeshS *pM)
     }
   }
 
+/* Boundaries set by the exchange: MPI neighbours and periodic B.C. */
+
+  xchg[0][0] = (pG->lx1_id >= 0) || (apply_ix1 == periodic_particle);
+  xchg[0][1] = (pG->rx1_id >= 0) || (apply_ox1 == periodic_particle);
+  xchg[1][0] = (pG->lx2_id >= 0) || (apply_ix2 == periodic_particle);
+  xchg[1][1] = (pG->rx2_id >= 0) || (apply_ox2 == periodic_particle);
+  xchg[2][0] = (pG->lx3_id >= 0) || (apply_ix3 == periodic_particle);
+  xchg[2][1] = (pG->rx3_id >= 0) || (apply_ox3 == periodic_particle);
+
+/* List the Grids at all offsets across these boundaries, this Grid first */
+
+  nnbr = 0;
+#ifdef MPI_PARALLEL
+  nbr_self = add_nbr(pD->GData[my_kproc][my_jproc][my_iproc].ID_Comm_Domain);
+#else
+  nbr_self = add_nbr(0);
+#endif
+  for (o3=-1; o3<=1; o3++) {
+  for (o2=-1; o2<=1; o2++) {
+  for (o1=-1; o1<=1; o1++) {
+    l = my_iproc + o1;
+    m = my_jproc + o2;
+    n = my_kproc + o3;
+    if ((o1 != 0) && ((pG->Nx[0] == 1) || !xchg[0][(o1+1)/2])) continue;
+    if ((o2 != 0) && ((pG->Nx[1] == 1) || !xchg[1][(o2+1)/2])) continue;
+    if ((o3 != 0) && ((pG->Nx[2] == 1) || !xchg[2][(o3+1)/2])) continue;
+    l = (l + pD->NGrid[0]) % pD->NGrid[0];
+    m = (m + pD->NGrid[1]) % pD->NGrid[1];
+    n = (n + pD->NGrid[2]) % pD->NGrid[2];
+#ifdef MPI_PARALLEL
+    add_nbr(pD->GData[n][m][l].ID_Comm_Domain);
+#else
+    add_nbr(0);
+#endif
+  }}}
+  nnbr_fix = nnbr;
+
   return;
 }
 
@@ -1339,11 +800,12 @@ void bvals_particle_destruct(MeshS *pM)
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /*----------------------------------------------------------------------------*/
 /* Following are the functions:
- *   realloc_sendbuf & realloc_recvbuf
+ *   fit_buffer & realloc_sendbuf
  *   update_particle_status
  *   reflecting_???_particle
  *   outflow_???_particle
- *   periodic_???_particle
+ *   periodic_particle
+ *   exchange related functions
  *   packing_???_particle
  *   unpack__particle
  *   shearing box related functions
@@ -1351,6 +813,32 @@ void bvals_particle_destruct(MeshS *pM)
  * where ???=[ix1,ox1,ix2,ox2,ix3,ox3]
  */
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fit_buffer(double **buf, long *size, long *peak, long n)
+ *  \brief Makes room for n particles in the send or receive buffer.
+ *
+ * The size follows a slowly decaying peak of the recent exchanges, with some
+ * headroom, so that the buffer is reallocated rarely while a clump of
+ * particles passes a boundary, and shrinks again once it has gone.
+ */
+static void fit_buffer(double **buf, long *size, long *peak, long n)
+{
+  long want;
+
+  *peak = MAX(n, *peak - *peak/16);
+  want = MAX(*peak + *peak/4, NBUF) + 2;
+
+  if ((n+2 > *size) || (*size > 4*want)) {
+    *size = want;
+    ath_pout(1,"[set_bvals_prticles]: resizing buffer to %ld particles\n",
+                                                                   want);
+    if ((*buf = (double*)realloc(*buf, NVAR_P*(*size)*sizeof(double)))==NULL)
+      ath_error("[set_bvals_prticles]: failed to allocate memory for buffer.\n");
+  }
+
+  return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn static void realloc_sendbuf()
  *  \brief Reallocate memory to send buffer */
@@ -1365,21 +853,6 @@ static void realloc_sendbuf()
   return;
 }
 
-/*----------------------------------------------------------------------------*/
-/*! \fn static void realloc_recvbuf(long newsize)
- *  \brief Reallocate memory to receive buffer */
-static void realloc_recvbuf(long newsize)
-{
-  recv_bufsize += NBUF;
-  recv_bufsize = MAX(recv_bufsize, newsize);
-  ath_pout(1,"[set_bvals_prticles]: reallocating receive buffer...");
-  if ((recv_buf = (double*)realloc(recv_buf,
-                           NVAR_P*(recv_bufsize)*sizeof(double))) == NULL)
-    ath_error("[set_bvals_prticles]: failed to allocate memory for buffer.\n");
-
-  return;
-}
-
 /*----------------------------------------------------------------------------*/
 /*! \fn static void update_particle_status(GridS *pG)
  *  \brief Update the status of the particles after applying boundary conditions
@@ -1581,159 +1054,189 @@ static void outflow_particle(GridS *pG)
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void periodic_ix1_particle(GridS *pG)
- *  \brief PERIODIC boundary conditions, Inner x1 boundary (ibc_x1=4)
+/*! \fn static void periodic_particle(GridS *pG)
+ *  \brief PERIODIC boundary conditions (ibc=4)
  *
- * Note: 2D shearing box B.C. is considered here!
+ * Periodic boundaries are set by the exchange in bvals_particle(), together
+ * with the MPI boundaries (the particles stay on this Grid if it is the only
+ * one in that direction).  This function only marks the boundary.
  */
-static void periodic_ix1_particle(GridS *pG)
+static void periodic_particle(GridS *pG)
 {
-  long n = 0;
-#ifdef SHEARING_BOX
-  /* index for vy, 5 for 3D (x1,x2,x3)=(X,Y,Z), 6 for 2D (x1,x2,x3)=(X,Z,Y) */
-  int vyind;
-
-  if (ShBoxCoord == xy) /* (x1,x2,x3)=(X,Y,Z) */
-    vyind = 5;
-  else                  /* (x1,x2,x3)=(X,Z,Y) */
-    vyind = 6;
-#endif
-
-  /* pack boundary particles */
-  n = packing_ox1_particle(pG, nbc);
-
-  /* shift the particles */
-  shift_packed_particle(send_buf, n, 1, -Lx1);
-
-#ifdef SHEARING_BOX
-#ifndef FARGO
-  /* velocity shift for shearing box */
-  shift_packed_particle(send_buf, n, vyind, vshear);
-#endif
-#endif /* SHEARING_BOX */
-
-  /* copy boudary particles to the rear */
-  unpack_particle(pG, send_buf, n);
-
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void periodic_ox1_particle(GridS *pG)
- *  \brief PERIODIC boundary conditions, Outer x1 boundary (ibc_x1=4)
- *
- * Note: 2D shearing box B.C. is considered here!
- */
-static void periodic_ox1_particle(GridS *pG)
+/*! \fn static int add_nbr(int id)
+ *  \brief Adds the Grid with processor id to the list of exchange partners
+ *   unless it is already there, and returns its slot in the list */
+static int add_nbr(int id)
 {
-  long n = 0;
-#ifdef SHEARING_BOX
-  /* index for vy, 5 for 3D (x1,x2,x3)=(X,Y,Z), 6 for 2D (x1,x2,x3)=(X,Z,Y) */
-  int vyind;
-
-  if (ShBoxCoord == xy) /* (x1,x2,x3)=(X,Y,Z) */
-    vyind = 5;
-  else             /* (x1,x2,x3)=(X,Z,Y) */
-    vyind = 6;
-#endif
-
-  /* pack boundary particles */
-  n = packing_ix1_particle(pG, nbc);
-
-  /* shift the particles */
-  shift_packed_particle(send_buf, n, 1, Lx1);
+  int s;
 
-#ifdef SHEARING_BOX
-#ifndef FARGO
-  /* velocity shift for shearing box */
-  shift_packed_particle(send_buf, n, vyind, -vshear);
-#endif
-#endif /* SHEARING_BOX */
+  for (s=0; s<nnbr; s++)
+    if (nbr_id[s] == id) return s;
 
-  /* copy boudary particles to the rear */
-  unpack_particle(pG, send_buf, n);
+  if (nnbr == MAXNBR)
+    ath_error("[bvals_particle]: more than %d Grids to exchange with\n",MAXNBR);
+  nbr_id[nnbr] = id;
 
-  return;
+  return nnbr++;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void periodic_ix2_particle(GridS *pG)
- *  \brief PERIODIC boundary conditions, Inner x2 boundary (ibc_x2=4)
+/*! \fn static void route_pass(GridS *pG, DomainS *pD, int pack)
+ *  \brief Finds the destination of every particle to be exchanged.
+ *
+ * Input: pack: 0 to count the particles for each destination in nbr_cnt[],
+ *              1 to pack them to the send buffer from offsets nbr_off[]
+ * Crossing particles outside an MPI or periodic boundary go to the Grid that
+ * owns them, which is this Grid itself for periodic B.C. with a single Grid
+ * in that direction; those are moved in place when packing.  Particles within
+ * nbc layers of such a boundary are also packed as ghost particles for every
+ * neighbour (faces, edges and corners) whose boundary layers they lie in.
  */
-static void periodic_ix2_particle(GridS *pG)
+static void route_pass(GridS *pG, DomainS *pD, int pack)
 {
-  long n = 0;
+  GrainS *gr, g;
+  long p, np, cur[MAXNBR];
+  int d[3], o[3], lay[3][2], dir, s, cross;
+  Real x[3], dx[3];
 
-  /* pack boundary particles */
-  n = packing_ox2_particle(pG, nbc);
+  np = pG->nparticle;
+  for (s=0; s<nnbr; s++)
+    cur[s] = nbr_off[s];
+  dx[0] = pG->dx1;  dx[1] = pG->dx2;  dx[2] = pG->dx3;
 
-  /* shift the particles */
-  shift_packed_particle(send_buf, n, 2, -Lx2);
+  for (p=0; p<np; p++) {
+    gr = &(pG->particle[p]);
+    if (gr->pos == 0) continue; /* ghost particles are not exchanged */
 
-  /* copy boudary particles to the rear */
-  unpack_particle(pG, send_buf, n);
+    x[0] = gr->x1;  x[1] = gr->x2;  x[2] = gr->x3;
 
-  return;
-}
+    /* offset of the Grid the particle has crossed into */
+    cross = 0;
+    for (dir=0; dir<3; dir++) {
+      d[dir] = 0;
+      if ((gr->pos >= 10) && (pG->Nx[dir] > 1)) {
+        if ((x[dir] < pG->MinX[dir]) && xchg[dir][0]) d[dir] = -1;
+        if ((x[dir] >= pG->MaxX[dir]) && xchg[dir][1]) d[dir] = 1;
+      }
+      cross = cross || (d[dir] != 0);
+    }
 
-/*----------------------------------------------------------------------------*/
-/*! \fn static void periodic_ox2_particle(GridS *pG)
- *  \brief PERIODIC boundary conditions, Outer x2 boundary (ibc_x2=4)
- */
-static void periodic_ox2_particle(GridS *pG)
-{
-  long n = 0;
+    if (cross) {
+      g = *gr;
+      s = route_particle(pG, pD, d, &g);
+      if (s == nbr_self) {
+        if (pack == 1) *gr = g; /* move in place */
+      }
+      else if (pack == 1)
+        packing_one_particle(&g, cur[s]++, 10);
+      else
+        nbr_cnt[s] += 1;
+      continue;
+    }
 
-  /* pack boundary particles */
-  n = packing_ix2_particle(pG, nbc);
+    if (nbc == 0) continue;
 
-  /* shift the particles */
-  shift_packed_particle(send_buf, n, 2, Lx2);
+    /* ghost particles in the boundary layers */
+    for (dir=0; dir<3; dir++) {
+      lay[dir][0] = (pG->Nx[dir] > 1) && xchg[dir][0] &&
+                    (x[dir] < pG->MinX[dir] + nbc*dx[dir]);
+      lay[dir][1] = (pG->Nx[dir] > 1) && xchg[dir][1] &&
+                    (x[dir] >= pG->MaxX[dir] - nbc*dx[dir]);
+    }
 
-  /* copy boudary particles to the rear */
-  unpack_particle(pG, send_buf, n);
+    for (o[2]=-1; o[2]<=1; o[2]++) {
+    for (o[1]=-1; o[1]<=1; o[1]++) {
+    for (o[0]=-1; o[0]<=1; o[0]++) {
+      if ((o[0] == 0) && (o[1] == 0) && (o[2] == 0)) continue;
+      for (dir=0; dir<3; dir++)
+        if ((o[dir] != 0) && !lay[dir][(o[dir]+1)/2]) break;
+      if (dir < 3) continue;
+
+      g = *gr;
+      s = route_particle(pG, pD, o, &g);
+      if (pack == 1)
+        packing_one_particle(&g, cur[s]++, 0);
+      else
+        nbr_cnt[s] += 1;
+    }}}
+  }
 
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static void periodic_ix3_particle(GridS *pG)
- *  \brief PERIODIC boundary conditions, Inner x3 boundary (ibc_x3=4)
+/*! \fn static int route_particle(GridS *pG, DomainS *pD, const int *d,
+ *                                GrainS *gr)
+ *  \brief Maps a particle to the Grid at offset d (-1,0,1 in each direction)
+ *
+ * Across a periodic boundary the position is shifted by the domain size.
+ * Across the shearing x1 boundaries the velocity is also shifted by vshear
+ * (unless FARGO), and for ShBoxCoord = xy the position by the shear in y,
+ * which then decides the destination Grid in y.
+ * Return: the slot of the destination Grid in the list of exchange partners
  */
-static void periodic_ix3_particle(GridS *pG)
+static int route_particle(GridS *pG, DomainS *pD, const int *d, GrainS *gr)
 {
-  long n = 0;
-
-  /* pack boundary particles */
-  n = packing_ox3_particle(pG, nbc);
-
-  /* shift the particles */
-  shift_packed_particle(send_buf, n, 3, -Lx3);
-
-  /* copy boudary particles to the rear */
-  unpack_particle(pG, send_buf, n);
+  int ind[3], s, id;
 
-  return;
-}
+  ind[0] = my_iproc + d[0];
+  ind[1] = my_jproc + d[1];
+  ind[2] = my_kproc + d[2];
 
-/*----------------------------------------------------------------------------*/
-/*! \fn static void periodic_ox3_particle(GridS *pG)
- *  \brief PERIODIC boundary conditions, Outer x3 boundary (ibc_x3=4)
- */
-static void periodic_ox3_particle(GridS *pG)
-{
-  long n = 0;
+  if (ind[1] < 0) {
+    ind[1] += pD->NGrid[1];	gr->x2 += Lx2;
+  }
+  else if (ind[1] >= pD->NGrid[1]) {
+    ind[1] -= pD->NGrid[1];	gr->x2 -= Lx2;
+  }
 
-  /* pack boundary particles */
-  n = packing_ix3_particle(pG, nbc);
+  if (ind[2] < 0) {
+    ind[2] += pD->NGrid[2];	gr->x3 += Lx3;
+  }
+  else if (ind[2] >= pD->NGrid[2]) {
+    ind[2] -= pD->NGrid[2];	gr->x3 -= Lx3;
+  }
 
-  /* shift the particles */
-  shift_packed_particle(send_buf, n, 3, Lx3);
+  if (ind[0] < 0) {
+    ind[0] += pD->NGrid[0];	gr->x1 += Lx1;
+#ifdef SHEARING_BOX
+#ifndef FARGO
+    /* velocity shift for shearing box */
+    if (ShBoxCoord == xy) gr->v2 -= vshear;
+    else                  gr->v3 -= vshear;
+#endif
+    if (ShBoxCoord == xy)
+      ind[1] = shear_row(pG, pD, ind[2], ind[0], -yshift, gr);
+#endif /* SHEARING_BOX */
+  }
+  else if (ind[0] >= pD->NGrid[0]) {
+    ind[0] -= pD->NGrid[0];	gr->x1 -= Lx1;
+#ifdef SHEARING_BOX
+#ifndef FARGO
+    /* velocity shift for shearing box */
+    if (ShBoxCoord == xy) gr->v2 += vshear;
+    else                  gr->v3 += vshear;
+#endif
+    if (ShBoxCoord == xy)
+      ind[1] = shear_row(pG, pD, ind[2], ind[0], yshift, gr);
+#endif /* SHEARING_BOX */
+  }
 
-  /* copy boudary particles to the rear */
-  unpack_particle(pG, send_buf, n);
+#ifdef MPI_PARALLEL
+  id = pD->GData[ind[2]][ind[1]][ind[0]].ID_Comm_Domain;
+#else
+  id = 0;
+#endif
+  for (s=0; s<nnbr; s++)
+    if (nbr_id[s] == id) return s;
 
-  return;
+  ath_error("[bvals_particle]: particle at (%e,%e,%e) beyond neighbour Grids\n",
+            gr->x1, gr->x2, gr->x3);
+  return -1;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -2041,34 +1544,6 @@ static void packing_one_particle(GrainS *gr, long n, short pos)
   return;
 }
 
-/*----------------------------------------------------------------------------*/
-/*! \fn static void shift_packed_particle(double *buf, long n, int index, 
- *					  double shift)
- *  \brief shift the coordinate/velocity of the packed particles by a constant 
- *  amount
- *
- * Input:
- *   buf: buffer;	n: number of particles in the buffer
- *   index: 1: x1; 2: x2; 3: x3; 4: v1; 5: v2; 6: v3;
- *   shift: amount of change.
- * Output:
- *   buf: buffer with shifted particles
- */
-static void shift_packed_particle(double *buf, long n, int index, double shift)
-{
-  double *pd = buf;
-  long i;
-
-  if (n>0) pd += index-1;
-  for (i=0; i<n-1; i++) {
-    *pd += shift;
-    pd += NVAR_P;
-  }
-  *pd += shift;
-
-  return;
-}
-
 /*----------------------------------------------------------------------------*/
 /*! \fn static void unpack_particle(GridS *pG, double *buf, long n)
  *  \brief Unpack received particle
@@ -2114,493 +1589,135 @@ static void unpack_particle(GridS *pG, double *buf, long n)
 
 #ifdef SHEARING_BOX
 /*----------------------------------------------------------------------------*/
-/*! \fn static void shearingbox_ix1_particle(GridS *pG, DomainS *pD,long numpar)
- *  \brief Shearing box boundary condition, Inner x1 boundary (ibc_x1=4)
+/*! \fn static void shear_nbrs(GridS *pG, DomainS *pD)
+ *  \brief Adds the Grids across the shearing x1 boundaries to the exchange
+ *   partners, for the current shear
  *
- * This routine works only for ShBoxCoord = xy.
- * Input: numpar: for the packing routine, the array index to start with.
+ * A Grid at the outer x1 boundary may send particles to any Grid at the inner
+ * boundary whose y range overlaps its own (extended by nghost cells) shifted
+ * by +yshift, and receive from it if that Grid's range shifted by -yshift
+ * overlaps its own; the same test is made from the other side, so that both
+ * Grids of every pair list each other.  Only for ShBoxCoord = xy.
  */
-static void shearingbox_ix1_particle(GridS *pG, DomainS *pD, long numpar)
+static void shear_nbrs(GridS *pG, DomainS *pD)
 {
-#ifdef MPI_PARALLEL
-  /* amount of shear, whole (yshear) and fractional (yshift) */
-  Real yshear, yshift;
-  Real x2len;			/* length in x2 (y) direction of a grid */
-  int id1s, id1r, id2s, id2r;	/* processor ids to send and receive data */
-  int ind1, ind2, ind3;		/* x1,x2,x3 indices of grid in the domain */
-  long n1, n2;			/* number of packed particles */
-  long cnt_recv;		/* received number of particles */
-  int err;
-  MPI_Request rq;
-  MPI_Status stat;
-#endif /* MPI_PARALLEL */
-
-#ifndef MPI_PARALLEL
-  packing_ix1_particle_shear(pG, 0, numpar);
-#else
-/*----------------- MPI case: Step 1. Find locations -------------------------*/
-
-  /* compute the distance the computational domain has sheared in y */
-  yshear = vshear*pG->time;
-  yshift = fmod(yshear, Lx2);
-  x2len = pG->dx2*pG->Nx[1];
-
-  /* obtain processor ids to send and receive */
-  ind1 = 0;		ind3 = my_kproc;
-  ind2 = my_jproc + (int)(yshift/x2len) + 1;
-  if (ind2 > (pD->NGrid[1]-1)) ind2 -= pD->NGrid[1];
-  if (ind2 > (pD->NGrid[1]-1)) ind2 -= pD->NGrid[1];
-  id1s = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region I (send to) */
-
-  ind2 = my_jproc + (int)(yshift/x2len);
-  if (ind2 > (pD->NGrid[1]-1)) ind2 -= pD->NGrid[1];
-  id2s = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region II(send to) */
-
-  ind2 = my_jproc - (int)(yshift/x2len) - 1;
-  if (ind2 < 0) ind2 += pD->NGrid[1];
-  if (ind2 < 0) ind2 += pD->NGrid[1];
-  id1r = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region I (rcv from)*/
-
-  ind2 = my_jproc - (int)(yshift/x2len);
-  if (ind2 < 0) ind2 += pD->NGrid[1];
-  id2r = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region II(rcv from)*/
-
-/*------------------MPI case: Step 2. Exchange particles ---------------------*/
-
-  /* packing particles at region I */
-  n1 = packing_ix1_particle_shear(pG, 1, numpar);
-
-/*-------- sub-step 1: exchange rigion I (id1) --------*/
-
-  /* send and receive buffer size to/from region I (id1) */
-  /* Post a non-blocking receive for the data size */
-  err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, id1r,
-                             boundary_particle_tag, MPI_COMM_WORLD, &rq);
-  if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-  /* send buffer size */
-  err = MPI_Send(&n1, 1, MPI_LONG, id1s, boundary_particle_tag, MPI_COMM_WORLD);
-  if(err) ath_error("[send_ix1_particle_shear]: MPI_Send error = %d\n",err);
-
-  /* receive buffer size from */
-  err = MPI_Wait(&rq, &stat);
-  if(err) ath_error("[receive_ix1_particle_shear]: MPI_Wait error = %d\n",err);
-
-  /* check space for the receive buffer */
-  if ((cnt_recv+1) >= recv_bufsize)
-    realloc_recvbuf(cnt_recv+1);
-
-  /* send and receive buffer to/from region I (id1) */
-  if (cnt_recv > 0) {
-    /* Post a non-blocking receive for the data from outer region I */
-    err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, id1r,
-                              boundary_particle_tag, MPI_COMM_WORLD, &rq);
-    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-  }
-
-  if (n1 > 0) {
-    /* send buffer */
-    err = MPI_Send(send_buf, n1*NVAR_P, MPI_DOUBLE, id1s,
-                             boundary_particle_tag, MPI_COMM_WORLD);
-    if(err) ath_error("[send_ix1_particle_shear]: MPI_Send error = %d\n",err);
-  }
-
-  /* packing particles at region II (N.B.!) */
-  n2 = packing_ix1_particle_shear(pG, 2, numpar);
-  if (cnt_recv > 0) {
-    /* receive buffer */
-    err = MPI_Wait(&rq, &stat);
-    if(err) ath_error("[recv_ix1_particle_shear]: MPI_Wait error = %d\n",err);
-
-    /* unpack the received particles */
-    unpack_particle(pG, recv_buf, cnt_recv);
-  }
-
-/*-------- sub-step 2: exchange region II (id2)  --------*/
-
-  /* send and receive buffer size to/from region II (id2) */
-  /* Post a non-blocking receive for the data size */
-  err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, id2r,
-                             boundary_particle_tag, MPI_COMM_WORLD, &rq);
-  if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
+  int i, j, k, f;
+  Real a0, a1, b0, b1, dy;
 
-  /* send buffer size */
-  err = MPI_Send(&n2, 1, MPI_LONG, id2s, boundary_particle_tag, MPI_COMM_WORLD);
-  if(err) ath_error("[send_ix1_particle_shear]: MPI_Send error = %d\n",err);
-
-  /* receive buffer size */
-  err = MPI_Wait(&rq, &stat);
-  if(err) ath_error("[receive_ix1_particle_shear]: MPI_Wait error = %d\n",err);
-
-  /* check space for the receive buffer */
-  if ((cnt_recv+1) >= recv_bufsize)
-    realloc_recvbuf(cnt_recv+1);
-
-  /* send and receive buffer to/from region II (id2) */
-  if (cnt_recv > 0) {
-    /* Post a non-blocking receive for the data */
-    err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, id2r,
-                              boundary_particle_tag, MPI_COMM_WORLD, &rq);
-    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-  }
-
-  if (n2 > 0) {
-    /* send buffer */
-    err = MPI_Send(send_buf, n2*NVAR_P, MPI_DOUBLE, id2s,
-                             boundary_particle_tag, MPI_COMM_WORLD);
-    if(err) ath_error("[send_ix1_particle_shear]: MPI_Send error = %d\n",err);
-  }
-
-  if (cnt_recv > 0) {
-    /* receive buffer */
-    err = MPI_Wait(&rq, &stat);
-    if(err) ath_error("[recv_ix1_particle_shear]: MPI_Wait error = %d\n",err);
-
-    /* unpack the received particles */
-    unpack_particle(pG, recv_buf, cnt_recv);
-  }
-
-#endif /* MPI_PARALLEL */
-
-  return;
-}
+  nnbr = nnbr_fix;
+  if ((ShBoxCoord != xy) || (pG->Nx[0] == 1) || !xchg[0][0] || !xchg[0][1])
+    return;
 
-/*----------------------------------------------------------------------------*/
-/*! \fn static void shearingbox_ox1_particle(GridS *pG, DomainS *pD,long numpar)
- *  \brief Shearing box boundary condition, Outer x1 boundary (obc_x1=4)
- *
- * This routine works only for ShBoxCoord = xy.
- * Input: numpar: for the packing routine, the array index to start with.
- */
-static void shearingbox_ox1_particle(GridS *pG, DomainS *pD, long numpar)
-{
+  a0 = pG->MinX[1];	a1 = pG->MaxX[1];
+  dy = nghost*pG->dx2;
+
+  for (f=-1; f<=1; f++) {
+    k = my_kproc + f;
+    if ((f != 0) && ((pG->Nx[2] == 1) || ((k < 0) && !xchg[2][0]) ||
+                     ((k >= pD->NGrid[2]) && !xchg[2][1]))) continue;
+    if (k < 0) k += pD->NGrid[2];
+    if (k >= pD->NGrid[2]) k -= pD->NGrid[2];
+
+    for (j=0; j<pD->NGrid[1]; j++) {
+      if (my_iproc == pD->NGrid[0]-1) { /* outer boundary */
+        i = 0;
+        b0 = x2min + pD->GData[k][j][i].Disp[1]*pG->dx2;
+        b1 = b0 + pD->GData[k][j][i].Nx[1]*pG->dx2;
+        if (shear_overlap(a0, a1, b0, b1, yshift, dy) ||
+            shear_overlap(b0, b1, a0, a1, -yshift, dy))
 #ifdef MPI_PARALLEL
-  /* amount of shear, whole (yshear) and fractional (yshift) */
-  Real yshear, yshift;
-  Real x2len;			/* length in x2 (y) direction of a grid */
-  int id1s, id1r, id2s, id2r;	/* processor ids to send and receive data */
-  int ind1, ind2, ind3;		/* x1,x2,x3 indices of grid in the domain */
-  long n1, n2;			/* number of packed particles */
-  long cnt_recv;		/* received number of particles */
-  int err;
-  MPI_Request rq;
-  MPI_Status stat;
-#endif /* MPI_PARALLEL */
-
-#ifndef MPI_PARALLEL
-  packing_ox1_particle_shear(pG, 0, numpar);
+          add_nbr(pD->GData[k][j][i].ID_Comm_Domain);
 #else
-/*--------------------- MPI case: Step 1. Find locations ---------------------*/
-
-  /* compute the distance the computational domain has sheared in y */
-  yshear = vshear*pG->time;
-  yshift = fmod(yshear, Lx2);
-  x2len = pG->dx2*pG->Nx[1];
-
-  /* obtain processor ids to send and receive */
-  ind1 = pD->NGrid[0]-1;	ind3 = my_kproc;
-  ind2 = my_jproc - (int)(yshift/x2len) - 1;
-  if (ind2 < 0) ind2 += pD->NGrid[1];
-  if (ind2 < 0) ind2 += pD->NGrid[1];
-  id1s = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region I (send to) */
-
-  ind2 = my_jproc - (int)(yshift/x2len);
-  if (ind2 < 0) ind2 += pD->NGrid[1];
-  id2s = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region II(send to) */
-
-  ind2 = my_jproc + (int)(yshift/x2len) + 1;
-  if (ind2 > (pD->NGrid[1]-1)) ind2 -= pD->NGrid[1];
-  if (ind2 > (pD->NGrid[1]-1)) ind2 -= pD->NGrid[1];
-  id1r = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region I (rcv from)*/
-
-  ind2 = my_jproc + (int)(yshift/x2len);
-  if (ind2 > (pD->NGrid[1]-1)) ind2 -= pD->NGrid[1];
-  id2r = pD->GData[ind3][ind2][ind1].ID_Comm_Domain;/* for region II(rcv from)*/
-
-/*--------------MPI case: Step 2. Exchange particles -------------------------*/
-
-  /* packing particles at region I */
-  n1 = packing_ox1_particle_shear(pG, 1, numpar);
-
-/*-------- sub-step 1: outer region I with inner rigion I (id1) --------*/
-  /* send and receive buffer size to/from inner region I (id1) */
-  /* Post a non-blocking receive for the data size from inner regiion I */
-  err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, id1r,
-                             boundary_particle_tag, MPI_COMM_WORLD, &rq);
-  if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-  /* send buffer size to inner region I */
-  err = MPI_Send(&n1, 1, MPI_LONG, id1s, boundary_particle_tag, MPI_COMM_WORLD);
-  if(err) ath_error("[send_ox1_particle_shear]: MPI_Send error = %d\n",err);
-
-  /* receive buffer size from the inner region I */
-  err = MPI_Wait(&rq, &stat);
-  if(err) ath_error("[recc_ox1_particle_shear]: MPI_Wait error = %d\n",err);
-
-  /* check space for the receive buffer */
-  if ((cnt_recv+1) >= recv_bufsize)
-    realloc_recvbuf(cnt_recv+1);
-
-  /* send and receive buffer to/from inner region I (id1) */
-  if (cnt_recv > 0) {
-    /* Post a non-blocking receive for the data from inner region I */
-    err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, id1r,
-                              boundary_particle_tag, MPI_COMM_WORLD, &rq);
-    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-  }
-
-  if (n1 > 0) {
-    /* send buffer to inner region I */
-    err = MPI_Send(send_buf, n1*NVAR_P, MPI_DOUBLE, id1s,
-                             boundary_particle_tag, MPI_COMM_WORLD);
-    if(err) ath_error("[send_ox1_particle_shear]: MPI_Send error = %d\n",err);
-  }
-
-  /* packing particles at region II (N.B.!) */
-  n2 = packing_ox1_particle_shear(pG, 2, numpar);
-  if (cnt_recv > 0) {
-    /* receive buffer inner region I */
-    err = MPI_Wait(&rq, &stat);
-    if(err) ath_error("[recv_ox1_particle_shear]: MPI_Wait error = %d\n",err);
-
-    /* unpack the received particle */
-    unpack_particle(pG, recv_buf, cnt_recv);
-  }
-
-/*-------- sub-step 2: outer region II with inner region II (id2)  --------*/
-
-  /* send and receive buffer size to/from inner region II (id2) */
-  /* Post a non-blocking receive for the data size from inner region II */
-  err = MPI_Irecv(&cnt_recv, 1, MPI_LONG, id2r,
-                             boundary_particle_tag, MPI_COMM_WORLD, &rq);
-  if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-
-  /* send buffer size to inner region II */
-  err = MPI_Send(&n2, 1, MPI_LONG, id2s, boundary_particle_tag, MPI_COMM_WORLD);
-  if(err) ath_error("[send_ox1_particle_shear]: MPI_Send error = %d\n",err);
-
-  /* receive buffer size from inner region II */
-  err = MPI_Wait(&rq, &stat);
-  if(err) ath_error("[recv_ox1_particle_shear]: MPI_Wait error = %d\n",err);
-
-  /* check space for the receive buffer */
-  if ((cnt_recv+1) >= recv_bufsize)
-    realloc_recvbuf(cnt_recv+1);
-
-  /* send and receive buffer to/from inner region II (id2) */
-  if (cnt_recv > 0) {
-    /* Post a non-blocking receive for the data from inner region II */
-    err = MPI_Irecv(recv_buf, cnt_recv*NVAR_P, MPI_DOUBLE, id2r,
-                              boundary_particle_tag, MPI_COMM_WORLD, &rq);
-    if(err) ath_error("[set_bvals_particle]: MPI_Irecv error = %d\n",err);
-  }
-
-  if (n2 > 0) {
-    /* send buffer to inner region II */
-    err = MPI_Send(send_buf, n2*NVAR_P, MPI_DOUBLE, id2s,
-                             boundary_particle_tag, MPI_COMM_WORLD);
-    if(err) ath_error("[send_ox1_particle_shear]: MPI_Send error = %d\n",err);
-  }
-
-  if (cnt_recv > 0) {
-    /* receive buffer from inner region II */
-    err = MPI_Wait(&rq, &stat);
-    if(err) ath_error("[recv_ox1_particle_shear]: MPI_Wait error = %d\n",err);
-
-    /* unpack the received particle */
-    unpack_particle(pG, recv_buf, cnt_recv);
+          add_nbr(0);
+#endif
+      }
+      if (my_iproc == 0) { /* inner boundary */
+        i = pD->NGrid[0]-1;
+        b0 = x2min + pD->GData[k][j][i].Disp[1]*pG->dx2;
+        b1 = b0 + pD->GData[k][j][i].Nx[1]*pG->dx2;
+        if (shear_overlap(a0, a1, b0, b1, -yshift, dy) ||
+            shear_overlap(b0, b1, a0, a1, yshift, dy))
+#ifdef MPI_PARALLEL
+          add_nbr(pD->GData[k][j][i].ID_Comm_Domain);
+#else
+          add_nbr(0);
+#endif
+      }
+    }
   }
 
-#endif /* MPI_PARALLEL */
-
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static long packing_ix1_particle_shear(GridS *pG, int reg, long numpar)
- *  \brief Packing the particle inside the inner x1 boundary for shearing box
- *
- * Input: pG: grid; reg: region, 1 or 2 for mpi case, 0 for non-mpi case
- *        numpar: array index to start with.
- * Return: number of packed particles in the specified region.
- * Note: this routine serves for only 3D
- */
-static long packing_ix1_particle_shear(GridS *pG, int reg, long numpar)
+/*! \fn static int shear_overlap(Real a0, Real a1, Real b0, Real b1,
+ *                               Real shift, Real dy)
+ *  \brief Whether [a0-dy,a1+dy) shifted by shift overlaps [b0,b1), periodic
+ *   in y */
+static int shear_overlap(Real a0, Real a1, Real b0, Real b1,
+                         Real shift, Real dy)
 {
-  GrainS *gr;		/* current pointer */
-  long n, p;
-  Real ix1b;		/* coordinate limit in x1 inner boundary */
-  /* amount of shear, whole (yshear) and fractional (yshift) */
-  Real yshear, yshift;
-  /* x2c: y-coordinate marking the demarcation of the two regions */
-  Real x20, x2c;
-  double *pd;
-
-/*---------------- Step.1 -----------------------*/
-  /* get the distance of shear */
-  yshear = vshear*pG->time;
-  yshift = fmod(yshear, Lx2);
-  x20 = pG->MaxX[1];
-  x2c = x20 - fmod(yshear, pG->dx2*pG->Nx[1]);
-
-  /* get coordinate limits for particles to be packed*/
-  ix1b = pG->MinX[0];
-
-  /* buffer assignment */
-  pd = send_buf;
-  n = 0;
-
-/*---------------- Step.2 -----------------------*/
-  /* loop over all particle to pack particles in the boundary */
-  p = numpar;
-  while (p<pG->nparticle) {
-    gr = &(pG->particle[p]);
-    p += 1;
-    if ((gr->pos == 21) || ( (gr->pos == 0) && (gr->x1 < ix1b)))
-    { /* crossing particle or ghost particle from ox1 */
-
-      if (((reg == 1) && (gr->x2 >= x2c)) || ((reg == 2) && (gr->x2 < x2c)))
-      {         /* region I */                      /* region II */
-        /* apply the shift */
-        gr->x2 = x2min + fmod(gr->x2 - x2min + yshift, Lx2);
-
-        /* pack the particle */
-        packing_one_particle(gr, n, gr->pos);
-        n += 1;
-
-        /* delete the particle */
-        pG->nparticle -= 1;
-        grproperty[gr->property].num -= 1;
-        p -= 1;
-        pG->particle[p] = pG->particle[pG->nparticle];
-      }
+  Real lo, hi, sh;
 
-      if (reg == 0) /* non-mpi case, directly shift the particle positions */
-        gr->x2 = x2min + fmod(gr->x2 - x2min + yshift, Lx2);
-    }
-  }
+  lo = a0 - dy + shift;
+  hi = a1 + dy + shift;
+  sh = Lx2*floor((lo - x2min)/Lx2);
+  lo -= sh;	hi -= sh;
 
-  return n;
+  return ((lo < b1) && (hi > b0)) || ((lo - Lx2 < b1) && (hi - Lx2 > b0));
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn static long packing_ox1_particle_shear(GridS *pG, int reg, long numpar)
- *  \brief Packing the particle outside the outer x1 boundary for shearing box
- *
- * Input: pG: grid; reg: region, 1 or 2 for mpi case, 0 for non-mpi case
- *        numpar: array index to start with.
- * Return: number of packed particles in the specified region.
- * Note: this routine serves for only 3D
- */
-static long packing_ox1_particle_shear(GridS *pG, int reg, long numpar)
+/*! \fn static int shear_row(GridS *pG, DomainS *pD, int k, int i,
+ *                           Real shift, GrainS *gr)
+ *  \brief Shifts a particle crossing the shearing x1 boundary by shift in y,
+ *   and finds the Grid of column (k,i) which it lies in.
+ * Return: the index of that Grid in y */
+static int shear_row(GridS *pG, DomainS *pD, int k, int i,
+                     Real shift, GrainS *gr)
 {
-  GrainS *gr;		/* current pointer */
-  long n, p;
-  Real ox1b;		/* coordinate limit of x1 outer boundary */
-  /* amount of shear, whole (yshear) and fractional (yshift) */
-  Real yshear, yshift;
-  /* x2c: y-coordinate marking the demarcation of the two regions */
-  Real x20, x2c;
-  double *pd;
-
-/*---------------- Step.1 -----------------------*/
-  /* get the distance of shear */
-  yshear = vshear*pG->time;
-  yshift = fmod(yshear, Lx2);
-  x20 = pG->MinX[1];
-  x2c = x20 + fmod(yshear, pG->dx2*pG->Nx[1]);
+  int j;
+  Real y;
 
-  /* get coordinate limits for particles to be packed*/
-  ox1b = pG->MaxX[0];
+  y = fmod(gr->x2 - x2min + shift, Lx2);
+  if (y < 0.0) y += Lx2;
+  gr->x2 = x2min + y;
 
-  /* buffer assignment */
-  pd = send_buf;
-  n = 0;
-
-/*---------------- Step.2 -----------------------*/
-  /* loop over all particle to pack particles in the boundary */
-  p = numpar;
-  while (p<pG->nparticle) {
-    gr = &(pG->particle[p]);
-    p += 1;
-    if ((gr->pos == 11) || ( (gr->pos == 0) && (gr->x1 >= ox1b)))
-    { /* crossing particle or ghost particle from ix1 */
-
-      if (((reg == 1) && (gr->x2 < x2c)) || ((reg == 2) && (gr->x2 >= x2c)))
-      {         /* region I */                      /* region II */
-
-        /* apply the shift */
-        gr->x2 = x2min + fmod(gr->x2 - x2min + Lx2 - yshift, Lx2);
-
-        /* pack the particle */
-        packing_one_particle(gr, n, gr->pos);
-        n += 1;
-
-        /* delete the particle */
-        pG->nparticle -= 1;
-        grproperty[gr->property].num -= 1;
-        p -= 1;
-        pG->particle[p] = pG->particle[pG->nparticle];
-      }
-      if (reg == 0) /* non-mpi case, directly shift the particle positions */
-        gr->x2 = x2min + fmod(gr->x2 - x2min + Lx2 - yshift, Lx2);
-    }
-  }
+  for (j=pD->NGrid[1]-1; j>0; j--)
+    if (y >= pD->GData[k][j][i].Disp[1]*pG->dx2) break;
 
-  return n;
+  return j;
 }
 
-#ifdef FARGO
+#if defined(FARGO) && defined(MPI_PARALLEL)
 /*----------------------------------------------------------------------------*/
-/*! \fn static long packing_particle_fargo(GridS *pG, Real yl, Real yu)
- *  \brief Packing the particle for FARGO
+/*! \fn static int fargo_slot(GridS *pG, DomainS *pD, const GrainS *gr,
+ *                            int nf, const int *frow)
+ *  \brief Finds the Grid which a particle advected by FARGO has moved to.
  *
- * Input: pG: grid; 
- *        yl, yu: lower and upper limit of x2 (y) coordinate for particles to
- *                be packed
- * Return: number of packed particles in the specified region.
+ * Input: nf, frow: number of Grids exchanged with, and their index in y
+ * Return: -1 if the particle is still in this Grid, otherwise the index of
+ *   its Grid in frow
  */
-static long packing_particle_fargo(GridS *pG, Real yl, Real yu)
+static int fargo_slot(GridS *pG, DomainS *pD, const GrainS *gr,
+                      int nf, const int *frow)
 {
-  GrainS *gr;
-  long p, n;
-  double *pd;
+  GrainS g;
+  int j, s;
 
-  p = 0;
-  n = 0;
-  pd = send_buf;
-  while (p<pG->nparticle) {
-    gr = &(pG->particle[p]);
-    p += 1;
-    if ((gr->x2 >= yl) && (gr->x2 < yu))
-    { /* pack the particle as it is */
-      packing_one_particle(gr, n, gr->pos);
-      n += 1;
-
-      /* delete the particle */
-      pG->nparticle -= 1;
-      grproperty[gr->property].num -= 1;
-      p -= 1;
-      pG->particle[p] = pG->particle[pG->nparticle];
-    }
-  }
+  if ((gr->x2 >= pG->MinX[1]) && (gr->x2 < pG->MaxX[1]))
+    return -1;
 
-  return n;
-}
+  g = *gr;
+  j = shear_row(pG, pD, my_kproc, my_iproc, 0.0, &g);
+  for (s=0; s<nf; s++)
+    if (frow[s] == j) return s;
 
-/*----------------------------------------------------------------------------*/
-/*! \fn static int gridshift(Real shift)
- *  \brief Get the number of grids to be shifted in the y direction */
-static int gridshift(Real shift)
-{
-  if (shift>0)
-    return (int)(shift)+1;
-  else if (shift<0)
-    return (int)(shift)-1;
-  else return 0;
+  ath_error("[advect_particles]: particle at x2=%e beyond the Grids in reach\n",
+            gr->x2);
+  return -1;
 }
-
-#endif /* FARGO */
+#endif /* FARGO && MPI_PARALLEL */
 
 #endif /* SHEARING_BOX */
 
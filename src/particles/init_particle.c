@@ -156,6 +156,20 @@ void init_particle(MeshS *pM)
   pG->Coup = (GPCouple***)calloc_3d_array(N3T,N2T,N1T, sizeof(GPCouple));
   if (pG->Coup == NULL) goto on_error;
 
+  /* cell offsets of the particles are allocated by the first shuffle() */
+  pG->parcell = NULL;
+  pG->cellkey = NULL;
+  pG->parsorted = 0;
+
+#ifdef MPI_PARALLEL
+  /* cost of the particles for load balancing, see record_grid_cost() */
+  pG->ptime = 0.0;
+  for (i=0; i<3; i++) {
+    pG->parprof[i] = (Real*)calloc_1d_array(pG->Nx[i], sizeof(Real));
+    if (pG->parprof[i] == NULL) goto on_error;
+  }
+#endif
+
 #ifdef SHEARING_BOX
   if (pG->Nx[2] > 1) /* 3D */
     ShBoxCoord = xy;
@@ -175,6 +189,9 @@ void particle_destruct(MeshS *pM)
 {
   DomainS *pD = (DomainS*)&(pM->Domain[0][0]); 
   GridS *pG = pD->Grid; 
+#ifdef MPI_PARALLEL
+  int i;
+#endif
 
   free_1d_array(pG->particle);
   free_1d_array(pG->parsub);
@@ -185,6 +202,12 @@ void particle_destruct(MeshS *pM)
   /* free memory for gas and feedback arrays */
   if (pG->Coup != NULL) free_3d_array(pG->Coup);
 
+  shuffle_destruct(pG);
+
+#ifdef MPI_PARALLEL
+  for (i=0; i<3; i++) free_1d_array(pG->parprof[i]);
+#endif
+
   return;
 }
 
@@ -15,9 +15,16 @@
  * - feedback_corrector()
  *
  * PRIVATE FUNCTION PROTOTYPES:
+ * - Integrate_Range()- integrate the particles in a list of index ranges
+ * - Predict_Range()  - feedback of the predictor step for a list of ranges
+ * - Deposit_FB()     - distribute the feedback of one particle to the grid
+ * - Tiled_Loop()     - threaded loop over the particles in colored cell tiles
+ * - Deposit_Deferred()-distribute the feedback deferred by Deposit_FB()
  * - Delete_Ghost()   - delete ghost particles
  * - JudgeCrossing()  - judge if the particle cross the grid boundary
- * - Get_Drag()       - calculate the drag force
+ * - Predict_Block()  - predict the positions of a block of particles
+ * - Get_Drag_Block() - calculate the drag force on a block of particles
+ * - Get_Force_Block()- calculate forces other than the drag on a block
  * - Get_Force()      - calculate forces other than the drag
  *
  * REFERENCE:
@@ -26,6 +33,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include "../defs.h"
 #include "../athena.h"
 #include "../prototypes.h"
@@ -35,18 +43,90 @@
 
 #ifdef PARTICLES         /* endif at the end of the file */
 
+/* With OpenMP the particles are integrated by many threads at once, and the
+ * feedback, which each particle scatters to the cells around it, is
+ * deposited tile by tile.  A tile is FBTILE cells wide in (up to) the two
+ * outermost dimensions that do not collapse.  The tiles are colored like a
+ * checkerboard, and the tiles of one color are done in parallel, one color
+ * after the other.  A thread may deposit into its tile and FBTILE/2 cells
+ * around it (its window); tiles of one color are FBTILE cells apart, so the
+ * windows never overlap.  The particles of a tile come from the cell-sorted
+ * particle array (see shuffle()).  Feedback from a particle whose stencil
+ * leaves the window is deferred and deposited after all the tiles, in the
+ * order of the particles.  The order in which each cell receives feedback
+ * hence does not depend on the number of threads, nor on their scheduling.
+ */
+#if defined(FEEDBACK) && defined(OPENMP_PARALLEL)
+#define FBTILE 4
+
+/* cells into which the thread may deposit feedback, per tiled dimension */
+typedef struct FBWindow_s{
+  int nd;                   /* number of tiled dimensions */
+  int dir[2];               /* tiled dimensions (0,1,2 for x1,x2,x3) */
+  int lo[2], hi[2];         /* first and last cell of the window */
+}FBWindow;
+
+static FBWindow *fbwin = NULL;  /* NULL: deposit without restriction */
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(fbwin)
+#endif
+
+/* feedback of one particle, deferred by Deposit_FB() */
+typedef struct FBDefer_s{
+  long p;                   /* particle index */
+  int pred;                 /* 1 for the predictor, 0 for the corrector */
+  int is, js, ks;
+  Real weight[3][3][3];
+  Real3Vect fb;
+  Real stiffness, Elosspar;
+}FBDefer;
+
+static FBDefer *fbdefer = NULL;
+static long ndefer = 0, defersize = 0;
+#endif /* FEEDBACK && OPENMP_PARALLEL */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
+ *   Integrate_Range()- integrate the particles in a list of index ranges
+ *   Predict_Range()  - feedback of the predictor step for a list of ranges
+ *   Deposit_FB()     - distribute the feedback of one particle to the grid
+ *   Tiled_Loop()     - threaded loop over the particles in colored cell tiles
+ *   Deposit_Deferred()-distribute the feedback deferred by Deposit_FB()
  *   Delete_Ghost()   - delete ghost particles
  *   JudgeCrossing()  - judge if the particle cross the grid boundary
- *   Get_Drag()       - calculate the drag force
+ *   Predict_Block()  - predict the positions of a block of particles
+ *   Get_Drag_Block() - calculate the drag force on a block of particles
+ *   Get_Force_Block()- calculate forces other than the drag on a block
  *   Get_Force()      - calculate forces other than the drag
  *   Get_ForceDiff()  - calculate the force difference between particle and gas
  *============================================================================*/
+void   Integrate_Range(GridS *pG, int nr, const long *pa, const long *pb,
+                       Real3Vect cell1);
+#ifdef FEEDBACK
+void   Predict_Range(GridS *pG, int nr, const long *pa, const long *pb,
+                     Real3Vect cell1);
+void   Deposit_FB(GridS *pG, long p, Real weight[3][3][3], int is, int js,
+                  int ks, Real3Vect fb, Real stiffness, Real Elosspar,
+                  int pred);
+#ifdef OPENMP_PARALLEL
+void   Tiled_Loop(GridS *pG, Real3Vect cell1,
+                  void (*work)(GridS *pG, int nr, const long *pa,
+                               const long *pb, Real3Vect cell1));
+void   Deposit_Deferred(GridS *pG);
+#endif /* OPENMP_PARALLEL */
+#endif /* FEEDBACK */
 void   Delete_Ghost(GridS *pG);
 void   JudgeCrossing(GridS *pG, Real x1, Real x2, Real x3, GrainS *gr);
-Real3Vect Get_Drag(GridS *pG, int type, Real x1, Real x2, Real x3,
-                Real v1, Real v2, Real v3, Real3Vect cell1, Real *tstop1);
+void   Predict_Block(GridS *pG, int n, Real h, const Real *x1, const Real *x2,
+                     const Real *x3, const Real *v1, const Real *v2,
+                     const Real *v3, Real *x1n, Real *x2n, Real *x3n);
+void   Get_Drag_Block(GridS *pG, int n, const int *type, const Real *x1,
+                      const Real *x2, const Real *x3, const Real *v1,
+                      const Real *v2, const Real *v3, Real3Vect cell1,
+                      Real *fd1, Real *fd2, Real *fd3, Real *tstop1);
+void   Get_Force_Block(GridS *pG, int n, const Real *x1, const Real *x2,
+                       const Real *x3, const Real *v1, const Real *v2,
+                       const Real *v3, Real *f1, Real *f2, Real *f3);
 Real3Vect Get_Force(GridS *pG, Real x1, Real x2, Real x3,
                                Real v1, Real v2, Real v3);
 
@@ -64,13 +144,20 @@ Real3Vect Get_Force(GridS *pG, Real x1, Real x2, Real x3,
  *       integrator.
  * Should use fully implicit integrator for tightly coupoled particles.
  * Otherwise the semi-implicit integrator performs better.
+ *
+ * Particles are integrated in blocks of NGRBLK by Integrate_Range().  With
+ * OpenMP the blocks are shared among the threads, and with FEEDBACK the
+ * particles are taken tile by tile (see Tiled_Loop()).
  */
 void Integrate_Particles(DomainS *pD)
 {
-  GrainS *curG, *curP, mygr;    /* pointer of the current working position */
-  long p;                       /* particle index */
-  Real dv1, dv2, dv3, ts, t1;   /* amount of velocity update, stopping time */
   Real3Vect cell1;              /* one over dx1, dx2, dx3 */
+#if !defined(FEEDBACK) || !defined(OPENMP_PARALLEL)
+  long pa, pb;                  /* range of particles of a block */
+#endif
+#ifdef MPI_PARALLEL
+  double tpar = MPI_Wtime();    /* start of the particle work */
+#endif
 
   GridS *pG = pD->Grid;         /* set ptr to Grid */
 
@@ -79,8 +166,6 @@ void Integrate_Particles(DomainS *pD)
   feedback_clear(pG);   /* clean the feedback array */
 #endif /* FEEDBACK */
 
-  curP = &(mygr);       /* temperory particle */
-
   /* cell1 is a shortcut expressions as well as dimension indicator */
   if (pG->Nx[0] > 1)  cell1.x1 = 1.0/pG->dx1;  else cell1.x1 = 0.0;
   if (pG->Nx[1] > 1)  cell1.x2 = 1.0/pG->dx2;  else cell1.x2 = 0.0;
@@ -89,368 +174,304 @@ void Integrate_Particles(DomainS *pD)
   /* delete all ghost particles */
   Delete_Ghost(pG);
 
-  p = 0;
-  while (p<pG->nparticle)
-  {/* loop over all particles */
-    curG = &(pG->particle[p]);
-
-/* Step 1: Calculate velocity update */
-    switch(grproperty[curG->property].integrator)
-    {
-      case 1: /* 2nd order explicit integrator */
-        int_par_exp(pG, curG, cell1, &dv1, &dv2, &dv3, &ts);
-        break;
-
-      case 2: /* 2nd order semi-implicit integrator */
-        int_par_semimp(pG, curG, cell1, &dv1, &dv2, &dv3, &ts);
-        break;
-
-      case 3: /* 2nd order fully implicit integrator */
-        int_par_fulimp(pG, curG, cell1, &dv1, &dv2, &dv3, &ts);
-        break;
-
-      default:
-        ath_error("[integrate_particle]: unknown integrator type!");
-    }
-
-/* Step 2: particle update to curP */
-
-    /* velocity update */
-    curP->v1 = curG->v1 + dv1;
-    curP->v2 = curG->v2 + dv2;
-    curP->v3 = curG->v3 + dv3;
-
-    /* position update */
-    if (pG->Nx[0] > 1)
-      curP->x1 = curG->x1 + 0.5*pG->dt*(curG->v1 + curP->v1);
-    else /* do not move if this dimension collapses */
-      curP->x1 = curG->x1;
-
-    if (pG->Nx[1] > 1)
-      curP->x2 = curG->x2 + 0.5*pG->dt*(curG->v2 + curP->v2);
-    else /* do not move if this dimension collapses */
-      curP->x2 = curG->x2;
-
-    if (pG->Nx[2] > 1)
-      curP->x3 = curG->x3 + 0.5*pG->dt*(curG->v3 + curP->v3);
-    else /* do not move if this dimension collapses */
-      curP->x3 = curG->x3;
-
-#ifdef FARGO
-    /* shift = -qshear * Omega_0 * x * dt */
-    pG->parsub[p].shift = -0.5*qshear*Omega_0*(curG->x1+curP->x1)*pG->dt;
+#if defined(FEEDBACK) && defined(OPENMP_PARALLEL)
+  Tiled_Loop(pG, cell1, Integrate_Range);
+#else
+#pragma omp parallel for schedule(static) private(pb)
+  for (pa=0; pa<pG->nparticle; pa+=NGRBLK) {
+    pb = MIN(pa+NGRBLK, pG->nparticle);
+    Integrate_Range(pG, 1, &pa, &pb, cell1);
+  }
 #endif
 
-/* Step 3: calculate feedback force to the gas */
-#ifdef FEEDBACK
-    feedback_corrector(pG, curG, curP, cell1, dv1, dv2, dv3, ts);
-#endif /* FEEDBACK */
-
-/* Step 4: Final update of the particle */
-    /* update particle status (crossing boundary or not) */
-    JudgeCrossing(pG, curP->x1, curP->x2, curP->x3, curG);
-
-    /* update the particle */
-    curG->x1 = curP->x1;
-    curG->x2 = curP->x2;
-    curG->x3 = curP->x3;
-    curG->v1 = curP->v1;
-    curG->v2 = curP->v2;
-    curG->v3 = curP->v3;
-    p++;
-
-  } /* end of the for loop */
-
   /* output the status */
   ath_pout(0, "In processor %d, there are %ld particles.\n",
                            myID_Comm_world, pG->nparticle);
 
+#ifdef MPI_PARALLEL
+  /* cost of the particles on this Grid, for load balancing */
+  count_particles(pG);
+  pG->ptime += MPI_Wtime() - tpar;
+#endif
+
   return;
 }
 
 /* ------------ 2nd order fully implicit particle integrator -----------------*/
-/*! \fn void int_par_fulimp(Grid *pG, Grain *curG, Real3Vect cell1, 
- *                            Real *dv1, Real *dv2, Real *dv3, Real *ts)
+/*! \fn void int_par_fulimp(GridS *pG, GrainBlock *pb, int q0, int q1,
+ *                          Real3Vect cell1)
  *  \brief 2nd order fully implicit particle integrator
  *
  * Input: 
- *   grid pointer (pG), grain pointer (curG), cell size indicator (cell1)
+ *   grid pointer (pG), block of particles (pb), range of the particles in the
+ *   block to update (q0 to q1-1), cell size indicator (cell1)
  * Output:
- *   dv1,dv2,dv3: velocity update
+ *   pb->dv1,dv2,dv3: velocity update; pb->ts: stopping time
  */
-void int_par_fulimp(GridS *pG, GrainS *curG, Real3Vect cell1, 
-                              Real *dv1, Real *dv2, Real *dv3, Real *ts)
+void int_par_fulimp(GridS *pG, GrainBlock *pb, int q0, int q1, Real3Vect cell1)
 {
-  Real x1n, x2n, x3n;	/* first order new position at half a time step */
-  Real3Vect fd, fr;	/* drag force and other forces */
-  Real3Vect fc, fp, ft;	/* force at current & predicted position, total force */
-  Real ts11, ts12;	/* 1/stopping time */
+  int q, n = q1-q0;
+  Real *x1 = pb->x1+q0, *x2 = pb->x2+q0, *x3 = pb->x3+q0;
+  Real *v1 = pb->v1+q0, *v2 = pb->v2+q0, *v3 = pb->v3+q0;
+  Real x1n[NGRBLK], x2n[NGRBLK], x3n[NGRBLK];	/* predicted position */
+  Real fc1[NGRBLK], fc2[NGRBLK], fc3[NGRBLK];	/* force at current position */
+  Real fp1[NGRBLK], fp2[NGRBLK], fp3[NGRBLK];	/* force at predicted one */
+  Real fr1[NGRBLK], fr2[NGRBLK], fr3[NGRBLK];	/* other forces */
+  Real ts11[NGRBLK], ts12[NGRBLK];	/* 1/stopping time */
+  Real3Vect ft;		/* total force */
   Real b0,A,B,C,D,Det1;	/* matrix elements and determinant */
 #ifdef SHEARING_BOX
   Real oh, oh2;		/* Omega_0*dt and its square */
 #endif
 
 /* step 1: predict of the particle position after one time step */
-  if (pG->Nx[0] > 1)  x1n = curG->x1+curG->v1*pG->dt;
-  else x1n = curG->x1;
-  if (pG->Nx[1] > 1)  x2n = curG->x2+curG->v2*pG->dt;
-  else x2n = curG->x2;
-  if (pG->Nx[2] > 1)  x3n = curG->x3+curG->v3*pG->dt;
-  else x3n = curG->x3;
-
-#ifdef SHEARING_BOX
-#ifndef FARGO
-  /* advection part */
-  if (ShBoxCoord == xy) x2n -= 0.5*qshear*curG->v1*SQR(pG->dt);
-#endif
-#endif
+  Predict_Block(pG, n, 1.0, x1, x2, x3, v1, v2, v3, x1n, x2n, x3n);
 
 /* step 2: calculate the force at current position */
-  fd = Get_Drag(pG, curG->property, curG->x1, curG->x2, curG->x3,
-                                    curG->v1, curG->v2, curG->v3, cell1, &ts11);
+  Get_Drag_Block(pG, n, pb->property+q0, x1, x2, x3, v1, v2, v3, cell1,
+                                                   fc1, fc2, fc3, ts11);
 
-  fr = Get_Force(pG, curG->x1, curG->x2, curG->x3,
-                     curG->v1, curG->v2, curG->v3);
+  Get_Force_Block(pG, n, x1, x2, x3, v1, v2, v3, fr1, fr2, fr3);
 
-  fc.x1 = fd.x1+fr.x1;
-  fc.x2 = fd.x2+fr.x2;
-  fc.x3 = fd.x3+fr.x3;
+  for (q=0; q<n; q++) {
+    fc1[q] += fr1[q];
+    fc2[q] += fr2[q];
+    fc3[q] += fr3[q];
+  }
 
 /* step 3: calculate the force at the predicted positoin */
-  fd = Get_Drag(pG, curG->property, x1n, x2n, x3n,
-                                    curG->v1, curG->v2, curG->v3, cell1, &ts12);
+  Get_Drag_Block(pG, n, pb->property+q0, x1n, x2n, x3n, v1, v2, v3, cell1,
+                                                   fp1, fp2, fp3, ts12);
 
-  fr = Get_Force(pG, x1n, x2n, x3n, curG->v1, curG->v2, curG->v3);
+  Get_Force_Block(pG, n, x1n, x2n, x3n, v1, v2, v3, fr1, fr2, fr3);
 
-  fp.x1 = fd.x1+fr.x1;
-  fp.x2 = fd.x2+fr.x2;
-  fp.x3 = fd.x3+fr.x3;
+  for (q=0; q<n; q++) {
+    fp1[q] += fr1[q];
+    fp2[q] += fr2[q];
+    fp3[q] += fr3[q];
+  }
 
 /* step 4: calculate the velocity update */
-  /* shortcut expressions */
-  b0 = 1.0+pG->dt*ts11;
+#ifdef SHEARING_BOX
+  oh = Omega_0*pG->dt;
+  oh2 = SQR(oh);
+#endif
 
-  /* Total force */
-  ft.x1 = 0.5*(fc.x1+b0*fp.x1);
-  ft.x2 = 0.5*(fc.x2+b0*fp.x2);
-  ft.x3 = 0.5*(fc.x3+b0*fp.x3);
+  for (q=0; q<n; q++) {
+    /* shortcut expressions */
+    b0 = 1.0+pG->dt*ts11[q];
+
+    /* Total force */
+    ft.x1 = 0.5*(fc1[q]+b0*fp1[q]);
+    ft.x2 = 0.5*(fc2[q]+b0*fp2[q]);
+    ft.x3 = 0.5*(fc3[q]+b0*fp3[q]);
 
 #ifdef SHEARING_BOX
-  oh = Omega_0*pG->dt;
-  if (ShBoxCoord == xy) {/* (x1,x2,x3)=(X,Y,Z) */
-    ft.x1 += -oh*fp.x2;
+    if (ShBoxCoord == xy) {/* (x1,x2,x3)=(X,Y,Z) */
+      ft.x1 += -oh*fp2[q];
   #ifdef FARGO
-    ft.x2 += 0.5*(2.0-qshear)*oh*fp.x1;
+      ft.x2 += 0.5*(2.0-qshear)*oh*fp1[q];
   #else
-    ft.x2 += oh*fp.x1;
+      ft.x2 += oh*fp1[q];
   #endif
-  } else {               /* (x1,x2,x3)=(X,Z,Y) */
-    ft.x1 += -oh*fp.x3;
+    } else {               /* (x1,x2,x3)=(X,Z,Y) */
+      ft.x1 += -oh*fp3[q];
   #ifdef FARGO
-    ft.x3 += 0.5*(2.0-qshear)*oh*fp.x1;
+      ft.x3 += 0.5*(2.0-qshear)*oh*fp1[q];
   #else
-    ft.x3 += oh*fp.x1;
+      ft.x3 += oh*fp1[q];
   #endif
-  }
+    }
 #endif /* SHEARING_BOX */
 
-  /* calculate the inverse matrix elements */
-  D = 1.0+0.5*pG->dt*(ts11 + ts12 + pG->dt*ts11*ts12);
+    /* calculate the inverse matrix elements */
+    D = 1.0+0.5*pG->dt*(ts11[q] + ts12[q] + pG->dt*ts11[q]*ts12[q]);
 #ifdef SHEARING_BOX
-  oh2 = SQR(oh);
-  B = oh * (-2.0-(ts11+ts12)*pG->dt);
+    B = oh * (-2.0-(ts11[q]+ts12[q])*pG->dt);
 #ifdef FARGO
-  A = D - (2.0-qshear)*oh2;
-  C = 0.5*(qshear-2.0)*B;
+    A = D - (2.0-qshear)*oh2;
+    C = 0.5*(qshear-2.0)*B;
 #else /* FARGO */
-  A = D - 2.0*oh2;
-  C = -B;
+    A = D - 2.0*oh2;
+    C = -B;
 #endif /* FARGO */
-  Det1 = 1.0/(SQR(A)-B*C);
-  if (ShBoxCoord == xy) {
-    *dv1 = pG->dt*Det1*(ft.x1*A-ft.x2*B);
-    *dv2 = pG->dt*Det1*(-ft.x1*C+ft.x2*A);
-    *dv3 = pG->dt*ft.x3/D;
-  } else {
-    *dv1 = pG->dt*Det1*(ft.x1*A-ft.x3*B);
-    *dv3 = pG->dt*Det1*(-ft.x1*C+ft.x3*A);
-    *dv2 = pG->dt*ft.x2/D;
-  }
+    Det1 = 1.0/(SQR(A)-B*C);
+    if (ShBoxCoord == xy) {
+      pb->dv1[q0+q] = pG->dt*Det1*(ft.x1*A-ft.x2*B);
+      pb->dv2[q0+q] = pG->dt*Det1*(-ft.x1*C+ft.x2*A);
+      pb->dv3[q0+q] = pG->dt*ft.x3/D;
+    } else {
+      pb->dv1[q0+q] = pG->dt*Det1*(ft.x1*A-ft.x3*B);
+      pb->dv3[q0+q] = pG->dt*Det1*(-ft.x1*C+ft.x3*A);
+      pb->dv2[q0+q] = pG->dt*ft.x2/D;
+    }
 #else /* SHEARING_BOX */
-  D = 1.0/D;
-  *dv1 = pG->dt*ft.x1*D;
-  *dv2 = pG->dt*ft.x2*D;
-  *dv3 = pG->dt*ft.x3*D;
+    D = 1.0/D;
+    pb->dv1[q0+q] = pG->dt*ft.x1*D;
+    pb->dv2[q0+q] = pG->dt*ft.x2*D;
+    pb->dv3[q0+q] = pG->dt*ft.x3*D;
 #endif /* SHEARING_BOX */
 
-  *ts = 0.5/ts11+0.5/ts12;
+    pb->ts[q0+q] = 0.5/ts11[q]+0.5/ts12[q];
+  }
 
   return;
 }
 
 
 /*--------------- 2nd order semi-implicit particle integrator ----------------*/
-/*! \fn void int_par_semimp(Grid *pG, Grain *curG, Real3Vect cell1, 
- *                            Real *dv1, Real *dv2, Real *dv3, Real *ts)
+/*! \fn void int_par_semimp(GridS *pG, GrainBlock *pb, int q0, int q1,
+ *                          Real3Vect cell1)
  *  \brief 2nd order semi-implicit particle integrator 
  *
  * Input: 
- *   grid pointer (pG), grain pointer (curG), cell size indicator (cell1)
+ *   grid pointer (pG), block of particles (pb), range of the particles in the
+ *   block to update (q0 to q1-1), cell size indicator (cell1)
  * Output:
- *   dv1,dv2,dv3: velocity update
+ *   pb->dv1,dv2,dv3: velocity update; pb->ts: stopping time
  */
-void int_par_semimp(GridS *pG, GrainS *curG, Real3Vect cell1, 
-                              Real *dv1, Real *dv2, Real *dv3, Real *ts)
+void int_par_semimp(GridS *pG, GrainBlock *pb, int q0, int q1, Real3Vect cell1)
 {
-  Real3Vect fd, fr, ft;	/* drag force and other forces, total force */
-  Real ts1, b, b2;	/* other shortcut expressions */
-  Real x1n, x2n, x3n;	/* first order new position at half a time step */
+  int q, n = q1-q0;
+  Real *x1 = pb->x1+q0, *x2 = pb->x2+q0, *x3 = pb->x3+q0;
+  Real *v1 = pb->v1+q0, *v2 = pb->v2+q0, *v3 = pb->v3+q0;
+  Real x1n[NGRBLK], x2n[NGRBLK], x3n[NGRBLK];	/* predicted position */
+  Real fd1[NGRBLK], fd2[NGRBLK], fd3[NGRBLK];	/* drag force */
+  Real fr1[NGRBLK], fr2[NGRBLK], fr3[NGRBLK];	/* other forces */
+  Real ts1[NGRBLK];	/* 1/stopping time */
+  Real3Vect ft;		/* total force */
+  Real b, b2;		/* other shortcut expressions */
 #ifdef SHEARING_BOX
   Real b1, oh;		/* Omega_0*h */
 #endif
 
 /* step 1: predict of the particle position after half a time step */
-  if (pG->Nx[0] > 1)  x1n = curG->x1+0.5*curG->v1*pG->dt;
-  else x1n = curG->x1;
-  if (pG->Nx[1] > 1)  x2n = curG->x2+0.5*curG->v2*pG->dt;
-  else x2n = curG->x2;
-  if (pG->Nx[2] > 1)  x3n = curG->x3+0.5*curG->v3*pG->dt;
-  else x3n = curG->x3;
-
-#ifdef SHEARING_BOX
-#ifndef FARGO
-  /* advection part */
-  if (ShBoxCoord == xy) x2n -= 0.125*qshear*curG->v1*SQR(pG->dt);
-#endif
-#endif
+  Predict_Block(pG, n, 0.5, x1, x2, x3, v1, v2, v3, x1n, x2n, x3n);
 
-/* Step 2: interpolation to get fluid density, velocity and the sound speed at\  * predicted position
+/* Step 2: interpolation to get fluid density, velocity and the sound speed at
+ * predicted position
  */
-  fd = Get_Drag(pG, curG->property, x1n, x2n, x3n,
-                                    curG->v1, curG->v2, curG->v3, cell1, &ts1);
-
-  fr = Get_Force(pG, x1n, x2n, x3n, curG->v1, curG->v2, curG->v3);
+  Get_Drag_Block(pG, n, pb->property+q0, x1n, x2n, x3n, v1, v2, v3, cell1,
+                                                   fd1, fd2, fd3, ts1);
 
-  ft.x1 = fd.x1+fr.x1;
-  ft.x2 = fd.x2+fr.x2;
-  ft.x3 = fd.x3+fr.x3;
+  Get_Force_Block(pG, n, x1n, x2n, x3n, v1, v2, v3, fr1, fr2, fr3);
 
 /* step 3: calculate velocity update */
-
-  /* shortcut expressions */
-  b = pG->dt*ts1+2.0;
 #ifdef SHEARING_BOX
   oh = Omega_0*pG->dt;
+#endif
+
+  for (q=0; q<n; q++) {
+    ft.x1 = fd1[q]+fr1[q];
+    ft.x2 = fd2[q]+fr2[q];
+    ft.x3 = fd3[q]+fr3[q];
+
+    /* shortcut expressions */
+    b = pG->dt*ts1[q]+2.0;
+#ifdef SHEARING_BOX
 #ifdef FARGO
-  b1 = 1.0/(SQR(b)+2.0*(2.0-qshear)*SQR(oh));
+    b1 = 1.0/(SQR(b)+2.0*(2.0-qshear)*SQR(oh));
 #else
-  b1 = 1.0/(SQR(b)+4.0*SQR(oh));
+    b1 = 1.0/(SQR(b)+4.0*SQR(oh));
 #endif /* FARGO */
-  b2 = b*b1;
+    b2 = b*b1;
 #else
-  b2 = 1.0/b;
+    b2 = 1.0/b;
 #endif /* SHEARING BOX */
 
     /* velocity evolution */
 #ifdef SHEARING_BOX
-  if (ShBoxCoord == xy)
-  {/* (x1,x2,x3)=(X,Y,Z) */
-    *dv1 = pG->dt*2.0*b2*ft.x1 + pG->dt*4.0*oh*b1*ft.x2;
-  #ifdef FARGO
-    *dv2 = pG->dt*2.0*b2*ft.x2 - 2.0*(2.0-qshear)*pG->dt*oh*b1*ft.x1;
-  #else
-    *dv2 = pG->dt*2.0*b2*ft.x2 - 4.0*pG->dt*oh*b1*ft.x1;
-  #endif /* FARGO */
-    *dv3 = pG->dt*2.0*ft.x3/b;
-  }
-  else
-  {/* (x1,x2,x3)=(X,Z,Y) */
-    *dv1 = pG->dt*2.0*b2*ft.x1 + pG->dt*4.0*oh*b1*ft.x3;
-    *dv2 = pG->dt*2.0*ft.x2/b;
-  #ifdef FARGO
-    *dv3 = pG->dt*2.0*b2*ft.x3 - 2.0*(2.0-qshear)*pG->dt*oh*b1*ft.x1;
-  #else
-    *dv3 = pG->dt*2.0*b2*ft.x3 - 4.0*pG->dt*oh*b1*ft.x1;
-  #endif
-  }
+    if (ShBoxCoord == xy)
+    {/* (x1,x2,x3)=(X,Y,Z) */
+      pb->dv1[q0+q] = pG->dt*2.0*b2*ft.x1 + pG->dt*4.0*oh*b1*ft.x2;
+    #ifdef FARGO
+      pb->dv2[q0+q] = pG->dt*2.0*b2*ft.x2 - 2.0*(2.0-qshear)*pG->dt*oh*b1*ft.x1;
+    #else
+      pb->dv2[q0+q] = pG->dt*2.0*b2*ft.x2 - 4.0*pG->dt*oh*b1*ft.x1;
+    #endif /* FARGO */
+      pb->dv3[q0+q] = pG->dt*2.0*ft.x3/b;
+    }
+    else
+    {/* (x1,x2,x3)=(X,Z,Y) */
+      pb->dv1[q0+q] = pG->dt*2.0*b2*ft.x1 + pG->dt*4.0*oh*b1*ft.x3;
+      pb->dv2[q0+q] = pG->dt*2.0*ft.x2/b;
+    #ifdef FARGO
+      pb->dv3[q0+q] = pG->dt*2.0*b2*ft.x3 - 2.0*(2.0-qshear)*pG->dt*oh*b1*ft.x1;
+    #else
+      pb->dv3[q0+q] = pG->dt*2.0*b2*ft.x3 - 4.0*pG->dt*oh*b1*ft.x1;
+    #endif
+    }
 #else
-  *dv1 = pG->dt*2.0*b2*ft.x1;
-  *dv2 = pG->dt*2.0*b2*ft.x2;
-  *dv3 = pG->dt*2.0*b2*ft.x3;
+    pb->dv1[q0+q] = pG->dt*2.0*b2*ft.x1;
+    pb->dv2[q0+q] = pG->dt*2.0*b2*ft.x2;
+    pb->dv3[q0+q] = pG->dt*2.0*b2*ft.x3;
 #endif /* SHEARING_BOX */
 
-  *ts = 1.0/ts1;
+    pb->ts[q0+q] = 1.0/ts1[q];
+  }
 
   return;
 }
 
 
 /*------------------- 2nd order explicit particle integrator -----------------*/
-/*! \fn void int_par_exp(Grid *pG, Grain *curG, Real3Vect cell1,
- *                         Real *dv1, Real *dv2, Real *dv3, Real *ts)
+/*! \fn void int_par_exp(GridS *pG, GrainBlock *pb, int q0, int q1,
+ *                       Real3Vect cell1)
  *  \brief 2nd order explicit particle integrator 
  *
  * Input: 
- *   grid pointer (pG), grain pointer (curG), cell size indicator (cell1)
+ *   grid pointer (pG), block of particles (pb), range of the particles in the
+ *   block to update (q0 to q1-1), cell size indicator (cell1)
  * Output:
- *   dv1,dv2,dv3: velocity update
+ *   pb->dv1,dv2,dv3: velocity update; pb->ts: stopping time
  */
-void int_par_exp(GridS *pG, GrainS *curG, Real3Vect cell1,
-                           Real *dv1, Real *dv2, Real *dv3, Real *ts)
+void int_par_exp(GridS *pG, GrainBlock *pb, int q0, int q1, Real3Vect cell1)
 {
-  Real3Vect fd, fr, ft;	/* drag force and other forces, total force */
-  Real ts1;		/* 1/stopping time */
-  Real x1n, x2n, x3n;	/* first order new position at half a time step */
-  Real v1n, v2n, v3n;	/* first order new velocity at half a time step */
+  int q, n = q1-q0;
+  Real *x1 = pb->x1+q0, *x2 = pb->x2+q0, *x3 = pb->x3+q0;
+  Real *v1 = pb->v1+q0, *v2 = pb->v2+q0, *v3 = pb->v3+q0;
+  Real x1n[NGRBLK], x2n[NGRBLK], x3n[NGRBLK];	/* predicted position */
+  Real v1n[NGRBLK], v2n[NGRBLK], v3n[NGRBLK];	/* predicted velocity */
+  Real fd1[NGRBLK], fd2[NGRBLK], fd3[NGRBLK];	/* drag force */
+  Real fr1[NGRBLK], fr2[NGRBLK], fr3[NGRBLK];	/* other forces */
+  Real ts1[NGRBLK];	/* 1/stopping time */
+
+  /* Integrate_Range() passes blocks of 1 to NGRBLK particles */
+  if ((n <= 0) || (n > NGRBLK)) {
+    if (n > NGRBLK)
+      ath_error("[int_par_exp]: %d particles in a block of %d\n",n,NGRBLK);
+    return;
+  }
 
 /* step 1: predict of the particle position after half a time step */
-  if (pG->Nx[0] > 1)
-    x1n = curG->x1+0.5*curG->v1*pG->dt;
-  else x1n = curG->x1;
-  if (pG->Nx[1] > 1)
-    x2n = curG->x2+0.5*curG->v2*pG->dt;
-  else x2n = curG->x2;
-  if (pG->Nx[2] > 1)
-    x3n = curG->x3+0.5*curG->v3*pG->dt;
-  else x3n = curG->x3;
-
-#ifdef SHEARING_BOX
-#ifndef FARGO
-  /* advection part */
-  if (ShBoxCoord == xy) x2n -= 0.125*qshear*curG->v1*SQR(pG->dt);
-#endif
-#endif
+  Predict_Block(pG, n, 0.5, x1, x2, x3, v1, v2, v3, x1n, x2n, x3n);
 
 /* step 2: calculate the force at current position */
-  fd = Get_Drag(pG, curG->property, curG->x1, curG->x2, curG->x3,
-                                    curG->v1, curG->v2, curG->v3, cell1, &ts1);
-
-  fr = Get_Force(pG, curG->x1, curG->x2, curG->x3,
-                     curG->v1, curG->v2, curG->v3);
+  Get_Drag_Block(pG, n, pb->property+q0, x1, x2, x3, v1, v2, v3, cell1,
+                                                   fd1, fd2, fd3, ts1);
 
-  ft.x1 = fd.x1+fr.x1;
-  ft.x2 = fd.x2+fr.x2;
-  ft.x3 = fd.x3+fr.x3;
+  Get_Force_Block(pG, n, x1, x2, x3, v1, v2, v3, fr1, fr2, fr3);
 
-  v1n = curG->v1 + 0.5*ft.x1*pG->dt;
-  v2n = curG->v2 + 0.5*ft.x2*pG->dt;
-  v3n = curG->v3 + 0.5*ft.x3*pG->dt;
+  for (q=0; q<n; q++) {
+    v1n[q] = v1[q] + 0.5*(fd1[q]+fr1[q])*pG->dt;
+    v2n[q] = v2[q] + 0.5*(fd2[q]+fr2[q])*pG->dt;
+    v3n[q] = v3[q] + 0.5*(fd3[q]+fr3[q])*pG->dt;
+  }
 
 /* step 3: calculate the force at the predicted positoin */
-  fd = Get_Drag(pG, curG->property, x1n, x2n, x3n, v1n, v2n, v3n, cell1, &ts1);
+  Get_Drag_Block(pG, n, pb->property+q0, x1n, x2n, x3n, v1n, v2n, v3n, cell1,
+                                                   fd1, fd2, fd3, ts1);
 
-  fr = Get_Force(pG, x1n, x2n, x3n, v1n, v2n, v3n);
-
-  ft.x1 = fd.x1+fr.x1;
-  ft.x2 = fd.x2+fr.x2;
-  ft.x3 = fd.x3+fr.x3;
+  Get_Force_Block(pG, n, x1n, x2n, x3n, v1n, v2n, v3n, fr1, fr2, fr3);
 
 /* step 4: calculate velocity update */
-  *dv1 = ft.x1*pG->dt;
-  *dv2 = ft.x2*pG->dt;
-  *dv3 = ft.x3*pG->dt;
+  for (q=0; q<n; q++) {
+    pb->dv1[q0+q] = (fd1[q]+fr1[q])*pG->dt;
+    pb->dv2[q0+q] = (fd2[q]+fr2[q])*pG->dt;
+    pb->dv3[q0+q] = (fd3[q]+fr3[q])*pG->dt;
 
-  *ts = 1.0/ts1;
+    pb->ts[q0+q] = 1.0/ts1[q];
+  }
 
   return;
 }
@@ -467,25 +488,20 @@ void int_par_exp(GridS *pG, GrainS *curG, Real3Vect cell1,
 void feedback_predictor(DomainS *pD)
 {
   GridS *pG = pD->Grid;
-  int is,js,ks,i,j,k;
-  long p;                   /* particle index */
-  Real weight[3][3][3];     /* weight function */
-  Real rho, cs, tstop;      /* density, sound speed, stopping time */
-  Real u1, u2, u3;
-  Real vd1, vd2, vd3, vd;   /* velocity difference between particle and gas */
-  Real f1, f2, f3;          /* feedback force */
-  Real m, ts1h;             /* grain mass, 0.5*dt/tstop */
+  int i,j,k;
+  Real stiffness;           /* stiffness parameter of feedback */
   Real3Vect cell1;          /* one over dx1, dx2, dx3 */
-  Real3Vect fb;             /* drag force, fluid velocity */
-#ifndef BAROTROPIC
-  Real Elosspar;            /* energy dissipation rate due to drag */
+#ifndef OPENMP_PARALLEL
+  long pa, pb;              /* range of all particles */
+#endif
+#ifdef MPI_PARALLEL
+  double tpar = MPI_Wtime(); /* start of the particle work */
 #endif
-  Real stiffness;           /* stiffness parameter of feedback */
-  GrainS *gr;              /* pointer of the current working position */
 
   /* initialization */
   get_gasinfo(pG);          /* calculate gas information */
 
+#pragma omp parallel for private(i,j)
   for (k=klp; k<=kup; k++)
     for (j=jlp; j<=jup; j++)
       for (i=ilp; i<=iup; i++) {
@@ -510,54 +526,21 @@ void feedback_predictor(DomainS *pD)
   else                cell1.x3 = 0.0;
 
   /* loop over all particles to calculate the drag force */
-  for (p=0; p<pG->nparticle; p++)
-  {/* loop over all particle */
-    gr = &(pG->particle[p]);
-
-    /* interpolation to get fluid density and velocity */
-    getweight(pG, gr->x1, gr->x2, gr->x3, cell1, weight, &is, &js, &ks);
-    if (getvalues(pG, weight, is, js, ks,
-                              &rho, &u1, &u2, &u3, &cs, &stiffness) == 0)
-    { /* particle is in the grid */
-
-      /* apply gas velocity shift due to pressure gradient */
-      gasvshift(gr->x1, gr->x2, gr->x3, &u1, &u2, &u3);
-      /* velocity difference */
-      vd1 = u1 - gr->v1;
-      vd2 = u2 - gr->v2;
-      vd3 = u3 - gr->v3;
-      vd = sqrt(vd1*vd1 + vd2*vd2 + vd3*vd3);
-
-      /* calculate particle stopping time */
-      tstop = get_ts(pG, gr->property, rho, cs, vd);
-      tstop = MAX(tstop, pG->dt);
-      ts1h = 0.5*pG->dt/tstop;
-
-      /* Drag force density */
-      m = grproperty[gr->property].m;
-      fb.x1 = m * vd1 * ts1h;
-      fb.x2 = m * vd2 * ts1h;
-      fb.x3 = m * vd3 * ts1h;
-
-      /* calculate feedback stiffness */
-      stiffness = m*pG->dt/tstop;
-
-      /* distribute the drag force (density) to the grid */
-#ifndef BAROTROPIC
-      Elosspar = fb.x1*vd1 + fb.x2*vd2 + fb.x3*vd3;
-      distrFB_pred(pG, weight, is, js, ks, fb, stiffness, Elosspar);
+#ifdef OPENMP_PARALLEL
+  Tiled_Loop(pG, cell1, Predict_Range);
 #else
-      distrFB_pred(pG, weight, is, js, ks, fb, stiffness);
+  pa = 0;
+  pb = pG->nparticle;
+  Predict_Range(pG, 1, &pa, &pb, cell1);
 #endif
-    }
-  }/* end of the for loop */
 
 /* normalize stiffness and correct for feedback */
+#pragma omp parallel for private(i,j,stiffness)
   for (k=klp; k<=kup; k++)
     for (j=jlp; j<=jup; j++)
       for (i=ilp; i<=iup; i++)
       {
-        pG->Coup[k][j][i].FBstiff /= pG->U[k][j][i].d;
+        pG->Coup[k][j][i].FBstiff /= UVAR(pG,k,j,i,d);
 
         stiffness = 1.0/MAX(1.0, pG->Coup[k][j][i].FBstiff);
 
@@ -566,6 +549,10 @@ void feedback_predictor(DomainS *pD)
         pG->Coup[k][j][i].fb3 *= stiffness;
       }
 
+#ifdef MPI_PARALLEL
+  pG->ptime += MPI_Wtime() - tpar;
+#endif
+
   return;
 }
 
@@ -576,7 +563,8 @@ void feedback_predictor(DomainS *pD)
  *	    to the gas.
  *
  * Serves for the corrector step. It deals with one particle at a time.
- * Input: pG: grid with particles; gri,grf: initial and final particles;
+ * Input: pG: grid with particles; gri,grf: initial and final particles,
+ *        gri being in the particle array of pG;
  *        dv: velocity difference between gri and grf.
  * Output: pG: the array of drag forces exerted by the particle is updated
 */
@@ -615,7 +603,8 @@ void feedback_corrector(GridS *pG, GrainS *gri, GrainS *grf, Real3Vect cell1,
 
   /* distribute the drag force (density) to the grid */
   getweight(pG, x1, x2, x3, cell1, weight, &is, &js, &ks);
-  distrFB_corr(pG, weight, is, js, ks, fb, Elosspar);
+  Deposit_FB(pG, (long)(gri - pG->particle), weight, is, js, ks,
+                                            fb, 0.0, Elosspar, 0);
 
   return;
 
@@ -625,6 +614,400 @@ void feedback_corrector(GridS *pG, GrainS *gri, GrainS *grf, Real3Vect cell1,
 
 
 /*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void Integrate_Range(GridS *pG, int nr, const long *pa,
+ *                           const long *pb, Real3Vect cell1)
+ *  \brief Integrate the particles pa[r] to pb[r]-1, r=0..nr-1
+ *
+ * The particles are taken in blocks of NGRBLK.  Each block is copied into a
+ * GrainBlock with the particles of each integrator type next to each other,
+ * and the velocity updates of each type are computed for the whole group at
+ * once.  The feedback and the final update are then done particle by particle
+ * in their original order.
+ */
+void Integrate_Range(GridS *pG, int nr, const long *pa, const long *pb,
+                     Real3Vect cell1)
+{
+  GrainS *curG, *curP, mygr;    /* pointer of the current working position */
+  GrainBlock blk;               /* block of particles grouped by integrator */
+  long p, pn, idx[NGRBLK];      /* particle index, next particle, block */
+  int r, n, q, t;               /* range, block size, index in block, type */
+  int num[4], first[5], next[4];/* number and range of each integrator type */
+  int slot[NGRBLK];             /* index of each particle in blk */
+  Real dv1, dv2, dv3;           /* amount of velocity update */
+
+  curP = &(mygr);       /* temperory particle */
+
+  r = 0;
+  pn = (nr > 0) ? pa[0] : 0;
+  while (r < nr)
+  {/* loop over blocks of particles */
+    n = 0;
+    while ((n < NGRBLK) && (r < nr)) {
+      if (pn < pb[r])
+        idx[n++] = pn++;
+      else if (++r < nr)
+        pn = pa[r];
+    }
+    if (n == 0) break;
+
+/* Step 1: Calculate velocity update */
+
+    /* count the particles of each integrator type */
+    for (t=1; t<=3; t++) num[t] = 0;
+    for (q=0; q<n; q++) {
+      t = grproperty[pG->particle[idx[q]].property].integrator;
+      if ((t < 1) || (t > 3))
+        ath_error("[integrate_particle]: unknown integrator type!");
+      num[t] += 1;
+    }
+    first[1] = 0;
+    for (t=1; t<=3; t++) {
+      first[t+1] = first[t] + num[t];
+      next[t] = first[t];
+    }
+
+    /* copy the block, grouped by integrator type */
+    for (q=0; q<n; q++) {
+      curG = &(pG->particle[idx[q]]);
+      t = next[grproperty[curG->property].integrator]++;
+      slot[q] = t;
+      blk.property[t] = curG->property;
+      blk.x1[t] = curG->x1;  blk.x2[t] = curG->x2;  blk.x3[t] = curG->x3;
+      blk.v1[t] = curG->v1;  blk.v2[t] = curG->v2;  blk.v3[t] = curG->v3;
+    }
+
+    if (num[1] > 0) /* 2nd order explicit integrator */
+      int_par_exp(pG, &blk, first[1], first[2], cell1);
+
+    if (num[2] > 0) /* 2nd order semi-implicit integrator */
+      int_par_semimp(pG, &blk, first[2], first[3], cell1);
+
+    if (num[3] > 0) /* 2nd order fully implicit integrator */
+      int_par_fulimp(pG, &blk, first[3], first[4], cell1);
+
+    for (q=0; q<n; q++)
+    {/* loop over the particles of the block */
+      p = idx[q];
+      curG = &(pG->particle[p]);
+
+      dv1 = blk.dv1[slot[q]];
+      dv2 = blk.dv2[slot[q]];
+      dv3 = blk.dv3[slot[q]];
+
+/* Step 2: particle update to curP */
+
+      /* velocity update */
+      curP->v1 = curG->v1 + dv1;
+      curP->v2 = curG->v2 + dv2;
+      curP->v3 = curG->v3 + dv3;
+
+      /* position update */
+      if (pG->Nx[0] > 1)
+        curP->x1 = curG->x1 + 0.5*pG->dt*(curG->v1 + curP->v1);
+      else /* do not move if this dimension collapses */
+        curP->x1 = curG->x1;
+
+      if (pG->Nx[1] > 1)
+        curP->x2 = curG->x2 + 0.5*pG->dt*(curG->v2 + curP->v2);
+      else /* do not move if this dimension collapses */
+        curP->x2 = curG->x2;
+
+      if (pG->Nx[2] > 1)
+        curP->x3 = curG->x3 + 0.5*pG->dt*(curG->v3 + curP->v3);
+      else /* do not move if this dimension collapses */
+        curP->x3 = curG->x3;
+
+#ifdef FARGO
+      /* shift = -qshear * Omega_0 * x * dt */
+      pG->parsub[p].shift = -0.5*qshear*Omega_0*(curG->x1+curP->x1)*pG->dt;
+#endif
+
+/* Step 3: calculate feedback force to the gas */
+#ifdef FEEDBACK
+      feedback_corrector(pG, curG, curP, cell1, dv1, dv2, dv3,
+                         blk.ts[slot[q]]);
+#endif /* FEEDBACK */
+
+/* Step 4: Final update of the particle */
+      /* update particle status (crossing boundary or not) */
+      JudgeCrossing(pG, curP->x1, curP->x2, curP->x3, curG);
+
+      /* update the particle */
+      curG->x1 = curP->x1;
+      curG->x2 = curP->x2;
+      curG->x3 = curP->x3;
+      curG->v1 = curP->v1;
+      curG->v2 = curP->v2;
+      curG->v3 = curP->v3;
+    }
+
+  } /* end of the loop over blocks */
+
+  return;
+}
+
+#ifdef FEEDBACK
+/*----------------------------------------------------------------------------*/
+/*! \fn void Predict_Range(GridS *pG, int nr, const long *pa,
+ *                         const long *pb, Real3Vect cell1)
+ *  \brief Feedback of the particles pa[r] to pb[r]-1, r=0..nr-1, for the
+ *         predictor step (see feedback_predictor())
+ */
+void Predict_Range(GridS *pG, int nr, const long *pa, const long *pb,
+                   Real3Vect cell1)
+{
+  int is,js,ks,r;
+  long p;                   /* particle index */
+  Real weight[3][3][3];     /* weight function */
+  Real rho, cs, tstop;      /* density, sound speed, stopping time */
+  Real u1, u2, u3;
+  Real vd1, vd2, vd3, vd;   /* velocity difference between particle and gas */
+  Real m, ts1h;             /* grain mass, 0.5*dt/tstop */
+  Real3Vect fb;             /* drag force, fluid velocity */
+  Real Elosspar;            /* energy dissipation rate due to drag */
+  Real stiffness;           /* stiffness parameter of feedback */
+  GrainS *gr;              /* pointer of the current working position */
+
+  for (r=0; r<nr; r++)
+    for (p=pa[r]; p<pb[r]; p++)
+    {/* loop over the particles of the ranges */
+      gr = &(pG->particle[p]);
+
+      /* interpolation to get fluid density and velocity */
+      getweight(pG, gr->x1, gr->x2, gr->x3, cell1, weight, &is, &js, &ks);
+      if (getvalues(pG, weight, is, js, ks,
+                                &rho, &u1, &u2, &u3, &cs, &stiffness) == 0)
+      { /* particle is in the grid */
+
+        /* apply gas velocity shift due to pressure gradient */
+        gasvshift(gr->x1, gr->x2, gr->x3, &u1, &u2, &u3);
+        /* velocity difference */
+        vd1 = u1 - gr->v1;
+        vd2 = u2 - gr->v2;
+        vd3 = u3 - gr->v3;
+        vd = sqrt(vd1*vd1 + vd2*vd2 + vd3*vd3);
+
+        /* calculate particle stopping time */
+        tstop = get_ts(pG, gr->property, rho, cs, vd);
+        tstop = MAX(tstop, pG->dt);
+        ts1h = 0.5*pG->dt/tstop;
+
+        /* Drag force density */
+        m = grproperty[gr->property].m;
+        fb.x1 = m * vd1 * ts1h;
+        fb.x2 = m * vd2 * ts1h;
+        fb.x3 = m * vd3 * ts1h;
+
+        /* calculate feedback stiffness */
+        stiffness = m*pG->dt/tstop;
+
+        /* distribute the drag force (density) to the grid */
+#ifndef BAROTROPIC
+        Elosspar = fb.x1*vd1 + fb.x2*vd2 + fb.x3*vd3;
+#else
+        Elosspar = 0.0;
+#endif
+        Deposit_FB(pG, p, weight, is, js, ks, fb, stiffness, Elosspar, 1);
+      }
+    }/* end of the for loop */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Deposit_FB(GridS *pG, long p, Real weight[3][3][3], int is,
+ *                      int js, int ks, Real3Vect fb, Real stiffness,
+ *                      Real Elosspar, int pred)
+ *  \brief Distribute the feedback of particle p to the grid with
+ *         distrFB_pred() (pred=1) or distrFB_corr() (pred=0)
+ *
+ * When the thread works on a tile (see Tiled_Loop()) and the stencil leaves
+ * the window of the tile, the feedback is saved for Deposit_Deferred().
+ */
+void Deposit_FB(GridS *pG, long p, Real weight[3][3][3], int is, int js,
+                int ks, Real3Vect fb, Real stiffness, Real Elosspar, int pred)
+{
+#ifdef OPENMP_PARALLEL
+  int d, n, s[3];
+  FBDefer *def;
+
+  if (fbwin != NULL) {
+    s[0] = is;  s[1] = js;  s[2] = ks;
+    for (d=0; d<fbwin->nd; d++) {
+      n = s[fbwin->dir[d]];
+      if ((n < fbwin->lo[d]) || (n+ncell-1 > fbwin->hi[d])) break;
+    }
+
+    if (d < fbwin->nd)
+    {/* the stencil leaves the window */
+#pragma omp critical (fbdefer)
+      {
+        if (ndefer == defersize) {
+          defersize = MAX(2*defersize, 64);
+          fbdefer = (FBDefer*)realloc(fbdefer, defersize*sizeof(FBDefer));
+          if (fbdefer == NULL)
+            ath_error("[Deposit_FB]: Error allocating memory.\n");
+        }
+        def = &(fbdefer[ndefer++]);
+        def->p = p;         def->pred = pred;
+        def->is = is;       def->js = js;       def->ks = ks;
+        memcpy(def->weight, weight, sizeof(def->weight));
+        def->fb = fb;       def->stiffness = stiffness;
+        def->Elosspar = Elosspar;
+      }
+      return;
+    }
+  }
+#endif /* OPENMP_PARALLEL */
+
+  if (pred)
+#ifndef BAROTROPIC
+    distrFB_pred(pG, weight, is, js, ks, fb, stiffness, Elosspar);
+#else
+    distrFB_pred(pG, weight, is, js, ks, fb, stiffness);
+#endif
+  else
+    distrFB_corr(pG, weight, is, js, ks, fb, Elosspar);
+
+  return;
+}
+
+#ifdef OPENMP_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn void Tiled_Loop(GridS *pG, Real3Vect cell1, void (*work)(GridS *pG,
+ *              int nr, const long *pa, const long *pb, Real3Vect cell1))
+ *  \brief Apply work() to all the particles, tile by tile, with the threads
+ *         sharing the tiles of each color (see the top of this file)
+ *
+ * The particles must be sorted in the storage order of the cells, so the
+ * particles of a tile are one index range per row of cells; they are sorted
+ * here if they are not already.
+ */
+void Tiled_Loop(GridS *pG, Real3Vect cell1,
+                void (*work)(GridS *pG, int nr, const long *pa,
+                             const long *pb, Real3Vect cell1))
+{
+  FBWindow win;
+  int N[3], lo[3], dir[2], nt[2], t0[2];
+  int d, nd, c, ncol, t, ntile, a, nr;
+  long s[3], b0, b1, pa[FBTILE], pb[FBTILE];
+
+  if (pG->parsorted == 0) shuffle(pG);
+
+  N[0] = iup-ilp+1;   N[1] = jup-jlp+1;   N[2] = kup-klp+1;
+  lo[0] = ilp;        lo[1] = jlp;        lo[2] = klp;
+  s[0] = 1;           s[1] = N[0];        s[2] = (long)N[0]*N[1];
+
+  /* tile the two outermost dimensions that do not collapse */
+  nd = 0;
+  for (d=2; d>=0; d--)
+    if ((N[d] > 1) && (nd < 2)) dir[nd++] = d;
+
+  if (nd == 0) {
+    pa[0] = 0;  pb[0] = pG->nparticle;
+    work(pG, 1, pa, pb, cell1);
+    return;
+  }
+
+  nt[0] = (N[dir[0]]+FBTILE-1)/FBTILE;
+  nt[1] = (nd == 2) ? (N[dir[1]]+FBTILE-1)/FBTILE : 1;
+  ntile = nt[0]*nt[1];
+  ncol = (nd == 2) ? 4 : 2;
+
+  for (c=0; c<ncol; c++) {
+#pragma omp parallel for schedule(dynamic) \
+        private(win,t0,d,a,nr,b0,b1,pa,pb)
+    for (t=0; t<ntile; t++) {
+      t0[0] = (t/nt[1])*FBTILE;
+      t0[1] = (t%nt[1])*FBTILE;
+      if ((t0[0]/FBTILE)%2 + 2*((t0[1]/FBTILE)%2) != c) continue;
+
+      /* the window of the tile */
+      win.nd = nd;
+      for (d=0; d<nd; d++) {
+        win.dir[d] = dir[d];
+        win.lo[d] = lo[dir[d]] + t0[d] - FBTILE/2;
+        win.hi[d] = lo[dir[d]] + MIN(t0[d]+FBTILE, N[dir[d]]) - 1 + FBTILE/2;
+      }
+
+      /* the particles of the tile, one range per row of cells */
+      if (nd == 2) {
+        b0 = t0[1]*s[dir[1]];
+        b1 = MIN(t0[1]+FBTILE, N[dir[1]])*s[dir[1]];
+      }
+      else {
+        b0 = 0;
+        b1 = s[dir[0]];
+      }
+      nr = 0;
+      for (a=t0[0]; a<MIN(t0[0]+FBTILE, N[dir[0]]); a++) {
+        pa[nr] = pG->parcell[a*s[dir[0]] + b0];
+        pb[nr] = pG->parcell[a*s[dir[0]] + b1];
+        nr++;
+      }
+
+      fbwin = &win;
+      work(pG, nr, pa, pb, cell1);
+      fbwin = NULL;
+    }
+  }
+
+  Deposit_Deferred(pG);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int compare_defer(const void *a, const void *b)
+ *  \brief Order the deferred feedback by particle index, for qsort() */
+static int compare_defer(const void *a, const void *b)
+{
+  long pa = ((const FBDefer*)a)->p, pb = ((const FBDefer*)b)->p;
+
+  return (pa > pb) - (pa < pb);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Deposit_Deferred(GridS *pG)
+ *  \brief Distribute the feedback deferred by Deposit_FB(), in the order of
+ *         the particles */
+void Deposit_Deferred(GridS *pG)
+{
+  long n;
+  FBDefer *def;
+
+  if (ndefer == 0) return;
+
+  qsort(fbdefer, ndefer, sizeof(FBDefer), compare_defer);
+
+  for (n=0; n<ndefer; n++) {
+    def = &(fbdefer[n]);
+    if (def->pred)
+#ifndef BAROTROPIC
+      distrFB_pred(pG, def->weight, def->is, def->js, def->ks,
+                       def->fb, def->stiffness, def->Elosspar);
+#else
+      distrFB_pred(pG, def->weight, def->is, def->js, def->ks,
+                       def->fb, def->stiffness);
+#endif
+    else
+      distrFB_corr(pG, def->weight, def->is, def->js, def->ks,
+                       def->fb, def->Elosspar);
+  }
+
+  ath_pout(1, "Deferred the feedback of %ld particles.\n", ndefer);
+
+  free(fbdefer);
+  fbdefer = NULL;
+  ndefer = defersize = 0;
+
+  return;
+}
+#endif /* OPENMP_PARALLEL */
+
+#endif /* FEEDBACK */
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void Delete_Ghost(GridS *pG)
  *  \brief Delete ghost particles */
@@ -643,6 +1026,7 @@ void Delete_Ghost(GridS *pG)
       pG->nparticle -= 1;
       grproperty[gr->property].num -= 1;
       pG->particle[p] = pG->particle[pG->nparticle];
+      pG->parsorted = 0;
     }
     else
       p++;
@@ -675,71 +1059,172 @@ void JudgeCrossing(GridS *pG, Real x1, Real x2, Real x3, GrainS *gr)
 }
 
 /*--------------------------------------------------------------------------- */
-/*! \fn Real3Vect Get_Drag(GridS *pG, int type, Real x1, Real x2, Real x3,
- *              Real v1, Real v2, Real v3, Real3Vect cell1, Real *tstop1)
- *  \brief Calculate the drag force to the particles 
+/*! \fn void Predict_Block(GridS *pG, int n, Real h, const Real *x1,
+ *          const Real *x2, const Real *x3, const Real *v1, const Real *v2,
+ *          const Real *v3, Real *x1n, Real *x2n, Real *x3n)
+ *  \brief Predict the positions of a block of particles after h*dt
  *
  * Input:
- *   pG: grid;	type: particle type;	cell1: 1/dx1,1/dx2,1/dx3;
- *   x1,x2,x3,v1,v2,v3: particle position and velocity;
+ *   pG: grid;	n: number of particles;	h: fraction of the time step;
+ *   x1,x2,x3,v1,v2,v3: particle positions and velocities;
  * Output:
- *   tstop1: 1/stopping time;
- * Return:
- *   drag force;
+ *   x1n,x2n,x3n: first order positions after h*dt
  */
-Real3Vect Get_Drag(GridS *pG, int type, Real x1, Real x2, Real x3,
-                Real v1, Real v2, Real v3, Real3Vect cell1, Real *tstop1)
+void Predict_Block(GridS *pG, int n, Real h, const Real *x1, const Real *x2,
+                   const Real *x3, const Real *v1, const Real *v2,
+                   const Real *v3, Real *x1n, Real *x2n, Real *x3n)
 {
-  int is, js, ks;
-  Real rho, u1, u2, u3, cs;
-  Real vd1, vd2, vd3, vd, tstop, ts1;
+  int q;
+
+  for (q=0; q<n; q++) {
+    if (pG->Nx[0] > 1)  x1n[q] = x1[q]+h*v1[q]*pG->dt;
+    else x1n[q] = x1[q];
+    if (pG->Nx[1] > 1)  x2n[q] = x2[q]+h*v2[q]*pG->dt;
+    else x2n[q] = x2[q];
+    if (pG->Nx[2] > 1)  x3n[q] = x3[q]+h*v3[q]*pG->dt;
+    else x3n[q] = x3[q];
+  }
+
+#ifdef SHEARING_BOX
+#ifndef FARGO
+  /* advection part */
+  if (ShBoxCoord == xy)
+    for (q=0; q<n; q++)
+      x2n[q] -= 0.5*h*h*qshear*v1[q]*SQR(pG->dt);
+#endif
+#endif
+
+  return;
+}
+
+/*--------------------------------------------------------------------------- */
+/*! \fn void Get_Drag_Block(GridS *pG, int n, const int *type,
+ *          const Real *x1, const Real *x2, const Real *x3, const Real *v1,
+ *          const Real *v2, const Real *v3, Real3Vect cell1,
+ *          Real *fd1, Real *fd2, Real *fd3, Real *tstop1)
+ *  \brief Calculate the drag force to a block of particles
+ *
+ * Input:
+ *   pG: grid;	n: number of particles;	type: particle types;
+ *   x1,x2,x3,v1,v2,v3: particle positions and velocities;
+ *   cell1: 1/dx1,1/dx2,1/dx3;
+ * Output:
+ *   fd1,fd2,fd3: drag force;	tstop1: 1/stopping time;
+ */
+void Get_Drag_Block(GridS *pG, int n, const int *type, const Real *x1,
+                    const Real *x2, const Real *x3, const Real *v1,
+                    const Real *v2, const Real *v3, Real3Vect cell1,
+                    Real *fd1, Real *fd2, Real *fd3, Real *tstop1)
+{
+  int q, ok[NGRBLK];
+  Real rho[NGRBLK], u1[NGRBLK], u2[NGRBLK], u3[NGRBLK], cs[NGRBLK];
+  Real tstop[NGRBLK];
 #ifdef FEEDBACK
-  Real stiffness;
+  Real stiffness[NGRBLK];
 #endif
-  Real weight[3][3][3];		/* weight function */
-  Real3Vect fd;
+  Real vd;
 
   /* interpolation to get fluid density, velocity and the sound speed */
-  getweight(pG, x1, x2, x3, cell1, weight, &is, &js, &ks);
-
 #ifndef FEEDBACK
-  if (getvalues(pG, weight, is, js, ks, &rho, &u1, &u2, &u3, &cs) == 0)
+  getvalues_blk(pG, n, x1, x2, x3, cell1, rho, u1, u2, u3, cs, ok);
 #else
-  if (getvalues(pG, weight, is, js, ks, &rho,&u1,&u2,&u3,&cs, &stiffness) == 0)
+  getvalues_blk(pG, n, x1, x2, x3, cell1, rho, u1, u2, u3, cs, stiffness, ok);
 #endif
-  { /* particle in the grid */
 
-    /* apply possible gas velocity shift (e.g., for fake gas velocity field) */
-    gasvshift(x1, x2, x3, &u1, &u2, &u3);
+  for (q=0; q<n; q++) {
+    if (ok[q])
+    { /* particle in the grid */
 
-    /* velocity difference */
-    vd1 = v1-u1;
-    vd2 = v2-u2;
-    vd3 = v3-u3;
-    vd = sqrt(SQR(vd1) + SQR(vd2) + SQR(vd3)); /* dimension independent */
+      /* apply possible gas velocity shift (e.g., for fake gas velocity) */
+      gasvshift(x1[q], x2[q], x3[q], &u1[q], &u2[q], &u3[q]);
 
-    /* particle stopping time */
-    tstop = get_ts(pG, type, rho, cs, vd);
+      /* particle stopping time */
+      vd = sqrt(SQR(v1[q]-u1[q]) + SQR(v2[q]-u2[q]) + SQR(v3[q]-u3[q]));
+      tstop[q] = get_ts(pG, type[q], rho[q], cs[q], vd);
+    }
+    else
+    { /* particle out of the grid, free motion, with warning sign */
+      u1[q] = v1[q];	u2[q] = v2[q];	u3[q] = v3[q];	tstop[q] = 1.0;
 #ifdef FEEDBACK
-    tstop *= MAX(1.0, stiffness);
+      stiffness[q] = 0.0;
 #endif
-    ts1 = 1.0/tstop;
+      ath_perr(0, "Particle move out of grid %d with position (%f,%f,%f)!\n",
+                            myID_Comm_world,x1[q],x2[q],x3[q]); /* warning! */
+    }
   }
-  else
-  { /* particle out of the grid, free motion, with warning sign */
-    vd1 = 0.0;	vd2 = 0.0;	vd3 = 0.0;	ts1 = 0.0;
-    ath_perr(0, "Particle move out of grid %d with position (%f,%f,%f)!\n",
-                                      myID_Comm_world,x1,x2,x3); /* warning! */
+
+  /* Drag force */
+  for (q=0; q<n; q++) {
+#ifdef FEEDBACK
+    tstop[q] *= MAX(1.0, stiffness[q]);
+#endif
+    tstop1[q] = ok[q] ? 1.0/tstop[q] : 0.0;
+
+    fd1[q] = -tstop1[q]*(v1[q]-u1[q]);
+    fd2[q] = -tstop1[q]*(v2[q]-u2[q]);
+    fd3[q] = -tstop1[q]*(v3[q]-u3[q]);
   }
 
-  *tstop1 = ts1;
+  return;
+}
 
-  /* Drag force */
-  fd.x1 = -ts1*vd1;
-  fd.x2 = -ts1*vd2;
-  fd.x3 = -ts1*vd3;
+/*--------------------------------------------------------------------------- */
+/*! \fn void Get_Force_Block(GridS *pG, int n, const Real *x1,
+ *          const Real *x2, const Real *x3, const Real *v1, const Real *v2,
+ *          const Real *v3, Real *f1, Real *f2, Real *f3)
+ *  \brief Calculate the forces other than the gas drag to a block of particles
+ *
+ * Input:
+ *   pG: grid;	n: number of particles;
+ *   x1,x2,x3,v1,v2,v3: particle positions and velocities;
+ * Output:
+ *   f1,f2,f3: forces, as returned by Get_Force() for each particle;
+ */
+void Get_Force_Block(GridS *pG, int n, const Real *x1, const Real *x2,
+                     const Real *x3, const Real *v1, const Real *v2,
+                     const Real *v3, Real *f1, Real *f2, Real *f3)
+{
+  int q;
+  Real3Vect ft;
+#ifdef SHEARING_BOX
+  Real omg2 = SQR(Omega_0);
+#endif
 
-  return fd;
+  /* User defined forces */
+  for (q=0; q<n; q++) {
+    ft.x1 = ft.x2 = ft.x3 = 0.0;
+    Userforce_particle(&ft, x1[q], x2[q], x3[q], v1[q], v2[q], v3[q]);
+    f1[q] = ft.x1;  f2[q] = ft.x2;  f3[q] = ft.x3;
+  }
+
+#ifdef SHEARING_BOX
+  if (ShBoxCoord == xy)
+  {/* (x1,x2,x3)=(X,Y,Z) */
+    for (q=0; q<n; q++) {
+  #ifdef FARGO
+      f1[q] += 2.0*v2[q]*Omega_0;
+      f2[q] += (qshear-2.0)*v1[q]*Omega_0;
+  #else
+      f1[q] += 2.0*(qshear*omg2*x1[q] + v2[q]*Omega_0);
+      f2[q] += -2.0*v1[q]*Omega_0;
+  #endif /* FARGO */
+    }
+  }
+  else
+  { /* (x1,x2,x3)=(X,Z,Y) */
+    for (q=0; q<n; q++) {
+  #ifdef FARGO
+      f1[q] += 2.0*v3[q]*Omega_0;
+      f3[q] += (qshear-2.0)*v1[q]*Omega_0;
+  #else
+      f1[q] += 2.0*(qshear*omg2*x1[q] + v3[q]*Omega_0);
+      f3[q] += -2.0*v1[q]*Omega_0;
+  #endif /* FARGO */
+    }
+  }
+#endif /* SHEARING_BOX */
+
+  return;
 }
 
 /*--------------------------------------------------------------------------- */
@@ -40,12 +40,12 @@ void particle_realloc(GridS *pG, long n);
 
 /* integrators_particle.c */
 void Integrate_Particles(DomainS *pD);
-void int_par_exp   (GridS *pG, GrainS *curG, Real3Vect cell1,
-                              Real *dv1, Real *dv2, Real *dv3, Real *ts);
-void int_par_semimp(GridS *pG, GrainS *curG, Real3Vect cell1,
-                              Real *dv1, Real *dv2, Real *dv3, Real *ts);
-void int_par_fulimp(GridS *pG, GrainS *curG, Real3Vect cell1,
-                              Real *dv1, Real *dv2, Real *dv3, Real *ts);
+void int_par_exp   (GridS *pG, GrainBlock *pb, int q0, int q1,
+                                                   Real3Vect cell1);
+void int_par_semimp(GridS *pG, GrainBlock *pb, int q0, int q1,
+                                                   Real3Vect cell1);
+void int_par_fulimp(GridS *pG, GrainBlock *pb, int q0, int q1,
+                                                   Real3Vect cell1);
 #ifdef FEEDBACK
 void feedback_predictor(DomainS *pD);
 void feedback_corrector(GridS *pG, GrainS *gri, GrainS *grf, Real3Vect cell1,
@@ -75,6 +75,16 @@ int getvalues(GridS *pG, Real weight[3][3][3], int is, int js, int ks,
 #endif
 );
 
+void getvalues_blk(GridS *pG, int n, const Real *x1, const Real *x2,
+                   const Real *x3, Real3Vect cell1,
+#ifndef FEEDBACK
+                   Real *rho, Real *u1, Real *u2, Real *u3, Real *cs,
+#else
+                   Real *rho, Real *u1, Real *u2, Real *u3, Real *cs,
+                   Real *stiff,
+#endif
+                   int *ok);
+
 Real get_ts_epstein(GridS *pG, int type, Real rho, Real cs, Real vd);
 Real get_ts_general(GridS *pG, int type, Real rho, Real cs, Real vd);
 Real get_ts_fixed  (GridS *pG, int type, Real rho, Real cs, Real vd);
@@ -93,6 +103,10 @@ void distrFB_corr(GridS *pG, Real weight[3][3][3], int is, int js, int ks,
 #endif
 
 void shuffle(GridS *pG);
+void shuffle_destruct(GridS *pG);
+#ifdef MPI_PARALLEL
+void count_particles(GridS *pG);
+#endif
 
 #endif /* PARTICLES */
 #endif /* PARTICLES_PROTOTYPES_H */
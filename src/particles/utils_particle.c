@@ -15,6 +15,7 @@
  * - getwei_TSC   ()
  * - getwei_QP    ()
  * - getvalues()
+ * - getvalues_blk()
  * - get_ts_epstein()
  * - get_ts_general()
  * - get_ts_fixed  ()
@@ -22,11 +23,14 @@
  * - feedback_clear()
  * - distrFB      ()
  * - void shuffle()
+ * - void shuffle_destruct()
+ * - void count_particles()
  * - void gasvshift_zero()
  * 
  * PRIVATE FUNCTION PROTOTYPES:
- * - compare_gr()         - compare the location of the two particles
- * - quicksort_particle() - sort the particles using the quicksort
+ * - cell_key()   - sort key of the cell containing a particle
+ * - morton_key() - sort keys of the cells in Morton (Z-curve) order
+ * - getwei_blk() - 1D interpolation weights for a block of particles
  *
  *============================================================================*/
 #include <stdio.h>
@@ -41,13 +45,22 @@
 
 #ifdef PARTICLES         /* endif at the end of the file */
 
+/* scratch particle array for shuffle(), swapped with pG->particle each time */
+static GrainS *sortbuf = NULL;
+static long sortsize = 0;	/* size of sortbuf (in number of particles) */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
- *   compare_gr()         - compare the location of the two particles
- *   quicksort_particle() - sort the particles using the quicksort
+ *   cell_key()   - sort key of the cell containing a particle
+ *   morton_key() - sort keys of the cells in Morton (Z-curve) order
+ *   getwei_blk() - 1D interpolation weights for a block of particles
  *============================================================================*/
-int compare_gr(GridS *pG, Real3Vect cell1, GrainS gr1, GrainS gr2);
-void quicksort_particle(GridS *pG, Real3Vect cell1, long start, long end);
+static long cell_key(const GridS *pG, const Real3Vect cell1, const GrainS *gr);
+#if !(defined(FEEDBACK) && defined(OPENMP_PARALLEL))
+static void morton_key(GridS *pG);
+#endif
+static void getwei_blk(int n, const Real *x, Real xmin, Real dx_1, int is,
+                       int *s, Real wei[3][NGRBLK]);
 
 
 /*============================== ALL FUNCTIONS ===============================*/
@@ -66,6 +79,7 @@ void quicksort_particle(GridS *pG, Real3Vect cell1, long start, long end);
  * getwei_TSC()
  * getwei_QP ()
  * getvalues();
+ * getvalues_blk();
  */
 /*============================================================================*/
 
@@ -361,6 +375,196 @@ int getvalues(GridS *pG, Real weight[3][3][3], int is, int js, int ks,
 }
 
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void getvalues_blk(GridS *pG, int n, const Real *x1, const Real *x2,
+ *        const Real *x3, Real3Vect cell1, Real *rho, Real *u1, Real *u2,
+ *        Real *u3, Real *cs, Real *stiff, int *ok)
+ *  \brief Interpolate the fluid quantities to a block of particles
+ *
+ * Input:
+ * - pG: grid; n: number of particles (<= NGRBLK);
+ * - x1,x2,x3: positions of the particles; cell1: 1 over dx1,dx2,dx3
+ * Output:
+ * - interpolated values of density, velocity and sound speed of the fluid
+ *   (and feedback stiffness) of each particle
+ * - ok: 1 for normal exit; 0 if the particle lies out of the grid
+ *
+ * Gives the same values as getweight() followed by getvalues() for each
+ * particle, but the weights and the sums over the stencil are computed in loops
+ * over the particles, with unit stride through the arrays.  Particles whose
+ * stencil is not entirely within [ilp:iup][jlp:jup][klp:kup] are passed to
+ * getweight() and getvalues().
+ */
+void getvalues_blk(GridS *pG, int n, const Real *x1, const Real *x2,
+                   const Real *x3, Real3Vect cell1,
+#ifndef FEEDBACK
+                   Real *rho, Real *u1, Real *u2, Real *u3, Real *cs,
+#else
+                   Real *rho, Real *u1, Real *u2, Real *u3, Real *cs,
+                   Real *stiff,
+#endif
+                   int *ok)
+{
+  int q, i, j, k, ni, nj, nk, N1T, N2T;
+  int is[NGRBLK], js[NGRBLK], ks[NGRBLK], in[NGRBLK];
+  long off[NGRBLK], o;
+  Real wei1[3][NGRBLK], wei2[3][NGRBLK], wei3[3][NGRBLK];
+  Real D[NGRBLK], v1[NGRBLK], v2[NGRBLK], v3[NGRBLK], totwei[NGRBLK];
+#ifndef ISOTHERMAL
+  Real C[NGRBLK];
+#endif
+#ifdef FEEDBACK
+  Real stiffness[NGRBLK];
+#endif
+  Real w, totwei1, weight[3][3][3];
+  GPCouple *base, *pq;
+
+  /* 1D weights, and the width of the stencil in each direction */
+  getwei_blk(n, x1, pG->MinX[0], cell1.x1, pG->is, is, wei1);
+  getwei_blk(n, x2, pG->MinX[1], cell1.x2, pG->js, js, wei2);
+  getwei_blk(n, x3, pG->MinX[2], cell1.x3, pG->ks, ks, wei3);
+  ni = (cell1.x1 > 0.0) ? ncell : 1;
+  nj = (cell1.x2 > 0.0) ? ncell : 1;
+  nk = (cell1.x3 > 0.0) ? ncell : 1;
+
+  /* offset of the first cell of each stencil in the (contiguous) Coup array */
+  N1T = iup-ilp+1;
+  N2T = jup-jlp+1;
+  base = &(pG->Coup[klp][jlp][ilp]);
+  for (q=0; q<n; q++) {
+    in[q] = (is[q] >= ilp) && (is[q]+ni-1 <= iup) &&
+            (js[q] >= jlp) && (js[q]+nj-1 <= jup) &&
+            (ks[q] >= klp) && (ks[q]+nk-1 <= kup);
+    off[q] = in[q] ? ((long)(ks[q]-klp)*N2T + (js[q]-jlp))*N1T + (is[q]-ilp)
+                   : 0;
+  }
+
+  for (q=0; q<n; q++) {
+    D[q] = 0.0;  v1[q] = 0.0;  v2[q] = 0.0;  v3[q] = 0.0;
+    totwei[q] = 0.0;
+#ifndef ISOTHERMAL
+    C[q] = 0.0;
+#endif
+#ifdef FEEDBACK
+    stiffness[q] = 0.0;
+#endif
+  }
+
+  /* Interpolate density, velocity and sound speed, in the order of getvalues */
+  for (k=0; k<nk; k++) {
+    for (j=0; j<nj; j++) {
+      for (i=0; i<ni; i++) {
+        o = ((long)k*N2T + j)*N1T + i;
+
+        for (q=0; q<n; q++) {
+          w = wei1[i][q] * wei2[j][q] * wei3[k][q];
+          pq = base + off[q] + o;
+          D[q] += w * pq->grid_d;
+          v1[q] += w * pq->grid_v1;
+          v2[q] += w * pq->grid_v2;
+          v3[q] += w * pq->grid_v3;
+#ifndef ISOTHERMAL
+          C[q] += w * pq->grid_cs;
+#endif
+#ifdef FEEDBACK
+          stiffness[q] += w * pq->FBstiff;
+#endif
+          totwei[q] += w;
+        }
+      }
+    }
+  }
+
+  for (q=0; q<n; q++) {
+    if (in[q]) {
+      ok[q] = (totwei[q] < TINY_NUMBER) ? 0 : 1;
+      totwei1 = 1.0/totwei[q];
+      rho[q] = D[q]*totwei1;
+      u1[q] = v1[q]*totwei1;  u2[q] = v2[q]*totwei1;  u3[q] = v3[q]*totwei1;
+#ifdef ISOTHERMAL
+      cs[q] = Iso_csound;
+#else
+      cs[q] = C[q]*totwei1;
+#endif
+#ifdef FEEDBACK
+      stiff[q] = stiffness[q]*totwei1;
+#endif
+    }
+    else { /* stencil crosses the edge of the particle grid */
+      getweight(pG, x1[q], x2[q], x3[q], cell1, weight, &i, &j, &k);
+#ifndef FEEDBACK
+      ok[q] = (getvalues(pG, weight, i, j, k,
+                         &rho[q], &u1[q], &u2[q], &u3[q], &cs[q]) == 0);
+#else
+      ok[q] = (getvalues(pG, weight, i, j, k,
+                         &rho[q], &u1[q], &u2[q], &u3[q], &cs[q],
+                         &stiff[q]) == 0);
+#endif
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void getwei_blk(int n, const Real *x, Real xmin, Real dx_1,
+ *                             int is, int *s, Real wei[3][NGRBLK])
+ *  \brief 1D interpolation weights for a block of particles
+ *
+ * Input: n: number of particles; x: coordinate of the particles in one
+ *        direction; xmin, dx_1, is: MinX, 1/dx (0 if the direction collapses)
+ *        and the first active cell index of the grid in that direction.
+ * Output: s: starting cell index; wei: weights of the cells s, s+1 (and s+2),
+ *         computed as in getweight().
+ */
+static void getwei_blk(int n, const Real *x, Real xmin, Real dx_1, int is,
+                       int *s, Real wei[3][NGRBLK])
+{
+  int q, i;
+  Real a, d;
+
+  if (dx_1 <= 0.0) { /* this dimension collapses */
+    for (q=0; q<n; q++) {
+      s[q] = is;
+      wei[0][q] = 1.0;	wei[1][q] = 0.0;	wei[2][q] = 0.0;
+    }
+  }
+  else if (getweight == getwei_linear) {
+    for (q=0; q<n; q++) {
+      a = (x[q] - xmin) * dx_1 + is;
+      i = (int)a;
+      s[q] = ((a-i) < 0.5) ? i-1 : i;
+      wei[1][q] = a - s[q] - 0.5;
+      wei[0][q] = 1.0 - wei[1][q];
+      wei[2][q] = 0.0;
+    }
+  }
+  else if (getweight == getwei_TSC) {
+    for (q=0; q<n; q++) {
+      a = (x[q] - xmin) * dx_1 + is;
+      i = (int)a;
+      s[q] = i - 1;
+      d = a - i;
+      wei[0][q] = 0.5*SQR(1.0-d);
+      wei[1][q] = 0.75-SQR(d-0.5);
+      wei[2][q] = 0.5*SQR(d);
+    }
+  }
+  else { /* getwei_QP */
+    for (q=0; q<n; q++) {
+      a = (x[q] - xmin) * dx_1 + is;
+      i = (int)a;
+      s[q] = i - 1;
+      d = a - i;
+      wei[0][q] = 0.5*(0.5-d)*(1.5-d);
+      wei[1][q] = 1.0-SQR(d-0.5);
+      wei[2][q] = 0.5*(d-0.5)*(d+0.5);
+    }
+  }
+
+  return;
+}
+
 /*============================================================================*/
 /*-----------------------------STOPPING TIME----------------------------------
  *
@@ -474,26 +678,31 @@ void get_gasinfo(GridS *pG)
 #endif
 
   /* get gas information */
+#ifndef BAROTROPIC
+#pragma omp parallel for private(i,j,rho1,pq,P)
+#else
+#pragma omp parallel for private(i,j,rho1,pq)
+#endif
   for (k=klp; k<=kup; k++)
     for (j=jlp; j<=jup; j++)
       for (i=ilp; i<=iup; i++)
       {
         pq = &(pG->Coup[k][j][i]);
-        rho1 = 1.0/(pG->U[k][j][i].d);
+        rho1 = 1.0/(UVAR(pG,k,j,i,d));
 
-        pq->grid_d  = pG->U[k][j][i].d;
-        pq->grid_v1 = pG->U[k][j][i].M1 * rho1;
-        pq->grid_v2 = pG->U[k][j][i].M2 * rho1;
-        pq->grid_v3 = pG->U[k][j][i].M3 * rho1;
+        pq->grid_d  = UVAR(pG,k,j,i,d);
+        pq->grid_v1 = UVAR(pG,k,j,i,M1) * rho1;
+        pq->grid_v2 = UVAR(pG,k,j,i,M2) * rho1;
+        pq->grid_v3 = UVAR(pG,k,j,i,M3) * rho1;
 
 #ifndef ISOTHERMAL
   #ifndef BAROTROPIC
         /* E = P/(gamma-1) + rho*v^2/2 + B^2/2 */
-        P = pG->U[k][j][i].E - 0.5*pG->U[k][j][i].d*(SQR(pq->grid_v1) \
+        P = UVAR(pG,k,j,i,E) - 0.5*UVAR(pG,k,j,i,d)*(SQR(pq->grid_v1) \
              + SQR(pq->grid_v2) + SQR(pq->grid_v3));
     #ifdef MHD
-        P = P - 0.5*(SQR(pG->U[k][j][i].B1c)+SQR(pG->U[k][j][i].B2c)
-                                            +SQR(pG->U[k][j][i].B3c));
+        P = P - 0.5*(SQR(UVAR(pG,k,j,i,B1c))+SQR(UVAR(pG,k,j,i,B2c))
+                                            +SQR(UVAR(pG,k,j,i,B3c)));
     #endif /* MHD */
         P = MAX(Gamma_1*P, TINY_NUMBER);
         pq->grid_cs = sqrt(Gamma*P*rho1);
@@ -515,6 +724,7 @@ void feedback_clear(GridS *pG)
   int i,j,k;
   GPCouple *pq;
 
+#pragma omp parallel for private(i,j,pq)
   for (k=klp; k<=kup; k++)
     for (j=jlp; j<=jup; j++)
       for (i=ilp; i<=iup; i++) {
@@ -627,8 +837,9 @@ void distrFB_corr(GridS *pG, Real weight[3][3][3], int is, int js, int ks,
 /*---------------------------------SHUFFLE------------------------------------
  *
  * shuffle()
- * compare_gr()
- * quicksort_particle()
+ * shuffle_destruct()
+ * cell_key()
+ * morton_key()
  */
 /*============================================================================*/
 
@@ -637,105 +848,217 @@ void distrFB_corr(GridS *pG, Real weight[3][3][3], int is, int js, int ks,
  *  \brief Shuffle the particles
  *
  * Input: pG: grid with particles;
- * Output: pG: particles in the linked list are rearranged by the order of their
- *         locations that are consistent with grid cell storage.
+ * Output: pG: particles in the array are rearranged by the order of their
+ *         locations that are consistent with grid cell storage (or, with
+ *         <particle>/morton=1, with a Morton curve through the cells).
+ *         pG->parcell holds the offset of the first particle of each cell.
+ *
+ * A stable counting sort keyed by cell, so the cost is O(N) and two passes
+ * over the particles.  The particles are scattered into a scratch array which
+ * then replaces pG->particle; the old array becomes the scratch array of the
+ * next call.  pG->parsub is not permuted, as it is recomputed before use.
  */
 void shuffle(GridS *pG)
 {
+  GrainS *gr, *tmp;
   Real3Vect cell1;
+  long p, n, ncells;
 
   if (pG->Nx[0] > 1) cell1.x1 = 1.0/pG->dx1;  else  cell1.x1 = 0.0;
   if (pG->Nx[1] > 1) cell1.x2 = 1.0/pG->dx2;  else  cell1.x2 = 0.0;
   if (pG->Nx[2] > 1) cell1.x3 = 1.0/pG->dx3;  else  cell1.x3 = 0.0;
 
+  ncells = (long)(iup-ilp+1)*(long)(jup-jlp+1)*(long)(kup-klp+1);
+
+  /* allocate the cell offsets (and keys) on the first call */
+  if (pG->parcell == NULL) {
+    pG->parcell = (long*)calloc_1d_array(ncells+1, sizeof(long));
+    if (pG->parcell == NULL) goto on_error;
+
+    /* the tiles of threaded feedback need the storage order of the cells */
+    if (par_geti_def("particle","morton",0) != 0) {
+#if defined(FEEDBACK) && defined(OPENMP_PARALLEL)
+      ath_perr(0, "[shuffle]: morton order is not used with OPENMP_PARALLEL "
+                  "and FEEDBACK\n");
+#else
+      morton_key(pG);
+#endif
+    }
+  }
+
+  /* the scratch array must be able to hold the whole particle array */
+  if (sortsize < pG->arrsize) {
+    if (sortbuf != NULL) free_1d_array(sortbuf);
+    sortsize = pG->arrsize;
+    sortbuf = (GrainS*)calloc_1d_array(sortsize, sizeof(GrainS));
+    if (sortbuf == NULL) goto on_error;
+  }
+
   /* output status */
-  ath_pout(0, "Resorting particles...\n");
+  ath_pout(1, "Resorting particles...\n");
+
+  /* count the particles in each cell */
+  for (n=0; n<=ncells; n++)
+    pG->parcell[n] = 0;
+  for (p=0; p<pG->nparticle; p++)
+    pG->parcell[cell_key(pG, cell1, &(pG->particle[p]))+1] += 1;
+
+  /* offset of the first particle in each cell */
+  for (n=0; n<ncells; n++)
+    pG->parcell[n+1] += pG->parcell[n];
+
+  /* scatter the particles; each offset ends up at the start of the next cell */
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    sortbuf[pG->parcell[cell_key(pG, cell1, gr)]++] = *gr;
+  }
+  for (n=ncells; n>0; n--)
+    pG->parcell[n] = pG->parcell[n-1];
+  pG->parcell[0] = 0;
+
+  /* swap the sorted array in */
+  tmp = pG->particle;
+  pG->particle = sortbuf;
+  sortbuf = tmp;
+
+  p = pG->arrsize;
+  pG->arrsize = sortsize;
+  sortsize = p;
+
+  pG->parsorted = 1;
+
+  return;
 
-  /* sort the particles according to their positions */
-  quicksort_particle(pG, cell1, 0, pG->nparticle-1);
+  on_error:
+    ath_error("[shuffle]: Error allocating memory.\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void shuffle_destruct(GridS *pG)
+ *  \brief Free the arrays allocated by shuffle() */
+void shuffle_destruct(GridS *pG)
+{
+  if (pG->parcell != NULL) free_1d_array(pG->parcell);
+  if (pG->cellkey != NULL) free_1d_array(pG->cellkey);
+  pG->parcell = NULL;
+  pG->cellkey = NULL;
+  pG->parsorted = 0;
+
+  if (sortbuf != NULL) free_1d_array(sortbuf);
+  sortbuf = NULL;
+  sortsize = 0;
 
   return;
 }
 
+#ifdef MPI_PARALLEL
 /*----------------------------------------------------------------------------*/
-/*! \fn int compare_gr(GridS *pG, Real3Vect cell1, GrainS gr1, GrainS gr2)
- *  \brief Compare the order of two particles according to their positions in 
- *  the grid
+/*! \fn void count_particles(GridS *pG)
+ *  \brief Adds the particles in each layer of cells in x1, x2 and x3 to
+ *   pG->parprof[0..2], called once every step.
  *
- * Input: pG: grid; 
- * -      cell1: 1/dx1,1/dx2,1/dx3, or 0 if that dimension collapses.
- * -      gr1,gr2: pointers of the two particles to be compared.
- * Output: pointer of the particle that should be put in front of the other.
+ * Together with pG->ptime these give the cost of the particles and where on
+ * the Grid it arises, recorded by record_grid_cost() for load balancing.
+ * Particles outside the Grid are counted in its nearest layer.
  */
-int compare_gr(GridS *pG, Real3Vect cell1, GrainS gr1, GrainS gr2)
+void count_particles(GridS *pG)
 {
-  int i1,j1,k1, i2,j2,k2;
+  GrainS *gr;
+  Real3Vect cell1;
+  long p;
+  int i, j, k;
+
+  if (pG->Nx[0] > 1) cell1.x1 = 1.0/pG->dx1;  else  cell1.x1 = 0.0;
+  if (pG->Nx[1] > 1) cell1.x2 = 1.0/pG->dx2;  else  cell1.x2 = 0.0;
+  if (pG->Nx[2] > 1) cell1.x3 = 1.0/pG->dx3;  else  cell1.x3 = 0.0;
 
-  k1 = (int)((gr1.x3 - pG->MinX[2]) * cell1.x3);	/* x3 index of gr1 */
-  k2 = (int)((gr2.x3 - pG->MinX[2]) * cell1.x3);	/* x3 index of gr2 */
-  if (k1 < k2) return 1;
-  if (k1 > k2) return 2;
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if (gr->pos == 0) continue; /* ghost particles cost little */
 
-  j1 = (int)((gr1.x2 - pG->MinX[1]) * cell1.x2);	/* x2 index of gr1 */
-  j2 = (int)((gr2.x2 - pG->MinX[1]) * cell1.x2);	/* x2 index of gr2 */
-  if (j1 < j2) return 1;
-  if (j1 > j2) return 2;
+    i = (int)floor((gr->x1 - pG->MinX[0]) * cell1.x1);
+    j = (int)floor((gr->x2 - pG->MinX[1]) * cell1.x2);
+    k = (int)floor((gr->x3 - pG->MinX[2]) * cell1.x3);
 
-  i1 = (int)((gr1.x1 - pG->MinX[0]) * cell1.x1);	/* x1 index of gr1 */
-  i2 = (int)((gr2.x1 - pG->MinX[0]) * cell1.x1);	/* x1 index of gr2 */
-  if (i1 < i2) return 1;
-  if (i1 > i2) return 2;
+    pG->parprof[0][MIN(MAX(i, 0), pG->Nx[0]-1)] += 1.0;
+    pG->parprof[1][MIN(MAX(j, 0), pG->Nx[1]-1)] += 1.0;
+    pG->parprof[2][MIN(MAX(k, 0), pG->Nx[2]-1)] += 1.0;
+  }
 
-  /* if they have equal indices, arbitrarily choose gr1 */
-  return 1;
+  return;
 }
+#endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void quicksort_particle(Grid *pG, Vector cell1, long start, long end)
- *  \brief Quick sort algorithm to shuffle the particles
+/*! \fn static long cell_key(const GridS *pG, const Real3Vect cell1,
+ *                           const GrainS *gr)
+ *  \brief Sort key of the cell containing a particle
  *
- * Input: pG, cell1: for compare_gr subroutine only. See above.
- *        head, rear: head and rear of the linked list.
- *          They do not contain data, or equal the pivot in the recursion.
- *        length: length of the linked list (does not contain head or rear).
- * Output: *head: linked list with shuffling finished.
+ * Input: pG: grid; cell1: 1/dx1,1/dx2,1/dx3, or 0 if that dimension collapses;
+ *        gr: the particle.
+ * Output: the cell index in storage order of pG->Coup, or its Morton rank.
+ * Particles outside the cells [ilp:iup][jlp:jup][klp:kup] are counted in the
+ * nearest cell.
  */
-void quicksort_particle(GridS *pG, Real3Vect cell1, long start, long end)
+static long cell_key(const GridS *pG, const Real3Vect cell1, const GrainS *gr)
 {
-  long i, pivot;
-  GrainS gr;
-  if (end <= start) return;	/* automatically sorted already */
-
-  /* location of the pivot at half chain length */
-  pivot = (long)((start+end+1)/2);
-
-  /* move the pivot to the start */
-  gr = pG->particle[pivot];
-  pG->particle[pivot] = pG->particle[start];
-  pG->particle[start] = gr;
-
-  /* initial configuration */
-  pivot = start;
-  i = start + 1;
-
-  /* move the particles that are "smaller" than the pivot before it */
-  while (i <= end) {
-    if (compare_gr(pG, cell1, pG->particle[pivot], pG->particle[i]) == 2)
-    {/* the ith particle is smaller, move it before the pivot */
-      gr = pG->particle[pivot];
-      pG->particle[pivot] = pG->particle[i];
-      pG->particle[i] = pG->particle[pivot+1];
-      pG->particle[pivot+1] = gr;
-      pivot += 1;
-    }
-    i += 1;
+  int i, j, k;
+  long n;
+
+  i = (int)((gr->x1 - pG->MinX[0]) * cell1.x1 + pG->is);
+  j = (int)((gr->x2 - pG->MinX[1]) * cell1.x2 + pG->js);
+  k = (int)((gr->x3 - pG->MinX[2]) * cell1.x3 + pG->ks);
+
+  i = MIN(MAX(i, ilp), iup);
+  j = MIN(MAX(j, jlp), jup);
+  k = MIN(MAX(k, klp), kup);
+
+  n = ((long)(k-klp)*(jup-jlp+1) + (j-jlp))*(iup-ilp+1) + (i-ilp);
+
+  if (pG->cellkey != NULL) return (long)(pG->cellkey[n]);
+  return n;
+}
+
+#if !(defined(FEEDBACK) && defined(OPENMP_PARALLEL))
+/*----------------------------------------------------------------------------*/
+/*! \fn static void morton_key(GridS *pG)
+ *  \brief Sort keys of the cells in Morton (Z-curve) order
+ *
+ * Enumerates the Morton codes interleaving the bits of the cell indices in
+ * the dimensions that do not collapse (x1 fastest), and ranks the codes that
+ * fall inside [ilp:iup][jlp:jup][klp:kup].  Called once, by shuffle().
+ */
+static void morton_key(GridS *pG)
+{
+  int N[3], dim[3], c[3];
+  int d, t, nd = 0, nb = 0;
+  long m, nm, r = 0;
+
+  N[0] = iup-ilp+1;  N[1] = jup-jlp+1;  N[2] = kup-klp+1;
+
+  pG->cellkey = (int*)calloc_1d_array((long)N[0]*N[1]*N[2], sizeof(int));
+  if (pG->cellkey == NULL)
+    ath_error("[shuffle]: Error allocating memory.\n");
+
+  /* bits per dimension to cover the largest dimension */
+  for (d=0; d<3; d++) {
+    if (N[d] > 1) dim[nd++] = d;
+    while ((1 << nb) < N[d]) nb++;
   }
+  nm = 1L << (nb*nd);
+
+  for (m=0; m<nm; m++) {
+    c[0] = c[1] = c[2] = 0;
+    for (t=0; t<nb; t++)
+      for (d=0; d<nd; d++)
+        c[dim[d]] |= (int)((m >> (t*nd+d)) & 1) << t;
 
-  /* recursively call this routine to complete sorting */
-  quicksort_particle(pG, cell1, start, pivot-1);
-  quicksort_particle(pG, cell1, pivot+1, end);
+    if ((c[0] < N[0]) && (c[1] < N[1]) && (c[2] < N[2]))
+      pG->cellkey[((long)c[2]*N[1] + c[1])*N[0] + c[0]] = (int)(r++);
+  }
 
   return;
 }
+#endif /* !(FEEDBACK && OPENMP_PARALLEL) */
 
 #endif /*PARTICLES*/
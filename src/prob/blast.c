@@ -68,20 +68,20 @@ void problem(DomainS *pDomain)
 
         U1d = Prim1D_to_Cons1D(&(W),&Bx);
 
-	pGrid->U[k][j][i].d  = U1d.d;
-	pGrid->U[k][j][i].M1 = U1d.Mx;
-	pGrid->U[k][j][i].M2 = U1d.My;
-	pGrid->U[k][j][i].M3 = U1d.Mz;
+	UVAR(pGrid,k,j,i,d)  = U1d.d;
+	UVAR(pGrid,k,j,i,M1) = U1d.Mx;
+	UVAR(pGrid,k,j,i,M2) = U1d.My;
+	UVAR(pGrid,k,j,i,M3) = U1d.Mz;
 #ifndef ISOTHERMAL
-	pGrid->U[k][j][i].E  = U1d.E;
+	UVAR(pGrid,k,j,i,E)  = U1d.E;
 #endif
 #ifdef MHD
 	pGrid->B1i[k][j][i] = Bx;
 	pGrid->B2i[k][j][i] = U1d.By;
 	pGrid->B3i[k][j][i] = U1d.Bz;
-	pGrid->U[k][j][i].B1c = Bx;
-	pGrid->U[k][j][i].B2c = U1d.By;
-	pGrid->U[k][j][i].B3c = U1d.Bz;
+	UVAR(pGrid,k,j,i,B1c) = Bx;
+	UVAR(pGrid,k,j,i,B2c) = U1d.By;
+	UVAR(pGrid,k,j,i,B3c) = U1d.Bz;
 	if (i == ie && ie > is) pGrid->B1i[k][j][i+1] = Bx;
 	if (j == je && je > js) pGrid->B2i[k][j+1][i] = U1d.By;
 	if (k == ke && ke > ks) pGrid->B3i[k+1][j][i] = U1d.Bz;
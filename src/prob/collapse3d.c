@@ -61,6 +61,7 @@ void problem(DomainS *pDomain)
   iwhich   = par_geti("problem","iwhich");
 #ifdef SELF_GRAVITY
   four_pi_G= par_getd("problem","four_pi_G");
+  grav_mean_rho = 0.0; /* isolated cloud, open boundaries */
 #endif
   if (myid == 0) {
     fprintf(stdout,"[collapse3d]: d0        = %13.5e\n",d0);
@@ -115,12 +116,12 @@ void problem(DomainS *pDomain)
   dx1   = pGrid->dx1;
   dx2   = pGrid->dx2;
   dx3   = pGrid->dx3;
-  x1min = par_getd("grid","x1min");
-  x1max = par_getd("grid","x1max");
-  x2min = par_getd("grid","x2min");
-  x2max = par_getd("grid","x2max");
-  x3min = par_getd("grid","x3min");
-  x3max = par_getd("grid","x3max");
+  x1min = pDomain->MinX[0];
+  x1max = pDomain->MaxX[0];
+  x2min = pDomain->MinX[1];
+  x2max = pDomain->MaxX[1];
+  x3min = pDomain->MinX[2];
+  x3max = pDomain->MaxX[2];
   x1len =  x1max-x1min;
   x2len =  x2max-x2min;
   x3len =  x3max-x3min;
@@ -140,20 +141,20 @@ void problem(DomainS *pDomain)
           r2  = sqrt(SQR(x1-x10)+SQR(x2-x20)+SQR(x3-x30));          
           switch (iwhich) {
           case 0: {
-            pGrid->U[k][j][i].d = d0 +
+            UVAR(pGrid,k,j,i,d) = d0 +
               0.5*(d1-d0)*(1.0-tanh((r2-radius)/(sig0*radius)));
             break;
           }
           case 1: {
-            pGrid->U[k][j][i].d = d1 +
+            UVAR(pGrid,k,j,i,d) = d1 +
              (0.75*d0/(PI*radius*radius*radius))*pow((1.0+SQR(r2/radius)),-2.5);
             break;
           }
 	  default: ath_error("[collapse3d]: invalid iwhich\n");
           }
-          pGrid->U[k][j][i].M1 = 0.0;
-          pGrid->U[k][j][i].M2 = 0.0;
-          pGrid->U[k][j][i].M3 = 0.0;
+          UVAR(pGrid,k,j,i,M1) = 0.0;
+          UVAR(pGrid,k,j,i,M2) = 0.0;
+          UVAR(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
           pGrid->B1i[k][j][i]  = bx0;
           pGrid->B2i[k][j][i]  = by0;
@@ -195,18 +196,18 @@ void problem(DomainS *pDomain)
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
 #ifdef MHD
-          pGrid->U[k][j][i].B1c= 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-          pGrid->U[k][j][i].B2c= 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-          pGrid->U[k][j][i].B3c= 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+          UVAR(pGrid,k,j,i,B1c)= 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+          UVAR(pGrid,k,j,i,B2c)= 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+          UVAR(pGrid,k,j,i,B3c)= 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
 #endif
 #ifndef ISOTHERMAL
-          pGrid->U[k][j][i].E = p0/Gamma_1
+          UVAR(pGrid,k,j,i,E) = p0/Gamma_1
 #ifdef MHD
-              + 0.5*(SQR(pGrid->U[k][j][i].B1c) + SQR(pGrid->U[k][j][i].B2c)
-                   + SQR(pGrid->U[k][j][i].B3c))
+              + 0.5*(SQR(UVAR(pGrid,k,j,i,B1c)) + SQR(UVAR(pGrid,k,j,i,B2c))
+                   + SQR(UVAR(pGrid,k,j,i,B3c)))
 #endif
-              + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-                   + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+              + 0.5*(SQR(UVAR(pGrid,k,j,i,M1)) + SQR(UVAR(pGrid,k,j,i,M2))
+                   + SQR(UVAR(pGrid,k,j,i,M3)))/UVAR(pGrid,k,j,i,d);
 #endif
         }
       }
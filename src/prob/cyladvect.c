@@ -43,7 +43,7 @@ static Real Shear(const Real R) {return 0.0;}
 void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
-  int i,j,k;
+  int i,j,k,n;
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3; 
   Real x1,x2,x3;
@@ -97,42 +97,42 @@ void problem(DomainS *pDomain)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
-        memset(&(pG->U[k][j][i]),0.0,sizeof(ConsS));
+        for (n=0; n<NVAR; n++) UCOMP(pG,k,j,i,n) = 0.0;
 
         switch (iprob) {
           case 1:
                   mask = (int)((x1>=R0-rad) && (x1<=R0+rad) && (x2>=phi0-rad/R0) && (x2<=phi0+rad/R0));
-                  pG->U[k][j][i].d  = rho0*(1.0 + amp*mask);
+                  UVAR(pG,k,j,i,d)  = rho0*(1.0 + amp*mask);
 #ifndef FARGO
-                  pG->U[k][j][i].M2 = pG->U[k][j][i].d*x1*omega0;
+                  UVAR(pG,k,j,i,M2) = UVAR(pG,k,j,i,d)*x1*omega0;
 #else
-                  pG->U[k][j][i].M2 = 0;
+                  UVAR(pG,k,j,i,M2) = 0;
 #endif
 #ifdef MHD
-                  pG->U[k][j][i].B3c = bz0*mask;
+                  UVAR(pG,k,j,i,B3c) = bz0*mask;
                   pG->B3i[k][j][i]   = bz0*mask;
 #endif
                   break;
           case 2:
-                  pG->U[k][j][i].d  = rho0*(1.0 + amp*sin(alpha*x2-phi0));
+                  UVAR(pG,k,j,i,d)  = rho0*(1.0 + amp*sin(alpha*x2-phi0));
 #ifndef FARGO
-                  pG->U[k][j][i].M2 = pG->U[k][j][i].d*x1*omega0;
+                  UVAR(pG,k,j,i,M2) = UVAR(pG,k,j,i,d)*x1*omega0;
 #else
-                  pG->U[k][j][i].M2 = 0;
+                  UVAR(pG,k,j,i,M2) = 0;
 #endif
                   break;
           case 3:
                   x  = x1*cos(x2);    y  = x1*sin(x2);    z  = x3;
                   x0 = R0*cos(phi0);  y0 = R0*sin(phi0);
                   r = sqrt(SQR(x-x0) + SQR(y-y0) + SQR(z-z0));
-                  pG->U[k][j][i].d  = rho0*(1.0 + exp(-0.5*SQR(3.0*r/rad)));
+                  UVAR(pG,k,j,i,d)  = rho0*(1.0 + exp(-0.5*SQR(3.0*r/rad)));
 #ifndef FARGO
-                  pG->U[k][j][i].M2 = pG->U[k][j][i].d*x1*omega0;
+                  UVAR(pG,k,j,i,M2) = UVAR(pG,k,j,i,d)*x1*omega0;
 #else
-                  pG->U[k][j][i].M2 = 0;
+                  UVAR(pG,k,j,i,M2) = 0;
 #endif
 #ifdef MHD
-                  pG->U[k][j][i].B3c = bz0;
+                  UVAR(pG,k,j,i,B3c) = bz0;
                   pG->B3i[k][j][i]   = bz0;
 #endif
                   break;
@@ -140,22 +140,22 @@ void problem(DomainS *pDomain)
                   ath_error("[cyladvect]:  Not an accepted problem number\n");
         }
 
-        pG->U[k][j][i].M3 = pG->U[k][j][i].d*vz0;
+        UVAR(pG,k,j,i,M3) = UVAR(pG,k,j,i,d)*vz0;
 
 #ifndef ISOTHERMAL
         /* Initialize total energy */
         Emag = 0.0;
 #ifdef MHD
-        Emag = 0.5*SQR(pG->U[k][j][i].B3c);
+        Emag = 0.5*SQR(UVAR(pG,k,j,i,B3c));
 #endif
         Eint = (Pgas0-Emag)/Gamma_1;
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+        Ekin = 0.5*(SQR(UVAR(pG,k,j,i,M1)) + SQR(UVAR(pG,k,j,i,M2)) + SQR(UVAR(pG,k,j,i,M3)))/UVAR(pG,k,j,i,d);
 
-        pG->U[k][j][i].E = Eint + Emag + Ekin;
+        UVAR(pG,k,j,i,E) = Eint + Emag + Ekin;
 #endif /* ISOTHERMAL */
 
         /* Save solution */
-        RootSoln[k][j][i] = pG->U[k][j][i];
+        RootSoln[k][j][i] = UGET(pG,k,j,i);
       }
     }
   }
@@ -245,27 +245,27 @@ void cyladvect_ix1(GridS *pG)
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
         cc_pos(pG,is-i,j,k,&x1,&x2,&x3);
-        pG->U[k][j][is-i].d   = rho0*(1.0 + amp*sin(alpha*x2-phi0));
+        UVAR(pG,k,j,is-i,d)   = rho0*(1.0 + amp*sin(alpha*x2-phi0));
 #ifndef FARGO
-        pG->U[k][j][is-i].M2  = pG->U[k][j][is-i].d*x1*omega0;
+        UVAR(pG,k,j,is-i,M2)  = UVAR(pG,k,j,is-i,d)*x1*omega0;
 #else
-        pG->U[k][j][is-i].M2  = 0.0;
+        UVAR(pG,k,j,is-i,M2)  = 0.0;
 #endif
-        pG->U[k][j][is-i].M3  = pG->U[k][j][is-i].d*vz0;
+        UVAR(pG,k,j,is-i,M3)  = UVAR(pG,k,j,is-i,d)*vz0;
 #ifdef MHD
-        pG->U[k][j][is-i].B3c = bz0;
+        UVAR(pG,k,j,is-i,B3c) = bz0;
         pG->B3i[k][j][is-i]   = bz0;
 #endif
 
 #ifndef ISOTHERMAL
         Emag = 0.0;
 #ifdef MHD
-        Emag = 0.5*SQR(pG->U[k][j][is-i].B3c);
+        Emag = 0.5*SQR(UVAR(pG,k,j,is-i,B3c));
 #endif
         Eint = (Pgas0-Emag)/Gamma_1;
-        Ekin = 0.5*(SQR(pG->U[k][j][is-i].M1) + SQR(pG->U[k][j][is-i].M2) + SQR(pG->U[k][j][is-i].M3))/pG->U[k][j][is-i].d;
+        Ekin = 0.5*(SQR(UVAR(pG,k,j,is-i,M1)) + SQR(UVAR(pG,k,j,is-i,M2)) + SQR(UVAR(pG,k,j,is-i,M3)))/UVAR(pG,k,j,is-i,d);
 
-        pG->U[k][j][is-i].E = Eint + Emag + Ekin;
+        UVAR(pG,k,j,is-i,E) = Eint + Emag + Ekin;
 #endif /* ISOTHERMAL */
       }
     }
@@ -293,27 +293,27 @@ void cyladvect_ox1(GridS *pG)
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
         cc_pos(pG,ie+i,j,k,&x1,&x2,&x3);
-        pG->U[k][j][ie+i].d   = rho0*(1.0 + amp*sin(alpha*x2-phi0));
+        UVAR(pG,k,j,ie+i,d)   = rho0*(1.0 + amp*sin(alpha*x2-phi0));
 #ifndef FARGO
-        pG->U[k][j][ie+i].M2  = pG->U[k][j][ie+i].d*x1*omega0;
+        UVAR(pG,k,j,ie+i,M2)  = UVAR(pG,k,j,ie+i,d)*x1*omega0;
 #else
-        pG->U[k][j][ie+i].M2  = 0.0;
+        UVAR(pG,k,j,ie+i,M2)  = 0.0;
 #endif
-        pG->U[k][j][ie+i].M3  = pG->U[k][j][ie+i].d*vz0;
+        UVAR(pG,k,j,ie+i,M3)  = UVAR(pG,k,j,ie+i,d)*vz0;
 #ifdef MHD
-        pG->U[k][j][ie+i].B3c = bz0;
+        UVAR(pG,k,j,ie+i,B3c) = bz0;
         pG->B3i[k][j][ie+i]   = bz0;
 #endif
 
 #ifndef ISOTHERMAL
         Emag = 0.0;
 #ifdef MHD
-        Emag = 0.5*SQR(pG->U[k][j][ie+i].B3c);
+        Emag = 0.5*SQR(UVAR(pG,k,j,ie+i,B3c));
 #endif
         Eint = (Pgas0-Emag)/Gamma_1;
-        Ekin = 0.5*(SQR(pG->U[k][j][ie+i].M1) + SQR(pG->U[k][j][ie+i].M2) + SQR(pG->U[k][j][ie+i].M3))/pG->U[k][j][ie+i].d;
+        Ekin = 0.5*(SQR(UVAR(pG,k,j,ie+i,M1)) + SQR(UVAR(pG,k,j,ie+i,M2)) + SQR(UVAR(pG,k,j,ie+i,M3)))/UVAR(pG,k,j,ie+i,d);
 
-        pG->U[k][j][ie+i].E = Eint + Emag + Ekin;
+        UVAR(pG,k,j,ie+i,E) = Eint + Emag + Ekin;
 #endif /* ISOTHERMAL */
       }
     }
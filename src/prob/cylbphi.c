@@ -30,7 +30,7 @@ static ConsS ***RootSoln=NULL;
 void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
-  int i,j,k;
+  int i,j,k,n;
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3;
   Real x1,x2,x3;
@@ -80,34 +80,34 @@ void problem(DomainS *pDomain)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
-        memset(&(pG->U[k][j][i]),0.0,sizeof(ConsS));
+        for (n=0; n<NVAR; n++) UCOMP(pG,k,j,i,n) = 0.0;
 
-        pG->U[k][j][i].d  = rho0;
-        pG->U[k][j][i].M1 = 0.0;
-        pG->U[k][j][i].M2 = rho0*omega0*x1;
-        pG->U[k][j][i].M3 = pG->U[k][j][i].d*vz0;
+        UVAR(pG,k,j,i,d)  = rho0;
+        UVAR(pG,k,j,i,M1) = 0.0;
+        UVAR(pG,k,j,i,M2) = rho0*omega0*x1;
+        UVAR(pG,k,j,i,M3) = UVAR(pG,k,j,i,d)*vz0;
         switch (iprob) {
           case 1:   // Constant B_phi
                     pG->B2i[k][j][i]   = bphi0;
-                    pG->U[k][j][i].B2c = bphi0;
+                    UVAR(pG,k,j,i,B2c) = bphi0;
                     break;
           case 2:   // B_phi goes as 1/R
                     pG->B2i[k][j][i]   = bphi0/x1;
-                    pG->U[k][j][i].B2c = bphi0/x1;
+                    UVAR(pG,k,j,i,B2c) = bphi0/x1;
                     break;
           default:  printf("[cylbphi]:  Not an accepted problem number\n");
         }
 
         /* Initialize total energy */
         Eint = pgas0/Gamma_1;
-        Emag = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-                  + SQR(pG->U[k][j][i].B3c));
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2)
-                  + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
-        pG->U[k][j][i].E = Eint + Emag + Ekin;
+        Emag = 0.5*(SQR(UVAR(pG,k,j,i,B1c)) + SQR(UVAR(pG,k,j,i,B2c))
+                  + SQR(UVAR(pG,k,j,i,B3c)));
+        Ekin = 0.5*(SQR(UVAR(pG,k,j,i,M1)) + SQR(UVAR(pG,k,j,i,M2))
+                  + SQR(UVAR(pG,k,j,i,M3)))/UVAR(pG,k,j,i,d);
+        UVAR(pG,k,j,i,E) = Eint + Emag + Ekin;
 
         /* Save solution */
-        RootSoln[k][j][i] = pG->U[ks][j][i];
+        RootSoln[k][j][i] = UGET(pG,ks,j,i);
       }
     }
   }
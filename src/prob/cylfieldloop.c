@@ -49,7 +49,7 @@ static Real Shear(const Real R) {return 0.0;}
 void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
-  int i=0,j=0,k=0;
+  int i=0,j=0,k=0,n;
   int is,ie,js,je,ks,ke,nx1,nx2,nx3;
   int il,iu,jl,ju,kl,ku;
   Real x1,x2,x3,lsf,rsf;
@@ -92,16 +92,16 @@ void problem(DomainS *pDomain)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
-        memset(&(pG->U[k][j][i]),0.0,sizeof(ConsS));
+        for (n=0; n<NVAR; n++) UCOMP(pG,k,j,i,n) = 0.0;
 
-        pG->U[k][j][i].d  = rho0;
-        pG->U[k][j][i].M1 = 0.0;
+        UVAR(pG,k,j,i,d)  = rho0;
+        UVAR(pG,k,j,i,M1) = 0.0;
 #ifndef FARGO
-        pG->U[k][j][i].M2 = pG->U[k][j][i].d*x1*omega0;
+        UVAR(pG,k,j,i,M2) = UVAR(pG,k,j,i,d)*x1*omega0;
 #else
-        pG->U[k][j][i].M2 = 0;
+        UVAR(pG,k,j,i,M2) = 0;
 #endif
-        pG->U[k][j][i].M3 = pG->U[k][j][i].d*vz0;
+        UVAR(pG,k,j,i,M3) = UVAR(pG,k,j,i,d)*vz0;
         pG->B1i[k][j][i]  = vecpot2b1i(NULL,A3,pG,i,j,k);
         pG->B2i[k][j][i]  = vecpot2b2i(NULL,A3,pG,i,j,k);
         pG->B3i[k][j][i]  = 0.0;
@@ -118,31 +118,31 @@ void problem(DomainS *pDomain)
         rsf = (x1 + 0.5*pG->dx1)/x1;
 
         if (i < iu) 
-          pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+          UVAR(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
         else
-          pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*vecpot2b1i(NULL,A3,pG,i+1,j,k));
+          UVAR(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*vecpot2b1i(NULL,A3,pG,i+1,j,k));
 
         if (j < ju) 
-          pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+          UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
         else
-          pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + vecpot2b2i(NULL,A3,pG,i,j+1,k));
+          UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + vecpot2b2i(NULL,A3,pG,i,j+1,k));
 
         if (ke > ks)
           if (k < ku)
-            pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+            UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
           else
-            pG->U[k][j][i].B3c = 0.0;
+            UVAR(pG,k,j,i,B3c) = 0.0;
         else
-          pG->U[k][j][i].B3c = pG->B3i[k][j][i];
+          UVAR(pG,k,j,i,B3c) = pG->B3i[k][j][i];
 
 #ifndef ISOTHERMAL
-        pG->U[k][j][i].E = 1.0/Gamma_1 
-          + 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c))
-          + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+        UVAR(pG,k,j,i,E) = 1.0/Gamma_1 
+          + 0.5*(SQR(UVAR(pG,k,j,i,B1c)) + SQR(UVAR(pG,k,j,i,B2c)) + SQR(UVAR(pG,k,j,i,B3c)))
+          + 0.5*(SQR(UVAR(pG,k,j,i,M1)) + SQR(UVAR(pG,k,j,i,M2)) + SQR(UVAR(pG,k,j,i,M3)))/UVAR(pG,k,j,i,d);
 #endif /* ISOTHERMAL */
 
         // Save solution
-        RootSoln[k][j][i] = pG->U[k][j][i];
+        RootSoln[k][j][i] = UGET(pG,k,j,i);
       }
     }
   }
@@ -40,7 +40,7 @@ void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
   int myID_Comm_world = 0;
-  int i,j,k;
+  int i,j,k,n;
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3;
   Real x1,x2,x3;
@@ -87,30 +87,30 @@ void problem(DomainS *pDomain)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
-        memset(&(pG->U[k][j][i]),0.0,sizeof(ConsS));
+        for (n=0; n<NVAR; n++) UCOMP(pG,k,j,i,n) = 0.0;
 
         // Random number between 0 and 1
         randnum = ((double) rand()/((double)RAND_MAX + 1.0));
         // Random number between +/- noise_level
         noise = noise_level*(2.0*randnum-1.0);
 
-        pG->U[k][j][i].d  = rho0;
+        UVAR(pG,k,j,i,d)  = rho0;
 #ifndef FARGO
-        pG->U[k][j][i].M2 = rho0*avg1d(vphi,pG,i,j,k);
+        UVAR(pG,k,j,i,M2) = rho0*avg1d(vphi,pG,i,j,k);
         // Now perturb v_phi
          if ((i>=is) && (i<=ie)) {
-           pG->U[k][j][i].M2 *= (1.0 + noise);
+           UVAR(pG,k,j,i,M2) *= (1.0 + noise);
          }
 #else
-         pG->U[k][j][i].M2 = 0.0;
+         UVAR(pG,k,j,i,M2) = 0.0;
         // Now perturb v_phi
          if ((i>=is) && (i<=ie)) {
-           pG->U[k][j][i].M2 = noise*rho0*avg1d(vphi,pG,i,j,k);
+           UVAR(pG,k,j,i,M2) = noise*rho0*avg1d(vphi,pG,i,j,k);
          }
 #endif
 
 #ifdef MHD
-        pG->U[k][j][i].B2c = bphi0/x1;
+        UVAR(pG,k,j,i,B2c) = bphi0/x1;
         pG->B2i[k][j][i]   = bphi0/x1;
 #endif
 
@@ -118,10 +118,10 @@ void problem(DomainS *pDomain)
         Eint = pgas0/Gamma_1;
         Emag = 0.0;
 #ifdef MHD
-        Emag = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+        Emag = 0.5*(SQR(UVAR(pG,k,j,i,B1c)) + SQR(UVAR(pG,k,j,i,B2c)) + SQR(UVAR(pG,k,j,i,B3c)));
 #endif
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1 ) + SQR(pG->U[k][j][i].M2 ) + SQR(pG->U[k][j][i].M3 ))/pG->U[k][j][i].d;
-        pG->U[k][j][i].E = Eint + Emag + Ekin;
+        Ekin = 0.5*(SQR(UVAR(pG,k,j,i,M1) ) + SQR(UVAR(pG,k,j,i,M2) ) + SQR(UVAR(pG,k,j,i,M3) ))/UVAR(pG,k,j,i,d);
+        UVAR(pG,k,j,i,E) = Eint + Emag + Ekin;
 #endif
       }
     }
@@ -219,12 +219,12 @@ void diode_outflow_ix1(GridS *pGrid)
 
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
-      L = r[is]*pGrid->U[k][j][is].M2;
+      L = r[is]*UVAR(pGrid,k,j,is,M2);
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][is];
+        USET(pGrid,k,j,is-i,UGET(pGrid,k,j,is));
         // HOLD ANGULAR MOMENTUM CONSTANT
-        pGrid->U[k][j][is-i].M2 = L/r[is-i];
-        pGrid->U[k][j][is-i].M1 = MIN(pGrid->U[k][j][is-i].M1,0.0);
+        UVAR(pGrid,k,j,is-i,M2) = L/r[is-i];
+        UVAR(pGrid,k,j,is-i,M1) = MIN(UVAR(pGrid,k,j,is-i,M1),0.0);
       }
     }
   }
@@ -283,12 +283,12 @@ void diode_outflow_ox1(GridS *pGrid)
 
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
-      L = r[ie]*pGrid->U[k][j][ie].M2;
+      L = r[ie]*UVAR(pGrid,k,j,ie,M2);
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][ie];
+        USET(pGrid,k,j,ie+i,UGET(pGrid,k,j,ie));
         // HOLD ANGULAR MOMENTUM CONSTANT
-        pGrid->U[k][j][ie+i].M2 = L/r[ie+i];
-        pGrid->U[k][j][ie+i].M1 = MAX(pGrid->U[k][j][ie+i].M1,0.0);
+        UVAR(pGrid,k,j,ie+i,M2) = L/r[ie+i];
+        UVAR(pGrid,k,j,ie+i,M1) = MAX(UVAR(pGrid,k,j,ie+i,M1),0.0);
       }
     }
   }
@@ -39,7 +39,7 @@ static ConsS ***RootSoln=NULL;
 void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
-  int i,j,k,converged;
+  int i,j,k,converged,n;
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3; 
   Real x1,x2,x3,a,b;
@@ -78,7 +78,7 @@ void problem(DomainS *pDomain)
 
   for (i=il; i<=iu; i++) {
     cc_pos(pG,i,js,ks,&x1,&x2,&x3);
-    memset(&(pG->U[ks][js][i]),0.0,sizeof(ConsS));
+    for (n=0; n<NVAR; n++) UCOMP(pG,ks,js,i,n) = 0.0;
 
     switch(iprob) {
       case 1: /* Parker wind */
@@ -103,21 +103,21 @@ void problem(DomainS *pDomain)
     converged = bisection(myfunc,a,b,x1,&v);
     if (!converged) ath_error("[cylwind]:  Bisection did not converge!\n");
 
-    pG->U[ks][js][i].d   = lambda_s/(x1*v);
-    pG->U[ks][js][i].M1  = lambda_s/x1;
+    UVAR(pG,ks,js,i,d)   = lambda_s/(x1*v);
+    UVAR(pG,ks,js,i,M1)  = lambda_s/x1;
     if (iprob==2)
-      pG->U[ks][js][i].M1  *= -1.0;
+      UVAR(pG,ks,js,i,M1)  *= -1.0;
 
 #ifdef MHD
-    pG->U[ks][js][i].B1c = b0/x1;
+    UVAR(pG,ks,js,i,B1c) = b0/x1;
     pG->B1i[ks][js][i]   = b0/(x1-0.5*pG->dx1);
 #endif /* MHD */
 
     /* Initialize total energy */
 #ifndef ISOTHERMAL
     pgas0 = 1.0/Gamma;
-    pgas = pgas0*pow(pG->U[ks][js][i].d,Gamma);
-    pG->U[ks][js][i].E = pgas/Gamma_1 + 0.5*SQR(pG->U[ks][js][i].M1)/pG->U[ks][js][i].d;
+    pgas = pgas0*pow(UVAR(pG,ks,js,i,d),Gamma);
+    UVAR(pG,ks,js,i,E) = pgas/Gamma_1 + 0.5*SQR(UVAR(pG,ks,js,i,M1))/UVAR(pG,ks,js,i,d);
 #endif /* ISOTHERMAL */
   }
 
@@ -125,8 +125,8 @@ void problem(DomainS *pDomain)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i] = pG->U[ks][js][i];
-        RootSoln[k][j][i] = pG->U[k][j][i];
+        USET(pG,k,j,i,UGET(pG,ks,js,i));
+        RootSoln[k][j][i] = UGET(pG,k,j,i);
       }
     }
   }
@@ -33,7 +33,7 @@ static ConsS ***RootSoln=NULL;
 void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
-  int i,j,k;
+  int i,j,k,n;
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3;
   Real x1,x2,x3;
@@ -82,7 +82,7 @@ void problem(DomainS *pDomain)
   // Compute 1D wind/accretion solution
   for (i=il; i<=iu; i++) {
     cc_pos(pG,i,j,k,&x1,&x2,&x3);
-    memset(&(pG->U[ks][js][i]),0.0,sizeof(ConsS));
+    for (n=0; n<NVAR; n++) UCOMP(pG,ks,js,i,n) = 0.0;
     vs = pow(lambda_s/x1,0.5*beta);
 
     switch(iprob) {
@@ -108,19 +108,19 @@ void problem(DomainS *pDomain)
     converged = bisection(myfunc,a,b,x1,&v);
     if (!converged) ath_error("[cylwindrot]:  Bisection did not converge!\n");
 
-    pG->U[ks][js][i].d   = lambda_s/(x1*v);
-    pG->U[ks][js][i].M1  = lambda_s/x1;
+    UVAR(pG,ks,js,i,d)   = lambda_s/(x1*v);
+    UVAR(pG,ks,js,i,M1)  = lambda_s/x1;
     if (iprob==2)
-      pG->U[ks][js][i].M1  *= -1.0;
-    pG->U[ks][js][i].M2  = pG->U[ks][js][i].d*ang_mom/x1;
-    pG->U[ks][js][i].M3  = pG->U[ks][js][i].d*vz0;
+      UVAR(pG,ks,js,i,M1)  *= -1.0;
+    UVAR(pG,ks,js,i,M2)  = UVAR(pG,ks,js,i,d)*ang_mom/x1;
+    UVAR(pG,ks,js,i,M3)  = UVAR(pG,ks,js,i,d)*vz0;
 
         /* Initialize total energy */
 #ifndef ISOTHERMAL
         pgas0 = 1.0/Gamma;
-        pgas = pgas0*pow(pG->U[ks][js][i].d,Gamma);
-        pG->U[ks][js][i].E = pgas/Gamma_1
-          + 0.5*(SQR(pG->U[ks][js][i].M1) + SQR(pG->U[ks][js][i].M2) + SQR(pG->U[ks][js][i].M3))/pG->U[ks][js][i].d;
+        pgas = pgas0*pow(UVAR(pG,ks,js,i,d),Gamma);
+        UVAR(pG,ks,js,i,E) = pgas/Gamma_1
+          + 0.5*(SQR(UVAR(pG,ks,js,i,M1)) + SQR(UVAR(pG,ks,js,i,M2)) + SQR(UVAR(pG,ks,js,i,M3)))/UVAR(pG,ks,js,i,d);
 #endif /* ISOTHERMAL */
   }
 
@@ -128,8 +128,8 @@ void problem(DomainS *pDomain)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i] = pG->U[ks][js][i];
-        RootSoln[k][j][i] = pG->U[ks][js][i];
+        USET(pG,k,j,i,UGET(pG,ks,js,i));
+        RootSoln[k][j][i] = UGET(pG,ks,js,i);
       }
     }
   }
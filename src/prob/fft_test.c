@@ -10,6 +10,8 @@
  *      input data -> d
  *      real part of FFT(d) -> M1
  *      imaginary part of FFT(d) -> M2
+ *      (in 3D only the local part of the half spectrum is stored, in the
+ *      first cnx3 zones in x3, and M1=M2=0 above it)
  *      IFFT(FFT(d)) -> M3
  *
  *  - Last updated Mar 29, 2012
@@ -63,10 +65,10 @@ void problem(DomainS *pD)
       for (i=is; i<=ie; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
         r2=SQR(x1)+SQR(x2)+SQR(x3);
-        pG->U[k][j][i].d = exp(-r2);
-        pG->U[k][j][i].M1 = 0.0;
-        pG->U[k][j][i].M2 = 0.0;
-        pG->U[k][j][i].M3 = 0.0;
+        UVAR(pG,k,j,i,d) = exp(-r2);
+        UVAR(pG,k,j,i,M1) = 0.0;
+        UVAR(pG,k,j,i,M2) = 0.0;
+        UVAR(pG,k,j,i,M3) = 0.0;
       }
     }
   }
@@ -192,18 +194,22 @@ void do_fft(DomainS *pD)
   int j, js=pG->js, je = pG->je;
   int k, ks=pG->ks, ke = pG->ke;
   Real r2,x1,x2,x3;
+  ath_fft_real *rwork = (ath_fft_real *)work;
+  int rnx3, cnx3;
 
 
   if(pD->Nx[2] > 1) {
 /* 3D case */
+    rnx3 = pD->fplan3d->rnx3;
+    cnx3 = pD->fplan3d->cnx3;
 
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
           cc_pos(pG,i,j,k,&x1,&x2,&x3);
           r2=SQR(x1)+SQR(x2)+SQR(x3);
-          pG->U[k][j][i].d = exp(-r2);
-          work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = pG->U[k][j][i].d;
+          UVAR(pG,k,j,i,d) = exp(-r2);
+          rwork[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],rnx3)] = UVAR(pG,k,j,i,d);
         }
       }
     }
@@ -213,8 +219,13 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M1 = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0];
-          pG->U[k][j][i].M2 = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1];
+          if (k-ks < cnx3) {
+            UVAR(pG,k,j,i,M1) = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],cnx3)][0];
+            UVAR(pG,k,j,i,M2) = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],cnx3)][1];
+          } else {
+            UVAR(pG,k,j,i,M1) = 0.0;
+            UVAR(pG,k,j,i,M2) = 0.0;
+          }
         }
       }
     }
@@ -224,7 +235,7 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M3 = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0]/pD->bplan3d->gcnt;
+          UVAR(pG,k,j,i,M3) = rwork[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],rnx3)]/pD->bplan3d->gcnt;
         }
       }
     }
@@ -237,8 +248,8 @@ void do_fft(DomainS *pD)
         for (i=is; i<=ie; i++) {
           cc_pos(pG,i,j,k,&x1,&x2,&x3);
           r2=SQR(x1)+SQR(x2);
-          pG->U[k][j][i].d = exp(-r2);
-          work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] = pG->U[k][j][i].d;
+          UVAR(pG,k,j,i,d) = exp(-r2);
+          work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] = UVAR(pG,k,j,i,d);
         }
       }
     }
@@ -248,8 +259,8 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M1 = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0];
-          pG->U[k][j][i].M2 = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1];
+          UVAR(pG,k,j,i,M1) = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0];
+          UVAR(pG,k,j,i,M2) = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1];
         }
       }
     }
@@ -259,7 +270,7 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M3 = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0]/pD->bplan2d->gcnt;
+          UVAR(pG,k,j,i,M3) = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0]/pD->bplan2d->gcnt;
         }
       }
     }
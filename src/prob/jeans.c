@@ -124,26 +124,26 @@ printf("4piG=%e, lambda=%e, period=%e\n",four_pi_G, lambda, (2.0*PI/omega));
     sinkx = sin(x3*kwave);
     coskx = cos(x3*kwave);
   }
-    pGrid->U[k][j][i].d = d0*(1.0 + amp*sinkx);
+    UVAR(pGrid,k,j,i,d) = d0*(1.0 + amp*sinkx);
 #ifndef ISOTHERMAL
-    pGrid->U[k][j][i].E = (p0/Gamma_1)*(1.0+Gamma*amp*sinkx) + 
+    UVAR(pGrid,k,j,i,E) = (p0/Gamma_1)*(1.0+Gamma*amp*sinkx) + 
                 b0*b0*(0.5+amp*sinkx);
 #endif /* ISOTHERMAL */
   switch(kdir){
     case 1:
-    pGrid->U[k][j][i].M1 = (omega2<0.0)? d0*(omega/kwave)*amp*coskx: 0.0;
-    pGrid->U[k][j][i].M2 = 0.0;
-    pGrid->U[k][j][i].M3 = 0.0;
+    UVAR(pGrid,k,j,i,M1) = (omega2<0.0)? d0*(omega/kwave)*amp*coskx: 0.0;
+    UVAR(pGrid,k,j,i,M2) = 0.0;
+    UVAR(pGrid,k,j,i,M3) = 0.0;
     break;
   case 2:
-    pGrid->U[k][j][i].M1 = 0.0;
-    pGrid->U[k][j][i].M2 = (omega2<0.0)? d0*(omega/kwave)*amp*coskx: 0.0;
-    pGrid->U[k][j][i].M3 = 0.0;
+    UVAR(pGrid,k,j,i,M1) = 0.0;
+    UVAR(pGrid,k,j,i,M2) = (omega2<0.0)? d0*(omega/kwave)*amp*coskx: 0.0;
+    UVAR(pGrid,k,j,i,M3) = 0.0;
     break;
   case 3:
-    pGrid->U[k][j][i].M1 = 0.0;
-    pGrid->U[k][j][i].M2 = 0.0;
-    pGrid->U[k][j][i].M3 = (omega2<0.0)? d0*(omega/kwave)*amp*coskx: 0.0;
+    UVAR(pGrid,k,j,i,M1) = 0.0;
+    UVAR(pGrid,k,j,i,M2) = 0.0;
+    UVAR(pGrid,k,j,i,M3) = (omega2<0.0)? d0*(omega/kwave)*amp*coskx: 0.0;
   }
 #ifdef MHD
   switch(kdir){
@@ -151,30 +151,30 @@ printf("4piG=%e, lambda=%e, period=%e\n",four_pi_G, lambda, (2.0*PI/omega));
     pGrid->B1i[k][j][i] = 0.0;
     pGrid->B2i[k][j][i] = b0*(1.0+amp*sin(kwave*xl));
     pGrid->B3i[k][j][i] = 0.0;
-    pGrid->U[k][j][i].B1c = 0.0;
-    pGrid->U[k][j][i].B2c = b0*(1.0+amp*sinkx);
-    pGrid->U[k][j][i].B3c = 0.0;
+    UVAR(pGrid,k,j,i,B1c) = 0.0;
+    UVAR(pGrid,k,j,i,B2c) = b0*(1.0+amp*sinkx);
+    UVAR(pGrid,k,j,i,B3c) = 0.0;
     break;
     case 2:
     pGrid->B1i[k][j][i] = b0*(1.0+amp*sin(kwave*xl));
     pGrid->B2i[k][j][i] = 0.0;
     pGrid->B3i[k][j][i] = 0.0;
-    pGrid->U[k][j][i].B1c = b0*(1.0+amp*sinkx);
-    pGrid->U[k][j][i].B2c = 0.0;
-    pGrid->U[k][j][i].B3c = 0.0;
+    UVAR(pGrid,k,j,i,B1c) = b0*(1.0+amp*sinkx);
+    UVAR(pGrid,k,j,i,B2c) = 0.0;
+    UVAR(pGrid,k,j,i,B3c) = 0.0;
     break;
     case 3:
     pGrid->B1i[k][j][i] = b0*(1.0+amp*sin(kwave*xl));
     pGrid->B2i[k][j][i] = 0.0;
     pGrid->B3i[k][j][i] = 0.0;
-    pGrid->U[k][j][i].B1c = b0*(1.0+amp*sinkx);
-    pGrid->U[k][j][i].B2c = 0.0;
-    pGrid->U[k][j][i].B3c = 0.0;
+    UVAR(pGrid,k,j,i,B1c) = b0*(1.0+amp*sinkx);
+    UVAR(pGrid,k,j,i,B2c) = 0.0;
+    UVAR(pGrid,k,j,i,B3c) = 0.0;
   }
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pGrid->U[k][j][i].s[n] = 0.0;
+        UVAR(pGrid,k,j,i,s[n]) = 0.0;
 #endif
   }}}
 
@@ -207,7 +207,7 @@ void problem_read_restart(MeshS *pM, FILE *fp)
  *  \brief returns first passively advected scalar s[0] */
 static Real color(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].s[0]/pG->U[k][j][i].d;
+  return UVAR(pG,k,j,i,s[0])/UVAR(pG,k,j,i,d);
 }
 #endif
 
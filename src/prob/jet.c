@@ -102,15 +102,15 @@ void problem(DomainS *pDomain){
    for(k=kl; k<=ku; k++){
       for(j=jl; j<=ju; j++){
          for(i=il; i<=iu; i++){
-            pGrid->U[k][j][i].d  = U.d;
-            pGrid->U[k][j][i].M1 = U.Mx;
-            pGrid->U[k][j][i].M2 = U.My;
-            pGrid->U[k][j][i].M3 = U.Mz;
-            pGrid->U[k][j][i].E  = U.E;
+            UVAR(pGrid,k,j,i,d)  = U.d;
+            UVAR(pGrid,k,j,i,M1) = U.Mx;
+            UVAR(pGrid,k,j,i,M2) = U.My;
+            UVAR(pGrid,k,j,i,M3) = U.Mz;
+            UVAR(pGrid,k,j,i,E)  = U.E;
 #ifdef MHD
-            pGrid->U[k][j][i].B1c = Bx;
-            pGrid->U[k][j][i].B2c = U.By;
-            pGrid->U[k][j][i].B3c = U.Bz;
+            UVAR(pGrid,k,j,i,B1c) = Bx;
+            UVAR(pGrid,k,j,i,B2c) = U.By;
+            UVAR(pGrid,k,j,i,B3c) = U.Bz;
             pGrid->B1i[k][j][i] = Bx;
             pGrid->B2i[k][j][i] = U.By;
             pGrid->B3i[k][j][i] = U.Bz;
@@ -212,25 +212,25 @@ void jet_iib(GridS *pGrid){
         rad = sqrt(SQR(x2 - x2_mid) + SQR(x3 - x3_mid));
             
         if(rad <= rjet){
-          pGrid->U[k][j][is-i].d  = Ujet.d;
-          pGrid->U[k][j][is-i].M1 = Ujet.Mx;
-          pGrid->U[k][j][is-i].M2 = Ujet.My;
-          pGrid->U[k][j][is-i].M3 = Ujet.Mz;
-          pGrid->U[k][j][is-i].E  = Ujet.E;
+          UVAR(pGrid,k,j,is-i,d)  = Ujet.d;
+          UVAR(pGrid,k,j,is-i,M1) = Ujet.Mx;
+          UVAR(pGrid,k,j,is-i,M2) = Ujet.My;
+          UVAR(pGrid,k,j,is-i,M3) = Ujet.Mz;
+          UVAR(pGrid,k,j,is-i,E)  = Ujet.E;
 #ifdef MHD
-          pGrid->U[k][j][is-i].B1c = Bxjet;
-          pGrid->U[k][j][is-i].B2c = Ujet.By;
-          pGrid->U[k][j][is-i].B3c = Ujet.Bz;
+          UVAR(pGrid,k,j,is-i,B1c) = Bxjet;
+          UVAR(pGrid,k,j,is-i,B2c) = Ujet.By;
+          UVAR(pGrid,k,j,is-i,B3c) = Ujet.Bz;
           pGrid->B1i[k][j][is-i] = Bxjet;
           pGrid->B2i[k][j][is-i] = Ujet.By;
           pGrid->B3i[k][j][is-i] = Ujet.Bz;
 #endif
         } else{
-          pGrid->U[k][j][is-i] = pGrid->U[k][j][is+(i-1)];
-          pGrid->U[k][j][is-i].M1 = -pGrid->U[k][j][is-i].M1;
+          USET(pGrid,k,j,is-i,UGET(pGrid,k,j,is+(i-1)));
+          UVAR(pGrid,k,j,is-i,M1) = -UVAR(pGrid,k,j,is-i,M1);
 #ifdef MHD
-          pGrid->U[k][j][is-i].B2c = -pGrid->U[k][j][is-i].B2c;
-          pGrid->U[k][j][is-i].B3c = -pGrid->U[k][j][is-i].B3c;
+          UVAR(pGrid,k,j,is-i,B2c) = -UVAR(pGrid,k,j,is-i,B2c);
+          UVAR(pGrid,k,j,is-i,B3c) = -UVAR(pGrid,k,j,is-i,B3c);
           pGrid->B1i[k][j][is-i] =  pGrid->B1i[k][j][is+i];
           pGrid->B2i[k][j][is-i] = -pGrid->B2i[k][j][is+(i-1)];
           pGrid->B3i[k][j][is-i] = -pGrid->B3i[k][j][is+(i-1)];
@@ -307,18 +307,18 @@ void problem(DomainS *pDomain)
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
   for (i=is; i<=ie; i++) {
-    pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+    UVAR(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
   }}}
 
   if (pGrid->Nx[1] > 1) {
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+      UVAR(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
     }}}
   } else {
     for (i=is; i<=ie; i++) {
-      pGrid->U[ks][js][i].B2c = pGrid->B2i[ks][js][i];
+      UVAR(pGrid,ks,js,i,B2c) = pGrid->B2i[ks][js][i];
     }
   }
 
@@ -326,12 +326,12 @@ void problem(DomainS *pDomain)
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[k][j][i].B3c = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+      UVAR(pGrid,k,j,i,B3c) = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
     }}}
   } else {
     for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pGrid->U[ks][j][i].B3c = pGrid->B3i[ks][j][i];
+      UVAR(pGrid,ks,j,i,B3c) = pGrid->B3i[ks][j][i];
     }}
   }
 #endif /* MHD */
@@ -347,18 +347,18 @@ void problem(DomainS *pDomain)
 
 	sn = sin(k_par*x);
 
-	pGrid->U[k][j][i].d = d0 + amp*sn*rem[0][wave_flag];
+	UVAR(pGrid,k,j,i,d) = d0 + amp*sn*rem[0][wave_flag];
 
 	Mx = d0*vflow + amp*sn*rem[1][wave_flag];
 	My = amp*sn*rem[2][wave_flag];
 	Mz = amp*sn*rem[3][wave_flag];
 
-	pGrid->U[k][j][i].M1 = Mx*cos_a2*cos_a3 - My*sin_a3 - Mz*sin_a2*cos_a3;
-	pGrid->U[k][j][i].M2 = Mx*cos_a2*sin_a3 + My*cos_a3 - Mz*sin_a2*sin_a3;
-	pGrid->U[k][j][i].M3 = Mx*sin_a2                    + Mz*cos_a2;
+	UVAR(pGrid,k,j,i,M1) = Mx*cos_a2*cos_a3 - My*sin_a3 - Mz*sin_a2*cos_a3;
+	UVAR(pGrid,k,j,i,M2) = Mx*cos_a2*sin_a3 + My*cos_a3 - Mz*sin_a2*sin_a3;
+	UVAR(pGrid,k,j,i,M3) = Mx*sin_a2                    + Mz*cos_a2;
 
 #ifndef ISOTHERMAL
-	pGrid->U[k][j][i].E = p0/Gamma_1 + 0.5*d0*u0*u0 +
+	UVAR(pGrid,k,j,i,E) = p0/Gamma_1 + 0.5*d0*u0*u0 +
 #ifdef MHD
 	  0.5*(bx0*bx0 + by0*by0 + bz0*bz0) +
 #endif /* MHD */
@@ -367,7 +367,7 @@ void problem(DomainS *pDomain)
 
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pGrid->U[k][j][i].s[n] = pGrid->U[k][j][i].d*(1.0 + amp*(sn - 1.0));
+          UVAR(pGrid,k,j,i,s[n]) = UVAR(pGrid,k,j,i,d)*(1.0 + amp*(sn - 1.0));
 #endif
       }
     }
@@ -634,21 +634,21 @@ void Userwork_after_loop(MeshS *pM)
 #endif
 
     for (i=is; i<=ie; i++) {
-      error.d   += fabs(pGrid->U[k][j][i].d   - RootSoln[k][j][i].d );
-      error.M1  += fabs(pGrid->U[k][j][i].M1  - RootSoln[k][j][i].M1);
-      error.M2  += fabs(pGrid->U[k][j][i].M2  - RootSoln[k][j][i].M2);
-      error.M3  += fabs(pGrid->U[k][j][i].M3  - RootSoln[k][j][i].M3); 
+      error.d   += fabs(UVAR(pGrid,k,j,i,d)   - RootSoln[k][j][i].d );
+      error.M1  += fabs(UVAR(pGrid,k,j,i,M1)  - RootSoln[k][j][i].M1);
+      error.M2  += fabs(UVAR(pGrid,k,j,i,M2)  - RootSoln[k][j][i].M2);
+      error.M3  += fabs(UVAR(pGrid,k,j,i,M3)  - RootSoln[k][j][i].M3); 
 #ifdef MHD
-      error.B1c += fabs(pGrid->U[k][j][i].B1c - RootSoln[k][j][i].B1c);
-      error.B2c += fabs(pGrid->U[k][j][i].B2c - RootSoln[k][j][i].B2c);
-      error.B3c += fabs(pGrid->U[k][j][i].B3c - RootSoln[k][j][i].B3c);
+      error.B1c += fabs(UVAR(pGrid,k,j,i,B1c) - RootSoln[k][j][i].B1c);
+      error.B2c += fabs(UVAR(pGrid,k,j,i,B2c) - RootSoln[k][j][i].B2c);
+      error.B3c += fabs(UVAR(pGrid,k,j,i,B3c) - RootSoln[k][j][i].B3c);
 #endif /* MHD */
 #ifndef ISOTHERMAL
-      error.E   += fabs(pGrid->U[k][j][i].E   - RootSoln[k][j][i].E );
+      error.E   += fabs(UVAR(pGrid,k,j,i,E)   - RootSoln[k][j][i].E );
 #endif /* ISOTHERMAL */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        error.s[n] += fabs(pGrid->U[k][j][i].s[n] - RootSoln[k][j][i].s[n]);
+        error.s[n] += fabs(UVAR(pGrid,k,j,i,s[n]) - RootSoln[k][j][i].s[n]);
 #endif
     }
 
@@ -699,7 +699,7 @@ void problem(DomainS *pDomain)
 	}
 
 	if(mix < qa_min_ix){ /* This cell is in the left state */
-	  pGrid->U[k][j][i] = ql;
+	  USET(pGrid,k,j,i,ql);
 #ifdef MHD
 	  pGrid->B1i[k][j][i] = ql.B1c;
 	  pGrid->B2i[k][j][i] = ql.B2c;
@@ -707,7 +707,7 @@ void problem(DomainS *pDomain)
 #endif
 	}
 	else if(mix >= qa_max_ix){ /* This cell is in the right state */
-	  pGrid->U[k][j][i] = qr;
+	  USET(pGrid,k,j,i,qr);
 #ifdef MHD
 	  pGrid->B1i[k][j][i] = qr.B1c;
 	  pGrid->B2i[k][j][i] = qr.B2c;
@@ -715,7 +715,7 @@ void problem(DomainS *pDomain)
 #endif
 	}
 	else{ /* Otherwise it's in the qa[][][] array */
-	  pGrid->U[k][j][i] = qa[mkx][mjx][mix - qa_min_ix];
+	  USET(pGrid,k,j,i,qa[mkx][mjx][mix - qa_min_ix]);
 #ifdef MHD
 	  pGrid->B1i[k][j][i] = aB1i[mkx][mjx][mix - qa_min_ix];
 	  pGrid->B2i[k][j][i] = aB2i[mkx][mjx][mix - qa_min_ix];
@@ -1003,17 +1003,17 @@ void Userwork_after_loop(MeshS *pM)
 #endif /* ISOTHERMAL */
 
     for (i=is; i<=ie; i++) {
-      error.d   += fabs(pGrid->U[k][j][i].d   - RootSoln[k][j][i].d );
-      error.M1  += fabs(pGrid->U[k][j][i].M1  - RootSoln[k][j][i].M1);
-      error.M2  += fabs(pGrid->U[k][j][i].M2  - RootSoln[k][j][i].M2);
-      error.M3  += fabs(pGrid->U[k][j][i].M3  - RootSoln[k][j][i].M3); 
+      error.d   += fabs(UVAR(pGrid,k,j,i,d)   - RootSoln[k][j][i].d );
+      error.M1  += fabs(UVAR(pGrid,k,j,i,M1)  - RootSoln[k][j][i].M1);
+      error.M2  += fabs(UVAR(pGrid,k,j,i,M2)  - RootSoln[k][j][i].M2);
+      error.M3  += fabs(UVAR(pGrid,k,j,i,M3)  - RootSoln[k][j][i].M3); 
 #ifdef MHD
-      error.B1c += fabs(pGrid->U[k][j][i].B1c - RootSoln[k][j][i].B1c);
-      error.B2c += fabs(pGrid->U[k][j][i].B2c - RootSoln[k][j][i].B2c);
-      error.B3c += fabs(pGrid->U[k][j][i].B3c - RootSoln[k][j][i].B3c);
+      error.B1c += fabs(UVAR(pGrid,k,j,i,B1c) - RootSoln[k][j][i].B1c);
+      error.B2c += fabs(UVAR(pGrid,k,j,i,B2c) - RootSoln[k][j][i].B2c);
+      error.B3c += fabs(UVAR(pGrid,k,j,i,B3c) - RootSoln[k][j][i].B3c);
 #endif /* MHD */
 #ifndef ISOTHERMAL
-      error.E   += fabs(pGrid->U[k][j][i].E   - RootSoln[k][j][i].E );
+      error.E   += fabs(UVAR(pGrid,k,j,i,E)   - RootSoln[k][j][i].E );
 #endif /* ISOTHERMAL */
     }
 
@@ -1199,7 +1199,7 @@ static void lx_bc(GridS *pG)
 	}
         else continue;
 
-	pG->U[k][j][i] = pG->U[mk][mj][mi];
+	USET(pG,k,j,i,UGET(pG,mk,mj,mi));
 #ifdef MHD
 	pG->B1i[k][j][i] = pG->B1i[mk][mj][mi];
         pG->B2i[k][j][i] = pG->B2i[mk][mj][mi];
@@ -1240,7 +1240,7 @@ static void rx_bc(GridS *pG)
 	}
         else continue;
 
-	pG->U[k][j][i] = pG->U[mk][mj][mi];
+	USET(pG,k,j,i,UGET(pG,mk,mj,mi));
 #ifdef MHD
 	if(i > ie+1) pG->B1i[k][j][i] = pG->B1i[mk][mj][mi];
         pG->B2i[k][j][i] = pG->B2i[mk][mj][mi];
@@ -1281,7 +1281,7 @@ static void ly_bc(GridS *pG)
         }
         else continue;
 
-	pG->U[k][j][i] = pG->U[mk][mj][mi];
+	USET(pG,k,j,i,UGET(pG,mk,mj,mi));
 #ifdef MHD
 	pG->B1i[k][j][i] = pG->B1i[mk][mj][mi];
         pG->B2i[k][j][i] = pG->B2i[mk][mj][mi];
@@ -1322,7 +1322,7 @@ static void ry_bc(GridS *pG)
         }
         else continue;
 
-	pG->U[k][j][i] = pG->U[mk][mj][mi];
+	USET(pG,k,j,i,UGET(pG,mk,mj,mi));
 #ifdef MHD
 	pG->B1i[k][j][i] = pG->B1i[mk][mj][mi];
         if(j > je+1) pG->B2i[k][j][i] = pG->B2i[mk][mj][mi];
@@ -1363,7 +1363,7 @@ static void lz_bc(GridS *pG)
 	}
         else continue;
 
-	pG->U[k][j][i] = pG->U[mk][mj][mi];
+	USET(pG,k,j,i,UGET(pG,mk,mj,mi));
 #ifdef MHD
 	pG->B1i[k][j][i] = pG->B1i[mk][mj][mi];
         pG->B2i[k][j][i] = pG->B2i[mk][mj][mi];
@@ -1404,7 +1404,7 @@ static void rz_bc(GridS *pG)
 	}
         else continue;
 
-	pG->U[k][j][i] = pG->U[mk][mj][mi];
+	USET(pG,k,j,i,UGET(pG,mk,mj,mi));
 #ifdef MHD
 	pG->B1i[k][j][i] = pG->B1i[mk][mj][mi];
         pG->B2i[k][j][i] = pG->B2i[mk][mj][mi];
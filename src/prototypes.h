@@ -27,14 +27,26 @@
 /* main.c */
 int athena_main(int argc, char *argv[]);
 
+/*----------------------------------------------------------------------------*/
+/* amr.c */
+#ifdef STATIC_MESH_REFINEMENT
+void AMR_init(MeshS *pM);
+void Regrid(MeshS *pM);
+#endif
+
 /*----------------------------------------------------------------------------*/
 /* ath_array.c */
 void*   calloc_1d_array(                      size_t nc, size_t size);
 void**  calloc_2d_array(           size_t nr, size_t nc, size_t size);
 void*** calloc_3d_array(size_t nt, size_t nr, size_t nc, size_t size);
+void*** calloc_3d_aligned_array(size_t nt, size_t nr, size_t nc, size_t size);
+Real*   calloc_pencil(void *pencil, size_t nvar, size_t nc);
+void*** map_3d_array(void *data, size_t nt, size_t nr, size_t pitch);
 void free_1d_array(void *array);
 void free_2d_array(void *array);
 void free_3d_array(void *array);
+void free_3d_map(void *array);
+void free_pencil(void *pencil);
 
 /*----------------------------------------------------------------------------*/
 /* ath_log.c */
@@ -70,6 +82,8 @@ void baton_stop(const int Nb, const int tag);
 void bvals_mhd_init(MeshS *pM);
 void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc);
 void bvals_mhd(DomainS *pDomain);
+void bvals_mhd_start(DomainS *pDomain);
+void bvals_mhd_finish(DomainS *pDomain);
 
 /*----------------------------------------------------------------------------*/
 /* bvals_shear.c  */
@@ -131,7 +145,19 @@ PrimS Cons_to_Prim(const ConsS *pU);
 ConsS Prim_to_Cons(const PrimS *pW);
 Prim1DS Cons1D_to_Prim1D(const Cons1DS *pU, const Real *pBx);
 Cons1DS Prim1D_to_Cons1D(const Prim1DS *pW, const Real *pBx);
+void Cons1D_to_pencil(const int il, const int iu, const Cons1DS *U,
+                      Cons1DArrS *pU);
+void Prim1D_to_pencil(const int il, const int iu, const Prim1DS *W,
+                      Prim1DArrS *pW);
+void pencil_to_Cons1D(const int il, const int iu, const Cons1DArrS *pU,
+                      Cons1DS *U);
+void pencil_to_Prim1D(const int il, const int iu, const Prim1DArrS *pW,
+                      Prim1DS *W);
 #ifndef SPECIAL_RELATIVITY
+void Cons1D_to_Prim1D_pencil(const int il, const int iu, const Cons1DArrS *pU,
+                             const Real *Bx, Prim1DArrS *pW);
+void Prim1D_to_Cons1D_pencil(const int il, const int iu, const Prim1DArrS *pW,
+                             const Real *Bx, Cons1DArrS *pU);
 Real cfast_prim(const Prim1DS *W, const Real *Bx);
 Real cfast(const Cons1DS *U, const Real *Bx);
 #endif
@@ -148,11 +174,22 @@ Prim1DS check_Prim1D (const Cons1DS *pU, const Real *pBx);
 /*----------------------------------------------------------------------------*/
 /* init_grid.c */
 void init_grid(MeshS *pM);
+#ifdef STATIC_MESH_REFINEMENT
+void init_grid_smr(MeshS *pM);
+void free_grid_smr(MeshS *pM);
+#endif
+#ifdef MPI_PARALLEL
+size_t shm_grid_bytes(const GridS *pG);
+void shm_grid_map(GridS *pG, void *base);
+#endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
 /* init_mesh.c */
-void init_mesh(MeshS *pM);
+void init_mesh(MeshS *pM, const int ires);
 void get_myGridIndex(DomainS *pD, const int my_id, int *pi, int *pj, int *pk);
+#ifdef MPI_PARALLEL
+void record_grid_cost(MeshS *pM);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* new_dt.c */
@@ -242,7 +279,15 @@ void show_config_par(void);
 /* smr.c */
 void RestrictCorrect(MeshS *pM);
 void Prolongate(MeshS *pM);
+void RestrictCorrect_Level(MeshS *pM, const int nl);
+void Prolongate_Level(MeshS *pM, const int nl, const Real frac);
+void Prolongate_Save(MeshS *pM, const int nl);
+void Average_FineFlux(MeshS *pM, const int nl, const int isub);
 void SMR_init(MeshS *pM);
+#ifdef SELF_GRAVITY
+void Prolongate_Phi(MeshS *pM, const int nl);
+void RestrictCorrect_Phi(MeshS *pM, const int nl);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* units.c */
@@ -271,6 +316,11 @@ int ath_gcd(int a, int b);
 int ath_big_endian(void);
 void ath_bswap(void *vdat, int sizeof_len, int cnt);
 void ath_error(char *fmt, ...);
+#ifdef SOA_STORAGE
+ConsS get_cons(const GridS *pG, const int k, const int j, const int i);
+void put_cons(GridS *pG, const int k, const int j, const int i, const ConsS q);
+const ConsS *cons_ptr(const GridS *pG, const int k, const int j, const int i);
+#endif
 void minmax1(Real   *data, int nx1,                   Real *dmin, Real *dmax);
 void minmax2(Real  **data, int nx2, int nx1,          Real *dmin, Real *dmax);
 void minmax3(Real ***data, int nx3, int nx2, int nx1, Real *dmin, Real *dmax);
@@ -28,6 +28,9 @@
  * - esys_prim_adb_hyd() - adiabatic hydrodynamics
  * - esys_prim_iso_mhd() - isothermal MHD
  * - esys_prim_adb_mhd() - adiabatic MHD
+ * - esys_prim_iso_hyd_pencil(), esys_prim_adb_hyd_pencil(),
+ *   esys_prim_iso_mhd_pencil(), esys_prim_adb_mhd_pencil() - the same over a
+ *                          pencil of cells
  *============================================================================*/
 
 #include <math.h>
@@ -585,3 +588,433 @@ void esys_prim_adb_mhd(const Real d, const Real v1, const Real rho_a2,
   left_eigenmatrix[6][6] = left_eigenmatrix[0][6];
 }
 #endif
+
+/*----------------------------------------------------------------------------*/
+/*  The functions below compute the same eigensystems as those above for each
+ *  cell il..iu of a pencil at once.  The eigenvalues and eigenmatrices are
+ *  stored as a 1D array over the pencil for each element, e.g. the right-
+ *  eigenmatrix of cell i is right_eigenmatrix[*][*][i], so that the loops over
+ *  cells can be vectorized.  The arithmetic is identical to the functions
+ *  above, with the branches written as selects.  Zero components are not set.
+ */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void esys_prim_iso_hyd_pencil(const int il, const int iu,
+ *  const Real *d, const Real *v1, Real **eigenvalues,
+ *  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+ *  \brief ISOTHERMAL HYDRO, over cells il..iu of a pencil
+ */
+
+#if defined(BAROTROPIC) && defined(HYDRO)
+void esys_prim_iso_hyd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+{
+  Real **ev = eigenvalues, ***rem = right_eigenmatrix;
+  Real ***lem = left_eigenmatrix;
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+    ev[0][i] = v1[i] - Iso_csound;
+    ev[1][i] = v1[i];
+    ev[2][i] = v1[i];
+    ev[3][i] = v1[i] + Iso_csound;
+
+    rem[0][0][i] = 1.0;
+    rem[1][0][i] = -Iso_csound/d[i];
+    rem[2][1][i] = 1.0;
+    rem[3][2][i] = 1.0;
+    rem[0][3][i] = 1.0;
+    rem[1][3][i] = Iso_csound/d[i];
+
+    lem[0][0][i] = 0.5;
+    lem[0][1][i] = -0.5*d[i]/Iso_csound;
+    lem[1][2][i] = 1.0;
+    lem[2][3][i] = 1.0;
+    lem[3][0][i] = 0.5;
+    lem[3][1][i] = 0.5*d[i]/Iso_csound;
+  }
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void esys_prim_adb_hyd_pencil(const int il, const int iu,
+ *  const Real *d, const Real *v1, const Real *p, Real **eigenvalues,
+ *  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+ *  \brief ADIABATIC HYDRO, over cells il..iu of a pencil.  Note p is the
+ *   pressure; rho_a2 = Gamma*p is computed here.
+ */
+
+#if !defined(BAROTROPIC) && defined(HYDRO)
+void esys_prim_adb_hyd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, const Real *p, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+{
+  Real **ev = eigenvalues, ***rem = right_eigenmatrix;
+  Real ***lem = left_eigenmatrix;
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+    Real asq,a;
+    asq = (Gamma*p[i])/d[i];
+    a = sqrt(asq);
+
+    ev[0][i] = v1[i] - a;
+    ev[1][i] = v1[i];
+    ev[2][i] = v1[i];
+    ev[3][i] = v1[i];
+    ev[4][i] = v1[i] + a;
+
+    rem[0][0][i] = 1.0;
+    rem[1][0][i] = -a/d[i];
+    rem[4][0][i] = asq;
+    rem[0][1][i] = 1.0;
+    rem[2][2][i] = 1.0;
+    rem[3][3][i] = 1.0;
+    rem[0][4][i] = 1.0;
+    rem[1][4][i] = -rem[1][0][i];
+    rem[4][4][i] = asq;
+
+    lem[0][1][i] = -0.5*d[i]/a;
+    lem[0][4][i] = 0.5/asq;
+    lem[1][0][i] = 1.0;
+    lem[1][4][i] = -1.0/asq;
+    lem[2][2][i] = 1.0;
+    lem[3][3][i] = 1.0;
+    lem[4][1][i] = -lem[0][1][i];
+    lem[4][4][i] = lem[0][4][i];
+  }
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void esys_prim_iso_mhd_pencil(const int il, const int iu,
+ *  const Real *d, const Real *v1, const Real *b1, const Real *b2,
+ *  const Real *b3, Real **eigenvalues,
+ *  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+ *  \brief ISOTHERMAL MHD, over cells il..iu of a pencil
+ */
+
+#if defined(BAROTROPIC) && defined(MHD)
+void esys_prim_iso_mhd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, const Real *b1, const Real *b2,
+  const Real *b3, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+{
+  Real **ev = eigenvalues, ***rem = right_eigenmatrix;
+  Real ***lem = left_eigenmatrix;
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+    Real btsq,vaxsq,cfsq,cf,cssq,cs,bt,bet2,bet3,alpha_f,alpha_s;
+    Real sqrtd,s,qf,qs,af,as,vax,norm,af_prime,as_prime;
+    Real ct2,tsum,tdif,cf2_cs2;
+    Real di = 1.0/d[i];
+    btsq  = b2[i]*b2[i] + b3[i]*b3[i];
+    vaxsq = b1[i]*b1[i]*di;
+
+    ct2 = btsq*di;
+    tsum = vaxsq + ct2 + (Iso_csound2);
+    tdif = vaxsq + ct2 - (Iso_csound2);
+    cf2_cs2 = sqrt((double)(tdif*tdif + 4.0*(Iso_csound2)*ct2));
+
+    cfsq = 0.5*(tsum + cf2_cs2);
+    cf = sqrt((double)cfsq);
+
+    cssq = (Iso_csound2)*vaxsq/cfsq;
+    cs = sqrt((double)cssq);
+
+    bt  = sqrt(btsq);
+    bet2 = (bt == 0.0) ? 1.0 : b2[i]/bt;
+    bet3 = (bt == 0.0) ? 0.0 : b3[i]/bt;
+
+/* Cases are tested in reverse order, so the first true case is applied last */
+    alpha_f = sqrt((Iso_csound2 - cssq)/(cfsq - cssq));
+    alpha_s = sqrt((cfsq - Iso_csound2)/(cfsq - cssq));
+    if ( (cfsq - Iso_csound2) <= 0.0) {
+      alpha_f = 1.0;
+      alpha_s = 0.0;
+    }
+    if ( (Iso_csound2 - cssq) <= 0.0) {
+      alpha_f = 0.0;
+      alpha_s = 1.0;
+    }
+    if ((cfsq-cssq) == 0.0) {
+      alpha_f = 1.0;
+      alpha_s = 0.0;
+    }
+
+    sqrtd = sqrt(d[i]);
+    s = SIGN(b1[i]);
+    qf = cf*alpha_f*s;
+    qs = cs*alpha_s*s;
+    af = Iso_csound*alpha_f*sqrtd;
+    as = Iso_csound*alpha_s*sqrtd;
+
+    vax = sqrt(vaxsq);
+    ev[0][i] = v1[i] - cf;
+    ev[1][i] = v1[i] - vax;
+    ev[2][i] = v1[i] - cs;
+    ev[3][i] = v1[i] + cs;
+    ev[4][i] = v1[i] + vax;
+    ev[5][i] = v1[i] + cf;
+
+    rem[0][0][i] = d[i]*alpha_f;
+    rem[1][0][i] = -cf*alpha_f;
+    rem[2][0][i] = qs*bet2;
+    rem[3][0][i] = qs*bet3;
+    rem[4][0][i] = as*bet2;
+    rem[5][0][i] = as*bet3;
+
+    rem[2][1][i] = -bet3;
+    rem[3][1][i] = bet2;
+    rem[4][1][i] = -bet3*s*sqrtd;
+    rem[5][1][i] = bet2*s*sqrtd;
+
+    rem[0][2][i] = d[i]*alpha_s;
+    rem[1][2][i] = -cs*alpha_s;
+    rem[2][2][i] = -qf*bet2;
+    rem[3][2][i] = -qf*bet3;
+    rem[4][2][i] = -af*bet2;
+    rem[5][2][i] = -af*bet3;
+
+    rem[0][3][i] = rem[0][2][i];
+    rem[1][3][i] = -rem[1][2][i];
+    rem[2][3][i] = -rem[2][2][i];
+    rem[3][3][i] = -rem[3][2][i];
+    rem[4][3][i] = rem[4][2][i];
+    rem[5][3][i] = rem[5][2][i];
+
+    rem[2][4][i] = bet3;
+    rem[3][4][i] = -bet2;
+    rem[4][4][i] = rem[4][1][i];
+    rem[5][4][i] = rem[5][1][i];
+
+    rem[0][5][i] = rem[0][0][i];
+    rem[1][5][i] = -rem[1][0][i];
+    rem[2][5][i] = -rem[2][0][i];
+    rem[3][5][i] = -rem[3][0][i];
+    rem[4][5][i] = rem[4][0][i];
+    rem[5][5][i] = rem[5][0][i];
+
+    norm = 0.5/Iso_csound2;
+    qf = norm*qf;
+    qs = norm*qs;
+    af_prime = norm*af*di;
+    as_prime = norm*as*di;
+
+    lem[0][0][i] = norm*alpha_f*Iso_csound2*di;
+    lem[0][1][i] = -norm*cf*alpha_f;
+    lem[0][2][i] = qs*bet2;
+    lem[0][3][i] = qs*bet3;
+    lem[0][4][i] = as_prime*bet2;
+    lem[0][5][i] = as_prime*bet3;
+
+    lem[1][2][i] = -0.5*bet3;
+    lem[1][3][i] = 0.5*bet2;
+    lem[1][4][i] = -0.5*bet3*s/sqrtd;
+    lem[1][5][i] = 0.5*bet2*s/sqrtd;
+
+    lem[2][0][i] = norm*alpha_s*Iso_csound2*di;
+    lem[2][1][i] = -norm*cs*alpha_s;
+    lem[2][2][i] = -qf*bet2;
+    lem[2][3][i] = -qf*bet3;
+    lem[2][4][i] = -af_prime*bet2;
+    lem[2][5][i] = -af_prime*bet3;
+
+    lem[3][0][i] = lem[2][0][i];
+    lem[3][1][i] = -lem[2][1][i];
+    lem[3][2][i] = -lem[2][2][i];
+    lem[3][3][i] = -lem[2][3][i];
+    lem[3][4][i] = lem[2][4][i];
+    lem[3][5][i] = lem[2][5][i];
+
+    lem[4][2][i] = -lem[1][2][i];
+    lem[4][3][i] = -lem[1][3][i];
+    lem[4][4][i] = lem[1][4][i];
+    lem[4][5][i] = lem[1][5][i];
+
+    lem[5][0][i] = lem[0][0][i];
+    lem[5][1][i] = -lem[0][1][i];
+    lem[5][2][i] = -lem[0][2][i];
+    lem[5][3][i] = -lem[0][3][i];
+    lem[5][4][i] = lem[0][4][i];
+    lem[5][5][i] = lem[0][5][i];
+  }
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void esys_prim_adb_mhd_pencil(const int il, const int iu,
+ *  const Real *d, const Real *v1, const Real *p, const Real *b1,
+ *  const Real *b2, const Real *b3, Real **eigenvalues,
+ *  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+ *  \brief ADIABATIC MHD, over cells il..iu of a pencil.  Note p is the
+ *   pressure; rho_a2 = Gamma*p is computed here.
+ */
+
+#if !defined(BAROTROPIC) && defined(MHD)
+void esys_prim_adb_mhd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, const Real *p, const Real *b1,
+  const Real *b2, const Real *b3, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix)
+{
+  Real **ev = eigenvalues, ***rem = right_eigenmatrix;
+  Real ***lem = left_eigenmatrix;
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+    Real di,cfsq,cf,cssq,cs,bt,bet2,bet3,alpha_f,alpha_s;
+    Real sqrtd,s,a,qf,qs,af,as,vax,na,af_prime,as_prime;
+    Real tsum,tdif,cf2_cs2,ct2;
+    Real btsq,vaxsq,asq;
+    di = 1.0/d[i];
+    btsq  = b2[i]*b2[i] + b3[i]*b3[i];
+    vaxsq = b1[i]*b1[i]*di;
+    asq   = (Gamma*p[i])*di;
+
+    ct2 = btsq*di;
+    tsum = vaxsq + ct2 + asq;
+    tdif = vaxsq + ct2 - asq;
+    cf2_cs2 = sqrt((double)(tdif*tdif + 4.0*asq*ct2));
+
+    cfsq = 0.5*(tsum + cf2_cs2);
+    cf = sqrt((double)cfsq);
+
+    cssq = asq*vaxsq/cfsq;
+    cs = sqrt((double)cssq);
+
+    bt  = sqrt(btsq);
+    bet2 = (bt == 0.0) ? 1.0 : b2[i]/bt;
+    bet3 = (bt == 0.0) ? 0.0 : b3[i]/bt;
+
+/* Cases are tested in reverse order, so the first true case is applied last */
+    alpha_f = sqrt((asq - cssq)/cf2_cs2);
+    alpha_s = sqrt((cfsq - asq)/cf2_cs2);
+    if ( (cfsq - asq) <= 0.0) {
+      alpha_f = 1.0;
+      alpha_s = 0.0;
+    }
+    if ( (asq - cssq) <= 0.0) {
+      alpha_f = 0.0;
+      alpha_s = 1.0;
+    }
+    if (cf2_cs2 == 0.0) {
+      alpha_f = 1.0;
+      alpha_s = 0.0;
+    }
+
+    sqrtd = sqrt(d[i]);
+    s = SIGN(b1[i]);
+    a = sqrt(asq);
+    qf = cf*alpha_f*s;
+    qs = cs*alpha_s*s;
+    af = a*alpha_f*sqrtd;
+    as = a*alpha_s*sqrtd;
+
+    vax = sqrt(vaxsq);
+    ev[0][i] = v1[i] - cf;
+    ev[1][i] = v1[i] - vax;
+    ev[2][i] = v1[i] - cs;
+    ev[3][i] = v1[i];
+    ev[4][i] = v1[i] + cs;
+    ev[5][i] = v1[i] + vax;
+    ev[6][i] = v1[i] + cf;
+
+    rem[0][0][i] = d[i]*alpha_f;
+    rem[0][2][i] = d[i]*alpha_s;
+    rem[0][3][i] = 1.0;
+    rem[0][4][i] = rem[0][2][i];
+    rem[0][6][i] = rem[0][0][i];
+
+    rem[1][0][i] = -cf*alpha_f;
+    rem[1][2][i] = -cs*alpha_s;
+    rem[1][4][i] = -rem[1][2][i];
+    rem[1][6][i] = -rem[1][0][i];
+
+    rem[2][0][i] = qs*bet2;
+    rem[2][1][i] = -bet3;
+    rem[2][2][i] = -qf*bet2;
+    rem[2][4][i] = -rem[2][2][i];
+    rem[2][5][i] = bet3;
+    rem[2][6][i] = -rem[2][0][i];
+
+    rem[3][0][i] = qs*bet3;
+    rem[3][1][i] = bet2;
+    rem[3][2][i] = -qf*bet3;
+    rem[3][4][i] = -rem[3][2][i];
+    rem[3][5][i] = -bet2;
+    rem[3][6][i] = -rem[3][0][i];
+
+    rem[4][0][i] = d[i]*asq*alpha_f;
+    rem[4][2][i] = d[i]*asq*alpha_s;
+    rem[4][4][i] = rem[4][2][i];
+    rem[4][6][i] = rem[4][0][i];
+
+    rem[5][0][i] = as*bet2;
+    rem[5][1][i] = -bet3*s*sqrtd;
+    rem[5][2][i] = -af*bet2;
+    rem[5][4][i] = rem[5][2][i];
+    rem[5][5][i] = rem[5][1][i];
+    rem[5][6][i] = rem[5][0][i];
+
+    rem[6][0][i] = as*bet3;
+    rem[6][1][i] = bet2*s*sqrtd;
+    rem[6][2][i] = -af*bet3;
+    rem[6][4][i] = rem[6][2][i];
+    rem[6][5][i] = rem[6][1][i];
+    rem[6][6][i] = rem[6][0][i];
+
+    na = 0.5/asq;
+    qf = na*qf;
+    qs = na*qs;
+    af_prime = na*af*di;
+    as_prime = na*as*di;
+
+    lem[0][1][i] = -na*cf*alpha_f;
+    lem[0][2][i] = qs*bet2;
+    lem[0][3][i] = qs*bet3;
+    lem[0][4][i] = na*alpha_f*di;
+    lem[0][5][i] = as_prime*bet2;
+    lem[0][6][i] = as_prime*bet3;
+
+    lem[1][2][i] = -0.5*bet3;
+    lem[1][3][i] = 0.5*bet2;
+    lem[1][5][i] = -0.5*bet3*s/sqrtd;
+    lem[1][6][i] = 0.5*bet2*s/sqrtd;
+
+    lem[2][1][i] = -na*cs*alpha_s;
+    lem[2][2][i] = -qf*bet2;
+    lem[2][3][i] = -qf*bet3;
+    lem[2][4][i] = na*alpha_s*di;
+    lem[2][5][i] = -af_prime*bet2;
+    lem[2][6][i] = -af_prime*bet3;
+
+    lem[3][0][i] = 1.0;
+    lem[3][4][i] = -1.0/asq;
+
+    lem[4][1][i] = -lem[2][1][i];
+    lem[4][2][i] = -lem[2][2][i];
+    lem[4][3][i] = -lem[2][3][i];
+    lem[4][4][i] = lem[2][4][i];
+    lem[4][5][i] = lem[2][5][i];
+    lem[4][6][i] = lem[2][6][i];
+
+    lem[5][2][i] = -lem[1][2][i];
+    lem[5][3][i] = -lem[1][3][i];
+    lem[5][5][i] = lem[1][5][i];
+    lem[5][6][i] = lem[1][6][i];
+
+    lem[6][1][i] = -lem[0][1][i];
+    lem[6][2][i] = -lem[0][2][i];
+    lem[6][3][i] = -lem[0][3][i];
+    lem[6][4][i] = lem[0][4][i];
+    lem[6][5][i] = lem[0][5][i];
+    lem[6][6][i] = lem[0][6][i];
+  }
+}
+#endif
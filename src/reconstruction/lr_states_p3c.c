@@ -53,6 +53,9 @@
 #define RLIM (0.1)
 
 static Real **pW=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(pW)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states(const GridS *pG, const Prim1DS W[], const Real Bxc[],
@@ -146,7 +149,7 @@ void lr_states(const GridS *pG __attribute((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd,n4v=4;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,n4v=4,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -170,7 +173,11 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+#pragma omp parallel reduction(+:nerr)
+  {
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) nerr++;
+  }
+  if (nerr > 0) goto on_error;
 
   return;
   on_error:
@@ -184,7 +191,10 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
+#pragma omp parallel
+  {
+    if (pW != NULL) free(pW);
+  }
   return;
 }
 
@@ -45,7 +45,312 @@
 #endif /* VL_INTEGRATOR */
 
 
+#ifdef LR_STATES_PENCIL
+/* Primitive variables, eigensystems and L/R states along the pencil, stored as
+ * a 1D array over the pencil for each variable so that the loop over cells
+ * vectorizes */
+static Prim1DArrS WPen, WlPen, WrPen;
+static Real **ev=NULL, ***rem=NULL, ***lem=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(WPen,WlPen,WrPen,ev,rem,lem)
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void lr_states(const GridS *pG, const Prim1DS W[], const Real Bxc[], 
+ *               const Real dt, const Real dx, const int il, const int iu, 
+ *               Prim1DS Wl[], Prim1DS Wr[], const int dir)
+ *  \brief Computes L/R states
+ *
+ * Same as the version below, but the eigensystems of all cells in the pencil
+ * are first computed by esys_prim_*_pencil(), and Steps 2-9 are then applied
+ * to all cells at once in a single loop over cells which vectorizes, with
+ * branches replaced by selects.  The results are identical (to round-off, if
+ * the compiler fuses multiply-adds differently in the two versions).  The
+ * pencils and eigensystems are each one contiguous block of memory, with row
+ * strides ns and ne, so that all loads and stores in the loop are affine in i.
+ */
+
+void lr_states(const GridS *pG __attribute__((unused)),
+               const Prim1DS W[], const Real Bxc[], 
+               const Real dt, const Real dx, const int il, const int iu, 
+               Prim1DS Wl[], Prim1DS Wr[],
+               const int dir __attribute__((unused)))
+{
+  int i;
+  const Real dtodx = dt/dx;
+  const int ns = (int)(WPen.Vx - WPen.d), ne = (int)(ev[1] - ev[0]);
+  const Real *pW = WPen.d, *E = ev[0], *L = lem[0][0], *R = rem[0][0];
+  Real *pWl = WlPen.d, *pWr = WrPen.d;
+
+  Prim1D_to_pencil(il-2,iu+2,W,&WPen);
+
+/*--- Step 1. ------------------------------------------------------------------
+ * Compute eigensystem in primitive variables.  */
+
+#ifdef HYDRO
+#ifdef ISOTHERMAL
+  esys_prim_iso_hyd_pencil(il-1,iu+1,WPen.d,WPen.Vx,       ev,rem,lem);
+#else
+  esys_prim_adb_hyd_pencil(il-1,iu+1,WPen.d,WPen.Vx,WPen.P,ev,rem,lem);
+#endif /* ISOTHERMAL */
+#endif /* HYDRO */
+
+#ifdef MHD
+#ifdef ISOTHERMAL
+  esys_prim_iso_mhd_pencil(il-1,iu+1,
+    WPen.d,WPen.Vx,       Bxc,WPen.By,WPen.Bz,ev,rem,lem);
+#else
+  esys_prim_adb_mhd_pencil(il-1,iu+1,
+    WPen.d,WPen.Vx,WPen.P,Bxc,WPen.By,WPen.Bz,ev,rem,lem);
+#endif /* ISOTHERMAL */
+#endif /* MHD */
+
+/*========================== START BIG LOOP OVER i =======================*/
+#pragma omp simd
+  for (i=il-1; i<=iu+1; i++) {
+    int n,m;
+    Real lim_slope1,lim_slope2,qa,qx,qx1,qx2,C,w,dw,wm,wp;
+    Real dWc[NWAVE+NSCALARS],dWl[NWAVE+NSCALARS];
+    Real dWr[NWAVE+NSCALARS],dWg[NWAVE+NSCALARS];
+    Real dac[NWAVE+NSCALARS],dal[NWAVE+NSCALARS];
+    Real dar[NWAVE+NSCALARS],dag[NWAVE+NSCALARS],da[NWAVE+NSCALARS];
+    Real Wlv[NWAVE+NSCALARS],Wrv[NWAVE+NSCALARS];
+    Real dW[NWAVE+NSCALARS],dWm[NWAVE+NSCALARS];
+
+/*--- Step 2. ------------------------------------------------------------------
+ * Compute centered, L/R, and van Leer differences of primitive variables */
+
+    UNROLL_NVAR
+    for (n=0; n<(NWAVE+NSCALARS); n++) {
+      dWc[n] = pW[n*ns+i+1] - pW[n*ns+i-1];
+      dWl[n] = pW[n*ns+i]   - pW[n*ns+i-1];
+      dWr[n] = pW[n*ns+i+1] - pW[n*ns+i];
+      dWg[n] = (dWl[n]*dWr[n] > 0.0) ?
+        2.0*dWl[n]*dWr[n]/(dWl[n]+dWr[n]) : 0.0;
+    }
+
+/*--- Step 3. ------------------------------------------------------------------
+ * Project differences in primitive variables along characteristics */
+
+    UNROLL_NVAR
+    for (n=0; n<NWAVE; n++) {
+      dac[n] = L[n*NWAVE*ne+i]*dWc[0];
+      dal[n] = L[n*NWAVE*ne+i]*dWl[0];
+      dar[n] = L[n*NWAVE*ne+i]*dWr[0];
+      dag[n] = L[n*NWAVE*ne+i]*dWg[0];
+      UNROLL_NVAR
+      for (m=1; m<NWAVE; m++) {
+        dac[n] += L[(n*NWAVE+m)*ne+i]*dWc[m];
+        dal[n] += L[(n*NWAVE+m)*ne+i]*dWl[m];
+        dar[n] += L[(n*NWAVE+m)*ne+i]*dWr[m];
+        dag[n] += L[(n*NWAVE+m)*ne+i]*dWg[m];
+      }
+    }
+
+/* Advected variables are treated differently; for them the right and left
+ * eigenmatrices are simply the identitiy matrix.
+ */
+#if (NSCALARS > 0)
+    UNROLL_NVAR
+    for (n=NWAVE; n<(NWAVE+NSCALARS); n++) {
+      dac[n] = dWc[n];
+      dal[n] = dWl[n];
+      dar[n] = dWr[n];
+      dag[n] = dWg[n];
+    }
+#endif
+
+/*--- Step 4. ------------------------------------------------------------------
+ * Apply monotonicity constraints to characteristic projections */
+
+    UNROLL_NVAR
+    for (n=0; n<(NWAVE+NSCALARS); n++) {
+      lim_slope1 = MIN(    fabs(dal[n]),fabs(dar[n]));
+      lim_slope2 = MIN(0.5*fabs(dac[n]),fabs(dag[n]));
+      da[n] = (dal[n]*dar[n] > 0.0) ?
+        SIGN(dac[n])*MIN(2.0*lim_slope1,lim_slope2) : 0.0;
+    }
+
+/*--- Step 5. ------------------------------------------------------------------
+ * Project monotonic slopes in characteristic back to primitive variables  */
+
+    UNROLL_NVAR
+    for (n=0; n<NWAVE; n++) {
+      dWm[n] = da[0]*R[n*NWAVE*ne+i];
+      UNROLL_NVAR
+      for (m=1; m<NWAVE; m++) {
+        dWm[n] += da[m]*R[(n*NWAVE+m)*ne+i];
+      }
+    }
+
+#if (NSCALARS > 0)
+    UNROLL_NVAR
+    for (n=NWAVE; n<(NWAVE+NSCALARS); n++) {
+      dWm[n] = da[n];
+    }
+#endif
+
+/*--- Step 6. ------------------------------------------------------------------
+ * Limit velocity difference to sound speed (deleted).  See r995 and earlier
+ * for this step */
+
+/*--- Step 7. ------------------------------------------------------------------
+ * Compute L/R values, ensure they lie between neighboring cell-centered vals
+ * (in Cartesian coordinates beta = 1) */
+
+    UNROLL_NVAR
+    for (n=0; n<(NWAVE+NSCALARS); n++) {
+      w  = pW[n*ns+i];
+      wm = pW[n*ns+i-1];
+      wp = pW[n*ns+i+1];
+      Wlv[n] = w - 0.5*dWm[n];
+      Wrv[n] = w + 0.5*dWm[n];
+
+      C = Wrv[n] + Wlv[n];
+      Wlv[n] = MAX(MIN(w,wm),Wlv[n]);
+      Wlv[n] = MIN(MAX(w,wm),Wlv[n]);
+      Wrv[n] = C - Wlv[n];
+
+      Wrv[n] = MAX(MIN(w,wp),Wrv[n]);
+      Wrv[n] = MIN(MAX(w,wp),Wrv[n]);
+      Wlv[n] = C - Wrv[n];
+
+      dW[n] = Wrv[n] - Wlv[n];
+    }
+
+/*--- Step 8. ------------------------------------------------------------------
+ * Integrate linear interpolation function over domain of dependence defined by
+ * max(min) eigenvalue
+ */
+
+#ifdef CTU_INTEGRATOR
+    qx1 =  0.5*MAX(E[(NWAVE-1)*ne+i],0.0)*dtodx;
+    qx2 = -0.5*MIN(E[i],0.0)*dtodx;
+    UNROLL_NVAR
+    for (n=0; n<(NWAVE+NSCALARS); n++) {
+      Wrv[n] = Wrv[n] - qx1*dW[n];
+      Wlv[n] = Wlv[n] + qx2*dW[n];
+    }
+
+/*--- Step 9. ------------------------------------------------------------------
+ * Then subtract amount of each wave n that does not reach the interface
+ * during timestep (CW eqn 3.5ff).  For HLL fluxes, must subtract waves that
+ * move in both directions.  The amount qa is computed for every wave, and
+ * only added where the wave moves in that direction.
+ */
+
+    UNROLL_NVAR
+    for (n=0; n<NWAVE; n++) {
+      qa  = 0.0;
+      qx1 = 0.5*dtodx*E[(NWAVE-1)*ne+i];
+      qx2 = 0.5*dtodx*E[n*ne+i];
+      qx = qx1 - qx2;
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        qa += L[(n*NWAVE+m)*ne+i]*qx*dW[m];
+      }
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        w  = Wrv[m];
+        dw = qa*R[(m*NWAVE+n)*ne+i];
+        Wrv[m] = (E[n*ne+i] >= 0.0) ? w + dw : w;
+      }
+
+/* For HLL fluxes, subtract wave moving away from interface as well. */
+#if defined(HLLE_FLUX) || defined(HLLC_FLUX) || defined(HLLD_FLUX) || defined(FORCE_FLUX)
+      qa  = 0.0;
+      qx1 = 0.5*dtodx*E[i];
+      qx2 = 0.5*dtodx*E[n*ne+i];
+      qx = qx1 - qx2;
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        qa += L[(n*NWAVE+m)*ne+i]*qx*dW[m];
+      }
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        w  = Wlv[m];
+        dw = qa*R[(m*NWAVE+n)*ne+i];
+        Wlv[m] = (E[n*ne+i] >= 0.0) ? w + dw : w;
+      }
+#endif /* HLL_FLUX */
+    }
+
+    UNROLL_NVAR
+    for (n=0; n<NWAVE; n++) {
+      qa  = 0.0;
+      qx1 = 0.5*dtodx*E[i];
+      qx2 = 0.5*dtodx*E[n*ne+i];
+      qx = qx1 - qx2;
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        qa += L[(n*NWAVE+m)*ne+i]*qx*dW[m];
+      }
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        w  = Wlv[m];
+        dw = qa*R[(m*NWAVE+n)*ne+i];
+        Wlv[m] = (E[n*ne+i] <= 0.0) ? w + dw : w;
+      }
+
+/* For HLL fluxes, subtract wave moving away from interface as well. */
+#if defined(HLLE_FLUX) || defined(HLLC_FLUX) || defined(HLLD_FLUX) || defined(FORCE_FLUX)
+      qa  = 0.0;
+      qx1 = 0.5*dtodx*E[(NWAVE-1)*ne+i];
+      qx2 = 0.5*dtodx*E[n*ne+i];
+      qx = qx1 - qx2;
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        qa += L[(n*NWAVE+m)*ne+i]*qx*dW[m];
+      }
+      UNROLL_NVAR
+      for (m=0; m<NWAVE; m++) {
+        w  = Wrv[m];
+        dw = qa*R[(m*NWAVE+n)*ne+i];
+        Wrv[m] = (E[n*ne+i] <= 0.0) ? w + dw : w;
+      }
+#endif /* HLL_FLUX */
+    }
+
+/* Wave subtraction for passive scalars */
+#if (NSCALARS > 0)
+    UNROLL_NVAR
+    for (n=NWAVE; n<(NWAVE+NSCALARS); n++) {
+      qx1 = 0.5*dtodx*E[(NWAVE-1)*ne+i];
+      qx2 = 0.5*dtodx*WPen.Vx[i];
+      qx = qx1 - qx2;
+      w = Wrv[n];
+      Wrv[n] = (WPen.Vx[i] > 0.) ? w + qx*dW[n] : w;
+
+      qx1 = -0.5*dtodx*E[i];
+      qx2 = -0.5*dtodx*WPen.Vx[i];
+      qx = -qx1 + qx2;
+      w = Wlv[n];
+      Wlv[n] = (WPen.Vx[i] < 0.) ? w + qx*dW[n] : w;
+    }
+#endif
+#endif /* CTU_INTEGRATOR */
+
+/* Store the L/R states at interfaces i+1 and i */
+    UNROLL_NVAR
+    for (n=0; n<(NWAVE+NSCALARS); n++) {
+      pWl[n*ns+i+1] = Wrv[n];
+      pWr[n*ns+i  ] = Wlv[n];
+    }
+
+  } /*===================== END BIG LOOP OVER i ===========================*/
+
+  pencil_to_Prim1D(il,iu+2,&WlPen,Wl);
+  pencil_to_Prim1D(il-1,iu+1,&WrPen,Wr);
+
+  return;
+}
+
+#else /* LR_STATES_PENCIL */
+
 static Real **pW=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(pW)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states(const GridS *pG, const Prim1DS W[], const Real Bxc[], 
@@ -400,7 +705,7 @@ void lr_states(const GridS *pG __attribute__((unused)),
 
   return;
 }
-
+#endif /* LR_STATES_PENCIL */
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states_init(MeshS *pM)
@@ -408,7 +713,7 @@ void lr_states(const GridS *pG __attribute__((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -432,7 +737,22 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+#pragma omp parallel reduction(+:nerr)
+  {
+#ifdef LR_STATES_PENCIL
+    if (calloc_pencil(&WPen, sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&WlPen,sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL ||
+        calloc_pencil(&WrPen,sizeof(Prim1DArrS)/sizeof(Real*),nmax) == NULL)
+      nerr++;
+    if ((ev  = (Real**)calloc_2d_array(NWAVE,nmax,sizeof(Real))) == NULL ||
+        (rem = (Real***)calloc_3d_array(NWAVE,NWAVE,nmax,sizeof(Real)))==NULL ||
+        (lem = (Real***)calloc_3d_array(NWAVE,NWAVE,nmax,sizeof(Real)))==NULL)
+      nerr++;
+#else
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) nerr++;
+#endif /* LR_STATES_PENCIL */
+  }
+  if (nerr > 0) goto on_error;
 
   return;
   on_error:
@@ -446,7 +766,21 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
+#pragma omp parallel
+  {
+#ifdef LR_STATES_PENCIL
+    if (WPen.d  != NULL) free_pencil(&WPen);
+    if (WlPen.d != NULL) free_pencil(&WlPen);
+    if (WrPen.d != NULL) free_pencil(&WrPen);
+    WPen.d = WlPen.d = WrPen.d = NULL;
+    if (ev  != NULL) free_2d_array(ev);
+    if (rem != NULL) free_3d_array(rem);
+    if (lem != NULL) free_3d_array(lem);
+    ev = NULL;  rem = lem = NULL;
+#else
+    if (pW != NULL) free(pW);
+#endif /* LR_STATES_PENCIL */
+  }
   return;
 }
 
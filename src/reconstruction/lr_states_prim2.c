@@ -43,8 +43,14 @@
 #ifdef SECOND_ORDER_PRIM
 
 static Real **pW=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(pW)
+#endif
 #ifdef SPECIAL_RELATIVITY
 static Real **vel=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(vel)
+#endif
 #endif
 
 /*----------------------------------------------------------------------------*/
@@ -316,7 +322,7 @@ void lr_states(const GridS *pG __attribute((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd,n4v=4;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,n4v=4,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -340,11 +346,15 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+#pragma omp parallel reduction(+:nerr)
+  {
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) nerr++;
 #ifdef SPECIAL_RELATIVITY
-  if ((vel = (Real**)calloc_2d_array(nmax, n4v, sizeof(Real))) == NULL)
-    goto on_error;
+    if ((vel = (Real**)calloc_2d_array(nmax, n4v, sizeof(Real))) == NULL)
+      nerr++;
 #endif
+  }
+  if (nerr > 0) goto on_error;
 
   return;
   on_error:
@@ -358,10 +368,13 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
+#pragma omp parallel
+  {
+    if (pW != NULL) free(pW);
 #ifdef SPECIAL_RELATIVITY
-  if (vel != NULL) free_2d_array(vel);
+    if (vel != NULL) free_2d_array(vel);
 #endif
+  }
   return;
 }
 
@@ -51,6 +51,9 @@
 #ifdef THIRD_ORDER_PRIM
 
 static Real **pW=NULL, **Whalf=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(pW,Whalf)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states(const GridS *pG, const Prim1DS W[], const Real Bxc[],
@@ -350,7 +353,7 @@ void lr_states(const GridS *pG __attribute__((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -374,10 +377,14 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+#pragma omp parallel reduction(+:nerr)
+  {
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) nerr++;
 
-  if ((Whalf = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
-    goto on_error;
+    if ((Whalf = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
+      nerr++;
+  }
+  if (nerr > 0) goto on_error;
 
   return;
   on_error:
@@ -391,8 +398,11 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
-  if (Whalf != NULL) free_2d_array(Whalf);
+#pragma omp parallel
+  {
+    if (pW != NULL) free(pW);
+    if (Whalf != NULL) free_2d_array(Whalf);
+  }
   return;
 }
 
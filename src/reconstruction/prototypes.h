@@ -37,6 +37,49 @@ void esys_prim_adb_mhd(const Real d, const Real v1, const Real rho_a2,
   Real right_eigenmatrix[][7], Real left_eigenmatrix[][7]);
 #endif
 
+#if defined(BAROTROPIC) && defined(HYDRO)
+void esys_prim_iso_hyd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix);
+#endif
+
+#if !defined(BAROTROPIC) && defined(HYDRO)
+void esys_prim_adb_hyd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, const Real *p, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix);
+#endif
+
+#if defined(BAROTROPIC) && defined(MHD)
+void esys_prim_iso_mhd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, const Real *b1, const Real *b2,
+  const Real *b3, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix);
+#endif
+
+#if !defined(BAROTROPIC) && defined(MHD)
+void esys_prim_adb_mhd_pencil(const int il, const int iu,
+  const Real *d, const Real *v1, const Real *p, const Real *b1,
+  const Real *b2, const Real *b3, Real **eigenvalues,
+  Real ***right_eigenmatrix, Real ***left_eigenmatrix);
+#endif
+
+/* lr_states_plm.c and lr_states_ppm.c reconstruct all cells of a pencil at
+ * once, using the *_pencil() eigensystems above, except in cylindrical
+ * coordinates.  This only pays off if the compiler targets vectors of at
+ * least four doubles (e.g. configure --enable-native on an AVX machine); with
+ * SSE2 the cell-by-cell versions are faster. */
+#if !defined(CYLINDRICAL) && defined(__AVX__)
+#define LR_STATES_PENCIL
+#endif
+
+/* Loops over variables inside a vectorized loop over cells must be fully
+ * unrolled, so that the local arrays indexed by them become registers */
+#if defined(__GNUC__) && (__GNUC__ >= 8)
+#define UNROLL_NVAR _Pragma("GCC unroll 16")
+#else
+#define UNROLL_NVAR
+#endif
+
 /*  All of the lr_states_*.c files in this directory contain the same function
  *  names below */
 void lr_states_destruct(void);
@@ -126,6 +126,9 @@ void restart_grids(char *res_file, MeshS *pM)
 
       pG->time = pM->time;
       pG->dt   = pM->dt;
+#ifdef STATIC_MESH_REFINEMENT
+      if (pM->subcycle) pG->dt = pM->dt/(Real)(1<<nl);
+#endif
 
 /* Read the density */
 
@@ -136,7 +139,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].d),sizeof(Real),1,fp);
+            fread(&(UVAR(pG,k,j,i,d)),sizeof(Real),1,fp);
           }
         }
       }
@@ -150,7 +153,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].M1),sizeof(Real),1,fp);
+            fread(&(UVAR(pG,k,j,i,M1)),sizeof(Real),1,fp);
           }
         }
       }
@@ -164,7 +167,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].M2),sizeof(Real),1,fp);
+            fread(&(UVAR(pG,k,j,i,M2)),sizeof(Real),1,fp);
           }
         }
       }
@@ -178,7 +181,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].M3),sizeof(Real),1,fp);
+            fread(&(UVAR(pG,k,j,i,M3)),sizeof(Real),1,fp);
           }
         }
       }
@@ -193,7 +196,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].E),sizeof(Real),1,fp);
+            fread(&(UVAR(pG,k,j,i,E)),sizeof(Real),1,fp);
           }
         }
       }
@@ -259,11 +262,11 @@ void restart_grids(char *res_file, MeshS *pM)
         for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
 #if defined(CARTESIAN)
-          pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] +pG->B1i[k][j][i+1]);
+          UVAR(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] +pG->B1i[k][j][i+1]);
 #elif defined(CYLINDRICAL)
-          pG->U[k][j][i].B1c = 0.5*(pG->ri[i]*pG->B1i[k][j][i] + pG->ri[i+1]*pG->B1i[k][j][i+1])/pG->r[i];
+          UVAR(pG,k,j,i,B1c) = 0.5*(pG->ri[i]*pG->B1i[k][j][i] + pG->ri[i+1]*pG->B1i[k][j][i+1])/pG->r[i];
 #elif defined(SPHERICAL)
-          pG->U[k][j][i].B1c = ((pG->px1i[i+1]-pG->px1v[i])*pG->B1i[k][j][i] + (pG->px1v[i]-pG->px1i[i])*pG->B1i[k][j][i+1])/pG->dx1;
+          UVAR(pG,k,j,i,B1c) = ((pG->px1i[i+1]-pG->px1v[i])*pG->B1i[k][j][i] + (pG->px1v[i]-pG->px1i[i])*pG->B1i[k][j][i+1])/pG->dx1;
 #endif
         }}}
       }
@@ -271,7 +274,7 @@ void restart_grids(char *res_file, MeshS *pM)
         for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].B1c = pG->B1i[k][j][i];
+        UVAR(pG,k,j,i,B1c) = pG->B1i[k][j][i];
         }}}
       }
       if(jb==1) {
@@ -279,9 +282,9 @@ void restart_grids(char *res_file, MeshS *pM)
         for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
 #ifdef SPHERICAL
-          pG->U[k][j][i].B2c = ((pG->px2i[j+1]-pG->px2v[j])*pG->B2i[k][j][i] + (pG->px2v[j]-pG->px2i[j])*pG->B2i[k][j+1][i])/pG->dx2;
+          UVAR(pG,k,j,i,B2c) = ((pG->px2i[j+1]-pG->px2v[j])*pG->B2i[k][j][i] + (pG->px2v[j]-pG->px2i[j])*pG->B2i[k][j+1][i])/pG->dx2;
 #else
-          pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] +pG->B2i[k][j+1][i]);
+          UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] +pG->B2i[k][j+1][i]);
 #endif
         }}}
       }
@@ -289,21 +292,21 @@ void restart_grids(char *res_file, MeshS *pM)
         for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].B2c = pG->B2i[k][j][i];
+          UVAR(pG,k,j,i,B2c) = pG->B2i[k][j][i];
         }}}
       }
       if(kb==1) {
         for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] +pG->B3i[k+1][j][i]);
+          UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] +pG->B3i[k+1][j][i]);
         }}}
       }
       else {
         for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].B3c = pG->B3i[k][j][i];
+          UVAR(pG,k,j,i,B3c) = pG->B3i[k][j][i];
         }}}
       }
 #endif
@@ -321,7 +324,7 @@ void restart_grids(char *res_file, MeshS *pM)
         for (k=ks; k<=ke; k++) {
           for (j=js; j<=je; j++) {
             for (i=is; i<=ie; i++) {
-              fread(&(pG->U[k][j][i].s[n]),sizeof(Real),1,fp);
+              fread(&(UVAR(pG,k,j,i,s[n])),sizeof(Real),1,fp);
             }
           }
         }
@@ -536,10 +539,14 @@ void dump_restart(MeshS *pM, OutputS *pout)
   }
   free(fname);
 
-/* Add the current time & nstep to the parameter file */
+/* Add the current time & nstep to the parameter file, and with MPI the cost
+ * measured on each Grid for load balancing */
 
   par_setd("time","time","%e",pM->time,"Current Simulation Time");
   par_seti("time","nstep","%d",pM->nstep,"Current Simulation Time Step");
+#ifdef MPI_PARALLEL
+  record_grid_cost(pM);
+#endif
 
 /* Write the current state of the parameter file */
 
@@ -590,7 +597,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].d;
+            buf[nbuf++] = UVAR(pG,k,j,i,d);
             if ((nbuf+1) > bufsize) {
               fwrite(buf,sizeof(Real),nbuf,fp);
               nbuf = 0;
@@ -609,7 +616,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].M1;
+            buf[nbuf++] = UVAR(pG,k,j,i,M1);
             if ((nbuf+1) > bufsize) {
               fwrite(buf,sizeof(Real),nbuf,fp);
               nbuf = 0;
@@ -628,7 +635,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].M2;
+            buf[nbuf++] = UVAR(pG,k,j,i,M2);
             if ((nbuf+1) > bufsize) {
               fwrite(buf,sizeof(Real),nbuf,fp);
               nbuf = 0;
@@ -647,7 +654,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].M3;
+            buf[nbuf++] = UVAR(pG,k,j,i,M3);
             if ((nbuf+1) > bufsize) {
               fwrite(buf,sizeof(Real),nbuf,fp);
               nbuf = 0;
@@ -667,7 +674,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].E;
+            buf[nbuf++] = UVAR(pG,k,j,i,E);
             if ((nbuf+1) > bufsize) {
               fwrite(buf,sizeof(Real),nbuf,fp);
               nbuf = 0;
@@ -754,7 +761,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
         for (k=ks; k<=ke; k++) {
           for (j=js; j<=je; j++) {
             for (i=is; i<=ie; i++) {
-              buf[nbuf++] = pG->U[k][j][i].s[n];
+              buf[nbuf++] = UVAR(pG,k,j,i,s[n]);
               if ((nbuf+1) > bufsize) {
                 fwrite(buf,sizeof(Real),nbuf,fp);
                 nbuf = 0;
@@ -17,7 +17,8 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - fluxes() - all Riemann solvers in Athena must have this function name and
- *              use the same argument list as defined in rsolvers/prototypes.h*/
+ *              use the same argument list as defined in rsolvers/prototypes.h
+ * - fluxes_pencil() - fluxes() for all interfaces along a pencil             */
 /*============================================================================*/
 
 #include <math.h>
@@ -247,5 +248,157 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
 
   return;
 }
+
+#ifdef FLUXES_PENCIL
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *                 const Cons1DArrS *pUl, const Cons1DArrS *pUr,
+ *                 const Prim1DArrS *pWl, const Prim1DArrS *pWr,
+ *                 const Real *Bxi, Cons1DArrS *pF)
+ *  \brief Computes HLLC fluxes at interfaces il..iu of a pencil.
+ *
+ *   Same algorithm and arithmetic as fluxes() above, written as a single loop
+ *   with the branches replaced by selects so that the interfaces can be
+ *   computed in SIMD lanes.  A negative contact pressure is reported once per
+ *   pencil (with the minimum value) rather than once per interface.
+ *   Input Arguments:
+ *   - pUl,pUr = L/R-states of CONSERVED variables at the interfaces
+ *   - pWl,pWr = L/R-states of PRIMITIVE variables at the interfaces
+ *   Output Arguments:
+ *   - pF = fluxes of CONSERVED variables at the interfaces
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DArrS *pUl, const Cons1DArrS *pUr,
+                   const Prim1DArrS *pWl, const Prim1DArrS *pWr,
+                   const Real *Bxi, Cons1DArrS *pF)
+{
+  Real cpmin = 0.0;
+  int i;
+
+#pragma omp simd reduction(min:cpmin)
+  for (i=il; i<=iu; i++) {
+    Real sqrtdl,sqrtdr,isdlpdr,v1roe,evl,evr;
+    Real cfl,cfr,bp,bm,tmp;
+    Real al,ar; /* Min and Max wave speeds */
+    Real am,cp; /* Contact wave speed and pressure */
+    Real tl,tr,dl,dr,sl,sm,sr;
+    Real Fld,Frd,FlMx,FrMx,FlMy,FrMy,FlMz,FrMz;
+#ifndef ISOTHERMAL
+    Real v2roe,v3roe,hroe,vsq,asq,FlE,FrE;
+#endif
+#if (NSCALARS > 0)
+    int n;
+#endif
+
+/* Roe-averaged data and eigenvalues (Steps 2-3 of fluxes()) */
+
+    sqrtdl = sqrt((double)pWl->d[i]);
+    sqrtdr = sqrt((double)pWr->d[i]);
+    isdlpdr = 1.0/(sqrtdl + sqrtdr);
+
+    v1roe = (sqrtdl*pWl->Vx[i] + sqrtdr*pWr->Vx[i])*isdlpdr;
+#ifdef ISOTHERMAL
+    evl = v1roe - Iso_csound;
+    evr = v1roe + Iso_csound;
+#else
+    v2roe = (sqrtdl*pWl->Vy[i] + sqrtdr*pWr->Vy[i])*isdlpdr;
+    v3roe = (sqrtdl*pWl->Vz[i] + sqrtdr*pWr->Vz[i])*isdlpdr;
+    hroe = ((pUl->E[i] + pWl->P[i])/sqrtdl +
+            (pUr->E[i] + pWr->P[i])/sqrtdr)*isdlpdr;
+
+    vsq = v1roe*v1roe + v2roe*v2roe + v3roe*v3roe;
+    asq = Gamma_1*MAX((hroe-0.5*vsq), TINY_NUMBER);
+    tmp = sqrt(asq);
+    evl = v1roe - tmp;
+    evr = v1roe + tmp;
+#endif /* ISOTHERMAL */
+
+/* Max and min wave speeds (Step 4 of fluxes()) */
+
+#ifdef ISOTHERMAL
+    cfl = cfr = Iso_csound;
+#else
+    cfl = sqrt((double)(Gamma*pWl->P[i]/pWl->d[i]));
+    cfr = sqrt((double)(Gamma*pWr->P[i]/pWr->d[i]));
+#endif
+
+    ar = MAX(evr,(pWr->Vx[i] + cfr));
+    al = MIN(evl,(pWl->Vx[i] - cfl));
+
+    bp = ar > 0.0 ? ar : 0.0;
+    bm = al < 0.0 ? al : 0.0;
+
+/* Contact wave speed and pressure (Step 5 of fluxes()) */
+
+#ifdef ISOTHERMAL
+    tl = pWl->d[i]*Iso_csound2 + (pWl->Vx[i] - al)*pUl->Mx[i];
+    tr = pWr->d[i]*Iso_csound2 + (pWr->Vx[i] - ar)*pUr->Mx[i];
+#else
+    tl = pWl->P[i] + (pWl->Vx[i] - al)*pUl->Mx[i];
+    tr = pWr->P[i] + (pWr->Vx[i] - ar)*pUr->Mx[i];
+#endif
+
+    dl =   pUl->Mx[i] - pUl->d[i]*al;
+    dr = -(pUr->Mx[i] - pUr->d[i]*ar);
+
+    tmp = 1.0/(dl + dr);
+    am = (tl - tr)*tmp;
+    cp = (dl*tr + dr*tl)*tmp;
+    cpmin = MIN(cpmin,cp);
+    cp = cp > 0.0 ? cp : 0.0;
+
+/* L/R fluxes along the line bm, bp (Step 6 of fluxes()) */
+
+    Fld  = pUl->Mx[i] - bm*pUl->d[i];
+    Frd  = pUr->Mx[i] - bp*pUr->d[i];
+
+    FlMx = pUl->Mx[i]*(pWl->Vx[i] - bm);
+    FrMx = pUr->Mx[i]*(pWr->Vx[i] - bp);
+
+    FlMy = pUl->My[i]*(pWl->Vx[i] - bm);
+    FrMy = pUr->My[i]*(pWr->Vx[i] - bp);
+
+    FlMz = pUl->Mz[i]*(pWl->Vx[i] - bm);
+    FrMz = pUr->Mz[i]*(pWr->Vx[i] - bp);
+
+#ifdef ISOTHERMAL
+    FlMx += pWl->d[i]*Iso_csound2;
+    FrMx += pWr->d[i]*Iso_csound2;
+#else
+    FlMx += pWl->P[i];
+    FrMx += pWr->P[i];
+
+    FlE  = pUl->E[i]*(pWl->Vx[i] - bm) + pWl->P[i]*pWl->Vx[i];
+    FrE  = pUr->E[i]*(pWr->Vx[i] - bp) + pWr->P[i]*pWr->Vx[i];
+#endif /* ISOTHERMAL */
+
+/* Flux weights (Step 7 of fluxes()) */
+
+    sl = am >= 0.0 ?  am/(am - bm) : 0.0;
+    sr = am >= 0.0 ?  0.0          : -am/(bp - am);
+    sm = am >= 0.0 ? -bm/(am - bm) :  bp/(bp - am);
+
+/* HLLC flux at interface (Step 8 of fluxes()) */
+
+    pF->d[i]  = sl*Fld  + sr*Frd;
+    pF->Mx[i] = sl*FlMx + sr*FrMx + sm*cp;
+    pF->My[i] = sl*FlMy + sr*FrMy;
+    pF->Mz[i] = sl*FlMz + sr*FrMz;
+#ifndef ISOTHERMAL
+    pF->E[i]  = sl*FlE  + sr*FrE  + sm*cp*am;
+#endif
+
+#if (NSCALARS > 0)
+    for (n=0; n<NSCALARS; n++)
+      pF->s[n][i] = pF->d[i]*(pF->d[i] >= 0.0 ? pWl->r[n][i] : pWr->r[n][i]);
+#endif
+  }
+
+  if(cpmin < 0.0) ath_perr(1,"[hllc flux]: Contact Pressure = %g\n",cpmin);
+
+  return;
+}
+#endif /* FLUXES_PENCIL */
 #endif /* SPECIAL_RELATIVITY */
 #endif /* HLLC_FLUX */
@@ -26,7 +26,8 @@
  *
  * CONTAINS PUBLIC FUNCTIONS:
  * - fluxes() - all Riemann solvers in Athena must have this function name and
- *              use the same argument list as defined in rsolvers/prototypes.h*/
+ *              use the same argument list as defined in rsolvers/prototypes.h
+ * - fluxes_pencil() - fluxes() for all interfaces along a pencil             */
 /*============================================================================*/
 
 #include <math.h>
@@ -269,4 +270,236 @@ void HLLE_FUNCTION(const Cons1DS Ul, const Cons1DS Ur,
   return;
 }
 #endif /* HLLE_FLUX */
+
+#if defined(HLLE_FLUX) && defined(FLUXES_PENCIL)
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *                 const Cons1DArrS *pUl, const Cons1DArrS *pUr,
+ *                 const Prim1DArrS *pWl, const Prim1DArrS *pWr,
+ *                 const Real *Bxi, Cons1DArrS *pF)
+ *  \brief Computes HLLE fluxes at interfaces il..iu of a pencil.
+ *
+ *   Same algorithm and arithmetic as fluxes() above, so the results are
+ *   identical, but written as a single loop with no branches or function
+ *   calls so that the interfaces can be computed in SIMD lanes.  Only the
+ *   eigenvalues ev[0] and ev[NWAVE-1] of the Roe-averaged state are needed,
+ *   and they are computed inline as in esys_roe_*().
+ *   Input Arguments:
+ *  -  Bxi[i] = B in direction of 1D slice at interface i
+ *  -  pUl,pUr = L/R-states of CONSERVED variables at the interfaces
+ *  -  pWl,pWr = L/R-states of PRIMITIVE variables at the interfaces
+ *   Output Arguments:
+ *  -  pF = fluxes of CONSERVED variables at the interfaces
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DArrS *pUl, const Cons1DArrS *pUr,
+                   const Prim1DArrS *pWl, const Prim1DArrS *pWr,
+                   const Real *Bxi, Cons1DArrS *pF)
+{
+  int i;
+
+#pragma omp simd
+  for (i=il; i<=iu; i++) {
+    Real sqrtdl,sqrtdr,isdlpdr,droe,v1roe,v2roe,v3roe,pbl=0.0,pbr=0.0;
+    Real asq,vaxsq=0.0,qsq,cfsq,cfl,cfr,bp,bm,ct2=0.0,tmp;
+    Real evl,evr,al,ar;
+    Real dl,vxl,vyl,vzl,dr,vxr,vyr,vzr;
+    Real Fld,Frd,FlMx,FrMx,FlMy,FrMy,FlMz,FrMz;
+#ifndef ISOTHERMAL
+    Real hroe,vsq,Pl,Pr,El,Er,FlE,FrE;
+#endif
+#ifdef MHD
+    Real bx,Byl,Bzl,Byr,Bzr,FlBy,FrBy,FlBz,FrBz;
+    Real b2roe,b3roe,x,y,di,btsq,bt_starsq,twid_asq,tsum,tdif;
+#ifndef ISOTHERMAL
+    Real hp;
+#endif
+#endif
+#if (NSCALARS > 0)
+    int n;
+#endif
+
+    dl  = pWl->d[i];   dr  = pWr->d[i];
+    vxl = pWl->Vx[i];  vxr = pWr->Vx[i];
+    vyl = pWl->Vy[i];  vyr = pWr->Vy[i];
+    vzl = pWl->Vz[i];  vzr = pWr->Vz[i];
+#ifndef ISOTHERMAL
+    Pl  = pWl->P[i];   Pr  = pWr->P[i];
+    El  = pUl->E[i];   Er  = pUr->E[i];
+#endif
+#ifdef MHD
+    bx  = Bxi[i];
+    Byl = pWl->By[i];  Byr = pWr->By[i];
+    Bzl = pWl->Bz[i];  Bzr = pWr->Bz[i];
+#endif
+
+/* Roe-averaged data from left- and right-states (Step 2 of fluxes()) */
+
+    sqrtdl = sqrt((double)dl);
+    sqrtdr = sqrt((double)dr);
+    isdlpdr = 1.0/(sqrtdl + sqrtdr);
+
+    droe  = sqrtdl*sqrtdr;
+    v1roe = (sqrtdl*vxl + sqrtdr*vxr)*isdlpdr;
+    v2roe = (sqrtdl*vyl + sqrtdr*vyr)*isdlpdr;
+    v3roe = (sqrtdl*vzl + sqrtdr*vzr)*isdlpdr;
+
+#ifdef MHD
+    b2roe = (sqrtdr*Byl + sqrtdl*Byr)*isdlpdr;
+    b3roe = (sqrtdr*Bzl + sqrtdl*Bzr)*isdlpdr;
+    x = 0.5*(SQR(Byl - Byr) + SQR(Bzl - Bzr))/(SQR(sqrtdl + sqrtdr));
+    y = 0.5*(dl + dr)/droe;
+    pbl = 0.5*(SQR(bx) + SQR(Byl) + SQR(Bzl));
+    pbr = 0.5*(SQR(bx) + SQR(Byr) + SQR(Bzr));
+#endif
+
+#ifndef ISOTHERMAL
+    hroe  = ((El + Pl + pbl)/sqrtdl + (Er + Pr + pbr)/sqrtdr)*isdlpdr;
+#endif
+
+/* Smallest and largest Roe eigenvalues (Step 3 of fluxes()) */
+
+#ifdef HYDRO
+#ifdef ISOTHERMAL
+    evl = v1roe - Iso_csound;
+    evr = v1roe + Iso_csound;
+#else
+    vsq = v1roe*v1roe + v2roe*v2roe + v3roe*v3roe;
+    asq = Gamma_1*MAX((hroe-0.5*vsq), TINY_NUMBER);
+    tmp = sqrt(asq);
+    evl = v1roe - tmp;
+    evr = v1roe + tmp;
+#endif /* ISOTHERMAL */
+#endif /* HYDRO */
+
+#ifdef MHD
+    di = 1.0/droe;
+    btsq = b2roe*b2roe + b3roe*b3roe;
+    vaxsq = bx*bx*di;
+#ifdef ISOTHERMAL
+    bt_starsq = btsq*y;
+    twid_asq = Iso_csound2 + x;
+#else
+    vsq = v1roe*v1roe + v2roe*v2roe + v3roe*v3roe;
+    bt_starsq = (Gamma_1 - Gamma_2*y)*btsq;
+    hp = hroe - (vaxsq + btsq*di);
+    twid_asq = MAX((Gamma_1*(hp-0.5*vsq)-Gamma_2*x), TINY_NUMBER);
+#endif /* ISOTHERMAL */
+    ct2 = bt_starsq*di;
+    tsum = vaxsq + ct2 + twid_asq;
+    tdif = vaxsq + ct2 - twid_asq;
+    cfsq = 0.5*(tsum + sqrt((double)(tdif*tdif + 4.0*twid_asq*ct2)));
+    tmp = sqrt((double)cfsq);
+    evl = v1roe - tmp;
+    evr = v1roe + tmp;
+#endif /* MHD */
+
+/* Max and min wave speeds (Step 4 of fluxes()) */
+
+#ifdef ISOTHERMAL
+    asq = Iso_csound2;
+#else
+    asq = Gamma*Pl/dl;
+#endif
+#ifdef MHD
+    vaxsq = bx*bx/dl;
+    ct2 = (pUl->By[i]*pUl->By[i] + pUl->Bz[i]*pUl->Bz[i])/dl;
+#endif
+    qsq = vaxsq + ct2 + asq;
+    tmp = vaxsq + ct2 - asq;
+    cfsq = 0.5*(qsq + sqrt((double)(tmp*tmp + 4.0*asq*ct2)));
+    cfl = sqrt((double)cfsq);
+
+#ifdef ISOTHERMAL
+    asq = Iso_csound2;
+#else
+    asq = Gamma*Pr/dr;
+#endif
+#ifdef MHD
+    vaxsq = bx*bx/dr;
+    ct2 = (pUr->By[i]*pUr->By[i] + pUr->Bz[i]*pUr->Bz[i])/dr;
+#endif
+    qsq = vaxsq + ct2 + asq;
+    tmp = vaxsq + ct2 - asq;
+    cfsq = 0.5*(qsq + sqrt((double)(tmp*tmp + 4.0*asq*ct2)));
+    cfr = sqrt((double)cfsq);
+
+    ar = MAX(evr,(vxr + cfr));
+    al = MIN(evl,(vxl - cfl));
+
+    bp = MAX(ar, 0.0);
+    bm = MIN(al, 0.0);
+
+/* L/R fluxes along the lines bm/bp (Step 5 of fluxes()) */
+
+    Fld  = pUl->Mx[i] - bm*pUl->d[i];
+    Frd  = pUr->Mx[i] - bp*pUr->d[i];
+
+    FlMx = pUl->Mx[i]*(vxl - bm);
+    FrMx = pUr->Mx[i]*(vxr - bp);
+
+    FlMy = pUl->My[i]*(vxl - bm);
+    FrMy = pUr->My[i]*(vxr - bp);
+
+    FlMz = pUl->Mz[i]*(vxl - bm);
+    FrMz = pUr->Mz[i]*(vxr - bp);
+
+#ifdef ISOTHERMAL
+    FlMx += dl*Iso_csound2;
+    FrMx += dr*Iso_csound2;
+#else
+    FlMx += Pl;
+    FrMx += Pr;
+
+    FlE  = El*(vxl - bm) + Pl*vxl;
+    FrE  = Er*(vxr - bp) + Pr*vxr;
+#endif /* ISOTHERMAL */
+
+#ifdef MHD
+    FlMx -= 0.5*(bx*bx - SQR(Byl) - SQR(Bzl));
+    FrMx -= 0.5*(bx*bx - SQR(Byr) - SQR(Bzr));
+
+    FlMy -= bx*Byl;
+    FrMy -= bx*Byr;
+
+    FlMz -= bx*Bzl;
+    FrMz -= bx*Bzr;
+
+#ifndef ISOTHERMAL
+    FlE += (pbl*vxl - bx*(bx*vxl + Byl*vyl + Bzl*vzl));
+    FrE += (pbr*vxr - bx*(bx*vxr + Byr*vyr + Bzr*vzr));
+#endif /* ISOTHERMAL */
+
+    FlBy = Byl*(vxl - bm) - bx*vyl;
+    FrBy = Byr*(vxr - bp) - bx*vyr;
+
+    FlBz = Bzl*(vxl - bm) - bx*vzl;
+    FrBz = Bzr*(vxr - bp) - bx*vzr;
+#endif /* MHD */
+
+/* HLLE flux at interface (Step 6 of fluxes()) */
+
+    tmp = 0.5*(bp + bm)/(bp - bm);
+    pF->d[i]  = 0.5*(Fld  + Frd ) + (Fld  - Frd )*tmp;
+    pF->Mx[i] = 0.5*(FlMx + FrMx) + (FlMx - FrMx)*tmp;
+    pF->My[i] = 0.5*(FlMy + FrMy) + (FlMy - FrMy)*tmp;
+    pF->Mz[i] = 0.5*(FlMz + FrMz) + (FlMz - FrMz)*tmp;
+#ifndef ISOTHERMAL
+    pF->E[i]  = 0.5*(FlE  + FrE ) + (FlE  - FrE )*tmp;
+#endif
+#ifdef MHD
+    pF->By[i] = 0.5*(FlBy + FrBy) + (FlBy - FrBy)*tmp;
+    pF->Bz[i] = 0.5*(FlBz + FrBz) + (FlBz - FrBz)*tmp;
+#endif
+
+#if (NSCALARS > 0)
+    for (n=0; n<NSCALARS; n++)
+      pF->s[n][i] = pF->d[i]*(pF->d[i] >= 0.0 ? pWl->r[n][i] : pWr->r[n][i]);
+#endif
+  }
+
+  return;
+}
+#endif /* FLUXES_PENCIL */
 #endif
@@ -37,6 +37,19 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
             const Prim1DS Wl, const Prim1DS Wr,
             const Real Bxi, Cons1DS *pF);
 
+/* Batched version of fluxes() for the interfaces il..iu of a pencil, with the
+ * L/R states stored as arrays of each variable.  Defined only by the solvers
+ * listed below; the integrators use it whenever FLUXES_PENCIL is defined */
+#if (defined(HLLE_FLUX) || defined(HLLC_FLUX) || \
+    (defined(HLLD_FLUX) && !defined(ISOTHERMAL))) && \
+    !defined(SPECIAL_RELATIVITY) && !defined(CYLINDRICAL)
+#define FLUXES_PENCIL
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DArrS *pUl, const Cons1DArrS *pUr,
+                   const Prim1DArrS *pWl, const Prim1DArrS *pWr,
+                   const Real *Bxi, Cons1DArrS *pF);
+#endif
+
 #ifdef SPECIAL_RELATIVITY
 void entropy_flux (const Cons1DS Ul, const Cons1DS Ur,
 		   const Prim1DS Wl, const Prim1DS Wr,
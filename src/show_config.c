@@ -49,6 +49,8 @@ void show_config(void)
   ath_pout(0," Self-gravity:            using FFTs\n");
 #elif defined(SELF_GRAVITY_USING_FFT_OBC)
   ath_pout(0," Self-gravity:            using FFT_OBC\n");
+#elif defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
+  ath_pout(0," Self-gravity:            using FFT_MULTIPOLE\n");
 #elif defined(SELF_GRAVITY_USING_FFT_DISK)
   ath_pout(0," Self-gravity:            using FFT_DISK\n");
 #else
@@ -141,6 +143,12 @@ void show_config(void)
   ath_pout(0," Precision:               DOUBLE_PREC\n");
 #endif
 
+#if defined(SOA_STORAGE)
+  ath_pout(0," Conserved var storage:   SoA\n");
+#else
+  ath_pout(0," Conserved var storage:   AoS\n");
+#endif
+
 #ifdef WRITE_GHOST_CELLS
   ath_pout(0," Ghost cell Output:       ON\n");
 #else
@@ -153,6 +161,12 @@ void show_config(void)
   ath_pout(0," Parallel Modes: MPI:     OFF\n");
 #endif
 
+#if defined(OPENMP_PARALLEL)
+  ath_pout(0," Parallel Modes: OpenMP:  ON\n");
+#else
+  ath_pout(0," Parallel Modes: OpenMP:  OFF\n");
+#endif
+
 #ifdef H_CORRECTION
   ath_pout(0," H-correction:            ON\n");
 #else
@@ -221,6 +235,8 @@ void show_config_par(void)
   par_sets("configure","self-gravity","FFT","Self-gravity algorithm");
 #elif defined(SELF_GRAVITY_USING_FFT_OBC)
   par_sets("configure","self-gravity","FFT_OBC","Self-gravity algorithm");
+#elif defined(SELF_GRAVITY_USING_FFT_MULTIPOLE)
+  par_sets("configure","self-gravity","FFT_MULTIPOLE","Self-gravity algorithm");
 #elif defined(SELF_GRAVITY_USING_FFT_DISK)
   par_sets("configure","self-gravity","FFT_DISK","Self-gravity algorithm");
 #else
@@ -307,6 +323,12 @@ void show_config_par(void)
   par_sets("configure","precision","double","Type of Real variables");
 #endif
 
+#if defined(SOA_STORAGE)
+  par_sets("configure","storage","soa","Storage of Grid conserved variables");
+#else
+  par_sets("configure","storage","aos","Storage of Grid conserved variables");
+#endif
+
 #ifdef WRITE_GHOST_CELLS
   par_sets("configure","write_ghost","yes","Ghost cells included in output?");
 #else
@@ -319,6 +341,12 @@ void show_config_par(void)
   par_sets("configure","mpi","no","Is code MPI parallel enabled?");
 #endif
 
+#if defined(OPENMP_PARALLEL)
+  par_sets("configure","openmp","yes","Is code OpenMP threading enabled?");
+#else
+  par_sets("configure","openmp","no","Is code OpenMP threading enabled?");
+#endif
+
 #ifdef H_CORRECTION
   par_sets("configure","H-correction","yes","H-correction enabled?");
 #else
@@ -14,12 +14,26 @@
  *    corrects cells at fine/coarse boundaries using restricted fine Grid fluxes
  * - Prolongate(): sets BC on fine Grid by prolongation (interpolation) of
  *     coarse Grid solution into fine grid ghost zones
- * - SMR_init(): allocates memory for send/receive buffers
+ * - RestrictCorrect_Level(), Prolongate_Level(): as above, for one pair of
+ *     levels, used when each level is advanced with its own timestep
+ * - Prolongate_Save(): saves the coarse solution that Prolongate_Level()
+ *     interpolates from, at the start of a step of a level
+ * - Average_FineFlux(): averages fluxes at fine/coarse boundaries over the
+ *     two steps of a subcycled level
+ * - SMR_init(): allocates (or reallocates) memory for send/receive buffers
+ * - Prolongate_Phi(): sets potential in fine Grid ghost zones at one level
+ * - RestrictCorrect_Phi(): restricts potential, and its gradient at
+ *     fine/coarse boundaries, from one level to the next coarser one
  *
  * PRIVATE FUNCTION PROTOTYPES: 
+ * - restrict_correct() - RestrictCorrect() over a range of levels
+ * - prolongate() - Prolongate() over a range of levels
+ * - pack_prolong() - loads the data sent to a child Grid by Prolongate()
+ * - sum_fine_flux() - copies or averages fluxes on the boundaries of a Grid
  * - ProCon() - prolongates conserved variables
  * - ProFld() - prolongates face-centered B field using TR formulas
- * - mcd_slope() - returns monotonized central-difference slope		      */
+ * - mcd_slope() - returns monotonized central-difference slope
+ * - nWordsRC_Phi() - length of a message sent by RestrictCorrect_Phi()	      */
 /*============================================================================*/
 
 #include <stdio.h>
@@ -41,7 +55,12 @@ static double ***recv_bufRC=NULL;
 static MPI_Request ***recv_rq=NULL;
 static MPI_Request  **send_rq=NULL;
 #endif
-static int maxND, *start_addrP;
+static int maxND, *start_addrP=NULL;
+
+/* With subcycling: the data each level sent in Prolongate() at the start of
+ * its step, and copies of the fine fluxes from the first of two steps */
+static double ***save_bufP=NULL;
+static Real ***flx_save=NULL;
 
 static ConsS ***GZ[3];
 #ifdef MHD
@@ -49,13 +68,31 @@ Real **SMRemf1, **SMRemf2, **SMRemf3;
 Real3Vect ***BFld[3];
 #endif
 
+/* words per zone in the messages of Prolongate() */
+#ifdef MHD
+#define NPWORDS ((NVAR) + 3)
+#else
+#define NPWORDS (NVAR)
+#endif
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
+ *   restrict_correct - RestrictCorrect() over a range of levels
+ *   prolongate - Prolongate() over a range of levels
+ *   pack_prolong - loads the data sent to a child Grid by Prolongate()
+ *   sum_fine_flux - copies or averages fluxes on the boundaries of a Grid
  *   ProCon - prolongates conserved variables
  *   ProFld - prolongates face-centered B field using TR formulas
  *   mcd_slope - returns monotonized central-difference slope
  *============================================================================*/
 
+static void restrict_correct(MeshS *pM, const int nlo, const int nhi);
+static void prolongate(MeshS *pM, const int nlo, const int nhi,
+  const Real frac);
+static double *pack_prolong(GridS *pG, GridOvrlpS *pCO, const int nDim,
+  double *pSnd);
+static int sum_fine_flux(GridS *pG, Real *pS, const int isub);
+
 void ProCon(const ConsS Uim1,const ConsS Ui,  const ConsS Uip1,
             const ConsS Ujm1,const ConsS Ujp1,
             const ConsS Ukm1,const ConsS Ukp1, ConsS PCon[][2][2]);
@@ -66,6 +103,9 @@ void ProFld(Real3Vect BGZ[][3][3], Real3Vect PFld[][3][3],
 #ifndef FIRST_ORDER
 static Real mcd_slope(const Real vl, const Real vc, const Real vr);
 #endif /* FIRST_ORDER */
+#ifdef SELF_GRAVITY
+static int nWordsRC_Phi(const GridOvrlpS *pO, const int r);
+#endif
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -75,6 +115,30 @@ static Real mcd_slope(const Real vl, const Real vc, const Real vr);
  */
 
 void RestrictCorrect(MeshS *pM)
+{
+  restrict_correct(pM, 0, (pM->NLevels)-1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void RestrictCorrect_Level(MeshS *pM, const int nl)
+ *  \brief Restricts the solution on Grids at level nl+1 to their parents at
+ *   level nl, and corrects level nl with the restricted fluxes.
+ *
+ *   Used with subcycling, after the two steps of level nl+1 that follow each
+ *   step of level nl.  The fluxes of level nl+1 must have been averaged over
+ *   those two steps by Average_FineFlux().  */
+
+void RestrictCorrect_Level(MeshS *pM, const int nl)
+{
+  if (nl < (pM->NLevels)-1) restrict_correct(pM, nl, nl+1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void restrict_correct(MeshS *pM, const int nlo, const int nhi)
+ *  \brief RestrictCorrect() for levels nlo to nhi.  Grids at level nhi only
+ *   send, and Grids at level nlo only receive. */
+
+static void restrict_correct(MeshS *pM, const int nlo, const int nhi)
 {
   GridS *pG;
   int nl,nd,ncg,dim,nDim,npg,rbufN,start_addr,cnt,nCons,nFlx,nZeroRC;
@@ -98,16 +162,16 @@ void RestrictCorrect(MeshS *pM)
   nDim=1;
   for (i=1; i<3; i++) if (pM->Nx[i]>1) nDim++;
 
-/* Loop over all Domains, starting at maxlevel */
+/* Loop over all Domains, starting at level nhi */
 
-  for (nl=(pM->NLevels)-1; nl>=0; nl--){
+  for (nl=nhi; nl>=nlo; nl--){
 
 #ifdef MPI_PARALLEL
 /* Post non-blocking receives at level nl-1 for data from child Grids at this
  * level (nl).  This data is sent in Step 3 below, and will be read in Step 1
  * at the next iteration of the loop. */ 
 
-  if (nl>0) {
+  if (nl>nlo) {
     for (nd=0; nd<(pM->DomainsPerLevel[nl-1]); nd++){
       if (pM->Domain[nl-1][nd].Grid != NULL) {
         pG=pM->Domain[nl-1][nd].Grid;
@@ -138,11 +202,11 @@ void RestrictCorrect(MeshS *pM)
 
 /*=== Step 1. Get child solution, inject into parent Grid ====================*/
 /* Loop over Domains and child Grids.  Maxlevel domains skip this step because
- * they have NCGrids=0 */
+ * they have NCGrids=0, as do Domains at level nhi (nothing was sent to them) */
 
   for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
 
-  if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
+  if (pM->Domain[nl][nd].Grid != NULL && nl < nhi) { /* Grid on this proc */
     pG=pM->Domain[nl][nd].Grid;
     rbufN = (nl % 2);
     nZeroRC = 0;
@@ -206,20 +270,20 @@ void RestrictCorrect(MeshS *pM)
       for (k=kcs; k<=kce; k++) {
         for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[k][j][i].d  = *(pRcv++);
-            pG->U[k][j][i].M1 = *(pRcv++);
-            pG->U[k][j][i].M2 = *(pRcv++);
-            pG->U[k][j][i].M3 = *(pRcv++);
+            UVAR(pG,k,j,i,d)  = *(pRcv++);
+            UVAR(pG,k,j,i,M1) = *(pRcv++);
+            UVAR(pG,k,j,i,M2) = *(pRcv++);
+            UVAR(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  = *(pRcv++);
+            UVAR(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c = *(pRcv++);
-            pG->U[k][j][i].B2c = *(pRcv++);
-            pG->U[k][j][i].B3c = *(pRcv++);
+            UVAR(pG,k,j,i,B1c) = *(pRcv++);
+            UVAR(pG,k,j,i,B2c) = *(pRcv++);
+            UVAR(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+            for (n=0; n<NSCALARS; n++) UVAR(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
           }
         }
@@ -233,42 +297,39 @@ void RestrictCorrect(MeshS *pM)
 
       if (nDim == 1){ /* 1D problem - set face-centered to cell-centered */
         for (i=ics; i<=ice; i++) {
-          pG->B1i[kcs][jcs][i] = pG->U[kcs][jcs][i].B1c;
-          pG->B2i[kcs][jcs][i] = pG->U[kcs][jcs][i].B2c;
-          pG->B3i[kcs][jcs][i] = pG->U[kcs][jcs][i].B3c;
+          pG->B1i[kcs][jcs][i] = UVAR(pG,kcs,jcs,i,B1c);
+          pG->B2i[kcs][jcs][i] = UVAR(pG,kcs,jcs,i,B2c);
+          pG->B3i[kcs][jcs][i] = UVAR(pG,kcs,jcs,i,B3c);
         }
-      } else {
+      } else if (ics <= ice && jcs <= jce && kcs <= kce) {
+        /* no fields are sent if the Grids only touch */
 
         if (nDim == 2){  /* 2D problem */
-/* Restrict B1i */
+/* Restrict B1i.  The overlap may be a single zone wide (ics=ice), in which
+ * case only the fields at its two faces are sent */
           for (j=jcs  ; j<=jce; j++) {
-          for (i=ics+1; i<=ice; i++) {
             /* Set B1i at ics if no flux correction will be made.  Increment
              * pointer even if value in Rcv pointer is ignored. */
-            if (i==ics+1){
-              if (pCO->myFlx[0] == NULL) {pG->B1i[kcs][j][ics] = *(pRcv++);}
-              else {pRcv++;}
-            }
+            if (pCO->myFlx[0] == NULL) {pG->B1i[kcs][j][ics] = *(pRcv++);}
+            else {pRcv++;}
 
-            pG->B1i[kcs][j][i] = *(pRcv++);
+            for (i=ics+1; i<=ice; i++) {
+              pG->B1i[kcs][j][i] = *(pRcv++);
+            }
 
             /* Set B1i at ice+1 if no flux correction will be made.  Increment
              * pointer even if value in Rcv pointer is ignored. */
-            if (i==ice){
-              if (pCO->myFlx[1] == NULL) {pG->B1i[kcs][j][ice+1] = *(pRcv++);}
-              else {pRcv++;}
-            }
-          }}
+            if (pCO->myFlx[1] == NULL) {pG->B1i[kcs][j][ice+1] = *(pRcv++);}
+            else {pRcv++;}
+          }
 
 /* Restrict B2i */
           /* Set B2i at jcs if no flux correction will be made.  Increment
            * pointer even if value in Rcv pointer is ignored. */
-        if(jcs < jce){
           for (i=ics; i<=ice; i++) {
             if (pCO->myFlx[2] == NULL) {pG->B2i[kcs][jcs][i] = *(pRcv++);}
             else {pRcv++;}
           }
-        }
 
           for (j=jcs+1; j<=jce; j++) {
           for (i=ics  ; i<=ice; i++) {
@@ -277,46 +338,40 @@ void RestrictCorrect(MeshS *pM)
 
           /* Set B2i at jce+1 if no flux correction will be made.  Increment
            * pointer even if value in Rcv pointer is ignored. */
-        if(jcs < jce){
           for (i=ics; i<=ice; i++) {
             if (pCO->myFlx[3] == NULL) {pG->B2i[kcs][jce+1][i] = *(pRcv++);}
             else {pRcv++;}
           }
-        }
 
 /* Set cell-centered fields */
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[kcs][j][i].B1c=0.5*(pG->B1i[kcs][j][i] +pG->B1i[kcs][j][i+1]);
-            pG->U[kcs][j][i].B2c=0.5*(pG->B2i[kcs][j][i] +pG->B2i[kcs][j+1][i]);
-            pG->B3i[kcs][j][i] = pG->U[kcs][j][i].B3c;
+            UVAR(pG,kcs,j,i,B1c)=0.5*(pG->B1i[kcs][j][i] +pG->B1i[kcs][j][i+1]);
+            UVAR(pG,kcs,j,i,B2c)=0.5*(pG->B2i[kcs][j][i] +pG->B2i[kcs][j+1][i]);
+            pG->B3i[kcs][j][i] = UVAR(pG,kcs,j,i,B3c);
           }}
 
         } else { /* 3D problem */
-/* Restrict B1i */
+/* Restrict B1i.  The overlap may be a single zone wide in any direction, in
+ * which case only the fields at its two faces are sent */
           for (k=kcs  ; k<=kce; k++) {
           for (j=jcs  ; j<=jce; j++) {
-          for (i=ics+1; i<=ice; i++) {
             /* Set B1i at ics if no flux correction will be made.  Increment
              * pointer even if value in Rcv pointer is ignored. */
-            if (i==ics+1){
-              if (pCO->myFlx[0] == NULL) {pG->B1i[k][j][ics] = *(pRcv++);}
-              else {pRcv++;}
-            }
+            if (pCO->myFlx[0] == NULL) {pG->B1i[k][j][ics] = *(pRcv++);}
+            else {pRcv++;}
 
-            pG->B1i[k][j][i] = *(pRcv++);
+            for (i=ics+1; i<=ice; i++) {
+              pG->B1i[k][j][i] = *(pRcv++);
+            }
 
             /* Set B1i at ice+1 if no flux correction will be made.  Increment
              * pointer even if value in Rcv pointer is ignored. */
-            if (i==ice){
-              if (pCO->myFlx[1] == NULL) {pG->B1i[k][j][ice+1] = *(pRcv++);}
-              else {pRcv++;}
-            }
-
-          }}}
+            if (pCO->myFlx[1] == NULL) {pG->B1i[k][j][ice+1] = *(pRcv++);}
+            else {pRcv++;}
+          }}
 
 /* Restrict B2i */
-        if(jcs < jce){
           for (k=kcs  ; k<=kce; k++) {
             /* Set B2i at jcs if no flux correction will be made.  Increment
              * pointer even if value in Rcv pointer is ignored. */
@@ -337,18 +392,15 @@ void RestrictCorrect(MeshS *pM)
               else {pRcv++;}
             }
           }
-        }
 
 /* Restrict B3i */
           /* Set B3i at kcs if no flux correction will be made.  Increment
            * pointer even if value in Rcv pointer is ignored. */
-        if(kcs < kce){
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
             if (pCO->myFlx[4] == NULL) {pG->B3i[kcs][j][i] = *(pRcv++);}
             else {pRcv++;}
           }}
-        }
           for (k=kcs+1; k<=kce; k++) {
           for (j=jcs  ; j<=jce; j++) {
           for (i=ics  ; i<=ice; i++) {
@@ -357,20 +409,18 @@ void RestrictCorrect(MeshS *pM)
 
           /* Set B3i at kce+1 if no flux correction will be made.  Increment
            * pointer even if value in Rcv pointer is ignored. */
-        if(kcs < kce){
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
             if (pCO->myFlx[5] == NULL) {pG->B3i[kce+1][j][i] = *(pRcv++);}
             else {pRcv++;}
           }}
-        }
 /* Set cell-centered fields */
           for (k=kcs; k<=kce; k++) {
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
-            pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
-            pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+            UVAR(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+            UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+            UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
           }}}
 
         }
@@ -392,20 +442,20 @@ void RestrictCorrect(MeshS *pM)
           if (dim == 1) {i=ice+1; q1= (pG->dt/pG->dx1);}
           for (k=kcs, kk=0; k<=kce; k++, kk++) {
           for (j=jcs, jj=0; j<=jce; j++, jj++) {
-            pG->U[k][j][i].d  -= q1*(pCO->myFlx[dim][kk][jj].d  - *(pRcv++));
-            pG->U[k][j][i].M1 -= q1*(pCO->myFlx[dim][kk][jj].M1 - *(pRcv++));
-            pG->U[k][j][i].M2 -= q1*(pCO->myFlx[dim][kk][jj].M2 - *(pRcv++));
-            pG->U[k][j][i].M3 -= q1*(pCO->myFlx[dim][kk][jj].M3 - *(pRcv++));
+            UVAR(pG,k,j,i,d)  -= q1*(pCO->myFlx[dim][kk][jj].d  - *(pRcv++));
+            UVAR(pG,k,j,i,M1) -= q1*(pCO->myFlx[dim][kk][jj].M1 - *(pRcv++));
+            UVAR(pG,k,j,i,M2) -= q1*(pCO->myFlx[dim][kk][jj].M2 - *(pRcv++));
+            UVAR(pG,k,j,i,M3) -= q1*(pCO->myFlx[dim][kk][jj].M3 - *(pRcv++));
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  -= q1*(pCO->myFlx[dim][kk][jj].E  - *(pRcv++));
+            UVAR(pG,k,j,i,E)  -= q1*(pCO->myFlx[dim][kk][jj].E  - *(pRcv++));
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c -= q1*(pCO->myFlx[dim][kk][jj].B1c - *(pRcv++));
-            pG->U[k][j][i].B2c -= q1*(pCO->myFlx[dim][kk][jj].B2c - *(pRcv++));
-            pG->U[k][j][i].B3c -= q1*(pCO->myFlx[dim][kk][jj].B3c - *(pRcv++));
+            UVAR(pG,k,j,i,B1c) -= q1*(pCO->myFlx[dim][kk][jj].B1c - *(pRcv++));
+            UVAR(pG,k,j,i,B2c) -= q1*(pCO->myFlx[dim][kk][jj].B2c - *(pRcv++));
+            UVAR(pG,k,j,i,B3c) -= q1*(pCO->myFlx[dim][kk][jj].B3c - *(pRcv++));
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] -= 
+            for (n=0; n<NSCALARS; n++) UVAR(pG,k,j,i,s[n]) -= 
               q1*(pCO->myFlx[dim][kk][jj].s[n] - *(pRcv++));
 #endif
           }}
@@ -420,20 +470,20 @@ void RestrictCorrect(MeshS *pM)
           if (dim == 3) {j=jce+1; q2= (pG->dt/pG->dx2);}
           for (k=kcs, kk=0; k<=kce; k++, kk++) {
           for (i=ics, ii=0; i<=ice; i++, ii++) {
-            pG->U[k][j][i].d  -= q2*(pCO->myFlx[dim][kk][ii].d  - *(pRcv++));
-            pG->U[k][j][i].M1 -= q2*(pCO->myFlx[dim][kk][ii].M1 - *(pRcv++));
-            pG->U[k][j][i].M2 -= q2*(pCO->myFlx[dim][kk][ii].M2 - *(pRcv++));
-            pG->U[k][j][i].M3 -= q2*(pCO->myFlx[dim][kk][ii].M3 - *(pRcv++));
+            UVAR(pG,k,j,i,d)  -= q2*(pCO->myFlx[dim][kk][ii].d  - *(pRcv++));
+            UVAR(pG,k,j,i,M1) -= q2*(pCO->myFlx[dim][kk][ii].M1 - *(pRcv++));
+            UVAR(pG,k,j,i,M2) -= q2*(pCO->myFlx[dim][kk][ii].M2 - *(pRcv++));
+            UVAR(pG,k,j,i,M3) -= q2*(pCO->myFlx[dim][kk][ii].M3 - *(pRcv++));
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  -= q2*(pCO->myFlx[dim][kk][ii].E  - *(pRcv++));
+            UVAR(pG,k,j,i,E)  -= q2*(pCO->myFlx[dim][kk][ii].E  - *(pRcv++));
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c -= q2*(pCO->myFlx[dim][kk][ii].B1c - *(pRcv++));
-            pG->U[k][j][i].B2c -= q2*(pCO->myFlx[dim][kk][ii].B2c - *(pRcv++));
-            pG->U[k][j][i].B3c -= q2*(pCO->myFlx[dim][kk][ii].B3c - *(pRcv++));
+            UVAR(pG,k,j,i,B1c) -= q2*(pCO->myFlx[dim][kk][ii].B1c - *(pRcv++));
+            UVAR(pG,k,j,i,B2c) -= q2*(pCO->myFlx[dim][kk][ii].B2c - *(pRcv++));
+            UVAR(pG,k,j,i,B3c) -= q2*(pCO->myFlx[dim][kk][ii].B3c - *(pRcv++));
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] -= 
+            for (n=0; n<NSCALARS; n++) UVAR(pG,k,j,i,s[n]) -= 
               q2*(pCO->myFlx[dim][kk][ii].s[n] - *(pRcv++));
 #endif
           }}
@@ -448,20 +498,20 @@ void RestrictCorrect(MeshS *pM)
           if (dim == 5) {k=kce+1; q3= (pG->dt/pG->dx3);}
           for (j=jcs, jj=0; j<=jce; j++, jj++) {
           for (i=ics, ii=0; i<=ice; i++, ii++) {
-            pG->U[k][j][i].d  -= q3*(pCO->myFlx[dim][jj][ii].d  - *(pRcv++));
-            pG->U[k][j][i].M1 -= q3*(pCO->myFlx[dim][jj][ii].M1 - *(pRcv++));
-            pG->U[k][j][i].M2 -= q3*(pCO->myFlx[dim][jj][ii].M2 - *(pRcv++));
-            pG->U[k][j][i].M3 -= q3*(pCO->myFlx[dim][jj][ii].M3 - *(pRcv++));
+            UVAR(pG,k,j,i,d)  -= q3*(pCO->myFlx[dim][jj][ii].d  - *(pRcv++));
+            UVAR(pG,k,j,i,M1) -= q3*(pCO->myFlx[dim][jj][ii].M1 - *(pRcv++));
+            UVAR(pG,k,j,i,M2) -= q3*(pCO->myFlx[dim][jj][ii].M2 - *(pRcv++));
+            UVAR(pG,k,j,i,M3) -= q3*(pCO->myFlx[dim][jj][ii].M3 - *(pRcv++));
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  -= q3*(pCO->myFlx[dim][jj][ii].E  - *(pRcv++));
+            UVAR(pG,k,j,i,E)  -= q3*(pCO->myFlx[dim][jj][ii].E  - *(pRcv++));
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c -= q3*(pCO->myFlx[dim][jj][ii].B1c - *(pRcv++));
-            pG->U[k][j][i].B2c -= q3*(pCO->myFlx[dim][jj][ii].B2c - *(pRcv++));
-            pG->U[k][j][i].B3c -= q3*(pCO->myFlx[dim][jj][ii].B3c - *(pRcv++));
+            UVAR(pG,k,j,i,B1c) -= q3*(pCO->myFlx[dim][jj][ii].B1c - *(pRcv++));
+            UVAR(pG,k,j,i,B2c) -= q3*(pCO->myFlx[dim][jj][ii].B2c - *(pRcv++));
+            UVAR(pG,k,j,i,B3c) -= q3*(pCO->myFlx[dim][jj][ii].B3c - *(pRcv++));
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] -= 
+            for (n=0; n<NSCALARS; n++) UVAR(pG,k,j,i,s[n]) -= 
               q3*(pCO->myFlx[dim][jj][ii].s[n] - *(pRcv++));
 #endif
           }}
@@ -576,18 +626,18 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 
             for (k=kcs-1; k<=kce+1; k++) {
             for (j=jcs; j<=jce; j++) {
-              pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+              UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
             }}
 
           }
 
           for (k=kcs; k<=kce; k++) {
             for (j=jcs; j<=jce; j++) {
-              pG->U[k][j][ib  ].B1c=0.5*(pG->B1i[k][j][ib]+pG->B1i[k][j][ib+1]);
-              pG->U[k][j][ib-1].B1c=0.5*(pG->B1i[k][j][ib-1]+pG->B1i[k][j][ib]);
+              UVAR(pG,k,j,ib,B1c)=0.5*(pG->B1i[k][j][ib]+pG->B1i[k][j][ib+1]);
+              UVAR(pG,k,j,ib-1,B1c)=0.5*(pG->B1i[k][j][ib-1]+pG->B1i[k][j][ib]);
             }
             for (j=jcs-1; j<=jce+1; j++) {
-              pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+              UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
             }
           }
         }
@@ -686,18 +736,18 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 
             for (k=kcs-1; k<=kce+1; k++) {
             for (i=ics; i<=ice; i++) {
-              pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+              UVAR(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
             }}
 
           }
 
           for (k=kcs; k<=kce; k++) {
             for (i=ics-1; i<=ice+1; i++) {
-              pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+              UVAR(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
             }
             for (i=ics; i<=ice; i++) {
-              pG->U[k][jb  ][i].B2c=0.5*(pG->B2i[k][jb][i]+pG->B2i[k][jb+1][i]);
-              pG->U[k][jb-1][i].B2c=0.5*(pG->B2i[k][jb-1][i]+pG->B2i[k][jb][i]);
+              UVAR(pG,k,jb,i,B2c)=0.5*(pG->B2i[k][jb][i]+pG->B2i[k][jb+1][i]);
+              UVAR(pG,k,jb-1,i,B2c)=0.5*(pG->B2i[k][jb-1][i]+pG->B2i[k][jb][i]);
             }
           }
         }
@@ -786,18 +836,18 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 
           for (j=jcs; j<=jce; j++) {
           for (i=ics-1; i<=ice+1; i++) {
-            pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+            UVAR(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
           }}
 
           for (j=jcs-1; j<=jce+1; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+            UVAR(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
           }}
 
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[kb  ][j][i].B3c=0.5*(pG->B3i[kb][j][i] + pG->B3i[kb+1][j][i]);
-            pG->U[kb-1][j][i].B3c=0.5*(pG->B3i[kb-1][j][i] + pG->B3i[kb][j][i]);
+            UVAR(pG,kb,j,i,B3c)=0.5*(pG->B3i[kb][j][i] + pG->B3i[kb+1][j][i]);
+            UVAR(pG,kb-1,j,i,B3c)=0.5*(pG->B3i[kb-1][j][i] + pG->B3i[kb][j][i]);
           }}
         }
       }
@@ -811,12 +861,13 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 /*=== Step 3. Restrict child solution and fluxes and send ====================*/
 /* Loop over all Domains and parent Grids.  Maxlevel grids skip straight to this
  * step to start the chain of communication.  Root (level=0) skips this step
- * since it has NPGrid=0.  If there is a parent Grid on this processor, it will
- * be first in the PGrid array, so it will be at start of send_bufRC */
+ * since it has NPGrid=0, as does level nlo.  If there is a parent Grid on this
+ * processor, it will be first in the PGrid array, so it will be at start of
+ * send_bufRC */
 
   for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
 
-  if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
+  if (pM->Domain[nl][nd].Grid != NULL && nl > nlo) { /* Grid on this proc */
     pG=pM->Domain[nl][nd].Grid;          /* set pointer to this Grid */
     start_addr=0;
     nZeroRC = 0;
@@ -850,21 +901,21 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
       for (k=kps; k<=kpe; k+=2) {
       for (j=jps; j<=jpe; j+=2) {
       for (i=ips; i<=ipe; i+=2) {
-        *(pSnd++) = pG->U[k][j][i].d  + pG->U[k][j][i+1].d;
-        *(pSnd++) = pG->U[k][j][i].M1 + pG->U[k][j][i+1].M1;
-        *(pSnd++) = pG->U[k][j][i].M2 + pG->U[k][j][i+1].M2;
-        *(pSnd++) = pG->U[k][j][i].M3 + pG->U[k][j][i+1].M3;
+        *(pSnd++) = UVAR(pG,k,j,i,d)  + UVAR(pG,k,j,i+1,d);
+        *(pSnd++) = UVAR(pG,k,j,i,M1) + UVAR(pG,k,j,i+1,M1);
+        *(pSnd++) = UVAR(pG,k,j,i,M2) + UVAR(pG,k,j,i+1,M2);
+        *(pSnd++) = UVAR(pG,k,j,i,M3) + UVAR(pG,k,j,i+1,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E  + pG->U[k][j][i+1].E;
+        *(pSnd++) = UVAR(pG,k,j,i,E)  + UVAR(pG,k,j,i+1,E);
 #endif
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c + pG->U[k][j][i+1].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c + pG->U[k][j][i+1].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c + pG->U[k][j][i+1].B3c;
+        *(pSnd++) = UVAR(pG,k,j,i,B1c) + UVAR(pG,k,j,i+1,B1c);
+        *(pSnd++) = UVAR(pG,k,j,i,B2c) + UVAR(pG,k,j,i+1,B2c);
+        *(pSnd++) = UVAR(pG,k,j,i,B3c) + UVAR(pG,k,j,i+1,B3c);
 #endif
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++) 
-          *(pSnd++) = pG->U[k][j][i].s[n] + pG->U[k][j][i+1].s[n];
+          *(pSnd++) = UVAR(pG,k,j,i,s[n]) + UVAR(pG,k,j,i+1,s[n]);
 #endif
       }}}
       fact = 0.5;
@@ -877,21 +928,21 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
         for (k=kps; k<=kpe; k+=2) {
         for (j=jps; j<=jpe; j+=2) {
         for (i=ips; i<=ipe; i+=2) {
-          *(pSnd++) += pG->U[k][j+1][i].d  + pG->U[k][j+1][i+1].d;
-          *(pSnd++) += pG->U[k][j+1][i].M1 + pG->U[k][j+1][i+1].M1;
-          *(pSnd++) += pG->U[k][j+1][i].M2 + pG->U[k][j+1][i+1].M2;
-          *(pSnd++) += pG->U[k][j+1][i].M3 + pG->U[k][j+1][i+1].M3;
+          *(pSnd++) += UVAR(pG,k,j+1,i,d)  + UVAR(pG,k,j+1,i+1,d);
+          *(pSnd++) += UVAR(pG,k,j+1,i,M1) + UVAR(pG,k,j+1,i+1,M1);
+          *(pSnd++) += UVAR(pG,k,j+1,i,M2) + UVAR(pG,k,j+1,i+1,M2);
+          *(pSnd++) += UVAR(pG,k,j+1,i,M3) + UVAR(pG,k,j+1,i+1,M3);
 #ifndef BAROTROPIC
-          *(pSnd++) += pG->U[k][j+1][i].E  + pG->U[k][j+1][i+1].E;
+          *(pSnd++) += UVAR(pG,k,j+1,i,E)  + UVAR(pG,k,j+1,i+1,E);
 #endif
 #ifdef MHD
-          *(pSnd++) += pG->U[k][j+1][i].B1c + pG->U[k][j+1][i+1].B1c;
-          *(pSnd++) += pG->U[k][j+1][i].B2c + pG->U[k][j+1][i+1].B2c;
-          *(pSnd++) += pG->U[k][j+1][i].B3c + pG->U[k][j+1][i+1].B3c;
+          *(pSnd++) += UVAR(pG,k,j+1,i,B1c) + UVAR(pG,k,j+1,i+1,B1c);
+          *(pSnd++) += UVAR(pG,k,j+1,i,B2c) + UVAR(pG,k,j+1,i+1,B2c);
+          *(pSnd++) += UVAR(pG,k,j+1,i,B3c) + UVAR(pG,k,j+1,i+1,B3c);
 #endif
 #if (NSCALARS > 0)
           for (n=0; n<NSCALARS; n++) 
-            *(pSnd++) += pG->U[k][j+1][i].s[n] + pG->U[k][j+1][i+1].s[n];
+            *(pSnd++) += UVAR(pG,k,j+1,i,s[n]) + UVAR(pG,k,j+1,i+1,s[n]);
 #endif
         }}}
         fact = 0.25;
@@ -905,30 +956,30 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
         for (k=kps; k<=kpe; k+=2) {
         for (j=jps; j<=jpe; j+=2) {
         for (i=ips; i<=ipe; i+=2) {
-          *(pSnd++) += pG->U[k+1][j  ][i].d  + pG->U[k+1][j  ][i+1].d +
-                       pG->U[k+1][j+1][i].d  + pG->U[k+1][j+1][i+1].d;
-          *(pSnd++) += pG->U[k+1][j  ][i].M1 + pG->U[k+1][j  ][i+1].M1 +
-                       pG->U[k+1][j+1][i].M1 + pG->U[k+1][j+1][i+1].M1;
-          *(pSnd++) += pG->U[k+1][j  ][i].M2 + pG->U[k+1][j  ][i+1].M2 +
-                       pG->U[k+1][j+1][i].M2 + pG->U[k+1][j+1][i+1].M2;
-          *(pSnd++) += pG->U[k+1][j  ][i].M3 + pG->U[k+1][j  ][i+1].M3 +
-                       pG->U[k+1][j+1][i].M3 + pG->U[k+1][j+1][i+1].M3;
+          *(pSnd++) += UVAR(pG,k+1,j,i,d)  + UVAR(pG,k+1,j,i+1,d) +
+                       UVAR(pG,k+1,j+1,i,d)  + UVAR(pG,k+1,j+1,i+1,d);
+          *(pSnd++) += UVAR(pG,k+1,j,i,M1) + UVAR(pG,k+1,j,i+1,M1) +
+                       UVAR(pG,k+1,j+1,i,M1) + UVAR(pG,k+1,j+1,i+1,M1);
+          *(pSnd++) += UVAR(pG,k+1,j,i,M2) + UVAR(pG,k+1,j,i+1,M2) +
+                       UVAR(pG,k+1,j+1,i,M2) + UVAR(pG,k+1,j+1,i+1,M2);
+          *(pSnd++) += UVAR(pG,k+1,j,i,M3) + UVAR(pG,k+1,j,i+1,M3) +
+                       UVAR(pG,k+1,j+1,i,M3) + UVAR(pG,k+1,j+1,i+1,M3);
 #ifndef BAROTROPIC
-          *(pSnd++) += pG->U[k+1][j  ][i].E  + pG->U[k+1][j  ][i+1].E +
-                       pG->U[k+1][j+1][i].E  + pG->U[k+1][j+1][i+1].E;
+          *(pSnd++) += UVAR(pG,k+1,j,i,E)  + UVAR(pG,k+1,j,i+1,E) +
+                       UVAR(pG,k+1,j+1,i,E)  + UVAR(pG,k+1,j+1,i+1,E);
 #endif
 #ifdef MHD
-          *(pSnd++) += pG->U[k+1][j  ][i].B1c + pG->U[k+1][j  ][i+1].B1c +
-                       pG->U[k+1][j+1][i].B1c + pG->U[k+1][j+1][i+1].B1c;
-          *(pSnd++) += pG->U[k+1][j  ][i].B2c + pG->U[k+1][j  ][i+1].B2c +
-                       pG->U[k+1][j+1][i].B2c + pG->U[k+1][j+1][i+1].B2c;
-          *(pSnd++) += pG->U[k+1][j  ][i].B3c + pG->U[k+1][j  ][i+1].B3c +
-                       pG->U[k+1][j+1][i].B3c + pG->U[k+1][j+1][i+1].B3c;
+          *(pSnd++) += UVAR(pG,k+1,j,i,B1c) + UVAR(pG,k+1,j,i+1,B1c) +
+                       UVAR(pG,k+1,j+1,i,B1c) + UVAR(pG,k+1,j+1,i+1,B1c);
+          *(pSnd++) += UVAR(pG,k+1,j,i,B2c) + UVAR(pG,k+1,j,i+1,B2c) +
+                       UVAR(pG,k+1,j+1,i,B2c) + UVAR(pG,k+1,j+1,i+1,B2c);
+          *(pSnd++) += UVAR(pG,k+1,j,i,B3c) + UVAR(pG,k+1,j,i+1,B3c) +
+                       UVAR(pG,k+1,j+1,i,B3c) + UVAR(pG,k+1,j+1,i+1,B3c);
 #endif
 #if (NSCALARS > 0)
           for (n=0; n<NSCALARS; n++) 
-            *(pSnd++) += pG->U[k+1][j  ][i].s[n] + pG->U[k+1][j  ][i+1].s[n] +
-                         pG->U[k+1][j+1][i].s[n] + pG->U[k+1][j+1][i+1].s[n];
+            *(pSnd++) += UVAR(pG,k+1,j,i,s[n]) + UVAR(pG,k+1,j,i+1,s[n]) +
+                         UVAR(pG,k+1,j+1,i,s[n]) + UVAR(pG,k+1,j+1,i+1,s[n]);
 #endif
         }}}
         fact = 0.125;
@@ -1334,7 +1385,7 @@ printf("cnt = %i\n", cnt);
  * is more efficient if there are multiple messages per Grid. */
 
   for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-    if (pM->Domain[nl][nd].Grid != NULL) {
+    if (pM->Domain[nl][nd].Grid != NULL && nl > nlo) {
       pG=pM->Domain[nl][nd].Grid;
       nZeroRC = 0;
 
@@ -1359,14 +1410,104 @@ printf("cnt = %i\n", cnt);
  *  \brief Sets BC on fine Grid by prolongation (interpolation) of
  *     coarse Grid solution into fine grid ghost zones */
 void Prolongate(MeshS *pM)
+{
+  prolongate(pM, 0, (pM->NLevels)-1, 1.0);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Prolongate_Level(MeshS *pM, const int nl, const Real frac)
+ *  \brief Sets ghost zones of Grids at level nl on fine/coarse boundaries by
+ *   prolongation of the solution on their parents at level nl-1, interpolated
+ *   linearly in time to a fraction frac of the last step of level nl-1.
+ *
+ *   Used with subcycling.  For frac<1 the solution on level nl-1 at the start
+ *   of its step must have been saved by Prolongate_Save().  */
+
+void Prolongate_Level(MeshS *pM, const int nl, const Real frac)
+{
+  if (nl > 0) prolongate(pM, nl-1, nl, frac);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Prolongate_Save(MeshS *pM, const int nl)
+ *  \brief Saves the data that Grids at level nl send to their children in
+ *   Prolongate(), before level nl takes a step, so that Prolongate_Level()
+ *   can interpolate in time. */
+
+void Prolongate_Save(MeshS *pM, const int nl)
+{
+  GridS *pG;
+  GridOvrlpS *pCO;
+  int nDim,nd,ncg,dim;
+
+  if (save_bufP == NULL)
+    ath_error("[Prolongate_Save]: buffers not allocated, subcycle=0\n");
+
+  nDim=1;
+  for (dim=1; dim<3; dim++) if (pM->Nx[dim]>1) nDim++;
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) {
+      pG=pM->Domain[nl][nd].Grid;
+      for(ncg=0; ncg<maxND; ncg++) start_addrP[ncg] = 0;
+
+      for (ncg=0; ncg<(pG->NCGrid); ncg++){
+        if (pG->CGrid[ncg].nWordsP > 0) {
+          pCO=(GridOvrlpS*)&(pG->CGrid[ncg]);
+          pack_prolong(pG, pCO, nDim,
+            &(save_bufP[nl][pCO->DomN][start_addrP[pCO->DomN]]));
+          start_addrP[pCO->DomN] += pCO->nWordsP;
+        }
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Average_FineFlux(MeshS *pM, const int nl, const int isub)
+ *  \brief Averages the fluxes (and EMFs) stored by the integrator on the
+ *   boundaries of the parent Grids of Grids at level nl over the two steps
+ *   level nl takes per step of level nl-1.
+ *
+ *   Call after each of the two steps, with isub=0 and then isub=1.  The first
+ *   call keeps a copy of the fluxes, the second replaces them by the mean of
+ *   that copy and the new ones, which RestrictCorrect_Level() then uses. */
+
+void Average_FineFlux(MeshS *pM, const int nl, const int isub)
+{
+  int nd;
+
+  if (flx_save == NULL)
+    ath_error("[Average_FineFlux]: buffers not allocated, subcycle=0\n");
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL)
+      sum_fine_flux(pM->Domain[nl][nd].Grid, flx_save[nl][nd], isub);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void prolongate(MeshS *pM, const int nlo, const int nhi,
+ *                             const Real frac)
+ *  \brief Prolongate() for levels nlo to nhi.  Grids at level nlo only send,
+ *   and Grids at level nhi only receive.  For frac<1, the data sent is
+ *   interpolated in time to the fraction frac between that saved by
+ *   Prolongate_Save() and the current solution. */
+
+static void prolongate(MeshS *pM, const int nlo, const int nhi,
+  const Real frac)
 {
   GridS *pG;
   int nDim,nl,nd,ncg,dim,npg,rbufN,id,l,m,n,mend,nend,nZeroP;
-  int i,ii,ics,ice,ips,ipe,igzs,igze;
-  int j,jj,jcs,jce,jps,jpe,jgzs,jgze;
-  int k,kk,kcs,kce,kps,kpe,kgzs,kgze;
+  int i,ii,ips,ipe,igzs,igze;
+  int j,jj,jps,jpe,jgzs,jgze;
+  int k,kk,kps,kpe,kgzs,kgze;
   int ngz1,ngz2,ngz3;
-  double *pRcv,*pSnd;
+  double *pRcv,*pSnd,*pSav;
   GridOvrlpS *pCO, *pPO;
   ConsS ProlongedC[2][2][2];
 #if (NSCALARS > 0)
@@ -1383,16 +1524,16 @@ void Prolongate(MeshS *pM)
   nDim=1;
   for (dim=1; dim<3; dim++) if (pM->Nx[dim]>1) nDim++;
 
-/* Loop over all levels, starting at root level */
+/* Loop over all levels, starting at level nlo */
 
-  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nl=nlo; nl<=nhi; nl++){
 
 #ifdef MPI_PARALLEL
 /* Post non-blocking receives at level nl+1 for data from parent Grids at this
  * level (nl). This data is sent in Step 1 below,
  * and will be read in Step 2 during the next iteration of nl */
 
-  if (nl<(pM->NLevels)-1) {
+  if (nl<nhi) {
     for (nd=0; nd<(pM->DomainsPerLevel[nl+1]); nd++){
       if (pM->Domain[nl+1][nd].Grid != NULL) {
         pG=pM->Domain[nl+1][nd].Grid;
@@ -1434,7 +1575,7 @@ void Prolongate(MeshS *pM)
 
   for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
 
-  if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
+  if (pM->Domain[nl][nd].Grid != NULL && nl < nhi) { /* Grid on this proc */
     pG=pM->Domain[nl][nd].Grid;
     for(i=0; i<maxND; i++) start_addrP[i] = 0;
     nZeroP = 0;
@@ -1453,62 +1594,15 @@ void Prolongate(MeshS *pM)
  * same processor.  Start address must be different for each DomN */
       pSnd = (double*)&(send_bufP[pCO->DomN][start_addrP[pCO->DomN]]); 
 
-      for (dim=0; dim<(2*nDim); dim++){
-        if (pCO->myFlx[dim] != NULL) {
-
-/* Get coordinates ON THIS GRID of zones that overlap child Grid ghost zones */
-
-          ics = pCO->ijks[0] - (nghost/2) - 1;
-          ice = pCO->ijke[0] + (nghost/2) + 1;
-          if (pG->Nx[1] > 1) {
-            jcs = pCO->ijks[1] - (nghost/2) - 1;
-            jce = pCO->ijke[1] + (nghost/2) + 1;
-          } else {
-            jcs = pCO->ijks[1];
-            jce = pCO->ijke[1];
-          }
-          if (pG->Nx[2] > 1) {
-            kcs = pCO->ijks[2] - (nghost/2) - 1;
-            kce = pCO->ijke[2] + (nghost/2) + 1;
-          } else {
-            kcs = pCO->ijks[2];
-            kce = pCO->ijke[2];
-          }
-          if (dim == 0) ice = pCO->ijks[0];
-          if (dim == 1) ics = pCO->ijke[0];
-          if (dim == 2) jce = pCO->ijks[1];
-          if (dim == 3) jcs = pCO->ijke[1];
-          if (dim == 4) kce = pCO->ijks[2];
-          if (dim == 5) kcs = pCO->ijke[2];
+      pack_prolong(pG, pCO, nDim, pSnd);
 
-/*--- Step 1a. ---------------------------------------------------------------*/
-/* Load send buffer with values in zones that overlap child ghost zones */
+/* With subcycling, interpolate in time between the data saved at the start of
+ * the step of this level and the current solution */
 
-          for (k=kcs; k<=kce; k++) {
-          for (j=jcs; j<=jce; j++) {
-          for (i=ics; i<=ice; i++) {
-            *(pSnd++) = pG->U[k][j][i].d;
-            *(pSnd++) = pG->U[k][j][i].M1;
-            *(pSnd++) = pG->U[k][j][i].M2;
-            *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-            *(pSnd++) = pG->U[k][j][i].E;
-#endif
-#ifdef MHD
-            *(pSnd++) = pG->U[k][j][i].B1c;
-            *(pSnd++) = pG->U[k][j][i].B2c;
-            *(pSnd++) = pG->U[k][j][i].B3c;
-            *(pSnd++) = pG->B1i[k][j][i];
-            *(pSnd++) = pG->B2i[k][j][i];
-            *(pSnd++) = pG->B3i[k][j][i];
-#endif
-#if (NSCALARS > 0)
-            for (ns=0; ns<NSCALARS; ns++) {
-               *(pSnd++) = pG->U[k][j][i].s[ns];
-            }
-#endif
-          }}}
-        }
+      if (frac < 1.0) {
+        pSav = (double*)&(save_bufP[nl][pCO->DomN][start_addrP[pCO->DomN]]);
+        for (i=0; i<pCO->nWordsP; i++)
+          pSnd[i] = pSav[i] + frac*(pSnd[i] - pSav[i]);
       }
 
 /*--- Step 1b. ---------------------------------------------------------------*/
@@ -1530,12 +1624,12 @@ void Prolongate(MeshS *pM)
 
 /*=== Step 2. Get step =======================================================*/
 /* Loop over all Domains, get data sent by parent Grids, and prolongate solution
- * into ghost zones. */
+ * into ghost zones.  Nothing was sent to level nlo. */
 
 
   for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
 
-  if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
+  if (pM->Domain[nl][nd].Grid != NULL && nl > nlo) { /* Grid on this proc */
     pG=pM->Domain[nl][nd].Grid;          /* set pointer to Grid */
     rbufN = (nl % 2);
 
@@ -1730,21 +1824,21 @@ void Prolongate(MeshS *pM)
             for (n=0; n<=nend; n++) {
             for (m=0; m<=mend; m++) {
             for (l=0; l<=1; l++) {
-              pG->U[k+n][j+m][i+l].d  = ProlongedC[n][m][l].d;
-              pG->U[k+n][j+m][i+l].M1 = ProlongedC[n][m][l].M1;
-              pG->U[k+n][j+m][i+l].M2 = ProlongedC[n][m][l].M2;
-              pG->U[k+n][j+m][i+l].M3 = ProlongedC[n][m][l].M3;
+              UVAR(pG,k+n,j+m,i+l,d)  = ProlongedC[n][m][l].d;
+              UVAR(pG,k+n,j+m,i+l,M1) = ProlongedC[n][m][l].M1;
+              UVAR(pG,k+n,j+m,i+l,M2) = ProlongedC[n][m][l].M2;
+              UVAR(pG,k+n,j+m,i+l,M3) = ProlongedC[n][m][l].M3;
 #ifndef BAROTROPIC
-              pG->U[k+n][j+m][i+l].E  = ProlongedC[n][m][l].E;
+              UVAR(pG,k+n,j+m,i+l,E)  = ProlongedC[n][m][l].E;
 #endif
 #ifdef MHD
-              pG->U[k+n][j+m][i+l].B1c = ProlongedC[n][m][l].B1c;
-              pG->U[k+n][j+m][i+l].B2c = ProlongedC[n][m][l].B2c;
-              pG->U[k+n][j+m][i+l].B3c = ProlongedC[n][m][l].B3c;
+              UVAR(pG,k+n,j+m,i+l,B1c) = ProlongedC[n][m][l].B1c;
+              UVAR(pG,k+n,j+m,i+l,B2c) = ProlongedC[n][m][l].B2c;
+              UVAR(pG,k+n,j+m,i+l,B3c) = ProlongedC[n][m][l].B3c;
 #endif
 #if (NSCALARS > 0)
               for (ns=0; ns<NSCALARS; ns++) 
-                pG->U[k+n][j+m][i+l].s[ns] = ProlongedC[n][m][l].s[ns];
+                UVAR(pG,k+n,j+m,i+l,s[ns]) = ProlongedC[n][m][l].s[ns];
 #endif
             }}}
 
@@ -1754,9 +1848,9 @@ void Prolongate(MeshS *pM)
 
             if (nDim == 1) {
               for (l=0; l<=1; l++) {
-                pG->B1i[k][j][i+l] = pG->U[k][j][i+l].B1c;
-                pG->B2i[k][j][i+l] = pG->U[k][j][i+l].B2c;
-                pG->B3i[k][j][i+l] = pG->U[k][j][i+l].B3c;
+                pG->B1i[k][j][i+l] = UVAR(pG,k,j,i+l,B1c);
+                pG->B2i[k][j][i+l] = UVAR(pG,k,j,i+l,B2c);
+                pG->B3i[k][j][i+l] = UVAR(pG,k,j,i+l,B3c);
               }
             } else {
               for (n=0; n<3; n++) {
@@ -1890,11 +1984,11 @@ void Prolongate(MeshS *pM)
                 if (dim != 5 || (k+n) != kps)
                   pG->B3i[k+n][j+m][i+l] = ProlongedF[n][m][l].x3;
 
-                pG->U[k+n][j+m][i+l].B1c = 
+                UVAR(pG,k+n,j+m,i+l,B1c) = 
                   0.5*(ProlongedF[n][m][l].x1 + ProlongedF[n][m][l+1].x1);
-                pG->U[k+n][j+m][i+l].B2c = 
+                UVAR(pG,k+n,j+m,i+l,B2c) = 
                   0.5*(ProlongedF[n][m][l].x2 + ProlongedF[n][m+1][l].x2);
-                pG->U[k+n][j+m][i+l].B3c = 
+                UVAR(pG,k+n,j+m,i+l,B3c) = 
                   0.5*(ProlongedF[n][m][l].x3 + ProlongedF[n+1][m][l].x3);
               }}}
             }
@@ -1914,7 +2008,7 @@ void Prolongate(MeshS *pM)
  * iteration of the loop over levels (for nl=nl+1). */
 
   for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-    if (pM->Domain[nl][nd].Grid != NULL) { 
+    if (pM->Domain[nl][nd].Grid != NULL && nl < nhi) { 
       pG=pM->Domain[nl][nd].Grid; 
       rbufN = ((nl+1) % 2);
 
@@ -1952,104 +2046,653 @@ void Prolongate(MeshS *pM)
   } /* end loop over levels */
 }
 
+#ifdef SELF_GRAVITY
 /*============================================================================*/
 /*----------------------------------------------------------------------------*/
-/*! \fn void SMR_init(MeshS *pM)
- *  \brief Allocates memory for send/receive buffers
+/*! \fn void Prolongate_Phi(MeshS *pM, const int nl)
+ *  \brief Sets the potential in ghost zones of child Grids at level nl+1 on
+ *   fine/coarse boundaries, by linear interpolation of the potential on the
+ *   parent Grids at level nl.
+ *
+ *   Same communication pattern (and buffers) as Prolongate(), but only Phi
+ *   is sent, so messages are nWordsP/NPWORDS long.  The ghost zones of Phi
+ *   on the parent Grids must be set.  Slopes are not limited, since the
+ *   potential is smooth.  3D only, as is the multigrid solver that uses it.
  */
 
-void SMR_init(MeshS *pM)
+void Prolongate_Phi(MeshS *pM, const int nl)
 {
-  int nl,nd,sendRC,recvRC,sendP,recvP,npg,ncg;
-  int max_sendRC=1,max_recvRC=1,max_sendP=1,max_recvP=1;
-  int max1=0,max2=0,max3=0,maxCG=1;
-#ifdef MHD
-  int ngh1;
-#endif
   GridS *pG;
-  
-  maxND=1;
-  for (nl=0; nl<(pM->NLevels); nl++) maxND=MAX(maxND,pM->DomainsPerLevel[nl]);
-  if((start_addrP = (int*)calloc_1d_array(maxND,sizeof(int))) == NULL)
-    ath_error("[SMR_init]:Failed to allocate start_addrP\n");
-
-/* Loop over all parent Grids of Grids on this processor to find maximum total
- * number of words communicated */
+  int nd,ncg,npg,dim,id,l,m,n,nZeroP,start_addr;
+  int i,ii,ics,ice,ips,ipe,ngz1;
+  int j,jj,jcs,jce,jps,jpe,ngz2;
+  int k,kk,kcs,kce,kps,kpe,ngz3;
+  Real dq1,dq2,dq3;
+  double *pRcv,*pSnd;
+  GridOvrlpS *pCO, *pPO;
+#ifdef MPI_PARALLEL
+  int ierr,mAddress,mIndex,mCount;
+#endif
 
-  for (nl=0; nl<(pM->NLevels); nl++){
-    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-      sendRC=0;
-      recvRC=0;
-      sendP =1;
-      recvP =1;
+  if (pM->Nx[2] == 1) ath_error("[Prolongate_Phi]: only works in 3D\n");
+  if (nl >= (pM->NLevels)-1) return;
 
-      if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this proc */
-        pG=pM->Domain[nl][nd].Grid;          /* set pointer to Grid */
+#ifdef MPI_PARALLEL
+/* Post non-blocking receives at level nl+1 for data from parent Grids on
+ * other processors.  Data from a parent Grid on this processor is read
+ * directly from its send buffer in Step 2. */
 
-        for (npg=0; npg<pG->NPGrid; npg++){
-          sendRC += pG->PGrid[npg].nWordsRC;
-          recvP  += pG->PGrid[npg].nWordsP;
-        }
-        for (ncg=0; ncg<pG->NCGrid; ncg++){
-          recvRC += pG->CGrid[ncg].nWordsRC;
-          sendP  += pG->CGrid[ncg].nWordsP;
+  for (nd=0; nd<(pM->DomainsPerLevel[nl+1]); nd++){
+    if (pM->Domain[nl+1][nd].Grid != NULL) {
+      pG=pM->Domain[nl+1][nd].Grid;
+      nZeroP = 0;
+      mAddress = 0;
+
+      for (npg=(pG->NmyPGrid); npg<(pG->NPGrid); npg++){
+        if (pG->PGrid[npg].nWordsP == 0) {
+          nZeroP += 1;
+        } else {
+          mIndex = npg - pG->NmyPGrid - nZeroP;
+          ierr = MPI_Irecv(&(recv_bufP[0][nd][mAddress]),
+            pG->PGrid[npg].nWordsP/NPWORDS, MPI_DOUBLE, pG->PGrid[npg].ID,
+            pG->PGrid[npg].DomN, pM->Domain[nl+1][nd].Comm_Parent,
+            &(recv_rq[nl+1][nd][mIndex]));
+          mAddress += pG->PGrid[npg].nWordsP/NPWORDS;
         }
-
-        max_sendRC = MAX(max_sendRC,sendRC);
-        max_recvRC = MAX(max_recvRC,recvRC);
-        max_sendP  = MAX(max_sendP ,sendP );
-        max_recvP  = MAX(max_recvP ,recvP );
-        max1 = MAX(max1,(pG->Nx[0]+1));
-        max2 = MAX(max2,(pG->Nx[1]+1));
-        max3 = MAX(max3,(pG->Nx[2]+1));
-        maxCG = MAX(maxCG,pG->NCGrid);
       }
     }
   }
+#endif /* MPI_PARALLEL */
 
-/* Allocate memory for send/receive buffers and EMFs used in RestrictCorrect */
+/*=== Step 1. Send step ======================================================*/
+/* Loop over all Domains at level nl, and send Phi in zones that overlap the
+ * ghost zones of child Grids. */
 
-  if((send_bufRC =
-    (double**)calloc_2d_array(maxND,max_sendRC,sizeof(double))) == NULL)
-    ath_error("[SMR_init]:Failed to allocate send_bufRC\n");
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+
+  if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
+    pG=pM->Domain[nl][nd].Grid;
+    for(i=0; i<maxND; i++) start_addrP[i] = 0;
+    nZeroP = 0;
+
+    for (ncg=0; ncg<(pG->NCGrid); ncg++){
+    if (pG->CGrid[ncg].nWordsP == 0) {
+      if (ncg >= pG->NmyCGrid) nZeroP += 1;
+    } else {
+
+      pCO=(GridOvrlpS*)&(pG->CGrid[ncg]);    /* ptr to child Grid overlap */
+      start_addr = start_addrP[pCO->DomN];
+      pSnd = (double*)&(send_bufP[pCO->DomN][start_addr]);
+
+      for (dim=0; dim<6; dim++){
+        if (pCO->myFlx[dim] != NULL) {
+          ics = pCO->ijks[0] - (nghost/2) - 1;
+          ice = pCO->ijke[0] + (nghost/2) + 1;
+          jcs = pCO->ijks[1] - (nghost/2) - 1;
+          jce = pCO->ijke[1] + (nghost/2) + 1;
+          kcs = pCO->ijks[2] - (nghost/2) - 1;
+          kce = pCO->ijke[2] + (nghost/2) + 1;
+          if (dim == 0) ice = pCO->ijks[0];
+          if (dim == 1) ics = pCO->ijke[0];
+          if (dim == 2) jce = pCO->ijks[1];
+          if (dim == 3) jcs = pCO->ijke[1];
+          if (dim == 4) kce = pCO->ijks[2];
+          if (dim == 5) kcs = pCO->ijke[2];
+
+          for (k=kcs; k<=kce; k++) {
+          for (j=jcs; j<=jce; j++) {
+          for (i=ics; i<=ice; i++) {
+            *(pSnd++) = pG->Phi[k][j][i];
+          }}}
+        }
+      }
 
 #ifdef MPI_PARALLEL
-  if((recv_bufRC =
-    (double***)calloc_3d_array(2,maxND,max_recvRC,sizeof(double))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate recv_bufRC\n");
-  if((recv_rq = (MPI_Request***)
-    calloc_3d_array(pM->NLevels,maxND,maxCG,sizeof(MPI_Request))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate recv MPI_Request array\n");
-  if((send_rq = (MPI_Request**)
-    calloc_2d_array(maxND,maxCG,sizeof(MPI_Request))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate send MPI_Request array\n");
+      if (ncg >= pG->NmyCGrid) {
+        mIndex = ncg - pG->NmyCGrid - nZeroP;
+        ierr = MPI_Isend(&(send_bufP[pCO->DomN][start_addr]),
+          pCO->nWordsP/NPWORDS, MPI_DOUBLE, pCO->ID, nd,
+          pM->Domain[nl][nd].Comm_Children, &(send_rq[nd][mIndex]));
+      }
 #endif /* MPI_PARALLEL */
 
-#ifdef MHD
-  if((SMRemf1 =
-    (Real**)calloc_2d_array(MAX(max2,max3),max1,sizeof(Real))) == NULL)
-    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf1\n");;
-  if((SMRemf2 =
-    (Real**)calloc_2d_array(MAX(max2,max3),MAX(max1,max2),sizeof(Real))) ==NULL)
-    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf2\n");;
-  if((SMRemf3 =
-    (Real**)calloc_2d_array(max3,MAX(max1,max2),sizeof(Real))) == NULL)
-    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf3\n");;
-#endif /* MHD */
+      start_addrP[pCO->DomN] += pCO->nWordsP/NPWORDS;
+    }
+    } /* end loop over child grids */
+  }} /* end loop over Domains */
 
-/* Allocate memory for send/receive buffers and GZ arrays used in Prolongate */
+/*=== Step 2. Get step =======================================================*/
+/* Loop over all Domains at level nl+1, get data sent by parent Grids, and
+ * interpolate it into ghost zones. */
 
-  if((send_bufP =
-    (double**)calloc_2d_array(maxND,max_sendP,sizeof(double))) == NULL)
-    ath_error("[SMR_init]:Failed to allocate send_bufP\n");
+  for (nd=0; nd<(pM->DomainsPerLevel[nl+1]); nd++){
 
-  if((recv_bufP =
-    (double***)calloc_3d_array(2,maxND,max_recvP,sizeof(double))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate recv_bufP\n");
+  if (pM->Domain[nl+1][nd].Grid != NULL) { /* there is a Grid on this proc */
+    pG=pM->Domain[nl+1][nd].Grid;
 
-  max1 += 2*nghost;
-  max2 += 2*nghost;
-  max3 += 2*nghost;
+    nZeroP = 0;
+    for (i=pG->NmyPGrid; i<pG->NPGrid; i++) if(pG->PGrid[i].nWordsP==0) nZeroP++;
+
+    for (npg=0; npg<(pG->NPGrid - nZeroP); npg++){
+
+      if (npg < pG->NmyPGrid) {
+        pPO = (GridOvrlpS*)&(pG->PGrid[npg]);
+        pRcv = (double*)&(send_bufP[nd][0]);
+      } else {
+
+#ifdef MPI_PARALLEL
+        mCount = pG->NPGrid - pG->NmyPGrid - nZeroP;
+        ierr = MPI_Waitany(mCount,recv_rq[nl+1][nd],&mIndex,MPI_STATUS_IGNORE);
+        if(mIndex == MPI_UNDEFINED){
+          ath_error("[Prolong_Phi]: Invalid request index nl=%i nd=%i\n",
+            nl+1,nd);
+        }
+
+        mIndex += pG->NmyPGrid;
+        for (i=pG->NmyPGrid; i <= mIndex; i++)
+          if (pG->PGrid[i].nWordsP == 0) mIndex++;
+
+        mAddress = 0;
+        for (i=pG->NmyPGrid; i<mIndex; i++)
+          mAddress += pG->PGrid[i].nWordsP/NPWORDS;
+        pPO = (GridOvrlpS*)&(pG->PGrid[mIndex]);
+        pRcv = (double*)&(recv_bufP[0][nd][mAddress]);
+#else
+        ath_error("[Prolong_Phi]: no Parent Grid on Domain[%d][%d]\n",nl+1,nd);
+#endif /* MPI_PARALLEL */
+      }
+
+/*=== Step 3. Set ghost zones ================================================*/
+/* Load Phi on the parent Grid into the d component of the GZ array, then
+ * interpolate into each 2x2x2 block of ghost zones on this Grid */
+
+      for (dim=0; dim<6; dim++){
+        if ((pPO->myFlx[dim] != NULL) && (pPO->nWordsP > 0)) {
+          id = dim/2;
+          ngz1 = (pPO->ijke[0] - pPO->ijks[0] + 1)/2 + nghost + 2;
+          ngz2 = (pPO->ijke[1] - pPO->ijks[1] + 1)/2 + nghost + 2;
+          ngz3 = (pPO->ijke[2] - pPO->ijks[2] + 1)/2 + nghost + 2;
+          if (id == 0) ngz1 = (nghost/2) + 2;
+          if (id == 1) ngz2 = (nghost/2) + 2;
+          if (id == 2) ngz3 = (nghost/2) + 2;
+
+          for (k=0; k<ngz3; k++) {
+          for (j=0; j<ngz2; j++) {
+          for (i=0; i<ngz1; i++) {
+            GZ[id][k][j][i].d = *(pRcv++);
+          }}}
+
+          ips = pPO->ijks[0] - nghost;
+          ipe = pPO->ijke[0] + nghost;
+          jps = pPO->ijks[1] - nghost;
+          jpe = pPO->ijke[1] + nghost;
+          kps = pPO->ijks[2] - nghost;
+          kpe = pPO->ijke[2] + nghost;
+          if (dim == 0) {ipe = pPO->ijks[0] - 1;}
+          if (dim == 1) {ips = pPO->ijke[0] + 1;}
+          if (dim == 2) {jpe = pPO->ijks[1] - 1;}
+          if (dim == 3) {jps = pPO->ijke[1] + 1;}
+          if (dim == 4) {kpe = pPO->ijks[2] - 1;}
+          if (dim == 5) {kps = pPO->ijke[2] + 1;}
+
+          for (k=kps, kk=1; k<=kpe; k+=2, kk++) {
+          for (j=jps, jj=1; j<=jpe; j+=2, jj++) {
+          for (i=ips, ii=1; i<=ipe; i+=2, ii++) {
+            dq1 = 0.5*(GZ[id][kk][jj][ii+1].d - GZ[id][kk][jj][ii-1].d);
+            dq2 = 0.5*(GZ[id][kk][jj+1][ii].d - GZ[id][kk][jj-1][ii].d);
+            dq3 = 0.5*(GZ[id][kk+1][jj][ii].d - GZ[id][kk-1][jj][ii].d);
+            for (n=0; n<=1; n++) {
+            for (m=0; m<=1; m++) {
+            for (l=0; l<=1; l++) {
+              pG->Phi[k+n][j+m][i+l] = GZ[id][kk][jj][ii].d
+                + (0.5*l - 0.25)*dq1 + (0.5*m - 0.25)*dq2 + (0.5*n - 0.25)*dq3;
+            }}}
+          }}}
+        }
+      } /* end loop over dims */
+
+    } /* end loop over parent grids */
+  }} /* end loop over Domains */
+
+#ifdef MPI_PARALLEL
+/*=== Step 4. Wait for all non-blocking sends in Step 1 to complete ==========*/
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) {
+      pG=pM->Domain[nl][nd].Grid;
+
+      nZeroP = 0;
+      for (i=pG->NmyCGrid; i<pG->NCGrid; i++) if(pG->CGrid[i].nWordsP==0) nZeroP++;
+
+      if (pG->NCGrid > pG->NmyCGrid) {
+        mCount = pG->NCGrid - pG->NmyCGrid - nZeroP;
+        ierr = MPI_Waitall(mCount, send_rq[nd], MPI_STATUS_IGNORE);
+      }
+    }
+  }
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void RestrictCorrect_Phi(MeshS *pM, const int nl)
+ *  \brief Restricts (averages) the potential on Grids at level nl onto the
+ *   zones they cover on parent Grids, and stores the mean gradient of the
+ *   fine potential across each fine/coarse boundary in myPhiFlx[] of the
+ *   parent's CGrid overlap.
+ *
+ *   The gradients are the fluxes of the composite Poisson equation; the
+ *   self-gravity solver uses them to correct the coarse equation in zones
+ *   next to the fine Grid.  Ghost zones of Phi on fine/coarse boundaries of
+ *   the Grids at level nl must be set by Prolongate_Phi().  Same
+ *   communication pattern (and buffers) as RestrictCorrect().  3D only.
+ */
+
+void RestrictCorrect_Phi(MeshS *pM, const int nl)
+{
+  GridS *pG;
+  int nd,ncg,npg,dim,start_addr,nZeroRC;
+  int i,ii,ics,ice,ips,ipe;
+  int j,jj,jcs,jce,jps,jpe;
+  int k,kk,kcs,kce,kps,kpe;
+  Real q1,q2,q3;
+  double *pRcv,*pSnd;
+  GridOvrlpS *pCO, *pPO;
+#ifdef MPI_PARALLEL
+  int ierr,mAddress,mIndex,mCount;
+#endif
+
+  if (pM->Nx[2] == 1) ath_error("[RestrictCorrect_Phi]: only works in 3D\n");
+  if (nl == 0) return;
+
+#ifdef MPI_PARALLEL
+/* Post non-blocking receives at level nl-1 for data from child Grids on
+ * other processors */
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl-1]); nd++){
+    if (pM->Domain[nl-1][nd].Grid != NULL) {
+      pG=pM->Domain[nl-1][nd].Grid;
+      nZeroRC = 0;
+      mAddress = 0;
+
+      for (ncg=(pG->NmyCGrid); ncg<(pG->NCGrid); ncg++){
+        if(pG->CGrid[ncg].nWordsRC == 0){
+          nZeroRC += 1;
+        } else {
+          mIndex = ncg - pG->NmyCGrid - nZeroRC;
+          ierr = MPI_Irecv(&(recv_bufRC[0][nd][mAddress]),
+            nWordsRC_Phi(&(pG->CGrid[ncg]),1), MPI_DOUBLE, pG->CGrid[ncg].ID,
+            pG->CGrid[ncg].DomN, pM->Domain[nl-1][nd].Comm_Children,
+            &(recv_rq[nl-1][nd][mIndex]));
+          mAddress += nWordsRC_Phi(&(pG->CGrid[ncg]),1);
+        }
+      }
+    }
+  }
+#endif /* MPI_PARALLEL */
+
+/*=== Step 1. Restrict Phi and its gradients and send ========================*/
+/* Loop over all Domains at level nl and parent Grids.  If there is a parent
+ * Grid on this processor, it will be first in the PGrid array, so it will be
+ * at start of send_bufRC */
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+
+  if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
+    pG=pM->Domain[nl][nd].Grid;
+    start_addr=0;
+    nZeroRC = 0;
+    q1 = 0.25/pG->dx1;
+    q2 = 0.25/pG->dx2;
+    q3 = 0.25/pG->dx3;
+
+    for (npg=0; npg<(pG->NPGrid); npg++){
+    if(pG->PGrid[npg].nWordsRC == 0){
+      if(npg >= pG->NmyPGrid) nZeroRC += 1;
+    } else {
+
+      pPO=(GridOvrlpS*)&(pG->PGrid[npg]);    /* ptr to Grid overlap */
+      pSnd = (double*)&(send_bufRC[nd][start_addr]);
+
+      ips = pPO->ijks[0];
+      ipe = pPO->ijke[0];
+      jps = pPO->ijks[1];
+      jpe = pPO->ijke[1];
+      kps = pPO->ijks[2];
+      kpe = pPO->ijke[2];
+
+/* Average of Phi over each 2x2x2 block of zones */
+
+      for (k=kps; k<=kpe; k+=2) {
+      for (j=jps; j<=jpe; j+=2) {
+      for (i=ips; i<=ipe; i+=2) {
+        *(pSnd++) = 0.125*(
+            pG->Phi[k  ][j  ][i] + pG->Phi[k  ][j  ][i+1]
+          + pG->Phi[k  ][j+1][i] + pG->Phi[k  ][j+1][i+1]
+          + pG->Phi[k+1][j  ][i] + pG->Phi[k+1][j  ][i+1]
+          + pG->Phi[k+1][j+1][i] + pG->Phi[k+1][j+1][i+1]);
+      }}}
+
+/* Mean gradient of Phi across each fine/coarse boundary, over the 2x2 fine
+ * faces covering each coarse face */
+
+      for (dim=0; dim<2; dim++){
+        if (pPO->myFlx[dim] != NULL) {
+          i = (dim == 0) ? ips : ipe+1;
+          for (k=kps; k<=kpe; k+=2) {
+          for (j=jps; j<=jpe; j+=2) {
+            *(pSnd++) = q1*(
+                pG->Phi[k  ][j][i] - pG->Phi[k  ][j][i-1]
+              + pG->Phi[k  ][j+1][i] - pG->Phi[k  ][j+1][i-1]
+              + pG->Phi[k+1][j][i] - pG->Phi[k+1][j][i-1]
+              + pG->Phi[k+1][j+1][i] - pG->Phi[k+1][j+1][i-1]);
+          }}
+        }
+      }
+
+      for (dim=2; dim<4; dim++){
+        if (pPO->myFlx[dim] != NULL) {
+          j = (dim == 2) ? jps : jpe+1;
+          for (k=kps; k<=kpe; k+=2) {
+          for (i=ips; i<=ipe; i+=2) {
+            *(pSnd++) = q2*(
+                pG->Phi[k  ][j][i] - pG->Phi[k  ][j-1][i]
+              + pG->Phi[k  ][j][i+1] - pG->Phi[k  ][j-1][i+1]
+              + pG->Phi[k+1][j][i] - pG->Phi[k+1][j-1][i]
+              + pG->Phi[k+1][j][i+1] - pG->Phi[k+1][j-1][i+1]);
+          }}
+        }
+      }
+
+      for (dim=4; dim<6; dim++){
+        if (pPO->myFlx[dim] != NULL) {
+          k = (dim == 4) ? kps : kpe+1;
+          for (j=jps; j<=jpe; j+=2) {
+          for (i=ips; i<=ipe; i+=2) {
+            *(pSnd++) = q3*(
+                pG->Phi[k][j  ][i] - pG->Phi[k-1][j  ][i]
+              + pG->Phi[k][j  ][i+1] - pG->Phi[k-1][j  ][i+1]
+              + pG->Phi[k][j+1][i] - pG->Phi[k-1][j+1][i]
+              + pG->Phi[k][j+1][i+1] - pG->Phi[k-1][j+1][i+1]);
+          }}
+        }
+      }
+
+#ifdef MPI_PARALLEL
+      if (npg >= pG->NmyPGrid){
+        mIndex = npg - pG->NmyPGrid - nZeroRC;
+        ierr = MPI_Isend(&(send_bufRC[nd][start_addr]), nWordsRC_Phi(pPO,2),
+          MPI_DOUBLE, pPO->ID, nd, pM->Domain[nl][nd].Comm_Parent,
+          &(send_rq[nd][mIndex]));
+      }
+#endif /* MPI_PARALLEL */
+
+      start_addr += nWordsRC_Phi(pPO,2);
+    }
+    } /* end loop over parent grids */
+  }} /* end loop over Domains */
+
+/*=== Step 2. Get restricted Phi and gradients on parent Grids ===============*/
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl-1]); nd++){
+
+  if (pM->Domain[nl-1][nd].Grid != NULL) { /* there is a Grid on this proc */
+    pG=pM->Domain[nl-1][nd].Grid;
+    nZeroRC = 0;
+    for (i=pG->NmyCGrid; i<pG->NCGrid; i++)
+      if(pG->CGrid[i].nWordsRC == 0) nZeroRC++;
+
+    for (ncg=0; ncg<(pG->NCGrid-nZeroRC); ncg++){
+
+      if (ncg < pG->NmyCGrid) {
+        pCO=(GridOvrlpS*)&(pG->CGrid[ncg]);
+        pRcv = (double*)&(send_bufRC[pCO->DomN][0]);
+      } else {
+
+#ifdef MPI_PARALLEL
+        mCount = pG->NCGrid - pG->NmyCGrid - nZeroRC;
+        ierr = MPI_Waitany(mCount,recv_rq[nl-1][nd],&mIndex,MPI_STATUS_IGNORE);
+        if(mIndex == MPI_UNDEFINED){
+          ath_error("[RestCorr_Phi]: Invalid request index nl=%i nd=%i\n",
+            nl-1,nd);
+        }
+
+        mIndex += pG->NmyCGrid;
+        for(i=pG->NmyCGrid; i<=mIndex; i++)
+          if(pG->CGrid[i].nWordsRC == 0) mIndex++;
+
+        mAddress = 0;
+        for (i=pG->NmyCGrid; i<mIndex; i++)
+          mAddress += nWordsRC_Phi(&(pG->CGrid[i]),1);
+        pCO=(GridOvrlpS*)&(pG->CGrid[mIndex]);
+        pRcv = (double*)&(recv_bufRC[0][nd][mAddress]);
+#else
+        ath_error("[RestCorr_Phi]: no Child grid on Domain[%d][%d]\n",nl-1,nd);
+#endif /* MPI_PARALLEL */
+      }
+
+      ics = pCO->ijks[0];
+      ice = pCO->ijke[0];
+      jcs = pCO->ijks[1];
+      jce = pCO->ijke[1];
+      kcs = pCO->ijks[2];
+      kce = pCO->ijke[2];
+
+      for (k=kcs; k<=kce; k++) {
+      for (j=jcs; j<=jce; j++) {
+      for (i=ics; i<=ice; i++) {
+        pG->Phi[k][j][i] = *(pRcv++);
+      }}}
+
+      for (dim=0; dim<2; dim++){
+        if (pCO->myFlx[dim] != NULL) {
+          for (k=kcs, kk=0; k<=kce; k++, kk++) {
+          for (j=jcs, jj=0; j<=jce; j++, jj++) {
+            pCO->myPhiFlx[dim][kk][jj] = *(pRcv++);
+          }}
+        }
+      }
+      for (dim=2; dim<4; dim++){
+        if (pCO->myFlx[dim] != NULL) {
+          for (k=kcs, kk=0; k<=kce; k++, kk++) {
+          for (i=ics, ii=0; i<=ice; i++, ii++) {
+            pCO->myPhiFlx[dim][kk][ii] = *(pRcv++);
+          }}
+        }
+      }
+      for (dim=4; dim<6; dim++){
+        if (pCO->myFlx[dim] != NULL) {
+          for (j=jcs, jj=0; j<=jce; j++, jj++) {
+          for (i=ics, ii=0; i<=ice; i++, ii++) {
+            pCO->myPhiFlx[dim][jj][ii] = *(pRcv++);
+          }}
+        }
+      }
+    } /* end loop over child grids */
+  }} /* end loop over Domains */
+
+#ifdef MPI_PARALLEL
+/*=== Step 3. Wait for all non-blocking sends in Step 1 to complete ==========*/
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) {
+      pG=pM->Domain[nl][nd].Grid;
+      nZeroRC = 0;
+      for(i=pG->NmyPGrid; i<pG->NPGrid; i++)
+        if(pG->PGrid[i].nWordsRC == 0) nZeroRC++;
+
+      if (pG->NPGrid > pG->NmyPGrid) {
+        mCount = pG->NPGrid - pG->NmyPGrid - nZeroRC;
+        ierr = MPI_Waitall(mCount, send_rq[nd], MPI_STATUS_IGNORE);
+      }
+    }
+  }
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+#endif /* SELF_GRAVITY */
+
+/*============================================================================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void SMR_init(MeshS *pM)
+ *  \brief Allocates memory for send/receive buffers
+ */
+
+void SMR_init(MeshS *pM)
+{
+  int nl,nd,sendRC,recvRC,sendP,recvP,npg,ncg;
+  int max_sendRC=1,max_recvRC=1,max_sendP=1,max_recvP=1;
+  int max1=0,max2=0,max3=0,maxCG=1;
+#ifdef MHD
+  int ngh1;
+#endif
+  GridS *pG;
+
+/* Free the buffers of an earlier call.  Their sizes depend on the overlaps
+ * between child and parent Grids, which change when Regrid() moves Domains */
+
+  if (start_addrP != NULL) {
+    free_1d_array(start_addrP);
+    free_2d_array(send_bufRC);
+#ifdef MPI_PARALLEL
+    free_3d_array(recv_bufRC);
+    free_3d_array(recv_rq);
+    free_2d_array(send_rq);
+#endif
+#ifdef MHD
+    free_2d_array(SMRemf1);
+    free_2d_array(SMRemf2);
+    free_2d_array(SMRemf3);
+#endif
+    free_2d_array(send_bufP);
+    free_3d_array(recv_bufP);
+    if (save_bufP != NULL) {
+      free_3d_array(save_bufP);
+      for (nl=0; nl<(pM->NLevels); nl++){
+        for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+          if (flx_save[nl][nd] != NULL) free_1d_array(flx_save[nl][nd]);
+        }
+      }
+      free_2d_array(flx_save);
+    }
+    free_3d_array(GZ[0]);
+    free_3d_array(GZ[1]);
+    free_3d_array(GZ[2]);
+#ifdef MHD
+    free_3d_array(BFld[0]);
+    free_3d_array(BFld[1]);
+    free_3d_array(BFld[2]);
+#endif
+  }
+
+  maxND=1;
+  for (nl=0; nl<(pM->NLevels); nl++) maxND=MAX(maxND,pM->DomainsPerLevel[nl]);
+  if((start_addrP = (int*)calloc_1d_array(maxND,sizeof(int))) == NULL)
+    ath_error("[SMR_init]:Failed to allocate start_addrP\n");
+
+/* Loop over all parent Grids of Grids on this processor to find maximum total
+ * number of words communicated */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      sendRC=0;
+      recvRC=0;
+      sendP =1;
+      recvP =1;
+
+      if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this proc */
+        pG=pM->Domain[nl][nd].Grid;          /* set pointer to Grid */
+
+        for (npg=0; npg<pG->NPGrid; npg++){
+          sendRC += pG->PGrid[npg].nWordsRC;
+          recvP  += pG->PGrid[npg].nWordsP;
+        }
+        for (ncg=0; ncg<pG->NCGrid; ncg++){
+          recvRC += pG->CGrid[ncg].nWordsRC;
+          sendP  += pG->CGrid[ncg].nWordsP;
+        }
+
+        max_sendRC = MAX(max_sendRC,sendRC);
+        max_recvRC = MAX(max_recvRC,recvRC);
+        max_sendP  = MAX(max_sendP ,sendP );
+        max_recvP  = MAX(max_recvP ,recvP );
+        max1 = MAX(max1,(pG->Nx[0]+1));
+        max2 = MAX(max2,(pG->Nx[1]+1));
+        max3 = MAX(max3,(pG->Nx[2]+1));
+/* MPI requests are indexed by child Grid, and by parent Grid */
+        maxCG = MAX(maxCG,pG->NCGrid);
+        maxCG = MAX(maxCG,pG->NPGrid);
+      }
+    }
+  }
+
+/* Allocate memory for send/receive buffers and EMFs used in RestrictCorrect */
+
+  if((send_bufRC =
+    (double**)calloc_2d_array(maxND,max_sendRC,sizeof(double))) == NULL)
+    ath_error("[SMR_init]:Failed to allocate send_bufRC\n");
+
+#ifdef MPI_PARALLEL
+  if((recv_bufRC =
+    (double***)calloc_3d_array(2,maxND,max_recvRC,sizeof(double))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate recv_bufRC\n");
+  if((recv_rq = (MPI_Request***)
+    calloc_3d_array(pM->NLevels,maxND,maxCG,sizeof(MPI_Request))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate recv MPI_Request array\n");
+  if((send_rq = (MPI_Request**)
+    calloc_2d_array(maxND,maxCG,sizeof(MPI_Request))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate send MPI_Request array\n");
+#endif /* MPI_PARALLEL */
+
+#ifdef MHD
+  if((SMRemf1 =
+    (Real**)calloc_2d_array(MAX(max2,max3),max1,sizeof(Real))) == NULL)
+    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf1\n");;
+  if((SMRemf2 =
+    (Real**)calloc_2d_array(MAX(max2,max3),MAX(max1,max2),sizeof(Real))) ==NULL)
+    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf2\n");;
+  if((SMRemf3 =
+    (Real**)calloc_2d_array(max3,MAX(max1,max2),sizeof(Real))) == NULL)
+    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf3\n");;
+#endif /* MHD */
+
+/* Allocate memory for send/receive buffers and GZ arrays used in Prolongate */
+
+  if((send_bufP =
+    (double**)calloc_2d_array(maxND,max_sendP,sizeof(double))) == NULL)
+    ath_error("[SMR_init]:Failed to allocate send_bufP\n");
+
+  if((recv_bufP =
+    (double***)calloc_3d_array(2,maxND,max_recvP,sizeof(double))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate recv_bufP\n");
+
+/* With subcycling, allocate memory for the data saved by Prolongate_Save() at
+ * each level, and for the fine fluxes saved by Average_FineFlux() */
+
+  if (pM->subcycle) {
+    if((save_bufP = (double***)calloc_3d_array(pM->NLevels,maxND,max_sendP,
+      sizeof(double))) == NULL)
+      ath_error("[SMR_init]: Failed to allocate save_bufP\n");
+
+    if((flx_save = (Real***)calloc_2d_array(pM->NLevels,maxND,sizeof(Real*)))
+      == NULL) ath_error("[SMR_init]: Failed to allocate flx_save\n");
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (pM->Domain[nl][nd].Grid != NULL) {
+          pG=pM->Domain[nl][nd].Grid;
+          if((flx_save[nl][nd] = (Real*)calloc_1d_array(
+            MAX(sum_fine_flux(pG,NULL,0),1),sizeof(Real))) == NULL)
+            ath_error("[SMR_init]: Failed to allocate flx_save\n");
+        }
+      }
+    }
+  }
+
+  max1 += 2*nghost;
+  max2 += 2*nghost;
+  max3 += 2*nghost;
 
   if((GZ[0]=(ConsS***)calloc_3d_array(max3,max2,nghost,sizeof(ConsS)))
     ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[0]C\n");
@@ -2070,6 +2713,150 @@ void SMR_init(MeshS *pM)
   return;
 }
 /*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static double *pack_prolong(GridS *pG, GridOvrlpS *pCO,
+ *                                  const int nDim, double *pSnd)
+ *  \brief Loads buffer pSnd with the values in zones of pG that overlap the
+ *   ghost zones of the child Grid pCO, and returns the end of the data. */
+
+static double *pack_prolong(GridS *pG, GridOvrlpS *pCO, const int nDim,
+  double *pSnd)
+{
+  int dim,i,ics,ice,j,jcs,jce,k,kcs,kce;
+#if (NSCALARS > 0)
+  int ns;
+#endif
+
+      for (dim=0; dim<(2*nDim); dim++){
+        if (pCO->myFlx[dim] != NULL) {
+
+/* Get coordinates ON THIS GRID of zones that overlap child Grid ghost zones */
+
+          ics = pCO->ijks[0] - (nghost/2) - 1;
+          ice = pCO->ijke[0] + (nghost/2) + 1;
+          if (pG->Nx[1] > 1) {
+            jcs = pCO->ijks[1] - (nghost/2) - 1;
+            jce = pCO->ijke[1] + (nghost/2) + 1;
+          } else {
+            jcs = pCO->ijks[1];
+            jce = pCO->ijke[1];
+          }
+          if (pG->Nx[2] > 1) {
+            kcs = pCO->ijks[2] - (nghost/2) - 1;
+            kce = pCO->ijke[2] + (nghost/2) + 1;
+          } else {
+            kcs = pCO->ijks[2];
+            kce = pCO->ijke[2];
+          }
+          if (dim == 0) ice = pCO->ijks[0];
+          if (dim == 1) ics = pCO->ijke[0];
+          if (dim == 2) jce = pCO->ijks[1];
+          if (dim == 3) jcs = pCO->ijke[1];
+          if (dim == 4) kce = pCO->ijks[2];
+          if (dim == 5) kcs = pCO->ijke[2];
+
+/* Load send buffer with values in zones that overlap child ghost zones */
+
+          for (k=kcs; k<=kce; k++) {
+          for (j=jcs; j<=jce; j++) {
+          for (i=ics; i<=ice; i++) {
+            *(pSnd++) = UVAR(pG,k,j,i,d);
+            *(pSnd++) = UVAR(pG,k,j,i,M1);
+            *(pSnd++) = UVAR(pG,k,j,i,M2);
+            *(pSnd++) = UVAR(pG,k,j,i,M3);
+#ifndef BAROTROPIC
+            *(pSnd++) = UVAR(pG,k,j,i,E);
+#endif
+#ifdef MHD
+            *(pSnd++) = UVAR(pG,k,j,i,B1c);
+            *(pSnd++) = UVAR(pG,k,j,i,B2c);
+            *(pSnd++) = UVAR(pG,k,j,i,B3c);
+            *(pSnd++) = pG->B1i[k][j][i];
+            *(pSnd++) = pG->B2i[k][j][i];
+            *(pSnd++) = pG->B3i[k][j][i];
+#endif
+#if (NSCALARS > 0)
+            for (ns=0; ns<NSCALARS; ns++) {
+               *(pSnd++) = UVAR(pG,k,j,i,s[ns]);
+            }
+#endif
+          }}}
+        }
+      }
+
+
+  return pSnd;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int sum_fine_flux(GridS *pG, Real *pS, const int isub)
+ *  \brief For each array of fluxes and EMFs on the boundaries of the parent
+ *   Grids of pG, copies it into pS (isub=0), or replaces it by its mean with
+ *   the copy in pS (isub=1).  With pS=NULL only counts the words needed.
+ *
+ *   The arrays are those allocated in init_grid(), each contiguous, with
+ *   n1 x n2 faces of the overlap transverse to the boundary.  EMFs along the
+ *   first transverse direction have n1 x (n2+1) edges, along the second
+ *   (n1+1) x n2 edges. */
+
+static int sum_fine_flux(GridS *pG, Real *pS, const int isub)
+{
+  GridOvrlpS *pPO;
+  int npg,dim,n1,n2,nblk,nb,n,cnt=0;
+  Real *pF[4];
+  int nF[4];
+
+  for (npg=0; npg<(pG->NPGrid); npg++){
+    pPO=(GridOvrlpS*)&(pG->PGrid[npg]);
+
+    for (dim=0; dim<6; dim++){
+      if (pPO->myFlx[dim] != NULL) {
+        if (dim < 2) {
+          n1 = pPO->ijke[1] - pPO->ijks[1] + 1;
+          n2 = pPO->ijke[2] - pPO->ijks[2] + 1;
+        } else if (dim < 4) {
+          n1 = pPO->ijke[0] - pPO->ijks[0] + 1;
+          n2 = pPO->ijke[2] - pPO->ijks[2] + 1;
+        } else {
+          n1 = pPO->ijke[0] - pPO->ijks[0] + 1;
+          n2 = pPO->ijke[1] - pPO->ijks[1] + 1;
+        }
+
+        nblk = 0;
+        pF[nblk] = (Real*)&(pPO->myFlx[dim][0][0]);
+        nF[nblk++] = n1*n2*(sizeof(ConsS)/sizeof(Real));
+#ifdef MHD
+        if (pPO->myEMF1[dim] != NULL) {
+          pF[nblk] = &(pPO->myEMF1[dim][0][0]);
+          nF[nblk++] = n1*(n2+1);
+        }
+        if (pPO->myEMF2[dim] != NULL) {
+          pF[nblk] = &(pPO->myEMF2[dim][0][0]);
+          nF[nblk++] = (dim < 2) ? n1*(n2+1) : (n1+1)*n2;
+        }
+        if (pPO->myEMF3[dim] != NULL) {
+          pF[nblk] = &(pPO->myEMF3[dim][0][0]);
+          nF[nblk++] = (n1+1)*n2;
+        }
+#endif /* MHD */
+
+        for (nb=0; nb<nblk; nb++){
+          if (pS != NULL) {
+            if (isub == 0) {
+              for (n=0; n<nF[nb]; n++) pS[cnt+n] = pF[nb][n];
+            } else {
+              for (n=0; n<nF[nb]; n++) pF[nb][n] = 0.5*(pS[cnt+n] + pF[nb][n]);
+            }
+          }
+          cnt += nF[nb];
+        }
+      }
+    }
+  }
+
+  return cnt;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void ProCon(const ConsS Uim1,const ConsS Ui,  const ConsS Uip1,
  *            const ConsS Ujm1,const ConsS Ujp1,
@@ -2521,4 +3308,31 @@ static Real mcd_slope(const Real vl, const Real vc, const Real vr){
 }
 #endif /* FIRST_ORDER */
 
+#ifdef SELF_GRAVITY
+/*----------------------------------------------------------------------------*/
+/*! \fn static int nWordsRC_Phi(const GridOvrlpS *pO, const int r)
+ *  \brief Number of words sent by RestrictCorrect_Phi() for an overlap:
+ *   restricted Phi in each zone, and a gradient on each fine/coarse face.
+ *   Indices of the overlap are in units of the parent Grid (r=1) or of the
+ *   child Grid (r=2).
+ */
+
+static int nWordsRC_Phi(const GridOvrlpS *pO, const int r)
+{
+  int n1 = (pO->ijke[0] - pO->ijks[0] + 1)/r;
+  int n2 = (pO->ijke[1] - pO->ijks[1] + 1)/r;
+  int n3 = (pO->ijke[2] - pO->ijks[2] + 1)/r;
+  int cnt = n1*n2*n3;
+
+  if (pO->myFlx[0] != NULL) cnt += n2*n3;
+  if (pO->myFlx[1] != NULL) cnt += n2*n3;
+  if (pO->myFlx[2] != NULL) cnt += n1*n3;
+  if (pO->myFlx[3] != NULL) cnt += n1*n3;
+  if (pO->myFlx[4] != NULL) cnt += n1*n2;
+  if (pO->myFlx[5] != NULL) cnt += n1*n2;
+
+  return cnt;
+}
+#endif /* SELF_GRAVITY */
+
 #endif /* STATIC_MESH_REFINEMENT */
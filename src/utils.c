@@ -11,6 +11,9 @@
  * - ath_big_endian() - run-time detection of endianism of the host cpu
  * - ath_bswap()      - fast byte swapping routine
  * - ath_error()      - fatal error routine
+ * - get_cons()       - ConsS value of a cell with SOA_STORAGE
+ * - put_cons()       - set a cell from a ConsS value with SOA_STORAGE
+ * - cons_ptr()       - pointer to a ConsS copy of a cell with SOA_STORAGE
  * - minmax1()        - fast Min/Max for a 1d array using registers
  * - minmax2()        - fast Min/Max for a 2d array using registers
  * - minmax3()        - fast Min/Max for a 3d array using registers
@@ -133,6 +136,66 @@ void ath_error(char *fmt, ...)
   exit(EXIT_FAILURE);
 }
 
+#ifdef SOA_STORAGE
+/*----------------------------------------------------------------------------*/
+/*! \fn ConsS get_cons(const GridS *pG, const int k, const int j, const int i)
+ *  \brief Gather the conserved variables of cell [k][j][i] into a ConsS.
+ *   Used by UGET() with SOA_STORAGE.
+ */
+
+ConsS get_cons(const GridS *pG, const int k, const int j, const int i)
+{
+  ConsS q;
+  Real *pq = (Real *)&q;
+  int n;
+
+  for (n=0; n<NVAR; n++) pq[n] = UCOMP(pG,k,j,i,n);
+#ifdef CYLINDRICAL
+  q.Pflux = UVAR(pG,k,j,i,Pflux);
+#endif
+  return q;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void put_cons(GridS *pG, const int k, const int j, const int i,
+ *                    const ConsS q)
+ *  \brief Scatter a ConsS into the conserved variables of cell [k][j][i].
+ *   Used by USET() with SOA_STORAGE.
+ */
+
+void put_cons(GridS *pG, const int k, const int j, const int i, const ConsS q)
+{
+  const Real *pq = (const Real *)&q;
+  int n;
+
+  for (n=0; n<NVAR; n++) UCOMP(pG,k,j,i,n) = pq[n];
+#ifdef CYLINDRICAL
+  UVAR(pG,k,j,i,Pflux) = q.Pflux;
+#endif
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn const ConsS *cons_ptr(const GridS *pG, const int k, const int j,
+ *                            const int i)
+ *  \brief Return a pointer to a copy of the conserved variables of cell
+ *   [k][j][i], for functions such as Cons_to_Prim() which take a ConsS
+ *   pointer.  The copy is overwritten by the next call on the same thread.
+ *   Used by UPTR() with SOA_STORAGE.
+ */
+
+static ConsS Ucopy;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(Ucopy)
+#endif
+
+const ConsS *cons_ptr(const GridS *pG, const int k, const int j, const int i)
+{
+  Ucopy = get_cons(pG,k,j,i);
+  return &Ucopy;
+}
+#endif /* SOA_STORAGE */
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void minmax1(Real *data, int nx1, Real *dmino, Real *dmaxo)
  *  \brief Return the min and max of a 1D array using registers
@@ -314,21 +377,21 @@ void compute_l1_error(const char *problem, const MeshS *pM,
 #endif
 
         /* Sum local L1 error for each grid cell I own */
-        error.d   += dVol*fabs(pG->U[k][j][i].d   - RootSoln[k][j][i].d );
-        error.M1  += dVol*fabs(pG->U[k][j][i].M1  - RootSoln[k][j][i].M1);
-        error.M2  += dVol*fabs(pG->U[k][j][i].M2  - RootSoln[k][j][i].M2);
-        error.M3  += dVol*fabs(pG->U[k][j][i].M3  - RootSoln[k][j][i].M3); 
+        error.d   += dVol*fabs(UVAR(pG,k,j,i,d)   - RootSoln[k][j][i].d );
+        error.M1  += dVol*fabs(UVAR(pG,k,j,i,M1)  - RootSoln[k][j][i].M1);
+        error.M2  += dVol*fabs(UVAR(pG,k,j,i,M2)  - RootSoln[k][j][i].M2);
+        error.M3  += dVol*fabs(UVAR(pG,k,j,i,M3)  - RootSoln[k][j][i].M3); 
 #ifdef MHD
-        error.B1c += dVol*fabs(pG->U[k][j][i].B1c - RootSoln[k][j][i].B1c);
-        error.B2c += dVol*fabs(pG->U[k][j][i].B2c - RootSoln[k][j][i].B2c);
-        error.B3c += dVol*fabs(pG->U[k][j][i].B3c - RootSoln[k][j][i].B3c);
+        error.B1c += dVol*fabs(UVAR(pG,k,j,i,B1c) - RootSoln[k][j][i].B1c);
+        error.B2c += dVol*fabs(UVAR(pG,k,j,i,B2c) - RootSoln[k][j][i].B2c);
+        error.B3c += dVol*fabs(UVAR(pG,k,j,i,B3c) - RootSoln[k][j][i].B3c);
 #endif /* MHD */
 #ifndef ISOTHERMAL
-        error.E   += dVol*fabs(pG->U[k][j][i].E   - RootSoln[k][j][i].E );
+        error.E   += dVol*fabs(UVAR(pG,k,j,i,E)   - RootSoln[k][j][i].E );
 #endif /* ISOTHERMAL */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          error.s[n] += dVol*fabs(pG->U[k][j][i].s[n] - RootSoln[k][j][i].s[n]);;
+          error.s[n] += dVol*fabs(UVAR(pG,k,j,i,s[n]) - RootSoln[k][j][i].s[n]);;
 #endif
       }
 
@@ -1024,33 +1087,33 @@ Real fx(Real x)
 #endif
 }
 
-Real avgXZ(Real (*func)(Real, Real, Real), const GridS *pG, const int i, const
-int j, const int k) {
-  Real x1,x2,x3;
-
-  Real fXZ(Real z);
-
-  nrfunc=func;
-  cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  xmin = x1 - 0.5*pG->dx1;  xmax = x1 + 0.5*pG->dx1;
-  zmin = x3 - 0.5*pG->dx3;  zmax = x3 + 0.5*pG->dx3;
-
-  ysav = x2;
-  return qsimp(fXZ,zmin,zmax)/(pG->dx1*pG->dx3);
-
-}
-
-Real fx2(Real x)
-{
-  return nrfunc(x,ysav,zsav);
-}
-
-Real fXZ(Real z) {
-  Real fx2(Real x);
-
-  zsav = z;
-  return qsimp(fx2,xmin,xmax);
-}
+Real avgXZ(Real (*func)(Real, Real, Real), const GridS *pG, const int i, const
+int j, const int k) {
+  Real x1,x2,x3;
+
+  Real fXZ(Real z);
+
+  nrfunc=func;
+  cc_pos(pG,i,j,k,&x1,&x2,&x3);
+  xmin = x1 - 0.5*pG->dx1;  xmax = x1 + 0.5*pG->dx1;
+  zmin = x3 - 0.5*pG->dx3;  zmax = x3 + 0.5*pG->dx3;
+
+  ysav = x2;
+  return qsimp(fXZ,zmin,zmax)/(pG->dx1*pG->dx3);
+
+}
+
+Real fx2(Real x)
+{
+  return nrfunc(x,ysav,zsav);
+}
+
+Real fXZ(Real z) {
+  Real fx2(Real x);
+
+  zsav = z;
+  return qsimp(fx2,xmin,xmax);
+}
 
 /*----------------------------------------------------------------------------*/
 /* FUNCTION vecpot2b1i,vecpot2b2i,vecpot2b3i